@@ -60,6 +60,16 @@ LD_FLAGS     += \
               -static-libgcc
 endif
 
+# count the calls into every function, see src/main/target/SITL/function_profile.c
+ifeq ($(FUNCTION_PROFILE),yes)
+TARGET_FLAGS    += -finstrument-functions -DUSE_FUNCTION_PROFILE
+endif
+
+# simulated time only advances with the state packets of the simulator, see src/main/target/SITL/target.c
+ifeq ($(LOCKSTEP),yes)
+TARGET_FLAGS    += -DSIMULATOR_LOCKSTEP
+endif
+
 ifneq ($(DEBUG),GDB)
 OPTIMISE_DEFAULT    := -Ofast
 OPTIMISE_SPEED      := -Ofast
@@ -1,7 +1,11 @@
 COMMON_SRC = \
+            build/benchmark.c \
             build/build_config.c \
             build/debug.c \
             build/debug_pin.c \
+            build/irq_load.c \
+            build/latency.c \
+            build/pc_sampling.c \
             build/version.c \
             $(TARGET_DIR_SRC) \
             main.c \
@@ -70,6 +74,7 @@ COMMON_SRC = \
             scheduler/scheduler.c \
             sensors/adcinternal.c \
             sensors/battery.c \
+            sensors/battery_estimator.c \
             sensors/current.c \
             sensors/voltage.c \
             target/config_helper.c \
@@ -46,6 +46,7 @@
 #include "config/feature.h"
 
 #include "drivers/compass/compass.h"
+#include "drivers/dshot.h"
 #include "drivers/sensor.h"
 #include "drivers/time.h"
 
@@ -88,13 +89,15 @@
 #define DEFAULT_BLACKBOX_DEVICE     BLACKBOX_DEVICE_SERIAL
 #endif
 
-PG_REGISTER_WITH_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 2);
+PG_REGISTER_WITH_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 4);
 
 PG_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig,
     .sample_rate = BLACKBOX_RATE_QUARTER,
     .device = DEFAULT_BLACKBOX_DEVICE,
     .fields_disabled_mask = 0, // default log all fields
-    .mode = BLACKBOX_MODE_NORMAL
+    .mode = BLACKBOX_MODE_NORMAL,
+    .p_predictor = BLACKBOX_P_PREDICTOR_AVERAGE,
+    .capture_window_ms = 0
 );
 
 STATIC_ASSERT((sizeof(blackboxConfig()->fields_disabled_mask) * 8) >= FLIGHT_LOG_FIELD_SELECT_COUNT, too_many_flight_log_fields_selections);
@@ -231,6 +234,11 @@ static const blackboxDeltaFieldDefinition_t blackboxMainFields[] = {
     {"debug",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(DEBUG_LOG)},
     {"debug",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(DEBUG_LOG)},
     {"debug",       3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(DEBUG_LOG)},
+    /* The second debug mode, if one is selected: */
+    {"debug",       4, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(DEBUG_LOG_2)},
+    {"debug",       5, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(DEBUG_LOG_2)},
+    {"debug",       6, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(DEBUG_LOG_2)},
+    {"debug",       7, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(DEBUG_LOG_2)},
     /* Motors only rarely drops under minthrottle (when stick falls below mincommand), so predict minthrottle for it and use *unsigned* encoding (which is large for negative numbers but more compact for positive ones): */
     {"motor",       0, UNSIGNED, .Ipredict = PREDICT(MINMOTOR), .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(AVERAGE_2), .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_1)},
     /* Subsequent motors base their I-frame values on the first one, P-frame values on the average of last two frames: */
@@ -307,7 +315,7 @@ typedef struct blackboxMainState_s {
     int16_t setpoint[4];
     int16_t gyroADC[XYZ_AXIS_COUNT];
     int16_t accADC[XYZ_AXIS_COUNT];
-    int16_t debug[DEBUG16_VALUE_COUNT];
+    int32_t debug[DEBUG_VALUE_COUNT];
     int16_t motor[MAX_SUPPORTED_MOTORS];
     int16_t servo[MAX_SUPPORTED_SERVOS];
 
@@ -366,6 +374,9 @@ static uint32_t blackboxConditionCache;
 
 STATIC_ASSERT((sizeof(blackboxConditionCache) * 8) >= FLIGHT_LOG_FIELD_CONDITION_LAST, too_many_flight_log_conditions);
 
+// P-frame predictor for the noisy main fields, latched at log start
+static uint8_t blackboxPPredictor = BLACKBOX_P_PREDICTOR_AVERAGE;
+
 static uint32_t blackboxIteration;
 static uint16_t blackboxLoopIndex;
 static uint16_t blackboxPFrameIndex;
@@ -395,6 +406,65 @@ static blackboxMainState_t blackboxHistoryRing[3];
 // These point into blackboxHistoryRing, use them to know where to store history of a given age (0, 1 or 2 generations old)
 static blackboxMainState_t* blackboxHistory[3];
 
+/*
+ * Main state snapshots are captured by blackboxCaptureIteration() in the PID loop and encoded by
+ * blackboxUpdate() in the blackbox task. The PID loop is the only writer of the head index and the
+ * blackbox task is the only writer of the tail index.
+ */
+#define BLACKBOX_FRAME_RING_SIZE 8 // must be a power of 2
+
+typedef struct blackboxFrameSnapshot_s {
+    blackboxMainState_t state;
+    uint32_t iteration;
+    bool intraframe;
+} blackboxFrameSnapshot_t;
+
+static blackboxFrameSnapshot_t blackboxFrameRing[BLACKBOX_FRAME_RING_SIZE];
+static volatile uint8_t blackboxFrameRingHead;
+static volatile uint8_t blackboxFrameRingTail;
+// Set when a P-frame can't be queued, no more P-frames are queued until the next I-frame resynchronises the log
+static bool blackboxFrameRingResync;
+static uint32_t blackboxFramesDropped;
+#ifdef USE_GPS
+static bool blackboxGpsHomeFrameDue;
+#endif
+
+#ifdef USE_BLACKBOX_CAPTURE_WINDOW
+/*
+ * With capture windows enabled every loop iteration is captured into a delay line, and frames are only
+ * passed on to the frame ring when they leave it. Decimation normally drops most of them, but a trigger
+ * marks everything still in the delay line (the pre-trigger history) and the following capture_window_ms
+ * for logging at full rate. The log stays in time order at the cost of running BLACKBOX_PRETRIGGER_FRAMES
+ * loop iterations behind.
+ */
+#ifndef BLACKBOX_PRETRIGGER_FRAMES
+#define BLACKBOX_PRETRIGGER_FRAMES 64
+#endif
+
+typedef enum {
+    BLACKBOX_DELAYED_FRAME_NONE = 0,
+    BLACKBOX_DELAYED_FRAME_P,
+    BLACKBOX_DELAYED_FRAME_I
+} blackboxDelayedFrameType_e;
+
+typedef struct blackboxDelayedFrame_s {
+    blackboxMainState_t state;
+    uint32_t iteration;
+    uint8_t frameType; // What decimation would log for this iteration
+} blackboxDelayedFrame_t;
+
+static blackboxDelayedFrame_t blackboxDelayLine[BLACKBOX_PRETRIGGER_FRAMES];
+static uint16_t blackboxDelayLineIndex;
+static uint16_t blackboxDelayLineCount;
+static uint32_t blackboxCaptureWindowIterations;
+// Iterations in [start, end) are logged at full rate
+static uint32_t blackboxCaptureStartIteration;
+static uint32_t blackboxCaptureEndIteration;
+static uint16_t blackboxCaptureTriggerCount;
+static uint8_t blackboxCaptureLastTrigger;
+static bool blackboxCaptureTriggerActive[BLACKBOX_CAPTURE_TRIGGER_COUNT];
+#endif
+
 static bool blackboxModeActivationConditionPresent = false;
 
 /**
@@ -488,7 +558,10 @@ static bool testBlackboxConditionUncached(FlightLogFieldCondition condition)
         return sensors(SENSOR_ACC) && isFieldEnabled(FIELD_SELECT(ACC));
 
     case CONDITION(DEBUG_LOG):
-        return (debugMode != DEBUG_NONE) && isFieldEnabled(FIELD_SELECT(DEBUG_LOG));
+        return (debugModes[0] != DEBUG_NONE) && isFieldEnabled(FIELD_SELECT(DEBUG_LOG));
+
+    case CONDITION(DEBUG_LOG_2):
+        return (debugModes[1] != DEBUG_NONE) && isFieldEnabled(FIELD_SELECT(DEBUG_LOG));
 
     case CONDITION(NEVER):
         return false;
@@ -547,13 +620,14 @@ static void blackboxSetState(BlackboxState newState)
     blackboxState = newState;
 }
 
-static void writeIntraframe(void)
+static void writeIntraframe(uint32_t iteration)
 {
     blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
 
+    blackboxFrameBegin();
     blackboxWrite('I');
 
-    blackboxWriteUnsignedVB(blackboxIteration);
+    blackboxWriteUnsignedVB(iteration);
     blackboxWriteUnsignedVB(blackboxCurrent->time);
 
     if (testBlackboxCondition(CONDITION(PID))) {
@@ -632,7 +706,10 @@ static void writeIntraframe(void)
     }
 
     if (testBlackboxCondition(CONDITION(DEBUG_LOG))) {
-        blackboxWriteSigned16VBArray(blackboxCurrent->debug, DEBUG16_VALUE_COUNT);
+        blackboxWriteSignedVBArray(blackboxCurrent->debug, DEBUG_GROUP_VALUE_COUNT);
+    }
+    if (testBlackboxCondition(CONDITION(DEBUG_LOG_2))) {
+        blackboxWriteSignedVBArray(&blackboxCurrent->debug[DEBUG_GROUP_VALUE_COUNT], DEBUG_GROUP_VALUE_COUNT);
     }
 
     if (isFieldEnabled(FIELD_SELECT(MOTOR))) {
@@ -661,6 +738,8 @@ static void writeIntraframe(void)
     blackboxHistory[0] = ((blackboxHistory[0] - blackboxHistoryRing + 1) % 3) + blackboxHistoryRing;
 
     blackboxLoggedAnyFrames = true;
+
+    blackboxFrameEnd();
 }
 
 static void blackboxWriteMainStateArrayUsingAveragePredictor(int arrOffsetInHistory, int count)
@@ -677,11 +756,54 @@ static void blackboxWriteMainStateArrayUsingAveragePredictor(int arrOffsetInHist
     }
 }
 
+static void blackboxWriteMainStateArrayUsingStraightLinePredictor(int arrOffsetInHistory, int count)
+{
+    int16_t *curr  = (int16_t*) ((char*) (blackboxHistory[0]) + arrOffsetInHistory);
+    int16_t *prev1 = (int16_t*) ((char*) (blackboxHistory[1]) + arrOffsetInHistory);
+    int16_t *prev2 = (int16_t*) ((char*) (blackboxHistory[2]) + arrOffsetInHistory);
+
+    for (int i = 0; i < count; i++) {
+        // Predictor extrapolates the line through the previous two history states
+        int32_t predictor = 2 * prev1[i] - prev2[i];
+
+        blackboxWriteSignedVB(curr[i] - predictor);
+    }
+}
+
+static void blackboxWriteMainStateArrayUsingPPredictor(int arrOffsetInHistory, int count)
+{
+    if (blackboxPPredictor == BLACKBOX_P_PREDICTOR_STRAIGHT_LINE) {
+        blackboxWriteMainStateArrayUsingStraightLinePredictor(arrOffsetInHistory, count);
+    } else {
+        blackboxWriteMainStateArrayUsingAveragePredictor(arrOffsetInHistory, count);
+    }
+}
+
+// As above for the 32 bit debug values, the predictor is calculated in 64 bits so it cannot overflow
+static void blackboxWriteMainStateArray32UsingPPredictor(int arrOffsetInHistory, int count)
+{
+    int32_t *curr  = (int32_t*) ((char*) (blackboxHistory[0]) + arrOffsetInHistory);
+    int32_t *prev1 = (int32_t*) ((char*) (blackboxHistory[1]) + arrOffsetInHistory);
+    int32_t *prev2 = (int32_t*) ((char*) (blackboxHistory[2]) + arrOffsetInHistory);
+
+    for (int i = 0; i < count; i++) {
+        int64_t predictor;
+        if (blackboxPPredictor == BLACKBOX_P_PREDICTOR_STRAIGHT_LINE) {
+            predictor = 2 * (int64_t)prev1[i] - prev2[i];
+        } else {
+            predictor = ((int64_t)prev1[i] + prev2[i]) / 2;
+        }
+
+        blackboxWriteSignedVB((int32_t)(curr[i] - predictor));
+    }
+}
+
 static void writeInterframe(void)
 {
     blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
     blackboxMainState_t *blackboxLast = blackboxHistory[1];
 
+    blackboxFrameBegin();
     blackboxWrite('P');
 
     //No need to store iteration count since its delta is always 1
@@ -773,19 +895,22 @@ static void writeInterframe(void)
 
     blackboxWriteTag8_8SVB(deltas, optionalFieldCount);
 
-    //Since gyros, accs and motors are noisy, base their predictions on the average of the history:
+    //Since gyros, accs and motors are noisy, base their predictions on the history (average or straight line):
     if (testBlackboxCondition(CONDITION(GYRO))) {
-        blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, gyroADC),   XYZ_AXIS_COUNT);
+        blackboxWriteMainStateArrayUsingPPredictor(offsetof(blackboxMainState_t, gyroADC),   XYZ_AXIS_COUNT);
     }
     if (testBlackboxCondition(CONDITION(ACC))) {
-        blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, accADC), XYZ_AXIS_COUNT);
+        blackboxWriteMainStateArrayUsingPPredictor(offsetof(blackboxMainState_t, accADC), XYZ_AXIS_COUNT);
     }
     if (testBlackboxCondition(CONDITION(DEBUG_LOG))) {
-        blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, debug), DEBUG16_VALUE_COUNT);
+        blackboxWriteMainStateArray32UsingPPredictor(offsetof(blackboxMainState_t, debug), DEBUG_GROUP_VALUE_COUNT);
+    }
+    if (testBlackboxCondition(CONDITION(DEBUG_LOG_2))) {
+        blackboxWriteMainStateArray32UsingPPredictor(offsetof(blackboxMainState_t, debug[DEBUG_GROUP_VALUE_COUNT]), DEBUG_GROUP_VALUE_COUNT);
     }
 
     if (isFieldEnabled(FIELD_SELECT(MOTOR))) {
-        blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, motor),     getMotorCount());
+        blackboxWriteMainStateArrayUsingPPredictor(offsetof(blackboxMainState_t, motor),     getMotorCount());
 
         if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_TRICOPTER)) {
             blackboxWriteSignedVB(blackboxCurrent->servo[5] - blackboxLast->servo[5]);
@@ -798,6 +923,8 @@ static void writeInterframe(void)
     blackboxHistory[0] = ((blackboxHistory[0] - blackboxHistoryRing + 1) % 3) + blackboxHistoryRing;
 
     blackboxLoggedAnyFrames = true;
+
+    blackboxFrameEnd();
 }
 
 /* Write the contents of the global "slowHistory" to the log as an "S" frame. Because this data is logged so
@@ -806,6 +933,7 @@ static void writeSlowFrame(void)
 {
     int32_t values[3];
 
+    blackboxFrameBegin();
     blackboxWrite('S');
 
     blackboxWriteUnsignedVB(slowHistory.flightModeFlags);
@@ -820,6 +948,8 @@ static void writeSlowFrame(void)
     blackboxWriteTag2_3S32(values);
 
     blackboxSlowFrameIterationTimer = 0;
+
+    blackboxFrameEnd();
 }
 
 /**
@@ -892,6 +1022,25 @@ static void blackboxResetIterationTimers(void)
     blackboxIFrameIndex = 0;
     blackboxPFrameIndex = 0;
     blackboxSlowFrameIterationTimer = 0;
+
+    blackboxFrameRingHead = 0;
+    blackboxFrameRingTail = 0;
+    blackboxFrameRingResync = false;
+    blackboxFramesDropped = 0;
+#ifdef USE_GPS
+    blackboxGpsHomeFrameDue = false;
+#endif
+#ifdef USE_BLACKBOX_CAPTURE_WINDOW
+    blackboxDelayLineIndex = 0;
+    blackboxDelayLineCount = 0;
+    blackboxCaptureStartIteration = 0;
+    blackboxCaptureEndIteration = 0;
+    blackboxCaptureTriggerCount = 0;
+    blackboxCaptureLastTrigger = 0;
+    memset(blackboxCaptureTriggerActive, 0, sizeof(blackboxCaptureTriggerActive));
+    // Telemetry only counts as lost once it has been seen, not while the ESCs are still starting up
+    blackboxCaptureTriggerActive[BLACKBOX_CAPTURE_TRIGGER_DSHOT_TELEMETRY_LOSS] = true;
+#endif
 }
 
 /**
@@ -923,6 +1072,9 @@ static void blackboxStart(void)
      */
     blackboxBuildConditionCache();
 
+    // The P-frame predictor is written into the field headers, so it must also stay fixed for the whole log
+    blackboxPPredictor = blackboxConfig()->p_predictor;
+
     blackboxModeActivationConditionPresent = isModeActivationConditionPresent(BOXBLACKBOX);
 
     blackboxResetIterationTimers();
@@ -1009,6 +1161,8 @@ static bool inMotorTestMode(void) {
 #ifdef USE_GPS
 static void writeGPSHomeFrame(void)
 {
+    blackboxFrameBegin();
+
     blackboxWrite('H');
 
     blackboxWriteSignedVB(GPS_home[0]);
@@ -1017,10 +1171,14 @@ static void writeGPSHomeFrame(void)
 
     gpsHistory.GPS_home[0] = GPS_home[0];
     gpsHistory.GPS_home[1] = GPS_home[1];
+
+    blackboxFrameEnd();
 }
 
 static void writeGPSFrame(timeUs_t currentTimeUs)
 {
+    blackboxFrameBegin();
+
     blackboxWrite('G');
 
     /*
@@ -1044,17 +1202,17 @@ static void writeGPSFrame(timeUs_t currentTimeUs)
     gpsHistory.GPS_numSat = gpsSol.numSat;
     gpsHistory.GPS_coord[LAT] = gpsSol.llh.lat;
     gpsHistory.GPS_coord[LON] = gpsSol.llh.lon;
+
+    blackboxFrameEnd();
 }
 #endif
 
 /**
  * Fill the current state of the blackbox using values read from the flight controller
  */
-static void loadMainState(timeUs_t currentTimeUs)
+static void loadMainState(blackboxMainState_t *blackboxCurrent, timeUs_t currentTimeUs)
 {
 #ifndef UNIT_TEST
-    blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
-
     blackboxCurrent->time = currentTimeUs;
 
     for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
@@ -1082,7 +1240,7 @@ static void loadMainState(timeUs_t currentTimeUs)
     // log the final throttle value used in the mixer
     blackboxCurrent->setpoint[3] = lrintf(mixerGetThrottle() * 1000);
 
-    for (int i = 0; i < DEBUG16_VALUE_COUNT; i++) {
+    for (int i = 0; i < DEBUG_VALUE_COUNT; i++) {
         blackboxCurrent->debug[i] = debug[i];
     }
 
@@ -1110,6 +1268,7 @@ static void loadMainState(timeUs_t currentTimeUs)
     blackboxCurrent->servo[5] = servo[5];
 #endif
 #else
+    UNUSED(blackboxCurrent);
     UNUSED(currentTimeUs);
 #endif // UNIT_TEST
 }
@@ -1214,7 +1373,13 @@ static bool sendFieldDefinition(char mainFrameChar, char deltaFrameChar, const v
                 }
             } else {
                 //The other headers are integers
-                blackboxPrintf("%d", def->arr[xmitState.headerIndex - 1]);
+                int value = def->arr[xmitState.headerIndex - 1];
+
+                // The noisy main fields may be switched over to the straight line predictor for this log
+                if (value == PREDICT(AVERAGE_2) && blackboxPPredictor == BLACKBOX_P_PREDICTOR_STRAIGHT_LINE) {
+                    value = PREDICT(STRAIGHT_LINE);
+                }
+                blackboxPrintf("%d", value);
             }
         }
     }
@@ -1319,6 +1484,7 @@ static bool blackboxWriteSysinfo(void)
         BLACKBOX_PRINT_HEADER_LINE("looptime", "%d",                        gyro.sampleLooptime);
         BLACKBOX_PRINT_HEADER_LINE("gyro_sync_denom", "%d",                 1);
         BLACKBOX_PRINT_HEADER_LINE("pid_process_denom", "%d",               activePidLoopDenom);
+        BLACKBOX_PRINT_HEADER_LINE("pid_outer_denom", "%d",                 pidConfig()->pid_outer_denom);
         BLACKBOX_PRINT_HEADER_LINE("thr_mid", "%d",                         currentControlRateProfile->thrMid8);
         BLACKBOX_PRINT_HEADER_LINE("thr_expo", "%d",                        currentControlRateProfile->thrExpo8);
         BLACKBOX_PRINT_HEADER_LINE("tpa_rate", "%d",                        currentControlRateProfile->dynThrPID);
@@ -1404,6 +1570,9 @@ static bool blackboxWriteSysinfo(void)
         BLACKBOX_PRINT_HEADER_LINE("yaw_deadband", "%d",                    rcControlsConfig()->yaw_deadband);
 
         BLACKBOX_PRINT_HEADER_LINE("gyro_hardware_lpf", "%d",               gyroConfig()->gyro_hardware_lpf);
+#ifdef USE_GYRO_FIFO
+        BLACKBOX_PRINT_HEADER_LINE("gyro_fifo_depth", "%d",                 gyro.fifoDepth);
+#endif
         BLACKBOX_PRINT_HEADER_LINE("gyro_lowpass_type", "%d",               gyroConfig()->gyro_lowpass_type);
         BLACKBOX_PRINT_HEADER_LINE("gyro_lowpass_hz", "%d",                 gyroConfig()->gyro_lowpass_hz);
 #ifdef USE_DYN_LPF
@@ -1419,9 +1588,11 @@ static bool blackboxWriteSysinfo(void)
         BLACKBOX_PRINT_HEADER_LINE("gyro_to_use", "%d",                     gyroConfig()->gyro_to_use);
 #ifdef USE_GYRO_DATA_ANALYSE
         BLACKBOX_PRINT_HEADER_LINE("dyn_notch_max_hz", "%d",                gyroConfig()->dyn_notch_max_hz);
-        BLACKBOX_PRINT_HEADER_LINE("dyn_notch_width_percent", "%d",         gyroConfig()->dyn_notch_width_percent);
+        BLACKBOX_PRINT_HEADER_LINE("dyn_notch_count", "%d",                 gyroConfig()->dyn_notch_count);
         BLACKBOX_PRINT_HEADER_LINE("dyn_notch_q", "%d",                     gyroConfig()->dyn_notch_q);
         BLACKBOX_PRINT_HEADER_LINE("dyn_notch_min_hz", "%d",                gyroConfig()->dyn_notch_min_hz);
+        BLACKBOX_PRINT_HEADER_LINE("dyn_notch_window", "%d",                gyroConfig()->dyn_notch_window);
+        BLACKBOX_PRINT_HEADER_LINE("dyn_notch_engine", "%d",                gyroConfig()->dyn_notch_engine);
 #endif
 #ifdef USE_DSHOT_TELEMETRY
         BLACKBOX_PRINT_HEADER_LINE("dshot_bidir", "%d",                     motorConfig()->dev.useDshotTelemetry);
@@ -1431,6 +1602,7 @@ static bool blackboxWriteSysinfo(void)
         BLACKBOX_PRINT_HEADER_LINE("gyro_rpm_notch_q", "%d",                rpmFilterConfig()->gyro_rpm_notch_q);
         BLACKBOX_PRINT_HEADER_LINE("gyro_rpm_notch_min", "%d",              rpmFilterConfig()->gyro_rpm_notch_min);
         BLACKBOX_PRINT_HEADER_LINE("rpm_notch_lpf", "%d",                   rpmFilterConfig()->rpm_lpf);
+        BLACKBOX_PRINT_HEADER_LINE("gyro_rpm_notch_budget", "%d",           rpmFilterConfig()->gyro_rpm_notch_budget);
 #endif
 #if defined(USE_ACC)
         BLACKBOX_PRINT_HEADER_LINE("acc_lpf_hz", "%d",                 (int)(accelerometerConfig()->acc_lpf_hz * 100.0f));
@@ -1452,7 +1624,8 @@ static bool blackboxWriteSysinfo(void)
         BLACKBOX_PRINT_HEADER_LINE("motor_pwm_protocol", "%d",              motorConfig()->dev.motorPwmProtocol);
         BLACKBOX_PRINT_HEADER_LINE("motor_pwm_rate", "%d",                  motorConfig()->dev.motorPwmRate);
         BLACKBOX_PRINT_HEADER_LINE("dshot_idle_value", "%d",                motorConfig()->digitalIdleOffsetValue);
-        BLACKBOX_PRINT_HEADER_LINE("debug_mode", "%d",                      debugMode);
+        BLACKBOX_PRINT_HEADER_LINE("debug_mode", "%d",                      debugModes[0]);
+        BLACKBOX_PRINT_HEADER_LINE("debug_mode_2", "%d",                    debugModes[1]);
         BLACKBOX_PRINT_HEADER_LINE("features", "%d",                        featureConfig()->enabledFeatures);
 
 #ifdef USE_RC_SMOOTHING_FILTER
@@ -1470,11 +1643,21 @@ static bool blackboxWriteSysinfo(void)
         BLACKBOX_PRINT_HEADER_LINE("rates_type", "%d",                      currentControlRateProfile->rates_type);
 
         BLACKBOX_PRINT_HEADER_LINE("fields_disabled_mask", "%d",            blackboxConfig()->fields_disabled_mask);
+        BLACKBOX_PRINT_HEADER_LINE("p_predictor", "%d",                     blackboxPPredictor);
+#ifdef USE_BLACKBOX_CAPTURE_WINDOW
+        BLACKBOX_PRINT_HEADER_LINE("capture_window", "%d,%d",               blackboxCaptureWindowIterations ? BLACKBOX_PRETRIGGER_FRAMES : 0,
+                                                                            blackboxConfig()->capture_window_ms);
+#endif
 
 #ifdef USE_BATTERY_VOLTAGE_SAG_COMPENSATION
         BLACKBOX_PRINT_HEADER_LINE("vbat_sag_compensation", "%d",           currentPidProfile->vbat_sag_compensation);
 #endif
 
+#ifdef USE_RPM_FILTER
+        BLACKBOX_PRINT_HEADER_LINE("motor_lag_comp", "%d",                  currentPidProfile->motor_lag_comp);
+        BLACKBOX_PRINT_HEADER_LINE("motor_lag_comp_limit", "%d",            currentPidProfile->motor_lag_comp_limit);
+#endif
+
 #if defined(USE_DYN_IDLE)
         BLACKBOX_PRINT_HEADER_LINE("dynamic_idle_min_rpm", "%d",            currentPidProfile->idle_min_rpm);
 #endif
@@ -1498,6 +1681,8 @@ void blackboxLogEvent(FlightLogEvent event, flightLogEventData_t *data)
         return;
     }
 
+    blackboxFrameBegin();
+
     //Shared header for event frames
     blackboxWrite('E');
     blackboxWrite(event);
@@ -1534,6 +1719,8 @@ void blackboxLogEvent(FlightLogEvent event, flightLogEventData_t *data)
     default:
         break;
     }
+
+    blackboxFrameEnd();
 }
 
 /* If an arming beep has played since it was last logged, write the time of the arming beep to the log as a synchronization point */
@@ -1582,7 +1769,7 @@ STATIC_UNIT_TESTED bool blackboxShouldLogIFrame(void)
 STATIC_UNIT_TESTED bool blackboxShouldLogGpsHomeFrame(void)
 {
     if ((GPS_home[0] != gpsHistory.GPS_home[0] || GPS_home[1] != gpsHistory.GPS_home[1]
-        || (blackboxPFrameIndex == blackboxIInterval / 2 && blackboxIFrameIndex % 128 == 0)) && isFieldEnabled(FIELD_SELECT(GPS))) {
+        || blackboxGpsHomeFrameDue) && isFieldEnabled(FIELD_SELECT(GPS))) {
         return true;
     }
     return false;
@@ -1602,58 +1789,248 @@ STATIC_UNIT_TESTED void blackboxAdvanceIterationTimers(void)
     } else if (++blackboxPFrameIndex >= blackboxPInterval) {
         blackboxPFrameIndex = 0;
     }
+#ifdef USE_GPS
+    if (blackboxPFrameIndex == blackboxIInterval / 2 && blackboxIFrameIndex % 128 == 0) {
+        blackboxGpsHomeFrameDue = true;
+    }
+#endif
 }
 
-// Called once every FC loop in order to log the current state
-STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs)
+static blackboxFrameSnapshot_t *blackboxFrameRingReserve(void)
+{
+    const uint8_t nextHead = (blackboxFrameRingHead + 1) & (BLACKBOX_FRAME_RING_SIZE - 1);
+
+    if (nextHead == blackboxFrameRingTail) {
+        // The blackbox task has fallen behind, drop this frame
+        blackboxFramesDropped++;
+        blackboxFrameRingResync = true;
+        return NULL;
+    }
+
+    return &blackboxFrameRing[blackboxFrameRingHead];
+}
+
+static void blackboxFrameRingCommit(bool intraframe)
+{
+    blackboxFrameRingHead = (blackboxFrameRingHead + 1) & (BLACKBOX_FRAME_RING_SIZE - 1);
+    if (intraframe) {
+        blackboxFrameRingResync = false;
+    }
+}
+
+static void blackboxQueueFrame(timeUs_t currentTimeUs, bool intraframe)
+{
+    blackboxFrameSnapshot_t *snapshot = blackboxFrameRingReserve();
+    if (!snapshot) {
+        return;
+    }
+
+    loadMainState(&snapshot->state, currentTimeUs);
+    snapshot->iteration = blackboxIteration;
+    snapshot->intraframe = intraframe;
+
+    blackboxFrameRingCommit(intraframe);
+}
+
+#ifdef USE_BLACKBOX_CAPTURE_WINDOW
+/**
+ * Open (or extend) a full-rate capture window. Must be called from the same context as blackboxCaptureIteration().
+ */
+void blackboxTriggerCaptureWindow(BlackboxCaptureTrigger_e trigger)
+{
+    if (blackboxState != BLACKBOX_STATE_RUNNING || blackboxCaptureWindowIterations == 0) {
+        return;
+    }
+
+    if (blackboxIteration >= blackboxCaptureEndIteration) {
+        // The history still in the delay line is the pre-trigger part of the window
+        blackboxCaptureStartIteration = blackboxIteration - blackboxDelayLineCount;
+    }
+    blackboxCaptureEndIteration = blackboxIteration + blackboxCaptureWindowIterations;
+
+    blackboxCaptureTriggerCount++;
+    blackboxCaptureLastTrigger = trigger;
+}
+
+static void blackboxCheckCaptureTrigger(BlackboxCaptureTrigger_e trigger, bool active)
+{
+    // Trigger on the rising edge only, a condition that persists doesn't keep the window open
+    if (active && !blackboxCaptureTriggerActive[trigger]) {
+        blackboxTriggerCaptureWindow(trigger);
+    }
+    blackboxCaptureTriggerActive[trigger] = active;
+}
+
+static void blackboxCheckCaptureTriggers(void)
+{
+#ifdef USE_GYRO_OVERFLOW_CHECK
+    blackboxCheckCaptureTrigger(BLACKBOX_CAPTURE_TRIGGER_GYRO_OVERFLOW, gyroOverflowDetected());
+#endif
+#ifdef USE_YAW_SPIN_RECOVERY
+    blackboxCheckCaptureTrigger(BLACKBOX_CAPTURE_TRIGGER_YAW_SPIN, gyroYawSpinDetected());
+#endif
+    blackboxCheckCaptureTrigger(BLACKBOX_CAPTURE_TRIGGER_CRASH_RECOVERY, crashRecoveryModeActive());
+#ifdef USE_DSHOT_TELEMETRY
+    if (motorConfig()->dev.useDshotTelemetry && ARMING_FLAG(ARMED)) {
+        blackboxCheckCaptureTrigger(BLACKBOX_CAPTURE_TRIGGER_DSHOT_TELEMETRY_LOSS, !isDshotTelemetryActive());
+    }
+#endif
+}
+
+static void blackboxReleaseDelayedFrame(const blackboxDelayedFrame_t *frame)
+{
+    const bool inCaptureWindow = frame->iteration >= blackboxCaptureStartIteration && frame->iteration < blackboxCaptureEndIteration;
+    bool intraframe;
+
+    if (frame->frameType == BLACKBOX_DELAYED_FRAME_I) {
+        intraframe = true;
+    } else if ((frame->frameType == BLACKBOX_DELAYED_FRAME_P || (inCaptureWindow && blackboxPInterval)) && !blackboxFrameRingResync) {
+        intraframe = false;
+    } else {
+        return;
+    }
+
+    blackboxFrameSnapshot_t *snapshot = blackboxFrameRingReserve();
+    if (!snapshot) {
+        return;
+    }
+
+    snapshot->state = frame->state;
+    snapshot->iteration = frame->iteration;
+    snapshot->intraframe = intraframe;
+
+    blackboxFrameRingCommit(intraframe);
+}
+
+static void blackboxCaptureDelayed(timeUs_t currentTimeUs)
 {
-    // Write a keyframe every blackboxIInterval frames so we can resynchronise upon missing frames
+    blackboxCheckCaptureTriggers();
+
+    blackboxDelayedFrame_t *frame = &blackboxDelayLine[blackboxDelayLineIndex];
+
+    if (blackboxDelayLineCount == BLACKBOX_PRETRIGGER_FRAMES) {
+        // The oldest frame leaves the delay line to make room for this one
+        blackboxReleaseDelayedFrame(frame);
+    } else {
+        blackboxDelayLineCount++;
+    }
+
+    loadMainState(&frame->state, currentTimeUs);
+    frame->iteration = blackboxIteration;
     if (blackboxShouldLogIFrame()) {
-        /*
-         * Don't log a slow frame if the slow data didn't change ("I" frames are already large enough without adding
-         * an additional item to write at the same time). Unless we're *only* logging "I" frames, then we have no choice.
-         */
-        if (blackboxIsOnlyLoggingIntraframes()) {
-            writeSlowFrameIfNeeded();
-        }
+        frame->frameType = BLACKBOX_DELAYED_FRAME_I;
+    } else if (blackboxShouldLogPFrame()) {
+        frame->frameType = BLACKBOX_DELAYED_FRAME_P;
+    } else {
+        frame->frameType = BLACKBOX_DELAYED_FRAME_NONE;
+    }
+
+    if (++blackboxDelayLineIndex >= BLACKBOX_PRETRIGGER_FRAMES) {
+        blackboxDelayLineIndex = 0;
+    }
 
-        loadMainState(currentTimeUs);
-        writeIntraframe();
+    DEBUG_SET(DEBUG_BLACKBOX, 2, blackboxCaptureTriggerCount);
+    DEBUG_SET(DEBUG_BLACKBOX, 3, blackboxIteration < blackboxCaptureEndIteration ? blackboxCaptureLastTrigger + 1 : 0);
+}
+#else
+void blackboxTriggerCaptureWindow(BlackboxCaptureTrigger_e trigger)
+{
+    UNUSED(trigger);
+}
+#endif // USE_BLACKBOX_CAPTURE_WINDOW
+
+/**
+ * Call each flight loop iteration to capture the main state for the blackbox task to encode.
+ */
+void blackboxCaptureIteration(timeUs_t currentTimeUs)
+{
+    if (blackboxState == BLACKBOX_STATE_RUNNING) {
+#ifdef USE_BLACKBOX_CAPTURE_WINDOW
+        if (blackboxCaptureWindowIterations) {
+            blackboxCaptureDelayed(currentTimeUs);
+        } else
+#endif
+        // Write a keyframe every blackboxIInterval frames so we can resynchronise upon missing frames
+        if (blackboxShouldLogIFrame()) {
+            blackboxQueueFrame(currentTimeUs, true);
+        } else if (blackboxShouldLogPFrame() && !blackboxFrameRingResync) {
+            blackboxQueueFrame(currentTimeUs, false);
+        }
+    } else if (blackboxState == BLACKBOX_STATE_PAUSED) {
+        // Logging must resume with an I-frame so that we have an "I" base to work from
+        blackboxFrameRingResync = true;
+#ifdef USE_BLACKBOX_CAPTURE_WINDOW
+        // Don't release history from before the pause once logging resumes
+        blackboxDelayLineCount = 0;
+#endif
     } else {
-        blackboxCheckAndLogArmingBeep();
-        blackboxCheckAndLogFlightMode(); // Check for FlightMode status change event
+        return;
+    }
+
+    DEBUG_SET(DEBUG_BLACKBOX, 0, blackboxFramesDropped);
+    DEBUG_SET(DEBUG_BLACKBOX, 1, (blackboxFrameRingHead - blackboxFrameRingTail) & (BLACKBOX_FRAME_RING_SIZE - 1));
 
-        if (blackboxShouldLogPFrame()) {
+    // Keep the logging timers ticking while paused so our log iteration continues to advance
+    blackboxAdvanceIterationTimers();
+}
+
+// Called by the blackbox task to encode the frames captured since it last ran
+STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs)
+{
+    blackboxCheckAndLogArmingBeep();
+    blackboxCheckAndLogFlightMode(); // Check for FlightMode status change event
+
+    while (blackboxFrameRingTail != blackboxFrameRingHead) {
+        const blackboxFrameSnapshot_t *snapshot = &blackboxFrameRing[blackboxFrameRingTail];
+
+        if (snapshot->intraframe) {
+            /*
+             * Don't log a slow frame if the slow data didn't change ("I" frames are already large enough without adding
+             * an additional item to write at the same time). Unless we're *only* logging "I" frames, then we have no choice.
+             */
+            if (blackboxIsOnlyLoggingIntraframes()) {
+                writeSlowFrameIfNeeded();
+            }
+
+            *blackboxHistory[0] = snapshot->state;
+            writeIntraframe(snapshot->iteration);
+        } else {
             /*
              * We assume that slow frames are only interesting in that they aid the interpretation of the main data stream.
              * So only log slow frames during loop iterations where we log a main frame.
              */
             writeSlowFrameIfNeeded();
 
-            loadMainState(currentTimeUs);
+            *blackboxHistory[0] = snapshot->state;
             writeInterframe();
         }
+
+        blackboxFrameRingTail = (blackboxFrameRingTail + 1) & (BLACKBOX_FRAME_RING_SIZE - 1);
+    }
+
 #ifdef USE_GPS
-        if (featureIsEnabled(FEATURE_GPS) && isFieldEnabled(FIELD_SELECT(GPS))) {
-            if (blackboxShouldLogGpsHomeFrame()) {
-                writeGPSHomeFrame();
-                writeGPSFrame(currentTimeUs);
-            } else if (gpsSol.numSat != gpsHistory.GPS_numSat
-                    || gpsSol.llh.lat != gpsHistory.GPS_coord[LAT]
-                    || gpsSol.llh.lon != gpsHistory.GPS_coord[LON]) {
-                //We could check for velocity changes as well but I doubt it changes independent of position
-                writeGPSFrame(currentTimeUs);
-            }
+    if (featureIsEnabled(FEATURE_GPS) && isFieldEnabled(FIELD_SELECT(GPS))) {
+        if (blackboxShouldLogGpsHomeFrame()) {
+            writeGPSHomeFrame();
+            writeGPSFrame(currentTimeUs);
+        } else if (gpsSol.numSat != gpsHistory.GPS_numSat
+                || gpsSol.llh.lat != gpsHistory.GPS_coord[LAT]
+                || gpsSol.llh.lon != gpsHistory.GPS_coord[LON]) {
+            //We could check for velocity changes as well but I doubt it changes independent of position
+            writeGPSFrame(currentTimeUs);
         }
-#endif
+        blackboxGpsHomeFrameDue = false;
     }
+#else
+    UNUSED(currentTimeUs);
+#endif
 
     //Flush every iteration so that our runtime variance is minimized
     blackboxDeviceFlush();
 }
 
 /**
- * Call each flight loop iteration to perform blackbox logging.
+ * Called from the blackbox task to run the logging state machine and encode captured frames.
  */
 void blackboxUpdate(timeUs_t currentTimeUs)
 {
@@ -1664,6 +2041,8 @@ void blackboxUpdate(timeUs_t currentTimeUs)
         if (ARMING_FLAG(ARMED)) {
             blackboxOpen();
             blackboxStart();
+        } else {
+            blackboxDevicePrepareLog();
         }
 #ifdef USE_FLASHFS
         if (IS_RC_MODE_ACTIVE(BOXBLACKBOXERASE)) {
@@ -1758,8 +2137,8 @@ void blackboxUpdate(timeUs_t currentTimeUs)
         }
         break;
     case BLACKBOX_STATE_PAUSED:
-        // Only allow resume to occur during an I-frame iteration, so that we have an "I" base to work from
-        if (IS_RC_MODE_ACTIVE(BOXBLACKBOX) && blackboxShouldLogIFrame()) {
+        // blackboxCaptureIteration() holds back P-frames after a resume until the next I-frame
+        if (IS_RC_MODE_ACTIVE(BOXBLACKBOX)) {
             // Write a log entry so the decoder is aware that our large time/iteration skip is intended
             flightLogEvent_loggingResume_t resume;
 
@@ -1771,18 +2150,14 @@ void blackboxUpdate(timeUs_t currentTimeUs)
 
             blackboxLogIteration(currentTimeUs);
         }
-        // Keep the logging timers ticking so our log iteration continues to advance
-        blackboxAdvanceIterationTimers();
         break;
     case BLACKBOX_STATE_RUNNING:
         // On entry to this state, blackboxIteration, blackboxPFrameIndex and blackboxIFrameIndex are reset to 0
+        blackboxLogIteration(currentTimeUs);
         // Prevent the Pausing of the log on the mode switch if in Motor Test Mode
         if (blackboxModeActivationConditionPresent && !IS_RC_MODE_ACTIVE(BOXBLACKBOX) && !startedLoggingInTestMode) {
             blackboxSetState(BLACKBOX_STATE_PAUSED);
-        } else {
-            blackboxLogIteration(currentTimeUs);
         }
-        blackboxAdvanceIterationTimers();
         break;
     case BLACKBOX_STATE_SHUTTING_DOWN:
         //On entry of this state, startTime is set
@@ -1874,6 +2249,19 @@ uint8_t blackboxGetRateDenom(void)
 
 }
 
+// Number of PID loop iterations between runs of the blackbox task
+uint8_t blackboxGetTaskRateDenom(void)
+{
+    uint8_t denom = MAX(blackboxPInterval, 1);
+#ifdef USE_BLACKBOX_CAPTURE_WINDOW
+    if (blackboxCaptureWindowIterations) {
+        // A capture window queues a frame every iteration, run often enough for the frame ring to absorb that
+        denom = MIN(denom, BLACKBOX_FRAME_RING_SIZE / 2);
+    }
+#endif
+    return denom;
+}
+
 uint16_t blackboxGetPRatio(void) {
     return blackboxIInterval / blackboxPInterval;
 }
@@ -1890,7 +2278,7 @@ void blackboxInit(void)
     blackboxResetIterationTimers();
 
     // an I-frame is written every 32ms
-    // blackboxUpdate() is run in synchronisation with the PID loop
+    // blackboxCaptureIteration() is run in synchronisation with the PID loop
     // targetPidLooptime is 1000 for 1kHz loop, 500 for 2kHz loop etc, targetPidLooptime is rounded for short looptimes
     blackboxIInterval = (uint16_t)(32 * 1000 / targetPidLooptime);
 
@@ -1905,5 +2293,9 @@ void blackboxInit(void)
         blackboxSetState(BLACKBOX_STATE_DISABLED);
     }
     blackboxSInterval = blackboxIInterval * 256; // S-frame is written every 256*32 = 8192ms, approx every 8 seconds
+
+#ifdef USE_BLACKBOX_CAPTURE_WINDOW
+    blackboxCaptureWindowIterations = blackboxConfig()->capture_window_ms * 1000 / targetPidLooptime;
+#endif
 }
 #endif
@@ -46,6 +46,20 @@ typedef enum BlackboxSampleRate { // Sample rate is 1/(2^BlackboxSampleRate)
     BLACKBOX_RATE_16TH
 } BlackboxSampleRate_e;
 
+typedef enum BlackboxPPredictor { // Predictor used for the noisy gyro, acc, debug and motor fields in P-frames
+    BLACKBOX_P_PREDICTOR_AVERAGE = 0,
+    BLACKBOX_P_PREDICTOR_STRAIGHT_LINE
+} BlackboxPPredictor_e;
+
+typedef enum BlackboxCaptureTrigger { // Events which open a full-rate capture window
+    BLACKBOX_CAPTURE_TRIGGER_GYRO_OVERFLOW = 0,
+    BLACKBOX_CAPTURE_TRIGGER_YAW_SPIN,
+    BLACKBOX_CAPTURE_TRIGGER_CRASH_RECOVERY,
+    BLACKBOX_CAPTURE_TRIGGER_DSHOT_TELEMETRY_LOSS,
+    BLACKBOX_CAPTURE_TRIGGER_EXTERNAL,
+    BLACKBOX_CAPTURE_TRIGGER_COUNT
+} BlackboxCaptureTrigger_e;
+
 typedef enum FlightLogEvent {
     FLIGHT_LOG_EVENT_SYNC_BEEP = 0,
     FLIGHT_LOG_EVENT_AUTOTUNE_CYCLE_START = 10,   // UNUSED
@@ -63,6 +77,8 @@ typedef struct blackboxConfig_s {
     uint8_t device;
     uint32_t fields_disabled_mask;
     uint8_t mode;
+    uint8_t p_predictor;
+    uint16_t capture_window_ms; // full-rate logging after a capture trigger, 0 disables capture windows
 } blackboxConfig_t;
 
 PG_DECLARE(blackboxConfig_t, blackboxConfig);
@@ -72,9 +88,12 @@ void blackboxLogEvent(FlightLogEvent event, union flightLogEventData_u *data);
 
 void blackboxInit(void);
 void blackboxUpdate(timeUs_t currentTimeUs);
+void blackboxCaptureIteration(timeUs_t currentTimeUs);
+void blackboxTriggerCaptureWindow(BlackboxCaptureTrigger_e trigger);
 void blackboxSetStartDateTime(const char *dateTime, timeMs_t timeNowMs);
 int blackboxCalculatePDenom(int rateNum, int rateDenom);
 uint8_t blackboxGetRateDenom(void);
+uint8_t blackboxGetTaskRateDenom(void);
 uint16_t blackboxGetPRatio(void);
 uint8_t blackboxCalculateSampleRate(uint16_t pRatio);
 void blackboxValidateConfig(void);
@@ -52,6 +52,7 @@ typedef enum FlightLogFieldCondition {
     FLIGHT_LOG_FIELD_CONDITION_GYRO,
     FLIGHT_LOG_FIELD_CONDITION_ACC,
     FLIGHT_LOG_FIELD_CONDITION_DEBUG_LOG,
+    FLIGHT_LOG_FIELD_CONDITION_DEBUG_LOG_2,
 
     FLIGHT_LOG_FIELD_CONDITION_NEVER,
 
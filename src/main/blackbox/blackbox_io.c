@@ -108,21 +108,30 @@ static uint16_t bbRateMax;
 static uint32_t bbDrops;
 #endif
 
-void blackboxWrite(uint8_t value)
+// Frames are staged here and handed to the device in one write, so the device is
+// dispatched once per frame rather than once per byte. A frame larger than the
+// buffer is simply written in several pieces.
+#define BLACKBOX_FRAME_BUFFER_SIZE 256
+
+static uint8_t blackboxFrameBuffer[BLACKBOX_FRAME_BUFFER_SIZE];
+static int blackboxFrameBufferLength;
+static bool blackboxFrameActive = false;
+
+static void blackboxWriteBuffer(const uint8_t *data, int length)
 {
 #ifdef DEBUG_BB_OUTPUT
-    bbBits += 8;
+    bbBits += 8 * length;
 #endif
 
     switch (blackboxConfig()->device) {
 #ifdef USE_FLASHFS
     case BLACKBOX_DEVICE_FLASH:
-        flashfsWriteByte(value); // Write byte asynchronously
+        flashfsWrite(data, length, false); // Write asynchronously
         break;
 #endif
 #ifdef USE_SDCARD
     case BLACKBOX_DEVICE_SDCARD:
-        afatfs_fputc(blackboxSDCard.logFile, value);
+        afatfs_fwrite(blackboxSDCard.logFile, data, length); // Ignore failures due to buffers filling up
         break;
 #endif
     case BLACKBOX_DEVICE_SERIAL:
@@ -131,18 +140,20 @@ void blackboxWrite(uint8_t value)
             int txBytesFree = serialTxBytesFree(blackboxPort);
 
 #ifdef DEBUG_BB_OUTPUT
-            bbBits += 2;
+            bbBits += 2 * length;
             DEBUG_SET(DEBUG_BLACKBOX_OUTPUT, 3, txBytesFree);
 #endif
 
-            if (txBytesFree == 0) {
+            if (txBytesFree < length) {
 #ifdef DEBUG_BB_OUTPUT
-                ++bbDrops;
+                bbDrops += length - txBytesFree;
                 DEBUG_SET(DEBUG_BLACKBOX_OUTPUT, 2, bbDrops);
 #endif
-                return;
+                length = txBytesFree;
+            }
+            if (length > 0) {
+                serialWriteBuf(blackboxPort, data, length);
             }
-            serialWrite(blackboxPort, value);
         }
         break;
     }
@@ -163,38 +174,57 @@ void blackboxWrite(uint8_t value)
 #endif
 }
 
-// Print the null-terminated string 's' to the blackbox device and return the number of bytes written
-int blackboxWriteString(const char *s)
+static void blackboxFrameBufferFlush(void)
 {
-    int length;
-    const uint8_t *pos;
+    if (blackboxFrameBufferLength > 0) {
+        blackboxWriteBuffer(blackboxFrameBuffer, blackboxFrameBufferLength);
+        blackboxFrameBufferLength = 0;
+    }
+}
 
-    switch (blackboxConfig()->device) {
+// Collect everything written until blackboxFrameEnd() into a single device write
+void blackboxFrameBegin(void)
+{
+    blackboxFrameActive = true;
+}
 
-#ifdef USE_FLASHFS
-    case BLACKBOX_DEVICE_FLASH:
-        length = strlen(s);
-        flashfsWrite((const uint8_t*) s, length, false); // Write asynchronously
-        break;
-#endif // USE_FLASHFS
+void blackboxFrameEnd(void)
+{
+    blackboxFrameBufferFlush();
+    blackboxFrameActive = false;
+}
 
-#ifdef USE_SDCARD
-    case BLACKBOX_DEVICE_SDCARD:
-        length = strlen(s);
-        afatfs_fwrite(blackboxSDCard.logFile, (const uint8_t*) s, length); // Ignore failures due to buffers filling up
-        break;
-#endif // USE_SDCARD
+// Drop everything written since blackboxFrameBegin(), used to time the frame encoding without a device
+void blackboxFrameDiscard(void)
+{
+    blackboxFrameBufferLength = 0;
+    blackboxFrameActive = false;
+}
 
-    case BLACKBOX_DEVICE_SERIAL:
-    default:
-        pos = (uint8_t*) s;
-        while (*pos) {
-            blackboxWrite(*pos);
-            pos++;
+void blackboxWrite(uint8_t value)
+{
+    if (blackboxFrameActive) {
+        blackboxFrameBuffer[blackboxFrameBufferLength++] = value;
+        if (blackboxFrameBufferLength == BLACKBOX_FRAME_BUFFER_SIZE) {
+            blackboxFrameBufferFlush();
         }
+    } else {
+        blackboxWriteBuffer(&value, 1);
+    }
+}
 
-        length = pos - (uint8_t*) s;
-        break;
+// Print the null-terminated string 's' to the blackbox device and return the number of bytes written
+int blackboxWriteString(const char *s)
+{
+    const int length = strlen(s);
+
+    if (blackboxFrameActive) {
+        // keep the string in order with the rest of the staged frame
+        for (int i = 0; i < length; i++) {
+            blackboxWrite(s[i]);
+        }
+    } else {
+        blackboxWriteBuffer((const uint8_t *)s, length);
     }
 
     return length;
@@ -214,7 +244,7 @@ void blackboxDeviceFlush(void)
          * devices will progressively write in the background without Blackbox calling anything.
          */
     case BLACKBOX_DEVICE_FLASH:
-        flashfsFlushAsync();
+        flashfsFlushAsync(false);
         break;
 #endif // USE_FLASHFS
 
@@ -237,7 +267,7 @@ bool blackboxDeviceFlushForce(void)
 
 #ifdef USE_FLASHFS
     case BLACKBOX_DEVICE_FLASH:
-        return flashfsFlushAsync();
+        return flashfsFlushAsync(true);
 #endif // USE_FLASHFS
 
 #ifdef USE_SDCARD
@@ -346,6 +376,7 @@ bool blackboxDeviceOpen(void)
         }
 
         blackboxMaxHeaderBytesPerIteration = BLACKBOX_TARGET_HEADER_BUDGET_PER_ITERATION;
+        flashfsResetWriteStats(); // Report the write buffer statistics of the latest log in flash_info
 
         return true;
         break;
@@ -449,6 +480,16 @@ static void blackboxLogDirCreated(afatfsFilePtr_t directory)
 static void blackboxLogFileCreated(afatfsFilePtr_t file)
 {
     if (file) {
+        uint32_t fileSize;
+
+        if (afatfs_ftell(file, &fileSize) && fileSize > 0) {
+            // A log with this number is on the card already, so the number of the last log is out of date. Find it again
+            afatfs_fclose(file, NULL);
+
+            blackboxSDCard.state = BLACKBOX_SDCARD_INITIAL;
+            return;
+        }
+
         blackboxSDCard.logFile = file;
 
         blackboxSDCard.largestLogFileNumber++;
@@ -477,18 +518,20 @@ static void blackboxCreateLogFile(void)
 }
 
 /**
- * Begin a new log on the SDCard.
+ * Open the log directory and find the number of the last log in it. This is done once, and the number is then kept
+ * up to date as logs are created.
  *
- * Keep calling until the function returns true (open is complete).
+ * Keep calling until the function returns true (the log directory is the working directory).
  */
-static bool blackboxSDCardBeginLog(void)
+static bool blackboxSDCardPrepareLogDirectory(void)
 {
     fatDirectoryEntry_t *directoryEntry;
 
     doMore:
     switch (blackboxSDCard.state) {
     case BLACKBOX_SDCARD_INITIAL:
-        if (afatfs_getFilesystemState() == AFATFS_FILESYSTEM_STATE_READY) {
+        // The log directory is found from the root directory
+        if (afatfs_getFilesystemState() == AFATFS_FILESYSTEM_STATE_READY && afatfs_chdir(NULL)) {
             blackboxSDCard.state = BLACKBOX_SDCARD_WAITING;
 
             afatfs_mkdir("logs", blackboxLogDirCreated);
@@ -530,16 +573,37 @@ static bool blackboxSDCardBeginLog(void)
             blackboxSDCard.logDirectory = NULL;
 
             blackboxSDCard.state = BLACKBOX_SDCARD_READY_TO_CREATE_LOG;
-            goto doMore;
+            return true;
         }
         break;
 
     case BLACKBOX_SDCARD_READY_TO_CREATE_LOG:
-        blackboxCreateLogFile();
-        break;
-
     case BLACKBOX_SDCARD_READY_TO_LOG:
-        return true; // Log has been created!
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Begin a new log on the SDCard.
+ *
+ * Keep calling until the function returns true (open is complete).
+ */
+static bool blackboxSDCardBeginLog(void)
+{
+    if (blackboxSDCardPrepareLogDirectory()) {
+        switch (blackboxSDCard.state) {
+        case BLACKBOX_SDCARD_READY_TO_CREATE_LOG:
+            blackboxCreateLogFile();
+            break;
+
+        case BLACKBOX_SDCARD_READY_TO_LOG:
+            return true; // Log has been created!
+
+        default:
+            ;
+        }
     }
 
     // Not finished init yet
@@ -548,6 +612,23 @@ static bool blackboxSDCardBeginLog(void)
 
 #endif // USE_SDCARD
 
+/**
+ * Get the device ready for a log to begin while logging is stopped, so that the log can begin soon after arming (for
+ * devices which support separations between the logs of multiple flights).
+ */
+void blackboxDevicePrepareLog(void)
+{
+    switch (blackboxConfig()->device) {
+#ifdef USE_SDCARD
+    case BLACKBOX_DEVICE_SDCARD:
+        blackboxSDCardPrepareLogDirectory();
+        break;
+#endif // USE_SDCARD
+    default:
+        ;
+    }
+}
+
 /**
  * Begin a new log (for devices which support separations between the logs of multiple flights).
  *
@@ -730,7 +811,7 @@ blackboxBufferReserveStatus_e blackboxDeviceReserveBufferSpace(int32_t bytes)
              * that the Blackbox header writing code doesn't have to guess about the best time to ask flashfs to
              * flush, and doesn't stall waiting for a flush that would otherwise not automatically be called.
              */
-            flashfsFlushAsync();
+            flashfsFlushAsync(true);
         }
         return BLACKBOX_RESERVE_TEMPORARY_FAILURE;
 #endif // USE_FLASHFS
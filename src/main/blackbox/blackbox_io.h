@@ -42,6 +42,9 @@ extern int32_t blackboxHeaderBudget;
 
 void blackboxOpen(void);
 void blackboxWrite(uint8_t value);
+void blackboxFrameBegin(void);
+void blackboxFrameEnd(void);
+void blackboxFrameDiscard(void);
 int blackboxWriteString(const char *s);
 
 void blackboxDeviceFlush(void);
@@ -54,6 +57,7 @@ void blackboxDeviceClose(void);
 void blackboxEraseAll(void);
 bool isBlackboxErased(void);
 
+void blackboxDevicePrepareLog(void);
 bool blackboxDeviceBeginLog(void);
 bool blackboxDeviceEndLog(bool retainLog);
 
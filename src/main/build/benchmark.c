@@ -0,0 +1,230 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_BENCHMARK
+
+#include "blackbox/blackbox.h"
+#include "blackbox/blackbox_encoding.h"
+#include "blackbox/blackbox_io.h"
+
+#include "common/maths.h"
+#include "common/utils.h"
+
+#include "config/config.h"
+
+#include "drivers/dshot.h"
+#include "drivers/dshot_bitbang_decode.h"
+#include "drivers/dshot_dpwm.h"
+#include "drivers/system.h"
+#include "drivers/time.h"
+
+#include "flight/mixer.h"
+#include "flight/pid.h"
+
+#include "sensors/gyro.h"
+
+#include "benchmark.h"
+
+// Each kernel is timed per call with the cycle counter while the interrupts keep running, so the minimum is
+// the undisturbed time of the kernel and the average includes what the interrupts took from it. The kernels
+// work on the live flight state, the CLI only runs disarmed and arming is refused while it is active.
+
+typedef struct benchmark_s {
+    const char *name;
+    void (*setup)(void);
+    bool (*run)(void);      // false if the kernel can not run now
+} benchmark_t;
+
+static volatile uint32_t benchmarkSink;
+
+static bool benchmarkGyroFiltering(void)
+{
+    gyroFiltering(micros());
+    return true;
+}
+
+static bool benchmarkPidController(void)
+{
+    pidController(currentPidProfile, micros());
+    return true;
+}
+
+static bool benchmarkMixTable(void)
+{
+    mixTable(micros());
+    return true;
+}
+
+#ifdef USE_DSHOT
+static bool benchmarkDshotEncode(void)
+{
+    static DSHOT_DMA_BUFFER_UNIT dmaBuffer[DSHOT_DMA_BUFFER_SIZE];
+    static dshotProtocolControl_t pcb;
+
+    pcb.value = (pcb.value + 1) & DSHOT_MAX_THROTTLE;
+    pcb.requestTelemetry = false;
+    const uint16_t packet = prepareDshotPacket(&pcb);
+    loadDmaBufferDshot((uint32_t *)dmaBuffer, 1, packet);
+    benchmarkSink = dmaBuffer[0];
+
+    return true;
+}
+#endif
+
+#if defined(USE_DSHOT_BITBANG) && defined(USE_DSHOT_TELEMETRY)
+#define BENCHMARK_BB_PINS 4
+#define BENCHMARK_BB_IDLE_SAMPLES 8
+#define BENCHMARK_BB_SAMPLES (BENCHMARK_BB_IDLE_SAMPLES + 21 * 3 + 24)
+
+static uint16_t benchmarkBbCapture[BENCHMARK_BB_SAMPLES];
+
+// Capture of four motors on one port, each sending a valid eRPM frame at 3x oversampling
+static void benchmarkDshotDecodeSetup(void)
+{
+    static const uint8_t gcr[16] = {
+        0x19, 0x1b, 0x12, 0x13, 0x1d, 0x15, 0x16, 0x17, 0x1a, 0x09, 0x0a, 0x0b, 0x1e, 0x0d, 0x0e, 0x0f };
+
+    memset(benchmarkBbCapture, 0, sizeof(benchmarkBbCapture));
+    for (int pin = 0; pin < BENCHMARK_BB_PINS; pin++) {
+        const uint16_t value = 0x2a5 + pin * 0x111;
+        const uint16_t csum = ~(value ^ (value >> 4) ^ (value >> 8)) & 0xf;
+        const uint16_t data = (value << 4) | csum;
+
+        // every one bit of the start bit and the GCR code is an edge of the inverted signal
+        uint32_t bits = 1 << 20;
+        for (int nibble = 0; nibble < 4; nibble++) {
+            bits |= gcr[(data >> (nibble * 4)) & 0xf] << (nibble * 5);
+        }
+
+        uint16_t level = 1 << pin;
+        int sample = 0;
+        while (sample < BENCHMARK_BB_IDLE_SAMPLES) {
+            benchmarkBbCapture[sample++] |= level;
+        }
+        for (int bit = 20; bit >= 0; bit--) {
+            if (bits & (1 << bit)) {
+                level ^= 1 << pin;
+            }
+            for (int i = 0; i < 3; i++) {
+                benchmarkBbCapture[sample++] |= level;
+            }
+        }
+        while (sample < BENCHMARK_BB_SAMPLES) {
+            benchmarkBbCapture[sample++] |= level;
+        }
+    }
+}
+
+static bool benchmarkDshotDecode(void)
+{
+    uint32_t values[16];
+    decode_bb_port(benchmarkBbCapture, BENCHMARK_BB_SAMPLES, (1 << BENCHMARK_BB_PINS) - 1, values);
+    benchmarkSink = values[0];
+
+    return true;
+}
+#endif
+
+#ifdef USE_BLACKBOX
+// Deltas of a P frame, written to the frame buffer which is then dropped instead of handed to the device
+static bool benchmarkBlackboxFrame(void)
+{
+    static int32_t deltas[8] = { 3, -12, 7, 0, -1, 95, -260, 14 };
+
+    if (!blackboxMayEditConfig()) {
+        // the log owns the frame buffer
+        return false;
+    }
+
+    deltas[0]++;
+    blackboxFrameBegin();
+    blackboxWrite('P');
+    blackboxWriteSignedVB(deltas[0]);
+    blackboxWriteTag2_3S32(deltas);
+    blackboxWriteSignedVBArray(deltas, 3);
+    blackboxWriteSignedVBArray(deltas + 3, 3);
+    blackboxWriteTag8_4S16(deltas);
+    blackboxWriteSignedVBArray(deltas, 8);
+    blackboxWriteSignedVBArray(deltas + 4, 4);
+    blackboxFrameDiscard();
+
+    return true;
+}
+#endif
+
+static const benchmark_t benchmarks[] = {
+    { "gyro_filter", NULL, benchmarkGyroFiltering },
+    { "pid_controller", NULL, benchmarkPidController },
+    { "mix_table", NULL, benchmarkMixTable },
+#ifdef USE_DSHOT
+    { "dshot_encode", NULL, benchmarkDshotEncode },
+#endif
+#if defined(USE_DSHOT_BITBANG) && defined(USE_DSHOT_TELEMETRY)
+    { "dshot_decode", benchmarkDshotDecodeSetup, benchmarkDshotDecode },
+#endif
+#ifdef USE_BLACKBOX
+    { "blackbox_frame", NULL, benchmarkBlackboxFrame },
+#endif
+};
+
+int benchmarkCount(void)
+{
+    return ARRAYLEN(benchmarks);
+}
+
+const char *benchmarkName(int index)
+{
+    return benchmarks[index].name;
+}
+
+bool benchmarkRun(int index, uint32_t iterations, benchmarkResult_t *result)
+{
+    const benchmark_t *benchmark = &benchmarks[index];
+
+    memset(result, 0, sizeof(*result));
+    result->minCycles = UINT32_MAX;
+
+    if (benchmark->setup) {
+        benchmark->setup();
+    }
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        const uint32_t startCycles = getCycleCounter();
+        if (!benchmark->run()) {
+            return false;
+        }
+        const uint32_t cycles = getCycleCounter() - startCycles;
+
+        result->minCycles = MIN(result->minCycles, cycles);
+        result->maxCycles = MAX(result->maxCycles, cycles);
+        result->totalCycles += cycles;
+        result->count++;
+    }
+
+    return true;
+}
+
+#endif
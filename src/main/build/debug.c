@@ -19,13 +19,20 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
+#include "config/config.h"
+
 #include "debug.h"
 
-int16_t debug[DEBUG16_VALUE_COUNT];
-uint8_t debugMode;
+int32_t debug[DEBUG_VALUE_STORAGE_COUNT];
+uint8_t debugModes[DEBUG_GROUP_COUNT];
+
+#ifdef USE_DEBUG_MODES
+uint8_t debugModeOffset[DEBUG_COUNT];
+#endif
 
 #ifdef DEBUG_SECTION_TIMES
 uint32_t sectionTimes[2][4];
@@ -98,4 +105,31 @@ const char * const debugModeNames[DEBUG_COUNT] = {
     "RX_TIMING",
     "D_LPF",
     "VTX_TRAMP",
+    "MOTOR_LAG_COMP",
+    "BLACKBOX",
+    "LATENCY",
+    "GYRO_FUSION",
+    "GYRO_SAMPLE_DT",
 };
+
+void debugInit(void)
+{
+    memset(debugModes, DEBUG_NONE, sizeof(debugModes));
+
+#ifdef USE_DEBUG_MODES
+    const uint8_t selectedModes[DEBUG_GROUP_COUNT] = { systemConfig()->debug_mode, systemConfig()->debug_mode_2 };
+
+    memset(debugModeOffset, DEBUG_VALUE_COUNT, sizeof(debugModeOffset));
+
+    // the selected modes take the debug[] groups in order, so a single mode always logs to debug[0..3]
+    unsigned group = 0;
+    for (unsigned i = 0; i < DEBUG_GROUP_COUNT; i++) {
+        const uint8_t mode = selectedModes[i];
+        if (mode != DEBUG_NONE && mode < DEBUG_COUNT && !debugModeIsEnabled(mode)) {
+            debugModes[group] = mode;
+            debugModeOffset[mode] = group * DEBUG_GROUP_VALUE_COUNT;
+            group++;
+        }
+    }
+#endif
+}
@@ -20,11 +20,16 @@
 
 #pragma once
 
-#define DEBUG16_VALUE_COUNT 4
-extern int16_t debug[DEBUG16_VALUE_COUNT];
-extern uint8_t debugMode;
+#include <stdbool.h>
+#include <stdint.h>
 
-#define DEBUG_SET(mode, index, value) {if (debugMode == (mode)) {debug[(index)] = (value);}}
+#define DEBUG_GROUP_VALUE_COUNT 4   // values written by each debug mode
+#define DEBUG_GROUP_COUNT 2         // debug modes that can be selected at the same time
+#define DEBUG_VALUE_COUNT (DEBUG_GROUP_COUNT * DEBUG_GROUP_VALUE_COUNT)
+// the values of the debug modes that are not selected go to a spare group after the logged ones
+#define DEBUG_VALUE_STORAGE_COUNT (DEBUG_VALUE_COUNT + DEBUG_GROUP_VALUE_COUNT)
+
+extern int32_t debug[DEBUG_VALUE_STORAGE_COUNT];
 
 #define DEBUG_SECTION_TIMES
 
@@ -114,7 +119,40 @@ typedef enum {
     DEBUG_RX_TIMING,
     DEBUG_D_LPF,
     DEBUG_VTX_TRAMP,
+    DEBUG_MOTOR_LAG_COMP,
+    DEBUG_BLACKBOX,
+    DEBUG_LATENCY,
+    DEBUG_GYRO_FUSION,
+    DEBUG_GYRO_SAMPLE_DT,
     DEBUG_COUNT
 } debugType_e;
 
 extern const char * const debugModeNames[DEBUG_COUNT];
+
+extern uint8_t debugModes[DEBUG_GROUP_COUNT];
+
+#ifdef USE_DEBUG_MODES
+// index of the first debug[] value of each debug mode, DEBUG_VALUE_COUNT for the modes not selected
+extern uint8_t debugModeOffset[DEBUG_COUNT];
+
+// the value is always evaluated and stored, so keep it cheap and free of side effects
+#define DEBUG_SET(mode, index, value) {debug[debugModeOffset[(mode)] + (index)] = (value);}
+
+static inline bool debugModeIsEnabled(debugType_e mode)
+{
+    return debugModeOffset[mode] < DEBUG_VALUE_COUNT;
+}
+#else
+#define DEBUG_SET(mode, index, value) {(void)(mode); (void)(index); (void)(value);}
+
+static inline bool debugModeIsEnabled(debugType_e mode)
+{
+    (void)mode;
+    return false;
+}
+#endif
+
+// for values that are costly to get, such as timings or register reads, only evaluated for a selected mode
+#define DEBUG_SET_IF_ENABLED(mode, index, value) {if (debugModeIsEnabled(mode)) {DEBUG_SET(mode, index, value);}}
+
+void debugInit(void);
@@ -0,0 +1,69 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_IRQ_LOAD_STATS
+
+#include "build/atomic.h"
+
+#include "drivers/nvic.h"
+#include "drivers/time.h"
+
+#include "irq_load.h"
+
+static FAST_DATA_ZERO_INIT irqLoadStats_t irqLoadStats[IRQ_LOAD_TYPE_COUNT][IRQ_LOAD_INSTANCE_COUNT];
+static uint32_t irqLoadResetTimeUs;
+
+FAST_CODE void irqLoadAdd(irqLoadType_e type, unsigned instance, uint32_t cycles)
+{
+    if (instance >= IRQ_LOAD_INSTANCE_COUNT) {
+        return;
+    }
+
+    irqLoadStats_t *stats = &irqLoadStats[type][instance];
+    if (cycles > stats->maxCycles) {
+        stats->maxCycles = cycles;
+    }
+    stats->totalCycles += cycles;
+    stats->count++;
+}
+
+uint32_t irqLoadGetAndResetStats(irqLoadStats_t stats[IRQ_LOAD_TYPE_COUNT][IRQ_LOAD_INSTANCE_COUNT])
+{
+    uint32_t elapsedUs;
+
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        const timeUs_t currentTimeUs = micros();
+        elapsedUs = cmpTimeUs(currentTimeUs, irqLoadResetTimeUs);
+        irqLoadResetTimeUs = currentTimeUs;
+
+        memcpy(stats, irqLoadStats, sizeof(irqLoadStats));
+        memset(irqLoadStats, 0, sizeof(irqLoadStats));
+    }
+
+    return elapsedUs;
+}
+
+#endif // USE_IRQ_LOAD_STATS
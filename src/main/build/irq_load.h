@@ -0,0 +1,56 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Time spent in interrupt handlers per interrupt source, build with OPTIONS=USE_IRQ_LOAD_STATS.
+// The cycles are counted from entry to exit of the dispatching handler, so a handler that is
+// preempted by a higher priority interrupt is also charged with the time of the preempting one.
+
+typedef enum {
+    IRQ_LOAD_DMA = 0,   // instance is the DMA descriptor index
+    IRQ_LOAD_EXTI,      // instance is the EXTI line
+    IRQ_LOAD_UART,      // instance is the UART device index
+    IRQ_LOAD_TYPE_COUNT
+} irqLoadType_e;
+
+#define IRQ_LOAD_INSTANCE_COUNT 16
+
+typedef struct irqLoadStats_s {
+    uint64_t totalCycles;
+    uint32_t maxCycles;
+    uint32_t count;
+} irqLoadStats_t;
+
+#ifdef USE_IRQ_LOAD_STATS
+#include "drivers/system.h"
+
+void irqLoadAdd(irqLoadType_e type, unsigned instance, uint32_t cycles);
+// Copies the statistics gathered since the previous call and restarts them, returns the time covered
+uint32_t irqLoadGetAndResetStats(irqLoadStats_t stats[IRQ_LOAD_TYPE_COUNT][IRQ_LOAD_INSTANCE_COUNT]);
+
+#define IRQ_LOAD_BEGIN() const uint32_t irqLoadStartCycles = getCycleCounter()
+#define IRQ_LOAD_END(type, instance) irqLoadAdd((type), (instance), getCycleCounter() - irqLoadStartCycles)
+#else
+#define IRQ_LOAD_BEGIN()
+#define IRQ_LOAD_END(type, instance)
+#endif
@@ -0,0 +1,227 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_LATENCY_STATS
+
+#include "build/debug.h"
+
+#include "common/maths.h"
+
+#include "drivers/system.h"
+
+#include "latency.h"
+
+#if defined(USE_DEBUG_PIN)
+#include "build/debug_pin.h"
+#else
+#define dbgPinHi(x)
+#define dbgPinLo(x)
+#endif
+
+// Held high from the gyro interrupt until the motor DMA starts; indices 0 and 1 are used by the bitbang driver
+#define LATENCY_DEBUG_PIN 2
+
+// DEBUG_LATENCY, time from the gyro data ready interrupt in 0.1us to:
+// 0 - sample read by taskGyroSample()
+// 1 - taskFiltering()
+// 2 - taskMainPidLoop()
+// 3 - motor output DMA start
+
+// DEBUG_RX_TIMING, time from the RX frame in 10us to:
+// 2 - setpoints updated by processRcCommand()
+// 3 - motor output DMA start
+
+static const char * const latencyStageNames[LATENCY_STAGE_COUNT] = {
+    "GYRO_EXTI",
+    "GYRO_SAMPLE",
+    "FILTER",
+    "PID",
+    "MOTOR_UPDATE",
+    "MOTOR_OUTPUT",
+};
+
+static const char * const rxLatencyStageNames[RX_LATENCY_STAGE_COUNT] = {
+    "FRAME",
+    "PROCESSED",
+    "SETPOINT",
+    "MOTOR_OUTPUT",
+};
+
+// The interrupt and read times of the latest sample, latched into the frame when filtering starts on it.
+// With pid_process_denom > 1 several samples are read between filtering and the PID loop.
+static FAST_DATA_ZERO_INIT uint32_t sampleExtiCycles;
+static FAST_DATA_ZERO_INIT uint32_t sampleReadCycles;
+static FAST_DATA_ZERO_INIT uint32_t sampleOriginCycles;
+static FAST_DATA_ZERO_INIT bool sampleExtiPending;
+
+static FAST_DATA_ZERO_INIT uint32_t frameCycles[LATENCY_STAGE_COUNT];
+static FAST_DATA_ZERO_INIT bool frameValid;
+
+static FAST_DATA_ZERO_INIT latencyStats_t latencyStats[LATENCY_STAGE_COUNT];
+
+// The RX frame being followed through to the motors and the last stage it has reached
+static FAST_DATA_ZERO_INIT uint32_t rxFrameCycles[RX_LATENCY_STAGE_COUNT];
+static FAST_DATA_ZERO_INIT rxLatencyStage_e rxFrameStage;
+
+static FAST_DATA_ZERO_INIT latencyStats_t rxLatencyStats[RX_LATENCY_STAGE_COUNT];
+
+static void updateStats(latencyStats_t *stats, uint32_t cycles)
+{
+    if (stats->count == 0 || cycles < stats->minCycles) {
+        stats->minCycles = cycles;
+    }
+    if (cycles > stats->maxCycles) {
+        stats->maxCycles = cycles;
+    }
+    stats->totalCycles += cycles;
+    stats->count++;
+}
+
+static int16_t latencyDebugValue(latencyStage_e stage)
+{
+    const uint32_t latency10thUs = clockCyclesTo10thMicros(frameCycles[stage] - frameCycles[LATENCY_STAGE_GYRO_EXTI]);
+    return MIN(latency10thUs, (uint32_t)INT16_MAX);
+}
+
+static FAST_CODE_NOINLINE void latencyUpdateStats(void)
+{
+    for (int stage = LATENCY_STAGE_GYRO_SAMPLE; stage < LATENCY_STAGE_COUNT; stage++) {
+        updateStats(&latencyStats[stage], frameCycles[stage] - frameCycles[LATENCY_STAGE_GYRO_EXTI]);
+    }
+
+    if (debugModeIsEnabled(DEBUG_LATENCY)) {
+        debug[0] = latencyDebugValue(LATENCY_STAGE_GYRO_SAMPLE);
+        debug[1] = latencyDebugValue(LATENCY_STAGE_FILTER);
+        debug[2] = latencyDebugValue(LATENCY_STAGE_PID);
+        debug[3] = latencyDebugValue(LATENCY_STAGE_MOTOR_OUTPUT);
+    }
+}
+
+static FAST_CODE_NOINLINE void latencyUpdateRxStats(void)
+{
+    for (int stage = RX_LATENCY_STAGE_PROCESSED; stage < RX_LATENCY_STAGE_COUNT; stage++) {
+        updateStats(&rxLatencyStats[stage], rxFrameCycles[stage] - rxFrameCycles[RX_LATENCY_STAGE_FRAME]);
+    }
+
+    if (debugModeIsEnabled(DEBUG_RX_TIMING)) {
+        for (int stage = RX_LATENCY_STAGE_SETPOINT; stage < RX_LATENCY_STAGE_COUNT; stage++) {
+            const uint32_t latency10Us = clockCyclesTo10thMicros(rxFrameCycles[stage] - rxFrameCycles[RX_LATENCY_STAGE_FRAME]) / 100;
+            debug[stage] = MIN(latency10Us, (uint32_t)INT16_MAX);
+        }
+    }
+}
+
+FAST_CODE void latencyMark(latencyStage_e stage)
+{
+    const uint32_t nowCycles = getCycleCounter();
+
+    switch (stage) {
+    case LATENCY_STAGE_GYRO_EXTI:
+        dbgPinHi(LATENCY_DEBUG_PIN);
+        sampleExtiCycles = nowCycles;
+        sampleExtiPending = true;
+        break;
+
+    case LATENCY_STAGE_GYRO_SAMPLE:
+        // Without a data ready interrupt (polled gyro) the read is the earliest known time of the sample
+        sampleOriginCycles = sampleExtiPending ? sampleExtiCycles : nowCycles;
+        sampleReadCycles = nowCycles;
+        sampleExtiPending = false;
+        break;
+
+    case LATENCY_STAGE_FILTER:
+        frameCycles[LATENCY_STAGE_GYRO_EXTI] = sampleOriginCycles;
+        frameCycles[LATENCY_STAGE_GYRO_SAMPLE] = sampleReadCycles;
+        frameCycles[LATENCY_STAGE_FILTER] = nowCycles;
+        frameValid = true;
+        break;
+
+    case LATENCY_STAGE_MOTOR_OUTPUT:
+        dbgPinLo(LATENCY_DEBUG_PIN);
+        if (rxFrameStage == RX_LATENCY_STAGE_SETPOINT) {
+            rxFrameCycles[RX_LATENCY_STAGE_MOTOR_OUTPUT] = nowCycles;
+            rxFrameStage = RX_LATENCY_STAGE_MOTOR_OUTPUT;
+            latencyUpdateRxStats();
+        }
+        // Motor output outside the PID loop (eg. stopMotors()) does not complete a frame
+        if (frameValid) {
+            frameCycles[LATENCY_STAGE_MOTOR_OUTPUT] = nowCycles;
+            frameValid = false;
+            latencyUpdateStats();
+        }
+        break;
+
+    default:
+        frameCycles[stage] = nowCycles;
+        break;
+    }
+}
+
+// Called once the channels of a new frame have been decoded, frameAgeUs is the time since the driver received it
+void latencyRxFrame(int32_t frameAgeUs)
+{
+    const uint32_t nowCycles = getCycleCounter();
+
+    rxFrameCycles[RX_LATENCY_STAGE_FRAME] = nowCycles - clockMicrosToCycles(MAX(frameAgeUs, 0));
+    rxFrameCycles[RX_LATENCY_STAGE_PROCESSED] = nowCycles;
+    rxFrameStage = RX_LATENCY_STAGE_PROCESSED;
+}
+
+FAST_CODE void latencyRxSetpoint(void)
+{
+    if (rxFrameStage == RX_LATENCY_STAGE_PROCESSED) {
+        rxFrameCycles[RX_LATENCY_STAGE_SETPOINT] = getCycleCounter();
+        rxFrameStage = RX_LATENCY_STAGE_SETPOINT;
+    }
+}
+
+void latencyResetStats(void)
+{
+    memset(latencyStats, 0, sizeof(latencyStats));
+    memset(rxLatencyStats, 0, sizeof(rxLatencyStats));
+}
+
+void getLatencyStats(latencyStage_e stage, latencyStats_t *stats)
+{
+    *stats = latencyStats[stage];
+}
+
+void getRxLatencyStats(rxLatencyStage_e stage, latencyStats_t *stats)
+{
+    *stats = rxLatencyStats[stage];
+}
+
+const char *getLatencyStageName(latencyStage_e stage)
+{
+    return latencyStageNames[stage];
+}
+
+const char *getRxLatencyStageName(rxLatencyStage_e stage)
+{
+    return rxLatencyStageNames[stage];
+}
+
+#endif // USE_LATENCY_STATS
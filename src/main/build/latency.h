@@ -0,0 +1,67 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Stages of the path from a gyro sample to the start of the motor frame built from it
+typedef enum {
+    LATENCY_STAGE_GYRO_EXTI = 0,    // gyro data ready interrupt
+    LATENCY_STAGE_GYRO_SAMPLE,      // taskGyroSample() read the sample
+    LATENCY_STAGE_FILTER,           // taskFiltering() started on the sample
+    LATENCY_STAGE_PID,              // taskMainPidLoop() started
+    LATENCY_STAGE_MOTOR_UPDATE,     // subTaskMotorUpdate() started
+    LATENCY_STAGE_MOTOR_OUTPUT,     // motor output DMA started
+    LATENCY_STAGE_COUNT
+} latencyStage_e;
+
+// Stages of the path from a received RC frame to the first motor frame built from its setpoints
+typedef enum {
+    RX_LATENCY_STAGE_FRAME = 0,     // frame received, as time stamped by the RX protocol driver
+    RX_LATENCY_STAGE_PROCESSED,     // processRx() decoded the channels
+    RX_LATENCY_STAGE_SETPOINT,      // processRcCommand() applied them to the setpoints
+    RX_LATENCY_STAGE_MOTOR_OUTPUT,  // motor output DMA started
+    RX_LATENCY_STAGE_COUNT
+} rxLatencyStage_e;
+
+typedef struct latencyStats_s {
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint64_t totalCycles;
+    uint32_t count;
+} latencyStats_t;
+
+#ifdef USE_LATENCY_STATS
+void latencyMark(latencyStage_e stage);
+void latencyRxFrame(int32_t frameAgeUs);
+void latencyRxSetpoint(void);
+void latencyResetStats(void);
+void getLatencyStats(latencyStage_e stage, latencyStats_t *stats);
+void getRxLatencyStats(rxLatencyStage_e stage, latencyStats_t *stats);
+const char *getLatencyStageName(latencyStage_e stage);
+const char *getRxLatencyStageName(rxLatencyStage_e stage);
+
+#define LATENCY_MARK(stage) latencyMark(stage)
+#define LATENCY_RX_FRAME(frameAgeUs) latencyRxFrame(frameAgeUs)
+#define LATENCY_RX_SETPOINT() latencyRxSetpoint()
+#else
+#define LATENCY_MARK(stage) {}
+#define LATENCY_RX_FRAME(frameAgeUs) {}
+#define LATENCY_RX_SETPOINT() {}
+#endif
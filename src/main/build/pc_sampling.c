@@ -0,0 +1,79 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Statistical profiler, the SysTick handler records the program counter of the code it interrupted.
+ *
+ * MSP2_PC_SAMPLES drains the samples, the host aggregates them over time and looks the addresses up in
+ * the elf to show where the CPU time goes. On F7 and H7 SysTick has the highest priority and on F4 it is
+ * raised to NVIC_PRIO_MAX, so the samples include the interrupt handlers as well, apart from code that
+ * runs with interrupts masked at NVIC_PRIO_MAX.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_PC_SAMPLING
+
+#include "pc_sampling.h"
+
+// single producer (SysTick) single consumer (MSP) ring, the indices run free and wrap at 16 bits
+static volatile uint32_t pcSamples[PC_SAMPLE_BUFFER_SIZE];
+static volatile uint16_t pcSampleHead;
+static volatile uint16_t pcSampleTail;
+static volatile uint16_t pcSamplesLost;
+
+void pcSamplingRecord(uint32_t pc)
+{
+    const uint16_t head = pcSampleHead;
+
+    if ((uint16_t)(head - pcSampleTail) >= PC_SAMPLE_BUFFER_SIZE) {
+        // not read in time, keep the older samples so the reader sees an unbroken run
+        pcSamplesLost++;
+        return;
+    }
+
+    pcSamples[head & (PC_SAMPLE_BUFFER_SIZE - 1)] = pc;
+    pcSampleHead = head + 1;
+}
+
+bool pcSamplingRead(uint32_t *pc)
+{
+    const uint16_t tail = pcSampleTail;
+
+    if (tail == pcSampleHead) {
+        return false;
+    }
+
+    *pc = pcSamples[tail & (PC_SAMPLE_BUFFER_SIZE - 1)];
+    pcSampleTail = tail + 1;
+
+    return true;
+}
+
+// Samples dropped because the buffer was full, runs free so the host can tell how many it missed between reads
+uint16_t pcSamplingLostCount(void)
+{
+    return pcSamplesLost;
+}
+
+#endif
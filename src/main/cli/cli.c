@@ -36,14 +36,18 @@ bool cliMode = false;
 
 #include "blackbox/blackbox.h"
 
+#include "build/benchmark.h"
 #include "build/build_config.h"
 #include "build/debug.h"
+#include "build/irq_load.h"
+#include "build/latency.h"
 #include "build/version.h"
 
 #include "cli/settings.h"
 
 #include "cms/cms.h"
 
+#include "common/arena.h"
 #include "common/axis.h"
 #include "common/color.h"
 #include "common/maths.h"
@@ -68,6 +72,7 @@ bool cliMode = false;
 #include "drivers/dshot.h"
 #include "drivers/dshot_command.h"
 #include "drivers/dshot_dpwm.h"
+#include "drivers/persistent.h"
 #include "drivers/pwm_output_dshot_shared.h"
 #include "drivers/camera_control.h"
 #include "drivers/compass/compass.h"
@@ -177,11 +182,12 @@ static serialPort_t *cliPort = NULL;
 
 #ifdef STM32F1
 #define CLI_IN_BUFFER_SIZE 128
+#define CLI_OUT_BUFFER_SIZE 64
 #else
 // Space required to set array parameters
 #define CLI_IN_BUFFER_SIZE 256
+#define CLI_OUT_BUFFER_SIZE 256
 #endif
-#define CLI_OUT_BUFFER_SIZE 64
 
 static bufWriter_t *cliWriter = NULL;
 static bufWriter_t *cliErrorWriter = NULL;
@@ -192,6 +198,9 @@ static uint32_t bufferIndex = 0;
 
 static bool configIsInCopy = false;
 
+// While set, output is only written out once the buffer is full or cliWriterFlush() is called
+static bool cliOutputBuffered = false;
+
 #define CURRENT_PROFILE_INDEX -1
 static int8_t pidProfileIndexToUse = CURRENT_PROFILE_INDEX;
 static int8_t rateProfileIndexToUse = CURRENT_PROFILE_INDEX;
@@ -223,6 +232,18 @@ extern char __custom_defaults_end;
 static bool processingCustomDefaults = false;
 static char cliBufferTemp[CLI_IN_BUFFER_SIZE];
 
+#if defined(USE_CUSTOM_DEFAULTS_IMAGE)
+#ifndef CUSTOM_DEFAULTS_IMAGE_SIZE
+#define CUSTOM_DEFAULTS_IMAGE_SIZE 2048
+#endif
+
+// The parameter groups the custom defaults change, each stored as its pgn followed by the group.
+// Built the first time the text is processed, the later resets are applied from it with memcpy.
+static uint8_t customDefaultsImage[CUSTOM_DEFAULTS_IMAGE_SIZE];
+static uint16_t customDefaultsImageLength = 0;
+static bool customDefaultsImageValid = false;
+#endif
+
 #define CUSTOM_DEFAULTS_START_PREFIX ("# " FC_FIRMWARE_NAME)
 #define CUSTOM_DEFAULTS_MANUFACTURER_ID_PREFIX "# config: manufacturer_id: "
 #define CUSTOM_DEFAULTS_BOARD_NAME_PREFIX ", board_name: "
@@ -351,7 +372,9 @@ static void cliPrintInternal(bufWriter_t *writer, const char *str)
         while (*str) {
             bufWriterAppend(writer, *str++);
         }
-        cliWriterFlushInternal(writer);
+        if (!cliOutputBuffered) {
+            cliWriterFlushInternal(writer);
+        }
     }
 }
 
@@ -395,7 +418,9 @@ static void cliPrintfva(const char *format, va_list va)
 {
     if (cliWriter) {
         tfp_format(cliWriter, cliPutp, format, va);
-        cliWriterFlush();
+        if (!cliOutputBuffered) {
+            cliWriterFlush();
+        }
     }
 }
 
@@ -688,6 +713,9 @@ static void backupConfigs(void)
         return;
     }
 
+    // Only dump and diff get here, entering the CLI does not copy anything.
+    // The whole config has to be copied since the defaults are built in place: custom defaults
+    // and targetConfiguration() write through the regular Mutable() accessors, not just the value table.
     // make copies of configs to do differencing
     PG_FOREACH(pg) {
         backupPgConfig(pg);
@@ -782,16 +810,8 @@ STATIC_UNIT_TESTED void *cliGetValuePointer(const clivalue_t *value)
     }
 }
 
-static const char *dumpPgValue(const char *cmdName, const clivalue_t *value, dumpFlags_t dumpMask, const char *headingStr)
+static const char *dumpPgValue(const char *cmdName, const clivalue_t *value, const pgRegistry_t *pg, dumpFlags_t dumpMask, const char *headingStr)
 {
-    const pgRegistry_t *pg = pgFind(value->pgn);
-#ifdef DEBUG
-    if (!pg) {
-        cliPrintLinef("VALUE %s ERROR", value->name);
-        return headingStr; // if it's not found, the pgn shouldn't be in the value table!
-    }
-#endif
-
     const char *format = "set %s = ";
     const char *defaultFormat = "#set %s = ";
     const int valueOffset = getValueOffset(value);
@@ -815,11 +835,27 @@ static void dumpAllValues(const char *cmdName, uint16_t valueSection, dumpFlags_
 {
     headingStr = cliPrintSectionHeading(dumpMask, false, headingStr);
 
+    // Values of the same group are next to each other in the table, so the group is only looked up and compared once
+    const pgRegistry_t *pg = NULL;
+    bool pgEqualsDefault = false;
     for (uint32_t i = 0; i < valueTableEntryCount; i++) {
         const clivalue_t *value = &valueTable[i];
-        cliWriterFlush();
         if ((value->type & VALUE_SECTION_MASK) == valueSection || ((valueSection == MASTER_VALUE) && (value->type & VALUE_SECTION_MASK) == HARDWARE_VALUE)) {
-            headingStr = dumpPgValue(cmdName, value, dumpMask, headingStr);
+            if (!pg || pgN(pg) != value->pgn) {
+                pg = pgFind(value->pgn);
+#ifdef DEBUG
+                if (!pg) {
+                    cliPrintLinef("VALUE %s ERROR", value->name);
+                    continue; // if it's not found, the pgn shouldn't be in the value table!
+                }
+#endif
+                pgEqualsDefault = !memcmp(pg->copy, pg->address, pgSize(pg));
+            }
+
+            // A diff has nothing to show for a group that is unchanged as a whole
+            if (!((dumpMask & DO_DIFF) && pgEqualsDefault)) {
+                headingStr = dumpPgValue(cmdName, value, pg, dumpMask, headingStr);
+            }
         }
     }
 }
@@ -2483,6 +2519,12 @@ static void cliFlashInfo(const char *cmdName, char *cmdline)
             FLASH_PARTITION_SECTOR_COUNT(flashPartition) * layout->sectorSize,
             flashfsGetOffset()
     );
+    cliPrintLinef("FlashFS writeBuffer=%u, highWater=%u, maxStall=%uus, totalStall=%ums",
+            flashfsGetWriteBufferSize(),
+            flashfsGetWriteBufferHighWater(),
+            flashfsGetWriteStallMaxUs(),
+            flashfsGetWriteStallTotalMs()
+    );
 #endif
 }
 
@@ -4454,8 +4496,59 @@ static uint8_t getWordLength(char *bufBegin, char *bufEnd)
     return bufEnd - bufBegin;
 }
 
+#ifdef USE_CLI_SETTING_INDEX
+static bool settingIndexSorted = false;
+
+// A shell sort is plenty for the size of the table and sorts in place
+static void sortSettingIndex(void)
+{
+    for (unsigned i = 0; i < valueTableEntryCount; i++) {
+        valueTableSortedIndex[i] = i;
+    }
+
+    for (unsigned gap = valueTableEntryCount / 2; gap > 0; gap /= 2) {
+        for (unsigned i = gap; i < valueTableEntryCount; i++) {
+            const uint16_t index = valueTableSortedIndex[i];
+            unsigned j = i;
+            for (; j >= gap && strcasecmp(valueTable[valueTableSortedIndex[j - gap]].name, valueTable[index].name) > 0; j -= gap) {
+                valueTableSortedIndex[j] = valueTableSortedIndex[j - gap];
+            }
+            valueTableSortedIndex[j] = index;
+        }
+    }
+
+    settingIndexSorted = true;
+}
+#endif
+
 uint16_t cliGetSettingIndex(char *name, uint8_t length)
 {
+#ifdef USE_CLI_SETTING_INDEX
+    if (!settingIndexSorted) {
+        sortSettingIndex();
+    }
+
+    unsigned low = 0;
+    unsigned high = valueTableEntryCount;
+    while (low < high) {
+        const unsigned mid = (low + high) / 2;
+        const char *settingName = valueTable[valueTableSortedIndex[mid]].name;
+
+        int result = strncasecmp(name, settingName, length);
+        if (result == 0 && settingName[length]) {
+            // ensure exact match when setting to prevent setting variables with longer names
+            result = -1;
+        }
+
+        if (result == 0) {
+            return valueTableSortedIndex[mid];
+        } else if (result < 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+#else
     for (uint32_t i = 0; i < valueTableEntryCount; i++) {
         const char *settingName = valueTable[i].name;
 
@@ -4464,6 +4557,7 @@ uint16_t cliGetSettingIndex(char *name, uint8_t length)
             return i;
         }
     }
+#endif
     return valueTableEntryCount;
 }
 
@@ -4707,6 +4801,23 @@ static void cliStatus(const char *cmdName, char *cmdline)
     cliPrintf(", Stack used: %d", stackUsedSize());
 #endif
     cliPrintLinefeed();
+#ifdef USE_STACK_CHECK
+    cliPrint("Stack used by interrupt priority:");
+    for (unsigned level = 0; level < STACK_CHECK_IRQ_LEVELS; level++) {
+        cliPrintf(" %d:%d", level, stackIrqUsedSize(level));
+    }
+    cliPrintLinefeed();
+#endif
+#ifdef USE_PERSISTENT_OBJECTS
+    if (persistentObjectRead(PERSISTENT_OBJECT_FAULT_PC)) {
+        cliPrintLinef("Last fault: PC 0x%x, LR 0x%x, SP 0x%x, CFSR 0x%x, address 0x%x",
+            persistentObjectRead(PERSISTENT_OBJECT_FAULT_PC),
+            persistentObjectRead(PERSISTENT_OBJECT_FAULT_LR),
+            persistentObjectRead(PERSISTENT_OBJECT_FAULT_SP),
+            persistentObjectRead(PERSISTENT_OBJECT_FAULT_CFSR),
+            persistentObjectRead(PERSISTENT_OBJECT_FAULT_ADDRESS));
+    }
+#endif
 
     cliPrintLinef("Configuration: %s, size: %d, max available: %d", configurationStates[systemConfigMutable()->configurationState], getEEPROMConfigSize(), getEEPROMStorageSize());
 
@@ -4809,6 +4920,15 @@ static void cliStatus(const char *cmdName, char *cmdline)
 #endif
     cliPrintLinef("I2C Errors: %d", i2cErrorCounter);
 
+#ifdef USE_SPI
+    for (int device = 0; device < SPIDEV_COUNT; device++) {
+        spiBusStats_t stats;
+        if (spiGetBusStats(device, &stats)) {
+            cliPrintLinef("SPI%d: %d%% busy, max gyro wait %dus, preempted %d", SPI_DEV_TO_CFG(device), stats.utilisationPercent, stats.maxWaitUs, stats.preemptCount);
+        }
+    }
+#endif
+
 #ifdef USE_SDCARD
     cliSdInfo(cmdName, "");
 #endif
@@ -4823,13 +4943,121 @@ static void cliStatus(const char *cmdName, char *cmdline)
     cliPrintLinefeed();
 }
 
+#ifndef SIMULATOR_BUILD
+// Declared in the .LD file
+extern char _sdata;
+extern char _edata;
+extern char _sbss;
+extern char _ebss;
+#endif
+
+static void cliMemory(const char *cmdName, char *cmdline)
+{
+    UNUSED(cmdName);
+    UNUSED(cmdline);
+
+#ifndef SIMULATOR_BUILD
+    cliPrintLinef("Static data: %d, bss: %d, stack: %d", &_edata - &_sdata, &_ebss - &_sbss, stackTotalSize());
+#endif
+    cliPrintLinef("Arena used: %d of %d", arenaGetUsed(), arenaGetSize());
+    for (arenaOwner_e owner = 0; owner < ARENA_OWNER_COUNT; owner++) {
+        if (arenaGetOwnerUsed(owner)) {
+            cliPrintLinef("  %s: %d", arenaGetOwnerName(owner), arenaGetOwnerUsed(owner));
+        }
+    }
+}
+
 #if defined(USE_TASK_STATISTICS)
+static void cliTaskHistogramPrint(const taskHistogram_t *histogram)
+{
+    for (int i = 0; i < TASK_STATS_HISTOGRAM_BUCKET_COUNT; i++) {
+        cliPrintf(" %6d", histogram->count[i]);
+    }
+    cliPrintLinef(" %7d %7d", taskHistogramPercentileUs(histogram, 990), taskHistogramPercentileUs(histogram, 999));
+}
+
+static void cliTasksHistogram(void)
+{
+    cliPrint("Task list             ");
+    for (int i = 0; i < TASK_STATS_HISTOGRAM_BUCKET_COUNT; i++) {
+        cliPrintf(" <%5d", 1 << i);
+    }
+    cliPrintLine("  p99/us p999/us");
+
+    taskHistogram_t histogram;
+    for (taskId_e taskId = 0; taskId < TASK_COUNT; taskId++) {
+        taskInfo_t taskInfo;
+        getTaskInfo(taskId, &taskInfo);
+        if (taskInfo.isEnabled) {
+            cliPrintf("%02d - (%15s) ", taskId, taskInfo.taskName);
+            getTaskHistogram(taskId, &histogram);
+            cliTaskHistogramPrint(&histogram);
+        }
+    }
+    cliPrint("RX Check Function     ");
+    getCheckFuncHistogram(&histogram);
+    cliTaskHistogramPrint(&histogram);
+}
+
+#ifdef USE_IRQ_LOAD_STATS
+static void cliIrqLoad(void)
+{
+    static irqLoadStats_t stats[IRQ_LOAD_TYPE_COUNT][IRQ_LOAD_INSTANCE_COUNT];
+    const uint32_t elapsedUs = irqLoadGetAndResetStats(stats);
+    const uint64_t elapsedCycles = (uint64_t)elapsedUs * clockMicrosToCycles(1);
+
+    cliPrintLinefeed();
+    cliPrintLine("IRQ load                rate/hz  max/us  avg/us    load");
+    for (irqLoadType_e type = 0; type < IRQ_LOAD_TYPE_COUNT; type++) {
+        for (unsigned instance = 0; instance < IRQ_LOAD_INSTANCE_COUNT; instance++) {
+            const irqLoadStats_t *irqStats = &stats[type][instance];
+            if (irqStats->count == 0) {
+                continue;
+            }
+
+            char name[20];
+            switch (type) {
+#ifdef USE_DMA
+            case IRQ_LOAD_DMA:
+                tfp_sprintf(name, DMA_OUTPUT_STRING, DMA_DEVICE_NO(instance + 1), DMA_DEVICE_INDEX(instance + 1));
+                break;
+#endif
+            case IRQ_LOAD_EXTI:
+                tfp_sprintf(name, "EXTI line %d:", instance);
+                break;
+            case IRQ_LOAD_UART:
+                tfp_sprintf(name, "UART%d:", instance + 1);
+                break;
+            default:
+                tfp_sprintf(name, "IRQ %d/%d:", type, instance);
+                break;
+            }
+
+            const int rate = elapsedUs == 0 ? 0 : ((uint64_t)irqStats->count * 1000000) / elapsedUs;
+            const int average10thUs = clockCyclesTo10thMicros(irqStats->totalCycles / irqStats->count);
+            const int load = elapsedCycles == 0 ? 0 : (irqStats->totalCycles * 1000 + elapsedCycles / 2) / elapsedCycles;
+            cliPrint(name);
+            cliRepeat(' ', sizeof(name) - strlen(name));
+            cliPrintLinef("%11d %7d %5d.%1d %4d.%1d%%", rate, clockCyclesToMicros(irqStats->maxCycles),
+                average10thUs / 10, average10thUs % 10, load / 10, load % 10);
+        }
+    }
+}
+#endif
+
 static void cliTasks(const char *cmdName, char *cmdline)
 {
     UNUSED(cmdName);
-    UNUSED(cmdline);
+
+    if (strcasecmp(cmdline, "hist") == 0) {
+        cliTasksHistogram();
+        return;
+    }
+
     int maxLoadSum = 0;
     int averageLoadSum = 0;
+    timeUs_t gyroMaxJitterUs = 0;
+    timeUs_t gyroAverageJitterUs = 0;
 
 #ifndef MINIMAL_CLI
     if (systemConfig()->task_statistics) {
@@ -4844,8 +5072,9 @@ static void cliTasks(const char *cmdName, char *cmdline)
         if (taskInfo.isEnabled) {
             int taskFrequency = taskInfo.averageDeltaTimeUs == 0 ? 0 : lrintf(1e6f / taskInfo.averageDeltaTimeUs);
             cliPrintf("%02d - (%15s) ", taskId, taskInfo.taskName);
-            const int maxLoad = taskInfo.maxExecutionTimeUs == 0 ? 0 :(taskInfo.maxExecutionTimeUs * taskFrequency + 5000) / 1000;
-            const int averageLoad = taskInfo.averageExecutionTimeUs == 0 ? 0 : (taskInfo.averageExecutionTimeUs * taskFrequency + 5000) / 1000;
+            // Use the nanosecond execution times so that sub microsecond tasks still contribute to the load
+            const int maxLoad = taskInfo.maxExecutionTimeNs == 0 ? 0 : ((uint64_t)taskInfo.maxExecutionTimeNs * taskFrequency + 5000000) / 1000000;
+            const int averageLoad = taskInfo.averageExecutionTimeNs == 0 ? 0 : ((uint64_t)taskInfo.averageExecutionTimeNs * taskFrequency + 5000000) / 1000000;
             if (taskId != TASK_SERIAL) {
                 maxLoadSum += maxLoad;
                 averageLoadSum += averageLoad;
@@ -4857,6 +5086,10 @@ static void cliTasks(const char *cmdName, char *cmdline)
             } else {
                 cliPrintLinef("%6d", taskFrequency);
             }
+            if (taskId == TASK_GYRO) {
+                gyroMaxJitterUs = taskInfo.maxJitterUs;
+                gyroAverageJitterUs = taskInfo.averageJitterUs;
+            }
 
             schedulerResetTaskMaxExecutionTime(taskId);
         }
@@ -4865,9 +5098,92 @@ static void cliTasks(const char *cmdName, char *cmdline)
         cfCheckFuncInfo_t checkFuncInfo;
         getCheckFuncInfo(&checkFuncInfo);
         cliPrintLinef("RX Check Function %19d %7d %25d", checkFuncInfo.maxExecutionTimeUs, checkFuncInfo.averageExecutionTimeUs, checkFuncInfo.totalExecutionTimeUs / 1000);
+        cliPrintLinef("GYRO Jitter       %19d %7d", gyroMaxJitterUs, gyroAverageJitterUs);
         cliPrintLinef("Total (excluding SERIAL) %25d.%1d%% %4d.%1d%%", maxLoadSum/10, maxLoadSum%10, averageLoadSum/10, averageLoadSum%10);
         schedulerResetCheckFunctionMaxExecutionTime();
     }
+#ifdef USE_IRQ_LOAD_STATS
+    cliIrqLoad();
+#endif
+}
+#endif
+
+#ifdef USE_LATENCY_STATS
+static void printLatencyStats(const char *stageName, const latencyStats_t *stats)
+{
+    const uint32_t averageCycles = stats->count ? stats->totalCycles / stats->count : 0;
+    const int min10thUs = clockCyclesTo10thMicros(stats->minCycles);
+    const int average10thUs = clockCyclesTo10thMicros(averageCycles);
+    const int max10thUs = clockCyclesTo10thMicros(stats->maxCycles);
+    cliPrintLinef("%12s %6d.%1d %6d.%1d %6d.%1d %9d", stageName,
+        min10thUs / 10, min10thUs % 10, average10thUs / 10, average10thUs % 10, max10thUs / 10, max10thUs % 10, stats->count);
+}
+
+static void cliLatency(const char *cmdName, char *cmdline)
+{
+    UNUSED(cmdName);
+
+    if (strcasecmp(cmdline, "reset") == 0) {
+        latencyResetStats();
+        return;
+    }
+
+    latencyStats_t stats;
+
+    cliPrintLine("Gyro EXTI to    min/us   avg/us   max/us     count");
+    for (latencyStage_e stage = LATENCY_STAGE_GYRO_SAMPLE; stage < LATENCY_STAGE_COUNT; stage++) {
+        getLatencyStats(stage, &stats);
+        printLatencyStats(getLatencyStageName(stage), &stats);
+    }
+
+    cliPrintLine("RX frame to     min/us   avg/us   max/us     count");
+    for (rxLatencyStage_e stage = RX_LATENCY_STAGE_PROCESSED; stage < RX_LATENCY_STAGE_COUNT; stage++) {
+        getRxLatencyStats(stage, &stats);
+        printLatencyStats(getRxLatencyStageName(stage), &stats);
+    }
+}
+#endif
+
+#ifdef USE_BENCHMARK
+#define BENCHMARK_DEFAULT_ITERATIONS 1000
+#define BENCHMARK_MAX_ITERATIONS 100000
+
+static void cliBenchmark(const char *cmdName, char *cmdline)
+{
+    const char *countArg = nextArg(cmdline);
+    const int nameLength = countArg ? (int)strcspn(cmdline, " ") : (int)strlen(cmdline);
+    int iterations = BENCHMARK_DEFAULT_ITERATIONS;
+    if (countArg) {
+        iterations = atoi(countArg);
+        if (iterations < 1 || iterations > BENCHMARK_MAX_ITERATIONS) {
+            cliShowArgumentRangeError(cmdName, "COUNT", 1, BENCHMARK_MAX_ITERATIONS);
+            return;
+        }
+    }
+
+    bool found = false;
+    for (int index = 0; index < benchmarkCount(); index++) {
+        const char *name = benchmarkName(index);
+        if (nameLength && (strncasecmp(cmdline, name, nameLength) || name[nameLength])) {
+            continue;
+        }
+        if (!found) {
+            cliPrintLinef("      Benchmark  min/cyc  avg/cyc  max/cyc  avg/ns (%d runs at %dMHz)", iterations, clockMicrosToCycles(1));
+            found = true;
+        }
+
+        benchmarkResult_t result;
+        if (!benchmarkRun(index, iterations, &result)) {
+            cliPrintLinef("%15s not available now", name);
+            continue;
+        }
+        const uint32_t averageCycles = result.totalCycles / result.count;
+        cliPrintLinef("%15s %8d %8d %8d %7d", name, result.minCycles, averageCycles, result.maxCycles, clockCyclesToNanos(averageCycles));
+    }
+
+    if (!found) {
+        cliPrintErrorLinef(cmdName, "UNKNOWN BENCHMARK");
+    }
 }
 #endif
 
@@ -5524,6 +5840,260 @@ static void printDmaopt(dumpFlags_t dumpMask, const char *headingStr)
 #endif
 }
 
+// dma auto: choose the DMA options of the peripherals and timer pins in use so that as many of the high rate
+// ones as possible get a stream of their own. Depth first search over the options, strongest users first,
+// the current option of each user tried first so an assignment that is already conflict free is kept.
+
+#define DMA_AUTO_MAX_USERS 32
+#define DMA_AUTO_MAX_NODES 20000
+#define DMA_AUTO_STREAM(code) ((code) >> 8)    // controller and stream (or channel)
+
+typedef struct dmaAutoUser_s {
+    const dmaoptEntry_t *entry;     // NULL for a timer pin
+    uint8_t index;
+    ioTag_t ioTag;
+    const timerHardware_t *timer;
+    uint8_t weight;
+    dmaoptValue_t currentOpt;
+    dmaoptValue_t opt;
+    dmaoptValue_t bestOpt;
+    uint8_t stream;
+} dmaAutoUser_t;
+
+static dmaAutoUser_t dmaAutoUsers[DMA_AUTO_MAX_USERS];
+static int dmaAutoUserCount;
+static int dmaAutoBestScore;
+static int dmaAutoNodes;
+
+static const dmaChannelSpec_t *dmaAutoChannelSpec(const dmaAutoUser_t *user, dmaoptValue_t opt)
+{
+    if (user->entry) {
+        return dmaGetChannelSpecByPeripheral(user->entry->peripheral, user->index, opt);
+    }
+    return dmaGetChannelSpecByTimerValue(user->timer->tim, user->timer->channel, opt);
+}
+
+static void dmaAutoAddUser(const dmaoptEntry_t *entry, uint8_t index, ioTag_t ioTag, const timerHardware_t *timer, dmaoptValue_t currentOpt, uint8_t weight)
+{
+    if (dmaAutoUserCount >= DMA_AUTO_MAX_USERS) {
+        return;
+    }
+
+    // keep the users ordered by weight, the search then decides the weightiest first
+    int i = dmaAutoUserCount++;
+    while (i > 0 && dmaAutoUsers[i - 1].weight < weight) {
+        dmaAutoUsers[i] = dmaAutoUsers[i - 1];
+        i--;
+    }
+
+    dmaAutoUser_t *user = &dmaAutoUsers[i];
+    user->entry = entry;
+    user->index = index;
+    user->ioTag = ioTag;
+    user->timer = timer;
+    user->weight = weight;
+    user->currentOpt = currentOpt;
+    user->opt = DMA_OPT_UNUSED;
+    user->bestOpt = currentOpt;
+}
+
+static dmaoptValue_t *dmaAutoPeripheralOpt(const dmaoptEntry_t *entry, int index)
+{
+    const pgRegistry_t* pg = pgFind(entry->pgn);
+    void *currentConfig = isWritingConfigToCopy() ? pg->copy : pg->address;
+
+    return (dmaoptValue_t *)((uint8_t *)currentConfig + entry->stride * index + entry->offset);
+}
+
+static bool dmaAutoPeripheralInUse(const dmaoptEntry_t *entry, int index)
+{
+    switch (entry->peripheral) {
+#ifdef USE_SPI
+    case DMA_PERIPH_SPI_TX:
+    case DMA_PERIPH_SPI_RX:
+        return index < SPIDEV_COUNT && spiPinConfig(index)->ioTagSck;
+#endif
+#ifdef USE_UART
+    case DMA_PERIPH_UART_TX:
+        return index < RESOURCE_SOFT_OFFSET && serialPinConfig()->ioTagTx[index];
+    case DMA_PERIPH_UART_RX:
+        return index < RESOURCE_SOFT_OFFSET && serialPinConfig()->ioTagRx[index];
+#endif
+    default:
+        // the others only take part if they are configured to use DMA
+        return *dmaAutoPeripheralOpt(entry, index) != DMA_OPT_UNUSED;
+    }
+}
+
+static uint8_t dmaAutoPeripheralWeight(dmaPeripheral_e peripheral)
+{
+    switch (peripheral) {
+    case DMA_PERIPH_SPI_TX:
+    case DMA_PERIPH_SPI_RX:
+    case DMA_PERIPH_TIMUP:
+        return 4;
+    case DMA_PERIPH_UART_RX:
+    case DMA_PERIPH_SDIO:
+        return 3;
+    default:
+        return 2;
+    }
+}
+
+static void dmaAutoCollectUsers(void)
+{
+    dmaAutoUserCount = 0;
+
+    for (size_t i = 0; i < ARRAYLEN(dmaoptEntryTable); i++) {
+        const dmaoptEntry_t *entry = &dmaoptEntryTable[i];
+        for (int index = 0; index < entry->maxIndex; index++) {
+            if (entry->presenceMask != MASK_IGNORED && !(entry->presenceMask & BIT(index + 1))) {
+                continue;
+            }
+            if (dmaGetChannelSpecByPeripheral(entry->peripheral, index, 0) && dmaAutoPeripheralInUse(entry, index)) {
+                dmaAutoAddUser(entry, index, IO_TAG_NONE, NULL, *dmaAutoPeripheralOpt(entry, index), dmaAutoPeripheralWeight(entry->peripheral));
+            }
+        }
+    }
+
+#if defined(USE_TIMER_MGMT)
+    for (unsigned i = 0; i < MAX_TIMER_PINMAP_COUNT; i++) {
+        const ioTag_t ioTag = timerIOConfig(i)->ioTag;
+        const timerHardware_t *timer = ioTag ? timerGetByTagAndIndex(ioTag, timerIOConfig(i)->index) : NULL;
+        if (!timer || !dmaGetChannelSpecByTimerValue(timer->tim, timer->channel, 0)) {
+            continue;
+        }
+
+        // motors (DShot) and the LED strip need DMA, other pins only take part if they are configured to use it
+        uint8_t weight = 0;
+        for (int motor = 0; motor < MAX_SUPPORTED_MOTORS; motor++) {
+            if (motorConfig()->dev.ioTags[motor] == ioTag) {
+                weight = 4;
+            }
+        }
+#ifdef USE_LED_STRIP
+        if (!weight && ledStripConfig()->ioTag == ioTag) {
+            weight = 2;
+        }
+#endif
+        if (!weight && timerIOConfig(i)->dmaopt != DMA_OPT_UNUSED) {
+            weight = 1;
+        }
+
+        if (weight) {
+            dmaAutoAddUser(NULL, 0, ioTag, timer, timerIOConfig(i)->dmaopt, weight);
+        }
+    }
+#endif
+}
+
+static bool dmaAutoStreamInUse(int depth, uint8_t stream)
+{
+    for (int i = 0; i < depth; i++) {
+        if (dmaAutoUsers[i].opt != DMA_OPT_UNUSED && dmaAutoUsers[i].stream == stream) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool dmaAutoTryOption(int depth, dmaoptValue_t opt)
+{
+    dmaAutoUser_t *user = &dmaAutoUsers[depth];
+    const dmaChannelSpec_t *dmaChannelSpec = dmaAutoChannelSpec(user, opt);
+    if (!dmaChannelSpec || dmaAutoStreamInUse(depth, DMA_AUTO_STREAM(dmaChannelSpec->code))) {
+        return false;
+    }
+
+    user->opt = opt;
+    user->stream = DMA_AUTO_STREAM(dmaChannelSpec->code);
+    return true;
+}
+
+static void dmaAutoSearch(int depth, int score, int remainingWeight)
+{
+    if (++dmaAutoNodes > DMA_AUTO_MAX_NODES || score + remainingWeight <= dmaAutoBestScore) {
+        return;
+    }
+
+    if (depth == dmaAutoUserCount) {
+        dmaAutoBestScore = score;
+        for (int i = 0; i < dmaAutoUserCount; i++) {
+            dmaAutoUsers[i].bestOpt = dmaAutoUsers[i].opt;
+        }
+        return;
+    }
+
+    dmaAutoUser_t *user = &dmaAutoUsers[depth];
+    remainingWeight -= user->weight;
+
+    if (user->currentOpt != DMA_OPT_UNUSED && dmaAutoTryOption(depth, user->currentOpt)) {
+        dmaAutoSearch(depth + 1, score + user->weight, remainingWeight);
+    }
+    for (dmaoptValue_t opt = 0; opt < MAX_TIMER_DMA_OPTIONS; opt++) {
+        if (opt != user->currentOpt && dmaAutoTryOption(depth, opt)) {
+            dmaAutoSearch(depth + 1, score + user->weight, remainingWeight);
+        }
+    }
+
+    user->opt = DMA_OPT_UNUSED;
+    dmaAutoSearch(depth + 1, score, remainingWeight);
+}
+
+static void dmaAuto(void)
+{
+    dmaAutoCollectUsers();
+
+    int totalWeight = 0;
+    for (int i = 0; i < dmaAutoUserCount; i++) {
+        totalWeight += dmaAutoUsers[i].weight;
+    }
+
+    // an assignment without any DMA is the one to beat
+    dmaAutoBestScore = 0;
+    dmaAutoNodes = 0;
+    for (int i = 0; i < dmaAutoUserCount; i++) {
+        dmaAutoUsers[i].bestOpt = DMA_OPT_UNUSED;
+    }
+    dmaAutoSearch(0, 0, totalWeight);
+
+    int assigned = 0;
+    for (int i = 0; i < dmaAutoUserCount; i++) {
+        const dmaAutoUser_t *user = &dmaAutoUsers[i];
+        char optvalString[DMA_OPT_STRING_BUFSIZE];
+        optToString(user->bestOpt, optvalString);
+
+        if (user->bestOpt != DMA_OPT_UNUSED) {
+            assigned++;
+        }
+
+        if (user->entry) {
+            const int uiIndex = user->entry->presenceMask ? timerGetNumberByIndex(user->index) : DMA_OPT_UI_INDEX(user->index);
+            if (user->bestOpt != user->currentOpt) {
+                *dmaAutoPeripheralOpt(user->entry, user->index) = user->bestOpt;
+                cliPrintLinef("dma %s %d %s", user->entry->device, uiIndex, optvalString);
+            } else if (user->bestOpt == DMA_OPT_UNUSED) {
+                cliPrintLinef("# dma %s %d: no free DMA stream", user->entry->device, uiIndex);
+            }
+        }
+#if defined(USE_TIMER_MGMT)
+        else {
+            if (user->bestOpt != user->currentOpt) {
+                timerIoConfigByTag(user->ioTag)->dmaopt = user->bestOpt;
+                cliPrintLinef("dma pin %c%02d %s", IO_GPIOPortIdxByTag(user->ioTag) + 'A', IO_GPIOPinIdxByTag(user->ioTag), optvalString);
+            } else if (user->bestOpt == DMA_OPT_UNUSED) {
+                cliPrintLinef("# dma pin %c%02d: no free DMA stream", IO_GPIOPortIdxByTag(user->ioTag) + 'A', IO_GPIOPinIdxByTag(user->ioTag));
+            }
+        }
+#endif
+    }
+
+    cliPrintLinef("# dma auto: %d of %d DMA users assigned", assigned, dmaAutoUserCount);
+    if (dmaAutoNodes > DMA_AUTO_MAX_NODES) {
+        cliPrintLine("# search stopped early, the assignment may not be the best");
+    }
+}
+
 static void cliDmaopt(const char *cmdName, char *cmdline)
 {
     char *pch = NULL;
@@ -5538,6 +6108,10 @@ static void cliDmaopt(const char *cmdName, char *cmdline)
     } else if (strcasecmp(pch, "list") == 0) {
         cliPrintErrorLinef(cmdName, "NOT IMPLEMENTED YET");
 
+        return;
+    } else if (strcasecmp(pch, "auto") == 0) {
+        dmaAuto();
+
         return;
     }
 
@@ -6145,6 +6719,8 @@ static void printConfig(const char *cmdName, char *cmdline, bool doDiff)
 
     backupAndResetConfigs((dumpMask & BARE) == 0);
 
+    cliOutputBuffered = true;
+
 #ifdef USE_CLI_BATCH
     bool batchModeEnabled = false;
 #endif
@@ -6315,6 +6891,9 @@ static void printConfig(const char *cmdName, char *cmdline, bool doDiff)
     }
 #endif
 
+    cliOutputBuffered = false;
+    cliWriterFlush();
+
     // restore configs from copies
     restoreConfigs();
 }
@@ -6403,6 +6982,9 @@ const clicmd_t cmdTable[] = {
     CLI_COMMAND_DEF("beeper", "enable/disable beeper for a condition", "list\r\n"
         "\t<->[name]", cliBeeper),
 #endif // USE_BEEPER
+#ifdef USE_BENCHMARK
+    CLI_COMMAND_DEF("bench", "time the flight loop kernels in cpu cycles", "[name] [count]", cliBenchmark),
+#endif
 #if defined(USE_RX_BIND)
     CLI_COMMAND_DEF("bind_rx", "initiate binding for RX SPI or SRXL2", NULL, cliRxBind),
 #endif
@@ -6427,7 +7009,7 @@ const clicmd_t cmdTable[] = {
 
 #ifdef USE_DMA
 #ifdef USE_DMA_SPEC
-    CLI_COMMAND_DEF("dma", "show/set DMA assignments", "<> | <device> <index> list | <device> <index> [<option>|none] | list | show", cliDma),
+    CLI_COMMAND_DEF("dma", "show/set DMA assignments", "<> | <device> <index> list | <device> <index> [<option>|none] | list | show | auto", cliDma),
 #else
     CLI_COMMAND_DEF("dma", "show DMA assignments", "show", cliDma),
 #endif
@@ -6466,6 +7048,9 @@ const clicmd_t cmdTable[] = {
     CLI_COMMAND_DEF("gyroregisters", "dump gyro config registers contents", NULL, cliDumpGyroRegisters),
 #endif
     CLI_COMMAND_DEF("help", "display command help", "[search string]", cliHelp),
+#ifdef USE_LATENCY_STATS
+    CLI_COMMAND_DEF("latency", "show gyro and rx to motor output latency", "[reset]", cliLatency),
+#endif
 #ifdef USE_LED_STRIP_STATUS_MODE
         CLI_COMMAND_DEF("led", "configure leds", NULL, cliLed),
 #endif
@@ -6474,6 +7059,7 @@ const clicmd_t cmdTable[] = {
 #endif
     CLI_COMMAND_DEF("map", "configure rc channel order", "[<map>]", cliMap),
     CLI_COMMAND_DEF("mcu_id", "id of the microcontroller", NULL, cliMcuId),
+    CLI_COMMAND_DEF("memory", "show static RAM and arena usage", NULL, cliMemory),
 #ifndef USE_QUAD_MIXER_ONLY
     CLI_COMMAND_DEF("mixer", "configure mixer", "list\r\n\t<name>", cliMixer),
 #endif
@@ -6529,7 +7115,7 @@ const clicmd_t cmdTable[] = {
 #endif
     CLI_COMMAND_DEF("status", "show status", NULL, cliStatus),
 #if defined(USE_TASK_STATISTICS)
-    CLI_COMMAND_DEF("tasks", "show task stats", NULL, cliTasks),
+    CLI_COMMAND_DEF("tasks", "show task stats", "[hist]", cliTasks),
 #endif
 #ifdef USE_TIMER_MGMT
     CLI_COMMAND_DEF("timer", "show/set timers", "<> | <pin> list | <pin> [af<alternate function>|none|<option(deprecated)>] | list | show", cliTimer),
@@ -6719,12 +7305,62 @@ void cliProcess(void)
 }
 
 #if defined(USE_CUSTOM_DEFAULTS)
+#if defined(USE_CUSTOM_DEFAULTS_IMAGE)
+// The reset value of each group is built in the free end of the image and compared with the group in place,
+// a group that differs overwrites it. When the changed groups do not fit the text keeps being processed.
+static void buildCustomDefaultsImage(void)
+{
+    unsigned length = 0;
+    PG_FOREACH(pg) {
+        const uint16_t size = pgSize(pg);
+        if (length + sizeof(pgn_t) + size > sizeof(customDefaultsImage)) {
+            return;
+        }
+
+        uint8_t *record = customDefaultsImage + length;
+        pgResetInstance(pg, record + sizeof(pgn_t));
+        if (memcmp(record + sizeof(pgn_t), pg->address, size) != 0) {
+            const pgn_t pgn = pgN(pg);
+            memcpy(record, &pgn, sizeof(pgn));
+            memcpy(record + sizeof(pgn_t), pg->address, size);
+            length += sizeof(pgn_t) + size;
+        }
+    }
+
+    customDefaultsImageLength = length;
+    customDefaultsImageValid = true;
+}
+
+// Expects the config to have been reset to the firmware defaults, as processing the text does
+static void applyCustomDefaultsImage(void)
+{
+    unsigned offset = 0;
+    while (offset < customDefaultsImageLength) {
+        pgn_t pgn;
+        memcpy(&pgn, customDefaultsImage + offset, sizeof(pgn));
+        offset += sizeof(pgn);
+
+        const pgRegistry_t *pg = pgFind(pgn);
+        memcpy(pg->address, customDefaultsImage + offset, pgSize(pg));
+        offset += pgSize(pg);
+    }
+}
+#endif
+
 static bool cliProcessCustomDefaults(bool quiet)
 {
     if (processingCustomDefaults || !hasCustomDefaults()) {
         return false;
     }
 
+#if defined(USE_CUSTOM_DEFAULTS_IMAGE)
+    if (customDefaultsImageValid) {
+        applyCustomDefaultsImage();
+
+        return true;
+    }
+#endif
+
     bufWriter_t *cliWriterTemp = NULL;
     if (quiet
 #if !defined(DEBUG_CUSTOM_DEFAULTS)
@@ -6764,6 +7400,10 @@ static bool cliProcessCustomDefaults(bool quiet)
 
     systemConfigMutable()->configurationState = CONFIGURATION_STATE_DEFAULTS_CUSTOM;
 
+#if defined(USE_CUSTOM_DEFAULTS_IMAGE)
+    buildCustomDefaultsImage();
+#endif
+
     return true;
 }
 #endif
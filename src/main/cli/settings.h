@@ -42,6 +42,7 @@ typedef enum {
     TABLE_BLACKBOX_DEVICE,
     TABLE_BLACKBOX_MODE,
     TABLE_BLACKBOX_SAMPLE_RATE,
+    TABLE_BLACKBOX_P_PREDICTOR,
 #endif
     TABLE_CURRENT_METER,
     TABLE_VOLTAGE_METER,
@@ -97,6 +98,7 @@ typedef enum {
 #endif
 #ifdef USE_MULTI_GYRO
     TABLE_GYRO,
+    TABLE_GYRO_FUSION,
 #endif
     TABLE_THROTTLE_LIMIT_TYPE,
 #if defined(USE_MAX7456) || defined(USE_FRSKYOSD)
@@ -141,6 +143,10 @@ typedef enum {
 #ifdef USE_OSD
     TABLE_OSD_LOGO_ON_ARMING,
 #endif
+#ifdef USE_GYRO_DATA_ANALYSE
+    TABLE_DYN_NOTCH_WINDOW,
+    TABLE_DYN_NOTCH_ENGINE,
+#endif
 
     LOOKUP_TABLE_COUNT
 } lookupTableIndex_e;
@@ -233,6 +239,9 @@ extern const lookupTableEntry_t lookupTables[];
 extern const uint16_t valueTableEntryCount;
 
 extern const clivalue_t valueTable[];
+#ifdef USE_CLI_SETTING_INDEX
+extern uint16_t valueTableSortedIndex[]; // valueTable indexes in setting name order, filled in by the CLI
+#endif
 //extern const uint8_t lookupTablesEntryCount;
 
 extern const char * const lookupTableGyroHardware[];
@@ -0,0 +1,90 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "drivers/max7456.h"
+
+#include "io/flashfs.h"
+
+#include "arena.h"
+
+// A target can define ARENA_SIZE below the sum of its optional buffers when no board uses all of them at once
+#ifndef ARENA_SIZE
+#ifdef USE_FLASHFS
+#define ARENA_FLASHFS_SIZE FLASHFS_WRITE_BUFFER_SIZE
+#else
+#define ARENA_FLASHFS_SIZE 0
+#endif
+#ifdef USE_MAX7456
+#define ARENA_MAX7456_SIZE MAX7456_BUFFER_SIZE
+#else
+#define ARENA_MAX7456_SIZE 0
+#endif
+#define ARENA_SIZE (ARENA_FLASHFS_SIZE + ARENA_MAX7456_SIZE)
+#endif
+
+#define ARENA_ALIGNMENT 4
+
+static const char * const arenaOwnerNames[ARENA_OWNER_COUNT] = {
+    "FLASHFS",
+    "MAX7456",
+};
+
+static uint8_t arena[ARENA_SIZE ? ARENA_SIZE : 1] __attribute__((aligned(ARENA_ALIGNMENT)));
+static size_t arenaUsed;
+static size_t arenaOwnerUsed[ARENA_OWNER_COUNT];
+
+void *arenaAlloc(arenaOwner_e owner, size_t size)
+{
+    size = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+    if (size > ARENA_SIZE - arenaUsed) {
+        return NULL;
+    }
+
+    void *block = &arena[arenaUsed];
+    arenaUsed += size;
+    arenaOwnerUsed[owner] += size;
+
+    return block;
+}
+
+size_t arenaGetSize(void)
+{
+    return ARENA_SIZE;
+}
+
+size_t arenaGetUsed(void)
+{
+    return arenaUsed;
+}
+
+size_t arenaGetOwnerUsed(arenaOwner_e owner)
+{
+    return arenaOwnerUsed[owner];
+}
+
+const char *arenaGetOwnerName(arenaOwner_e owner)
+{
+    return arenaOwnerNames[owner];
+}
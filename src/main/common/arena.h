@@ -0,0 +1,39 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Memory claimed at boot by optional subsystems, only when their feature or hardware is configured.
+// Nothing is ever freed, a claim that does not fit leaves the subsystem disabled.
+
+typedef enum {
+    ARENA_OWNER_FLASHFS = 0,    // flashfs write buffer
+    ARENA_OWNER_MAX7456,        // MAX7456 layer and shadow buffers
+    ARENA_OWNER_COUNT
+} arenaOwner_e;
+
+void *arenaAlloc(arenaOwner_e owner, size_t size);
+size_t arenaGetSize(void);
+size_t arenaGetUsed(void);
+size_t arenaGetOwnerUsed(arenaOwner_e owner);
+const char *arenaGetOwnerName(arenaOwner_e owner);
@@ -18,6 +18,8 @@
  * If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
+
 #include "platform.h"
 
 #include "encoding.h"
@@ -51,3 +53,30 @@ uint32_t zigzagEncode(int32_t value)
 {
     return (uint32_t)((value << 1) ^ (value >> 31));
 }
+
+/**
+ * Unpack 16 channels of 11 bits each, packed LSB first into 22 bytes as used by SBUS, FPort and CRSF.
+ *
+ * Each group of 8 channels spans 11 bytes and is read as one 64 bit and one 24 bit little endian word,
+ * so every channel is a fixed shift and mask with no per channel branching or byte addressing.
+ */
+void unpackChannels11Bit(uint16_t *dest, const uint8_t *src)
+{
+    for (int group = 0; group < 2; group++) {
+        uint64_t lo;
+        memcpy(&lo, src, sizeof(lo));
+        const uint32_t hi = src[8] | (src[9] << 8) | (src[10] << 16);
+
+        dest[0] = lo & 0x7ff;
+        dest[1] = (lo >> 11) & 0x7ff;
+        dest[2] = (lo >> 22) & 0x7ff;
+        dest[3] = (lo >> 33) & 0x7ff;
+        dest[4] = (lo >> 44) & 0x7ff;
+        dest[5] = ((lo >> 55) | (hi << 9)) & 0x7ff;
+        dest[6] = (hi >> 2) & 0x7ff;
+        dest[7] = (hi >> 13) & 0x7ff;
+
+        src += 11;
+        dest += 8;
+    }
+}
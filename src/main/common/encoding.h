@@ -24,3 +24,4 @@
 
 uint32_t castFloatBytesToInt(float f);
 uint32_t zigzagEncode(int32_t value);
+void unpackChannels11Bit(uint16_t *dest, const uint8_t *src);
@@ -66,7 +66,7 @@ float exp_approx(float val) {
                1.3555747234758484073940937e-2f))));
 }
 
-/* Absolute error bounded by 1e-6 for normalized inputs
+/* Absolute error bounded by 1e-6 for normalized inputs, 1.3e-5 over 0.001..1000 (see maths_unittest)
    Returns a finite number for +inf input
    Returns -inf for nan and <= 0 inputs.
    Continuous error. */
@@ -41,6 +41,12 @@ FAST_CODE float nullFilterApply(filter_t *filter, float input)
     return input;
 }
 
+FAST_CODE void nullFilter3Apply(filter3_t *filter, float *values)
+{
+    UNUSED(filter);
+    UNUSED(values);
+}
+
 
 // PT1 Low Pass filter
 
@@ -67,6 +73,30 @@ FAST_CODE float pt1FilterApply(pt1Filter_t *filter, float input)
     return filter->state;
 }
 
+// PT1 Low Pass filter for the three axes of a vector, filtered in place
+
+void pt1Filter3Init(pt1Filter3_t *filter, float k)
+{
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        filter->state[axis] = 0.0f;
+    }
+    filter->k = k;
+}
+
+void pt1Filter3UpdateCutoff(pt1Filter3_t *filter, float k)
+{
+    filter->k = k;
+}
+
+FAST_CODE void pt1Filter3Apply(pt1Filter3_t *filter, float *values)
+{
+    const float k = filter->k;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        filter->state[axis] += k * (values[axis] - filter->state[axis]);
+        values[axis] = filter->state[axis];
+    }
+}
+
 // Slew filter with limit
 
 void slewFilterInit(slewFilter_t *filter, float slewLimit, float threshold)
@@ -76,19 +106,14 @@ void slewFilterInit(slewFilter_t *filter, float slewLimit, float threshold)
     filter->threshold = threshold;
 }
 
+// Outside the threshold only steps back towards zero larger than the slew limit are rejected,
+// the conditions are combined without short circuits so the update is a single select
 FAST_CODE float slewFilterApply(slewFilter_t *filter, float input)
 {
-    if (filter->state >= filter->threshold) {
-        if (input >= filter->state - filter->slewLimit) {
-            filter->state = input;
-        }
-    } else if (filter->state <= -filter->threshold) {
-        if (input <= filter->state + filter->slewLimit) {
-            filter->state = input;
-        }
-    } else {
-        filter->state = input;
-    }
+    const float state = filter->state;
+    const bool rejectHigh = (state >= filter->threshold) & (input < state - filter->slewLimit);
+    const bool rejectLow = (state <= -filter->threshold) & (input > state + filter->slewLimit);
+    filter->state = (rejectHigh | rejectLow) ? state : input;
     return filter->state;
 }
 
@@ -98,6 +123,49 @@ float filterGetNotchQ(float centerFreq, float cutoffFreq) {
     return centerFreq * cutoffFreq / (centerFreq * centerFreq - cutoffFreq * cutoffFreq);
 }
 
+// Notch coefficient generator for notches that follow a frequency, the constants of the
+// biquadFilterInit() notch are computed once and every frequency costs one sin/cos pair and one
+// division, or nothing when its whole Hz value was computed before
+
+void biquadNotchCacheInit(biquadNotchCache_t *cache, uint32_t refreshRate, float Q)
+{
+    cache->omegaPerHz = 2.0f * M_PI_FLOAT * refreshRate * 0.000001f;
+    cache->alphaScale = 1.0f / (2.0f * Q);
+    memset(cache->key, 0, sizeof(cache->key));
+}
+
+FAST_CODE void biquadNotchCoefficients(biquadNotchCache_t *cache, const float *frequencies, biquadNotchCoeffs_t *coeffs, int count)
+{
+    for (int i = 0; i < count; i++) {
+        const uint16_t hz = lrintf(MAX(frequencies[i], 0.0f));
+        const uint16_t key = hz + 1;
+        const unsigned slot = hz & (BIQUAD_NOTCH_CACHE_SIZE - 1);
+
+        if (cache->key[slot] != key) {
+            float sn, cs;
+            sin_cos_approx(cache->omegaPerHz * hz, &sn, &cs);
+            const float alpha = sn * cache->alphaScale;
+            const float a0Inv = 1.0f / (1.0f + alpha);
+
+            cache->coeffs[slot].b0 = a0Inv;
+            cache->coeffs[slot].a1 = -2.0f * cs * a0Inv;
+            cache->coeffs[slot].a2 = (1.0f - alpha) * a0Inv;
+            cache->key[slot] = key;
+        }
+        coeffs[i] = cache->coeffs[slot];
+    }
+}
+
+// Replaces the coefficients only, the state is kept
+FAST_CODE void biquadFilterSetNotchCoefficients(biquadFilter_t *filter, const biquadNotchCoeffs_t *coeffs)
+{
+    filter->b0 = coeffs->b0;
+    filter->b1 = coeffs->a1;
+    filter->b2 = coeffs->b0;
+    filter->a1 = coeffs->a1;
+    filter->a2 = coeffs->a2;
+}
+
 /* sets up a biquad Filter */
 void biquadFilterInitLPF(biquadFilter_t *filter, float filterFreq, uint32_t refreshRate)
 {
@@ -108,8 +176,8 @@ void biquadFilterInit(biquadFilter_t *filter, float filterFreq, uint32_t refresh
 {
     // setup variables
     const float omega = 2.0f * M_PI_FLOAT * filterFreq * refreshRate * 0.000001f;
-    const float sn = sin_approx(omega);
-    const float cs = cos_approx(omega);
+    float sn, cs;
+    sin_cos_approx(omega, &sn, &cs);
     const float alpha = sn / (2.0f * Q);
 
     float b0 = 0, b1 = 0, b2 = 0, a0 = 0, a1 = 0, a2 = 0;
@@ -177,6 +245,16 @@ FAST_CODE void biquadFilterUpdateLPF(biquadFilter_t *filter, float filterFreq, u
     biquadFilterUpdate(filter, filterFreq, refreshRate, BIQUAD_Q, FILTER_LPF);
 }
 
+// Lets filters running at the same cutoff share one coefficient calculation, the state is left untouched
+FAST_CODE void biquadFilterCopyCoefficients(biquadFilter_t *filter, const biquadFilter_t *source)
+{
+    filter->b0 = source->b0;
+    filter->b1 = source->b1;
+    filter->b2 = source->b2;
+    filter->a1 = source->a1;
+    filter->a2 = source->a2;
+}
+
 /* Computes a biquadFilter_t filter on a sample (slightly less precise than df2 but works in dynamic mode) */
 FAST_CODE float biquadFilterApplyDF1(biquadFilter_t *filter, float input)
 {
@@ -203,6 +281,155 @@ FAST_CODE float biquadFilterApply(biquadFilter_t *filter, float input)
     return result;
 }
 
+// Biquad lowpass for the three axes of a vector, filtered in place
+
+static FAST_CODE void biquadFilter3SetCoefficients(biquadFilter3_t *filter, const biquadFilter_t *source)
+{
+    filter->b0 = source->b0;
+    filter->b1 = source->b1;
+    filter->b2 = source->b2;
+    filter->a1 = source->a1;
+    filter->a2 = source->a2;
+}
+
+void biquadFilter3InitLPF(biquadFilter3_t *filter, float filterFreq, uint32_t refreshRate)
+{
+    biquadFilter_t coefficients;
+    biquadFilterInitLPF(&coefficients, filterFreq, refreshRate);
+    biquadFilter3SetCoefficients(filter, &coefficients);
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        filter->x1[axis] = filter->x2[axis] = 0;
+        filter->y1[axis] = filter->y2[axis] = 0;
+    }
+}
+
+// Replaces the coefficients only, the state is kept
+FAST_CODE void biquadFilter3UpdateLPF(biquadFilter3_t *filter, float filterFreq, uint32_t refreshRate)
+{
+    biquadFilter_t coefficients;
+    biquadFilterInitLPF(&coefficients, filterFreq, refreshRate);
+    biquadFilter3SetCoefficients(filter, &coefficients);
+}
+
+/* Same as biquadFilterApplyDF1() on each axis, works in dynamic mode */
+FAST_CODE void biquadFilter3ApplyDF1(biquadFilter3_t *filter, float *values)
+{
+    const float b0 = filter->b0, b1 = filter->b1, b2 = filter->b2, a1 = filter->a1, a2 = filter->a2;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float input = values[axis];
+        const float result = b0 * input + b1 * filter->x1[axis] + b2 * filter->x2[axis] - a1 * filter->y1[axis] - a2 * filter->y2[axis];
+
+        filter->x2[axis] = filter->x1[axis];
+        filter->x1[axis] = input;
+        filter->y2[axis] = filter->y1[axis];
+        filter->y1[axis] = result;
+
+        values[axis] = result;
+    }
+}
+
+/* Same as biquadFilterApply() on each axis, direct form 2 keeps its state in x1 and x2 */
+FAST_CODE void biquadFilter3Apply(biquadFilter3_t *filter, float *values)
+{
+    const float b0 = filter->b0, b1 = filter->b1, b2 = filter->b2, a1 = filter->a1, a2 = filter->a2;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float input = values[axis];
+        const float result = b0 * input + filter->x1[axis];
+        filter->x1[axis] = b1 * input - a1 * result + filter->x2[axis];
+        filter->x2[axis] = b2 * input - a2 * result;
+
+        values[axis] = result;
+    }
+}
+
+// Cascade of lowpass sections for the three axes of a vector, evaluated in direct form 1 so that
+// the coefficients of a section can change while running
+
+void filterCascade3Init(filterCascade3_t *filter)
+{
+    filter->sectionCount = 0;
+}
+
+static biquadFilter3_t *filterCascade3NewSection(filterCascade3_t *filter)
+{
+    if (filter->sectionCount >= FILTER_CASCADE_MAX_SECTIONS) {
+        return NULL;
+    }
+
+    biquadFilter3_t *section = &filter->section[filter->sectionCount++];
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        section->x1[axis] = section->x2[axis] = 0;
+        section->y1[axis] = section->y2[axis] = 0;
+    }
+    return section;
+}
+
+static void filterCascade3SetPt1(biquadFilter3_t *section, float k)
+{
+    // y = y1 + k * (x - y1)
+    section->b0 = k;
+    section->b1 = 0;
+    section->b2 = 0;
+    section->a1 = k - 1;
+    section->a2 = 0;
+}
+
+// Returns the index of the new section, or -1 when the cascade is full
+int filterCascade3AddPt1(filterCascade3_t *filter, float k)
+{
+    biquadFilter3_t *section = filterCascade3NewSection(filter);
+    if (!section) {
+        return -1;
+    }
+    filterCascade3SetPt1(section, k);
+    return filter->sectionCount - 1;
+}
+
+int filterCascade3AddBiquadLPF(filterCascade3_t *filter, float filterFreq, uint32_t refreshRate)
+{
+    biquadFilter3_t *section = filterCascade3NewSection(filter);
+    if (!section) {
+        return -1;
+    }
+    biquadFilter3UpdateLPF(section, filterFreq, refreshRate);
+    return filter->sectionCount - 1;
+}
+
+FAST_CODE void filterCascade3UpdatePt1(filterCascade3_t *filter, int section, float k)
+{
+    filterCascade3SetPt1(&filter->section[section], k);
+}
+
+FAST_CODE void filterCascade3UpdateBiquadLPF(filterCascade3_t *filter, int section, float filterFreq, uint32_t refreshRate)
+{
+    biquadFilter3UpdateLPF(&filter->section[section], filterFreq, refreshRate);
+}
+
+// Takes over the state of a cascade with the same number of sections, the coefficients are left untouched
+void filterCascade3CopyState(filterCascade3_t *filter, const filterCascade3_t *source)
+{
+    if (filter->sectionCount != source->sectionCount) {
+        return;
+    }
+
+    for (int i = 0; i < filter->sectionCount; i++) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            filter->section[i].x1[axis] = source->section[i].x1[axis];
+            filter->section[i].x2[axis] = source->section[i].x2[axis];
+            filter->section[i].y1[axis] = source->section[i].y1[axis];
+            filter->section[i].y2[axis] = source->section[i].y2[axis];
+        }
+    }
+}
+
+FAST_CODE void filterCascade3Apply(filterCascade3_t *filter, float *values)
+{
+    for (int i = 0; i < filter->sectionCount; i++) {
+        biquadFilter3ApplyDF1(&filter->section[i], values);
+    }
+}
+
 void laggedMovingAverageInit(laggedMovingAverage_t *filter, uint16_t windowSize, float *buf)
 {
     filter->movingWindowIndex = 0;
@@ -227,3 +454,63 @@ FAST_CODE float laggedMovingAverageUpdate(laggedMovingAverage_t *filter, float i
     const uint16_t denom = filter->primed ? filter->windowSize : filter->movingWindowIndex;
     return filter->movingSum  / denom;
 }
+
+// Fill coeffs for a factor times decimation. The cutoff is at the output Nyquist frequency
+// so only content close to it aliases, and it aliases onto frequencies the gyro lowpasses remove.
+void firDecimatorInitCoeffs(float *coeffs, uint8_t factor)
+{
+    const int taps = factor * FIR_DECIMATOR_TAPS_PER_PHASE;
+    const float centre = (taps - 1) / 2.0f;
+    float h[FIR_DECIMATOR_MAX_FACTOR * FIR_DECIMATOR_TAPS_PER_PHASE];
+    float sum = 0.0f;
+
+    for (int n = 0; n < taps; n++) {
+        const float t = n - centre;
+        const float sinc = (t == 0.0f) ? 1.0f : sin_approx(M_PIf * t / factor) / (M_PIf * t / factor);
+        const float hamming = 0.54f - 0.46f * cos_approx(2.0f * M_PIf * n / (taps - 1));
+        h[n] = sinc * hamming;
+        sum += h[n];
+    }
+
+    // unity gain at DC, and group the taps so each input phase reads a contiguous run
+    for (int phase = 0; phase < factor; phase++) {
+        for (int k = 0; k < FIR_DECIMATOR_TAPS_PER_PHASE; k++) {
+            coeffs[phase * FIR_DECIMATOR_TAPS_PER_PHASE + k] = h[k * factor + factor - 1 - phase] / sum;
+        }
+    }
+}
+
+void firDecimatorInit(firDecimator_t *filter, const float *coeffs, uint8_t factor)
+{
+    filter->coeffs = coeffs;
+    filter->factor = factor;
+    filter->phase = 0;
+    filter->head = 0;
+    memset(filter->acc, 0, sizeof(filter->acc));
+}
+
+// Each input is added into the FIR_DECIMATOR_TAPS_PER_PHASE outputs it is part of, so the
+// cost is spread evenly over the inputs. Returns true when an output is complete.
+FAST_CODE bool firDecimatorApply(firDecimator_t *filter, float input, float *output)
+{
+    const float *coeffs = &filter->coeffs[filter->phase * FIR_DECIMATOR_TAPS_PER_PHASE];
+    int index = filter->head;
+    for (int k = 0; k < FIR_DECIMATOR_TAPS_PER_PHASE; k++) {
+        filter->acc[index] += coeffs[k] * input;
+        if (++index == FIR_DECIMATOR_TAPS_PER_PHASE) {
+            index = 0;
+        }
+    }
+
+    if (++filter->phase < filter->factor) {
+        return false;
+    }
+    filter->phase = 0;
+
+    *output = filter->acc[filter->head];
+    filter->acc[filter->head] = 0.0f;
+    if (++filter->head == FIR_DECIMATOR_TAPS_PER_PHASE) {
+        filter->head = 0;
+    }
+    return true;
+}
@@ -21,9 +21,14 @@
 #pragma once
 #include <stdbool.h>
 
+#include "common/axis.h"
+
 struct filter_s;
 typedef struct filter_s filter_t;
 
+struct filter3_s;
+typedef struct filter3_s filter3_t;
+
 typedef struct pt1Filter_s {
     float state;
     float k;
@@ -41,6 +46,41 @@ typedef struct biquadFilter_s {
     float x1, x2, y1, y2;
 } biquadFilter_t;
 
+// Filters for the three axes of a vector sharing one set of coefficients, the states are kept per axis side by side
+typedef struct pt1Filter3_s {
+    float state[XYZ_AXIS_COUNT];
+    float k;
+} pt1Filter3_t;
+
+typedef struct biquadFilter3_s {
+    float b0, b1, b2, a1, a2;
+    float x1[XYZ_AXIS_COUNT], x2[XYZ_AXIS_COUNT];
+    float y1[XYZ_AXIS_COUNT], y2[XYZ_AXIS_COUNT];
+} biquadFilter3_t;
+
+// Notch coefficients normalised by a0, for a notch b2 == b0 and b1 == a1
+typedef struct biquadNotchCoeffs_s {
+    float b0, a1, a2;
+} biquadNotchCoeffs_t;
+
+#define BIQUAD_NOTCH_CACHE_SIZE 64 // power of 2
+
+// Notch coefficients for one Q and refresh rate, computed for whole Hz and kept per frequency
+typedef struct biquadNotchCache_s {
+    float omegaPerHz;
+    float alphaScale;
+    uint16_t key[BIQUAD_NOTCH_CACHE_SIZE]; // frequency in Hz + 1 of the entry, 0 when empty
+    biquadNotchCoeffs_t coeffs[BIQUAD_NOTCH_CACHE_SIZE];
+} biquadNotchCache_t;
+
+#define FILTER_CASCADE_MAX_SECTIONS 3
+
+// Lowpass stages run one after the other in a single call, first order stages are biquad sections with b2 = a2 = 0
+typedef struct filterCascade3_s {
+    biquadFilter3_t section[FILTER_CASCADE_MAX_SECTIONS];
+    uint8_t sectionCount;
+} filterCascade3_t;
+
 typedef struct laggedMovingAverage_s {
     uint16_t movingWindowIndex;
     uint16_t windowSize;
@@ -49,6 +89,18 @@ typedef struct laggedMovingAverage_s {
     bool primed;
 } laggedMovingAverage_t;
 
+#define FIR_DECIMATOR_TAPS_PER_PHASE 6
+#define FIR_DECIMATOR_MAX_FACTOR 8
+
+// Windowed sinc lowpass evaluated in polyphase form, one output per factor inputs
+typedef struct firDecimator_s {
+    const float *coeffs;        // factor * FIR_DECIMATOR_TAPS_PER_PHASE, grouped by input phase, see firDecimatorInitCoeffs()
+    float acc[FIR_DECIMATOR_TAPS_PER_PHASE];    // partial sums of the outputs the current input contributes to
+    uint8_t factor;
+    uint8_t phase;
+    uint8_t head;               // acc index of the next output to complete
+} firDecimator_t;
+
 typedef enum {
     FILTER_PT1 = 0,
     FILTER_BIQUAD,
@@ -61,18 +113,25 @@ typedef enum {
 } biquadFilterType_e;
 
 typedef float (*filterApplyFnPtr)(filter_t *filter, float input);
+typedef void (*filter3ApplyFnPtr)(filter3_t *filter, float *values);
 
 float nullFilterApply(filter_t *filter, float input);
+void nullFilter3Apply(filter3_t *filter, float *values);
 
 void biquadFilterInitLPF(biquadFilter_t *filter, float filterFreq, uint32_t refreshRate);
 void biquadFilterInit(biquadFilter_t *filter, float filterFreq, uint32_t refreshRate, float Q, biquadFilterType_e filterType);
 void biquadFilterUpdate(biquadFilter_t *filter, float filterFreq, uint32_t refreshRate, float Q, biquadFilterType_e filterType);
 void biquadFilterUpdateLPF(biquadFilter_t *filter, float filterFreq, uint32_t refreshRate);
+void biquadFilterCopyCoefficients(biquadFilter_t *filter, const biquadFilter_t *source);
 
 float biquadFilterApplyDF1(biquadFilter_t *filter, float input);
 float biquadFilterApply(biquadFilter_t *filter, float input);
 float filterGetNotchQ(float centerFreq, float cutoffFreq);
 
+void biquadNotchCacheInit(biquadNotchCache_t *cache, uint32_t refreshRate, float Q);
+void biquadNotchCoefficients(biquadNotchCache_t *cache, const float *frequencies, biquadNotchCoeffs_t *coeffs, int count);
+void biquadFilterSetNotchCoefficients(biquadFilter_t *filter, const biquadNotchCoeffs_t *coeffs);
+
 void laggedMovingAverageInit(laggedMovingAverage_t *filter, uint16_t windowSize, float *buf);
 float laggedMovingAverageUpdate(laggedMovingAverage_t *filter, float input);
 
@@ -81,5 +140,26 @@ void pt1FilterInit(pt1Filter_t *filter, float k);
 void pt1FilterUpdateCutoff(pt1Filter_t *filter, float k);
 float pt1FilterApply(pt1Filter_t *filter, float input);
 
+void pt1Filter3Init(pt1Filter3_t *filter, float k);
+void pt1Filter3UpdateCutoff(pt1Filter3_t *filter, float k);
+void pt1Filter3Apply(pt1Filter3_t *filter, float *values);
+
+void biquadFilter3InitLPF(biquadFilter3_t *filter, float filterFreq, uint32_t refreshRate);
+void biquadFilter3UpdateLPF(biquadFilter3_t *filter, float filterFreq, uint32_t refreshRate);
+void biquadFilter3ApplyDF1(biquadFilter3_t *filter, float *values);
+void biquadFilter3Apply(biquadFilter3_t *filter, float *values);
+
+void filterCascade3Init(filterCascade3_t *filter);
+int filterCascade3AddPt1(filterCascade3_t *filter, float k);
+int filterCascade3AddBiquadLPF(filterCascade3_t *filter, float filterFreq, uint32_t refreshRate);
+void filterCascade3UpdatePt1(filterCascade3_t *filter, int section, float k);
+void filterCascade3UpdateBiquadLPF(filterCascade3_t *filter, int section, float filterFreq, uint32_t refreshRate);
+void filterCascade3CopyState(filterCascade3_t *filter, const filterCascade3_t *source);
+void filterCascade3Apply(filterCascade3_t *filter, float *values);
+
+void firDecimatorInitCoeffs(float *coeffs, uint8_t factor);
+void firDecimatorInit(firDecimator_t *filter, const float *coeffs, uint8_t factor);
+bool firDecimatorApply(firDecimator_t *filter, float input, float *output);
+
 void slewFilterInit(slewFilter_t *filter, float slewLimit, float threshold);
 float slewFilterApply(slewFilter_t *filter, float input);
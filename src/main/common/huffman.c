@@ -28,80 +28,130 @@
 #include "huffman.h"
 
 
-int huffmanEncodeBuf(uint8_t *outBuf, int outBufLen, const uint8_t *inBuf, int inLen, const huffmanTable_t *huffmanTable)
+// Bits already used in the partially written output byte
+static int huffmanUsedBits(uint8_t outBit)
 {
-    int ret = 0;
-
-    uint8_t *outByte = outBuf;
-    *outByte = 0;
-    uint8_t outBit = 0x80;
+    int usedBits = 0;
+    for (uint8_t bit = 0x80; bit != outBit; bit >>= 1) {
+        ++usedBits;
+    }
+    return usedBits;
+}
 
-    for (int ii = 0; ii < inLen; ++ii) {
-        const int huffCodeLen = huffmanTable[*inBuf].codeLen;
-        const uint16_t huffCode = huffmanTable[*inBuf].code;
-        ++inBuf;
-        uint16_t testBit = 0x8000;
+int huffmanEncodeBuf(uint8_t *outBuf, int outBufLen, const uint8_t *inBuf, int inLen, const huffmanTable_t *huffmanTable)
+{
+    huffmanState_t state = {
+        .bytesWritten = 0,
+        .outByte = outBuf,
+        .outBufLen = outBufLen,
+        .outBit = 0x80,
+    };
+    *state.outByte = 0;
+
+    if (huffmanEncodeBufStreaming(&state, inBuf, inLen, huffmanTable) == -1) {
+        return -1;
+    }
+    if (state.outBit != 0x80) {
+        // ensure last character in output buffer is counted
+        ++state.bytesWritten;
+    }
+    return state.bytesWritten;
+}
 
-        for (int jj = 0; jj < huffCodeLen; ++jj) {
-            if (huffCode & testBit) {
-                *outByte |= outBit;
-            }
+// The codes are collected left aligned in a 32 bit register and written out a byte at a time, a code is at most
+// 16 bits and less than a byte is left over between codes, so the register never overflows.
+// On overflow the state is left as it was before the call.
+int huffmanEncodeBufStreaming(huffmanState_t *state, const uint8_t *inBuf, int inLen, const huffmanTable_t *huffmanTable)
+{
+    uint8_t *outByte = state->outByte;
+    uint16_t bytesWritten = state->bytesWritten;
+    int accBits = huffmanUsedBits(state->outBit);
+    const uint8_t savedOutByte = (bytesWritten < state->outBufLen) ? *outByte : 0;
+    uint32_t acc = (uint32_t)savedOutByte << 24;
 
-            testBit >>= 1;
-            outBit >>= 1;
-            if (outBit == 0) {
-                outBit = 0x80;
-                ++outByte;
-                *outByte = 0;
-                ++ret;
-            }
+    for (const uint8_t *pos = inBuf, *end = inBuf + inLen; pos < end; ++pos) {
+        acc |= ((uint32_t)huffmanTable[*pos].code << 16) >> accBits;
+        accBits += huffmanTable[*pos].codeLen;
 
-            if (ret >= outBufLen && ii < inLen - 1 && jj < huffCodeLen - 1) {
-                return -1;
+        while (accBits >= 8) {
+            if (bytesWritten >= state->outBufLen) {
+                goto overflow;
             }
+            *outByte++ = acc >> 24;
+            ++bytesWritten;
+            acc <<= 8;
+            accBits -= 8;
         }
     }
-    if (outBit != 0x80) {
-        // ensure last character in output buffer is counted
-        ++ret;
+
+    if (accBits && bytesWritten >= state->outBufLen) {
+        goto overflow;
     }
-    return ret;
+    if (bytesWritten < state->outBufLen) {
+        // the partial byte, or a cleared one for the next call to continue in
+        *outByte = acc >> 24;
+    }
+
+    state->outByte = outByte;
+    state->bytesWritten = bytesWritten;
+    state->outBit = 0x80 >> accBits;
+
+    return 0;
+
+overflow:
+    if (state->bytesWritten < state->outBufLen) {
+        *state->outByte = savedOutByte;
+    }
+    return -1;
 }
 
-int huffmanEncodeBufStreaming(huffmanState_t *state, const uint8_t *inBuf, int inLen, const huffmanTable_t *huffmanTable)
+void huffmanInitDecodeTable(huffmanDecodeTable_t *decodeTable, const huffmanTable_t *huffmanTable)
 {
-    uint8_t *savedOutBytePtr = state->outByte;
-    uint8_t savedOutByte = *savedOutBytePtr;
+    // every window of HUFFMAN_DECODE_BITS bits starting with a code decodes to it
+    for (int symbol = 0; symbol < HUFFMAN_TABLE_SIZE; ++symbol) {
+        const int codeLen = huffmanTable[symbol].codeLen;
+        const int first = huffmanTable[symbol].code >> (16 - HUFFMAN_DECODE_BITS);
+        for (int ii = first; ii < first + (1 << (HUFFMAN_DECODE_BITS - codeLen)); ++ii) {
+            decodeTable->entry[ii] = (codeLen << HUFFMAN_DECODE_SYMBOL_BITS) | symbol;
+        }
+    }
+}
 
-    for (const uint8_t *pos = inBuf, *end = inBuf + inLen; pos < end; ++pos) {
-        const int huffCodeLen = huffmanTable[*pos].codeLen;
-        const uint16_t huffCode = huffmanTable[*pos].code;
-        uint16_t testBit = 0x8000;
+int huffmanDecodeBuf(uint8_t *outBuf, int outBufLen, const uint8_t *inBuf, int inBufLen, int inBufCharacterCount, const huffmanDecodeTable_t *decodeTable)
+{
+    if (inBufCharacterCount > outBufLen) {
+        return -1;
+    }
 
-        for (int jj = 0; jj < huffCodeLen; ++jj) {
-            if (huffCode & testBit) {
-                *state->outByte |= state->outBit;
-            }
+    const uint8_t *inEnd = inBuf + inBufLen;
+    uint32_t bitBuf = 0; // left aligned, zero padded past the end of the input
+    int bitCount = 0;
+    int outCount = 0;
 
-            testBit >>= 1;
-            state->outBit >>= 1;
-            if (state->outBit == 0) {
-                state->outBit = 0x80;
-                ++state->outByte;
-                *state->outByte = 0;
-                ++state->bytesWritten;
-            }
+    while (outCount < inBufCharacterCount) {
+        while (bitCount <= 24 && inBuf < inEnd) {
+            bitBuf |= (uint32_t)*inBuf++ << (24 - bitCount);
+            bitCount += 8;
+        }
 
-            // if buffer is filled and we haven't finished compressing
-            if (state->bytesWritten >= state->outBufLen && (pos < end - 1 || jj < huffCodeLen - 1)) {
-                // restore savedOutByte
-                *savedOutBytePtr = savedOutByte;
-                return -1;
-            }
+        const uint16_t entry = decodeTable->entry[bitBuf >> (32 - HUFFMAN_DECODE_BITS)];
+        const int codeLen = entry >> HUFFMAN_DECODE_SYMBOL_BITS;
+        const int symbol = entry & ((1 << HUFFMAN_DECODE_SYMBOL_BITS) - 1);
+        if (codeLen > bitCount) {
+            // input ends inside a code
+            return -1;
+        }
+        if (symbol == HUFFMAN_EOF_SYMBOL) {
+            break;
         }
+
+        *outBuf++ = symbol;
+        ++outCount;
+        bitBuf <<= codeLen;
+        bitCount -= codeLen;
     }
 
-    return 0;
+    return outCount;
 }
 
 #endif
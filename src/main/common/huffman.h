@@ -43,5 +43,16 @@ struct huffmanInfo_s {
 
 #define HUFFMAN_INFO_SIZE sizeof(struct huffmanInfo_s)
 
+#define HUFFMAN_EOF_SYMBOL (HUFFMAN_TABLE_SIZE - 1)
+#define HUFFMAN_DECODE_BITS 12 // longest code in huffmanTable
+#define HUFFMAN_DECODE_SYMBOL_BITS 9
+
+// Symbol and code length of the code starting each possible window of HUFFMAN_DECODE_BITS input bits
+typedef struct huffmanDecodeTable_s {
+    uint16_t entry[1 << HUFFMAN_DECODE_BITS];
+} huffmanDecodeTable_t;
+
 int huffmanEncodeBuf(uint8_t *outBuf, int outBufLen, const uint8_t *inBuf, int inLen, const huffmanTable_t *huffmanTable);
 int huffmanEncodeBufStreaming(huffmanState_t *state, const uint8_t *inBuf, int inLen, const huffmanTable_t *huffmanTable);
+void huffmanInitDecodeTable(huffmanDecodeTable_t *decodeTable, const huffmanTable_t *huffmanTable);
+int huffmanDecodeBuf(uint8_t *outBuf, int outBufLen, const uint8_t *inBuf, int inBufLen, int inBufCharacterCount, const huffmanDecodeTable_t *decodeTable);
@@ -19,6 +19,7 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 #include <math.h>
 
 #include "platform.h"
@@ -35,8 +36,8 @@
 // Chebyshev http://stackoverflow.com/questions/345085/how-do-trigonometric-functions-work/345117#345117
 // Thanks for ledvinap for making such accuracy possible! See: https://github.com/cleanflight/cleanflight/issues/940#issuecomment-110323384
 // https://github.com/Crashpilot1000/HarakiriWebstore1/blob/master/src/mw.c#L1235
-// sin_approx maximum absolute error = 2.305023e-06
-// cos_approx maximum absolute error = 2.857298e-06
+// sin_approx maximum absolute error = 1.966953e-06
+// cos_approx maximum absolute error = 2.026558e-06
 #define sinPolyCoef3 -1.666568107e-1f
 #define sinPolyCoef5  8.312366210e-3f
 #define sinPolyCoef7 -1.849218155e-4f
@@ -47,16 +48,28 @@
 #define sinPolyCoef7 -1.980661520e-4f                                          // Double: -1.980661520135080504411629636078917643846e-4
 #define sinPolyCoef9  2.600054768e-6f                                          // Double:  2.600054767890361277123254766503271638682e-6
 #endif
+
+// Wrap to -PI..PI with a single multiply instead of a loop, callers limit |x| to 32 (5 * 360 Deg)
+static inline float wrapToPi(float x)
+{
+    const float turns = x * (0.5f / M_PIf);
+    return x - (2.0f * M_PIf) * (int32_t)(turns + (turns >= 0.0f ? 0.5f : -0.5f));
+}
+
+// x in -PI..PI
+static inline float sinPoly(float x)
+{
+    if (x >  (0.5f * M_PIf)) x =  M_PIf - x;                                // We just pick -90..+90 Degree
+    else if (x < -(0.5f * M_PIf)) x = -M_PIf - x;
+    const float x2 = x * x;
+    return x + x * x2 * (sinPolyCoef3 + x2 * (sinPolyCoef5 + x2 * (sinPolyCoef7 + x2 * sinPolyCoef9)));
+}
+
 float sin_approx(float x)
 {
     int32_t xint = x;
     if (xint < -32 || xint > 32) return 0.0f;                               // Stop here on error input (5 * 360 Deg)
-    while (x >  M_PIf) x -= (2.0f * M_PIf);                                 // always wrap input angle to -PI..PI
-    while (x < -M_PIf) x += (2.0f * M_PIf);
-    if (x >  (0.5f * M_PIf)) x =  (0.5f * M_PIf) - (x - (0.5f * M_PIf));   // We just pick -90..+90 Degree
-    else if (x < -(0.5f * M_PIf)) x = -(0.5f * M_PIf) - ((0.5f * M_PIf) + x);
-    float x2 = x * x;
-    return x + x * x2 * (sinPolyCoef3 + x2 * (sinPolyCoef5 + x2 * (sinPolyCoef7 + x2 * sinPolyCoef9)));
+    return sinPoly(wrapToPi(x));
 }
 
 float cos_approx(float x)
@@ -64,6 +77,22 @@ float cos_approx(float x)
     return sin_approx(x + (0.5f * M_PIf));
 }
 
+// Both results share one range reduction, the error bounds are those of sin_approx and cos_approx
+void sin_cos_approx(float x, float *sinResult, float *cosResult)
+{
+    int32_t xint = x;
+    if (xint < -32 || xint > 32) {                                          // Stop here on error input (5 * 360 Deg)
+        *sinResult = 0.0f;
+        *cosResult = 0.0f;
+        return;
+    }
+    x = wrapToPi(x);
+    *sinResult = sinPoly(x);
+    float xCos = x + (0.5f * M_PIf);                                        // cos(x) = sin(x + 90 Deg)
+    if (xCos > M_PIf) xCos -= (2.0f * M_PIf);
+    *cosResult = sinPoly(xCos);
+}
+
 // Initial implementation by Crashpilot1000 (https://github.com/Crashpilot1000/HarakiriWebstore1/blob/396715f73c6fcf859e0db0f34e12fe44bace6483/src/mw.c#L1292)
 // Polynomial coefficients by Andor (http://www.dsprelated.com/showthread/comp.dsp/21872-1.php) optimized by Ledvinap to save one multiplication
 // Max absolute error 0,000027 degree
@@ -169,6 +198,29 @@ float devStandardDeviation(stdev_t *dev)
     return sqrtf(devVariance(dev));
 }
 
+void movingSumInit(movingSum_t *movingSum, int16_t *buf, uint8_t windowSize)
+{
+    movingSum->buf = buf;
+    movingSum->sum = 0;
+    movingSum->windowSize = windowSize;
+    movingSum->index = 0;
+    movingSum->primed = false;
+    memset(buf, 0, windowSize * sizeof(*buf));
+}
+
+// Replaces the oldest sample, returns the sum of the window
+int32_t movingSumUpdate(movingSum_t *movingSum, int16_t sample)
+{
+    movingSum->sum += sample - movingSum->buf[movingSum->index];
+    movingSum->buf[movingSum->index] = sample;
+    if (++movingSum->index == movingSum->windowSize) {
+        movingSum->index = 0;
+        movingSum->primed = true;
+    }
+
+    return movingSum->sum;
+}
+
 float degreesToRadians(int16_t degrees)
 {
     return degrees * RAD;
@@ -252,11 +304,11 @@ void rotateV(struct fp_vector *v, fp_angles_t *delta)
 // Quick median filter implementation
 // (c) N. Devillard - 1998
 // http://ndevilla.free.fr/median/median.pdf
-#define QMF_SORT(a,b) { if ((a)>(b)) QMF_SWAP((a),(b)); }
-#define QMF_SWAP(a,b) { int32_t temp=(a);(a)=(b);(b)=temp; }
+// The compare and swap steps of the sorting networks are a min and a max each, so they compile
+// to conditional selects rather than branches that depend on the data
+#define QMF_SORT(a,b) { const int32_t lo = (a) < (b) ? (a) : (b); (b) = (a) < (b) ? (b) : (a); (a) = lo; }
 #define QMF_COPY(p,v,n) { int32_t i; for (i=0; i<n; i++) p[i]=v[i]; }
-#define QMF_SORTF(a,b) { if ((a)>(b)) QMF_SWAPF((a),(b)); }
-#define QMF_SWAPF(a,b) { float temp=(a);(a)=(b);(b)=temp; }
+#define QMF_SORTF(a,b) { const float lo = fminSelect((a), (b)); (b) = fmaxSelect((a), (b)); (a) = lo; }
 
 int32_t quickMedianFilter3(int32_t * v)
 {
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #ifndef sq
@@ -57,6 +58,25 @@
 
 #define Q12 (1 << 12)
 
+// Minimum and maximum that compile to vminnm/vmaxnm on FPv5 and to a compare and conditional move otherwise
+static inline float fminSelect(float a, float b)
+{
+#if defined(STM32F7) || defined(STM32H7)
+    return __builtin_fminf(a, b);
+#else
+    return a < b ? a : b;
+#endif
+}
+
+static inline float fmaxSelect(float a, float b)
+{
+#if defined(STM32F7) || defined(STM32H7)
+    return __builtin_fmaxf(a, b);
+#else
+    return a > b ? a : b;
+#endif
+}
+
 #define HZ_TO_INTERVAL(x) (1.0f / (x))
 #define HZ_TO_INTERVAL_US(x) (1000000 / (x))
 
@@ -68,6 +88,15 @@ typedef struct stdev_s
     int m_n;
 } stdev_t;
 
+// Sum over a fixed window of the latest samples, the buffer holds the window and starts out zeroed
+typedef struct movingSum_s {
+    int16_t *buf;
+    int32_t sum;
+    uint8_t windowSize;
+    uint8_t index;
+    bool primed;                // The window has been filled once
+} movingSum_t;
+
 // Floating point 3 vector.
 typedef struct fp_vector {
     float X;
@@ -106,6 +135,8 @@ void devClear(stdev_t *dev);
 void devPush(stdev_t *dev, float x);
 float devVariance(stdev_t *dev);
 float devStandardDeviation(stdev_t *dev);
+void movingSumInit(movingSum_t *movingSum, int16_t *buf, uint8_t windowSize);
+int32_t movingSumUpdate(movingSum_t *movingSum, int16_t sample);
 float degreesToRadians(int16_t degrees);
 
 int scaleRange(int x, int srcFrom, int srcTo, int destFrom, int destTo);
@@ -130,6 +161,7 @@ float quickMedianFilter9f(float * v);
 #if defined(FAST_MATH) || defined(VERY_FAST_MATH)
 float sin_approx(float x);
 float cos_approx(float x);
+void sin_cos_approx(float x, float *sinResult, float *cosResult);
 float atan2_approx(float y, float x);
 float acos_approx(float x);
 #define tan_approx(x)       (sin_approx(x) / cos_approx(x))
@@ -139,6 +171,7 @@ float pow_approx(float a, float b);
 #else
 #define sin_approx(x)   sinf(x)
 #define cos_approx(x)   cosf(x)
+#define sin_cos_approx(x, sinResult, cosResult) { *(sinResult) = sinf(x); *(cosResult) = cosf(x); }
 #define atan2_approx(y,x)   atan2f(y,x)
 #define acos_approx(x)      acosf(x)
 #define tan_approx(x)       tanf(x)
@@ -0,0 +1,133 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// Byte ring with a single producer and a single consumer, e.g. the main loop and an interrupt handler.
+//
+// The size must be a power of two and one byte is left unused to tell a full ring from an empty one.
+// The head is only written by the producer and the tail only by the consumer. Each side publishes its
+// index with release ordering once it is done with the data and loads the other index with acquire
+// ordering, so neither side needs a critical section.
+
+#define RING_IS_POWER_OF_TWO(size) ((size) && !((size) & ((size) - 1)))
+
+typedef struct ringSpan_s {
+    uint8_t *ptr;
+    uint32_t len;
+} ringSpan_t;
+
+static inline uint32_t ringLoadIndex(const uint32_t *index)
+{
+    return __atomic_load_n(index, __ATOMIC_ACQUIRE);
+}
+
+static inline void ringStoreIndex(uint32_t *index, uint32_t value)
+{
+    __atomic_store_n(index, value, __ATOMIC_RELEASE);
+}
+
+static inline uint32_t ringAdvance(uint32_t size, uint32_t index, uint32_t count)
+{
+    return (index + count) & (size - 1);
+}
+
+static inline uint32_t ringUsed(uint32_t size, uint32_t head, uint32_t tail)
+{
+    return (head - tail) & (size - 1);
+}
+
+static inline uint32_t ringFree(uint32_t size, uint32_t head, uint32_t tail)
+{
+    return size - 1 - ringUsed(size, head, tail);
+}
+
+// Bytes from the tail up to the head or the end of the buffer, whichever comes first
+static inline uint32_t ringUsedContiguous(uint32_t size, uint32_t head, uint32_t tail)
+{
+    return head >= tail ? head - tail : size - tail;
+}
+
+// The used bytes as at most two spans in reading order, returns the total
+static inline uint32_t ringUsedSpans(uint8_t *buffer, uint32_t size, uint32_t head, uint32_t tail, ringSpan_t spans[2])
+{
+    spans[0].ptr = buffer + tail;
+    spans[0].len = ringUsedContiguous(size, head, tail);
+    spans[1].ptr = buffer;
+    spans[1].len = head < tail ? head : 0;
+
+    return spans[0].len + spans[1].len;
+}
+
+// Producer side, false when the ring is full
+static inline bool ringPut(uint8_t *buffer, uint32_t size, uint32_t *head, const uint32_t *tail, uint8_t byte)
+{
+    const uint32_t index = *head;
+    const uint32_t next = ringAdvance(size, index, 1);
+    if (next == ringLoadIndex(tail)) {
+        return false;
+    }
+
+    buffer[index] = byte;
+    ringStoreIndex(head, next);
+
+    return true;
+}
+
+// Producer side, copies as much of the data as fits with at most two copies and returns the count copied
+static inline uint32_t ringWrite(uint8_t *buffer, uint32_t size, uint32_t *head, const uint32_t *tail, const void *data, uint32_t count)
+{
+    const uint32_t index = *head;
+    const uint32_t free = ringFree(size, index, ringLoadIndex(tail));
+    if (count > free) {
+        count = free;
+    }
+
+    const uint32_t first = count < size - index ? count : size - index;
+    memcpy(buffer + index, data, first);
+    memcpy(buffer, (const uint8_t *)data + first, count - first);
+    ringStoreIndex(head, ringAdvance(size, index, count));
+
+    return count;
+}
+
+// Consumer side, false when the ring is empty
+static inline bool ringGet(const uint8_t *buffer, uint32_t size, const uint32_t *head, uint32_t *tail, uint8_t *byte)
+{
+    const uint32_t index = *tail;
+    if (index == ringLoadIndex(head)) {
+        return false;
+    }
+
+    *byte = buffer[index];
+    ringStoreIndex(tail, ringAdvance(size, index, 1));
+
+    return true;
+}
+
+// Consumer side, hands a span taken with ringUsedSpans() back to the producer
+static inline void ringConsume(uint32_t size, uint32_t *tail, uint32_t count)
+{
+    ringStoreIndex(tail, ringAdvance(size, *tail, count));
+}
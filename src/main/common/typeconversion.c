@@ -58,8 +58,68 @@ void li2a(long num, char *bf)
 
 #endif
 
+// Writes the digits of num in decimal backwards from end, with a decimal point before the last decimals digits.
+// The divisions by the constant 10 compile to a multiply by its reciprocal, so no division instruction or loop
+// to find the leading digit is needed. Returns the first character written.
+static char *decimalDigits(unsigned int num, int decimals, char *end)
+{
+    int count = 0;
+    do {
+        const unsigned int quotient = num / 10;
+        *--end = '0' + (num - quotient * 10);
+        num = quotient;
+        if (++count == decimals) {
+            *--end = '.';
+        }
+    } while (num || count <= decimals);
+    return end;
+}
+
+static char *formatDecimal(int num, int decimals, int width, char pad, char *bf)
+{
+    char digits[12]; // 10 digits and the decimal point
+    const char *start = decimalDigits(num < 0 ? -(unsigned int)num : (unsigned int)num, decimals, digits + sizeof(digits));
+    const int len = digits + sizeof(digits) - start;
+    int padding = width - len - (num < 0);
+
+    if (pad != '0') {
+        while (padding-- > 0) {
+            *bf++ = pad;
+        }
+    }
+    if (num < 0) {
+        *bf++ = '-';
+    }
+    while (padding-- > 0) {
+        *bf++ = '0';
+    }
+    memcpy(bf, start, len);
+    bf += len;
+    *bf = 0;
+    return bf;
+}
+
+char *i2aPad(int num, int width, char pad, char *bf)
+{
+    return formatDecimal(num, 0, width, pad, bf);
+}
+
+char *fixed2a(int num, int decimals, int width, char *bf)
+{
+    return formatDecimal(num, decimals, width, ' ', bf);
+}
+
 void ui2a(unsigned int num, unsigned int base, int uc, char *bf)
 {
+    if (base == 10) {
+        char digits[10];
+        const char *start = decimalDigits(num, 0, digits + sizeof(digits));
+        const int len = digits + sizeof(digits) - start;
+        memcpy(bf, start, len);
+        bf[len] = 0;
+        return;
+    }
+
     unsigned int d = 1;
 
     while (num / d >= base)
@@ -26,6 +26,11 @@ void uli2a(unsigned long int num, unsigned int base, int uc, char *bf);
 void li2a(long num, char *bf);
 void ui2a(unsigned int num, unsigned int base, int uc, char *bf);
 void i2a(int num, char *bf);
+// Decimal num right aligned in at least width characters, padded with pad, '0' pads after the sign.
+// Returns the terminating NUL, so more can be appended.
+char *i2aPad(int num, int width, char pad, char *bf);
+// num / 10^decimals with decimals (at most 9) digits after the point, space padded to at least width characters.
+char *fixed2a(int num, int decimals, int width, char *bf);
 char a2i(char ch, const char **src, int base, int *nump);
 char *ftoa(float x, char *floatString);
 float fastA2F(const char *p);
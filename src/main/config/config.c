@@ -115,12 +115,13 @@ PG_RESET_TEMPLATE(pilotConfig_t, pilotConfig,
     .displayName = { 0 },
 );
 
-PG_REGISTER_WITH_RESET_TEMPLATE(systemConfig_t, systemConfig, PG_SYSTEM_CONFIG, 2);
+PG_REGISTER_WITH_RESET_TEMPLATE(systemConfig_t, systemConfig, PG_SYSTEM_CONFIG, 4);
 
 PG_RESET_TEMPLATE(systemConfig_t, systemConfig,
     .pidProfileIndex = 0,
     .activeRateProfile = 0,
     .debug_mode = DEBUG_MODE,
+    .debug_mode_2 = DEBUG_NONE,
     .task_statistics = true,
     .rateProfile6PosSwitch = false,
     .cpu_overclock = DEFAULT_CPU_OVERCLOCK,
@@ -130,6 +131,7 @@ PG_RESET_TEMPLATE(systemConfig_t, systemConfig,
     .configurationState = CONFIGURATION_STATE_DEFAULTS_BARE,
     .schedulerOptimizeRate = SCHEDULER_OPTIMIZE_RATE_AUTO,
     .enableStickArming = false,
+    .taskGovernorLoad = 80,
 );
 
 uint8_t getCurrentPidProfileIndex(void)
@@ -164,6 +166,7 @@ void resetConfig(void)
 static void activateConfig(void)
 {
     schedulerOptimizeRate(systemConfig()->schedulerOptimizeRate == SCHEDULER_OPTIMIZE_RATE_ON || (systemConfig()->schedulerOptimizeRate == SCHEDULER_OPTIMIZE_RATE_AUTO && motorConfig()->dev.useDshotTelemetry));
+    schedulerSetLoadGovernor(systemConfig()->taskGovernorLoad);
     loadPidProfile();
     loadControlRateProfile();
 
@@ -392,7 +395,12 @@ static void validateAndFixConfig(void)
     }
 
 #if defined(USE_ESC_SENSOR)
-    if (!findSerialPortConfig(FUNCTION_ESC_SENSOR)) {
+    // Extended DShot telemetry can stand in for the ESC sensor port
+    if (!findSerialPortConfig(FUNCTION_ESC_SENSOR)
+#ifdef USE_DSHOT_TELEMETRY
+        && !(motorConfig()->dev.useDshotTelemetry && motorConfig()->dev.useDshotEdt)
+#endif
+        ) {
         featureDisableImmediate(FEATURE_ESC_SENSOR);
     }
 #endif
@@ -658,6 +666,9 @@ void validateAndFixGyroConfig(void)
         case PWM_TYPE_DSHOT300:
                 motorUpdateRestriction = 0.0001f;
                 break;
+        case PWM_TYPE_DSHOT1200:
+                motorUpdateRestriction = 0.000015625f;
+                break;
 #endif
         default:
             motorUpdateRestriction = 0.00003125f;
@@ -687,6 +698,15 @@ void validateAndFixGyroConfig(void)
                 pidConfigMutable()->pid_process_denom = MAX(pidConfigMutable()->pid_process_denom, minPidProcessDenom);
             }
         }
+
+        // Each gyro task run reads a whole FIFO burst, so the PID loop has to start on a burst boundary
+        if (gyro.fifoDepth > 1 && (pidConfig()->pid_process_denom % gyro.fifoDepth)) {
+            uint8_t pidProcessDenom = (pidConfig()->pid_process_denom / gyro.fifoDepth + 1) * gyro.fifoDepth;
+            if (pidProcessDenom > MAX_PID_PROCESS_DENOM) {
+                pidProcessDenom -= gyro.fifoDepth;
+            }
+            pidConfigMutable()->pid_process_denom = pidProcessDenom;
+        }
     }
 
 #ifdef USE_GYRO_DATA_ANALYSE
@@ -838,7 +858,7 @@ void changePidProfile(uint8_t pidProfileIndex)
         systemConfigMutable()->pidProfileIndex = pidProfileIndex;
         loadPidProfile();
 
-        pidInit(currentPidProfile);
+        pidChangeProfile(currentPidProfile);
         initEscEndpoints();
         mixerInitProfile();
     }
@@ -50,6 +50,7 @@ typedef struct systemConfig_s {
     uint8_t pidProfileIndex;
     uint8_t activeRateProfile;
     uint8_t debug_mode;
+    uint8_t debug_mode_2;           // second debug mode, logged to debug[4..7]
     uint8_t task_statistics;
     uint8_t rateProfile6PosSwitch;
     uint8_t cpu_overclock;
@@ -59,6 +60,7 @@ typedef struct systemConfig_s {
     uint8_t configurationState;     // The state of the configuration (defaults / configured)
     uint8_t schedulerOptimizeRate;
     uint8_t enableStickArming; // boolean that determines whether stick arming can be used
+    uint8_t taskGovernorLoad;  // system load percentage above which the low priority tasks are slowed down, 0 to disable
 } systemConfig_t;
 
 PG_DECLARE(systemConfig_t, systemConfig);
@@ -43,6 +43,17 @@
 
 static uint16_t eepromConfigSize;
 
+// Internal flash can be programmed in place after the saved copy, so only the PGs that
+// changed are appended as log records. Other storage always rewrites the whole copy.
+#if defined(CONFIG_IN_FLASH) || defined(CONFIG_IN_FILE)
+#define CONFIG_LOG_APPEND
+#endif
+
+// Appended records start after the saved copy and run until erased flash
+static const uint8_t *configLogStart;
+static const uint8_t *configLogEnd;
+static bool configLogErasedAtEnd;
+
 typedef enum {
     CR_CLASSICATION_SYSTEM   = 0,
     CR_CLASSICATION_PROFILE_LAST = CR_CLASSICATION_SYSTEM,
@@ -77,6 +88,11 @@ typedef struct {
 } PG_PACKED configFooter_t;
 // checksum is appended just after footer. It is not included in footer to make checksum calculation consistent
 
+// Each log record is a configRecord_t followed by a CRC of the record, padded to the flash write size.
+#define CONFIG_LOG_ALIGN(size)  (((size) + CONFIG_STREAMER_BUFFER_SIZE - 1) & ~(CONFIG_STREAMER_BUFFER_SIZE - 1))
+#define CONFIG_LOG_SPACE(recordSize) CONFIG_LOG_ALIGN((recordSize) + sizeof(uint16_t))
+#define CONFIG_LOG_ERASED_SIZE  0xFFFF
+
 // Used to check the compiler packing at build time.
 typedef struct {
     uint8_t byte;
@@ -281,12 +297,57 @@ bool isEEPROMVersionValid(void)
     return true;
 }
 
+static bool isFlashErased(const uint8_t *p, size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        if (p[i] != 0xFF) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Find the end of the records appended after the saved copy. A record that is torn or
+// from before the last full write stops the scan and leaves configLogErasedAtEnd false.
+static void scanConfigLog(const uint8_t *p)
+{
+    configLogStart = p;
+    configLogErasedAtEnd = false;
+
+    while (p + sizeof(configRecord_t) <= &__config_end) {
+        const configRecord_t *record = (const configRecord_t *)p;
+
+        if (record->size == CONFIG_LOG_ERASED_SIZE) {
+            configLogErasedAtEnd = true;
+            break;
+        }
+        if (record->size < sizeof(*record) || p + CONFIG_LOG_SPACE(record->size) > &__config_end) {
+            break;
+        }
+
+        uint16_t storedCrc;
+        memcpy(&storedCrc, p + record->size, sizeof(storedCrc));
+        if (crc16_ccitt_update(CRC_START_VALUE, p, record->size) != storedCrc) {
+            break;
+        }
+
+        p += CONFIG_LOG_SPACE(record->size);
+    }
+
+    configLogEnd = p;
+    eepromConfigSize = p - &__config_start;
+}
+
 // Scan the EEPROM config. Returns true if the config is valid.
 bool isEEPROMStructureValid(void)
 {
     const uint8_t *p = &__config_start;
     const configHeader_t *header = (const configHeader_t *)p;
 
+    configLogStart = configLogEnd = NULL;
+    configLogErasedAtEnd = false;
+
     if (header->magic_be != 0xBE) {
         return false;
     }
@@ -325,7 +386,15 @@ bool isEEPROMStructureValid(void)
     eepromConfigSize = p - &__config_start;
 
     // CRC has the property that if the CRC itself is included in the calculation the resulting CRC will have constant value
-    return crc == CRC_CHECK_VALUE;
+    if (crc != CRC_CHECK_VALUE) {
+        return false;
+    }
+
+    // the log starts at the next flash write unit after the stored CRC
+    const uint8_t *configEnd = (const uint8_t *)(storedCrc + 1);
+    scanConfigLog(&__config_start + CONFIG_LOG_ALIGN(configEnd - &__config_start));
+
+    return true;
 }
 
 uint16_t getEEPROMConfigSize(void)
@@ -348,10 +417,13 @@ size_t getEEPROMStorageSize(void)
 }
 
 // find config record for reg + classification (profile info) in EEPROM
+// the last record appended to the log wins over the saved copy
 // return NULL when record is not found
 // this function assumes that EEPROM content is valid
 static const configRecord_t *findEEPROM(const pgRegistry_t *reg, configRecordFlags_e classification)
 {
+    const configRecord_t *found = NULL;
+
     const uint8_t *p = &__config_start;
     p += sizeof(configHeader_t);             // skip header
     while (true) {
@@ -361,12 +433,35 @@ static const configRecord_t *findEEPROM(const pgRegistry_t *reg, configRecordFla
             || record->size < sizeof(*record))
             break;
         if (pgN(reg) == record->pgn
-            && (record->flags & CR_CLASSIFICATION_MASK) == classification)
-            return record;
+            && (record->flags & CR_CLASSIFICATION_MASK) == classification) {
+            found = record;
+            break;
+        }
         p += record->size;
     }
-    // record not found
-    return NULL;
+
+    for (p = configLogStart; p && p < configLogEnd; ) {
+        const configRecord_t *record = (const configRecord_t *)p;
+        if (pgN(reg) == record->pgn
+            && (record->flags & CR_CLASSIFICATION_MASK) == classification) {
+            found = record;
+        }
+        p += CONFIG_LOG_SPACE(record->size);
+    }
+
+    return found;
+}
+
+// true when the stored record for reg is missing or differs from the PG in RAM
+static bool isEEPROMRecordStale(const pgRegistry_t *reg)
+{
+    const configRecord_t *rec = findEEPROM(reg, CR_CLASSICATION_SYSTEM);
+    const uint16_t regSize = pgSize(reg);
+
+    return !rec
+        || rec->size != sizeof(configRecord_t) + regSize
+        || rec->version != pgVersion(reg)
+        || memcmp(rec->pg, reg->address, regSize) != 0;
 }
 
 // Initialize all PG records from EEPROM.
@@ -442,8 +537,98 @@ static bool writeSettingsToEEPROM(void)
     return success;
 }
 
+#ifdef CONFIG_LOG_APPEND
+// Append a record for every changed PG after the saved copy without erasing.
+// Returns false when the log has no room or is not clean, the caller then rewrites everything.
+static bool appendSettingsToEEPROM(void)
+{
+    if (!configLogErasedAtEnd || !isEEPROMVersionValid()) {
+        return false;
+    }
+
+    size_t required = 0;
+    PG_FOREACH(reg) {
+        if (isEEPROMRecordStale(reg)) {
+            required += CONFIG_LOG_SPACE(sizeof(configRecord_t) + pgSize(reg));
+        }
+    }
+
+    if (required == 0) {
+        return true;
+    }
+
+    // flash past this page may hold records from before the last full write, those pages are
+    // erased by the streamer as it reaches them and anything else still in the way forces a rewrite
+    if (configLogEnd + required > &__config_end || !isFlashErased(configLogEnd, required)) {
+        return false;
+    }
+
+    config_streamer_t streamer;
+    config_streamer_init(&streamer);
+
+    config_streamer_start(&streamer, (uintptr_t)configLogEnd, &__config_end - configLogEnd);
+
+    PG_FOREACH(reg) {
+        if (!isEEPROMRecordStale(reg)) {
+            continue;
+        }
+
+        const uint16_t regSize = pgSize(reg);
+        const configRecord_t record = {
+            .size = sizeof(configRecord_t) + regSize,
+            .pgn = pgN(reg),
+            .version = pgVersion(reg),
+            .flags = CR_CLASSICATION_SYSTEM,
+        };
+
+        config_streamer_write(&streamer, (uint8_t *)&record, sizeof(record));
+        uint16_t crc = crc16_ccitt_update(CRC_START_VALUE, (uint8_t *)&record, sizeof(record));
+        config_streamer_write(&streamer, reg->address, regSize);
+        crc = crc16_ccitt_update(crc, reg->address, regSize);
+        config_streamer_write(&streamer, (uint8_t *)&crc, sizeof(crc));
+
+        config_streamer_flush(&streamer);
+    }
+
+    const uint8_t *end = (const uint8_t *)streamer.address;
+    if (end + sizeof(configRecord_t) <= &__config_end && !isFlashErased(end, sizeof(uint16_t))) {
+        // Ended on a page boundary in front of old records, terminate the log
+        const uint16_t terminator = 0;
+        config_streamer_write(&streamer, (uint8_t *)&terminator, sizeof(terminator));
+        config_streamer_flush(&streamer);
+    }
+
+    return config_streamer_finish(&streamer) == 0;
+}
+
+static bool isEEPROMUpToDate(void)
+{
+    PG_FOREACH(reg) {
+        if (isEEPROMRecordStale(reg)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+#endif
+
+// Writes the changed groups without erasing anything, false if that is not possible and a full write is needed
+bool appendConfigToEEPROM(void)
+{
+#ifdef CONFIG_LOG_APPEND
+    return appendSettingsToEEPROM() && isEEPROMVersionValid() && isEEPROMStructureValid() && isEEPROMUpToDate();
+#else
+    return false;
+#endif
+}
+
 void writeConfigToEEPROM(void)
 {
+    if (appendConfigToEEPROM()) {
+        return;
+    }
+
     bool success = false;
     // write it
     for (int attempt = 0; attempt < 3 && !success; attempt++) {
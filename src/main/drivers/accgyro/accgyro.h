@@ -22,6 +22,8 @@
 
 #include "platform.h"
 
+#include "build/latency.h"
+
 #include "common/axis.h"
 #include "common/maths.h"
 #include "common/sensor_alignment.h"
@@ -29,6 +31,9 @@
 #include "drivers/bus.h"
 #include "drivers/sensor.h"
 #include "drivers/accgyro/accgyro_mpu.h"
+#ifdef USE_GYRO_TIMESTAMP
+#include "drivers/system.h"
+#endif
 
 #pragma GCC diagnostic push
 #if defined(SIMULATOR_BUILD) && defined(SIMULATOR_MULTITHREAD)
@@ -80,6 +85,10 @@ typedef enum {
     GYRO_RATE_32_kHz,
 } gyroRateKHz_e;
 
+#ifdef USE_GYRO_FIFO
+#define GYRO_FIFO_MAX_SAMPLES 4                              // most samples read from the sensor FIFO in one burst
+#endif
+
 typedef struct gyroDev_s {
 #if defined(SIMULATOR_BUILD) && defined(SIMULATOR_MULTITHREAD)
     pthread_mutex_t lock;
@@ -91,11 +100,12 @@ typedef struct gyroDev_s {
     busDevice_t bus;
     float scale;                                             // scalefactor
     float gyroZero[XYZ_AXIS_COUNT];
-    float gyroADC[XYZ_AXIS_COUNT];                           // gyro data after calibration and alignment
+    float gyroADC[XYZ_AXIS_COUNT];                           // gyro data after calibration, scaling and alignment
     int32_t gyroADCRawPrevious[XYZ_AXIS_COUNT];
     int16_t gyroADCRaw[XYZ_AXIS_COUNT];                      // raw data from sensor
     int16_t temperature;
     mpuDetectionResult_t mpuDetectionResult;
+    uint8_t spiDetectIndex;                                  // detect function to probe first, plus one, and the one that found the sensor
     sensor_align_e gyroAlign;
     gyroRateKHz_e gyroRateKHz;
     bool dataReady;
@@ -109,6 +119,22 @@ typedef struct gyroDev_s {
     fp_rotationMatrix_t rotationMatrix;
     uint16_t gyroSampleRateHz;
     uint16_t accSampleRateHz;
+#ifdef USE_GYRO_EXTI_REALTIME
+    void (*dataReadyCallback)(void);                         // called from the data ready interrupt
+#endif
+#ifdef USE_SPI_DMA
+    busSegment_t dmaReadSegments[2];                         // gyro data read started by the data ready interrupt
+    volatile bool dmaReadStarted;
+    bool useDmaRead;
+#endif
+#ifdef USE_GYRO_TIMESTAMP
+    volatile uint32_t dataReadyCycles;                       // cycle counter at the latest data ready interrupt, 0 without one
+#endif
+#ifdef USE_GYRO_FIFO
+    uint8_t fifoDepth;                                       // samples per data ready interrupt, 0/1 if the FIFO burst read is not used
+    uint8_t fifoSampleCount;                                 // samples returned by the last FIFO burst read, oldest first
+    int16_t fifoSamples[GYRO_FIFO_MAX_SAMPLES][XYZ_AXIS_COUNT];
+#endif
 } gyroDev_t;
 
 typedef struct accDev_s {
@@ -165,4 +191,19 @@ static inline void gyroDevUnLock(gyroDev_t *gyro)
     (void)gyro;
 #endif
 }
+
+// To be called from the gyro data ready interrupt handler
+static inline void gyroDevSetDataReady(gyroDev_t *gyro)
+{
+    LATENCY_MARK(LATENCY_STAGE_GYRO_EXTI);
+#ifdef USE_GYRO_TIMESTAMP
+    gyro->dataReadyCycles = getCycleCounter();
+#endif
+    gyro->dataReady = true;
+#ifdef USE_GYRO_EXTI_REALTIME
+    if (gyro->dataReadyCallback) {
+        gyro->dataReadyCallback();
+    }
+#endif
+}
 #pragma GCC diagnostic pop
@@ -107,6 +107,19 @@ static void mpu6050FindRevision(gyroDev_t *gyro)
  * Gyro interrupt service routine
  */
 #ifdef USE_GYRO_EXTI
+#ifdef USE_SPI_DMA
+static bool mpuGyroUseDmaRead(const gyroDev_t *gyro)
+{
+#ifdef USE_GYRO_EXTI_REALTIME
+    // The realtime tasks run from the data ready interrupt, so the read could not overlap them anyway
+    if (gyro->dataReadyCallback) {
+        return false;
+    }
+#endif
+    return gyro->useDmaRead;
+}
+#endif
+
 static void mpuIntExtiHandler(extiCallbackRec_t *cb)
 {
 #ifdef DEBUG_MPU_DATA_READY_INTERRUPT
@@ -116,7 +129,12 @@ static void mpuIntExtiHandler(extiCallbackRec_t *cb)
     lastCalledAtUs = nowUs;
 #endif
     gyroDev_t *gyro = container_of(cb, gyroDev_t, exti);
-    gyro->dataReady = true;
+#ifdef USE_SPI_DMA
+    if (mpuGyroUseDmaRead(gyro) && spiBusSequence(&gyro->bus, SPI_PRIORITY_HIGH, gyro->dmaReadSegments, NULL, 0)) {
+        gyro->dmaReadStarted = true;
+    }
+#endif
+    gyroDevSetDataReady(gyro);
 #ifdef DEBUG_MPU_DATA_READY_INTERRUPT
     const uint32_t now2Us = micros();
     debug[1] = (uint16_t)(now2Us - nowUs);
@@ -140,7 +158,7 @@ static void mpuIntExtiInit(gyroDev_t *gyro)
 
     IOInit(mpuIntIO, OWNER_GYRO_EXTI, 0);
     EXTIHandlerInit(&gyro->exti, mpuIntExtiHandler);
-    EXTIConfig(mpuIntIO, &gyro->exti, NVIC_PRIO_MPU_INT_EXTI, IOCFG_IN_FLOATING, BETAFLIGHT_EXTI_TRIGGER_RISING);
+    EXTIConfig(mpuIntIO, &gyro->exti, NVIC_PRIO_GYRO_INT_EXTI, IOCFG_IN_FLOATING, BETAFLIGHT_EXTI_TRIGGER_RISING);
     EXTIEnable(mpuIntIO, true);
 }
 #endif // USE_GYRO_EXTI
@@ -195,6 +213,58 @@ bool mpuGyroReadSPI(gyroDev_t *gyro)
     return true;
 }
 
+#ifdef USE_SPI_DMA
+#define MPU_GYRO_READ_LENGTH 7
+#define MPU_DMA_READ_COUNT 2    // one per gyro sensor
+
+// Outside FAST_DATA, which is not accessible by DMA on some targets
+static uint8_t mpuDmaReadTxData[MPU_GYRO_READ_LENGTH] = {MPU_RA_GYRO_XOUT_H | 0x80, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+static uint8_t mpuDmaReadRxData[MPU_DMA_READ_COUNT][MPU_GYRO_READ_LENGTH];
+static uint8_t mpuDmaReadCount;
+
+static bool mpuGyroReadSPIDMA(gyroDev_t *gyro)
+{
+    if (!mpuGyroUseDmaRead(gyro)) {
+        return mpuGyroReadSPI(gyro);
+    }
+
+    // Normally the data ready interrupt has already started the read, which has landed by now
+    if (!gyro->dmaReadStarted) {
+        spiBusSequence(&gyro->bus, SPI_PRIORITY_HIGH, gyro->dmaReadSegments, NULL, 0);
+    }
+    spiBusWaitSequence(&gyro->bus);
+    gyro->dmaReadStarted = false;
+
+    const uint8_t *data = gyro->dmaReadSegments[0].rxData;
+
+    gyro->gyroADCRaw[X] = (int16_t)((data[1] << 8) | data[2]);
+    gyro->gyroADCRaw[Y] = (int16_t)((data[3] << 8) | data[4]);
+    gyro->gyroADCRaw[Z] = (int16_t)((data[5] << 8) | data[6]);
+
+    return true;
+}
+
+// Read the gyro data with DMA, started from the data ready interrupt so that the transfer overlaps the processing
+// of the previous sample. Only called once the gyro is initialised, as the bus is used without DMA until then.
+bool mpuGyroSpiDmaInit(gyroDev_t *gyro)
+{
+    if (gyro->readFn != mpuGyroReadSPI || gyro->mpuIntExtiTag == IO_TAG_NONE || mpuDmaReadCount >= MPU_DMA_READ_COUNT) {
+        return false;
+    }
+
+    if (!spiBusEnableSequenceDMA(&gyro->bus)) {
+        return false;
+    }
+
+    gyro->dmaReadSegments[0] = (busSegment_t){ .txData = mpuDmaReadTxData, .rxData = mpuDmaReadRxData[mpuDmaReadCount++], .len = MPU_GYRO_READ_LENGTH, .negateCS = true };
+    gyro->dmaReadSegments[1] = (busSegment_t){ .len = 0 };
+    gyro->readFn = mpuGyroReadSPIDMA;
+    gyro->useDmaRead = true;
+
+    return true;
+}
+#endif // USE_SPI_DMA
+
 typedef uint8_t (*gyroSpiDetectFn_t)(const busDevice_t *bus);
 
 static gyroSpiDetectFn_t gyroSpiDetectFnTable[] = {
@@ -247,14 +317,31 @@ static bool detectSPISensorsAndUpdateDetectionResult(gyroDev_t *gyro, const gyro
 
     uint8_t sensor = MPU_NONE;
 
+    // Some detection functions reset the device and wait for it, so probe the one that found
+    // the sensor on the previous startup first and only fall back to the full scan if that fails.
+    const size_t hintIndex = gyro->spiDetectIndex;
+    if (hintIndex && hintIndex < ARRAYLEN(gyroSpiDetectFnTable)) {
+        sensor = (gyroSpiDetectFnTable[hintIndex - 1])(&gyro->bus);
+        if (sensor != MPU_NONE) {
+            gyro->mpuDetectionResult.sensor = sensor;
+            busDeviceRegister(&gyro->bus);
+
+            return true;
+        }
+    }
+
     // It is hard to use hardware to optimize the detection loop here,
     // as hardware type and detection function name doesn't match.
     // May need a bitmap of hardware to detection function to do it right?
 
     for (size_t index = 0 ; gyroSpiDetectFnTable[index] ; index++) {
+        if (index + 1 == hintIndex) {
+            continue;
+        }
         sensor = (gyroSpiDetectFnTable[index])(&gyro->bus);
         if (sensor != MPU_NONE) {
             gyro->mpuDetectionResult.sensor = sensor;
+            gyro->spiDetectIndex = index + 1;
             busDeviceRegister(&gyro->bus);
 
             return true;
@@ -262,6 +349,7 @@ static bool detectSPISensorsAndUpdateDetectionResult(gyroDev_t *gyro, const gyro
     }
 
     // Detection failed, disable CS pin again
+    gyro->spiDetectIndex = 0;
 
     spiPreinitByTag(config->csnTag);
 
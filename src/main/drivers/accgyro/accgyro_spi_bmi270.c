@@ -40,6 +40,12 @@
 
 #define BMI270_FIFO_FRAME_SIZE 6
 
+#ifdef USE_GYRO_FIFO
+#define BMI270_FIFO_MAX_FRAMES GYRO_FIFO_MAX_SAMPLES
+#else
+#define BMI270_FIFO_MAX_FRAMES 1
+#endif
+
 #define BMI270_CONFIG_SIZE 8192
 
 // Declaration for the device config (microcode) that must be uploaded to the sensor
@@ -119,7 +125,7 @@ typedef enum {
     BMI270_VAL_FIFO_CONFIG_0 = 0x00,         // don't stop when full, disable sensortime frame
     BMI270_VAL_FIFO_CONFIG_1 = 0x80,         // only gyro data in FIFO, use headerless mode
     BMI270_VAL_FIFO_DOWNS = 0x00,            // select unfiltered gyro data with no downsampling (6.4KHz samples)
-    BMI270_VAL_FIFO_WTM_0 = 0x06,            // set the FIFO watermark level to 1 gyro sample (6 bytes)
+    BMI270_VAL_FIFO_DOWNS_FILTERED = 0x08,   // select filtered gyro data with no downsampling (3.2KHz samples)
     BMI270_VAL_FIFO_WTM_1 = 0x00,            // FIFO watermark MSB
 } bmi270ConfigValues_e;
 
@@ -181,17 +187,39 @@ static void bmi270UploadConfig(const busDevice_t *bus)
     bmi270RegisterWrite(bus, BMI270_REG_INIT_CTRL, 1, 1);
 }
 
-static void bmi270Config(const gyroDev_t *gyro)
+// If running in hardware_lpf experimental mode then switch to FIFO-based,
+// 6.4KHz sampling, unfiltered data vs. the default 3.2KHz with hardware filtering
+static bool bmi270UnfilteredMode(const gyroDev_t *gyro)
 {
-    const busDevice_t *bus = &gyro->bus;
-
-    // If running in hardware_lpf experimental mode then switch to FIFO-based,
-    // 6.4KHz sampling, unfiltered data vs. the default 3.2KHz with hardware filtering
 #ifdef USE_GYRO_DLPF_EXPERIMENTAL
-    const bool fifoMode = (gyro->hardware_lpf == GYRO_HARDWARE_LPF_EXPERIMENTAL);
+    return gyro->hardware_lpf == GYRO_HARDWARE_LPF_EXPERIMENTAL;
 #else
-    const bool fifoMode = false;
+    UNUSED(gyro);
+    return false;
 #endif
+}
+
+static uint8_t bmi270FifoDepth(const gyroDev_t *gyro)
+{
+#ifdef USE_GYRO_FIFO
+    return MAX(gyro->fifoDepth, 1);
+#else
+    UNUSED(gyro);
+    return 1;
+#endif
+}
+
+// The filtered 3.2KHz data is read from the FIFO too when several samples are burst read per interrupt
+static bool bmi270FifoMode(const gyroDev_t *gyro)
+{
+    return bmi270UnfilteredMode(gyro) || bmi270FifoDepth(gyro) > 1;
+}
+
+static void bmi270Config(const gyroDev_t *gyro)
+{
+    const busDevice_t *bus = &gyro->bus;
+
+    const bool fifoMode = bmi270FifoMode(gyro);
 
     // Perform a soft reset to set all configuration to default
     // Delay 100ms before continuing configuration
@@ -206,8 +234,9 @@ static void bmi270Config(const gyroDev_t *gyro)
     if (fifoMode) {
         bmi270RegisterWrite(bus, BMI270_REG_FIFO_CONFIG_0, BMI270_VAL_FIFO_CONFIG_0, 1);
         bmi270RegisterWrite(bus, BMI270_REG_FIFO_CONFIG_1, BMI270_VAL_FIFO_CONFIG_1, 1);
-        bmi270RegisterWrite(bus, BMI270_REG_FIFO_DOWNS, BMI270_VAL_FIFO_DOWNS, 1);
-        bmi270RegisterWrite(bus, BMI270_REG_FIFO_WTM_0, BMI270_VAL_FIFO_WTM_0, 1);
+        bmi270RegisterWrite(bus, BMI270_REG_FIFO_DOWNS, bmi270UnfilteredMode(gyro) ? BMI270_VAL_FIFO_DOWNS : BMI270_VAL_FIFO_DOWNS_FILTERED, 1);
+        // Set the FIFO watermark level to the number of gyro samples read per interrupt
+        bmi270RegisterWrite(bus, BMI270_REG_FIFO_WTM_0, BMI270_FIFO_FRAME_SIZE * bmi270FifoDepth(gyro), 1);
         bmi270RegisterWrite(bus, BMI270_REG_FIFO_WTM_1, BMI270_VAL_FIFO_WTM_1, 1);
     }
 
@@ -253,7 +282,7 @@ extiCallbackRec_t bmi270IntCallbackRec;
 void bmi270ExtiHandler(extiCallbackRec_t *cb)
 {
     gyroDev_t *gyro = container_of(cb, gyroDev_t, exti);
-    gyro->dataReady = true;
+    gyroDevSetDataReady(gyro);
 }
 
 static void bmi270IntExtiInit(gyroDev_t *gyro)
@@ -266,7 +295,7 @@ static void bmi270IntExtiInit(gyroDev_t *gyro)
 
     IOInit(mpuIntIO, OWNER_GYRO_EXTI, 0);
     EXTIHandlerInit(&gyro->exti, bmi270ExtiHandler);
-    EXTIConfig(mpuIntIO, &gyro->exti, NVIC_PRIO_MPU_INT_EXTI, IOCFG_IN_FLOATING, BETAFLIGHT_EXTI_TRIGGER_RISING);
+    EXTIConfig(mpuIntIO, &gyro->exti, NVIC_PRIO_GYRO_INT_EXTI, IOCFG_IN_FLOATING, BETAFLIGHT_EXTI_TRIGGER_RISING);
     EXTIEnable(mpuIntIO, true);
 }
 #endif
@@ -327,7 +356,6 @@ static bool bmi270GyroReadRegister(gyroDev_t *gyro)
     return true;
 }
 
-#ifdef USE_GYRO_DLPF_EXPERIMENTAL
 static bool bmi270GyroReadFifo(gyroDev_t *gyro)
 {
     enum {
@@ -335,33 +363,32 @@ static bool bmi270GyroReadFifo(gyroDev_t *gyro)
         IDX_SKIP,
         IDX_FIFO_LENGTH_L,
         IDX_FIFO_LENGTH_H,
-        IDX_GYRO_XOUT_L,
-        IDX_GYRO_XOUT_H,
-        IDX_GYRO_YOUT_L,
-        IDX_GYRO_YOUT_H,
-        IDX_GYRO_ZOUT_L,
-        IDX_GYRO_ZOUT_H,
-        BUFFER_SIZE,
+        IDX_FIFO_DATA,
+        BUFFER_SIZE = IDX_FIFO_DATA + BMI270_FIFO_FRAME_SIZE * BMI270_FIFO_MAX_FRAMES,
     };
 
     bool dataRead = false;
-    static const uint8_t bmi270_tx_buf[BUFFER_SIZE] = {BMI270_REG_FIFO_LENGTH_LSB | 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    static const uint8_t bmi270_tx_buf[BUFFER_SIZE] = {BMI270_REG_FIFO_LENGTH_LSB | 0x80};
     uint8_t bmi270_rx_buf[BUFFER_SIZE];
 
-    // Burst read the FIFO length followed by the next 6 bytes containing the gyro axis data for
-    // the first sample in the queue. It's possible for the FIFO to be empty so we need to check the
-    // length before using the sample.
+    const int fifoDepth = bmi270FifoDepth(gyro);
+
+    // Burst read the FIFO length followed by the frames containing the gyro axis data for the
+    // next fifoDepth samples in the queue. It's possible for the FIFO to hold fewer samples, or to
+    // be empty, so we need to check the length before using the samples.
     IOLo(gyro->bus.busdev_u.spi.csnPin);
-    spiTransfer(gyro->bus.busdev_u.spi.instance, bmi270_tx_buf, bmi270_rx_buf, BUFFER_SIZE);   // receive response
+    spiTransfer(gyro->bus.busdev_u.spi.instance, bmi270_tx_buf, bmi270_rx_buf, IDX_FIFO_DATA + BMI270_FIFO_FRAME_SIZE * fifoDepth);   // receive response
     IOHi(gyro->bus.busdev_u.spi.csnPin);
 
     int fifoLength = (uint16_t)((bmi270_rx_buf[IDX_FIFO_LENGTH_H] << 8) | bmi270_rx_buf[IDX_FIFO_LENGTH_L]);
+    int sampleCount = 0;
 
-    if (fifoLength >= BMI270_FIFO_FRAME_SIZE) {
+    for (int frame = 0; frame < fifoDepth && fifoLength >= BMI270_FIFO_FRAME_SIZE; frame++) {
+        const uint8_t *frameData = &bmi270_rx_buf[IDX_FIFO_DATA + frame * BMI270_FIFO_FRAME_SIZE];
 
-        const int16_t gyroX = (int16_t)((bmi270_rx_buf[IDX_GYRO_XOUT_H] << 8) | bmi270_rx_buf[IDX_GYRO_XOUT_L]);
-        const int16_t gyroY = (int16_t)((bmi270_rx_buf[IDX_GYRO_YOUT_H] << 8) | bmi270_rx_buf[IDX_GYRO_YOUT_L]);
-        const int16_t gyroZ = (int16_t)((bmi270_rx_buf[IDX_GYRO_ZOUT_H] << 8) | bmi270_rx_buf[IDX_GYRO_ZOUT_L]);
+        const int16_t gyroX = (int16_t)((frameData[1] << 8) | frameData[0]);
+        const int16_t gyroY = (int16_t)((frameData[3] << 8) | frameData[2]);
+        const int16_t gyroZ = (int16_t)((frameData[5] << 8) | frameData[4]);
 
         // If the FIFO data is invalid then the returned values will be 0x8000 (-32768) (pg. 43 of datasheet).
         // This shouldn't happen since we're only using the data if the FIFO length indicates
@@ -371,36 +398,41 @@ static bool bmi270GyroReadFifo(gyroDev_t *gyro)
             gyro->gyroADCRaw[X] = gyroX;
             gyro->gyroADCRaw[Y] = gyroY;
             gyro->gyroADCRaw[Z] = gyroZ;
+#ifdef USE_GYRO_FIFO
+            gyro->fifoSamples[sampleCount][X] = gyroX;
+            gyro->fifoSamples[sampleCount][Y] = gyroY;
+            gyro->fifoSamples[sampleCount][Z] = gyroZ;
+#endif
+            sampleCount++;
             dataRead = true;
         }
         fifoLength -= BMI270_FIFO_FRAME_SIZE;
     }
+#ifdef USE_GYRO_FIFO
+    gyro->fifoSampleCount = sampleCount;
+#endif
 
-    // If there are additional samples in the FIFO then we don't use those for now and simply
-    // flush the FIFO. Under normal circumstances we only expect one sample in the FIFO since
-    // the gyro loop is running at the native sample rate of 6.4KHz.
+    // If there are more samples left in the FIFO than one burst then we've fallen behind and
+    // simply flush the FIFO. Under normal circumstances we only expect fifoDepth samples in the
+    // FIFO since the gyro task is running at the rate of the watermark interrupt.
     // However the way the FIFO works in the sensor is that if a frame is partially read then
     // it remains in the queue instead of bein removed. So if we ever got into a state where there
     // was a partial frame or other unexpected data in the FIFO is may never get cleared and we
     // would end up in a lock state of always re-reading the same partial or invalid sample.
-    if (fifoLength > 0) {
+    if ((fifoLength % BMI270_FIFO_FRAME_SIZE) || (fifoLength >= BMI270_FIFO_FRAME_SIZE * fifoDepth)) {
         // Partial or additional frames left - flush the FIFO
         bmi270RegisterWrite(&gyro->bus, BMI270_REG_CMD, BMI270_VAL_CMD_FIFOFLUSH, 0);
     }
 
     return dataRead;
 }
-#endif
 
 static bool bmi270GyroRead(gyroDev_t *gyro)
 {
-#ifdef USE_GYRO_DLPF_EXPERIMENTAL
-    if (gyro->hardware_lpf == GYRO_HARDWARE_LPF_EXPERIMENTAL) {
-        // running in 6.4KHz FIFO mode
+    if (bmi270FifoMode(gyro)) {
+        // running in 6.4KHz unfiltered or burst read FIFO mode
         return bmi270GyroReadFifo(gyro);
-    } else
-#endif
-    {
+    } else {
         // running in 3.2KHz register mode
         return bmi270GyroReadRegister(gyro);
     }
@@ -443,6 +475,9 @@ bool bmi270SpiGyroDetect(gyroDev_t *gyro)
     gyro->initFn = bmi270SpiGyroInit;
     gyro->readFn = bmi270GyroRead;
     gyro->scale = GYRO_SCALE_2000DPS;
+#ifdef USE_GYRO_FIFO
+    gyro->fifoDepth = GYRO_FIFO_MAX_SAMPLES;
+#endif
 
     return true;
 }
@@ -451,7 +486,7 @@ bool bmi270SpiGyroDetect(gyroDev_t *gyro)
 // When in 3.2KHz mode the interrupt is mapped to the data ready state. However the data ready
 // trigger will fire for both gyro and accelerometer. So it's necessary to check this register
 // to determine which event caused the interrupt.
-// When in 6.4KHz mode the interrupt is configured to be the FIFO watermark size of 6 bytes.
+// When in FIFO mode the interrupt is configured to be the FIFO watermark size of 6 bytes per sample.
 // Since in this mode we only put gyro data in the FIFO it's sufficient to check for the FIFO
 // watermark reason as an idication of gyro data ready.
 uint8_t bmi270InterruptStatus(gyroDev_t *gyro)
@@ -94,6 +94,28 @@
 #define ICM42605_RA_INT_SOURCE0                     0x65
 #define ICM42605_UI_DRDY_INT1_EN_DISABLED           (0 << 3)
 #define ICM42605_UI_DRDY_INT1_EN_ENABLED            (1 << 3)
+#define ICM42605_FIFO_THS_INT1_EN_ENABLED           (1 << 2)
+
+#define ICM42605_RA_SIGNAL_PATH_RESET               0x4B
+#define ICM42605_FIFO_FLUSH                         (1 << 1)
+
+#define ICM42605_RA_FIFO_CONFIG                     0x16
+#define ICM42605_FIFO_MODE_BYPASS                   (0 << 6)
+#define ICM42605_FIFO_MODE_STREAM                   (1 << 6)
+
+#define ICM42605_RA_FIFO_CONFIG1                    0x5F
+#define ICM42605_FIFO_GYRO_EN                       (1 << 1)
+#define ICM42605_FIFO_WM_GT_TH                      (1 << 5)
+
+#define ICM42605_RA_FIFO_CONFIG2                    0x60    // watermark in bytes, LSB
+#define ICM42605_RA_FIFO_CONFIG3                    0x61    // watermark in bytes, MSB
+
+#define ICM42605_RA_FIFO_COUNTH                     0x2E
+#define ICM42605_RA_FIFO_DATA                       0x30
+
+// With only the gyro enabled each FIFO packet is a header, the gyro data and a temperature byte
+#define ICM42605_FIFO_PACKET_SIZE                   8
+#define ICM42605_FIFO_HEADER_EMPTY                  (1 << 7)
 
 static void icm42605SpiInit(const busDevice_t *bus)
 {
@@ -190,6 +212,58 @@ odrEntry_t khzToSupportedODRMap[] = {
     { 1, 6 },
 };
 
+#ifdef USE_GYRO_FIFO
+static bool icm42605GyroReadFifo(gyroDev_t *gyro)
+{
+    static const uint8_t countToSend[3] = {ICM42605_RA_FIFO_COUNTH | 0x80, 0xFF, 0xFF};
+    uint8_t count[3];
+
+    if (!spiBusTransfer(&gyro->bus, countToSend, count, 3)) {
+        return false;
+    }
+
+    // The FIFO count is in bytes, big endian. Only whole packets are read, anything beyond one burst
+    // stays queued for the next read.
+    const int fifoCount = (count[1] << 8) | count[2];
+    const int packetCount = MIN(fifoCount / ICM42605_FIFO_PACKET_SIZE, gyro->fifoDepth);
+    if (packetCount == 0) {
+        return false;
+    }
+
+    static const uint8_t dataToSend[1 + ICM42605_FIFO_PACKET_SIZE * GYRO_FIFO_MAX_SAMPLES] = {ICM42605_RA_FIFO_DATA | 0x80};
+    uint8_t data[1 + ICM42605_FIFO_PACKET_SIZE * GYRO_FIFO_MAX_SAMPLES];
+
+    if (!spiBusTransfer(&gyro->bus, dataToSend, data, 1 + ICM42605_FIFO_PACKET_SIZE * packetCount)) {
+        return false;
+    }
+
+    int sampleCount = 0;
+    for (int packet = 0; packet < packetCount; packet++) {
+        const uint8_t *packetData = &data[1 + packet * ICM42605_FIFO_PACKET_SIZE];
+
+        if (packetData[0] & ICM42605_FIFO_HEADER_EMPTY) {
+            continue;
+        }
+
+        gyro->fifoSamples[sampleCount][X] = (int16_t)((packetData[1] << 8) | packetData[2]);
+        gyro->fifoSamples[sampleCount][Y] = (int16_t)((packetData[3] << 8) | packetData[4]);
+        gyro->fifoSamples[sampleCount][Z] = (int16_t)((packetData[5] << 8) | packetData[6]);
+        sampleCount++;
+    }
+
+    if (sampleCount == 0) {
+        return false;
+    }
+
+    gyro->fifoSampleCount = sampleCount;
+    gyro->gyroADCRaw[X] = gyro->fifoSamples[sampleCount - 1][X];
+    gyro->gyroADCRaw[Y] = gyro->fifoSamples[sampleCount - 1][Y];
+    gyro->gyroADCRaw[Z] = gyro->fifoSamples[sampleCount - 1][Z];
+
+    return true;
+}
+#endif
+
 void icm42605GyroInit(gyroDev_t *gyro)
 {
     mpuGyroInit(gyro);
@@ -240,8 +314,29 @@ void icm42605GyroInit(gyroDev_t *gyro)
     spiBusWriteRegister(&gyro->bus, ICM42605_RA_INT_CONFIG, ICM42605_INT1_MODE_PULSED | ICM42605_INT1_DRIVE_CIRCUIT_PP | ICM42605_INT1_POLARITY_ACTIVE_HIGH);
     spiBusWriteRegister(&gyro->bus, ICM42605_RA_INT_CONFIG0, ICM42605_UI_DRDY_INT_CLEAR_ON_SBR);
 
+#ifdef USE_GYRO_FIFO
+    if (gyro->fifoDepth > 1) {
+        // Accumulate the gyro samples in the FIFO and interrupt once a whole burst is ready
+        const uint16_t watermark = ICM42605_FIFO_PACKET_SIZE * gyro->fifoDepth;
+        spiBusWriteRegister(&gyro->bus, ICM42605_RA_FIFO_CONFIG1, ICM42605_FIFO_WM_GT_TH | ICM42605_FIFO_GYRO_EN);
+        spiBusWriteRegister(&gyro->bus, ICM42605_RA_FIFO_CONFIG2, watermark & 0xFF);
+        spiBusWriteRegister(&gyro->bus, ICM42605_RA_FIFO_CONFIG3, watermark >> 8);
+        spiBusWriteRegister(&gyro->bus, ICM42605_RA_FIFO_CONFIG, ICM42605_FIFO_MODE_STREAM);
+        spiBusWriteRegister(&gyro->bus, ICM42605_RA_SIGNAL_PATH_RESET, ICM42605_FIFO_FLUSH);
+
+        gyro->readFn = icm42605GyroReadFifo;
+    }
+#endif
+
 #ifdef USE_MPU_DATA_READY_SIGNAL
-    spiBusWriteRegister(&gyro->bus, ICM42605_RA_INT_SOURCE0, ICM42605_UI_DRDY_INT1_EN_ENABLED);
+#ifdef USE_GYRO_FIFO
+    if (gyro->fifoDepth > 1) {
+        spiBusWriteRegister(&gyro->bus, ICM42605_RA_INT_SOURCE0, ICM42605_FIFO_THS_INT1_EN_ENABLED);
+    } else
+#endif
+    {
+        spiBusWriteRegister(&gyro->bus, ICM42605_RA_INT_SOURCE0, ICM42605_UI_DRDY_INT1_EN_ENABLED);
+    }
 
     uint8_t intConfig1Value = spiBusReadRegister(&gyro->bus, ICM42605_RA_INT_CONFIG1);
     // Datasheet says: "User should change setting to 0 from default setting of 1, for proper INT1 and INT2 pin operation"
@@ -285,6 +380,9 @@ bool icm42605SpiGyroDetect(gyroDev_t *gyro)
     gyro->readFn = icm42605GyroReadSPI;
 
     gyro->scale = GYRO_SCALE_2000DPS;
+#ifdef USE_GYRO_FIFO
+    gyro->fifoDepth = GYRO_FIFO_MAX_SAMPLES;
+#endif
 
     return true;
 }
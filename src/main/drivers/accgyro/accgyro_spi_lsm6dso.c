@@ -36,7 +36,7 @@
 void lsm6dsoExtiHandler(extiCallbackRec_t *cb)
 {
     gyroDev_t *gyro = container_of(cb, gyroDev_t, exti);
-    gyro->dataReady = true;
+    gyroDevSetDataReady(gyro);
 }
 #endif
 
@@ -87,4 +87,69 @@ bool lsm6dsoGyroRead(gyroDev_t *gyro)
 
     return true;
 }
+
+#ifdef USE_GYRO_FIFO
+// Each FIFO word is a tag byte followed by the X/Y/Z LSB/MSB data
+#define LSM6DSO_FIFO_WORD_SIZE 7
+#define LSM6DSO_FIFO_TAG_GYRO_NC 0x01
+#define LSM6DSO_FIFO_DIFF_MSB_MASK 0x03
+
+bool lsm6dsoGyroReadFifo(gyroDev_t *gyro)
+{
+    enum {
+        IDX_FIFO_TAG,
+        IDX_GYRO_XOUT_L,
+        IDX_GYRO_XOUT_H,
+        IDX_GYRO_YOUT_L,
+        IDX_GYRO_YOUT_H,
+        IDX_GYRO_ZOUT_L,
+        IDX_GYRO_ZOUT_H,
+    };
+
+    const busDevice_t *busdev = &gyro->bus;
+
+    uint8_t fifoStatus[2];
+    if (!busReadRegisterBuffer(busdev, LSM6DSO_REG_FIFO_STATUS1, fifoStatus, sizeof(fifoStatus))) {
+        return false;
+    }
+
+    // Only read one burst, anything else stays queued for the next read
+    const int unreadWords = ((fifoStatus[1] & LSM6DSO_FIFO_DIFF_MSB_MASK) << 8) | fifoStatus[0];
+    const int wordCount = MIN(unreadWords, gyro->fifoDepth);
+    if (wordCount == 0) {
+        return false;
+    }
+
+    // Burst reads of the FIFO output registers wrap from the last data byte back to the tag
+    uint8_t lsm6dso_rx_buf[LSM6DSO_FIFO_WORD_SIZE * GYRO_FIFO_MAX_SAMPLES];
+    if (!busReadRegisterBuffer(busdev, LSM6DSO_REG_FIFO_DATA_OUT_TAG, lsm6dso_rx_buf, LSM6DSO_FIFO_WORD_SIZE * wordCount)) {
+        return false;
+    }
+
+    int sampleCount = 0;
+    for (int word = 0; word < wordCount; word++) {
+        const uint8_t *wordData = &lsm6dso_rx_buf[word * LSM6DSO_FIFO_WORD_SIZE];
+
+        if ((wordData[IDX_FIFO_TAG] >> 3) != LSM6DSO_FIFO_TAG_GYRO_NC) {
+            continue;
+        }
+
+        gyro->fifoSamples[sampleCount][X] = (int16_t)((wordData[IDX_GYRO_XOUT_H] << 8) | wordData[IDX_GYRO_XOUT_L]);
+        gyro->fifoSamples[sampleCount][Y] = (int16_t)((wordData[IDX_GYRO_YOUT_H] << 8) | wordData[IDX_GYRO_YOUT_L]);
+        gyro->fifoSamples[sampleCount][Z] = (int16_t)((wordData[IDX_GYRO_ZOUT_H] << 8) | wordData[IDX_GYRO_ZOUT_L]);
+        sampleCount++;
+    }
+
+    if (sampleCount == 0) {
+        return false;
+    }
+
+    gyro->fifoSampleCount = sampleCount;
+    gyro->gyroADCRaw[X] = gyro->fifoSamples[sampleCount - 1][X];
+    gyro->gyroADCRaw[Y] = gyro->fifoSamples[sampleCount - 1][Y];
+    gyro->gyroADCRaw[Z] = gyro->fifoSamples[sampleCount - 1][Z];
+
+    return true;
+}
+#endif
 #endif
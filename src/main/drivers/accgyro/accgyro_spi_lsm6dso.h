@@ -25,6 +25,10 @@
 
 // LSM6DSO registers (not the complete list)
 typedef enum {
+    LSM6DSO_REG_FIFO_CTRL1 = 0x07, // FIFO watermark LSB
+    LSM6DSO_REG_FIFO_CTRL2 = 0x08, // FIFO watermark MSB and compression
+    LSM6DSO_REG_FIFO_CTRL3 = 0x09, // FIFO batch data rates
+    LSM6DSO_REG_FIFO_CTRL4 = 0x0A, // FIFO mode
     LSM6DSO_REG_INT1_CTRL = 0x0D,  // int pin 1 control
     LSM6DSO_REG_INT2_CTRL = 0x0E,  // int pin 2 control
     LSM6DSO_REG_WHO_AM_I = 0x0F,   // chip ID
@@ -53,6 +57,9 @@ typedef enum {
     LSM6DSO_REG_OUTY_H_A = 0x2B,   // acc Y axis MSB
     LSM6DSO_REG_OUTZ_L_A = 0x2C,   // acc Z axis LSB
     LSM6DSO_REG_OUTZ_H_A = 0x2D,   // acc Z axis MSB
+    LSM6DSO_REG_FIFO_STATUS1 = 0x3A, // FIFO unread words LSB
+    LSM6DSO_REG_FIFO_STATUS2 = 0x3B, // FIFO unread words MSB and flags
+    LSM6DSO_REG_FIFO_DATA_OUT_TAG = 0x78, // FIFO word tag, followed by the X/Y/Z LSB/MSB data
 } lsm6dsoRegister_e;
 
 // Contained in accgyro_spi_lsm6dso_init.c which is size-optimized
@@ -64,3 +71,6 @@ bool lsm6dsoSpiGyroDetect(gyroDev_t *gyro);
 void lsm6dsoExtiHandler(extiCallbackRec_t *cb);
 bool lsm6dsoAccRead(accDev_t *acc);
 bool lsm6dsoGyroRead(gyroDev_t *gyro);
+#ifdef USE_GYRO_FIFO
+bool lsm6dsoGyroReadFifo(gyroDev_t *gyro);
+#endif
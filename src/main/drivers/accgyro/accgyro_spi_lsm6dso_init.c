@@ -43,6 +43,7 @@
 // LSM6DSO register configuration values
 typedef enum {
     LSM6DSO_VAL_INT1_CTRL = 0x02,             // enable gyro data ready interrupt pin 1
+    LSM6DSO_VAL_INT1_CTRL_FIFO_TH = 0x08,     // enable FIFO watermark interrupt pin 1
     LSM6DSO_VAL_INT2_CTRL = 0x02,             // enable gyro data ready interrupt pin 2
     LSM6DSO_VAL_CTRL1_XL_ODR833 = 0x07,       // accelerometer 833hz output data rate (gyro/8)
     LSM6DSO_VAL_CTRL1_XL_ODR1667 = 0x08,      // accelerometer 1666hz output data rate (gyro/4)
@@ -67,6 +68,9 @@ typedef enum {
     LSM6DSO_VAL_CTRL6_C_FTYPE_171HZ = 0x02,   // (bits 2:0) gyro LPF1 cutoff 171.1hz
     LSM6DSO_VAL_CTRL6_C_FTYPE_609HZ = 0x03,   // (bits 2:0) gyro LPF1 cutoff 609.0hz
     LSM6DSO_VAL_CTRL9_XL_I3C_DISABLE = BIT(1),// (bit 1) disable I3C interface
+    LSM6DSO_VAL_FIFO_CTRL2 = 0x00,            // watermark MSB, no compression
+    LSM6DSO_VAL_FIFO_CTRL3_BDR_GY_6664 = 0x0A,// (bits 7:4) batch gyro data at 6664hz, don't batch accelerometer data
+    LSM6DSO_VAL_FIFO_CTRL4_CONTINUOUS = 0x06, // (bits 2:0) continuous mode, oldest samples are overwritten when full
 } lsm6dsoConfigValues_e;
 
 // LSM6DSO register configuration bit masks
@@ -114,11 +118,22 @@ static void lsm6dsoConfig(const gyroDev_t *gyro)
 {
     const busDevice_t *bus = &gyro->bus;
 
+#ifdef USE_GYRO_FIFO
+    const bool fifoMode = (gyro->fifoDepth > 1);
+#else
+    const bool fifoMode = false;
+#endif
+
     // Reset the device (wait 100ms before continuing config)
     lsm6dsoWriteRegisterBits(bus, LSM6DSO_REG_CTRL3_C, LSM6DSO_MASK_CTRL3_C_RESET, BIT(0), 100);
 
-    // Configure interrupt pin 1 for gyro data ready only
-    lsm6dsoWriteRegister(bus, LSM6DSO_REG_INT1_CTRL, LSM6DSO_VAL_INT1_CTRL, 1);
+    if (fifoMode) {
+        // Configure interrupt pin 1 for the FIFO watermark only
+        lsm6dsoWriteRegister(bus, LSM6DSO_REG_INT1_CTRL, LSM6DSO_VAL_INT1_CTRL_FIFO_TH, 1);
+    } else {
+        // Configure interrupt pin 1 for gyro data ready only
+        lsm6dsoWriteRegister(bus, LSM6DSO_REG_INT1_CTRL, LSM6DSO_VAL_INT1_CTRL, 1);
+    }
 
     // Disable interrupt pin 2
     lsm6dsoWriteRegister(bus, LSM6DSO_REG_INT2_CTRL, LSM6DSO_VAL_INT2_CTRL, 1);
@@ -146,6 +161,17 @@ static void lsm6dsoConfig(const gyroDev_t *gyro)
     // Configure control register 9
     // disable I3C interface
     lsm6dsoWriteRegisterBits(bus, LSM6DSO_REG_CTRL9_XL, LSM6DSO_MASK_CTRL9_XL, LSM6DSO_VAL_CTRL9_XL_I3C_DISABLE, 1);
+
+#ifdef USE_GYRO_FIFO
+    // Configure the FIFO
+    // watermark of one burst of gyro samples; batch gyro data only; continuous mode
+    if (fifoMode) {
+        lsm6dsoWriteRegister(bus, LSM6DSO_REG_FIFO_CTRL1, gyro->fifoDepth, 1);
+        lsm6dsoWriteRegister(bus, LSM6DSO_REG_FIFO_CTRL2, LSM6DSO_VAL_FIFO_CTRL2, 1);
+        lsm6dsoWriteRegister(bus, LSM6DSO_REG_FIFO_CTRL3, LSM6DSO_VAL_FIFO_CTRL3_BDR_GY_6664, 1);
+        lsm6dsoWriteRegister(bus, LSM6DSO_REG_FIFO_CTRL4, LSM6DSO_VAL_FIFO_CTRL4_CONTINUOUS, 1);
+    }
+#endif
 }
 
 #if defined(USE_GYRO_EXTI) && defined(USE_MPU_DATA_READY_SIGNAL)
@@ -159,7 +185,7 @@ static void lsm6dsoIntExtiInit(gyroDev_t *gyro)
 
     IOInit(mpuIntIO, OWNER_GYRO_EXTI, 0);
     EXTIHandlerInit(&gyro->exti, lsm6dsoExtiHandler);
-    EXTIConfig(mpuIntIO, &gyro->exti, NVIC_PRIO_MPU_INT_EXTI, IOCFG_IN_FLOATING, BETAFLIGHT_EXTI_TRIGGER_RISING);
+    EXTIConfig(mpuIntIO, &gyro->exti, NVIC_PRIO_GYRO_INT_EXTI, IOCFG_IN_FLOATING, BETAFLIGHT_EXTI_TRIGGER_RISING);
     EXTIEnable(mpuIntIO, true);
 }
 #endif
@@ -168,6 +194,12 @@ static void lsm6dsoSpiGyroInit(gyroDev_t *gyro)
 {
     lsm6dsoConfig(gyro);
 
+#ifdef USE_GYRO_FIFO
+    if (gyro->fifoDepth > 1) {
+        gyro->readFn = lsm6dsoGyroReadFifo;
+    }
+#endif
+
 #if defined(USE_GYRO_EXTI) && defined(USE_MPU_DATA_READY_SIGNAL)
     lsm6dsoIntExtiInit(gyro);
 #endif
@@ -200,6 +232,9 @@ bool lsm6dsoSpiGyroDetect(gyroDev_t *gyro)
     gyro->initFn = lsm6dsoSpiGyroInit;
     gyro->readFn = lsm6dsoGyroRead;
     gyro->scale = GYRO_SCALE_2000DPS;
+#ifdef USE_GYRO_FIFO
+    gyro->fifoDepth = GYRO_FIFO_MAX_SAMPLES;
+#endif
 
     return true;
 }
@@ -99,6 +99,12 @@ extern const adcTagMap_t adcTagMap[ADC_TAG_MAP_COUNT];
 extern adcOperatingConfig_t adcOperatingConfig[ADC_CHANNEL_COUNT];
 extern volatile uint16_t adcValues[ADC_CHANNEL_COUNT];
 
+// Every value published in adcValues[] is the mean of ADC_OVERSAMPLE_COUNT conversions.
+// H7 and G4 average in the ADC oversampler, F4 and F7 keep the last ADC_OVERSAMPLE_COUNT scans in the
+// circular DMA buffer and average them in adcGetChannelValues().
+#define ADC_OVERSAMPLE_SHIFT 4
+#define ADC_OVERSAMPLE_COUNT (1 << ADC_OVERSAMPLE_SHIFT)
+
 uint8_t adcChannelByTag(ioTag_t ioTag);
 ADCDevice adcDeviceByInstance(ADC_TypeDef *instance);
 bool adcVerifyPin(ioTag_t tag, ADCDevice device);
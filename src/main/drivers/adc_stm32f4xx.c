@@ -208,6 +208,10 @@ uint16_t adcInternalReadTempsensor(void)
 }
 #endif
 
+// Circular DMA buffer of the last ADC_OVERSAMPLE_COUNT scans of the regular channels
+static volatile uint16_t adcConversionBuffer[ADC_CHANNEL_COUNT * ADC_OVERSAMPLE_COUNT];
+static uint8_t adcConversionChannels;
+
 void adcInit(const adcConfig_t *config)
 {
     uint8_t i;
@@ -288,6 +292,7 @@ void adcInit(const adcConfig_t *config)
 #endif
 
     adcInitDevice(adc.ADCx, configuredAdcChannels);
+    adcConversionChannels = configuredAdcChannels;
 
     uint8_t rank = 1;
     for (i = 0; i < ADC_CHANNEL_COUNT; i++) {
@@ -328,11 +333,11 @@ void adcInit(const adcConfig_t *config)
     DMA_InitStructure.DMA_Channel = adc.channel;
 #endif
 
-    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)adcValues;
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)adcConversionBuffer;
     DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
-    DMA_InitStructure.DMA_BufferSize = configuredAdcChannels;
+    DMA_InitStructure.DMA_BufferSize = configuredAdcChannels * ADC_OVERSAMPLE_COUNT;
     DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
-    DMA_InitStructure.DMA_MemoryInc = configuredAdcChannels > 1 ? DMA_MemoryInc_Enable : DMA_MemoryInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
     DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
     DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
     DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
@@ -351,6 +356,17 @@ void adcInit(const adcConfig_t *config)
 
 void adcGetChannelValues(void)
 {
-    // Nothing to do
+    // Publish the mean of the scans in the conversion buffer, the DMA keeps overwriting the oldest one meanwhile
+
+    for (int i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        if (adcOperatingConfig[i].enabled) {
+            const uint8_t dmaIndex = adcOperatingConfig[i].dmaIndex;
+            uint32_t sum = 0;
+            for (int scan = 0; scan < ADC_OVERSAMPLE_COUNT; scan++) {
+                sum += adcConversionBuffer[scan * adcConversionChannels + dmaIndex];
+            }
+            adcValues[dmaIndex] = sum >> ADC_OVERSAMPLE_SHIFT;
+        }
+    }
 }
 #endif
@@ -202,6 +202,11 @@ uint16_t adcInternalReadTempsensor(void)
 }
 #endif
 
+// Circular DMA buffer of the last ADC_OVERSAMPLE_COUNT scans of the regular channels, in DTCM like adcValues[]
+// as the DMA bypasses the data cache
+static volatile FAST_DATA_ZERO_INIT uint16_t adcConversionBuffer[ADC_CHANNEL_COUNT * ADC_OVERSAMPLE_COUNT];
+static uint8_t adcConversionChannels;
+
 void adcInit(const adcConfig_t *config)
 {
     uint8_t i;
@@ -255,6 +260,7 @@ void adcInit(const adcConfig_t *config)
     RCC_ClockCmd(adc.rccADC, ENABLE);
 
     adcInitDevice(&adc, configuredAdcChannels);
+    adcConversionChannels = configuredAdcChannels;
 
 #ifdef USE_ADC_INTERNAL
     // If device is not ADC1 or there's no active channel, then initialize ADC1  here.
@@ -303,7 +309,7 @@ void adcInit(const adcConfig_t *config)
 
     adc.DmaHandle.Init.Direction = DMA_PERIPH_TO_MEMORY;
     adc.DmaHandle.Init.PeriphInc = DMA_PINC_DISABLE;
-    adc.DmaHandle.Init.MemInc = configuredAdcChannels > 1 ? DMA_MINC_ENABLE : DMA_MINC_DISABLE;
+    adc.DmaHandle.Init.MemInc = DMA_MINC_ENABLE;
     adc.DmaHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
     adc.DmaHandle.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
     adc.DmaHandle.Init.Mode = DMA_CIRCULAR;
@@ -321,9 +327,7 @@ void adcInit(const adcConfig_t *config)
 
     __HAL_LINKDMA(&adc.ADCHandle, DMA_Handle, adc.DmaHandle);
 
-    //HAL_CLEANINVALIDATECACHE((uint32_t*)&adcValues, configuredAdcChannels);
-
-    if (HAL_ADC_Start_DMA(&adc.ADCHandle, (uint32_t*)&adcValues, configuredAdcChannels) != HAL_OK)
+    if (HAL_ADC_Start_DMA(&adc.ADCHandle, (uint32_t*)adcConversionBuffer, configuredAdcChannels * ADC_OVERSAMPLE_COUNT) != HAL_OK)
     {
         /* Start Conversion Error */
     }
@@ -331,6 +335,17 @@ void adcInit(const adcConfig_t *config)
 
 void adcGetChannelValues(void)
 {
-    // Nothing to do
+    // Publish the mean of the scans in the conversion buffer, the DMA keeps overwriting the oldest one meanwhile
+
+    for (int i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        if (adcOperatingConfig[i].enabled) {
+            const uint8_t dmaIndex = adcOperatingConfig[i].dmaIndex;
+            uint32_t sum = 0;
+            for (int scan = 0; scan < ADC_OVERSAMPLE_COUNT; scan++) {
+                sum += adcConversionBuffer[scan * adcConversionChannels + dmaIndex];
+            }
+            adcValues[dmaIndex] = sum >> ADC_OVERSAMPLE_SHIFT;
+        }
+    }
 }
 #endif
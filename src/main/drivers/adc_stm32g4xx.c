@@ -221,7 +221,13 @@ void adcInitDevice(adcDevice_t *adcdev, int channelCount)
     hadc->Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_NONE;
     hadc->Init.DMAContinuousRequests = ENABLE;
     hadc->Init.Overrun = ADC_OVR_DATA_OVERWRITTEN;
-    hadc->Init.OversamplingMode = DISABLE;
+
+    // Average ADC_OVERSAMPLE_COUNT conversions of each channel in hardware, keeping the 12-bit scale
+    hadc->Init.OversamplingMode = ENABLE;
+    hadc->Init.Oversampling.Ratio = ADC_OVERSAMPLING_RATIO_16;
+    hadc->Init.Oversampling.RightBitShift = ADC_RIGHTBITSHIFT_4;
+    hadc->Init.Oversampling.TriggeredMode = ADC_TRIGGEREDMODE_SINGLE_TRIGGER;
+    hadc->Init.Oversampling.OversamplingStopReset = ADC_REGOVERSAMPLING_CONTINUED_MODE;
 
     if (HAL_ADC_Init(hadc) != HAL_OK) {
         handleError();
@@ -254,7 +260,7 @@ void adcInitCalibrationValues(void)
 // Need this separate from the main adcValue[] array, because channels are numbered
 // by ADC instance order that is different from ADC_xxx numbering.
 
-volatile DMA_RAM_R uint16_t adcConversionBuffer[ADC_CHANNEL_COUNT] __attribute__((aligned(32)));
+volatile DMA_BUFFER_R uint16_t adcConversionBuffer[ADC_CHANNEL_COUNT];
 
 void adcInit(const adcConfig_t *config)
 {
@@ -218,7 +218,20 @@ void adcInitDevice(adcDevice_t *adcdev, int channelCount)
 #endif
 
     hadc->Init.Overrun                  = ADC_OVR_DATA_OVERWRITTEN;
-    hadc->Init.OversamplingMode         = DISABLE;
+
+    // Average ADC_OVERSAMPLE_COUNT conversions of each channel in hardware, keeping the 12-bit scale
+    hadc->Init.OversamplingMode         = ENABLE;
+#if defined(STM32H723xx) || defined(STM32H725xx)
+    if (adcdev->ADCx == ADC3) {
+        hadc->Init.Oversampling.Ratio   = ADC3_OVERSAMPLING_RATIO_16;
+    } else
+#endif
+    {
+        hadc->Init.Oversampling.Ratio   = ADC_OVERSAMPLE_COUNT;
+    }
+    hadc->Init.Oversampling.RightBitShift = ADC_RIGHTBITSHIFT_4;
+    hadc->Init.Oversampling.TriggeredMode = ADC_TRIGGEREDMODE_SINGLE_TRIGGER;
+    hadc->Init.Oversampling.OversamplingStopReset = ADC_REGOVERSAMPLING_CONTINUED_MODE;
 
     // Initialize this ADC peripheral
 
@@ -265,7 +278,7 @@ void adcInitCalibrationValues(void)
 // Need this separate from the main adcValue[] array, because channels are numbered
 // by ADC instance order that is different from ADC_xxx numbering.
 
-static volatile DMA_RAM uint16_t adcConversionBuffer[ADC_CHANNEL_COUNT] __attribute__((aligned(32)));
+static volatile DMA_BUFFER_R uint16_t adcConversionBuffer[ADC_CHANNEL_COUNT];
 
 void adcInit(const adcConfig_t *config)
 {
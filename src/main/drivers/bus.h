@@ -61,6 +61,14 @@ typedef struct busDevice_s {
     } busdev_u;
 } busDevice_t;
 
+// A sequence of transfers made with CS asserted, terminated by a segment with a zero length
+typedef struct busSegment_s {
+    const uint8_t *txData;  // NULL to send 0xff
+    uint8_t *rxData;        // NULL to discard the received data
+    int len;
+    bool negateCS;          // Negate CS once this segment has completed
+} busSegment_t;
+
 #ifdef TARGET_BUS_INIT
 void targetBusInit(void);
 #endif
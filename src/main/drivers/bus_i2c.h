@@ -55,6 +55,22 @@ typedef enum I2CDevice {
 #define I2C_ADDR7_MIN       8
 #define I2C_ADDR7_MAX       119
 
+#define I2C_QUEUE_LENGTH    4
+
+typedef void i2cCallbackFn(uint32_t arg, bool error);
+
+// A register read or write, copied into the queue of its bus. The data must remain valid until it has completed.
+typedef struct i2cTransfer_s {
+    uint8_t address;
+    uint8_t reg;
+    uint8_t length;
+    bool read;
+    uint8_t *data;              // NULL to write the single byte below
+    uint8_t byte;
+    i2cCallbackFn *callback;    // Called from the interrupt that completed the transfer, NULL for none
+    uint32_t callbackArg;
+} i2cTransfer_t;
+
 struct i2cConfig_s;
 void i2cHardwareConfigure(const struct i2cConfig_s *i2cConfig);
 void i2cInit(I2CDevice device);
@@ -64,5 +80,11 @@ bool i2cReadBuffer(I2CDevice device, uint8_t addr_, uint8_t reg, uint8_t len, ui
 bool i2cRead(I2CDevice device, uint8_t addr_, uint8_t reg, uint8_t len, uint8_t* buf);
 bool i2cBusy(I2CDevice device, bool *error);
 
+bool i2cQueueTransfer(I2CDevice device, const i2cTransfer_t *transfer);
+bool i2cQueueBusy(I2CDevice device, uint8_t address, bool *error);
+bool i2cQueueWait(I2CDevice device);
+void i2cQueueStart(I2CDevice device);
+void i2cTransferComplete(I2CDevice device, bool error);
+
 uint16_t i2cGetErrorCounter(void);
 uint8_t i2cGetRegisteredDeviceCount(void);
@@ -28,44 +28,244 @@
 
 #include "drivers/bus.h"
 #include "drivers/bus_i2c.h"
+#include "drivers/bus_i2c_impl.h"
+#include "drivers/time.h"
+
+#define I2C_QUEUE_TIMEOUT_US 10000
 
 static uint8_t i2cRegisteredDeviceCount = 0;
 
+// Transfers are started in turn from the interrupt that completed the previous one, the head is in progress once started
+typedef struct i2cQueue_s {
+    i2cTransfer_t transfer[I2C_QUEUE_LENGTH];
+    uint8_t head;
+    volatile uint8_t count;
+    volatile bool started;
+    volatile bool error;        // The last transfer to complete failed
+    uint8_t lockDepth;
+} i2cQueue_t;
+
+static i2cQueue_t i2cQueue[I2CDEV_COUNT];
+
+// The I2C interrupts are above NVIC_PRIO_MAX, so the queue is protected by masking the interrupts of its own bus
+// The lock nests, as a callback may queue the next transfer
+static void i2cQueueLock(I2CDevice device)
+{
+#if !defined(STM32F303xC)
+    NVIC_DisableIRQ(i2cDevice[device].hardware->ev_irq);
+    NVIC_DisableIRQ(i2cDevice[device].hardware->er_irq);
+#endif
+    i2cQueue[device].lockDepth++;
+}
+
+static void i2cQueueUnlock(I2CDevice device)
+{
+    if (--i2cQueue[device].lockDepth) {
+        return;
+    }
+#if !defined(STM32F303xC)
+    NVIC_EnableIRQ(i2cDevice[device].hardware->ev_irq);
+    NVIC_EnableIRQ(i2cDevice[device].hardware->er_irq);
+#endif
+}
+
+static bool i2cQueueValid(I2CDevice device)
+{
+    return device != I2CINVALID && device < I2CDEV_COUNT && i2cDevice[device].hardware;
+}
+
+static bool i2cTransferStart(I2CDevice device, i2cTransfer_t *transfer)
+{
+    uint8_t *data = transfer->data ? transfer->data : &transfer->byte;
+
+    if (transfer->read) {
+        return i2cReadBuffer(device, transfer->address, transfer->reg, transfer->length, data);
+    }
+    return i2cWriteBuffer(device, transfer->address, transfer->reg, transfer->length, data);
+}
+
+// Remove the head of the queue, and call back with a copy as the entry may be reused from the callback
+static void i2cQueueRetire(I2CDevice device, bool error)
+{
+    i2cQueue_t *queue = &i2cQueue[device];
+    const i2cTransfer_t transfer = queue->transfer[queue->head];
+
+    queue->head = (queue->head + 1) % I2C_QUEUE_LENGTH;
+    queue->count--;
+    queue->started = false;
+    queue->error = error;
+
+    if (transfer.callback) {
+        transfer.callback(transfer.callbackArg, error);
+    }
+}
+
+// Start the head of the queue unless the bus is in use
+void i2cQueueStart(I2CDevice device)
+{
+    if (!i2cQueueValid(device)) {
+        return;
+    }
+
+    i2cQueue_t *queue = &i2cQueue[device];
+
+    i2cQueueLock(device);
+    while (queue->count && !queue->started) {
+        if (i2cTransferStart(device, &queue->transfer[queue->head])) {
+            queue->started = true;
+#if defined(STM32F303xC)
+            // The F3 driver is polled, so the transfer completed before it returned
+            i2cQueueRetire(device, false);
+#endif
+        } else if (i2cBusy(device, NULL)) {
+            // Held by a transfer outside the queue, which restarts the queue when it completes
+            break;
+        } else {
+            // Failed to start on an idle bus, drop it rather than stall the queue
+            i2cQueueRetire(device, true);
+        }
+    }
+    i2cQueueUnlock(device);
+}
+
+// Called by the I2C driver from the interrupt that completed a transfer, queued or not
+void i2cTransferComplete(I2CDevice device, bool error)
+{
+    if (!i2cQueueValid(device)) {
+        return;
+    }
+
+    if (i2cQueue[device].started) {
+        i2cQueueRetire(device, error);
+    }
+    i2cQueueStart(device);
+}
+
+// Queue a transfer that completes from interrupts without blocking. Returns false if the queue is full.
+bool i2cQueueTransfer(I2CDevice device, const i2cTransfer_t *transfer)
+{
+    if (!i2cQueueValid(device)) {
+        return false;
+    }
+
+    i2cQueue_t *queue = &i2cQueue[device];
+    bool queued = false;
+
+    i2cQueueLock(device);
+    if (queue->count < I2C_QUEUE_LENGTH) {
+        queue->transfer[(queue->head + queue->count) % I2C_QUEUE_LENGTH] = *transfer;
+        queue->count++;
+        queued = true;
+    }
+    i2cQueueUnlock(device);
+
+    if (queued) {
+        i2cQueueStart(device);
+    }
+
+    return queued;
+}
+
+// True while a transfer queued for the address has not completed
+bool i2cQueueBusy(I2CDevice device, uint8_t address, bool *error)
+{
+    if (error) {
+        *error = false;
+    }
+
+    if (!i2cQueueValid(device)) {
+        return false;
+    }
+
+    i2cQueue_t *queue = &i2cQueue[device];
+    bool busy = false;
+
+    i2cQueueLock(device);
+    for (int i = 0; i < queue->count; i++) {
+        if (queue->transfer[(queue->head + i) % I2C_QUEUE_LENGTH].address == address) {
+            busy = true;
+        }
+    }
+    if (error) {
+        *error = queue->error;
+    }
+    i2cQueueUnlock(device);
+
+    return busy;
+}
+
+// Blocking transfers wait for the queue to drain first. Returns false if it didn't within the timeout.
+bool i2cQueueWait(I2CDevice device)
+{
+    if (!i2cQueueValid(device)) {
+        return true;
+    }
+
+    const timeUs_t startUs = micros();
+    while (i2cQueue[device].count) {
+        if (cmpTimeUs(micros(), startUs) > I2C_QUEUE_TIMEOUT_US) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool i2cBusWriteRegister(const busDevice_t *busdev, uint8_t reg, uint8_t data)
 {
-    return i2cWrite(busdev->busdev_u.i2c.device, busdev->busdev_u.i2c.address, reg, data);
+    const I2CDevice device = busdev->busdev_u.i2c.device;
+
+    const bool ack = i2cQueueWait(device) && i2cWrite(device, busdev->busdev_u.i2c.address, reg, data);
+    i2cQueueStart(device);
+    return ack;
 }
 
 bool i2cBusWriteRegisterStart(const busDevice_t *busdev, uint8_t reg, uint8_t data)
 {
-    // Need a static value, not on the stack
-    static uint8_t byte;
+    const i2cTransfer_t transfer = {
+        .address = busdev->busdev_u.i2c.address,
+        .reg = reg,
+        .length = 1,
+        .read = false,
+        .data = NULL,
+        .byte = data,
+    };
 
-    byte = data;
-
-    return i2cWriteBuffer(busdev->busdev_u.i2c.device, busdev->busdev_u.i2c.address, reg, sizeof (byte), &byte);
+    return i2cQueueTransfer(busdev->busdev_u.i2c.device, &transfer);
 }
 
 bool i2cBusReadRegisterBuffer(const busDevice_t *busdev, uint8_t reg, uint8_t *data, uint8_t length)
 {
-    return i2cRead(busdev->busdev_u.i2c.device, busdev->busdev_u.i2c.address, reg, length, data);
+    const I2CDevice device = busdev->busdev_u.i2c.device;
+
+    const bool ack = i2cQueueWait(device) && i2cRead(device, busdev->busdev_u.i2c.address, reg, length, data);
+    i2cQueueStart(device);
+    return ack;
 }
 
 uint8_t i2cBusReadRegister(const busDevice_t *busdev, uint8_t reg)
 {
-    uint8_t data;
-    i2cRead(busdev->busdev_u.i2c.device, busdev->busdev_u.i2c.address, reg, 1, &data);
+    uint8_t data = 0;
+    i2cBusReadRegisterBuffer(busdev, reg, &data, 1);
     return data;
 }
 
 bool i2cBusReadRegisterBufferStart(const busDevice_t *busdev, uint8_t reg, uint8_t *data, uint8_t length)
 {
-    return i2cReadBuffer(busdev->busdev_u.i2c.device, busdev->busdev_u.i2c.address, reg, length, data);
+    const i2cTransfer_t transfer = {
+        .address = busdev->busdev_u.i2c.address,
+        .reg = reg,
+        .length = length,
+        .read = true,
+        .data = data,
+    };
+
+    return i2cQueueTransfer(busdev->busdev_u.i2c.device, &transfer);
 }
 
+// True until the transfers started for this device have completed
 bool i2cBusBusy(const busDevice_t *busdev, bool *error)
 {
-    return i2cBusy(busdev->busdev_u.i2c.device, error);
+    return i2cQueueBusy(busdev->busdev_u.i2c.device, busdev->busdev_u.i2c.address, error);
 }
 
 void i2cBusDeviceRegister(const busDevice_t *busdev)
@@ -26,6 +26,8 @@
 
 #if defined(USE_I2C) && !defined(SOFT_I2C)
 
+#include "common/utils.h"
+
 #include "drivers/io.h"
 #include "drivers/io_impl.h"
 #include "drivers/nvic.h"
@@ -209,6 +211,27 @@ bool i2cReadBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, u
     return true;
 }
 
+static I2CDevice i2cDeviceByHandle(I2C_HandleTypeDef *hi2c)
+{
+    return (I2CDevice)(container_of(hi2c, i2cDevice_t, handle) - i2cDevice);
+}
+
+// Completion of the non-blocking transfers, which starts the next queued transfer
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    i2cTransferComplete(i2cDeviceByHandle(hi2c), false);
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    i2cTransferComplete(i2cDeviceByHandle(hi2c), false);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+    i2cTransferComplete(i2cDeviceByHandle(hi2c), true);
+}
+
 bool i2cBusy(I2CDevice device, bool *error)
 {
     I2C_HandleTypeDef *pHandle = &i2cDevice[device].handle;
@@ -311,6 +311,7 @@ static void i2c_er_handler(I2CDevice device) {
     }
     I2Cx->SR1 &= ~(I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_AF | I2C_SR1_OVR);     // reset all the error bits to clear the interrupt
     state->busy = 0;
+    i2cTransferComplete(device, state->error);
 }
 
 void i2c_ev_handler(I2CDevice device) {
@@ -425,6 +426,7 @@ void i2c_ev_handler(I2CDevice device) {
         if (final_stop)                                                 // If there is a final stop and no more jobs, bus is inactive, disable interrupts to prevent BTF
             I2C_ITConfig(I2Cx, I2C_IT_EVT | I2C_IT_ERR, DISABLE);       // Disable EVT and ERR interrupts while bus inactive
         state->busy = 0;
+        i2cTransferComplete(device, state->error);                     // start the next queued job
     }
 }
 
@@ -26,17 +26,122 @@
 
 #ifdef USE_SPI
 
+#include "build/atomic.h"
+
+#include "common/maths.h"
+
 #include "drivers/bus.h"
 #include "drivers/bus_spi.h"
 #include "drivers/bus_spi_impl.h"
 #include "drivers/exti.h"
 #include "drivers/io.h"
+#include "drivers/nvic.h"
 #include "drivers/rcc.h"
+#include "drivers/system.h"
+#include "drivers/time.h"
 
 static uint8_t spiRegisteredDeviceCount = 0;
 
 spiDevice_t spiDevice[SPIDEV_COUNT];
 
+#ifdef USE_SPI_DMA
+static bool spiSequenceQueued(const spiDevice_t *spi)
+{
+    for (int priority = 0; priority < SPI_PRIORITY_COUNT; priority++) {
+        if (spi->sequence[priority].queued) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Start the highest priority queued sequence, unless the bus is in use
+void spiSequenceStartNext(spiDevice_t *spi)
+{
+    spiSequence_t *next = NULL;
+
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        if (!spi->claimCount && !spi->activeSequence) {
+            for (int priority = SPI_PRIORITY_COUNT - 1; priority >= 0 && !next; priority--) {
+                if (spi->sequence[priority].queued) {
+                    next = &spi->sequence[priority];
+                }
+            }
+            spi->activeSequence = next;
+        }
+    }
+
+    if (!next) {
+        return;
+    }
+
+    spi->sequenceStartCycles = getCycleCounter();
+    if (!next->started) {
+        next->started = true;
+        if (next == &spi->sequence[SPI_PRIORITY_HIGH]) {
+            spi->maxWaitCycles = MAX(spi->maxWaitCycles, spi->sequenceStartCycles - next->queuedAtCycles);
+        }
+    }
+
+    spiSequenceStart(spi);
+}
+
+// A higher priority sequence is waiting for the active one to give up the bus
+bool spiSequencePreempted(const spiDevice_t *spi)
+{
+    for (const spiSequence_t *sequence = spi->activeSequence + 1; sequence < &spi->sequence[SPI_PRIORITY_COUNT]; sequence++) {
+        if (sequence->queued) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The active sequence has completed or been suspended with CS negated, and releases the bus
+void spiSequenceEnd(spiDevice_t *spi)
+{
+    spi->sequenceBusyCycles += getCycleCounter() - spi->sequenceStartCycles;
+    spi->activeSequence = NULL;
+}
+#endif
+
+// Polled transfers claim the bus, so that a DMA sequence requested from an interrupt is deferred until they are done
+static void spiBusClaim(spiDevice_t *spi)
+{
+    spi->claimCount++;
+#ifdef USE_SPI_DMA
+    while (spi->activeSequence);
+#endif
+    if (spi->claimCount == 1) {
+        spi->claimStartCycles = getCycleCounter();
+    }
+}
+
+static void spiBusRelease(spiDevice_t *spi)
+{
+    if (spi->claimCount == 1) {
+        spi->claimBusyCycles += getCycleCounter() - spi->claimStartCycles;
+    }
+    spi->claimCount--;
+#ifdef USE_SPI_DMA
+    if (spi->claimCount == 0) {
+        spiSequenceStartNext(spi);
+    }
+#endif
+}
+
+static void spiBusSelect(const busDevice_t *bus)
+{
+    spiBusClaim(&spiDevice[spiDeviceByInstance(bus->busdev_u.spi.instance)]);
+    IOLo(bus->busdev_u.spi.csnPin);
+}
+
+static void spiBusDeselect(const busDevice_t *bus)
+{
+    IOHi(bus->busdev_u.spi.csnPin);
+    spiBusRelease(&spiDevice[spiDeviceByInstance(bus->busdev_u.spi.instance)]);
+}
+
 SPIDevice spiDeviceByInstance(SPI_TypeDef *instance)
 {
 #ifdef USE_SPI_DEVICE_1
@@ -140,9 +245,9 @@ uint32_t spiTimeoutUserCallback(SPI_TypeDef *instance)
 
 bool spiBusTransfer(const busDevice_t *bus, const uint8_t *txData, uint8_t *rxData, int length)
 {
-    IOLo(bus->busdev_u.spi.csnPin);
+    spiBusSelect(bus);
     spiTransfer(bus->busdev_u.spi.instance, txData, rxData, length);
-    IOHi(bus->busdev_u.spi.csnPin);
+    spiBusDeselect(bus);
     return true;
 }
 
@@ -175,9 +280,9 @@ uint8_t spiBusTransferByte(const busDevice_t *bus, uint8_t data)
 
 void spiBusWriteByte(const busDevice_t *bus, uint8_t data)
 {
-    IOLo(bus->busdev_u.spi.csnPin);
+    spiBusSelect(bus);
     spiBusTransferByte(bus, data);
-    IOHi(bus->busdev_u.spi.csnPin);
+    spiBusDeselect(bus);
 }
 
 bool spiBusRawTransfer(const busDevice_t *bus, const uint8_t *txData, uint8_t *rxData, int len)
@@ -187,20 +292,20 @@ bool spiBusRawTransfer(const busDevice_t *bus, const uint8_t *txData, uint8_t *r
 
 bool spiBusWriteRegister(const busDevice_t *bus, uint8_t reg, uint8_t data)
 {
-    IOLo(bus->busdev_u.spi.csnPin);
+    spiBusSelect(bus);
     spiTransferByte(bus->busdev_u.spi.instance, reg);
     spiTransferByte(bus->busdev_u.spi.instance, data);
-    IOHi(bus->busdev_u.spi.csnPin);
+    spiBusDeselect(bus);
 
     return true;
 }
 
 bool spiBusRawReadRegisterBuffer(const busDevice_t *bus, uint8_t reg, uint8_t *data, uint8_t length)
 {
-    IOLo(bus->busdev_u.spi.csnPin);
+    spiBusSelect(bus);
     spiTransferByte(bus->busdev_u.spi.instance, reg);
     spiTransfer(bus->busdev_u.spi.instance, NULL, data, length);
-    IOHi(bus->busdev_u.spi.csnPin);
+    spiBusDeselect(bus);
 
     return true;
 }
@@ -212,19 +317,19 @@ bool spiBusReadRegisterBuffer(const busDevice_t *bus, uint8_t reg, uint8_t *data
 
 void spiBusWriteRegisterBuffer(const busDevice_t *bus, uint8_t reg, const uint8_t *data, uint8_t length)
 {
-    IOLo(bus->busdev_u.spi.csnPin);
+    spiBusSelect(bus);
     spiTransferByte(bus->busdev_u.spi.instance, reg);
     spiTransfer(bus->busdev_u.spi.instance, data, NULL, length);
-    IOHi(bus->busdev_u.spi.csnPin);
+    spiBusDeselect(bus);
 }
 
 uint8_t spiBusRawReadRegister(const busDevice_t *bus, uint8_t reg)
 {
     uint8_t data;
-    IOLo(bus->busdev_u.spi.csnPin);
+    spiBusSelect(bus);
     spiTransferByte(bus->busdev_u.spi.instance, reg);
     spiTransfer(bus->busdev_u.spi.instance, NULL, &data, 1);
-    IOHi(bus->busdev_u.spi.csnPin);
+    spiBusDeselect(bus);
 
     return data;
 }
@@ -271,12 +376,12 @@ void spiBusSetDivisor(busDevice_t *bus, uint16_t divisor)
 void spiBusTransactionBegin(const busDevice_t *bus)
 {
     spiBusTransactionSetup(bus);
-    IOLo(bus->busdev_u.spi.csnPin);
+    spiBusSelect(bus);
 }
 
 void spiBusTransactionEnd(const busDevice_t *bus)
 {
-    IOHi(bus->busdev_u.spi.csnPin);
+    spiBusDeselect(bus);
 }
 
 bool spiBusTransactionTransfer(const busDevice_t *bus, const uint8_t *txData, uint8_t *rxData, int length)
@@ -302,8 +407,138 @@ bool spiBusTransactionReadRegisterBuffer(const busDevice_t *bus, uint8_t reg, ui
     spiBusTransactionSetup(bus);
     return spiBusReadRegisterBuffer(bus, reg, data, length);
 }
+
+// Between the transfers of a long transaction, negate CS and hand the bus to any queued sequence
+void spiBusTransactionYield(const busDevice_t *bus)
+{
+#ifdef USE_SPI_DMA
+    if (spiSequenceQueued(&spiDevice[spiDeviceByInstance(bus->busdev_u.spi.instance)])) {
+        spiBusTransactionEnd(bus);
+        spiBusTransactionBegin(bus);
+    }
+#else
+    UNUSED(bus);
+#endif
+}
 #endif // USE_SPI_TRANSACTION
 
+// Use DMA for the sequences on the bus of this device, if SPI_TX and SPI_RX DMA are configured for it
+bool spiBusEnableSequenceDMA(const busDevice_t *bus)
+{
+#ifdef USE_SPI_DMA
+    return spiInitDeviceDMA(spiDeviceByInstance(bus->busdev_u.spi.instance));
+#else
+    UNUSED(bus);
+    return false;
+#endif
+}
+
+// Queue a sequence of transfers, calling back once it has completed. Without DMA the transfers are
+// polled and have completed on return. Returns false if a sequence of this priority is already queued on the bus.
+bool spiBusSequence(const busDevice_t *bus, spiPriority_e priority, const busSegment_t *segments, spiSequenceCallbackFn *callback, uint32_t arg)
+{
+    spiDevice_t *spi = &spiDevice[spiDeviceByInstance(bus->busdev_u.spi.instance)];
+
+#ifdef USE_SPI_DMA
+    if (spi->useDma) {
+        spiSequence_t *sequence = &spi->sequence[priority];
+        if (sequence->queued) {
+            return false;
+        }
+
+        sequence->bus = bus;
+        sequence->segment = segments;
+        sequence->callback = callback;
+        sequence->callbackArg = arg;
+        sequence->queuedAtCycles = getCycleCounter();
+        sequence->started = false;
+        sequence->queued = true;
+
+        spiSequenceStartNext(spi);
+
+        return true;
+    }
+#else
+    UNUSED(priority);
+#endif
+
+    SPI_TypeDef *instance = bus->busdev_u.spi.instance;
+
+    spiBusClaim(spi);
+    IOLo(bus->busdev_u.spi.csnPin);
+    for (const busSegment_t *segment = segments; segment->len; segment++) {
+        spiTransfer(instance, segment->txData, segment->rxData, segment->len);
+        if (segment->negateCS) {
+            IOHi(bus->busdev_u.spi.csnPin);
+            if (segment[1].len) {
+                IOLo(bus->busdev_u.spi.csnPin);
+            }
+        }
+    }
+    IOHi(bus->busdev_u.spi.csnPin);
+    spiBusRelease(spi);
+
+    if (callback) {
+        callback(arg);
+    }
+
+    return true;
+}
+
+// True while a sequence queued for this device has not completed
+bool spiBusIsSequenceBusy(const busDevice_t *bus)
+{
+#ifdef USE_SPI_DMA
+    const spiDevice_t *spi = &spiDevice[spiDeviceByInstance(bus->busdev_u.spi.instance)];
+    for (int priority = 0; priority < SPI_PRIORITY_COUNT; priority++) {
+        if (spi->sequence[priority].queued && spi->sequence[priority].bus == bus) {
+            return true;
+        }
+    }
+#else
+    UNUSED(bus);
+#endif
+    return false;
+}
+
+void spiBusWaitSequence(const busDevice_t *bus)
+{
+    while (spiBusIsSequenceBusy(bus));
+}
+
+// Bus statistics since the previous call. Returns false if the bus is not in use.
+bool spiGetBusStats(SPIDevice device, spiBusStats_t *stats)
+{
+    if (device == SPIINVALID || device >= SPIDEV_COUNT || !spiDevice[device].dev) {
+        return false;
+    }
+
+    spiDevice_t *spi = &spiDevice[device];
+    const uint32_t nowUs = micros();
+    const uint32_t elapsedUs = nowUs - spi->statsStartUs;
+
+    uint64_t busyCycles = spi->claimBusyCycles;
+    spi->claimBusyCycles = 0;
+    stats->maxWaitUs = 0;
+    stats->preemptCount = 0;
+#ifdef USE_SPI_DMA
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        busyCycles += spi->sequenceBusyCycles;
+        spi->sequenceBusyCycles = 0;
+        stats->maxWaitUs = MIN(clockCyclesToMicros(spi->maxWaitCycles), (uint32_t)UINT16_MAX);
+        spi->maxWaitCycles = 0;
+        stats->preemptCount = spi->preemptCount;
+        spi->preemptCount = 0;
+    }
+#endif
+
+    const uint64_t elapsedCycles = (uint64_t)clockMicrosToCycles(1) * elapsedUs;
+    stats->utilisationPercent = elapsedCycles ? MIN(busyCycles * 100 / elapsedCycles, (uint64_t)100) : 0;
+    spi->statsStartUs = nowUs;
+
+    return true;
+}
+
 void spiBusDeviceRegister(const busDevice_t *bus)
 {
     UNUSED(bus);
@@ -84,6 +84,22 @@ typedef enum SPIDevice {
 
 #endif
 
+typedef void spiSequenceCallbackFn(uint32_t arg);
+
+// A queued sequence of a higher priority is started first, and takes over the bus from a lower priority
+// sequence at the next segment that negates CS
+typedef enum {
+    SPI_PRIORITY_LOW = 0,
+    SPI_PRIORITY_HIGH,      // Gyro reads
+    SPI_PRIORITY_COUNT
+} spiPriority_e;
+
+typedef struct spiBusStats_s {
+    uint8_t utilisationPercent;     // Time the bus was held by a transfer or sequence
+    uint16_t maxWaitUs;             // Longest a high priority sequence waited for the bus
+    uint16_t preemptCount;          // Sequences suspended to let a higher priority one start
+} spiBusStats_t;
+
 // Macros to convert between CLI bus number and SPIDevice.
 #define SPI_CFG_TO_DEV(x)   ((x) - 1)
 #define SPI_DEV_TO_CFG(x)   ((x) + 1)
@@ -136,6 +152,13 @@ bool spiBusTransactionWriteRegister(const busDevice_t *bus, uint8_t reg, uint8_t
 uint8_t spiBusTransactionReadRegister(const busDevice_t *bus, uint8_t reg);
 bool spiBusTransactionReadRegisterBuffer(const busDevice_t *bus, uint8_t reg, uint8_t *data, uint8_t length);
 bool spiBusTransactionTransfer(const busDevice_t *bus, const uint8_t *txData, uint8_t *rxData, int length);
+void spiBusTransactionYield(const busDevice_t *bus);
+
+bool spiBusEnableSequenceDMA(const busDevice_t *bus);
+bool spiBusSequence(const busDevice_t *bus, spiPriority_e priority, const busSegment_t *segments, spiSequenceCallbackFn *callback, uint32_t arg);
+bool spiBusIsSequenceBusy(const busDevice_t *bus);
+void spiBusWaitSequence(const busDevice_t *bus);
+bool spiGetBusStats(SPIDevice device, spiBusStats_t *stats);
 
 //
 // Config
@@ -20,6 +20,10 @@
 
 #pragma once
 
+#ifdef USE_SPI_DMA
+#include "drivers/dma.h"
+#endif
+
 #if defined(STM32F1) || defined(STM32F3) || defined(STM32F4) || defined(STM32G4)
 #define MAX_SPI_PIN_SEL 2
 #elif defined(STM32F7)
@@ -54,6 +58,18 @@ typedef struct spiHardware_s {
 
 extern const spiHardware_t spiHardware[];
 
+#ifdef USE_SPI_DMA
+typedef struct spiSequence_s {
+    const busDevice_t *bus;
+    const busSegment_t *segment;    // Next segment to transfer
+    spiSequenceCallbackFn *callback;
+    uint32_t callbackArg;
+    uint32_t queuedAtCycles;
+    bool started;
+    volatile bool queued;           // Requested and not yet completed
+} spiSequence_t;
+#endif
+
 typedef struct SPIDevice_s {
     SPI_TypeDef *dev;
     ioTag_t sck;
@@ -79,9 +95,33 @@ typedef struct SPIDevice_s {
 #ifdef USE_SPI_TRANSACTION
     uint16_t cr1SoftCopy;   // Copy of active CR1 value for this SPI instance
 #endif
+#ifdef USE_SPI_DMA
+    dmaChannelDescriptor_t *txDma;
+    dmaChannelDescriptor_t *rxDma;
+    DMA_InitTypeDef txDmaInit;
+    DMA_InitTypeDef rxDmaInit;
+    bool useDma;
+    spiSequence_t sequence[SPI_PRIORITY_COUNT];
+    spiSequence_t * volatile activeSequence;    // Sequence holding the bus
+    uint32_t sequenceStartCycles;
+    uint64_t sequenceBusyCycles;
+    uint32_t maxWaitCycles;
+    uint16_t preemptCount;
+#endif
+    volatile uint8_t claimCount;    // Polled transfers in progress
+    uint32_t claimStartCycles;
+    uint64_t claimBusyCycles;
+    uint32_t statsStartUs;
 } spiDevice_t;
 
 extern spiDevice_t spiDevice[SPIDEV_COUNT];
 
 void spiInitDevice(SPIDevice device, bool leadingEdge);
+#ifdef USE_SPI_DMA
+bool spiInitDeviceDMA(SPIDevice device);
+void spiSequenceStart(spiDevice_t *spi);
+void spiSequenceStartNext(spiDevice_t *spi);
+bool spiSequencePreempted(const spiDevice_t *spi);
+void spiSequenceEnd(spiDevice_t *spi);
+#endif
 uint32_t spiTimeoutUserCallback(SPI_TypeDef *instance);
@@ -30,10 +30,14 @@
 #include "drivers/bus.h"
 #include "drivers/bus_spi.h"
 #include "drivers/bus_spi_impl.h"
+#include "drivers/dma_reqmap.h"
 #include "drivers/exti.h"
 #include "drivers/io.h"
+#include "drivers/nvic.h"
 #include "drivers/rcc.h"
 
+#include "pg/bus_spi.h"
+
 static SPI_InitTypeDef defaultInit = {
     .SPI_Mode = SPI_Mode_Master,
     .SPI_Direction = SPI_Direction_2Lines_FullDuplex,
@@ -260,4 +264,156 @@ void spiBusTransactionSetup(const busDevice_t *bus)
     }
 }
 #endif // USE_SPI_TRANSACTION
+
+#ifdef USE_SPI_DMA
+// Source and sink for segments without transmit or receive data
+static const uint8_t spiDmaDummyTx = 0xff;
+static uint8_t spiDmaDummyRx;
+
+static void spiSegmentStart(spiDevice_t *spi)
+{
+    const busSegment_t *segment = spi->activeSequence->segment;
+
+    spi->rxDmaInit.DMA_Memory0BaseAddr = segment->rxData ? (uint32_t)segment->rxData : (uint32_t)&spiDmaDummyRx;
+    spi->rxDmaInit.DMA_MemoryInc = segment->rxData ? DMA_MemoryInc_Enable : DMA_MemoryInc_Disable;
+    spi->rxDmaInit.DMA_BufferSize = segment->len;
+    xDMA_Init(spi->rxDma->ref, &spi->rxDmaInit);
+
+    spi->txDmaInit.DMA_Memory0BaseAddr = segment->txData ? (uint32_t)segment->txData : (uint32_t)&spiDmaDummyTx;
+    spi->txDmaInit.DMA_MemoryInc = segment->txData ? DMA_MemoryInc_Enable : DMA_MemoryInc_Disable;
+    spi->txDmaInit.DMA_BufferSize = segment->len;
+    xDMA_Init(spi->txDma->ref, &spi->txDmaInit);
+
+    // The event flags of a stream must be clear before it can be enabled
+    DMA_CLEAR_FLAG(spi->rxDma, DMA_IT_TCIF | DMA_IT_HTIF | DMA_IT_TEIF | DMA_IT_DMEIF | DMA_IT_FEIF);
+    DMA_CLEAR_FLAG(spi->txDma, DMA_IT_TCIF | DMA_IT_HTIF | DMA_IT_TEIF | DMA_IT_DMEIF | DMA_IT_FEIF);
+
+    xDMA_ITConfig(spi->rxDma->ref, DMA_IT_TC, ENABLE);
+
+    DISCARD(spi->dev->DR);
+
+    xDMA_Cmd(spi->rxDma->ref, ENABLE);
+    xDMA_Cmd(spi->txDma->ref, ENABLE);
+
+    SPI_I2S_DMACmd(spi->dev, SPI_I2S_DMAReq_Rx | SPI_I2S_DMAReq_Tx, ENABLE);
+}
+
+// Start, or resume after it was preempted, the active sequence
+void spiSequenceStart(spiDevice_t *spi)
+{
+    const busDevice_t *bus = spi->activeSequence->bus;
+
+#ifdef USE_SPI_TRANSACTION
+    spiBusTransactionSetup(bus);
+#endif
+    IOLo(bus->busdev_u.spi.csnPin);
+
+    spiSegmentStart(spi);
+}
+
+// Receive completes after transmit, so the end of each segment is taken from the receive stream
+static void spiRxDmaIrqHandler(dmaChannelDescriptor_t *descriptor)
+{
+    spiDevice_t *spi = &spiDevice[descriptor->userParam];
+
+    if (!DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF)) {
+        DMA_CLEAR_FLAG(descriptor, DMA_IT_HTIF | DMA_IT_TEIF | DMA_IT_DMEIF | DMA_IT_FEIF);
+        return;
+    }
+
+    SPI_I2S_DMACmd(spi->dev, SPI_I2S_DMAReq_Rx | SPI_I2S_DMAReq_Tx, DISABLE);
+    xDMA_Cmd(spi->rxDma->ref, DISABLE);
+    xDMA_Cmd(spi->txDma->ref, DISABLE);
+    DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF | DMA_IT_HTIF);
+
+    spiSequence_t *sequence = spi->activeSequence;
+    const IO_t csnPin = sequence->bus->busdev_u.spi.csnPin;
+    const busSegment_t *segment = sequence->segment++;
+
+    if (segment->negateCS) {
+        IOHi(csnPin);
+    }
+
+    if (sequence->segment->len) {
+        if (segment->negateCS) {
+            if (spiSequencePreempted(spi)) {
+                // Resumed from the next segment once the higher priority sequences are done
+                spi->preemptCount++;
+                spiSequenceEnd(spi);
+                spiSequenceStartNext(spi);
+                return;
+            }
+            IOLo(csnPin);
+        }
+        spiSegmentStart(spi);
+        return;
+    }
+
+    IOHi(csnPin);
+    spiSequenceEnd(spi);
+    sequence->queued = false;
+
+    if (sequence->callback) {
+        sequence->callback(sequence->callbackArg);
+    }
+
+    spiSequenceStartNext(spi);
+}
+
+static void spiDmaInitStruct(DMA_InitTypeDef *init, const spiDevice_t *spi, const dmaChannelSpec_t *dmaChannelSpec, uint32_t dir, uint32_t priority)
+{
+    DMA_StructInit(init);
+    init->DMA_Channel = dmaChannelSpec->channel;
+    init->DMA_PeripheralBaseAddr = (uint32_t)&spi->dev->DR;
+    init->DMA_DIR = dir;
+    init->DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    init->DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    init->DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    init->DMA_Mode = DMA_Mode_Normal;
+    init->DMA_Priority = priority;
+    init->DMA_FIFOMode = DMA_FIFOMode_Disable;
+}
+
+bool spiInitDeviceDMA(SPIDevice device)
+{
+    if (device == SPIINVALID || device >= SPIDEV_COUNT) {
+        return false;
+    }
+
+    spiDevice_t *spi = &spiDevice[device];
+
+    if (spi->useDma) {
+        return true;
+    }
+
+    const dmaChannelSpec_t *txDmaChannelSpec = dmaGetChannelSpecByPeripheral(DMA_PERIPH_SPI_TX, device, spiPinConfig(device)->txDmaopt);
+    const dmaChannelSpec_t *rxDmaChannelSpec = dmaGetChannelSpecByPeripheral(DMA_PERIPH_SPI_RX, device, spiPinConfig(device)->rxDmaopt);
+
+    if (!spi->dev || !txDmaChannelSpec || !rxDmaChannelSpec) {
+        return false;
+    }
+
+    const dmaIdentifier_e txDmaIdentifier = dmaGetIdentifier(txDmaChannelSpec->ref);
+    const dmaIdentifier_e rxDmaIdentifier = dmaGetIdentifier(rxDmaChannelSpec->ref);
+
+    if (dmaGetOwner(txDmaIdentifier)->owner != OWNER_FREE || dmaGetOwner(rxDmaIdentifier)->owner != OWNER_FREE) {
+        return false;
+    }
+
+    dmaInit(txDmaIdentifier, OWNER_SPI_TX, RESOURCE_INDEX(device));
+    dmaInit(rxDmaIdentifier, OWNER_SPI_RX, RESOURCE_INDEX(device));
+
+    spi->txDma = dmaGetDescriptorByIdentifier(txDmaIdentifier);
+    spi->rxDma = dmaGetDescriptorByIdentifier(rxDmaIdentifier);
+
+    spiDmaInitStruct(&spi->txDmaInit, spi, txDmaChannelSpec, DMA_DIR_MemoryToPeripheral, DMA_Priority_High);
+    spiDmaInitStruct(&spi->rxDmaInit, spi, rxDmaChannelSpec, DMA_DIR_PeripheralToMemory, DMA_Priority_VeryHigh);
+
+    dmaSetHandler(rxDmaIdentifier, spiRxDmaIrqHandler, NVIC_PRIO_SPI_DMA, device);
+
+    spi->useDma = true;
+
+    return true;
+}
+#endif // USE_SPI_DMA
 #endif
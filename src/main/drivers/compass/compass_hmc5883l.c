@@ -203,23 +203,33 @@ static void hmc5883SpiInit(busDevice_t *busdev)
 }
 #endif
 
+// Returns the data of the read started by the previous call, and starts the next one
 static bool hmc5883lRead(magDev_t *mag, int16_t *magData)
 {
-    uint8_t buf[6];
+    static uint8_t buf[6];
+    static bool pendingRead = false;
 
     busDevice_t *busdev = &mag->busdev;
-
-    bool ack = busReadRegisterBuffer(busdev, HMC58X3_REG_DATA, buf, 6);
-
-    if (!ack) {
-        return false;
+    bool dataReady = false;
+
+    if (pendingRead) {
+        bool error;
+        if (busBusy(busdev, &error)) {
+            return false;
+        }
+        pendingRead = false;
+
+        if (!error) {
+            magData[X] = (int16_t)(buf[0] << 8 | buf[1]);
+            magData[Z] = (int16_t)(buf[2] << 8 | buf[3]);
+            magData[Y] = (int16_t)(buf[4] << 8 | buf[5]);
+            dataReady = true;
+        }
     }
 
-    magData[X] = (int16_t)(buf[0] << 8 | buf[1]);
-    magData[Z] = (int16_t)(buf[2] << 8 | buf[3]);
-    magData[Y] = (int16_t)(buf[4] << 8 | buf[5]);
+    pendingRead = busReadRegisterBufferStart(busdev, HMC58X3_REG_DATA, buf, 6);
 
-    return true;
+    return dataReady;
 }
 
 static bool hmc5883lInit(magDev_t *mag)
@@ -101,23 +101,33 @@
 #define LIS3MDL_FAST_READ           0x80  // Default 0
 #define LIS3MDL_BDU                 0x40  // Default 0
 
+// Returns the data of the read started by the previous call, and starts the next one
 static bool lis3mdlRead(magDev_t * mag, int16_t *magData)
 {
-    uint8_t buf[6];
+    static uint8_t buf[6];
+    static bool pendingRead = false;
 
     busDevice_t *busdev = &mag->busdev;
-
-    bool ack = busReadRegisterBuffer(busdev, LIS3MDL_REG_OUT_X_L, buf, 6);
-
-    if (!ack) {
-        return false;
+    bool dataReady = false;
+
+    if (pendingRead) {
+        bool error;
+        if (busBusy(busdev, &error)) {
+            return false;
+        }
+        pendingRead = false;
+
+        if (!error) {
+            magData[X] = (int16_t)(buf[1] << 8 | buf[0]) / 4;
+            magData[Y] = (int16_t)(buf[3] << 8 | buf[2]) / 4;
+            magData[Z] = (int16_t)(buf[5] << 8 | buf[4]) / 4;
+            dataReady = true;
+        }
     }
 
-    magData[X] = (int16_t)(buf[1] << 8 | buf[0]) / 4;
-    magData[Y] = (int16_t)(buf[3] << 8 | buf[2]) / 4;
-    magData[Z] = (int16_t)(buf[5] << 8 | buf[4]) / 4;
+    pendingRead = busReadRegisterBufferStart(busdev, LIS3MDL_REG_OUT_X_L, buf, 6);
 
-    return true;
+    return dataReady;
 }
 
 static bool lis3mdlInit(magDev_t *mag)
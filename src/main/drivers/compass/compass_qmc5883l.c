@@ -91,34 +91,36 @@ static bool qmc5883lInit(magDev_t *magDev)
     return true;
 }
 
+// Returns the data of the reads started by the previous call, and starts the next pair.
+// The status and data reads are queued back to back so neither waits on the bus.
 static bool qmc5883lRead(magDev_t *magDev, int16_t *magData)
 {
-    uint8_t status;
-    uint8_t buf[6];
-
-    // set magData to zero for case of failed read
-    magData[X] = 0;
-    magData[Y] = 0;
-    magData[Z] = 0;
+    static uint8_t status;
+    static uint8_t buf[6];
+    static bool pendingRead = false;
 
     busDevice_t *busdev = &magDev->busdev;
+    bool dataReady = false;
 
-    bool ack = busReadRegisterBuffer(busdev, QMC5883L_REG_STATUS, &status, 1);
-
-    if (!ack || (status & 0x04) == 0) {
-        return false;
-    }
+    if (pendingRead) {
+        bool error;
+        if (busBusy(busdev, &error)) {
+            return false;
+        }
+        pendingRead = false;
 
-    ack = busReadRegisterBuffer(busdev, QMC5883L_REG_DATA_OUTPUT_X, buf, 6);
-    if (!ack) {
-        return false;
+        if (!error && (status & 0x04)) {
+            magData[X] = (int16_t)(buf[1] << 8 | buf[0]);
+            magData[Y] = (int16_t)(buf[3] << 8 | buf[2]);
+            magData[Z] = (int16_t)(buf[5] << 8 | buf[4]);
+            dataReady = true;
+        }
     }
 
-    magData[X] = (int16_t)(buf[1] << 8 | buf[0]);
-    magData[Y] = (int16_t)(buf[3] << 8 | buf[2]);
-    magData[Z] = (int16_t)(buf[5] << 8 | buf[4]);
+    pendingRead = busReadRegisterBufferStart(busdev, QMC5883L_REG_STATUS, &status, 1)
+        && busReadRegisterBufferStart(busdev, QMC5883L_REG_DATA_OUTPUT_X, buf, 6);
 
-    return true;
+    return dataReady;
 }
 
 bool qmc5883lDetect(magDev_t *magDev)
@@ -20,12 +20,16 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
 #include "common/utils.h"
 
+#include "drivers/bus.h"
 #include "drivers/bus_i2c.h"
+#include "drivers/bus_i2c_busdev.h"
+#include "drivers/time.h"
 
 #include "display_ug2864hsweg01.h"
 
@@ -34,8 +38,23 @@
 #define INVERSE_CHAR_FORMAT 0x7f // 0b01111111
 #define NORMAL_CHAR_FORMAT  0x00 // 0b00000000
 
+#define SCREEN_PAGE_COUNT (SCREEN_HEIGHT / 8)
+#define FLUSH_STOP_TIMEOUT_US 20000
+
 unsigned char CHAR_FORMAT = NORMAL_CHAR_FORMAT;
 
+// The characters are rendered into the frame buffer, and the pages that changed are sent by i2c_OLED_flush()
+// from the interrupts of the I2C queue. Each page is sent after setting its address with a short command stream.
+static uint8_t frameBuffer[SCREEN_PAGE_COUNT][SCREEN_WIDTH];
+static volatile uint8_t dirtyPages = 0;
+static volatile bool flushInProgress = false;
+static volatile bool flushStop = false;
+static uint8_t cursorPage = 0;
+static uint8_t cursorColumn = 0;
+
+static const busDevice_t *flushBus;
+static uint8_t flushCommands[6];
+
 static const uint8_t multiWiiFont[][5] = { // Refer to "Times New Roman" Font Database... 5 x 7 font
         { 0x00, 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x4F, 0x00, 0x00 }, //   (  1)  ! - 0x0021 Exclamation Mark
                 { 0x00, 0x07, 0x00, 0x07, 0x00 }, //   (  2)  " - 0x0022 Quotation Mark
@@ -175,7 +194,8 @@ static const uint8_t multiWiiFont[][5] = { // Refer to "Times New Roman" Font Da
 
 static bool i2c_OLED_send_cmd(busDevice_t *bus, uint8_t command)
 {
-    return i2cWrite(bus->busdev_u.i2c.device, bus->busdev_u.i2c.address, 0x80, command);
+    // Waits for a flush in progress to complete
+    return i2cBusWriteRegister(bus, 0x80, command);
 }
 
 static bool i2c_OLED_send_cmdarray(busDevice_t *bus, const uint8_t *commands, size_t len)
@@ -189,27 +209,131 @@ static bool i2c_OLED_send_cmdarray(busDevice_t *bus, const uint8_t *commands, si
     return true;
 }
 
-static bool i2c_OLED_send_byte(busDevice_t *bus, uint8_t val)
+static void i2c_OLED_put_byte(uint8_t val)
 {
-    return i2cWrite(bus->busdev_u.i2c.device, bus->busdev_u.i2c.address, 0x40, val);
+    uint8_t *column = &frameBuffer[cursorPage][cursorColumn];
+    if (*column != val) {
+        *column = val;
+        dirtyPages |= 1 << cursorPage;
+    }
+
+    // Wrap like the horizontal addressing mode of the display does
+    if (++cursorColumn == SCREEN_WIDTH) {
+        cursorColumn = 0;
+        cursorPage = (cursorPage + 1) % SCREEN_PAGE_COUNT;
+    }
 }
 
 void i2c_OLED_clear_display_quick(busDevice_t *bus)
 {
-    static const uint8_t i2c_OLED_cmd_clear_display_quick[] = {
-        0xb0, // set page address to 0
-        0x40, // Display start line register to 0
-        0,    // Set low col address to 0
-        0x10, // Set high col address to 0
+    UNUSED(bus);
+
+    for (int page = 0; page < SCREEN_PAGE_COUNT; page++) {
+        for (int column = 0; column < SCREEN_WIDTH; column++) {
+            if (frameBuffer[page][column]) {
+                memset(frameBuffer[page], 0, SCREEN_WIDTH);
+                dirtyPages |= 1 << page;
+                break;
+            }
+        }
+    }
+
+    cursorPage = 0;
+    cursorColumn = 0;
+}
+
+static bool i2c_OLED_send_page(uint8_t page);
+
+static void i2c_OLED_page_sent(uint32_t page, bool error)
+{
+    if (error || flushStop) {
+        // Sent again by the next flush rather than from the interrupt, in case the display is gone
+        dirtyPages |= 1 << page;
+        flushInProgress = false;
+        return;
+    }
+
+    for (int next = 1; next <= SCREEN_PAGE_COUNT; next++) {
+        const uint8_t nextPage = (page + next) % SCREEN_PAGE_COUNT;
+        if (dirtyPages & (1 << nextPage)) {
+            if (!i2c_OLED_send_page(nextPage)) {
+                flushInProgress = false;
+            }
+            return;
+        }
+    }
+
+    flushInProgress = false;
+}
+
+static bool i2c_OLED_send_page(uint8_t page)
+{
+    const I2CDevice device = flushBus->busdev_u.i2c.device;
+
+    flushCommands[0] = 0x21;                // Set column address range
+    flushCommands[1] = 0;
+    flushCommands[2] = SCREEN_WIDTH - 1;
+    flushCommands[3] = 0x22;                // Set page address range
+    flushCommands[4] = page;
+    flushCommands[5] = SCREEN_PAGE_COUNT - 1;
+
+    const i2cTransfer_t address = {
+        .address = flushBus->busdev_u.i2c.address,
+        .reg = 0x00,                        // Command stream
+        .length = sizeof(flushCommands),
+        .read = false,
+        .data = flushCommands,
+    };
+    const i2cTransfer_t data = {
+        .address = flushBus->busdev_u.i2c.address,
+        .reg = 0x40,                        // Data stream
+        .length = SCREEN_WIDTH,
+        .read = false,
+        .data = frameBuffer[page],
+        .callback = i2c_OLED_page_sent,
+        .callbackArg = page,
     };
 
-    i2c_OLED_send_cmdarray(bus, i2c_OLED_cmd_clear_display_quick, ARRAYLEN(i2c_OLED_cmd_clear_display_quick));
+    // The page is marked clean before it is sent, so a change made meanwhile sends it again
+    dirtyPages &= ~(1 << page);
+    if (!i2cQueueTransfer(device, &address)) {
+        dirtyPages |= 1 << page;
+        return false;
+    }
+    if (!i2cQueueTransfer(device, &data)) {
+        dirtyPages |= 1 << page;
+        return false;
+    }
+
+    return true;
+}
+
+// Start sending the pages changed since the last flush, returns at once
+void i2c_OLED_flush(busDevice_t *bus)
+{
+    if (flushInProgress || !dirtyPages) {
+        return;
+    }
 
-    for (uint16_t i = 0; i < 1024; i++) {      // fill the display's RAM with graphic... 128*64 pixel picture
-        i2c_OLED_send_byte(bus, 0x00);  // clear
+    flushBus = bus;
+    for (int page = 0; page < SCREEN_PAGE_COUNT; page++) {
+        if (dirtyPages & (1 << page)) {
+            flushInProgress = true;
+            if (!i2c_OLED_send_page(page)) {
+                flushInProgress = false;
+            }
+            return;
+        }
     }
 }
 
+bool i2c_OLED_flush_in_progress(busDevice_t *bus)
+{
+    UNUSED(bus);
+
+    return flushInProgress;
+}
+
 void i2c_OLED_clear_display(busDevice_t *bus)
 {
     static const uint8_t i2c_OLED_cmd_clear_display_pre[] = {
@@ -221,7 +345,9 @@ void i2c_OLED_clear_display(busDevice_t *bus)
 
     i2c_OLED_send_cmdarray(bus, i2c_OLED_cmd_clear_display_pre, ARRAYLEN(i2c_OLED_cmd_clear_display_pre));
 
+    // The display RAM is unknown, so all of it is sent by the next flush
     i2c_OLED_clear_display_quick(bus);
+    dirtyPages = (1 << SCREEN_PAGE_COUNT) - 1;
 
     static const uint8_t i2c_OLED_cmd_clear_display_post[] = {
         0x81, // Setup CONTRAST CONTROL, following byte is the contrast Value... always a 2 byte instruction
@@ -234,13 +360,10 @@ void i2c_OLED_clear_display(busDevice_t *bus)
 
 void i2c_OLED_set_xy(busDevice_t *bus, uint8_t col, uint8_t row)
 {
-    uint8_t i2c_OLED_cmd_set_xy[] = {
-        0xb0 + row,                                            //set page address
-        0x00 + ((CHARACTER_WIDTH_TOTAL * col) & 0x0f),         //set low col address
-        0x10 + (((CHARACTER_WIDTH_TOTAL * col) >> 4) & 0x0f)   //set high col address
-    };
+    UNUSED(bus);
 
-    i2c_OLED_send_cmdarray(bus, i2c_OLED_cmd_set_xy, ARRAYLEN(i2c_OLED_cmd_set_xy));
+    cursorPage = row % SCREEN_PAGE_COUNT;
+    cursorColumn = (CHARACTER_WIDTH_TOTAL * col) % SCREEN_WIDTH;
 }
 
 void i2c_OLED_set_line(busDevice_t *bus, uint8_t row)
@@ -250,14 +373,16 @@ void i2c_OLED_set_line(busDevice_t *bus, uint8_t row)
 
 void i2c_OLED_send_char(busDevice_t *bus, unsigned char ascii)
 {
+    UNUSED(bus);
+
     unsigned char i;
     uint8_t buffer;
     for (i = 0; i < 5; i++) {
         buffer = multiWiiFont[ascii - 32][i];
         buffer ^= CHAR_FORMAT;  // apply
-        i2c_OLED_send_byte(bus, buffer);
+        i2c_OLED_put_byte(buffer);
     }
-    i2c_OLED_send_byte(bus, CHAR_FORMAT);    // the gap
+    i2c_OLED_put_byte(CHAR_FORMAT);    // the gap
 }
 
 void i2c_OLED_send_string(busDevice_t *bus, const char *string)
@@ -275,6 +400,12 @@ void i2c_OLED_send_string(busDevice_t *bus, const char *string)
 
 bool ug2864hsweg01InitI2C(busDevice_t *bus)
 {
+    // Let the page being sent complete, the display is sent in full again once it has been set up
+    flushStop = true;
+    const timeUs_t startUs = micros();
+    while (flushInProgress && cmpTimeUs(micros(), startUs) < FLUSH_STOP_TIMEOUT_US) {
+    }
+    flushStop = false;
 
     // Set display OFF
     if (!i2c_OLED_send_cmd(bus, 0xAE)) {
@@ -47,3 +47,5 @@ void i2c_OLED_send_char(busDevice_t *bus, unsigned char ascii);
 void i2c_OLED_send_string(busDevice_t *bus, const char *string);
 void i2c_OLED_clear_display(busDevice_t *bus);
 void i2c_OLED_clear_display_quick(busDevice_t *bus);
+void i2c_OLED_flush(busDevice_t *bus);
+bool i2c_OLED_flush_in_progress(busDevice_t *bus);
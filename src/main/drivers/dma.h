@@ -20,7 +20,10 @@
 
 #pragma once
 
+#include "build/irq_load.h"
+
 #include "drivers/resource.h"
+#include "drivers/stack_check.h"
 
 // dmaResource_t is a opaque data type which represents a single DMA engine,
 // called and implemented differently in different families of STM32s.
@@ -108,10 +111,13 @@ typedef enum {
     }
 
 #define DEFINE_DMA_IRQ_HANDLER(d, s, i) void DMA ## d ## _Stream ## s ## _IRQHandler(void) {\
+                                                                STACK_CHECK_IRQ(); \
+                                                                IRQ_LOAD_BEGIN(); \
                                                                 const uint8_t index = DMA_IDENTIFIER_TO_INDEX(i); \
                                                                 dmaCallbackHandlerFuncPtr handler = dmaDescriptors[index].irqHandlerCallback; \
                                                                 if (handler) \
                                                                     handler(&dmaDescriptors[index]); \
+                                                                IRQ_LOAD_END(IRQ_LOAD_DMA, index); \
                                                             }
 
 #define DMA_CLEAR_FLAG(d, flag) if (d->flagsShift > 31) d->dma->HIFCR = (flag << (d->flagsShift - 32)); else d->dma->LIFCR = (flag << d->flagsShift)
@@ -207,10 +213,13 @@ typedef enum {
 #endif
 
 #define DEFINE_DMA_IRQ_HANDLER(d, c, i) DMA_HANDLER_CODE void DMA ## d ## _Channel ## c ## _IRQHandler(void) {\
+                                                                        STACK_CHECK_IRQ(); \
+                                                                        IRQ_LOAD_BEGIN(); \
                                                                         const uint8_t index = DMA_IDENTIFIER_TO_INDEX(i); \
                                                                         dmaCallbackHandlerFuncPtr handler = dmaDescriptors[index].irqHandlerCallback; \
                                                                         if (handler) \
                                                                             handler(&dmaDescriptors[index]); \
+                                                                        IRQ_LOAD_END(IRQ_LOAD_DMA, index); \
                                                                     }
 
 #define DMA_CLEAR_FLAG(d, flag) d->dma->IFCR = (flag << d->flagsShift)
@@ -26,9 +26,12 @@
 
 #include "platform.h"
 
+#include "dshot.h"
+
 #ifdef USE_DSHOT
 
 #include "build/atomic.h"
+#include "build/debug.h"
 
 #include "common/maths.h"
 #include "common/time.h"
@@ -47,8 +50,6 @@
 
 #include "rx/rx.h"
 
-#include "dshot.h"
-
 void dshotInitEndpoints(const motorConfig_t *motorConfig, float outputLimit, float *outputLow, float *outputHigh, float *disarm, float *deadbandMotor3dHigh, float *deadbandMotor3dLow) {
     float outputLimitOffset = DSHOT_RANGE * (1 - outputLimit);
     *disarm = DSHOT_CMD_MOTOR_STOP;
@@ -139,6 +140,62 @@ uint16_t getDshotTelemetry(uint8_t index)
     return dshotTelemetryState.motorState[index].telemetryValue;
 }
 
+/*
+ * Interprets a checksummed 12 bit telemetry value (eeem mmmm mmmm). With extended telemetry enabled the ESC sends
+ * eRPM periods normalised so the top mantissa bit is set whenever the exponent is non zero, which frees the
+ * values with a non zero exponent and a clear top mantissa bit (pppp vvvv vvvv) for the extended frame types.
+ */
+FAST_CODE_NOINLINE bool dshotDecodeTelemetryValue(uint8_t motorIndex, uint16_t value)
+{
+    dshotTelemetryMotorState_t *motorState = &dshotTelemetryState.motorState[motorIndex];
+    dshotTelemetryType_t type;
+
+    if (motorConfig()->dev.useDshotEdt && (value & 0x0e00) && !(value & 0x0100)) {
+        // Extended frames use the even values 0x2 .. 0xe as type, in dshotTelemetryType_t order
+        type = (value >> 9) & 0x07;
+        value &= 0x00ff;
+        motorState->extendedFrameCount++;
+    } else {
+        type = DSHOT_TELEMETRY_TYPE_eRPM;
+
+        if (value == 0x0fff) {
+            // Motor stopped
+            value = 0;
+        } else {
+            // Convert value to 16 bit from the GCR telemetry format (eeem mmmm mmmm)
+            const uint32_t period = (value & 0x000001ff) << ((value & 0x00000e00) >> 9);
+            if (!period) {
+                return false;
+            }
+            // Convert period to erpm * 100
+            value = (1000000 * 60 / 100 + period / 2) / period;
+        }
+
+        motorState->telemetryValue = value;
+        motorState->telemetryActive = true;
+        if (motorIndex < 4) {
+            DEBUG_SET(DEBUG_DSHOT_RPM_TELEMETRY, motorIndex, value);
+        }
+    }
+
+    motorState->telemetryData[type] = value;
+    motorState->telemetryTypes |= 1 << type;
+
+    return true;
+}
+
+bool getDshotTelemetryData(uint8_t motorIndex, dshotTelemetryType_t type, uint16_t *value)
+{
+    const dshotTelemetryMotorState_t *motorState = &dshotTelemetryState.motorState[motorIndex];
+
+    if (!(motorState->telemetryTypes & (1 << type))) {
+        return false;
+    }
+    *value = motorState->telemetryData[type];
+
+    return true;
+}
+
 #endif
 
 #ifdef USE_DSHOT_TELEMETRY_STATS
@@ -165,6 +222,19 @@ void updateDshotTelemetryQuality(dshotTelemetryQuality_t *qualityStats, bool pac
 
 #endif // USE_DSHOT
 
+// Minimum time between the starts of two frames [us]. A bidirectional frame leaves room for the ESC turnaround
+// and the telemetry reply, allowing one frame length for each of them plus margin.
+uint32_t dshotFrameIntervalUs(uint32_t frameUs, bool bidirectional)
+{
+    return bidirectional ? 40 + 2 * frameUs : frameUs;
+}
+
+// Timer period closest to the requested rate [timer ticks]
+uint32_t dshotPacerPeriod(uint32_t timerClockHz, uint32_t rateHz)
+{
+    return (timerClockHz + rateHz / 2) / rateHz;
+}
+
 // temporarly here, needs to be moved during refactoring
 void validateAndfixMotorOutputReordering(uint8_t *array, const unsigned size)
 {
@@ -62,12 +62,31 @@ uint16_t dshotConvertToExternal(float motorValue);
 
 uint16_t prepareDshotPacket(dshotProtocolControl_t *pcb);
 
+uint32_t dshotFrameIntervalUs(uint32_t frameUs, bool bidirectional);
+uint32_t dshotPacerPeriod(uint32_t timerClockHz, uint32_t rateHz);
+
 #ifdef USE_DSHOT_TELEMETRY
 extern bool useDshotTelemetry;
 
+// Extended DShot telemetry (EDT) frames share the channel with the eRPM period frames
+typedef enum dshotTelemetryType_e {
+    DSHOT_TELEMETRY_TYPE_eRPM = 0,
+    DSHOT_TELEMETRY_TYPE_TEMPERATURE,   // C degrees
+    DSHOT_TELEMETRY_TYPE_VOLTAGE,       // 0.25V
+    DSHOT_TELEMETRY_TYPE_CURRENT,       // A
+    DSHOT_TELEMETRY_TYPE_DEBUG1,
+    DSHOT_TELEMETRY_TYPE_DEBUG2,
+    DSHOT_TELEMETRY_TYPE_STRESS_LEVEL,
+    DSHOT_TELEMETRY_TYPE_STATE_EVENTS,
+    DSHOT_TELEMETRY_TYPE_COUNT
+} dshotTelemetryType_t;
+
 typedef struct dshotTelemetryMotorState_s {
     uint16_t telemetryValue;
     bool telemetryActive;
+    uint8_t telemetryTypes;             // bitmask of the dshotTelemetryType_t received
+    uint16_t telemetryData[DSHOT_TELEMETRY_TYPE_COUNT];
+    uint16_t extendedFrameCount;
 } dshotTelemetryMotorState_t;
 
 
@@ -81,6 +100,9 @@ typedef struct dshotTelemetryState_s {
 
 extern dshotTelemetryState_t dshotTelemetryState;
 
+bool dshotDecodeTelemetryValue(uint8_t motorIndex, uint16_t value);
+bool getDshotTelemetryData(uint8_t motorIndex, dshotTelemetryType_t type, uint16_t *value);
+
 #ifdef USE_DSHOT_TELEMETRY_STATS
 void updateDshotTelemetryQuality(dshotTelemetryQuality_t *qualityStats, bool packetValid, timeMs_t currentTimeMs);
 #endif
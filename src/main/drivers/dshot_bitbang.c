@@ -27,6 +27,9 @@
 #ifdef USE_DSHOT_BITBANG
 
 #include "build/debug.h"
+#include "build/latency.h"
+
+#include "common/utils.h"
 
 #include "drivers/io.h"
 #include "drivers/io_impl.h"
@@ -44,6 +47,8 @@
 #include "drivers/time.h"
 #include "drivers/timer.h"
 
+#include "fc/dispatch.h"
+
 #include "pg/motor.h"
 
 #if defined(USE_DEBUG_PIN)
@@ -65,31 +70,9 @@ FAST_DATA_ZERO_INIT bbMotor_t bbMotors[MAX_SUPPORTED_MOTORS];
 static FAST_DATA_ZERO_INIT int motorCount;
 dshotBitbangStatus_e bbStatus;
 
-// For MCUs that use MPU to control DMA coherency, there might be a performance hit
-// on manipulating input buffer content especially if it is read multiple times,
-// as the buffer region is attributed as not cachable.
-// If this is not desirable, we should use manual cache invalidation.
-#ifdef USE_DSHOT_CACHE_MGMT
-#define BB_OUTPUT_BUFFER_ATTRIBUTE __attribute__((aligned(32)))
-#define BB_INPUT_BUFFER_ATTRIBUTE  __attribute__((aligned(32)))
-#else
-#if defined(STM32F4)
-#define BB_OUTPUT_BUFFER_ATTRIBUTE
-#define BB_INPUT_BUFFER_ATTRIBUTE
-#elif defined(STM32F7)
-#define BB_OUTPUT_BUFFER_ATTRIBUTE FAST_DATA_ZERO_INIT
-#define BB_INPUT_BUFFER_ATTRIBUTE  FAST_DATA_ZERO_INIT
-#elif defined(STM32H7)
-#define BB_OUTPUT_BUFFER_ATTRIBUTE DMA_RAM
-#define BB_INPUT_BUFFER_ATTRIBUTE  DMA_RAM
-#elif defined(STM32G4)
-#define BB_OUTPUT_BUFFER_ATTRIBUTE DMA_RAM_W
-#define BB_INPUT_BUFFER_ATTRIBUTE  DMA_RAM_R
-#endif
-#endif // USE_DSHOT_CACHE_MGMT
-
-BB_OUTPUT_BUFFER_ATTRIBUTE uint32_t bbOutputBuffer[MOTOR_DSHOT_BUF_CACHE_ALIGN_LENGTH * MAX_SUPPORTED_MOTOR_PORTS];
-BB_INPUT_BUFFER_ATTRIBUTE uint16_t bbInputBuffer[DSHOT_BB_PORT_IP_BUF_CACHE_ALIGN_LENGTH * MAX_SUPPORTED_MOTOR_PORTS];
+// The input buffer is read uncached on H7, but only once per frame, when it is copied for the telemetry decoder
+DMA_BUFFER_W uint32_t bbOutputBuffer[MOTOR_DSHOT_BUF_LENGTH * MAX_SUPPORTED_MOTOR_PORTS];
+DMA_BUFFER_R uint16_t bbInputBuffer[DSHOT_BB_PORT_IP_BUF_LENGTH * MAX_SUPPORTED_MOTOR_PORTS];
 
 uint8_t bbPuPdMode;
 FAST_DATA_ZERO_INIT timeUs_t dshotFrameUs;
@@ -161,29 +144,23 @@ static void bbOutputDataInit(uint32_t *buffer, uint16_t portMask, bool inverted)
     }
 }
 
-static void bbOutputDataSet(uint32_t *buffer, int pinNumber, uint16_t value, bool inverted)
+// Only rewrites the middle slots of the bits that changed since the previous packet, the buffer is kept between
+// frames. A cleared middle slot encodes a one, so an all ones packet matches a freshly initialised buffer.
+
+static void bbOutputDataUpdate(uint32_t *buffer, uint32_t middleBit, uint16_t lastPacket, uint16_t packet)
 {
-    uint32_t middleBit;
+    uint32_t changed = lastPacket ^ packet;
 
-    if (inverted) {
-        middleBit = (1 << (pinNumber + 0));
-    } else {
-        middleBit = (1 << (pinNumber + 16));
-    }
+    while (changed) {
+        const int bit = 31 - __builtin_clz(changed);
+        uint32_t *slot = &buffer[(15 - bit) * 3 + 1];
 
-    for (int pos = 0; pos < 16; pos++) {
-        if (!(value & 0x8000)) {
-            buffer[pos * 3 + 1] |= middleBit;
+        if (packet & (1 << bit)) {
+            *slot &= ~middleBit;
+        } else {
+            *slot |= middleBit;
         }
-        value <<= 1;
-    }
-}
-
-static void bbOutputDataClear(uint32_t *buffer)
-{
-    // Middle position to no change
-    for (int bitpos = 0; bitpos < 16; bitpos++) {
-        buffer[bitpos * 3 + 1] = 0;
+        changed &= ~(1 << bit);
     }
 }
 
@@ -262,6 +239,8 @@ const resourceOwner_t *dshotBitbangTimerGetOwner(int8_t timerNumber, uint16_t ti
 static uint32_t getDshotBaseFrequency(motorPwmProtocolTypes_e pwmProtocolType)
 {
     switch (pwmProtocolType) {
+    case(PWM_TYPE_DSHOT1200):
+        return MOTOR_DSHOT1200_SYMBOL_RATE * MOTOR_DSHOT_STATE_PER_SYMBOL;
     case(PWM_TYPE_DSHOT600):
         return MOTOR_DSHOT600_SYMBOL_RATE * MOTOR_DSHOT_STATE_PER_SYMBOL;
     case(PWM_TYPE_DSHOT300):
@@ -393,7 +372,8 @@ static void bbTimebaseSetup(bbPort_t *bbPort, motorPwmProtocolTypes_e dshotProto
 
     uint32_t outputFreq = getDshotBaseFrequency(dshotProtocolType);
     dshotFrameUs = 1000000 * 17 * 3 / outputFreq;
-    bbPort->outputARR = timerclock / outputFreq - 1;
+    // At DShot1200 the pacer period is only a few dozen ticks, truncating would skew the rate by up to 2%
+    bbPort->outputARR = dshotPacerPeriod(timerclock, outputFreq) - 1;
 
     // XXX Explain this formula
     uint32_t inputFreq = outputFreq * 5 * 2 * DSHOT_BITBANG_TELEMETRY_OVER_SAMPLE / 24;
@@ -419,6 +399,7 @@ static bool bbMotorConfig(IO_t io, uint8_t motorIndex, motorPwmProtocolTypes_e p
         bbPort = bbAllocMotorPort(portIndex);
         if (!bbPort) {
             bbDevice.vTable.write = motorWriteNull;
+            bbDevice.vTable.writeAll = NULL;
             bbDevice.vTable.updateStart = motorUpdateStartNull;
             bbDevice.vTable.updateComplete = motorUpdateCompleteNull;
 
@@ -428,10 +409,10 @@ static bool bbMotorConfig(IO_t io, uint8_t motorIndex, motorPwmProtocolTypes_e p
         bbPort->gpio = IO_GPIO(io);
 
         bbPort->portOutputCount = MOTOR_DSHOT_BUF_LENGTH;
-        bbPort->portOutputBuffer = &bbOutputBuffer[(bbPort - bbPorts) * MOTOR_DSHOT_BUF_CACHE_ALIGN_LENGTH];
+        bbPort->portOutputBuffer = &bbOutputBuffer[(bbPort - bbPorts) * MOTOR_DSHOT_BUF_LENGTH];
 
         bbPort->portInputCount = DSHOT_BB_PORT_IP_BUF_LENGTH;
-        bbPort->portInputBuffer = &bbInputBuffer[(bbPort - bbPorts) * DSHOT_BB_PORT_IP_BUF_CACHE_ALIGN_LENGTH];
+        bbPort->portInputBuffer = &bbInputBuffer[(bbPort - bbPorts) * DSHOT_BB_PORT_IP_BUF_LENGTH];
 
         bbTimebaseSetup(bbPort, pwmProtocolType);
         bbTIM_TimeBaseInit(bbPort, bbPort->outputARR);
@@ -458,10 +439,19 @@ static bool bbMotorConfig(IO_t io, uint8_t motorIndex, motorPwmProtocolTypes_e p
 #ifdef USE_DSHOT_TELEMETRY
     if (useDshotTelemetry) {
         bbOutputDataInit(bbPort->portOutputBuffer, (1 << pinIndex), DSHOT_BITBANG_INVERTED);
+        bbMotors[motorIndex].middleBit = 1 << (pinIndex + 0);
     } else
 #endif
     {
         bbOutputDataInit(bbPort->portOutputBuffer, (1 << pinIndex), DSHOT_BITBANG_NONINVERTED);
+        bbMotors[motorIndex].middleBit = 1 << (pinIndex + 16);
+    }
+
+    // bbOutputDataInit() clears the middle slots of the port, which matches an all ones packet
+    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
+        if (bbMotors[i].bbPort == bbPort) {
+            bbMotors[i].lastPacket = 0xffff;
+        }
     }
 
     bbSwitchToOutput(bbPort);
@@ -471,88 +461,103 @@ static bool bbMotorConfig(IO_t io, uint8_t motorIndex, motorPwmProtocolTypes_e p
     return true;
 }
 
-static bool bbUpdateStart(void)
-{
 #ifdef USE_DSHOT_TELEMETRY
-    if (useDshotTelemetry) {
+/*
+ * Telemetry frames are decoded from copies of the port input buffers by a dispatch entry, so only the copy
+ * happens in the motor update on the PID path. The copies are overwritten by every update, the decoder just
+ * picks up the most recent frames when it runs.
+ */
+static uint16_t bbTelemetryCapture[MAX_SUPPORTED_MOTOR_PORTS][DSHOT_BB_PORT_IP_BUF_LENGTH];
+static uint16_t bbTelemetryCaptureCount[MAX_SUPPORTED_MOTOR_PORTS];
+
+static void bbDecodeTelemetry(dispatchEntry_t *self)
+{
+    UNUSED(self);
+
 #ifdef USE_DSHOT_TELEMETRY_STATS
-        const timeMs_t currentTimeMs = millis();
+    const timeMs_t currentTimeMs = millis();
 #endif
-        timeUs_t currentUs = micros();
-        // don't send while telemetry frames might still be incoming
-        if (cmpTimeUs(currentUs, lastSendUs) < (timeDelta_t)(40 + 2 * dshotFrameUs)) {
-            return false;
-        }
 
+    // Decode every pin of a port in one pass over its capture
+    uint32_t values[MAX_SUPPORTED_MOTOR_PORTS][16];
+    for (int portIndex = 0; portIndex < usedMotorPorts; portIndex++) {
+        uint16_t pinMask = 0;
         for (int motorIndex = 0; motorIndex < MAX_SUPPORTED_MOTORS && motorIndex < motorCount; motorIndex++) {
-#ifdef USE_DSHOT_CACHE_MGMT
-            // Only invalidate the buffer once. If all motors are on a common port they'll share a buffer.
-            bool invalidated = false;
-            for (int i = 0; i < motorIndex; i++) {
-                if (bbMotors[motorIndex].bbPort->portInputBuffer == bbMotors[i].bbPort->portInputBuffer) {
-                    invalidated = true;
-                }
-            }
-            if (!invalidated) {
-                SCB_InvalidateDCache_by_Addr((uint32_t *)bbMotors[motorIndex].bbPort->portInputBuffer,
-                                             DSHOT_BB_PORT_IP_BUF_CACHE_ALIGN_BYTES);
+            if (bbMotors[motorIndex].bbPort == &bbPorts[portIndex]) {
+                pinMask |= 1 << bbMotors[motorIndex].pinIndex;
             }
-#endif
+        }
+        decode_bb_port(bbTelemetryCapture[portIndex], bbTelemetryCaptureCount[portIndex], pinMask, values[portIndex]);
+    }
 
-#ifdef STM32F4
-            uint32_t value = decode_bb_bitband(
-                bbMotors[motorIndex].bbPort->portInputBuffer,
-                bbMotors[motorIndex].bbPort->portInputCount - bbDMA_Count(bbMotors[motorIndex].bbPort),
-                bbMotors[motorIndex].pinIndex);
-#else
-            uint32_t value = decode_bb(
-                bbMotors[motorIndex].bbPort->portInputBuffer,
-                bbMotors[motorIndex].bbPort->portInputCount - bbDMA_Count(bbMotors[motorIndex].bbPort),
-                bbMotors[motorIndex].pinIndex);
-#endif
-            if (value == BB_NOEDGE) {
-                continue;
-            }
-            dshotTelemetryState.readCount++;
+    for (int motorIndex = 0; motorIndex < MAX_SUPPORTED_MOTORS && motorIndex < motorCount; motorIndex++) {
+        const int portIndex = bbMotors[motorIndex].bbPort - bbPorts;
+        const uint32_t value = values[portIndex][bbMotors[motorIndex].pinIndex];
 
-            if (value != BB_INVALID) {
-                dshotTelemetryState.motorState[motorIndex].telemetryValue = value;
-                dshotTelemetryState.motorState[motorIndex].telemetryActive = true;
-                if (motorIndex < 4) {
-                    DEBUG_SET(DEBUG_DSHOT_RPM_TELEMETRY, motorIndex, value);
-                }
-            } else {
-                dshotTelemetryState.invalidPacketCount++;
-            }
+        if (value == BB_NOEDGE) {
+            continue;
+        }
+        dshotTelemetryState.readCount++;
+
+        const bool validTelemetryPacket = value != BB_INVALID && dshotDecodeTelemetryValue(motorIndex, value);
+        if (!validTelemetryPacket) {
+            dshotTelemetryState.invalidPacketCount++;
+        }
 #ifdef USE_DSHOT_TELEMETRY_STATS
-            updateDshotTelemetryQuality(&dshotTelemetryQuality[motorIndex], value != BB_INVALID, currentTimeMs);
+        updateDshotTelemetryQuality(&dshotTelemetryQuality[motorIndex], validTelemetryPacket, currentTimeMs);
+#endif
+    }
+
+    // Each capture is decoded once
+    memset(bbTelemetryCaptureCount, 0, sizeof(bbTelemetryCaptureCount));
+}
+
+static dispatchEntry_t bbTelemetryDispatchEntry = {
+    .dispatch = bbDecodeTelemetry,
+    .priority = DISPATCH_PRIORITY_URGENT,
+};
 #endif
+
+static bool bbUpdateStart(void)
+{
+#ifdef USE_DSHOT_TELEMETRY
+    if (useDshotTelemetry) {
+        timeUs_t currentUs = micros();
+        // don't send while telemetry frames might still be incoming
+        if (cmpTimeUs(currentUs, lastSendUs) < (timeDelta_t)dshotFrameIntervalUs(dshotFrameUs, true)) {
+            return false;
+        }
+
+        for (int i = 0; i < usedMotorPorts; i++) {
+            bbPort_t *bbPort = &bbPorts[i];
+
+            // The input buffer is reused by the next telemetry frame, keep a copy for the decoder
+            const uint16_t count = bbPort->portInputCount - bbDMA_Count(bbPort);
+            memcpy(bbTelemetryCapture[i], bbPort->portInputBuffer, count * sizeof(uint16_t));
+            bbTelemetryCaptureCount[i] = count;
         }
+
+        dispatchAdd(&bbTelemetryDispatchEntry, 0);
     }
 #endif
     for (int i = 0; i < usedMotorPorts; i++) {
         bbDMA_Cmd(&bbPorts[i], DISABLE);
-        bbOutputDataClear(bbPorts[i].portOutputBuffer);
     }
 
     return true;
 }
 
-static void bbWriteInt(uint8_t motorIndex, uint16_t value)
+static uint16_t bbPrepareMotorPacket(uint8_t motorIndex, uint16_t value)
 {
     bbMotor_t *const bbmotor = &bbMotors[motorIndex];
 
-    if (!bbmotor->configured) {
-        return;
-    }
-
     // fetch requestTelemetry from motors. Needs to be refactored.
     motorDmaOutput_t * const motor = getMotorDmaOutput(motorIndex);
     bbmotor->protocolControl.requestTelemetry = motor->protocolControl.requestTelemetry;
     motor->protocolControl.requestTelemetry = false;
 
     // If there is a command ready to go overwrite the value and send that instead
-    if (dshotCommandIsProcessing()) {
+    if (dshotCommandIsFrameDue()) {
         value = dshotCommandGetCurrent(motorIndex);
         if (value) {
             bbmotor->protocolControl.requestTelemetry = true;
@@ -561,18 +566,21 @@ static void bbWriteInt(uint8_t motorIndex, uint16_t value)
 
     bbmotor->protocolControl.value = value;
 
-    uint16_t packet = prepareDshotPacket(&bbmotor->protocolControl);
+    return prepareDshotPacket(&bbmotor->protocolControl);
+}
 
-    bbPort_t *bbPort = bbmotor->bbPort;
+static void bbWriteInt(uint8_t motorIndex, uint16_t value)
+{
+    bbMotor_t *const bbmotor = &bbMotors[motorIndex];
 
-#ifdef USE_DSHOT_TELEMETRY
-    if (useDshotTelemetry) {
-        bbOutputDataSet(bbPort->portOutputBuffer, bbmotor->pinIndex, packet, DSHOT_BITBANG_INVERTED);
-    } else
-#endif
-    {
-        bbOutputDataSet(bbPort->portOutputBuffer, bbmotor->pinIndex, packet, DSHOT_BITBANG_NONINVERTED);
+    if (!bbmotor->configured) {
+        return;
     }
+
+    const uint16_t packet = bbPrepareMotorPacket(motorIndex, value);
+
+    bbOutputDataUpdate(bbmotor->bbPort->portOutputBuffer, bbmotor->middleBit, bbmotor->lastPacket, packet);
+    bbmotor->lastPacket = packet;
 }
 
 static void bbWrite(uint8_t motorIndex, float value)
@@ -580,6 +588,22 @@ static void bbWrite(uint8_t motorIndex, float value)
     bbWriteInt(motorIndex, value);
 }
 
+static void bbWriteAll(float *values)
+{
+    for (int motorIndex = 0; motorIndex < MAX_SUPPORTED_MOTORS && motorIndex < motorCount; motorIndex++) {
+        bbMotor_t *const bbmotor = &bbMotors[motorIndex];
+
+        if (!bbmotor->configured) {
+            continue;
+        }
+
+        const uint16_t packet = bbPrepareMotorPacket(motorIndex, values[motorIndex]);
+
+        bbOutputDataUpdate(bbmotor->bbPort->portOutputBuffer, bbmotor->middleBit, bbmotor->lastPacket, packet);
+        bbmotor->lastPacket = packet;
+    }
+}
+
 static void bbUpdateComplete(void)
 {
     // If there is a dshot command loaded up, time it correctly with motor update
@@ -590,21 +614,6 @@ static void bbUpdateComplete(void)
         }
     }
 
-#ifdef USE_DSHOT_CACHE_MGMT
-    for (int motorIndex = 0; motorIndex < MAX_SUPPORTED_MOTORS && motorIndex < motorCount; motorIndex++) {
-        // Only clean the buffer once. If all motors are on a common port they'll share a buffer.
-        bool clean = false;
-        for (int i = 0; i < motorIndex; i++) {
-            if (bbMotors[motorIndex].bbPort->portInputBuffer == bbMotors[i].bbPort->portInputBuffer) {
-                clean = true;
-            }
-        }
-        if (!clean) {
-            SCB_CleanDCache_by_Addr(bbMotors[motorIndex].bbPort->portOutputBuffer, MOTOR_DSHOT_BUF_CACHE_ALIGN_BYTES);
-        }
-    }
-#endif
-
 #ifdef USE_DSHOT_TELEMETRY
     for (int i = 0; i < usedMotorPorts; i++) {
         bbPort_t *bbPort = &bbPorts[i];
@@ -626,6 +635,7 @@ static void bbUpdateComplete(void)
         bbPacer_t *bbPacer = &bbPacers[i];
         bbTIM_DMACmd(bbPacer->tim, bbPacer->dmaSources, ENABLE);
     }
+    LATENCY_MARK(LATENCY_STAGE_MOTOR_OUTPUT);
 }
 
 static bool bbEnableMotors(void)
@@ -680,6 +690,7 @@ static motorVTable_t bbVTable = {
     .updateStart = bbUpdateStart,
     .write = bbWrite,
     .writeInt = bbWriteInt,
+    .writeAll = bbWriteAll,
     .updateComplete = bbUpdateComplete,
     .convertExternalToMotor = dshotConvertFromExternal,
     .convertMotorToExternal = dshotConvertToExternal,
@@ -704,6 +715,9 @@ motorDevice_t *dshotBitbangDevInit(const motorDevConfig_t *motorConfig, uint8_t
 
 #ifdef USE_DSHOT_TELEMETRY
     useDshotTelemetry = motorConfig->useDshotTelemetry;
+    if (useDshotTelemetry) {
+        dispatchEnable();
+    }
 #endif
 
     memset(bbOutputBuffer, 0, sizeof(bbOutputBuffer));
@@ -725,6 +739,7 @@ motorDevice_t *dshotBitbangDevInit(const motorDevConfig_t *motorConfig, uint8_t
         if (!IOIsFreeOrPreinit(io)) {
             /* not enough motors initialised for the mixer or a break in the motors */
             bbDevice.vTable.write = motorWriteNull;
+            bbDevice.vTable.writeAll = NULL;
             bbDevice.vTable.updateStart = motorUpdateStartNull;
             bbDevice.vTable.updateComplete = motorUpdateCompleteNull;
             bbStatus = DSHOT_BITBANG_STATUS_MOTOR_PIN_CONFLICT;
@@ -71,18 +71,8 @@ static uint32_t decode_bb_value(uint32_t value, uint16_t buffer[], uint32_t coun
 #endif
         value = BB_INVALID;
     } else {
+        // Return the 12 bit telemetry value, dshotDecodeTelemetryValue() interprets it
         value = decodedValue >> 4;
-
-        if (value == 0x0fff) {
-            return 0;
-        }
-        // Convert value to 16 bit from the GCR telemetry format (eeem mmmm mmmm)
-        value = (value & 0x000001ff) << ((value & 0xfffffe00) >> 9);
-        if (!value) {
-            return BB_INVALID;
-        }
-        // Convert period to erpm * 100
-        value = (1000000 * 60 / 100 + value / 2) / value;
     }
     return value;
 }
@@ -96,7 +86,7 @@ uint32_t decode_bb_bitband( uint16_t buffer[], uint32_t count, uint32_t bit)
 #endif
     uint32_t value = 0;
 
-    bitBandWord_t* p = (bitBandWord_t*)BITBAND_SRAM((uint32_t)buffer, bit);
+    bitBandWord_t* p = (bitBandWord_t*)BITBAND_SRAM((uintptr_t)buffer, bit);
     bitBandWord_t* b = p;
     bitBandWord_t* endP = p + (count - MIN_VALID_BBSAMPLES);
 
@@ -292,4 +282,106 @@ FAST_CODE uint32_t decode_bb( uint16_t buffer[], uint32_t count, uint32_t bit)
     return decode_bb_value(value, buffer, count, bit);
 }
 
+/*
+ * Decode all pins in pinMask from one pass over a port's input buffer. All motors on a GPIO port share a
+ * capture, so rather than walking the buffer once per pin each sample is XORed against the current level of
+ * every pin at once, and only pins that actually changed are visited. Run lengths are turned into bits with
+ * the same rules as decode_bb(). values[] is indexed by pin and receives a decoded value, BB_NOEDGE or
+ * BB_INVALID for each pin in pinMask.
+ */
+FAST_CODE void decode_bb_port(uint16_t buffer[], uint32_t count, uint16_t pinMask, uint32_t values[])
+{
+    typedef struct bbPinDecode_s {
+        uint32_t value;
+        uint32_t bits;
+        uint32_t lastEdge; // index of the sample following the last edge
+        uint32_t end;      // only edges followed by a sample before end are part of the frame
+    } bbPinDecode_t;
+
+    bbPinDecode_t pins[16];
+
+    // Pins still looking for the low level that starts a frame
+    uint16_t searching = pinMask;
+    // Pins which were low on the previous sample, their frame starts here if they are still low
+    uint16_t starting = 0;
+    // Pins which found a frame, the subset still inside it, and the current level of those
+    uint16_t framed = 0;
+    uint16_t active = 0;
+    uint16_t level = 0;
+
+    const uint32_t searchEnd = count > MIN_VALID_BBSAMPLES ? count - MIN_VALID_BBSAMPLES : 0;
+
+    for (uint32_t i = 0; i < count && (searching | starting | active); i++) {
+        const uint16_t sample = buffer[i];
+
+        if (starting) {
+            // Pins that went straight back high have no frame
+            const uint16_t started = starting & ~sample;
+            for (uint16_t pending = started; pending; pending &= pending - 1) {
+                bbPinDecode_t *pin = &pins[__builtin_ctz(pending)];
+
+                pin->value = 0;
+                pin->bits = 0;
+                pin->lastEdge = i;
+                pin->end = i + MIN(count - i, (uint32_t)MAX_VALID_BBSAMPLES);
+            }
+            framed |= started;
+            active |= started;
+            level &= ~started;
+            starting = 0;
+        }
+
+        if (searching) {
+            if (i < searchEnd) {
+                starting = searching & ~sample;
+                searching &= ~starting;
+            } else {
+                searching = 0;
+            }
+        }
+
+        for (uint16_t edges = (sample ^ level) & active; edges; edges &= edges - 1) {
+            const unsigned pinIndex = __builtin_ctz(edges);
+            bbPinDecode_t *pin = &pins[pinIndex];
+            const uint32_t next = i + 1;
+
+            if (next < pin->end) {
+                // A level of length n gets decoded to a sequence of bits of
+                // the form 1000 with a length of (n+1) / 3 to account for 3x
+                // oversampling.
+                const int len = MAX((int)(next - pin->lastEdge + 1) / 3, 1);
+                pin->bits += len;
+                pin->value <<= len;
+                pin->value |= 1 << (len - 1);
+                pin->lastEdge = next;
+                level ^= 1 << pinIndex;
+            } else {
+                active &= ~(1 << pinIndex);
+            }
+        }
+    }
+
+    for (uint16_t pending = pinMask; pending; pending &= pending - 1) {
+        const unsigned pinIndex = __builtin_ctz(pending);
+        const bbPinDecode_t *pin = &pins[pinIndex];
+
+        if (!(framed & (1 << pinIndex)) || pin->bits < 18) {
+            values[pinIndex] = BB_NOEDGE;
+            continue;
+        }
+
+        // length of last sequence has to be inferred since the last bit with inverted dshot is high
+        const int nlen = 21 - pin->bits;
+        uint32_t value = pin->value;
+        if (nlen < 0) {
+            value = BB_INVALID;
+        }
+        if (nlen > 0) {
+            value <<= nlen;
+            value |= 1 << (nlen - 1);
+        }
+        values[pinIndex] = decode_bb_value(value, buffer, count, pinIndex);
+    }
+}
+
 #endif
@@ -42,6 +42,7 @@
 // XXX Trying to fiddle with constants here.
 
 // Symbol rate [symbol/sec]
+#define MOTOR_DSHOT1200_SYMBOL_RATE    (1200 * 1000)
 #define MOTOR_DSHOT600_SYMBOL_RATE     (600 * 1000)
 #define MOTOR_DSHOT300_SYMBOL_RATE     (300 * 1000)
 #define MOTOR_DSHOT150_SYMBOL_RATE     (150 * 1000)
@@ -63,17 +64,6 @@
 #define MOTOR_DSHOT_GCR_CHANGE_INTERVAL_NS(rate) (MOTOR_DSHOT_CHANGE_INTERVAL_NS(rate) * 5 / 4)
 
 #define MOTOR_DSHOT_BUF_LENGTH            ((MOTOR_DSHOT_FRAME_BITS / MOTOR_DSHOT_BIT_PER_SYMBOL) * MOTOR_DSHOT_STATE_PER_SYMBOL)
-#ifdef USE_DSHOT_CACHE_MGMT
-// MOTOR_DSHOT_BUF_LENGTH is multiples of uint32_t
-// Number of bytes required for buffer
-#define MOTOR_DSHOT_BUF_BYTES              (MOTOR_DSHOT_BUF_LENGTH * sizeof (uint32_t))
-// Number of bytes required to cache align buffer
-#define MOTOR_DSHOT_BUF_CACHE_ALIGN_BYTES  ((MOTOR_DSHOT_BUF_BYTES + 0x20) & ~0x1f)
-// Size of array to create a cache aligned buffer
-#define MOTOR_DSHOT_BUF_CACHE_ALIGN_LENGTH (MOTOR_DSHOT_BUF_CACHE_ALIGN_BYTES / sizeof (uint32_t))
-#else
-#define MOTOR_DSHOT_BUF_CACHE_ALIGN_LENGTH MOTOR_DSHOT_BUF_LENGTH
-#endif
 
 #ifdef USE_HAL_DRIVER
 #define BB_GPIO_PULLDOWN GPIO_PULLDOWN
@@ -185,6 +175,8 @@ typedef struct bbMotor_s {
     uint8_t output;
     uint32_t iocfg;
     bbPort_t *bbPort;
+    uint32_t middleBit;      // port output buffer bit that drives the middle slot of this output
+    uint16_t lastPacket;     // packet currently held in the port output buffer
     bool configured;
     bool enabled;
 } bbMotor_t;
@@ -206,7 +198,7 @@ extern uint8_t bbPuPdMode;
 
 // DMA output buffer:
 // DShot requires 3 [word/bit] * 16 [bit] = 48 [word]
-extern uint32_t bbOutputBuffer[MOTOR_DSHOT_BUF_CACHE_ALIGN_LENGTH * MAX_SUPPORTED_MOTOR_PORTS];
+extern uint32_t bbOutputBuffer[MOTOR_DSHOT_BUF_LENGTH * MAX_SUPPORTED_MOTOR_PORTS];
 
 // DMA input buffer
 // (30us + <frame time> + <slack>) / <input sampling clock perid>
@@ -218,18 +210,7 @@ extern uint32_t bbOutputBuffer[MOTOR_DSHOT_BUF_CACHE_ALIGN_LENGTH * MAX_SUPPORTE
 // (30 + 26 + 3) / 0.44 = 134
 // In some cases this was not enough, so we add 6 extra samples
 #define DSHOT_BB_PORT_IP_BUF_LENGTH 140
-#ifdef USE_DSHOT_CACHE_MGMT
-// Each sample is a uint16_t
-// Number of bytes required for buffer
-#define DSHOT_BB_PORT_IP_BUF_BYTES              (DSHOT_BB_PORT_IP_BUF_LENGTH * sizeof (uint16_t))
-// Number of bytes required to cache align buffer
-#define DSHOT_BB_PORT_IP_BUF_CACHE_ALIGN_BYTES  ((DSHOT_BB_PORT_IP_BUF_BYTES + 0x20) & ~0x1f)
-// Size of array to create a cache aligned buffer
-#define DSHOT_BB_PORT_IP_BUF_CACHE_ALIGN_LENGTH (DSHOT_BB_PORT_IP_BUF_CACHE_ALIGN_BYTES / sizeof (uint16_t))
-#else
-#define DSHOT_BB_PORT_IP_BUF_CACHE_ALIGN_LENGTH DSHOT_BB_PORT_IP_BUF_LENGTH
-#endif
-extern uint16_t bbInputBuffer[DSHOT_BB_PORT_IP_BUF_CACHE_ALIGN_LENGTH * MAX_SUPPORTED_MOTOR_PORTS];
+extern uint16_t bbInputBuffer[DSHOT_BB_PORT_IP_BUF_LENGTH * MAX_SUPPORTED_MOTOR_PORTS];
 
 void bbGpioSetup(bbMotor_t *bbMotor);
 void bbTimerChannelInit(bbPort_t *bbPort);
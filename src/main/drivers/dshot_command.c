@@ -103,7 +103,19 @@ FAST_CODE bool dshotCommandIsProcessing(void)
     return commandIsProcessing;
 }
 
-static FAST_CODE bool dshotCommandQueueUpdate(void)
+// True when the next motor output carries the command instead of the motor values. Outside of the repeats of
+// a command normal frames keep flowing, so only the gaps between repeats hold back the motor output.
+FAST_CODE bool dshotCommandIsFrameDue(void)
+{
+    if (dshotCommandQueueEmpty()) {
+        return false;
+    }
+    const dshotCommandControl_t* command = &commandQueue[commandQueueTail];
+    return (command->state == DSHOT_COMMAND_STATE_STARTDELAY || command->state == DSHOT_COMMAND_STATE_ACTIVE)
+           && !command->nextCommandCycleDelay;
+}
+
+static FAST_CODE void dshotCommandQueueUpdate(void)
 {
     if (!dshotCommandQueueEmpty()) {
         commandQueueTail = (commandQueueTail + 1) % (DSHOT_MAX_COMMANDS + 1);
@@ -114,10 +126,8 @@ static FAST_CODE bool dshotCommandQueueUpdate(void)
             dshotCommandControl_t* nextCommand = &commandQueue[commandQueueTail];
             nextCommand->state = DSHOT_COMMAND_STATE_ACTIVE;
             nextCommand->nextCommandCycleDelay = 0;
-            return true;
         }
     }
-    return false;
 }
 
 static FAST_CODE uint32_t dshotCommandCyclesFromTime(timeUs_t delayUs)
@@ -192,6 +202,8 @@ void dshotCommandWrite(uint8_t index, uint8_t motorCount, uint8_t command, dshot
     case DSHOT_CMD_3D_MODE_OFF:
     case DSHOT_CMD_3D_MODE_ON:
     case DSHOT_CMD_SAVE_SETTINGS:
+    case DSHOT_CMD_EXTENDED_TELEMETRY_ENABLE:
+    case DSHOT_CMD_EXTENDED_TELEMETRY_DISABLE:
     case DSHOT_CMD_SPIN_DIRECTION_NORMAL:
     case DSHOT_CMD_SPIN_DIRECTION_REVERSED:
     case DSHOT_CMD_SIGNAL_LINE_TELEMETRY_DISABLE:
@@ -264,6 +276,8 @@ uint8_t dshotCommandGetCurrent(uint8_t index)
 // allows the motor output to be sent, "false" means delay until next loop. So take
 // the example of a dshot command that needs to repeat 10 times at 1ms intervals.
 // If we have a 8KHz PID loop we'll end up sending the dshot command every 8th motor output.
+// Only the loops between the repeats are held back, ESCs count the repeats of a command in a row and a motor
+// frame in between would restart the count. The delays before and after a command carry normal motor frames.
 FAST_CODE_NOINLINE bool dshotCommandOutputIsEnabled(uint8_t motorCount)
 {
     UNUSED(motorCount);
@@ -280,7 +294,7 @@ FAST_CODE_NOINLINE bool dshotCommandOutputIsEnabled(uint8_t motorCount)
     case DSHOT_COMMAND_STATE_STARTDELAY:
         if (command->nextCommandCycleDelay) {
             --command->nextCommandCycleDelay;
-            return false;  // Delay motor output until the start of the command seequence
+            return true;  // Motor frames continue until the start of the command sequence
         }
         command->state = DSHOT_COMMAND_STATE_ACTIVE;
         command->nextCommandCycleDelay = 0;  // first iteration of the repeat happens now
@@ -309,13 +323,10 @@ FAST_CODE_NOINLINE bool dshotCommandOutputIsEnabled(uint8_t motorCount)
     case DSHOT_COMMAND_STATE_POSTDELAY:
         if (command->nextCommandCycleDelay) {
             --command->nextCommandCycleDelay;
-            return false;  // Delay motor output until the end of the post-command delay
-        }
-        if (dshotCommandQueueUpdate()) {
-            // Will be true if the command queue is not empty and we
-            // want to wait for the next command to start in sequence.
-            return false;
+            return true;  // Motor frames continue during the post-command delay
         }
+        // Starts the next command, if any, on the following motor output
+        dshotCommandQueueUpdate();
     }
 
     return true;
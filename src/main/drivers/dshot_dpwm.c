@@ -34,6 +34,8 @@
 #include "drivers/dshot_dpwm.h"
 #include "drivers/motor.h"
 
+#include "fc/dispatch.h"
+
 #include "pg/motor.h"
 
 // XXX TODO: Share a single region among dshotDmaBuffer and dshotBurstDmaBuffer
@@ -84,6 +86,8 @@ uint32_t getDshotHz(motorPwmProtocolTypes_e pwmProtocolType)
     switch (pwmProtocolType) {
     case(PWM_TYPE_PROSHOT1000):
         return MOTOR_PROSHOT1000_HZ;
+    case(PWM_TYPE_DSHOT1200):
+        return MOTOR_DSHOT1200_HZ;
     case(PWM_TYPE_DSHOT600):
         return MOTOR_DSHOT600_HZ;
     case(PWM_TYPE_DSHOT300):
@@ -161,12 +165,16 @@ motorDevice_t *dshotPwmDevInit(const motorDevConfig_t *motorConfig, uint16_t idl
 #ifdef USE_DSHOT_TELEMETRY
     useDshotTelemetry = motorConfig->useDshotTelemetry;
     dshotPwmDevice.vTable.updateStart = pwmStartDshotMotorUpdate;
+    if (useDshotTelemetry) {
+        dispatchEnable();
+    }
 #endif
 
     switch (motorConfig->motorPwmProtocol) {
     case PWM_TYPE_PROSHOT1000:
         loadDmaBuffer = loadDmaBufferProshot;
         break;
+    case PWM_TYPE_DSHOT1200:
     case PWM_TYPE_DSHOT600:
     case PWM_TYPE_DSHOT300:
     case PWM_TYPE_DSHOT150:
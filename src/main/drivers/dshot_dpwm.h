@@ -25,6 +25,7 @@
 #include "drivers/dshot.h"
 #include "drivers/motor.h"
 
+#define MOTOR_DSHOT1200_HZ    MHZ_TO_HZ(24)
 #define MOTOR_DSHOT600_HZ     MHZ_TO_HZ(12)
 #define MOTOR_DSHOT300_HZ     MHZ_TO_HZ(6)
 #define MOTOR_DSHOT150_HZ     MHZ_TO_HZ(3)
@@ -60,16 +61,8 @@ motorDevice_t *dshotPwmDevInit(const struct motorDevConfig_s *motorConfig, uint1
 
 #define GCR_TELEMETRY_INPUT_LEN MAX_GCR_EDGES
 
-// For H7, DMA buffer is placed in a dedicated segment for coherency management
-#if defined(STM32H7)
-#define DSHOT_DMA_BUFFER_ATTRIBUTE DMA_RAM
-#elif defined(STM32G4)
-#define DSHOT_DMA_BUFFER_ATTRIBUTE DMA_RAM_W
-#elif defined(STM32F7)
-#define DSHOT_DMA_BUFFER_ATTRIBUTE FAST_DATA_ZERO_INIT
-#else
-#define DSHOT_DMA_BUFFER_ATTRIBUTE // None
-#endif
+// The timer DMA reads the output and, with DShot telemetry, writes the input on the same buffer
+#define DSHOT_DMA_BUFFER_ATTRIBUTE DMA_BUFFER_RW
 
 #if defined(STM32F3) || defined(STM32F4) || defined(STM32F7) || defined(STM32H7) || defined(STM32G4)
 #define DSHOT_DMA_BUFFER_UNIT uint32_t
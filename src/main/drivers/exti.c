@@ -26,7 +26,10 @@
 
 #ifdef USE_EXTI
 
+#include "build/irq_load.h"
+
 #include "drivers/nvic.h"
+#include "drivers/stack_check.h"
 #include "io_impl.h"
 #include "drivers/exti.h"
 
@@ -236,12 +239,16 @@ void EXTIEnable(IO_t io, bool enable)
 
 void EXTI_IRQHandler(void)
 {
+    STACK_CHECK_IRQ();
+
     uint32_t exti_active = (EXTI_REG_IMR & EXTI_REG_PR) & EXTI_EVENT_MASK;
 
     while (exti_active) {
         unsigned idx = 31 - __builtin_clz(exti_active);
         uint32_t mask = 1 << idx;
+        IRQ_LOAD_BEGIN();
         extiChannelRecs[idx].handler->fn(extiChannelRecs[idx].handler);
+        IRQ_LOAD_END(IRQ_LOAD_EXTI, idx);
         EXTI_REG_PR = mask;  // clear pending mask (by writing 1)
         exti_active &= ~mask;
     }
@@ -142,6 +142,22 @@ typedef struct bblut_s {
 
 static bool w25n01g_waitForReady(flashDevice_t *fdevice);
 
+// The page held in the data buffer of the chip, the ECC status of its load is checked on the first read from it
+static uint32_t currentPage = UINT32_MAX;
+static bool currentPageEccChecked;
+
+// The first page of the erase or the page of the program in progress, its status is checked once the chip is ready
+static uint32_t operationPage = UINT32_MAX;
+static bool operationIsErase;
+
+// A block that could not be read back, it is replaced before it is next erased
+static uint32_t failingBlock = UINT32_MAX;
+
+// The block of the replacement area to be used next, found ahead as looking for it overwrites the data buffer
+static uint16_t replacementBlock;
+
+static bool w25n01g_replaceFailedBlock(flashDevice_t *fdevice, uint32_t page, bool isErase);
+
 static void w25n01g_setTimeout(flashDevice_t *fdevice, uint32_t timeoutMillis)
 {
     uint32_t now = millis();
@@ -266,15 +282,29 @@ bool w25n01g_isReady(flashDevice_t *fdevice)
 
 static bool w25n01g_waitForReady(flashDevice_t *fdevice)
 {
-    while (!w25n01g_isReady(fdevice)) {
-        uint32_t now = millis();
-        if (cmp32(now, fdevice->timeoutAt) >= 0) {
-            return false;
+    while (true) {
+        uint8_t status;
+
+        while ((status = w25n01g_readRegister(&fdevice->io, W25N01G_STAT_REG)) & W25N01G_STATUS_FLAG_BUSY) {
+            uint32_t now = millis();
+            if (cmp32(now, fdevice->timeoutAt) >= 0) {
+                return false;
+            }
         }
-    }
-    fdevice->timeoutAt = 0;
+        fdevice->timeoutAt = 0;
 
-    return true;
+        const uint32_t page = operationPage;
+        operationPage = UINT32_MAX;
+
+        if (page == UINT32_MAX || !(status & (W25N01G_STATUS_ERASE_FAIL | W25N01G_STATUS_PROGRAM_FAIL))) {
+            return true;
+        }
+
+        // Replacing the block may start the failed erase again on the replacement, so wait for that too
+        if (!w25n01g_replaceFailedBlock(fdevice, page, operationIsErase)) {
+            return true;
+        }
+    }
 }
 
 /**
@@ -358,11 +388,28 @@ void w25n01g_eraseSector(flashDevice_t *fdevice, uint32_t address)
 
     w25n01g_waitForReady(fdevice);
 
+    const uint32_t page = W25N01G_BLOCK_TO_PAGE(W25N01G_LINEAR_TO_BLOCK(address));
+
+    if (W25N01G_LINEAR_TO_BLOCK(address) == failingBlock) {
+        failingBlock = UINT32_MAX;
+
+        // Its contents are about to go, so the block can simply be swapped for a good one, which is then erased
+        if (w25n01g_replaceFailedBlock(fdevice, page, true)) {
+            return;
+        }
+    }
+
     w25n01g_writeEnable(fdevice);
 
-    w25n01g_performCommandWithPageAddress(&fdevice->io, W25N01G_INSTRUCTION_BLOCK_ERASE, W25N01G_LINEAR_TO_PAGE(address));
+    w25n01g_performCommandWithPageAddress(&fdevice->io, W25N01G_INSTRUCTION_BLOCK_ERASE, page);
 
     w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_BLOCK_ERASE_MS);
+
+    operationPage = page;
+    operationIsErase = true;
+
+    // The data buffer may hold a page of the erased block
+    currentPage = UINT32_MAX;
 }
 
 //
@@ -435,6 +482,9 @@ static void w25n01g_programExecute(flashDevice_t *fdevice, uint32_t pageAddress)
     w25n01g_performCommandWithPageAddress(&fdevice->io, W25N01G_INSTRUCTION_PROGRAM_EXECUTE, pageAddress);
 
     w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_PAGE_PROGRAM_MS);
+
+    operationPage = pageAddress;
+    operationIsErase = false;
 }
 
 //
@@ -506,6 +556,9 @@ void w25n01g_pageProgramContinue(flashDevice_t *fdevice, const uint8_t *data, in
 
     isProgramming = false;
 
+    // The data buffer no longer holds the page last read
+    currentPage = UINT32_MAX;
+
     if (!bufferDirty) {
         w25n01g_programDataLoad(fdevice, W25N01G_LINEAR_TO_COLUMN(programLoadAddress), data, length);
     } else {
@@ -518,8 +571,6 @@ void w25n01g_pageProgramContinue(flashDevice_t *fdevice, const uint8_t *data, in
     programLoadAddress += length;
 }
 
-static uint32_t currentPage = UINT32_MAX;
-
 void w25n01g_pageProgramFinish(flashDevice_t *fdevice)
 {
     if (bufferDirty && W25N01G_LINEAR_TO_COLUMN(programLoadAddress) == 0) {
@@ -574,8 +625,10 @@ void w25n01g_flush(flashDevice_t *fdevice)
 
 void w25n01g_addError(uint32_t address, uint8_t code)
 {
-    UNUSED(address);
-    UNUSED(code);
+    // Corrected errors are expected as NAND flash wears, blocks are only retired once the ECC can no longer cope
+    if (code >= 2) {
+        failingBlock = W25N01G_LINEAR_TO_BLOCK(address);
+    }
 }
 
 /**
@@ -592,11 +645,17 @@ void w25n01g_addError(uint32_t address, uint8_t code)
 // (2) "Read Data" command is executed for bytes not requested and data are discarded
 // (3) "Read Data" command is executed and data are stored directly into caller's buffer
 //
-// Buffered read mode (BUF = 1), non-read ahead
-// (1) If currentBufferPage != requested page, then issue PAGE_DATA_READ on requested page.
+// Buffered read mode (BUF = 1), with read ahead
+// (1) If currentPage != requested page, then issue PAGE_DATA_READ on requested page.
 // (2) Compute transferLength as smaller of remaining length and requested length.
 // (3) Issue READ_DATA on column address.
-// (4) Return transferLength.
+// (4) Check the ECC status if this is the first read from the page.
+// (5) If the end of the page was read, issue PAGE_DATA_READ on the next page without waiting for it, the array read
+//     then overlaps with the caller using the data.
+// (6) Return transferLength.
+//
+// The continuous read mode is not used: it always starts at column 0 and only runs on while CS is held low, which
+// the callers reading in chunks over a shared bus cannot make use of.
 
 int w25n01g_readBytes(flashDevice_t *fdevice, uint32_t address, uint8_t *buffer, int length)
 {
@@ -612,11 +671,15 @@ int w25n01g_readBytes(flashDevice_t *fdevice, uint32_t address, uint8_t *buffer,
         w25n01g_performCommandWithPageAddress(&fdevice->io, W25N01G_INSTRUCTION_PAGE_DATA_READ, targetPage);
 
         w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_PAGE_READ_MS);
-        if (!w25n01g_waitForReady(fdevice)) {
-            return 0;
-        }
 
         currentPage = targetPage;
+        currentPageEccChecked = false;
+    }
+
+    // Wait for the page to be loaded, here or by the read ahead
+    if (!w25n01g_waitForReady(fdevice)) {
+        currentPage = UINT32_MAX;
+        return 0;
     }
 
     uint16_t column = W25N01G_LINEAR_TO_COLUMN(address);
@@ -637,9 +700,10 @@ int w25n01g_readBytes(flashDevice_t *fdevice, uint32_t address, uint8_t *buffer,
         cmd[2] = (column >> 0) & 0xff;
         cmd[3] = 0;
 
+        // Only the rest of the loaded page is valid, the caller continues with the next page
         ENABLE(busdev);
         spiTransfer(busdev->busdev_u.spi.instance, cmd, NULL, sizeof(cmd));
-        spiTransfer(busdev->busdev_u.spi.instance, NULL, buffer, length);
+        spiTransfer(busdev->busdev_u.spi.instance, NULL, buffer, transferLength);
         DISABLE(busdev);
 
     }
@@ -647,31 +711,42 @@ int w25n01g_readBytes(flashDevice_t *fdevice, uint32_t address, uint8_t *buffer,
     else if (fdevice->io.mode == FLASHIO_QUADSPI) {
         QUADSPI_TypeDef *quadSpi = fdevice->io.handle.quadSpi;
 
-        //quadSpiReceiveWithAddress1LINE(quadSpi, W25N01G_INSTRUCTION_READ_DATA, 8, column, W28N01G_STATUS_COLUMN_ADDRESS_SIZE, buffer, length);
-        quadSpiReceiveWithAddress4LINES(quadSpi, W25N01G_INSTRUCTION_FAST_READ_QUAD_OUTPUT, 8, column, W28N01G_STATUS_COLUMN_ADDRESS_SIZE, buffer, length);
+        //quadSpiReceiveWithAddress1LINE(quadSpi, W25N01G_INSTRUCTION_READ_DATA, 8, column, W28N01G_STATUS_COLUMN_ADDRESS_SIZE, buffer, transferLength);
+        quadSpiReceiveWithAddress4LINES(quadSpi, W25N01G_INSTRUCTION_FAST_READ_QUAD_OUTPUT, 8, column, W28N01G_STATUS_COLUMN_ADDRESS_SIZE, buffer, transferLength);
     }
 #endif
 
-    // XXX Don't need this?
-    w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_PAGE_READ_MS);
-    if (!w25n01g_waitForReady(fdevice)) {
-        return 0;
+    // Check ECC, the status stays valid until the next page is loaded
+
+    if (!currentPageEccChecked) {
+        currentPageEccChecked = true;
+
+        uint8_t statReg = w25n01g_readRegister(&fdevice->io, W25N01G_STAT_REG);
+        uint8_t eccCode = W25N01G_STATUS_FLAG_ECC(statReg);
+
+        switch (eccCode) {
+        case 0: // Successful read, no ECC correction
+            break;
+        case 1: // Successful read with ECC correction
+        case 2: // Uncorrectable ECC in a single page
+        case 3: // Uncorrectable ECC in multiple pages
+            w25n01g_addError(address, eccCode);
+            w25n01g_deviceReset(fdevice);
+            currentPage = UINT32_MAX;
+            return transferLength;
+        }
     }
 
-    // Check ECC
+    // Read ahead the next page, unless the data buffer holds data to be programmed
+    const uint32_t nextPage = targetPage + 1;
 
-    uint8_t statReg = w25n01g_readRegister(&fdevice->io, W25N01G_STAT_REG);
-    uint8_t eccCode = W25N01G_STATUS_FLAG_ECC(statReg);
+    if (column + transferLength == W25N01G_PAGE_SIZE && !bufferDirty && nextPage < W25N01G_LINEAR_TO_PAGE(fdevice->geometry.totalSize)) {
+        w25n01g_performCommandWithPageAddress(&fdevice->io, W25N01G_INSTRUCTION_PAGE_DATA_READ, nextPage);
 
-    switch (eccCode) {
-    case 0: // Successful read, no ECC correction
-        break;
-    case 1: // Successful read with ECC correction
-    case 2: // Uncorrectable ECC in a single page
-    case 3: // Uncorrectable ECC in multiple pages
-        w25n01g_addError(address, eccCode);
-        w25n01g_deviceReset(fdevice);
-        break;
+        w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_PAGE_READ_MS);
+
+        currentPage = nextPage;
+        currentPageEccChecked = false;
     }
 
     return transferLength;
@@ -684,8 +759,16 @@ int w25n01g_readExtensionBytes(flashDevice_t *fdevice, uint32_t address, uint8_t
         return 0;
     }
 
+    // The data buffer no longer holds the page last read
+    currentPage = UINT32_MAX;
+
     w25n01g_performCommandWithPageAddress(&fdevice->io, W25N01G_INSTRUCTION_PAGE_DATA_READ, W25N01G_LINEAR_TO_PAGE(address));
 
+    w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_PAGE_READ_MS);
+    if (!w25n01g_waitForReady(fdevice)) {
+        return 0;
+    }
+
     uint32_t column = 2048;
 
     if (fdevice->io.mode == FLASHIO_SPI) {
@@ -759,8 +842,8 @@ void w25n01g_readBBLUT(flashDevice_t *fdevice, bblut_t *bblut, int lutsize)
 
         for (int i = 0 ; i < lutsize ; i++) {
             spiTransfer(busdev->busdev_u.spi.instance, NULL, in, 4);
-            bblut[i].pba = (in[0] << 16)|in[1];
-            bblut[i].lba = (in[2] << 16)|in[3];
+            bblut[i].lba = (in[0] << 8)|in[1];
+            bblut[i].pba = (in[2] << 8)|in[3];
         }
 
         DISABLE(busdev);
@@ -777,8 +860,8 @@ void w25n01g_readBBLUT(flashDevice_t *fdevice, bblut_t *bblut, int lutsize)
 
         for (int i = 0, offset = 0 ; i < lutsize ; i++, offset += 4) {
             if (i < W25N01G_BBLUT_TABLE_ENTRY_COUNT) {
-                bblut[i].pba = (in[offset + 0] << 16)|in[offset + 1];
-                bblut[i].lba = (in[offset + 2] << 16)|in[offset + 3];
+                bblut[i].lba = (bblutBuffer[offset + 0] << 8)|bblutBuffer[offset + 1];
+                bblut[i].pba = (bblutBuffer[offset + 2] << 8)|bblutBuffer[offset + 3];
             }
         }
     }
@@ -810,8 +893,106 @@ void w25n01g_writeBBLUT(flashDevice_t *fdevice, uint16_t lba, uint16_t pba)
     w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_PAGE_PROGRAM_MS);
 }
 
+/**
+ * Find the first good block of the replacement area that the bad block LUT does not link to yet.
+ *
+ * Returns 0 if there is none left, block 0 is never in the replacement area.
+ */
+static uint16_t w25n01g_findReplacementBlock(flashDevice_t *fdevice)
+{
+    bblut_t bblut[W25N01G_BBLUT_TABLE_ENTRY_COUNT];
+
+    w25n01g_readBBLUT(fdevice, bblut, W25N01G_BBLUT_TABLE_ENTRY_COUNT);
+
+    for (uint16_t block = W25N01G_BB_REPLACEMENT_START_BLOCK; block < W25N01G_BLOCKS_PER_DIE; block++) {
+        bool linked = false;
+
+        for (int i = 0; i < W25N01G_BBLUT_TABLE_ENTRY_COUNT; i++) {
+            if ((bblut[i].lba & W25N01G_BBLUT_STATUS_ENABLED) && bblut[i].pba == block) {
+                linked = true;
+                break;
+            }
+        }
+
+        if (linked) {
+            continue;
+        }
+
+        // Factory bad blocks have their bad block marker, the first spare byte of the first page, cleared
+        uint8_t marker;
+
+        if (w25n01g_readExtensionBytes(fdevice, W25N01G_BLOCK_TO_LINEAR(block), &marker, sizeof(marker)) == sizeof(marker) && marker == 0xff) {
+            return block;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Link the block holding the page of a failed erase or program to a good block of the replacement area in the bad
+ * block LUT, so that the chip uses the good block from now on.
+ *
+ * If the program failed, the data buffer still holds the data of the page. It is programmed into the replacement
+ * block first, then the pages written before it are moved across inside the chip. This is SLC NAND, so the pages
+ * of a block need not be programmed in order. If the erase failed, the erase is started again on the replacement
+ * block without waiting for it.
+ *
+ * Returns false if there are no replacement blocks or LUT entries left.
+ */
+static bool w25n01g_replaceFailedBlock(flashDevice_t *fdevice, uint32_t page, bool isErase)
+{
+    flashDeviceIO_t *io = &fdevice->io;
+
+    if (w25n01g_readRegister(io, W25N01G_STAT_REG) & W25N01G_STATUS_BBM_LUT_FULL) {
+        return false;
+    }
+
+    const uint32_t pba = replacementBlock;
+
+    if (!pba) {
+        return false;
+    }
+
+    const uint32_t block = page / W25N01G_PAGES_PER_BLOCK;
+
+    if (!isErase) {
+        const uint32_t pageInBlock = page % W25N01G_PAGES_PER_BLOCK;
+
+        w25n01g_writeEnable(fdevice);
+        w25n01g_performCommandWithPageAddress(io, W25N01G_INSTRUCTION_PROGRAM_EXECUTE, W25N01G_BLOCK_TO_PAGE(pba) + pageInBlock);
+        w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_PAGE_PROGRAM_MS);
+
+        for (uint32_t i = 0; i < pageInBlock; i++) {
+            w25n01g_waitForReady(fdevice);
+            w25n01g_performCommandWithPageAddress(io, W25N01G_INSTRUCTION_PAGE_DATA_READ, W25N01G_BLOCK_TO_PAGE(block) + i);
+            w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_PAGE_READ_MS);
+
+            w25n01g_waitForReady(fdevice);
+            w25n01g_writeEnable(fdevice);
+            w25n01g_performCommandWithPageAddress(io, W25N01G_INSTRUCTION_PROGRAM_EXECUTE, W25N01G_BLOCK_TO_PAGE(pba) + i);
+            w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_PAGE_PROGRAM_MS);
+        }
+
+        currentPage = UINT32_MAX;
+    }
+
+    w25n01g_waitForReady(fdevice);
+    w25n01g_writeEnable(fdevice);
+    w25n01g_writeBBLUT(fdevice, block, pba);
+    w25n01g_waitForReady(fdevice);
+
+    replacementBlock = w25n01g_findReplacementBlock(fdevice);
+
+    if (isErase) {
+        w25n01g_eraseSector(fdevice, W25N01G_BLOCK_TO_LINEAR(block));
+    }
+
+    return true;
+}
+
 static void w25n01g_deviceInit(flashDevice_t *flashdev)
 {
-    UNUSED(flashdev);
+    replacementBlock = w25n01g_findReplacementBlock(flashdev);
 }
 #endif
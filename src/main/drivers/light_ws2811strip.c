@@ -38,21 +38,14 @@
 
 #include "common/color.h"
 #include "common/colorconversion.h"
+#include "common/utils.h"
 
 #include "drivers/dma.h"
 #include "drivers/io.h"
 
 #include "light_ws2811strip.h"
 
-#if defined(STM32F1) || defined(STM32F3)
-uint8_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
-#elif defined(STM32F7)
-FAST_DATA_ZERO_INIT uint32_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
-#elif defined(STM32H7)
-DMA_RAM uint32_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
-#else
-uint32_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
-#endif
+DMA_BUFFER_W ws2811DmaBufferElement_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
 
 static ioTag_t ledStripIoTag;
 static bool ws2811Initialised = false;
@@ -63,14 +56,37 @@ static bool needsFullRefresh = true;
 uint16_t BIT_COMPARE_1 = 0;
 uint16_t BIT_COMPARE_0 = 0;
 
+// compare values for the four bits of each nibble, most significant bit first
+static ws2811DmaBufferElement_t nibbleCompareValues[16][4];
+
 static hsvColor_t ledColorBuffer[WS2811_DATA_BUFFER_SIZE];
 
 #if !defined(USE_WS2811_SINGLE_COLOUR)
-void setLedHsv(uint16_t index, const hsvColor_t *color)
+// LEDs whose colour changed since they were last encoded into the DMA buffer
+STATIC_ASSERT(WS2811_DATA_BUFFER_SIZE <= 32, ws2811_dirty_mask_too_small);
+static uint32_t ledDirtyMask = 0;
+static ledStripFormatRGB_e encodedLedFormat = LED_GRB;
+// the LEDs past the used count still hold encoded data that must be cleared for the reset delay
+static bool needsTrailerClear = false;
+#endif
+
+static void setLedColor(uint16_t index, const hsvColor_t *color)
 {
+#if !defined(USE_WS2811_SINGLE_COLOUR)
+    hsvColor_t *ledColor = &ledColorBuffer[index];
+    if (ledColor->h != color->h || ledColor->s != color->s || ledColor->v != color->v) {
+        ledDirtyMask |= 1U << index;
+    }
+#endif
     ledColorBuffer[index] = *color;
 }
 
+#if !defined(USE_WS2811_SINGLE_COLOUR)
+void setLedHsv(uint16_t index, const hsvColor_t *color)
+{
+    setLedColor(index, color);
+}
+
 void getLedHsv(uint16_t index, hsvColor_t *color)
 {
     *color = ledColorBuffer[index];
@@ -78,19 +94,23 @@ void getLedHsv(uint16_t index, hsvColor_t *color)
 
 void setLedValue(uint16_t index, const uint8_t value)
 {
-    ledColorBuffer[index].v = value;
+    hsvColor_t color = ledColorBuffer[index];
+    color.v = value;
+    setLedColor(index, &color);
 }
 
 void scaleLedValue(uint16_t index, const uint8_t scalePercent)
 {
-    ledColorBuffer[index].v = ((uint16_t)ledColorBuffer[index].v * scalePercent / 100);
+    hsvColor_t color = ledColorBuffer[index];
+    color.v = ((uint16_t)color.v * scalePercent / 100);
+    setLedColor(index, &color);
 }
 #endif
 
 void setStripColor(const hsvColor_t *color)
 {
     for (unsigned index = 0; index < usedLedCount; index++) {
-        ledColorBuffer[index] = *color;
+        setLedColor(index, color);
     }
 }
 
@@ -117,6 +137,15 @@ void ws2811LedStripInit(ioTag_t ioTag)
     ledStripIoTag = ioTag;
 }
 
+static void initNibbleCompareValues(void)
+{
+    for (unsigned nibble = 0; nibble < ARRAYLEN(nibbleCompareValues); nibble++) {
+        for (unsigned bit = 0; bit < 4; bit++) {
+            nibbleCompareValues[nibble][bit] = (nibble & (0x8 >> bit)) ? BIT_COMPARE_1 : BIT_COMPARE_0;
+        }
+    }
+}
+
 void ws2811LedStripEnable(void)
 {
     if (!ws2811Initialised) {
@@ -124,6 +153,8 @@ void ws2811LedStripEnable(void)
             return;
         }
 
+        initNibbleCompareValues();
+
         const hsvColor_t hsv_black = { 0, 0, 0 };
         setStripColor(&hsv_black);
         // RGB or GRB ordering doesn't matter for black
@@ -154,9 +185,10 @@ STATIC_UNIT_TESTED void updateLEDDMABuffer(ledStripFormatRGB_e ledFormat, rgbCol
         break;
     }
 
-    unsigned dmaBufferOffset = 0;
-    for (int index = 23; index >= 0; index--) {
-        ledStripDMABuffer[ledIndex * WS2811_BITS_PER_LED + dmaBufferOffset++] = (packed_colour & (1 << index)) ? BIT_COMPARE_1 : BIT_COMPARE_0;
+    ws2811DmaBufferElement_t *dmaBuffer = &ledStripDMABuffer[ledIndex * WS2811_BITS_PER_LED];
+    for (int shift = 20; shift >= 0; shift -= 4) {
+        memcpy(dmaBuffer, nibbleCompareValues[(packed_colour >> shift) & 0xf], sizeof(nibbleCompareValues[0]));
+        dmaBuffer += 4;
     }
 }
 
@@ -171,21 +203,55 @@ void ws2811UpdateStrip(ledStripFormatRGB_e ledFormat)
         return;
     }
 
-    unsigned ledIndex = 0;              // reset led index
-
-    // fill transmit buffer with correct compare values to achieve
-    // correct pulse widths according to color values
-    const unsigned ledUpdateCount = needsFullRefresh ? WS2811_DATA_BUFFER_SIZE : usedLedCount;
     const hsvColor_t hsvBlack = { 0, 0, 0 };
-    while (ledIndex < ledUpdateCount) {
-        rgbColor24bpp_t *rgb24 = hsvToRgb24(ledIndex < usedLedCount ? &ledColorBuffer[ledIndex] : &hsvBlack);
 
-        updateLEDDMABuffer(ledFormat, rgb24, ledIndex++);
+#if defined(USE_WS2811_SINGLE_COLOUR)
+    // the DMA handler clears the buffer to generate the reset delay, so encode it on every update
+    updateLEDDMABuffer(ledFormat, hsvToRgb24(usedLedCount ? &ledColorBuffer[0] : &hsvBlack), 0);
+    const uint16_t dmaBufferLength = WS2811_DMA_BUFFER_SIZE;
+#else
+    uint16_t dmaBufferLength;
+
+    if (needsFullRefresh) {
+        // fill transmit buffer with correct compare values to achieve
+        // correct pulse widths according to color values
+        for (unsigned ledIndex = 0; ledIndex < WS2811_DATA_BUFFER_SIZE; ledIndex++) {
+            rgbColor24bpp_t *rgb24 = hsvToRgb24(ledIndex < usedLedCount ? &ledColorBuffer[ledIndex] : &hsvBlack);
+
+            updateLEDDMABuffer(ledFormat, rgb24, ledIndex);
+        }
+        dmaBufferLength = WS2811_DMA_BUFFER_SIZE;
+
+        needsFullRefresh = false;
+        needsTrailerClear = usedLedCount < WS2811_DATA_BUFFER_SIZE;
+        ledDirtyMask = 0;
+        encodedLedFormat = ledFormat;
+    } else {
+        if (needsTrailerClear) {
+            // the unused LEDs have been turned off, shorten the transfer to end with the reset delay after the used ones
+            memset(&ledStripDMABuffer[usedLedCount * WS2811_BITS_PER_LED], 0, (WS2811_DATA_BUFFER_SIZE - usedLedCount) * WS2811_BITS_PER_LED * sizeof(ledStripDMABuffer[0]));
+            needsTrailerClear = false;
+        }
+
+        if (ledFormat != encodedLedFormat) {
+            ledDirtyMask = ~0U;
+            encodedLedFormat = ledFormat;
+        }
+
+        // only re-encode the LEDs that changed since the last update
+        for (unsigned ledIndex = 0; ledIndex < usedLedCount; ledIndex++) {
+            if (ledDirtyMask & (1U << ledIndex)) {
+                updateLEDDMABuffer(ledFormat, hsvToRgb24(&ledColorBuffer[ledIndex]), ledIndex);
+            }
+        }
+        ledDirtyMask = 0;
+
+        dmaBufferLength = usedLedCount * WS2811_BITS_PER_LED + WS2811_DELAY_BUFFER_LENGTH;
     }
-    needsFullRefresh = false;
+#endif
 
     ws2811LedDataTransferInProgress = true;
-    ws2811LedStripDMAEnable();
+    ws2811LedStripDMAEnable(dmaBufferLength);
 }
 
 #endif
@@ -41,6 +41,14 @@
 #define WS2811_DMA_BUFFER_SIZE     (WS2811_DATA_BUFFER_SIZE * WS2811_BITS_PER_LED + WS2811_DELAY_BUFFER_LENGTH)
 #endif
 
+// F1/F3 DMA zero extends byte reads into the timer compare register, later DMA controllers
+// pack them instead so need word writes to drive 32 bit timers
+#if defined(STM32F1) || defined(STM32F3)
+typedef uint8_t ws2811DmaBufferElement_t;
+#else
+typedef uint32_t ws2811DmaBufferElement_t;
+#endif
+
 #define WS2811_TIMER_MHZ           48
 #define WS2811_CARRIER_HZ          800000
 
@@ -54,7 +62,7 @@ void ws2811LedStripInit(ioTag_t ioTag);
 void ws2811LedStripEnable(void);
 
 bool ws2811LedStripHardwareInit(ioTag_t ioTag);
-void ws2811LedStripDMAEnable(void);
+void ws2811LedStripDMAEnable(uint16_t dmaBufferLength);
 
 void ws2811UpdateStrip(ledStripFormatRGB_e ledFormat);
 
@@ -71,11 +79,7 @@ void setUsedLedCount(unsigned ledCount);
 
 bool isWS2811LedStripReady(void);
 
-#if defined(STM32F1) || defined(STM32F3)
-extern uint8_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
-#else
-extern uint32_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
-#endif
+extern ws2811DmaBufferElement_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
 extern volatile bool ws2811LedDataTransferInProgress;
 
 extern uint16_t BIT_COMPARE_1;
@@ -176,9 +176,9 @@ bool ws2811LedStripHardwareInit(ioTag_t ioTag)
     return true;
 }
 
-void ws2811LedStripDMAEnable(void)
+void ws2811LedStripDMAEnable(uint16_t dmaBufferLength)
 {
-    if (DMA_SetCurrDataCounter(&TimHandle, timerChannel, ledStripDMABuffer, WS2811_DMA_BUFFER_SIZE) != HAL_OK) {
+    if (DMA_SetCurrDataCounter(&TimHandle, timerChannel, ledStripDMABuffer, dmaBufferLength) != HAL_OK) {
         /* DMA set error */
         ws2811LedDataTransferInProgress = false;
         return;
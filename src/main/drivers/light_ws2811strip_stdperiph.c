@@ -214,9 +214,9 @@ bool ws2811LedStripHardwareInit(ioTag_t ioTag)
     return true;
 }
 
-void ws2811LedStripDMAEnable(void)
+void ws2811LedStripDMAEnable(uint16_t dmaBufferLength)
 {
-    xDMA_SetCurrDataCounter(dmaRef, WS2811_DMA_BUFFER_SIZE);  // load number of bytes to be transferred
+    xDMA_SetCurrDataCounter(dmaRef, dmaBufferLength);  // load number of bytes to be transferred
     TIM_SetCounter(timer, 0);
     TIM_Cmd(timer, ENABLE);
     xDMA_Cmd(dmaRef, ENABLE);
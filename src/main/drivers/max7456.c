@@ -28,6 +28,9 @@
 
 #include "build/debug.h"
 
+#include "common/arena.h"
+#include "common/maths.h"
+
 #include "pg/max7456.h"
 #include "pg/vcd.h"
 
@@ -182,18 +185,18 @@
 #ifdef USE_SPI_TRANSACTION
     #define __spiBusTransactionBegin(busdev)        spiBusTransactionBegin(busdev)
     #define __spiBusTransactionEnd(busdev)          spiBusTransactionEnd(busdev)
+    #define __spiBusTransactionYield(busdev)        spiBusTransactionYield(busdev)
 #else
     #define __spiBusTransactionBegin(busdev)        {spiBusSetDivisor(busdev, max7456SpiClock);IOLo((busdev)->busdev_u.spi.csnPin);}
     #define __spiBusTransactionEnd(busdev)       {IOHi((busdev)->busdev_u.spi.csnPin);spiSetDivisor((busdev)->busdev_u.spi.instance, spiCalculateDivider(MAX7456_MAX_SPI_SHARED_CLK));}
+    #define __spiBusTransactionYield(busdev)
 #endif
 
-#define MAX7456_SUPPORTED_LAYER_COUNT (DISPLAYPORT_LAYER_BACKGROUND + 1)
-
 typedef struct max7456Layer_s {
     uint8_t buffer[VIDEO_BUFFER_CHARS_PAL];
 } max7456Layer_t;
 
-static max7456Layer_t displayLayers[MAX7456_SUPPORTED_LAYER_COUNT];
+static max7456Layer_t *displayLayers;
 static displayPortLayer_e activeLayer = DISPLAYPORT_LAYER_FOREGROUND;
 
 busDevice_t max7456BusDevice;
@@ -208,11 +211,23 @@ uint16_t maxScreenSize = VIDEO_BUFFER_CHARS_PAL;
 // it with shadowBuffer to update only changed chars.
 // This solution is faster then redrawing entire screen.
 
-static uint8_t shadowBuffer[VIDEO_BUFFER_CHARS_PAL];
+static uint8_t *shadowBuffer;
+
+// One bit per character for each line that may differ from shadowBuffer, so a screen
+// update only compares the characters written since the last one.
+static uint32_t dirtyLines[VIDEO_LINES_PAL];
+#define DIRTY_LINE_ALL ((1U << CHARS_PER_LINE) - 1)
 
 //Max chars to update in one idle
 
 #define MAX_CHARS2UPDATE    100
+
+// A run of changed characters this long or longer costs fewer SPI bytes in auto-increment mode,
+// 10 bytes of setup and 2 per character against 6 per character with direct addressing
+#define AUTO_INCREMENT_MIN_RUN 3
+
+// Each character is written on its own, so a screen update can hand the bus to the gyro after this many
+#define CHARS_PER_BUS_YIELD 8
 #ifdef MAX7456_DMA_CHANNEL_TX
 volatile bool dmaTransactionInProgress = false;
 #endif
@@ -227,6 +242,7 @@ static uint8_t  hosRegValue; // HOS (Horizontal offset register) value
 static uint8_t  vosRegValue; // VOS (Vertical offset register) value
 
 static bool fontIsLoading       = false;
+static bool fontNvmWriteInProgress = false;
 
 static uint8_t max7456DeviceType;
 
@@ -376,9 +392,17 @@ uint8_t max7456GetRowsCount(void)
 
 // When clearing the shadow buffer we fill with 0 so that the characters will
 // be flagged as changed when compared to the 0x20 used in the layer buffers.
+static void max7456MarkAllDirty(void)
+{
+    for (int y = 0; y < VIDEO_LINES_PAL; y++) {
+        dirtyLines[y] = DIRTY_LINE_ALL;
+    }
+}
+
 static void max7456ClearShadowBuffer(void)
 {
     memset(shadowBuffer, 0, maxScreenSize);
+    max7456MarkAllDirty();
 }
 
 // Buffer is filled with the whitespace character (0x20)
@@ -460,17 +484,27 @@ max7456InitStatus_e max7456Init(const max7456Config_t *max7456Config, const vcdP
     max7456SpiClock = spiCalculateDivider(MAX7456_MAX_SPI_CLK_HZ);
     max7456DeviceDetected = false;
 
-    // initialize all layers
-    for (unsigned i = 0; i < MAX7456_SUPPORTED_LAYER_COUNT; i++) {
-        max7456ClearLayer(i);
-    }
-
     max7456HardwareReset();
 
     if (!max7456Config->csTag || !max7456Config->spiDevice) {
         return MAX7456_INIT_NOT_CONFIGURED;
     }
 
+    // A device that is not found yet is initialised again later, the buffers are claimed once
+    if (!displayLayers) {
+        uint8_t *buffers = arenaAlloc(ARENA_OWNER_MAX7456, MAX7456_BUFFER_SIZE);
+        if (!buffers) {
+            return MAX7456_INIT_NOT_CONFIGURED;
+        }
+        displayLayers = (max7456Layer_t *)buffers;
+        shadowBuffer = buffers + MAX7456_SUPPORTED_LAYER_COUNT * sizeof(max7456Layer_t);
+    }
+
+    // initialize all layers
+    for (unsigned i = 0; i < MAX7456_SUPPORTED_LAYER_COUNT; i++) {
+        max7456ClearLayer(i);
+    }
+
     busdev->busdev_u.spi.csnPin = IOGetByTag(max7456Config->csTag);
 
     if (!IOIsFreeOrPreinit(busdev->busdev_u.spi.csnPin)) {
@@ -614,6 +648,7 @@ void max7456Brightness(uint8_t black, uint8_t white)
 void max7456ClearScreen(void)
 {
     max7456ClearLayer(activeLayer);
+    max7456MarkAllDirty();
 }
 
 void max7456WriteChar(uint8_t x, uint8_t y, uint8_t c)
@@ -621,6 +656,7 @@ void max7456WriteChar(uint8_t x, uint8_t y, uint8_t c)
     uint8_t *buffer = getActiveLayerBuffer();
     if (x < CHARS_PER_LINE && y < VIDEO_LINES_PAL) {
         buffer[y * CHARS_PER_LINE + x] = c;
+        dirtyLines[y] |= 1U << x;
     }
 }
 
@@ -628,9 +664,13 @@ void max7456Write(uint8_t x, uint8_t y, const char *buff)
 {
     if (y < VIDEO_LINES_PAL) {
         uint8_t *buffer = getActiveLayerBuffer();
-        for (int i = 0; buff[i] && x + i < CHARS_PER_LINE; i++) {
+        int i;
+        for (i = 0; buff[i] && x + i < CHARS_PER_LINE; i++) {
             buffer[y * CHARS_PER_LINE + x + i] = buff[i];
         }
+        if (i) {
+            dirtyLines[y] |= ((1U << i) - 1) << x;
+        }
     }
 }
 
@@ -647,6 +687,7 @@ bool max7456LayerSelect(displayPortLayer_e layer)
 {
     if (max7456LayerSupported(layer)) {
         activeLayer = layer;
+        max7456MarkAllDirty();
         return true;
     } else {
         return false;
@@ -657,6 +698,7 @@ bool max7456LayerCopy(displayPortLayer_e destLayer, displayPortLayer_e sourceLay
 {
     if ((sourceLayer != destLayer) && max7456LayerSupported(sourceLayer) && max7456LayerSupported(destLayer)) {
         memcpy(getLayerBuffer(destLayer), getLayerBuffer(sourceLayer), VIDEO_BUFFER_CHARS_PAL);
+        max7456MarkAllDirty();
         return true;
     } else {
         return false;
@@ -737,10 +779,41 @@ void max7456ReInitIfRequired(bool forceStallCheck)
     //------------   end of (re)init-------------------------------------
 }
 
-void max7456DrawScreen(void)
+// Queue the changed characters at pos into spiBuff, in auto-increment mode when there are enough of them.
+// Returns the new buff_len.
+static int max7456QueueRun(const uint8_t *buffer, uint16_t pos, int runLength, int buff_len)
 {
-    static uint16_t pos = 0;
+    if (runLength < AUTO_INCREMENT_MIN_RUN) {
+        for (int i = pos; i < pos + runLength; i++) {
+            spiBuff[buff_len++] = MAX7456ADD_DMAH;
+            spiBuff[buff_len++] = i >> 8;
+            spiBuff[buff_len++] = MAX7456ADD_DMAL;
+            spiBuff[buff_len++] = i & 0xff;
+            spiBuff[buff_len++] = MAX7456ADD_DMDI;
+            spiBuff[buff_len++] = buffer[i];
+        }
+    } else {
+        spiBuff[buff_len++] = MAX7456ADD_DMAH;
+        spiBuff[buff_len++] = pos >> 8;
+        spiBuff[buff_len++] = MAX7456ADD_DMAL;
+        spiBuff[buff_len++] = pos & 0xff;
+        spiBuff[buff_len++] = MAX7456ADD_DMM;
+        spiBuff[buff_len++] = displayMemoryModeReg | 1;
+        for (int i = pos; i < pos + runLength; i++) {
+            spiBuff[buff_len++] = MAX7456ADD_DMDI;
+            spiBuff[buff_len++] = buffer[i];
+        }
+        spiBuff[buff_len++] = MAX7456ADD_DMDI;
+        spiBuff[buff_len++] = END_STRING;
+        spiBuff[buff_len++] = MAX7456ADD_DMM;
+        spiBuff[buff_len++] = displayMemoryModeReg;
+    }
 
+    return buff_len;
+}
+
+void max7456DrawScreen(void)
+{
     if (!fontIsLoading) {
 
         // (Re)Initialize MAX7456 at startup or stall is detected.
@@ -750,20 +823,37 @@ void max7456DrawScreen(void)
         uint8_t *buffer = getActiveLayerBuffer();
 
         int buff_len = 0;
-        for (int k = 0; k < MAX_CHARS2UPDATE; k++) {
-            if (buffer[pos] != shadowBuffer[pos]) {
-                spiBuff[buff_len++] = MAX7456ADD_DMAH;
-                spiBuff[buff_len++] = pos >> 8;
-                spiBuff[buff_len++] = MAX7456ADD_DMAL;
-                spiBuff[buff_len++] = pos & 0xff;
-                spiBuff[buff_len++] = MAX7456ADD_DMDI;
-                spiBuff[buff_len++] = buffer[pos];
-                shadowBuffer[pos] = buffer[pos];
-            }
+        int charsToUpdate = MAX_CHARS2UPDATE;
+        const int lines = maxScreenSize / CHARS_PER_LINE;
+        for (int y = 0; y < lines && charsToUpdate; y++) {
+            while (dirtyLines[y] && charsToUpdate) {
+                const int x = __builtin_ctz(dirtyLines[y]);
+                const uint16_t pos = y * CHARS_PER_LINE + x;
+
+                // the run is the changed characters from x up to the first unchanged one. The 0xFF character
+                // ends auto-increment mode, so it is only ever sent as a run of its own.
+                int runLength = 0;
+                while (x + runLength < CHARS_PER_LINE && runLength < charsToUpdate) {
+                    const uint16_t runPos = pos + runLength;
+                    if (!(dirtyLines[y] & (1U << (x + runLength))) || buffer[runPos] == shadowBuffer[runPos]
+                        || (runLength && buffer[runPos] == END_STRING)) {
+                        break;
+                    }
+                    shadowBuffer[runPos] = buffer[runPos];
+                    runLength++;
+                    if (buffer[runPos] == END_STRING) {
+                        break;
+                    }
+                }
 
-            if (++pos >= maxScreenSize) {
-                pos = 0;
-                break;
+                if (runLength) {
+                    buff_len = max7456QueueRun(buffer, pos, runLength, buff_len);
+                    charsToUpdate -= runLength;
+                    dirtyLines[y] &= ~(((1U << runLength) - 1) << x);
+                } else {
+                    // written but unchanged
+                    dirtyLines[y] &= ~(1U << x);
+                }
             }
         }
 
@@ -772,7 +862,12 @@ void max7456DrawScreen(void)
             max7456SendDma(spiBuff, NULL, buff_len);
 #else
             __spiBusTransactionBegin(busdev);
-            spiTransfer(busdev->busdev_u.spi.instance, spiBuff, NULL, buff_len);
+            for (int offset = 0; offset < buff_len; offset += CHARS_PER_BUS_YIELD * 6) {
+                if (offset) {
+                    __spiBusTransactionYield(busdev);
+                }
+                spiTransfer(busdev->busdev_u.spi.instance, spiBuff + offset, NULL, MIN(buff_len - offset, CHARS_PER_BUS_YIELD * 6));
+            }
             __spiBusTransactionEnd(busdev);
 #endif // MAX7456_DMA_CHANNEL_TX
         }
@@ -801,6 +896,7 @@ static void max7456DrawScreenSlow(void)
         }
         shadowBuffer[xx] = buffer[xx];
     }
+    memset(dirtyLines, 0, sizeof(dirtyLines));
 
     max7456Send(MAX7456ADD_DMDI, END_STRING);
     max7456Send(MAX7456ADD_DMM, displayMemoryModeReg);
@@ -842,6 +938,13 @@ bool max7456WriteNvm(uint8_t char_address, const uint8_t *font_data)
 #endif
 
     __spiBusTransactionBegin(busdev);
+
+    // The previous character is stored while this one is received, so only wait here
+    // until bit 5 in the status register returns to 0 if it hasn't finished yet (12ms)
+    if (fontNvmWriteInProgress) {
+        while ((max7456Send(MAX7456ADD_STAT, 0x00) & STAT_NVR_BUSY) != 0x00);
+    }
+
     // disable display
     fontIsLoading = true;
     max7456Send(MAX7456ADD_VM0, 0);
@@ -861,10 +964,7 @@ bool max7456WriteNvm(uint8_t char_address, const uint8_t *font_data)
     // Transfer 54 bytes from shadow ram to NVM
 
     max7456Send(MAX7456ADD_CMM, WRITE_NVR);
-
-    // Wait until bit 5 in the status register returns to 0 (12ms)
-
-    while ((max7456Send(MAX7456ADD_STAT, 0x00) & STAT_NVR_BUSY) != 0x00);
+    fontNvmWriteInProgress = true;
 
     __spiBusTransactionEnd(busdev);
     return true;
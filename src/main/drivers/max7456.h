@@ -30,6 +30,10 @@
 #define VIDEO_LINES_NTSC          13
 #define VIDEO_LINES_PAL           16
 
+#define MAX7456_SUPPORTED_LAYER_COUNT (DISPLAYPORT_LAYER_BACKGROUND + 1)
+// The layers and the shadow of the screen contents, claimed from the arena when the chip is configured
+#define MAX7456_BUFFER_SIZE ((MAX7456_SUPPORTED_LAYER_COUNT + 1) * VIDEO_BUFFER_CHARS_PAL)
+
 typedef enum {
     // IO defined and MAX7456 was detected
     MAX7456_INIT_OK = 0,
@@ -46,8 +46,8 @@ mpuRegion_t mpuRegions[] = {
     },
 #endif
     {
-        // DMA transmit buffer in D2 SRAM1
-        // Reading needs cache coherence operation
+        // DMA buffers in D2 SRAM1 (DMA_BUFFER_R/W/RW)
+        // The Cortex-M7 does not cache shareable memory, so no cache coherence operation is needed
         .start      = (uint32_t)&dmaram_start,
         .end        = (uint32_t)&dmaram_end,
         .size       = 0,  // Size determined by ".end"
@@ -65,8 +65,12 @@ void motorWriteAll(float *values)
             return;
         }
 #endif
-        for (int i = 0; i < motorDevice->count; i++) {
-            motorDevice->vTable.write(i, values[i]);
+        if (motorDevice->vTable.writeAll) {
+            motorDevice->vTable.writeAll(values);
+        } else {
+            for (int i = 0; i < motorDevice->count; i++) {
+                motorDevice->vTable.write(i, values[i]);
+            }
         }
         motorDevice->vTable.updateComplete();
     }
@@ -113,6 +117,7 @@ bool checkMotorProtocolEnabled(const motorDevConfig_t *motorDevConfig, bool *isP
     case PWM_TYPE_DSHOT150:
     case PWM_TYPE_DSHOT300:
     case PWM_TYPE_DSHOT600:
+    case PWM_TYPE_DSHOT1200:
     case PWM_TYPE_PROSHOT1000:
         enabled = true;
         isDshot = true;
@@ -38,6 +38,7 @@ typedef enum {
 //    PWM_TYPE_DSHOT1200, removed
     PWM_TYPE_PROSHOT1000,
     PWM_TYPE_DISABLED,
+    PWM_TYPE_DSHOT1200,                     // appended to keep the stored protocol values
     PWM_TYPE_MAX
 } motorPwmProtocolTypes_e;
 
@@ -53,6 +54,7 @@ typedef struct motorVTable_s {
     bool (*updateStart)(void);
     void (*write)(uint8_t index, float value);
     void (*writeInt)(uint8_t index, uint16_t value);
+    void (*writeAll)(float *values);        // Optional, converts and packs all motors in one pass
     void (*updateComplete)(void);
     void (*shutdown)(void);
 
@@ -29,6 +29,12 @@
 #define NVIC_PRIO_DSHOT_DMA                NVIC_BUILD_PRIORITY(2, 1)
 #define NVIC_PRIO_TRANSPONDER_DMA          NVIC_BUILD_PRIORITY(3, 0)
 #define NVIC_PRIO_MPU_INT_EXTI             NVIC_BUILD_PRIORITY(0x0f, 0x0f)
+#ifdef USE_GYRO_EXTI_REALTIME
+#define NVIC_PRIO_GYRO_INT_EXTI            NVIC_BUILD_PRIORITY(3, 0)  // gyro, filter and PID tasks run from the data ready interrupt
+#else
+#define NVIC_PRIO_GYRO_INT_EXTI            NVIC_PRIO_MPU_INT_EXTI
+#endif
+#define NVIC_PRIO_SPI_DMA                  NVIC_BUILD_PRIORITY(2, 0)  // above the gyro interrupt, which may wait for a sequence to complete
 #define NVIC_PRIO_MAG_INT_EXTI             NVIC_BUILD_PRIORITY(0x0f, 0x0f)
 #define NVIC_PRIO_WS2811_DMA               NVIC_BUILD_PRIORITY(1, 2)  // TODO - is there some reason to use high priority? (or to use DMA IRQ at all?)
 #define NVIC_PRIO_SERIALUART_TXDMA         NVIC_BUILD_PRIORITY(1, 1)  // Highest of all SERIALUARTx_TXDMA
@@ -64,6 +70,7 @@
 #define NVIC_PRIO_MPU_DATA_READY           NVIC_BUILD_PRIORITY(0x0f, 0x0f)
 #define NVIC_PRIO_MAG_DATA_READY           NVIC_BUILD_PRIORITY(0x0f, 0x0f)
 #define NVIC_PRIO_CALLBACK                 NVIC_BUILD_PRIORITY(0x0f, 0x0f)
+#define NVIC_PRIO_DISPATCH                 NVIC_BUILD_PRIORITY(3, 3)  // PendSV for urgent dispatch entries, does not preempt the gyro interrupt
 #define NVIC_PRIO_MAX7456_DMA              NVIC_BUILD_PRIORITY(3, 0)
 #define NVIC_PRIO_SDIO_DMA                 NVIC_BUILD_PRIORITY(0, 0)
 
@@ -37,6 +37,11 @@ typedef enum {
 #endif
     PERSISTENT_OBJECT_RTC_HIGH,           // high 32 bits of rtcTime_t
     PERSISTENT_OBJECT_RTC_LOW,            // low 32 bits of rtcTime_t
+    PERSISTENT_OBJECT_FAULT_PC,           // context of the last hard fault, zero if none
+    PERSISTENT_OBJECT_FAULT_LR,
+    PERSISTENT_OBJECT_FAULT_SP,
+    PERSISTENT_OBJECT_FAULT_CFSR,
+    PERSISTENT_OBJECT_FAULT_ADDRESS,      // BFAR or MMFAR when the CFSR marks one of them valid
     PERSISTENT_OBJECT_COUNT,
 #ifdef USE_SPRACING_PERSISTENT_RTC_WORKAROUND
     // On SPRACING H7 firmware use this alternate location for all reset reasons interpreted by this firmware
@@ -37,6 +37,10 @@
 
 FAST_DATA_ZERO_INIT pwmOutputPort_t motors[MAX_SUPPORTED_MOTORS];
 
+// Distinct timers driving the motors, forced to overflow together to start the OneShot/Multishot pulses
+static FAST_DATA_ZERO_INIT TIM_TypeDef *motorTimers[MAX_SUPPORTED_MOTORS];
+static FAST_DATA_ZERO_INIT uint8_t motorTimerCount;
+
 static void pwmOCConfig(TIM_TypeDef *tim, uint8_t channel, uint16_t value, uint8_t output)
 {
 #if defined(USE_HAL_DRIVER)
@@ -151,10 +155,11 @@ bool pwmIsMotorEnabled(uint8_t index)
 
 static void pwmCompleteOneshotMotorUpdate(void)
 {
+    // The compare registers are preloaded, so the update event latches the new pulse of every channel of a timer at once.
+    // Force all timers before touching any compare register, leaving only a few cycles of skew between timers.
+    timerForceOverflowGroup(motorTimers, motorTimerCount);
+
     for (int index = 0; index < motorPwmDevice.count; index++) {
-        if (motors[index].forceOverflow) {
-            timerForceOverflow(motors[index].channel.tim);
-        }
         // Set the compare register to 0, which stops the output pulsing if the timer overflows before the main loop completes again.
         // This compare register will be set to the output value on the next main loop.
         *motors[index].channel.ccr = 0;
@@ -217,6 +222,7 @@ motorDevice_t *motorPwmDevInit(const motorDevConfig_t *motorConfig, uint16_t idl
     motorPwmDevice.vTable.write = pwmWriteStandard;
     motorPwmDevice.vTable.updateStart = motorUpdateStartNull;
     motorPwmDevice.vTable.updateComplete = useUnsyncedPwm ? motorUpdateCompleteNull : pwmCompleteOneshotMotorUpdate;
+    motorTimerCount = 0;
 
     for (int motorIndex = 0; motorIndex < MAX_SUPPORTED_MOTORS && motorIndex < motorCount; motorIndex++) {
         const unsigned reorderedMotorIndex = motorConfig->motorOutputReordering[motorIndex];
@@ -261,13 +267,15 @@ motorDevice_t *motorPwmDevInit(const motorDevConfig_t *motorConfig, uint16_t idl
         pwmOutConfig(&motors[motorIndex].channel, timerHardware, hz, period, idlePulse, motorConfig->motorPwmInversion);
 
         bool timerAlreadyUsed = false;
-        for (int i = 0; i < motorIndex; i++) {
-            if (motors[i].channel.tim == motors[motorIndex].channel.tim) {
+        for (int i = 0; i < motorTimerCount; i++) {
+            if (motorTimers[i] == motors[motorIndex].channel.tim) {
                 timerAlreadyUsed = true;
                 break;
             }
         }
-        motors[motorIndex].forceOverflow = !timerAlreadyUsed;
+        if (!timerAlreadyUsed) {
+            motorTimers[motorTimerCount++] = motors[motorIndex].channel.tim;
+        }
         motors[motorIndex].enabled = true;
     }
 
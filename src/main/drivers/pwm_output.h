@@ -50,7 +50,6 @@ typedef struct {
     timerChannel_t channel;
     float pulseScale;
     float pulseOffset;
-    bool forceOverflow;
     bool enabled;
     IO_t io;
 } pwmOutputPort_t;
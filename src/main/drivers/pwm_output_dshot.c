@@ -27,6 +27,7 @@
 #ifdef USE_DSHOT
 
 #include "build/debug.h"
+#include "build/latency.h"
 
 #include "drivers/dma.h"
 #include "drivers/dma_reqmap.h"
@@ -186,6 +187,7 @@ void pwmCompleteDshotMotorUpdate(void)
             dmaMotorTimers[i].timerDmaSources = 0;
         }
     }
+    LATENCY_MARK(LATENCY_STAGE_MOTOR_OUTPUT);
 }
 
 #if defined(STM32F3)
@@ -27,6 +27,7 @@
 #ifdef USE_DSHOT
 
 #include "build/debug.h"
+#include "build/latency.h"
 
 #include "common/time.h"
 
@@ -162,6 +163,7 @@ FAST_CODE void pwmCompleteDshotMotorUpdate(void)
             dmaMotorTimers[i].timerDmaSources = 0;
         }
     }
+    LATENCY_MARK(LATENCY_STAGE_MOTOR_OUTPUT);
 }
 
 FAST_CODE static void motor_DMA_IRQHandler(dmaChannelDescriptor_t* descriptor)
@@ -27,6 +27,8 @@
 
 #ifdef USE_DSHOT
 
+#include "build/latency.h"
+
 #include "drivers/dma_reqmap.h"
 #include "drivers/io.h"
 #include "timer.h"
@@ -150,7 +152,7 @@ FAST_CODE void pwmWriteDshotInt(uint8_t index, uint16_t value)
     }
 
     /*If there is a command ready to go overwrite the value and send that instead*/
-    if (dshotCommandIsProcessing()) {
+    if (dshotCommandIsFrameDue()) {
         value = dshotCommandGetCurrent(index);
         if (value) {
             motor->protocolControl.requestTelemetry = true;
@@ -208,6 +210,7 @@ void pwmCompleteDshotMotorUpdate(void)
     {
         // XXX Empty for non-burst?
     }
+    LATENCY_MARK(LATENCY_STAGE_MOTOR_OUTPUT);
 }
 
 static void motor_DMA_IRQHandler(dmaChannelDescriptor_t* descriptor)
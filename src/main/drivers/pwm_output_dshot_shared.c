@@ -22,6 +22,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <math.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -29,6 +30,8 @@
 
 #include "build/debug.h"
 
+#include "common/utils.h"
+
 #include "drivers/dma.h"
 #include "drivers/dma_reqmap.h"
 #include "drivers/io.h"
@@ -48,6 +51,8 @@
 #include "drivers/dshot_command.h"
 #include "drivers/motor.h"
 
+#include "fc/dispatch.h"
+
 #include "pwm_output_dshot_shared.h"
 
 FAST_DATA_ZERO_INIT uint8_t dmaMotorTimerCount = 0;
@@ -93,7 +98,7 @@ FAST_CODE void pwmWriteDshotInt(uint8_t index, uint16_t value)
     }
 
     /*If there is a command ready to go overwrite the value and send that instead*/
-    if (dshotCommandIsProcessing()) {
+    if (dshotCommandIsFrameDue()) {
         value = dshotCommandGetCurrent(index);
 #ifdef USE_DSHOT_TELEMETRY
         // reset telemetry debug statistics every time telemetry is enabled
@@ -179,30 +184,68 @@ static uint32_t decodeTelemetryPacket(uint32_t buffer[], uint32_t count)
     if ((csum & 0xf) != 0xf) {
         return 0xffff;
     }
-    decodedValue >>= 4;
-
-    if (decodedValue == 0x0fff) {
-        return 0;
-    }
-    decodedValue = (decodedValue & 0x000001ff) << ((decodedValue & 0xfffffe00) >> 9);
-    if (!decodedValue) {
-        return 0xffff;
-    }
-    uint32_t ret = (1000000 * 60 / 100 + decodedValue / 2) / decodedValue;
-    return ret;
+    // Return the 12 bit telemetry value, dshotDecodeTelemetryValue() interprets it
+    return decodedValue >> 4;
 }
 
 #endif
 
 #ifdef USE_DSHOT_TELEMETRY
+/*
+ * Telemetry edges are copied out of the DMA buffers by the motor update on the PID path and decoded later by a
+ * dispatch entry. The copies are overwritten by every update, the decoder just picks up the most recent frames
+ * when it runs.
+ */
+typedef struct dshotTelemetryCapture_s {
+    uint32_t buffer[GCR_TELEMETRY_INPUT_LEN];
+    uint8_t edges;
+} dshotTelemetryCapture_t;
+
+static dshotTelemetryCapture_t dshotTelemetryCapture[MAX_SUPPORTED_MOTORS];
+
+static void dshotDecodeTelemetry(dispatchEntry_t *self)
+{
+    UNUSED(self);
+
+#ifdef USE_DSHOT_TELEMETRY_STATS
+    const timeMs_t currentTimeMs = millis();
+#endif
+    for (int i = 0; i < dshotPwmDevice.count; i++) {
+        dshotTelemetryCapture_t *capture = &dshotTelemetryCapture[i];
+
+        if (capture->edges == 0) {
+            continue;
+        }
+
+        dshotTelemetryState.readCount++;
+        const uint16_t value = decodeTelemetryPacket(capture->buffer, capture->edges);
+
+        const bool validTelemetryPacket = value != 0xffff && dshotDecodeTelemetryValue(i, value);
+        if (!validTelemetryPacket) {
+            dshotTelemetryState.invalidPacketCount++;
+            if (i == 0) {
+                memcpy(dshotTelemetryState.inputBuffer, capture->buffer, sizeof(dshotTelemetryState.inputBuffer));
+            }
+        }
+#ifdef USE_DSHOT_TELEMETRY_STATS
+        updateDshotTelemetryQuality(&dshotTelemetryQuality[i], validTelemetryPacket, currentTimeMs);
+#endif
+
+        // Each capture is decoded once
+        capture->edges = 0;
+    }
+}
+
+static dispatchEntry_t dshotTelemetryDispatchEntry = {
+    .dispatch = dshotDecodeTelemetry,
+    .priority = DISPATCH_PRIORITY_URGENT,
+};
+
 FAST_CODE_NOINLINE bool pwmStartDshotMotorUpdate(void)
 {
     if (!useDshotTelemetry) {
         return true;
     }
-#ifdef USE_DSHOT_TELEMETRY_STATS
-    const timeMs_t currentTimeMs = millis();
-#endif
     const timeUs_t currentUs = micros();
     for (int i = 0; i < dshotPwmDevice.count; i++) {
         timeDelta_t usSinceInput = cmpTimeUs(currentUs, inputStampUs);
@@ -222,33 +265,11 @@ FAST_CODE_NOINLINE bool pwmStartDshotMotorUpdate(void)
             TIM_DMACmd(dmaMotors[i].timerHardware->tim, dmaMotors[i].timerDmaSource, DISABLE);
 #endif
 
-            uint16_t value = 0xffff;
-
             if (edges > MIN_GCR_EDGES) {
-                dshotTelemetryState.readCount++;
-                value = decodeTelemetryPacket(dmaMotors[i].dmaBuffer, edges);
-
-#ifdef USE_DSHOT_TELEMETRY_STATS
-                bool validTelemetryPacket = false;
-#endif
-                if (value != 0xffff) {
-                    dshotTelemetryState.motorState[i].telemetryValue = value;
-                    dshotTelemetryState.motorState[i].telemetryActive = true;
-                    if (i < 4) {
-                        DEBUG_SET(DEBUG_DSHOT_RPM_TELEMETRY, i, value);
-                    }
-#ifdef USE_DSHOT_TELEMETRY_STATS
-                    validTelemetryPacket = true;
-#endif
-                } else {
-                    dshotTelemetryState.invalidPacketCount++;
-                    if (i == 0) {
-                        memcpy(dshotTelemetryState.inputBuffer,dmaMotors[i].dmaBuffer,sizeof(dshotTelemetryState.inputBuffer));
-                    }
-                }
-#ifdef USE_DSHOT_TELEMETRY_STATS
-                updateDshotTelemetryQuality(&dshotTelemetryQuality[i], validTelemetryPacket, currentTimeMs);
-#endif
+                // The DMA buffer is reused for the next output, keep a copy for the decoder
+                memcpy(dshotTelemetryCapture[i].buffer, dmaMotors[i].dmaBuffer, edges * sizeof(uint32_t));
+                dshotTelemetryCapture[i].edges = edges;
+                dispatchAdd(&dshotTelemetryDispatchEntry, 0);
             }
         }
         pwmDshotSetDirectionOutput(&dmaMotors[i]);
@@ -109,4 +109,6 @@ const char * const ownerNames[OWNER_TOTAL_COUNT] = {
     "PULLDOWN",
     "DSHOT_BITBANG",
     "SWD",
+    "SPI_TX",
+    "SPI_RX",
 };
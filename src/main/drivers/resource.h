@@ -107,6 +107,8 @@ typedef enum {
     OWNER_PULLDOWN,
     OWNER_DSHOT_BITBANG,
     OWNER_SWD,
+    OWNER_SPI_TX,
+    OWNER_SPI_RX,
     OWNER_TOTAL_COUNT
 } resourceOwner_e;
 
@@ -48,6 +48,17 @@ void cc2500ReadFifo(uint8_t *dpbuffer, uint8_t len)
     rxSpiReadCommandMulti(CC2500_3F_RXFIFO | CC2500_READ_BURST, NOP, dpbuffer, len);
 }
 
+// Read the FIFO in the background, the data is valid once cc2500ReadFifoBusy() returns false
+void cc2500ReadFifoStart(uint8_t *dpbuffer, uint8_t len)
+{
+    rxSpiReadCommandMultiStart(CC2500_3F_RXFIFO | CC2500_READ_BURST, dpbuffer, len);
+}
+
+bool cc2500ReadFifoBusy(void)
+{
+    return rxSpiIsBusy();
+}
+
 void cc2500WriteFifo(uint8_t *dpbuffer, uint8_t len)
 {
     cc2500Strobe(CC2500_SFTX); // 0x3B SFTX
@@ -158,6 +158,8 @@ enum {
 #define CC2500_LQI_EST_BM 0x7F
 
 void cc2500ReadFifo(uint8_t *dpbuffer, uint8_t len);
+void cc2500ReadFifoStart(uint8_t *dpbuffer, uint8_t len);
+bool cc2500ReadFifoBusy(void);
 void cc2500WriteFifo(uint8_t *dpbuffer, uint8_t len);
 
 void cc2500ReadRegisterMulti(uint8_t address, uint8_t *data,
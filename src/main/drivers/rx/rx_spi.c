@@ -59,6 +59,14 @@ static bool extiLevel = true;
 static volatile bool extiHasOccurred = false;
 static volatile timeUs_t lastExtiTimeUs = 0;
 
+// Segments of a queued read, they must stay valid until the transfer has completed
+static uint8_t readStartCommand;
+static busSegment_t readStartSegments[] = {
+    { &readStartCommand, NULL, sizeof(readStartCommand), false },
+    { NULL, NULL, 0, true },
+    { NULL, NULL, 0, false },
+};
+
 void rxSpiDevicePreInit(const rxSpiConfig_t *rxSpiConfig)
 {
     spiPreinitRegister(rxSpiConfig->csnTag, IOCFG_IPU, 1);
@@ -98,6 +106,9 @@ bool rxSpiDeviceInit(const rxSpiConfig_t *rxSpiConfig)
     spiBusSetDivisor(busdev, spiCalculateDivider(RX_MAX_SPI_CLK_HZ));
 #endif
 
+    // Packet reads are queued as DMA sequences if DMA is configured for the bus
+    spiBusEnableSequenceDMA(busdev);
+
     extiPin = IOGetByTag(rxSpiConfig->extiIoTag);
 
     if (extiPin) {
@@ -152,6 +163,27 @@ void rxSpiReadCommandMulti(uint8_t command, uint8_t commandData, uint8_t *retDat
     spiBusRawReadRegisterBuffer(busdev, command, retData, length);
 }
 
+// Queue a read without waiting for it to complete, poll rxSpiIsBusy() before using the data. Falls back to
+// a polled read that has completed on return if DMA isn't available or the bus is already busy.
+void rxSpiReadCommandMultiStart(uint8_t command, uint8_t *retData, uint8_t length)
+{
+    if (rxSpiIsBusy()) {
+        rxSpiReadCommandMulti(command, 0xff, retData, length);
+        return;
+    }
+
+    readStartCommand = command;
+    readStartSegments[1].rxData = retData;
+    readStartSegments[1].len = length;
+
+    spiBusSequence(busdev, SPI_PRIORITY_LOW, readStartSegments, NULL, 0);
+}
+
+bool rxSpiIsBusy(void)
+{
+    return spiBusIsSequenceBusy(busdev);
+}
+
 bool rxSpiExtiConfigured(void)
 {
     return extiPin != IO_NONE;
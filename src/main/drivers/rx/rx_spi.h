@@ -38,6 +38,8 @@ void rxSpiWriteCommand(uint8_t command, uint8_t data);
 void rxSpiWriteCommandMulti(uint8_t command, const uint8_t *data, uint8_t length);
 uint8_t rxSpiReadCommand(uint8_t command, uint8_t commandData);
 void rxSpiReadCommandMulti(uint8_t command, uint8_t commandData, uint8_t *retData, uint8_t length);
+void rxSpiReadCommandMultiStart(uint8_t command, uint8_t *retData, uint8_t length);
+bool rxSpiIsBusy(void);
 void rxSpiExtiInit(ioConfig_t rxSpiExtiPinConfig, extiTrigger_t rxSpiExtiPinTrigger);
 bool rxSpiExtiConfigured(void);
 bool rxSpiGetExtiState(void);
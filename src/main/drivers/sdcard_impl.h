@@ -93,6 +93,7 @@ typedef struct sdcard_t {
     busDevice_t busdev;
     bool useDMAForTx;
     dmaChannelDescriptor_t * dma;
+    timeUs_t busyPollAtUs;              // when to next check whether the card has finished programming
 #endif
 
 #ifdef USE_SDCARD_SDIO
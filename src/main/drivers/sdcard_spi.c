@@ -63,6 +63,11 @@
  */
 #define SDCARD_NON_DMA_CHUNK_SIZE                   256
 
+/* The card holds its output low while it programs a block, which takes some hundreds of microseconds at best. It is
+ * probed for the end of that at this interval rather than on every call to sdcard_poll().
+ */
+#define SDCARD_BUSY_POLL_INTERVAL_US                100
+
 /**
  * Returns true if the card has already been, or is currently, initializing and hasn't encountered enough errors to
  * trip our error threshold and be disabled (i.e. our card is in and working!)
@@ -523,7 +528,8 @@ static void sdcardSpi_init(const sdcardConfig_t *config, const spiPinConfig_t *s
         dmaIdentifier = config->dmaIdentifier;
 #endif
 
-        if (dmaIdentifier) {
+        // the stream may already be taken by another user of the bus, the blocks are then written in chunks
+        if (dmaIdentifier && dmaGetOwner(dmaIdentifier)->owner == OWNER_FREE) {
             sdcard.dma = dmaGetDescriptorByIdentifier(dmaIdentifier);
             dmaInit(dmaIdentifier, OWNER_SDCARD, 0);
             sdcard.useDMAForTx = true;
@@ -617,6 +623,7 @@ static sdcardOperationStatus_e sdcard_endWriteBlocks(void)
     } else {
         sdcard.state = SDCARD_STATE_STOPPING_MULTIPLE_BLOCK_WRITE;
         sdcard.operationStartTime = millis();
+        sdcard.busyPollAtUs = micros() + SDCARD_BUSY_POLL_INTERVAL_US;
 
         return SDCARD_OPERATION_IN_PROGRESS;
     }
@@ -787,6 +794,7 @@ static bool sdcardSpi_poll(void)
                     // The SD card is now busy committing that write to the card
                     sdcard.state = SDCARD_STATE_WAITING_FOR_WRITE;
                     sdcard.operationStartTime = millis();
+                    sdcard.busyPollAtUs = micros() + SDCARD_BUSY_POLL_INTERVAL_US;
 
                     // Since we've transmitted the buffer we can go ahead and tell the caller their operation is complete
                     if (sdcard.pendingOperation.callback) {
@@ -808,6 +816,11 @@ static bool sdcardSpi_poll(void)
             }
         break;
         case SDCARD_STATE_WAITING_FOR_WRITE:
+            if (cmpTimeUs(micros(), sdcard.busyPollAtUs) < 0) {
+                break;
+            }
+            sdcard.busyPollAtUs = micros() + SDCARD_BUSY_POLL_INTERVAL_US;
+
             if (sdcard_waitForIdle(SDCARD_MAXIMUM_BYTE_DELAY_FOR_CMD_REPLY)) {
 #ifdef SDCARD_PROFILING
                 profilingComplete = true;
@@ -899,6 +912,11 @@ static bool sdcardSpi_poll(void)
             }
         break;
         case SDCARD_STATE_STOPPING_MULTIPLE_BLOCK_WRITE:
+            if (cmpTimeUs(micros(), sdcard.busyPollAtUs) < 0) {
+                break;
+            }
+            sdcard.busyPollAtUs = micros() + SDCARD_BUSY_POLL_INTERVAL_US;
+
             if (sdcard_waitForIdle(SDCARD_MAXIMUM_BYTE_DELAY_FOR_CMD_REPLY)) {
                 sdcard_deselect();
 
@@ -35,6 +35,7 @@
 
 #include "build/debug.h"
 
+#include "common/ring.h"
 #include "common/utils.h"
 
 #include "drivers/nvic.h"
@@ -98,6 +99,8 @@ typedef struct softSerial_s {
     timerCCHandlerRec_t edgeCb;
 } softSerial_t;
 
+STATIC_ASSERT(RING_IS_POWER_OF_TWO(SOFTSERIAL_BUFFER_SIZE), softserial_buffer_size_not_power_of_two);
+
 static const struct serialPortVTable softSerialVTable; // Forward
 
 static softSerial_t softSerialPorts[MAX_SOFTSERIAL_PORTS];
@@ -218,6 +221,44 @@ static void serialTimerConfigureTimebase(const timerHardware_t *timerHardwarePtr
     timerConfigure(timerHardwarePtr, timerPeriod, baseClock);
 }
 
+// The bit clock only interrupts while a byte is being sent or received, an idle port costs no interrupts.
+// In dual timer mode the bit clock is the TX timer, the RX timer only captures edges.
+static TIM_TypeDef *bitClockTimer(const softSerial_t *softSerial)
+{
+    return (softSerial->timerMode == TIMER_MODE_DUAL) ? softSerial->exTimerHardware->tim : softSerial->timerHardware->tim;
+}
+
+static void bitClockStart(softSerial_t *softSerial)
+{
+    TIM_TypeDef *tim = bitClockTimer(softSerial);
+
+    ATOMIC_BLOCK(NVIC_PRIO_TIMER) {
+        if (!(tim->DIER & TIM_DIER_UIE)) {
+            // The update flag kept being set while the interrupt was off
+            tim->SR = ~TIM_SR_UIF;
+            tim->DIER |= TIM_DIER_UIE;
+        }
+    }
+}
+
+static void bitClockStopIfIdle(softSerial_t *softSerial)
+{
+    if (softSerial->isTransmittingData || !softSerial->isSearchingForStartBit) {
+        return;
+    }
+
+    // A half-duplex port must turn around to receive first
+    if ((softSerial->port.options & SERIAL_BIDIR) && !softSerial->rxActive) {
+        return;
+    }
+
+    if (ringLoadIndex(&softSerial->port.txBufferTail) != softSerial->port.txBufferHead) {
+        return;
+    }
+
+    bitClockTimer(softSerial)->DIER &= ~TIM_DIER_UIE;
+}
+
 static void resetBuffers(softSerial_t *softSerial)
 {
     softSerial->port.rxBufferSize = SOFTSERIAL_BUFFER_SIZE;
@@ -344,6 +385,8 @@ serialPort_t *openSoftSerial(softSerialPortIndex_e portIndex, serialReceiveCallb
 
     serialInputPortActivate(softSerial);
 
+    bitClockStopIfIdle(softSerial);
+
     return &softSerial->port;
 }
 
@@ -357,7 +400,8 @@ void processTxState(softSerial_t *softSerial)
     uint8_t mask;
 
     if (!softSerial->isTransmittingData) {
-        if (isSoftSerialTransmitBufferEmpty((serialPort_t *)softSerial)) {
+        uint8_t byteToSend;
+        if (!ringGet((const uint8_t *)softSerial->port.txBuffer, softSerial->port.txBufferSize, &softSerial->port.txBufferHead, &softSerial->port.txBufferTail, &byteToSend)) {
             // Transmit buffer empty.
             // Start listening if not already in if half-duplex
             if (!softSerial->rxActive && softSerial->port.options & SERIAL_BIDIR) {
@@ -367,12 +411,6 @@ void processTxState(softSerial_t *softSerial)
             return;
         }
 
-        // data to send
-        uint8_t byteToSend = softSerial->port.txBuffer[softSerial->port.txBufferTail++];
-        if (softSerial->port.txBufferTail >= softSerial->port.txBufferSize) {
-            softSerial->port.txBufferTail = 0;
-        }
-
         // build internal buffer, MSB = Stop Bit (1) + data bits (MSB to LSB) + start bit(0) LSB
         softSerial->internalTxBuffer = (1 << (TX_TOTAL_BITS - 1)) | (byteToSend << 1);
         softSerial->bitsLeftToTransmit = TX_TOTAL_BITS;
@@ -453,8 +491,7 @@ void extractAndStoreRxByte(softSerial_t *softSerial)
     if (softSerial->port.rxCallback) {
         softSerial->port.rxCallback(rxByte, softSerial->port.rxCallbackData);
     } else {
-        softSerial->port.rxBuffer[softSerial->port.rxBufferHead] = rxByte;
-        softSerial->port.rxBufferHead = (softSerial->port.rxBufferHead + 1) % softSerial->port.rxBufferSize;
+        ringPut((uint8_t *)softSerial->port.rxBuffer, softSerial->port.rxBufferSize, &softSerial->port.rxBufferHead, &softSerial->port.rxBufferTail, rxByte);
     }
 }
 
@@ -492,6 +529,8 @@ void onSerialTimerOverflow(timerOvrHandlerRec_t *cbRec, captureCompare_t capture
 
     if (self->port.mode & MODE_RX)
         processRxState(self);
+
+    bitClockStopIfIdle(self);
 }
 
 void onSerialRxPinChange(timerCCHandlerRec_t *cbRec, captureCompare_t capture)
@@ -534,6 +573,8 @@ void onSerialRxPinChange(timerCCHandlerRec_t *cbRec, captureCompare_t capture)
         self->rxLastLeadingEdgeAtBitIndex = 0;
         self->internalRxBuffer = 0;
         self->isSearchingForStartBit = false;
+
+        bitClockStart(self);
         return;
     }
 
@@ -568,7 +609,7 @@ uint32_t softSerialRxBytesWaiting(const serialPort_t *instance)
 
     softSerial_t *s = (softSerial_t *)instance;
 
-    return (s->port.rxBufferHead - s->port.rxBufferTail) & (s->port.rxBufferSize - 1);
+    return ringUsed(s->port.rxBufferSize, ringLoadIndex(&s->port.rxBufferHead), s->port.rxBufferTail);
 }
 
 uint32_t softSerialTxBytesFree(const serialPort_t *instance)
@@ -579,25 +620,18 @@ uint32_t softSerialTxBytesFree(const serialPort_t *instance)
 
     softSerial_t *s = (softSerial_t *)instance;
 
-    uint8_t bytesUsed = (s->port.txBufferHead - s->port.txBufferTail) & (s->port.txBufferSize - 1);
-
-    return (s->port.txBufferSize - 1) - bytesUsed;
+    return ringFree(s->port.txBufferSize, s->port.txBufferHead, ringLoadIndex(&s->port.txBufferTail));
 }
 
 uint8_t softSerialReadByte(serialPort_t *instance)
 {
-    uint8_t ch;
+    uint8_t ch = 0;
 
     if ((instance->mode & MODE_RX) == 0) {
         return 0;
     }
 
-    if (softSerialRxBytesWaiting(instance) == 0) {
-        return 0;
-    }
-
-    ch = instance->rxBuffer[instance->rxBufferTail];
-    instance->rxBufferTail = (instance->rxBufferTail + 1) % instance->rxBufferSize;
+    ringGet((const uint8_t *)instance->rxBuffer, instance->rxBufferSize, &instance->rxBufferHead, &instance->rxBufferTail, &ch);
     return ch;
 }
 
@@ -607,8 +641,9 @@ void softSerialWriteByte(serialPort_t *s, uint8_t ch)
         return;
     }
 
-    s->txBuffer[s->txBufferHead] = ch;
-    s->txBufferHead = (s->txBufferHead + 1) % s->txBufferSize;
+    ringPut((uint8_t *)s->txBuffer, s->txBufferSize, &s->txBufferHead, &s->txBufferTail, ch);
+
+    bitClockStart((softSerial_t *)s);
 }
 
 void softSerialSetBaudRate(serialPort_t *s, uint32_t baudRate)
@@ -627,7 +662,7 @@ void softSerialSetMode(serialPort_t *instance, portMode_e mode)
 
 bool isSoftSerialTransmitBufferEmpty(const serialPort_t *instance)
 {
-    return instance->txBufferHead == instance->txBufferTail;
+    return ringLoadIndex(&instance->txBufferTail) == instance->txBufferHead;
 }
 
 static const struct serialPortVTable softSerialVTable = {
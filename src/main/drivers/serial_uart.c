@@ -27,13 +27,17 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
 #ifdef USE_UART
 
 #include "build/build_config.h"
+#include "build/irq_load.h"
 
+#include "common/maths.h"
+#include "common/ring.h"
 #include "common/utils.h"
 
 #include "drivers/dma.h"
@@ -42,24 +46,15 @@
 #include "drivers/serial.h"
 #include "drivers/serial_uart.h"
 #include "drivers/serial_uart_impl.h"
+#include "drivers/stack_check.h"
 
 #include "pg/serial_uart.h"
 
-#if defined(STM32H7)
-#define UART_TX_BUFFER_ATTRIBUTE DMA_RAM            // D2 SRAM
-#define UART_RX_BUFFER_ATTRIBUTE DMA_RAM            // D2 SRAM
-#elif defined(STM32G4)
-#define UART_TX_BUFFER_ATTRIBUTE DMA_RAM_W          // SRAM MPU NOT_BUFFERABLE
-#define UART_RX_BUFFER_ATTRIBUTE DMA_RAM_R          // SRAM MPU NOT CACHABLE
-#elif defined(STM32F7)
-#define UART_TX_BUFFER_ATTRIBUTE FAST_DATA_ZERO_INIT // DTCM RAM
-#define UART_RX_BUFFER_ATTRIBUTE FAST_DATA_ZERO_INIT // DTCM RAM
-#elif defined(STM32F4) || defined(STM32F3) || defined(STM32F1)
-#define UART_TX_BUFFER_ATTRIBUTE                    // NONE
-#define UART_RX_BUFFER_ATTRIBUTE                    // NONE
-#else
-#error Undefined UART_{TX,RX}_BUFFER_ATTRIBUTE for this MCU
-#endif
+#define UART_TX_BUFFER_ATTRIBUTE DMA_BUFFER_W
+#define UART_RX_BUFFER_ATTRIBUTE DMA_BUFFER_R
+
+STATIC_ASSERT(RING_IS_POWER_OF_TWO(UART_RX_BUFFER_SIZE), uart_rx_buffer_size_not_power_of_two);
+STATIC_ASSERT(RING_IS_POWER_OF_TWO(UART_TX_BUFFER_SIZE), uart_tx_buffer_size_not_power_of_two);
 
 #define UART_BUFFERS(n) \
     UART_BUFFER(UART_TX_BUFFER_ATTRIBUTE, n, T); \
@@ -117,7 +112,7 @@ serialPort_t *uartOpen(UARTDevice_e device, serialReceiveCallbackPtr rxCallback,
     // common serial initialisation code should move to serialPort::init()
     s->port.rxBufferHead = s->port.rxBufferTail = 0;
     s->port.txBufferHead = s->port.txBufferTail = 0;
-    // callback works for IRQ-based RX ONLY
+    // with DMA reception the callback is handed the received bytes on each idle line
     s->port.rxCallback = rxCallback;
     s->port.rxCallbackData = rxCallbackData;
     s->port.mode = mode;
@@ -166,24 +161,14 @@ static uint32_t uartTotalRxBytesWaiting(const serialPort_t *instance)
     }
 #endif
 
-    if (s->port.rxBufferHead >= s->port.rxBufferTail) {
-        return s->port.rxBufferHead - s->port.rxBufferTail;
-    } else {
-        return s->port.rxBufferSize + s->port.rxBufferHead - s->port.rxBufferTail;
-    }
+    return ringUsed(s->port.rxBufferSize, ringLoadIndex(&s->port.rxBufferHead), s->port.rxBufferTail);
 }
 
 static uint32_t uartTotalTxBytesFree(const serialPort_t *instance)
 {
     const uartPort_t *s = (const uartPort_t*)instance;
 
-    uint32_t bytesUsed;
-
-    if (s->port.txBufferHead >= s->port.txBufferTail) {
-        bytesUsed = s->port.txBufferHead - s->port.txBufferTail;
-    } else {
-        bytesUsed = s->port.txBufferSize + s->port.txBufferHead - s->port.txBufferTail;
-    }
+    uint32_t bytesUsed = ringUsed(s->port.txBufferSize, s->port.txBufferHead, ringLoadIndex(&s->port.txBufferTail));
 
 #ifdef USE_DMA
     if (s->txDMAResource) {
@@ -223,13 +208,13 @@ static bool isUartTransmitBufferEmpty(const serialPort_t *instance)
     } else
 #endif
     {
-        return s->port.txBufferTail == s->port.txBufferHead;
+        return ringLoadIndex(&s->port.txBufferTail) == s->port.txBufferHead;
     }
 }
 
 static uint8_t uartRead(serialPort_t *instance)
 {
-    uint8_t ch;
+    uint8_t ch = 0;
     uartPort_t *s = (uartPort_t *)instance;
 
 #ifdef USE_DMA
@@ -240,28 +225,21 @@ static uint8_t uartRead(serialPort_t *instance)
     } else
 #endif
     {
-        ch = s->port.rxBuffer[s->port.rxBufferTail];
-        if (s->port.rxBufferTail + 1 >= s->port.rxBufferSize) {
-            s->port.rxBufferTail = 0;
-        } else {
-            s->port.rxBufferTail++;
-        }
+        ringGet((const uint8_t *)s->port.rxBuffer, s->port.rxBufferSize, &s->port.rxBufferHead, &s->port.rxBufferTail, &ch);
     }
 
     return ch;
 }
 
-static void uartWrite(serialPort_t *instance, uint8_t ch)
+static void uartStartTx(uartPort_t *s)
 {
-    uartPort_t *s = (uartPort_t *)instance;
-
-    s->port.txBuffer[s->port.txBufferHead] = ch;
-
-    if (s->port.txBufferHead + 1 >= s->port.txBufferSize) {
-        s->port.txBufferHead = 0;
-    } else {
-        s->port.txBufferHead++;
+#ifndef USE_HAL_DRIVER
+    if ((s->port.options & (SERIAL_BIDIR | SERIAL_BIDIR_NOECHO)) == (SERIAL_BIDIR | SERIAL_BIDIR_NOECHO)) {
+        // Stop listening to our own frame, the transmission complete interrupt turns the line around
+        s->USARTx->CR1 &= ~USART_CR1_RE;
+        USART_ITConfig(s->USARTx, USART_IT_TC, ENABLE);
     }
+#endif
 
 #ifdef USE_DMA
     if (s->txDMAResource) {
@@ -277,6 +255,69 @@ static void uartWrite(serialPort_t *instance, uint8_t ch)
     }
 }
 
+static void uartWrite(serialPort_t *instance, uint8_t ch)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+
+    ringPut((uint8_t *)s->port.txBuffer, s->port.txBufferSize, &s->port.txBufferHead, &s->port.txBufferTail, ch);
+
+    if (!s->txBatching) {
+        uartStartTx(s);
+    }
+}
+
+static void uartWriteBuf(serialPort_t *instance, const void *data, int count)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+
+    ringWrite((uint8_t *)s->port.txBuffer, s->port.txBufferSize, &s->port.txBufferHead, &s->port.txBufferTail, data, count);
+
+    if (!s->txBatching) {
+        uartStartTx(s);
+    }
+}
+
+// Between beginWrite and endWrite the bytes are only queued, the transmitter is started once by endWrite
+static void uartBeginWrite(serialPort_t *instance)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+
+    s->txBatching = true;
+}
+
+static void uartEndWrite(serialPort_t *instance)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+
+    s->txBatching = false;
+    uartStartTx(s);
+}
+
+#ifdef USE_DMA
+// Called on an idle line for a port receiving by DMA with a callback. Every byte received since
+// the previous idle line, normally one complete frame, is passed on from this single interrupt.
+void uartRxDmaIdle(uartPort_t *s)
+{
+    while (uartTotalRxBytesWaiting(&s->port)) {
+        s->port.rxCallback(uartRead(&s->port), s->port.rxCallbackData);
+    }
+}
+#endif
+
+#ifndef USE_HAL_DRIVER
+// Called on transmission complete for a SERIAL_BIDIR_NOECHO port. The last stop bit is out, so
+// once nothing more is queued the receiver is enabled again without waiting on the protocol.
+void uartHalfDuplexTxComplete(uartPort_t *s)
+{
+    USART_ClearITPendingBit(s->USARTx, USART_IT_TC);
+
+    if (ringLoadIndex(&s->port.txBufferHead) == s->port.txBufferTail) {
+        USART_ITConfig(s->USARTx, USART_IT_TC, DISABLE);
+        s->USARTx->CR1 |= USART_CR1_RE;
+    }
+}
+#endif
+
 const struct serialPortVTable uartVTable[] = {
     {
         .serialWrite = uartWrite,
@@ -288,9 +329,9 @@ const struct serialPortVTable uartVTable[] = {
         .setMode = uartSetMode,
         .setCtrlLineStateCb = NULL,
         .setBaudRateCb = NULL,
-        .writeBuf = NULL,
-        .beginWrite = NULL,
-        .endWrite = NULL,
+        .writeBuf = uartWriteBuf,
+        .beginWrite = uartBeginWrite,
+        .endWrite = uartEndWrite,
     }
 };
 
@@ -313,7 +354,7 @@ void uartConfigureDma(uartDevice_t *uartdev)
     }
 
     if (serialUartConfig(device)->rxDmaopt != DMA_OPT_UNUSED) {
-        dmaChannelSpec = dmaGetChannelSpecByPeripheral(DMA_PERIPH_UART_RX, device, serialUartConfig(device)->txDmaopt);
+        dmaChannelSpec = dmaGetChannelSpecByPeripheral(DMA_PERIPH_UART_RX, device, serialUartConfig(device)->rxDmaopt);
         if (dmaChannelSpec) {
             s->rxDMAResource = dmaChannelSpec->ref;
             s->rxDMAChannel = dmaChannelSpec->channel;
@@ -351,8 +392,11 @@ void uartConfigureDma(uartDevice_t *uartdev)
 #define UART_IRQHandler(type, number, dev)                    \
     void type ## number ## _IRQHandler(void)                  \
     {                                                         \
+        STACK_CHECK_IRQ();                                    \
+        IRQ_LOAD_BEGIN();                                     \
         uartPort_t *s = &(uartDevmap[UARTDEV_ ## dev]->port); \
         uartIrqHandler(s);                                    \
+        IRQ_LOAD_END(IRQ_LOAD_UART, UARTDEV_ ## dev);         \
     }
 
 #ifdef USE_UART1
@@ -35,6 +35,7 @@
 #include "build/build_config.h"
 #include "build/atomic.h"
 
+#include "common/ring.h"
 #include "common/utils.h"
 #include "drivers/io.h"
 #include "drivers/nvic.h"
@@ -220,22 +221,16 @@ void uartTryStartTxDMA(uartPort_t *s)
             return;
         }
 
-        if (s->port.txBufferHead == s->port.txBufferTail) {
+        const uint32_t fromwhere = s->port.txBufferTail;
+        const uint16_t size = ringUsedContiguous(s->port.txBufferSize, ringLoadIndex(&s->port.txBufferHead), fromwhere);
+
+        if (size == 0) {
             // No more data to transmit
             s->txDMAEmpty = true;
             return;
         }
 
-        uint16_t size;
-        uint32_t fromwhere = s->port.txBufferTail;
-
-        if (s->port.txBufferHead > s->port.txBufferTail) {
-            size = s->port.txBufferHead - s->port.txBufferTail;
-            s->port.txBufferTail = s->port.txBufferHead;
-        } else {
-            size = s->port.txBufferSize - s->port.txBufferTail;
-            s->port.txBufferTail = 0;
-        }
+        ringConsume(s->port.txBufferSize, &s->port.txBufferTail, size);
         s->txDMAEmpty = false;
 
         HAL_UART_Transmit_DMA(&s->Handle, (uint8_t *)&s->port.txBuffer[fromwhere], size);
@@ -281,8 +276,7 @@ void uartIrqHandler(uartPort_t *s)
         if (s->port.rxCallback) {
             s->port.rxCallback(rbyte, s->port.rxCallbackData);
         } else {
-            s->port.rxBuffer[s->port.rxBufferHead] = rbyte;
-            s->port.rxBufferHead = (s->port.rxBufferHead + 1) % s->port.rxBufferSize;
+            ringPut((uint8_t *)s->port.rxBuffer, s->port.rxBufferSize, &s->port.rxBufferHead, &s->port.rxBufferTail, rbyte);
         }
         CLEAR_BIT(huart->Instance->CR1, (USART_CR1_PEIE));
 
@@ -321,17 +315,15 @@ void uartIrqHandler(uartPort_t *s)
         (__HAL_UART_GET_IT(huart, UART_IT_TXE) != RESET)) {
         /* Check that a Tx process is ongoing */
         if (huart->gState != HAL_UART_STATE_BUSY_TX) {
-            if (s->port.txBufferTail == s->port.txBufferHead) {
+            uint8_t ch;
+            if (!ringGet((const uint8_t *)s->port.txBuffer, s->port.txBufferSize, &s->port.txBufferHead, &s->port.txBufferTail, &ch)) {
                 huart->TxXferCount = 0;
                 /* Disable the UART Transmit Data Register Empty Interrupt */
                 CLEAR_BIT(huart->Instance->CR1, USART_CR1_TXEIE);
+            } else if ((huart->Init.WordLength == UART_WORDLENGTH_9B) && (huart->Init.Parity == UART_PARITY_NONE)) {
+                huart->Instance->TDR = (((uint16_t) ch) & (uint16_t) 0x01FFU);
             } else {
-                if ((huart->Init.WordLength == UART_WORDLENGTH_9B) && (huart->Init.Parity == UART_PARITY_NONE)) {
-                    huart->Instance->TDR = (((uint16_t) s->port.txBuffer[s->port.txBufferTail]) & (uint16_t) 0x01FFU);
-                } else {
-                    huart->Instance->TDR = (uint8_t)(s->port.txBuffer[s->port.txBufferTail]);
-                }
-                s->port.txBufferTail = (s->port.txBufferTail + 1) % s->port.txBufferSize;
+                huart->Instance->TDR = ch;
             }
         }
     }
@@ -212,6 +212,10 @@ void uartConfigureDma(uartDevice_t *uartdev);
 
 void uartDmaIrqHandler(dmaChannelDescriptor_t* descriptor);
 
+void uartRxDmaIdle(uartPort_t *s);
+
+void uartHalfDuplexTxComplete(uartPort_t *s);
+
 #if defined(STM32F3) || defined(STM32F7) || defined(STM32H7) || defined(STM32G4)
 #define UART_REG_RXD(base) ((base)->RDR)
 #define UART_REG_TXD(base) ((base)->TDR)
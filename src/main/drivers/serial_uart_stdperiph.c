@@ -39,6 +39,7 @@
 #include "build/build_config.h"
 #include "build/atomic.h"
 
+#include "common/ring.h"
 #include "common/utils.h"
 #include "drivers/inverter.h"
 #include "drivers/nvic.h"
@@ -150,6 +151,10 @@ void uartReconfigure(uartPort_t *uartPort)
             xDMA_Cmd(uartPort->rxDMAResource, ENABLE);
             USART_DMACmd(uartPort->USARTx, USART_DMAReq_Rx, ENABLE);
             uartPort->rxDMAPos = xDMA_GetCurrDataCounter(uartPort->rxDMAResource);
+            if (uartPort->port.rxCallback) {
+                // The idle line interrupt delivers the received frame to the callback
+                USART_ITConfig(uartPort->USARTx, USART_IT_IDLE, ENABLE);
+            }
         } else {
             USART_ClearITPendingBit(uartPort->USARTx, USART_IT_RXNE);
             USART_ITConfig(uartPort->USARTx, USART_IT_RXNE, ENABLE);
@@ -223,7 +228,9 @@ void uartTryStartTxDMA(uartPort_t *s)
             goto reenable;
         }
 
-        if (s->port.txBufferHead == s->port.txBufferTail) {
+        const uint32_t size = ringUsedContiguous(s->port.txBufferSize, ringLoadIndex(&s->port.txBufferHead), s->port.txBufferTail);
+
+        if (size == 0) {
             // No more data to transmit.
             s->txDMAEmpty = true;
             return;
@@ -237,13 +244,8 @@ void uartTryStartTxDMA(uartPort_t *s)
         DMAx_SetMemoryAddress(s->txDMAResource, (uint32_t)&s->port.txBuffer[s->port.txBufferTail]);
 #endif
 
-        if (s->port.txBufferHead > s->port.txBufferTail) {
-            xDMA_SetCurrDataCounter(s->txDMAResource, s->port.txBufferHead - s->port.txBufferTail);
-            s->port.txBufferTail = s->port.txBufferHead;
-        } else {
-            xDMA_SetCurrDataCounter(s->txDMAResource, s->port.txBufferSize - s->port.txBufferTail);
-            s->port.txBufferTail = 0;
-        }
+        xDMA_SetCurrDataCounter(s->txDMAResource, size);
+        ringConsume(s->port.txBufferSize, &s->port.txBufferTail, size);
         s->txDMAEmpty = false;
 
     reenable:
@@ -265,15 +265,14 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
 
     serialUARTInitIO(IOGetByTag(uartDev->tx.pin), IOGetByTag(uartDev->rx.pin), mode, options, hardware->af, device);
 
-    if (!s->rxDMAResource || !s->txDMAResource) {
-        NVIC_InitTypeDef NVIC_InitStructure;
-
-        NVIC_InitStructure.NVIC_IRQChannel = hardware->irqn;
-        NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = NVIC_PRIORITY_BASE(hardware->rxPriority);
-        NVIC_InitStructure.NVIC_IRQChannelSubPriority = NVIC_PRIORITY_SUB(hardware->rxPriority);
-        NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
-        NVIC_Init(&NVIC_InitStructure);
-    }
+    // Also needed with DMA reception for the idle line interrupt
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    NVIC_InitStructure.NVIC_IRQChannel = hardware->irqn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = NVIC_PRIORITY_BASE(hardware->rxPriority);
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = NVIC_PRIORITY_SUB(hardware->rxPriority);
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
 
     return s;
 }
@@ -304,12 +303,19 @@ void uartIrqHandler(uartPort_t *s)
         }
     }
 
+    if (USART_GetITStatus(s->USARTx, USART_IT_TC) == SET) {
+        uartHalfDuplexTxComplete(s);
+    }
+
     if (ISR & USART_FLAG_ORE)
     {
         USART_ClearITPendingBit(s->USARTx, USART_IT_ORE);
     }
 
     if (ISR & USART_FLAG_IDLE) {
+        if (s->rxDMAResource && s->port.rxCallback) {
+            uartRxDmaIdle(s);
+        }
         if (s->port.idleCallback) {
             s->port.idleCallback();
         }
@@ -29,6 +29,8 @@
 
 #ifdef USE_UART
 
+#include "common/ring.h"
+
 #include "drivers/system.h"
 #include "drivers/io.h"
 #include "drivers/dma.h"
@@ -294,17 +296,14 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
         }
     }
 
-#ifdef USE_DMA
-    if (!(s->rxDMAResource)) {
-        NVIC_InitTypeDef NVIC_InitStructure;
-
-        NVIC_InitStructure.NVIC_IRQChannel = hardware->irqn;
-        NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = NVIC_PRIORITY_BASE(hardware->rxPriority);
-        NVIC_InitStructure.NVIC_IRQChannelSubPriority = NVIC_PRIORITY_SUB(hardware->rxPriority);
-        NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
-        NVIC_Init(&NVIC_InitStructure);
-    }
-#endif
+    // Also needed with DMA reception for the idle line interrupt
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    NVIC_InitStructure.NVIC_IRQChannel = hardware->irqn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = NVIC_PRIORITY_BASE(hardware->rxPriority);
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = NVIC_PRIORITY_SUB(hardware->rxPriority);
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
 
     return s;
 }
@@ -315,25 +314,33 @@ void uartIrqHandler(uartPort_t *s)
         if (s->port.rxCallback) {
             s->port.rxCallback(s->USARTx->DR, s->port.rxCallbackData);
         } else {
-            s->port.rxBuffer[s->port.rxBufferHead] = s->USARTx->DR;
-            s->port.rxBufferHead = (s->port.rxBufferHead + 1) % s->port.rxBufferSize;
+            ringPut((uint8_t *)s->port.rxBuffer, s->port.rxBufferSize, &s->port.rxBufferHead, &s->port.rxBufferTail, s->USARTx->DR);
         }
     }
 
     if (!s->txDMAResource && (USART_GetITStatus(s->USARTx, USART_IT_TXE) == SET)) {
-        if (s->port.txBufferTail != s->port.txBufferHead) {
-            USART_SendData(s->USARTx, s->port.txBuffer[s->port.txBufferTail]);
-            s->port.txBufferTail = (s->port.txBufferTail + 1) % s->port.txBufferSize;
+        uint8_t ch;
+        if (ringGet((const uint8_t *)s->port.txBuffer, s->port.txBufferSize, &s->port.txBufferHead, &s->port.txBufferTail, &ch)) {
+            USART_SendData(s->USARTx, ch);
         } else {
             USART_ITConfig(s->USARTx, USART_IT_TXE, DISABLE);
         }
     }
 
+    if (USART_GetITStatus(s->USARTx, USART_IT_TC) == SET) {
+        uartHalfDuplexTxComplete(s);
+    }
+
     if (USART_GetITStatus(s->USARTx, USART_IT_ORE) == SET) {
         USART_ClearITPendingBit(s->USARTx, USART_IT_ORE);
     }
 
     if (USART_GetITStatus(s->USARTx, USART_IT_IDLE) == SET) {
+#ifdef USE_DMA
+        if (s->rxDMAResource && s->port.rxCallback) {
+            uartRxDmaIdle(s);
+        }
+#endif
         if (s->port.idleCallback) {
             s->port.idleCallback();
         }
@@ -20,6 +20,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -122,16 +123,21 @@ static uint8_t usbVcpRead(serialPort_t *instance)
     }
 }
 
-static void usbVcpWriteBuf(serialPort_t *instance, const void *data, int count)
+static bool usbVcpFlush(vcpPort_t *port)
 {
-    UNUSED(instance);
+    uint32_t count = port->txAt;
+    port->txAt = 0;
 
-    if (!(usbIsConnected() && usbIsConfigured())) {
-        return;
+    if (count == 0) {
+        return true;
+    }
+
+    if (!usbIsConnected() || !usbIsConfigured()) {
+        return false;
     }
 
     uint32_t start = millis();
-    const uint8_t *p = data;
+    uint8_t *p = port->txBuf;
     while (count > 0) {
         uint32_t txed = CDC_Send_DATA(p, count);
         count -= txed;
@@ -141,23 +147,27 @@ static void usbVcpWriteBuf(serialPort_t *instance, const void *data, int count)
             break;
         }
     }
+    return count == 0;
 }
 
-static bool usbVcpFlush(vcpPort_t *port)
+static void usbVcpWriteBuf(serialPort_t *instance, const void *data, int count)
 {
-    uint32_t count = port->txAt;
-    port->txAt = 0;
+    vcpPort_t *port = container_of(instance, vcpPort_t, port);
 
-    if (count == 0) {
-        return true;
+    // Small writes within a bulk write are gathered into whole packets
+    if (port->buffering && port->txAt + count <= (int)ARRAYLEN(port->txBuf)) {
+        memcpy(&port->txBuf[port->txAt], data, count);
+        port->txAt += count;
+        return;
     }
 
-    if (!usbIsConnected() || !usbIsConfigured()) {
-        return false;
+    // Anything already buffered has to go out first to keep the bytes in order
+    if (!(usbIsConnected() && usbIsConfigured()) || !usbVcpFlush(port)) {
+        return;
     }
 
     uint32_t start = millis();
-    uint8_t *p = port->txBuf;
+    const uint8_t *p = data;
     while (count > 0) {
         uint32_t txed = CDC_Send_DATA(p, count);
         count -= txed;
@@ -167,7 +177,6 @@ static bool usbVcpFlush(vcpPort_t *port)
             break;
         }
     }
-    return count == 0;
 }
 
 static void usbVcpWrite(serialPort_t *instance, uint8_t c)
@@ -189,7 +198,10 @@ static void usbVcpBeginWrite(serialPort_t *instance)
 static uint32_t usbTxBytesFree(const serialPort_t *instance)
 {
     UNUSED(instance);
-    return CDC_Send_FreeBytes();
+    const uint32_t bytesFree = CDC_Send_FreeBytes();
+
+    // Bytes still gathered in the packet buffer take up space too
+    return bytesFree > vcpPort.txAt ? bytesFree - vcpPort.txAt : 0;
 }
 
 static void usbVcpEndWrite(serialPort_t *instance)
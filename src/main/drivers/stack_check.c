@@ -28,6 +28,7 @@
 
 #include "common/utils.h"
 
+#include "drivers/nvic.h"
 #include "drivers/stack_check.h"
 
 #define STACK_FILL_CHAR 0xa5
@@ -61,6 +62,7 @@ extern char _Min_Stack_Size; // declared in .LD file
 #ifdef USE_STACK_CHECK
 
 static uint32_t usedStackSize;
+static FAST_DATA_ZERO_INIT uint32_t irqUsedStackSize[STACK_CHECK_IRQ_LEVELS];
 
 void taskStackCheck(timeUs_t currentTimeUs)
 {
@@ -90,6 +92,27 @@ uint32_t stackUsedSize(void)
 {
     return usedStackSize;
 }
+
+// An interrupt cannot preempt another one of the same level, so each level only has one writer
+FAST_CODE void stackCheckIrq(void)
+{
+    const int irqn = (int)(__get_IPSR() & 0x1ff) - 16;
+    if (irqn < 0) {
+        // system exception, SysTick for instance, not configured through the NVIC
+        return;
+    }
+
+    const uint32_t used = (uint32_t)(intptr_t)&_estack - __get_MSP();
+    const unsigned level = NVIC_PRIORITY_BASE(NVIC_GetPriority((IRQn_Type)irqn) << (8 - __NVIC_PRIO_BITS)) % STACK_CHECK_IRQ_LEVELS;
+    if (used > irqUsedStackSize[level]) {
+        irqUsedStackSize[level] = used;
+    }
+}
+
+uint32_t stackIrqUsedSize(unsigned level)
+{
+    return irqUsedStackSize[level];
+}
 #endif
 
 uint32_t stackTotalSize(void)
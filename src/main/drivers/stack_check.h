@@ -22,7 +22,20 @@
 
 #include "common/time.h"
 
+// Preemption priority levels with NVIC_PRIORITY_GROUPING 2
+#define STACK_CHECK_IRQ_LEVELS 4
+
 void taskStackCheck(timeUs_t currentTimeUs);
 uint32_t stackUsedSize(void);
 uint32_t stackTotalSize(void);
 uint32_t stackHighMem(void);
+
+#ifdef USE_STACK_CHECK
+void stackCheckIrq(void);
+uint32_t stackIrqUsedSize(unsigned level);
+
+// Called on entry of the common interrupt dispatchers to record the stack in use by the contexts they preempted
+#define STACK_CHECK_IRQ() stackCheckIrq()
+#else
+#define STACK_CHECK_IRQ()
+#endif
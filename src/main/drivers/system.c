@@ -25,6 +25,7 @@
 #include "platform.h"
 
 #include "build/atomic.h"
+#include "build/pc_sampling.h"
 
 #include "drivers/io.h"
 #include "drivers/light_led.h"
@@ -85,7 +86,7 @@ void cycleCounterInit(void)
 
 static volatile int sysTickPending = 0;
 
-void SysTick_Handler(void)
+static void sysTickUpdate(void)
 {
     ATOMIC_BLOCK(NVIC_PRIO_MAX) {
         sysTickUptime++;
@@ -99,6 +100,35 @@ void SysTick_Handler(void)
 #endif
 }
 
+#ifdef USE_PC_SAMPLING
+void sysTickHandler(const uint32_t *exceptionFrame) __attribute__((used));
+
+// Hand the exception frame of the interrupted code to sysTickHandler(), the stack it is on is given by EXC_RETURN in lr
+__attribute__((naked)) void SysTick_Handler(void)
+{
+    __asm volatile (
+        "tst lr, #4\n"
+        "ite eq\n"
+        "mrseq r0, msp\n"
+        "mrsne r0, psp\n"
+        "b sysTickHandler\n"
+    );
+}
+
+void sysTickHandler(const uint32_t *exceptionFrame)
+{
+    // the frame holds r0-r3, r12, lr, pc and xpsr
+    pcSamplingRecord(exceptionFrame[6]);
+
+    sysTickUpdate();
+}
+#else
+void SysTick_Handler(void)
+{
+    sysTickUpdate();
+}
+#endif
+
 // Return system uptime in microseconds (rollover in 70minutes)
 
 uint32_t microsISR(void)
@@ -156,6 +186,21 @@ uint32_t clockCyclesToMicros(uint32_t clockCycles)
     return clockCycles / usTicks;
 }
 
+uint32_t clockCyclesTo10thMicros(uint32_t clockCycles)
+{
+    return ((uint64_t)clockCycles * 10) / usTicks;
+}
+
+uint32_t clockCyclesToNanos(uint32_t clockCycles)
+{
+    return ((uint64_t)clockCycles * 1000) / usTicks;
+}
+
+uint32_t clockMicrosToCycles(uint32_t micros)
+{
+    return micros * usTicks;
+}
+
 // Return system uptime in milliseconds (rollover in 49 days)
 uint32_t millis(void)
 {
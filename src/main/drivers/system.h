@@ -65,6 +65,9 @@ void systemResetToBootloader(bootloaderRequestType_e requestType);
 bool isMPUSoftReset(void);
 void cycleCounterInit(void);
 uint32_t clockCyclesToMicros(uint32_t clockCycles);
+uint32_t clockCyclesTo10thMicros(uint32_t clockCycles);
+uint32_t clockCyclesToNanos(uint32_t clockCycles);
+uint32_t clockMicrosToCycles(uint32_t micros);
 uint32_t getCycleCounter(void);
 #if defined(STM32H7) || defined(STM32G4)
 void systemCheckResetReason(void);
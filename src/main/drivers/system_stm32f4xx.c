@@ -172,4 +172,8 @@ void systemInit(void)
 
     // SysTick
     SysTick_Config(SystemCoreClock / 1000);
+#ifdef USE_PC_SAMPLING
+    // SysTick_Config() leaves it at the lowest priority, raise it so the profiler samples the interrupt handlers too
+    NVIC_SetPriority(SysTick_IRQn, NVIC_PRIO_MAX >> (8 - __NVIC_PRIO_BITS));
+#endif
 }
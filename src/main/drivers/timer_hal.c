@@ -1021,6 +1021,18 @@ void timerForceOverflow(TIM_TypeDef *tim)
     }
 }
 
+// Force an overflow on a group of timers back to back, so that their update events are only a few cycles apart
+void timerForceOverflowGroup(TIM_TypeDef * const *tims, uint8_t count)
+{
+    ATOMIC_BLOCK(NVIC_PRIO_TIMER) {
+        for (unsigned i = 0; i < count; i++) {
+            TIM_TypeDef *tim = tims[i];
+            timerConfig[lookupTimerIndex(tim)].forcedOverflowTimerValue = tim->CNT + 1;
+            tim->EGR |= TIM_EGR_UG;
+        }
+    }
+}
+
 // DMA_Handle_index
 uint16_t timerDmaIndex(uint8_t channel)
 {
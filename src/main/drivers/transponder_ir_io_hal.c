@@ -50,13 +50,7 @@ static uint8_t alternateFunction;
 #error "Transponder (via HAL) not supported on this MCU."
 #endif
 
-#if defined(STM32H7)
-DMA_RAM transponder_t transponder;
-#elif defined(STM32G4)
-DMA_RAM_W transponder_t transponder;
-#else
-transponder_t transponder;
-#endif
+DMA_BUFFER_W transponder_t transponder;
 bool transponderInitialised = false;
 
 static void TRANSPONDER_DMA_IRQHandler(dmaChannelDescriptor_t* descriptor)
@@ -29,6 +29,7 @@
 #include "blackbox/blackbox_fielddefs.h"
 
 #include "build/debug.h"
+#include "build/latency.h"
 
 #include "cli/cli.h"
 
@@ -304,34 +305,22 @@ void updateArmingStatus(void)
             hadRx = haveRx;
         }
 
+        // the conditions that are only polled here are collected and applied in one update
+        armingDisableFlags_e polledFlags = 0;
         if (IS_RC_MODE_ACTIVE(BOXFAILSAFE)) {
-            setArmingDisabled(ARMING_DISABLED_BOXFAILSAFE);
-        } else {
-            unsetArmingDisabled(ARMING_DISABLED_BOXFAILSAFE);
+            polledFlags |= ARMING_DISABLED_BOXFAILSAFE;
         }
-
         if (calculateThrottleStatus() != THROTTLE_LOW) {
-            setArmingDisabled(ARMING_DISABLED_THROTTLE);
-        } else {
-            unsetArmingDisabled(ARMING_DISABLED_THROTTLE);
+            polledFlags |= ARMING_DISABLED_THROTTLE;
         }
-
         if (!isUpright() && !IS_RC_MODE_ACTIVE(BOXFLIPOVERAFTERCRASH)) {
-            setArmingDisabled(ARMING_DISABLED_ANGLE);
-        } else {
-            unsetArmingDisabled(ARMING_DISABLED_ANGLE);
+            polledFlags |= ARMING_DISABLED_ANGLE;
         }
-
         if (getAverageSystemLoadPercent() > LOAD_PERCENTAGE_ONE) {
-            setArmingDisabled(ARMING_DISABLED_LOAD);
-        } else {
-            unsetArmingDisabled(ARMING_DISABLED_LOAD);
+            polledFlags |= ARMING_DISABLED_LOAD;
         }
-
         if (isCalibrating()) {
-            setArmingDisabled(ARMING_DISABLED_CALIBRATING);
-        } else {
-            unsetArmingDisabled(ARMING_DISABLED_CALIBRATING);
+            polledFlags |= ARMING_DISABLED_CALIBRATING;
         }
 
         if (isModeActivationConditionPresent(BOXPREARM)) {
@@ -361,17 +350,13 @@ void updateArmingStatus(void)
         // USE_RPM_FILTER will only be defined if USE_DSHOT and USE_DSHOT_TELEMETRY are defined
         // If the RPM filter is anabled and any motor isn't providing telemetry, then disable arming
         if (isRpmFilterEnabled() && !isDshotTelemetryActive()) {
-            setArmingDisabled(ARMING_DISABLED_RPMFILTER);
-        } else {
-            unsetArmingDisabled(ARMING_DISABLED_RPMFILTER);
+            polledFlags |= ARMING_DISABLED_RPMFILTER;
         }
 #endif
 
 #ifdef USE_DSHOT_BITBANG
         if (isDshotBitbangActive(&motorConfig()->dev) && dshotBitbangGetStatus() != DSHOT_BITBANG_STATUS_OK) {
-            setArmingDisabled(ARMING_DISABLED_DSHOT_BITBANG);
-        } else {
-            unsetArmingDisabled(ARMING_DISABLED_DSHOT_BITBANG);
+            polledFlags |= ARMING_DISABLED_DSHOT_BITBANG;
         }
 #endif
 
@@ -381,12 +366,12 @@ void updateArmingStatus(void)
 
 #ifdef USE_ACC
         if (accNeedsCalibration()) {
-            setArmingDisabled(ARMING_DISABLED_ACC_CALIBRATION);
-        } else {
-            unsetArmingDisabled(ARMING_DISABLED_ACC_CALIBRATION);
+            polledFlags |= ARMING_DISABLED_ACC_CALIBRATION;
         }
 #endif
 
+        updateArmingDisabled(ARMING_DISABLED_POLLED, polledFlags);
+
         if (!isMotorProtocolEnabled()) {
             setArmingDisabled(ARMING_DISABLED_MOTOR_PROTOCOL);
         }
@@ -749,7 +734,7 @@ bool processRx(timeUs_t currentTimeUs)
     static bool sharedPortTelemetryEnabled = false;
 #endif
 
-    timeDelta_t frameAgeUs;
+    timeDelta_t frameAgeUs = 0;
     timeDelta_t frameDeltaUs = rxGetFrameDelta(&frameAgeUs);
 
     DEBUG_SET(DEBUG_RX_TIMING, 0, MIN(frameDeltaUs / 10, INT16_MAX));
@@ -759,6 +744,8 @@ bool processRx(timeUs_t currentTimeUs)
         return false;
     }
 
+    LATENCY_RX_FRAME(frameAgeUs);
+
     updateRcRefreshRate(currentTimeUs);
 
     // in 3D mode, we need to be able to disarm by switch at any time
@@ -1089,10 +1076,10 @@ bool processRx(timeUs_t currentTimeUs)
 static FAST_CODE void subTaskPidController(timeUs_t currentTimeUs)
 {
     uint32_t startTime = 0;
-    if (debugMode == DEBUG_PIDLOOP) {startTime = micros();}
+    if (debugModeIsEnabled(DEBUG_PIDLOOP)) {startTime = micros();}
     // PID - note this is function pointer set by setPIDController()
     pidController(currentPidProfile, currentTimeUs);
-    DEBUG_SET(DEBUG_PIDLOOP, 1, micros() - startTime);
+    DEBUG_SET_IF_ENABLED(DEBUG_PIDLOOP, 1, micros() - startTime);
 
 #ifdef USE_RUNAWAY_TAKEOFF
     // Check to see if runaway takeoff detection is active (anti-taz), the pidSum is over the threshold,
@@ -1143,7 +1130,7 @@ static FAST_CODE void subTaskPidController(timeUs_t currentTimeUs)
 static FAST_CODE_NOINLINE void subTaskPidSubprocesses(timeUs_t currentTimeUs)
 {
     uint32_t startTime = 0;
-    if (debugMode == DEBUG_PIDLOOP) {
+    if (debugModeIsEnabled(DEBUG_PIDLOOP)) {
         startTime = micros();
     }
 
@@ -1153,15 +1140,27 @@ static FAST_CODE_NOINLINE void subTaskPidSubprocesses(timeUs_t currentTimeUs)
     }
 #endif
 
+#ifdef USE_ACC
+    if (sensors(SENSOR_ACC)) {
+        imuPredictLevelAttitude(pidGetDT());
+    }
+#endif
+
+#ifdef USE_GPS_RESCUE
+    if (sensors(SENSOR_GPS) && sensors(SENSOR_ACC)) {
+        gpsRescuePropagateEstimate(pidGetDT());
+    }
+#endif
+
 #ifdef USE_BLACKBOX
     if (!cliMode && blackboxConfig()->device) {
-        blackboxUpdate(currentTimeUs);
+        blackboxCaptureIteration(currentTimeUs);
     }
 #else
     UNUSED(currentTimeUs);
 #endif
 
-    DEBUG_SET(DEBUG_PIDLOOP, 3, micros() - startTime);
+    DEBUG_SET_IF_ENABLED(DEBUG_PIDLOOP, 3, micros() - startTime);
 }
 
 #ifdef USE_TELEMETRY
@@ -1180,15 +1179,17 @@ void subTaskTelemetryPollSensors(timeUs_t currentTimeUs)
 
 static FAST_CODE void subTaskMotorUpdate(timeUs_t currentTimeUs)
 {
+    LATENCY_MARK(LATENCY_STAGE_MOTOR_UPDATE);
+
     uint32_t startTime = 0;
-    if (debugMode == DEBUG_CYCLETIME) {
+    if (debugModeIsEnabled(DEBUG_CYCLETIME)) {
         startTime = micros();
         static uint32_t previousMotorUpdateTime;
         const uint32_t currentDeltaTime = startTime - previousMotorUpdateTime;
         debug[2] = currentDeltaTime;
         debug[3] = currentDeltaTime - targetPidLooptime;
         previousMotorUpdateTime = startTime;
-    } else if (debugMode == DEBUG_PIDLOOP) {
+    } else if (debugModeIsEnabled(DEBUG_PIDLOOP)) {
         startTime = micros();
     }
 
@@ -1204,7 +1205,7 @@ static FAST_CODE void subTaskMotorUpdate(timeUs_t currentTimeUs)
     writeMotors();
 
 #ifdef USE_DSHOT_TELEMETRY_STATS
-    if (debugMode == DEBUG_DSHOT_RPM_ERRORS && useDshotTelemetry) {
+    if (debugModeIsEnabled(DEBUG_DSHOT_RPM_ERRORS) && useDshotTelemetry) {
         const uint8_t motorCount = MIN(getMotorCount(), 4);
         for (uint8_t i = 0; i < motorCount; i++) {
             debug[i] = getDshotTelemetryMotorInvalidPercent(i);
@@ -1212,7 +1213,7 @@ static FAST_CODE void subTaskMotorUpdate(timeUs_t currentTimeUs)
     }
 #endif
 
-    DEBUG_SET(DEBUG_PIDLOOP, 2, micros() - startTime);
+    DEBUG_SET_IF_ENABLED(DEBUG_PIDLOOP, 2, micros() - startTime);
 }
 
 static FAST_CODE_NOINLINE void subTaskRcCommand(timeUs_t currentTimeUs)
@@ -1242,7 +1243,8 @@ FAST_CODE void taskGyroSample(timeUs_t currentTimeUs)
 {
     UNUSED(currentTimeUs);
     gyroUpdate();
-    if (pidUpdateCounter % activePidLoopDenom == 0) {
+    LATENCY_MARK(LATENCY_STAGE_GYRO_SAMPLE);
+    if (pidUpdateCounter % activeGyroUpdateDenom == 0) {
         pidUpdateCounter = 0;
     }
     pidUpdateCounter++;
@@ -1250,7 +1252,7 @@ FAST_CODE void taskGyroSample(timeUs_t currentTimeUs)
 
 FAST_CODE bool gyroFilterReady(void)
 {
-    if (pidUpdateCounter % activePidLoopDenom == 0) {
+    if (pidUpdateCounter % activeGyroUpdateDenom == 0) {
         return true;
     } else {
         return false;
@@ -1259,7 +1261,7 @@ FAST_CODE bool gyroFilterReady(void)
 
 FAST_CODE bool pidLoopReady(void)
 {
-    if ((pidUpdateCounter % activePidLoopDenom) == (activePidLoopDenom / 2)) {
+    if ((pidUpdateCounter % activeGyroUpdateDenom) == (activeGyroUpdateDenom / 2)) {
         return true;
     }
     return false;
@@ -1267,6 +1269,7 @@ FAST_CODE bool pidLoopReady(void)
 
 FAST_CODE void taskFiltering(timeUs_t currentTimeUs)
 {
+    LATENCY_MARK(LATENCY_STAGE_FILTER);
     gyroFiltering(currentTimeUs);
 
 }
@@ -1279,19 +1282,21 @@ FAST_CODE void taskMainPidLoop(timeUs_t currentTimeUs)
     if (lockMainPID() != 0) return;
 #endif
 
+    LATENCY_MARK(LATENCY_STAGE_PID);
+
     // DEBUG_PIDLOOP, timings for:
     // 0 - gyroUpdate()
     // 1 - subTaskPidController()
     // 2 - subTaskMotorUpdate()
     // 3 - subTaskPidSubprocesses()
-    DEBUG_SET(DEBUG_PIDLOOP, 0, micros() - currentTimeUs);
+    DEBUG_SET_IF_ENABLED(DEBUG_PIDLOOP, 0, micros() - currentTimeUs);
 
     subTaskRcCommand(currentTimeUs);
     subTaskPidController(currentTimeUs);
     subTaskMotorUpdate(currentTimeUs);
     subTaskPidSubprocesses(currentTimeUs);
 
-    if (debugMode == DEBUG_CYCLETIME) {
+    if (debugModeIsEnabled(DEBUG_CYCLETIME)) {
         DEBUG_SET(DEBUG_CYCLETIME, 0, getTaskDeltaTimeUs(TASK_SELF));
         DEBUG_SET(DEBUG_CYCLETIME, 1, getAverageSystemLoadPercent());
     }
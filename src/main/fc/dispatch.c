@@ -24,15 +24,116 @@
 
 #include "platform.h"
 
+#if !defined(SIMULATOR_BUILD) && !defined(UNIT_TEST)
+// Urgent entries run from PendSV, which is at the lowest priority so it only preempts the main loop
+#define USE_DISPATCH_PENDSV
+#endif
+
+#ifdef USE_DISPATCH_PENDSV
+#include "build/atomic.h"
+#endif
+
 #include "common/utils.h"
 
+#include "drivers/nvic.h"
 #include "drivers/time.h"
 
 #include "fc/dispatch.h"
 
-static dispatchEntry_t *head = NULL;
+#ifdef USE_DISPATCH_PENDSV
+// Entries may be added from interrupts up to the PendSV priority, which then keep off the queues
+#define DISPATCH_ATOMIC_BLOCK ATOMIC_BLOCK(NVIC_PRIO_DISPATCH)
+#else
+#define DISPATCH_ATOMIC_BLOCK
+#endif
+
+// Binary min heap on delayedUntil, one per priority
+typedef struct dispatchQueue_s {
+    dispatchEntry_t *entries[DISPATCH_QUEUE_SIZE];
+    unsigned count;
+} dispatchQueue_t;
+
+static dispatchQueue_t queues[DISPATCH_PRIORITY_COUNT];
 static bool dispatchEnabled = false;
 
+static bool dispatchBefore(const dispatchEntry_t *a, const dispatchEntry_t *b)
+{
+    return cmp32(a->delayedUntil, b->delayedUntil) < 0;
+}
+
+static bool dispatchQueueIsDue(const dispatchQueue_t *queue, uint32_t currentTime)
+{
+    return queue->count && cmp32(currentTime, queue->entries[0]->delayedUntil) >= 0;
+}
+
+static bool dispatchQueuePush(dispatchQueue_t *queue, dispatchEntry_t *entry)
+{
+    if (queue->count >= DISPATCH_QUEUE_SIZE) {
+        return false;
+    }
+
+    unsigned i = queue->count++;
+    while (i > 0) {
+        const unsigned parent = (i - 1) / 2;
+        if (!dispatchBefore(entry, queue->entries[parent])) {
+            break;
+        }
+        queue->entries[i] = queue->entries[parent];
+        i = parent;
+    }
+    queue->entries[i] = entry;
+
+    return true;
+}
+
+static dispatchEntry_t *dispatchQueuePopDue(dispatchQueue_t *queue, uint32_t currentTime)
+{
+    dispatchEntry_t *due = NULL;
+
+    DISPATCH_ATOMIC_BLOCK {
+        if (dispatchQueueIsDue(queue, currentTime)) {
+            due = queue->entries[0];
+            due->inQue = false;
+
+            const dispatchEntry_t *last = queue->entries[--queue->count];
+            unsigned i = 0;
+            for (unsigned child = 1; child < queue->count; child = 2 * i + 1) {
+                if (child + 1 < queue->count && dispatchBefore(queue->entries[child + 1], queue->entries[child])) {
+                    child++;
+                }
+                if (!dispatchBefore(queue->entries[child], last)) {
+                    break;
+                }
+                queue->entries[i] = queue->entries[child];
+                i = child;
+            }
+            queue->entries[i] = (dispatchEntry_t *)last;
+        }
+    }
+
+    return due;
+}
+
+static void dispatchQueueProcess(dispatchQueue_t *queue, uint32_t currentTime)
+{
+    // the entry is unlinked first, so the handler can replan self
+    for (dispatchEntry_t *entry; (entry = dispatchQueuePopDue(queue, currentTime)); ) {
+        (*entry->dispatch)(entry);
+    }
+}
+
+#ifdef USE_DISPATCH_PENDSV
+static void dispatchPendUrgent(void)
+{
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+}
+
+void PendSV_Handler(void)
+{
+    dispatchQueueProcess(&queues[DISPATCH_PRIORITY_URGENT], micros());
+}
+#endif
+
 bool dispatchIsEnabled(void)
 {
     return dispatchEnabled;
@@ -40,36 +141,47 @@ bool dispatchIsEnabled(void)
 
 void dispatchEnable(void)
 {
+#ifdef USE_DISPATCH_PENDSV
+    NVIC_SetPriority(PendSV_IRQn, NVIC_PRIO_DISPATCH >> (8 - __NVIC_PRIO_BITS));
+#endif
     dispatchEnabled = true;
 }
 
 void dispatchProcess(uint32_t currentTime)
 {
-    for (dispatchEntry_t **p = &head; *p; ) {
-        if (cmp32(currentTime, (*p)->delayedUntil) < 0)
-            break;
-        // unlink entry first, so handler can replan self
-        dispatchEntry_t *current = *p;
-        *p = (*p)->next;
-        current->inQue = false;
-        (*current->dispatch)(current);
+#ifdef USE_DISPATCH_PENDSV
+    // urgent entries added with a delay are handed to PendSV once due, so they never run in two contexts
+    if (dispatchQueueIsDue(&queues[DISPATCH_PRIORITY_URGENT], currentTime)) {
+        dispatchPendUrgent();
+    }
+    const int firstPriority = DISPATCH_PRIORITY_URGENT - 1;
+#else
+    const int firstPriority = DISPATCH_PRIORITY_URGENT;
+#endif
+
+    for (int priority = firstPriority; priority >= DISPATCH_PRIORITY_NORMAL; priority--) {
+        dispatchQueueProcess(&queues[priority], currentTime);
     }
 }
 
 void dispatchAdd(dispatchEntry_t *entry, int delayUs)
 {
-    uint32_t delayedUntil = micros() + delayUs;
-    dispatchEntry_t **p = &head;
+    const uint32_t delayedUntil = micros() + delayUs;
+    bool added = false;
 
-    if (entry->inQue) {
-      return;    // Allready in Queue, abort
+    DISPATCH_ATOMIC_BLOCK {
+        // an entry already in a queue keeps its time, a full queue drops the entry
+        if (!entry->inQue) {
+            entry->delayedUntil = delayedUntil;
+            entry->inQue = added = dispatchQueuePush(&queues[entry->priority], entry);
+        }
     }
 
-    while (*p && cmp32((*p)->delayedUntil, delayedUntil) < 0)
-        p = &(*p)->next;
-
-    entry->next = *p;
-    entry->delayedUntil = delayedUntil;
-    entry->inQue = true;
-    *p = entry;
+#ifdef USE_DISPATCH_PENDSV
+    if (added && entry->priority == DISPATCH_PRIORITY_URGENT && delayUs <= 0) {
+        dispatchPendUrgent();
+    }
+#else
+    UNUSED(added);
+#endif
 }
@@ -20,13 +20,26 @@
 
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+
+#define DISPATCH_QUEUE_SIZE 8 // entries per priority
+
+// Due entries run highest priority first, urgent ones from PendSV as soon as they are due
+typedef enum {
+    DISPATCH_PRIORITY_NORMAL = 0,
+    DISPATCH_PRIORITY_HIGH,
+    DISPATCH_PRIORITY_URGENT,
+    DISPATCH_PRIORITY_COUNT
+} dispatchPriority_e;
+
 struct dispatchEntry_s;
 typedef void dispatchFunc(struct dispatchEntry_s* self);
 
 typedef struct dispatchEntry_s {
     dispatchFunc *dispatch;
     uint32_t delayedUntil;
-    struct dispatchEntry_s *next;
+    dispatchPriority_e priority;
     bool inQue;
 } dispatchEntry_t;
 
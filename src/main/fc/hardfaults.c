@@ -24,6 +24,8 @@
 #include "platform.h"
 
 #include "drivers/light_led.h"
+#include "drivers/persistent.h"
+#include "drivers/system.h"
 #include "drivers/time.h"
 #include "drivers/transponder_ir.h"
 
@@ -122,8 +124,26 @@ void hard_fault_handler_c(unsigned long *hardfault_args)
   __asm("BKPT #0\n") ; // Break into the debugger
 }
 
+#else
+#ifdef USE_PERSISTENT_OBJECTS
+void hardFaultHandler(const uint32_t *exceptionFrame) __attribute__((used));
+
+// Hand the exception frame of the faulting code to hardFaultHandler(), the stack it is on is given by EXC_RETURN in lr
+__attribute__((naked)) void HardFault_Handler(void)
+{
+    __asm volatile (
+        "tst lr, #4\n"
+        "ite eq\n"
+        "mrseq r0, msp\n"
+        "mrsne r0, psp\n"
+        "b hardFaultHandler\n"
+    );
+}
+
+void hardFaultHandler(const uint32_t *exceptionFrame)
 #else
 void HardFault_Handler(void)
+#endif
 {
     LED0_ON;
     LED1_ON;
@@ -143,6 +163,24 @@ void HardFault_Handler(void)
     }
 #endif
 
+#ifdef USE_PERSISTENT_OBJECTS
+    // the frame holds r0-r3, r12, lr, pc and xpsr, keep the context for the cli status after the software reset
+    const uint32_t cfsr = SCB->CFSR;
+    uint32_t address = 0;
+    if (cfsr & SCB_CFSR_BFARVALID_Msk) {
+        address = SCB->BFAR;
+    } else if (cfsr & SCB_CFSR_MMARVALID_Msk) {
+        address = SCB->MMFAR;
+    }
+    persistentObjectWrite(PERSISTENT_OBJECT_FAULT_PC, exceptionFrame[6]);
+    persistentObjectWrite(PERSISTENT_OBJECT_FAULT_LR, exceptionFrame[5]);
+    persistentObjectWrite(PERSISTENT_OBJECT_FAULT_SP, (uint32_t)exceptionFrame);
+    persistentObjectWrite(PERSISTENT_OBJECT_FAULT_CFSR, cfsr);
+    persistentObjectWrite(PERSISTENT_OBJECT_FAULT_ADDRESS, address);
+
+    systemReset();
+#endif
+
     LED0_OFF;
     LED1_OFF;
     LED2_OFF;
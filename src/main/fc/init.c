@@ -463,7 +463,7 @@ void init(void)
     }
 #endif
 
-    debugMode = systemConfig()->debug_mode;
+    debugInit();
 
 #ifdef TARGET_PREINIT
     targetPreInit();
@@ -764,26 +764,9 @@ void init(void)
     pinioBoxInit(pinioBoxConfig());
 #endif
 
-    LED1_ON;
-    LED0_OFF;
-    LED2_OFF;
-
-    for (int i = 0; i < 10; i++) {
-        LED1_TOGGLE;
-        LED0_TOGGLE;
-#if defined(USE_BEEPER)
-        delay(25);
-        if (!(beeperConfig()->beeper_off_flags & BEEPER_GET_FLAG(BEEPER_SYSTEM_INIT))) {
-            BEEP_ON;
-        }
-        delay(25);
-        BEEP_OFF;
-#else
-        delay(50);
-#endif
-    }
     LED0_OFF;
     LED1_OFF;
+    LED2_OFF;
 
     imuInit();
 
@@ -1022,6 +1005,9 @@ void init(void)
 
     setArmingDisabled(ARMING_DISABLED_BOOT_GRACE_TIME);
 
+    // The power-on beeps and LED flashes are played by the beeper task rather than blocking init()
+    beeper(BEEPER_SYSTEM_INIT);
+
 #ifdef USE_MOTOR
     motorPostInit();
     motorEnable();
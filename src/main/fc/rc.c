@@ -25,6 +25,7 @@
 #include "platform.h"
 
 #include "build/debug.h"
+#include "build/latency.h"
 
 #include "common/axis.h"
 #include "common/maths.h"
@@ -33,6 +34,8 @@
 #include "config/config.h"
 #include "config/feature.h"
 
+#include "drivers/time.h"
+
 #include "fc/controlrate_profile.h"
 #include "fc/core.h"
 #include "fc/rc.h"
@@ -64,6 +67,11 @@ static float rawSetpoint[XYZ_AXIS_COUNT];
 // Stick deflection [-1.0, 1.0] before RC-Smoothing is applied
 static float rawDeflection[XYZ_AXIS_COUNT];
 static float oldRcCommand[XYZ_AXIS_COUNT];
+
+#define RC_PREDICTION_MAX_FRAMES 2   // Maximum number of consecutive late frames extrapolated for feedforward
+static float rawSetpointDelta[XYZ_AXIS_COUNT];
+static timeUs_t nextRxFrameDueUs;
+static uint8_t predictedFrames;
 #endif
 static float setpointRate[3], rcDeflection[3], rcDeflectionAbs[3];
 static float throttlePIDAttenuation;
@@ -88,10 +96,10 @@ enum {
 #define RC_SMOOTHING_IDENTITY_FREQUENCY         80    // Used in the formula to convert a BIQUAD cutoff frequency to PT1
 #define RC_SMOOTHING_FILTER_STARTUP_DELAY_MS    5000  // Time to wait after power to let the PID loop stabilize before starting average frame rate calculation
 #define RC_SMOOTHING_FILTER_TRAINING_SAMPLES    50    // Number of rx frame rate samples to average during initial training
-#define RC_SMOOTHING_FILTER_RETRAINING_SAMPLES  20    // Number of rx frame rate samples to average during frame rate changes
 #define RC_SMOOTHING_FILTER_TRAINING_DELAY_MS   1000  // Additional time to wait after receiving first valid rx frame before initial training starts
-#define RC_SMOOTHING_FILTER_RETRAINING_DELAY_MS 2000  // Guard time to wait after retraining to prevent retraining again too quickly
-#define RC_SMOOTHING_RX_RATE_CHANGE_PERCENT     20    // Look for samples varying this much from the current detected frame rate to initiate retraining
+#define RC_SMOOTHING_FILTER_RETRAINING_DELAY_MS 2000  // Guard time to wait after training before the rolling frame rate estimate takes over
+#define RC_SMOOTHING_RX_RATE_ESTIMATE_GAIN      0.05f // Rolling frame interval estimate gain, a time constant of about 20 frames
+#define RC_SMOOTHING_RX_RATE_CHANGE_PERCENT     10    // Retune the filters when the rolling estimate moves this much from the rate in use
 #define RC_SMOOTHING_RX_RATE_MIN_US             1000  // 1ms
 #define RC_SMOOTHING_RX_RATE_MAX_US             50000 // 50ms or 20hz
 #define RC_SMOOTHING_INTERPOLATED_FEEDFORWARD_DERIVATIVE_PT1_HZ 100 // The value to use for "auto" when interpolated feedforward is enabled
@@ -230,6 +238,114 @@ float applyQuickRates(const int axis, float rcCommandf, const float rcCommandfAb
     return angleRate;
 }
 
+// Rate curves are compiled into a piecewise cubic Hermite table over |deflection| in [0, 1]
+// so the RC path avoids the divisions and powers of the rate functions above. The table
+// keeps a copy of the profile fields it was compiled from and recompiles itself when any
+// of them change (CLI, MSP, in-flight adjustments), so it can never go stale.
+#define RC_RATE_TABLE_SEGMENTS 32
+#define RC_RATE_TABLE_SLOPE_STEP 0.001f
+#define RC_RATE_TABLE_MAX_ERROR 0.5f // deg/s, curves that can't be matched this closely use the rate function
+
+typedef struct rcRateTable_s {
+    applyRatesFn *applyRates;
+    uint8_t rcRate;
+    uint8_t rcExpo;
+    uint8_t rate;
+    uint8_t quickRatesRcExpo;
+    bool valid;
+    float value[RC_RATE_TABLE_SEGMENTS + 1];
+    float slope[RC_RATE_TABLE_SEGMENTS + 1]; // per segment, not per unit of deflection
+} rcRateTable_t;
+
+static FAST_DATA_ZERO_INIT rcRateTable_t rcRateTable[XYZ_AXIS_COUNT];
+
+static float rcRateTableInterpolate(const rcRateTable_t *table, float rcCommandfAbs)
+{
+    const float position = rcCommandfAbs * RC_RATE_TABLE_SEGMENTS;
+    const int i = MIN((int)position, RC_RATE_TABLE_SEGMENTS - 1);
+    const float t = position - i;
+    const float t2 = t * t;
+    const float t3 = t2 * t;
+
+    return (2.0f * t3 - 3.0f * t2 + 1.0f) * table->value[i] + (t3 - 2.0f * t2 + t) * table->slope[i]
+        + (3.0f * t2 - 2.0f * t3) * table->value[i + 1] + (t3 - t2) * table->slope[i + 1];
+}
+
+static bool rcRateTableIsCurrent(const rcRateTable_t *table, int axis)
+{
+    return table->applyRates == applyRates
+        && table->rcRate == currentControlRateProfile->rcRates[axis]
+        && table->rcExpo == currentControlRateProfile->rcExpo[axis]
+        && table->rate == currentControlRateProfile->rates[axis]
+        && table->quickRatesRcExpo == currentControlRateProfile->quickRatesRcExpo;
+}
+
+static void rcRateTableBuild(int axis)
+{
+    rcRateTable_t *table = &rcRateTable[axis];
+
+    table->applyRates = applyRates;
+    table->rcRate = currentControlRateProfile->rcRates[axis];
+    table->rcExpo = currentControlRateProfile->rcExpo[axis];
+    table->rate = currentControlRateProfile->rates[axis];
+    table->quickRatesRcExpo = currentControlRateProfile->quickRatesRcExpo;
+
+    // Node slopes come from the rate function itself, sampled just around each node
+    for (int i = 0; i <= RC_RATE_TABLE_SEGMENTS; i++) {
+        const float x = (float)i / RC_RATE_TABLE_SEGMENTS;
+        const float lo = MAX(x - RC_RATE_TABLE_SLOPE_STEP, 0.0f);
+        const float hi = MIN(x + RC_RATE_TABLE_SLOPE_STEP, 1.0f);
+        table->value[i] = applyRates(axis, x, x);
+        table->slope[i] = (applyRates(axis, hi, hi) - applyRates(axis, lo, lo)) / ((hi - lo) * RC_RATE_TABLE_SEGMENTS);
+    }
+
+    // Fritsch-Carlson limit keeps the interpolation monotonic like the curves themselves
+    float secant[RC_RATE_TABLE_SEGMENTS];
+    for (int i = 0; i < RC_RATE_TABLE_SEGMENTS; i++) {
+        secant[i] = table->value[i + 1] - table->value[i];
+    }
+    for (int i = 0; i < RC_RATE_TABLE_SEGMENTS; i++) {
+        if (secant[i] == 0.0f) {
+            table->slope[i] = 0.0f;
+            table->slope[i + 1] = 0.0f;
+            continue;
+        }
+        const float a = table->slope[i] / secant[i];
+        const float b = table->slope[i + 1] / secant[i];
+        const float magnitude = a * a + b * b;
+        if (magnitude > 9.0f) {
+            const float tau = 3.0f / sqrtf(magnitude);
+            table->slope[i] = tau * a * secant[i];
+            table->slope[i + 1] = tau * b * secant[i];
+        }
+    }
+
+    // Steep super rate curves near the stick end can't be followed closely, keep the exact function for those
+    table->valid = true;
+    for (int i = 0; i < RC_RATE_TABLE_SEGMENTS * 4; i++) {
+        const float x = (i + 0.5f) / (RC_RATE_TABLE_SEGMENTS * 4);
+        if (fabsf(rcRateTableInterpolate(table, x) - applyRates(axis, x, x)) > RC_RATE_TABLE_MAX_ERROR) {
+            table->valid = false;
+            break;
+        }
+    }
+}
+
+static FAST_CODE float applyRatesTable(const int axis, float rcCommandf, const float rcCommandfAbs)
+{
+    const rcRateTable_t *table = &rcRateTable[axis];
+
+    if (!rcRateTableIsCurrent(table, axis)) {
+        rcRateTableBuild(axis);
+    }
+    if (!table->valid || rcCommandfAbs > 1.0f) {
+        return applyRates(axis, rcCommandf, rcCommandfAbs);
+    }
+
+    const float angleRate = rcRateTableInterpolate(table, rcCommandfAbs);
+    return (rcCommandf < 0.0f) ? -angleRate : angleRate;
+}
+
 float applyCurve(int axis, float deflection)
 {
     return applyRates(axis, deflection, fabsf(deflection));
@@ -268,7 +384,7 @@ static void calculateSetpointRate(int axis)
         const float rcCommandfAbs = fabsf(rcCommandf);
         rcDeflectionAbs[axis] = rcCommandfAbs;
 
-        angleRate = applyRates(axis, rcCommandf, rcCommandfAbs);
+        angleRate = applyRatesTable(axis, rcCommandf, rcCommandfAbs);
     }
     // Rate limit from profile (deg/sec)
     setpointRate[axis] = constrainf(angleRate, -1.0f * currentControlRateProfile->rate_limit[axis], 1.0f * currentControlRateProfile->rate_limit[axis]);
@@ -497,11 +613,35 @@ static FAST_CODE bool rcSmoothingAccumulateSample(rcSmoothingFilter_t *smoothing
     smoothingData->training.min = MIN(smoothingData->training.min, rxFrameTimeUs);
 
     // if we've collected enough samples then calculate the average and reset the accumulation
-    const int sampleLimit = (rcSmoothingData.filterInitialized) ? RC_SMOOTHING_FILTER_RETRAINING_SAMPLES : RC_SMOOTHING_FILTER_TRAINING_SAMPLES;
-    if (smoothingData->training.count >= sampleLimit) {
+    if (smoothingData->training.count >= RC_SMOOTHING_FILTER_TRAINING_SAMPLES) {
         smoothingData->training.sum = smoothingData->training.sum - smoothingData->training.min - smoothingData->training.max; // Throw out high and low samples
         smoothingData->averageFrameTimeUs = lrintf(smoothingData->training.sum / (smoothingData->training.count - 2));
         rcSmoothingResetAccumulation(smoothingData);
+
+        // seed the rolling estimate with the trained average
+        for (unsigned i = 0; i < ARRAYLEN(smoothingData->frameTimeWindowUs); i++) {
+            smoothingData->frameTimeWindowUs[i] = smoothingData->averageFrameTimeUs;
+        }
+        smoothingData->frameTimeEstimateUs = smoothingData->averageFrameTimeUs;
+        return true;
+    }
+    return false;
+}
+
+// Track the rx frame interval after the initial training. Each sample goes through a median of three,
+// which drops single late or early frames, into an exponential average. Returns true when the estimate
+// has moved far enough from the rate currently in use that the filter cutoffs should be updated.
+static FAST_CODE bool rcSmoothingUpdateFrameTimeEstimate(rcSmoothingFilter_t *smoothingData, int rxFrameTimeUs)
+{
+    smoothingData->frameTimeWindowUs[smoothingData->frameTimeWindowIndex] = rxFrameTimeUs;
+    smoothingData->frameTimeWindowIndex = (smoothingData->frameTimeWindowIndex + 1) % ARRAYLEN(smoothingData->frameTimeWindowUs);
+
+    const int32_t medianFrameTimeUs = quickMedianFilter3(smoothingData->frameTimeWindowUs);
+    smoothingData->frameTimeEstimateUs += RC_SMOOTHING_RX_RATE_ESTIMATE_GAIN * (medianFrameTimeUs - smoothingData->frameTimeEstimateUs);
+
+    const int estimateUs = lrintf(smoothingData->frameTimeEstimateUs);
+    if (ABS(estimateUs - smoothingData->averageFrameTimeUs) * 100 > smoothingData->averageFrameTimeUs * RC_SMOOTHING_RX_RATE_CHANGE_PERCENT) {
+        smoothingData->averageFrameTimeUs = estimateUs;
         return true;
     }
     return false;
@@ -613,30 +753,18 @@ static FAST_CODE uint8_t processRcSmoothingFilter(void)
                     // if the guard time has expired then process the rx frame time
                     if (currentTimeMs > validRxFrameTimeMs) {
                         sampleState = 2;
-                        bool accumulateSample = true;
 
-                        // During initial training process all samples.
-                        // During retraining check samples to determine if they vary by more than the limit percentage.
                         if (rcSmoothingData.filterInitialized) {
-                            const float percentChange = (ABS(currentRxRefreshRate - rcSmoothingData.averageFrameTimeUs) / (float)rcSmoothingData.averageFrameTimeUs) * 100;
-                            if (percentChange < RC_SMOOTHING_RX_RATE_CHANGE_PERCENT) {
-                                // We received a sample that wasn't more than the limit percent so reset the accumulation
-                                // During retraining we need a contiguous block of samples that are all significantly different than the current average
-                                rcSmoothingResetAccumulation(&rcSmoothingData);
-                                accumulateSample = false;
-                            }
-                        }
-
-                        // accumlate the sample into the average
-                        if (accumulateSample) {
-                            if (rcSmoothingAccumulateSample(&rcSmoothingData, currentRxRefreshRate)) {
-                                // the required number of samples were collected so set the filter cutoffs
+                            // after the initial training follow the link rate continuously, eg. for dynamic packet rates
+                            if (rcSmoothingUpdateFrameTimeEstimate(&rcSmoothingData, currentRxRefreshRate)) {
                                 rcSmoothingSetFilterCutoffs(&rcSmoothingData);
-                                rcSmoothingData.filterInitialized = true;
-                                validRxFrameTimeMs = 0;
                             }
+                        } else if (rcSmoothingAccumulateSample(&rcSmoothingData, currentRxRefreshRate)) {
+                            // the required number of samples were collected so set the filter cutoffs
+                            rcSmoothingSetFilterCutoffs(&rcSmoothingData);
+                            rcSmoothingData.filterInitialized = true;
+                            validRxFrameTimeMs = 0;
                         }
-
                     }
                 } else {
                     // we have either stopped receiving rx samples (failsafe?) or the sample time is unreasonable so reset the accumulation
@@ -645,7 +773,7 @@ static FAST_CODE uint8_t processRcSmoothingFilter(void)
             }
 
             // rx frame rate training blackbox debugging
-            if (debugMode == DEBUG_RC_SMOOTHING_RATE) {
+            if (debugModeIsEnabled(DEBUG_RC_SMOOTHING_RATE)) {
                 DEBUG_SET(DEBUG_RC_SMOOTHING_RATE, 0, currentRxRefreshRate);              // log each rx frame interval
                 DEBUG_SET(DEBUG_RC_SMOOTHING_RATE, 1, rcSmoothingData.training.count);    // log the training step count
                 DEBUG_SET(DEBUG_RC_SMOOTHING_RATE, 2, rcSmoothingData.averageFrameTimeUs);// the current calculated average
@@ -654,7 +782,7 @@ static FAST_CODE uint8_t processRcSmoothingFilter(void)
         }
     }
 
-    if (rcSmoothingData.filterInitialized && (debugMode == DEBUG_RC_SMOOTHING)) {
+    if (rcSmoothingData.filterInitialized && debugModeIsEnabled(DEBUG_RC_SMOOTHING)) {
         // after training has completed then log the raw rc channel and the calculated
         // average rx frame rate that was used to calculate the automatic filter cutoffs
         DEBUG_SET(DEBUG_RC_SMOOTHING, 0, lrintf(lastRxData[rcSmoothingData.debugAxis]));
@@ -692,6 +820,7 @@ FAST_CODE void processRcCommand(void)
 
     if (isRxDataNew) {
         rcFrameNumber++;
+        LATENCY_RX_SETPOINT();
     }
 
     if (isRxDataNew && pidAntiGravityEnabled()) {
@@ -699,6 +828,7 @@ FAST_CODE void processRcCommand(void)
     }
 
 #ifdef USE_INTERPOLATED_SP
+    const timeUs_t currentTimeUs = micros();
     if (isRxDataNew) {
         for (int i = FD_ROLL; i <= FD_YAW; i++) {
             oldRcCommand[i] = rcCommand[i];
@@ -709,9 +839,24 @@ FAST_CODE void processRcCommand(void)
                 rcCommandf = rcCommand[i] / rcCommandDivider;
             }
             const float rcCommandfAbs = fabsf(rcCommandf);
-            rawSetpoint[i] = applyRates(i, rcCommandf, rcCommandfAbs);
+            const float setpoint = applyRatesTable(i, rcCommandf, rcCommandfAbs);
+            // the step following an extrapolated frame spans an unknown interval, don't project it forward
+            rawSetpointDelta[i] = predictedFrames ? 0.0f : setpoint - rawSetpoint[i];
+            rawSetpoint[i] = setpoint;
             rawDeflection[i] = rcCommandf;
         }
+        nextRxFrameDueUs = currentTimeUs + currentRxRefreshRate + currentRxRefreshRate / 2;
+        predictedFrames = 0;
+    } else if (predictedFrames < RC_PREDICTION_MAX_FRAMES && cmpTimeUs(currentTimeUs, nextRxFrameDueUs) >= 0) {
+        // the expected frame is late, extrapolate the raw setpoint along its last slope so that feedforward
+        // keeps moving instead of stalling and then seeing a double step when the next frame lands
+        for (int i = FD_ROLL; i <= FD_YAW; i++) {
+            const float rateLimit = currentControlRateProfile->rate_limit[i];
+            rawSetpoint[i] = constrainf(rawSetpoint[i] + rawSetpointDelta[i], -rateLimit, rateLimit);
+        }
+        nextRxFrameDueUs += currentRxRefreshRate;
+        predictedFrames++;
+        rcFrameNumber++;
     }
 #endif
 
@@ -896,6 +1041,10 @@ void initRcProcessing(void)
         break;
     }
 
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        rcRateTableBuild(axis);
+    }
+
     interpolationChannels = 0;
     switch (rxConfig()->rcInterpolationChannels) {
     case INTERPOLATION_CHANNELS_RPYT:
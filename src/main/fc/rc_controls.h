@@ -133,6 +133,9 @@ typedef struct rcSmoothingFilter_s {
     uint16_t derivativeCutoffFrequency;
     int averageFrameTimeUs;
     rcSmoothingFilterTraining_t training;
+    int32_t frameTimeWindowUs[3];           // last rx frame intervals, median prefilter for the rolling estimate
+    uint8_t frameTimeWindowIndex;
+    float frameTimeEstimateUs;              // rolling rx frame interval estimate used after the initial training
     uint8_t debugAxis;
     uint8_t autoSmoothnessFactor;
 } rcSmoothingFilter_t;
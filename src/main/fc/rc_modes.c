@@ -55,6 +55,7 @@ static int activeMacCount = 0;
 static uint8_t activeMacArray[MAX_MODE_ACTIVATION_CONDITION_COUNT];
 static int activeLinkedMacCount = 0;
 static uint8_t activeLinkedMacArray[MAX_MODE_ACTIVATION_CONDITION_COUNT];
+static boxBitmask_t presentModes; // modes with a usable or linked activation condition
 
 PG_REGISTER_ARRAY(modeActivationCondition_t, MAX_MODE_ACTIVATION_CONDITION_COUNT, modeActivationConditions, PG_MODE_ACTIVATION_PROFILE, 2);
 
@@ -178,15 +179,7 @@ void updateActivatedModes(void)
 
 bool isModeActivationConditionPresent(boxId_e modeId)
 {
-    for (int i = 0; i < MAX_MODE_ACTIVATION_CONDITION_COUNT; i++) {
-        const modeActivationCondition_t *mac = modeActivationConditions(i);
-
-        if (mac->modeId == modeId && (IS_RANGE_USABLE(&mac->range) || mac->linkedTo)) {
-            return true;
-        }
-    }
-
-    return false;
+    return bitArrayGet(&presentModes, modeId);
 }
 
 bool isModeActivationConditionLinked(boxId_e modeId)
@@ -244,9 +237,13 @@ void analyzeModeActivationConditions(void)
 
     activeMacCount = 0;
     activeLinkedMacCount = 0;
+    memset(&presentModes, 0, sizeof(presentModes));
 
     for (uint8_t i = 0; i < MAX_MODE_ACTIVATION_CONDITION_COUNT; i++) {
         const modeActivationCondition_t *mac = modeActivationConditions(i);
+        if (mac->modeId < CHECKBOX_ITEM_COUNT && (IS_RANGE_USABLE(&mac->range) || mac->linkedTo)) {
+            bitArraySet(&presentModes, mac->modeId);
+        }
         if (mac->linkedTo) {
             activeLinkedMacArray[activeLinkedMacCount++] = i;
         } else if (isModeActivationConditionConfigured(mac, &emptyMac)) {
@@ -74,6 +74,12 @@ void unsetArmingDisabled(armingDisableFlags_e flag)
     armingDisableFlags = armingDisableFlags & ~flag;
 }
 
+// Replaces the flags in mask by those set in flags
+void updateArmingDisabled(armingDisableFlags_e mask, armingDisableFlags_e flags)
+{
+    armingDisableFlags = (armingDisableFlags & ~mask) | (flags & mask);
+}
+
 bool isArmingDisabled(void)
 {
     return armingDisableFlags;
@@ -70,10 +70,16 @@ typedef enum {
 
 #define ARMING_DISABLE_FLAGS_COUNT (LOG2(ARMING_DISABLED_ARM_SWITCH) + 1)
 
+// The reasons updateArmingStatus() polls for rather than being set and cleared by their subsystem
+#define ARMING_DISABLED_POLLED (ARMING_DISABLED_BOXFAILSAFE | ARMING_DISABLED_THROTTLE | ARMING_DISABLED_ANGLE \
+    | ARMING_DISABLED_LOAD | ARMING_DISABLED_CALIBRATING | ARMING_DISABLED_RPMFILTER | ARMING_DISABLED_DSHOT_BITBANG \
+    | ARMING_DISABLED_ACC_CALIBRATION)
+
 extern const char *armingDisableFlagNames[ARMING_DISABLE_FLAGS_COUNT];
 
 void setArmingDisabled(armingDisableFlags_e flag);
 void unsetArmingDisabled(armingDisableFlags_e flag);
+void updateArmingDisabled(armingDisableFlags_e mask, armingDisableFlags_e flags);
 bool isArmingDisabled(void);
 armingDisableFlags_e getArmingDisableFlags(void);
 
@@ -25,6 +25,7 @@
 #include "drivers/time.h"
 
 #include "config/config.h"
+#include "config/config_eeprom.h"
 #include "fc/dispatch.h"
 #include "fc/runtime_config.h"
 #include "fc/stats.h"
@@ -60,7 +61,11 @@ void writeStats(struct dispatchEntry_s* self)
     if (!ARMING_FLAG(ARMED)) {
         // Don't save if the user made config changes that have not yet been saved.
         if (!isConfigDirty()) {
-            writeEEPROM();
+            // Only the stats group changed, so it normally just gets appended to the config log,
+            // the full write with its erase is only needed once the log is full
+            if (!appendConfigToEEPROM()) {
+                writeEEPROM();
+            }
 
             // Repeat disarming beep indicating the stats save is complete
             beeper(BEEPER_DISARMING);
@@ -72,7 +77,7 @@ void writeStats(struct dispatchEntry_s* self)
 
 dispatchEntry_t writeStatsEntry =
 {
-    writeStats, 0, NULL, false
+    .dispatch = writeStats,
 };
 
 
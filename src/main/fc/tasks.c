@@ -24,6 +24,8 @@
 
 #include "platform.h"
 
+#include "blackbox/blackbox.h"
+
 #include "build/debug.h"
 
 #include "cli/cli.h"
@@ -61,6 +63,7 @@
 #include "io/asyncfatfs/asyncfatfs.h"
 #include "io/beeper.h"
 #include "io/dashboard.h"
+#include "io/flashfs.h"
 #include "io/gps.h"
 #include "io/ledstrip.h"
 #include "io/piniobox.h"
@@ -88,6 +91,7 @@
 #include "sensors/compass.h"
 #include "sensors/esc_sensor.h"
 #include "sensors/gyro.h"
+#include "sensors/gyro_init.h"
 #include "sensors/sensors.h"
 #include "sensors/rangefinder.h"
 
@@ -138,7 +142,7 @@ static void taskHandleSerial(timeUs_t currentTimeUs)
     }
 #endif
     bool evaluateMspData = ARMING_FLAG(ARMED) ? MSP_SKIP_NON_MSP_DATA : MSP_EVALUATE_NON_MSP_DATA;
-    mspSerialProcess(evaluateMspData, mspFcProcessCommand, mspFcProcessReply);
+    mspSerialProcess(evaluateMspData, mspFcProcessCommand, mspFcProcessReply, mspFcProcessStream);
 }
 
 static void taskBatteryAlerts(timeUs_t currentTimeUs)
@@ -155,6 +159,10 @@ static void taskBatteryAlerts(timeUs_t currentTimeUs)
 static void taskUpdateAccelerometer(timeUs_t currentTimeUs)
 {
     accUpdate(currentTimeUs, &accelerometerConfigMutable()->accelerometerTrims);
+
+    if (accUpdateRate()) {
+        rescheduleTask(TASK_SELF, TASK_PERIOD_HZ(acc.updateRateHz));
+    }
 }
 #endif
 
@@ -222,6 +230,15 @@ static void taskTelemetry(timeUs_t currentTimeUs)
 }
 #endif
 
+#ifdef USE_BLACKBOX
+static void taskBlackbox(timeUs_t currentTimeUs)
+{
+    if (!cliMode) {
+        blackboxUpdate(currentTimeUs);
+    }
+}
+#endif
+
 #ifdef USE_CAMERA_CONTROL
 static void taskCameraControl(uint32_t currentTime)
 {
@@ -262,19 +279,25 @@ void tasksInit(void)
 #endif
 
     if (sensors(SENSOR_GYRO)) {
-        rescheduleTask(TASK_GYRO, gyro.sampleLooptime);
+        rescheduleTask(TASK_GYRO, gyro.sampleLooptime * gyro.fifoDepth);
         rescheduleTask(TASK_FILTER, gyro.targetLooptime);
         rescheduleTask(TASK_PID, gyro.targetLooptime);
         setTaskEnabled(TASK_GYRO, true);
         setTaskEnabled(TASK_FILTER, true);
         setTaskEnabled(TASK_PID, true);
         schedulerEnableGyro();
+#if defined(USE_GYRO_EXTI_REALTIME)
+        // Run the realtime tasks from the gyro data ready interrupt if there is one, otherwise fall back to polling
+        if (gyroSetDataReadyCallback(schedulerRealtimeInterrupt)) {
+            schedulerEnableRealtimeInterrupt();
+        }
+#endif
     }
 
 #if defined(USE_ACC)
     if (sensors(SENSOR_ACC) && acc.sampleRateHz) {
         setTaskEnabled(TASK_ACCEL, true);
-        rescheduleTask(TASK_ACCEL, TASK_PERIOD_HZ(acc.sampleRateHz));
+        rescheduleTask(TASK_ACCEL, TASK_PERIOD_HZ(acc.updateRateHz));
         setTaskEnabled(TASK_ATTITUDE, true);
     }
 #endif
@@ -311,6 +334,7 @@ void tasksInit(void)
 
 #ifdef USE_DASHBOARD
     setTaskEnabled(TASK_DASHBOARD, featureIsEnabled(FEATURE_DASHBOARD));
+    schedulerSetTaskMaxPeriod(TASK_DASHBOARD, TASK_PERIOD_HZ(2));
 #endif
 
 #ifdef USE_TELEMETRY
@@ -323,11 +347,13 @@ void tasksInit(void)
             // Reschedule telemetry to 500hz, 2ms for CRSF
             rescheduleTask(TASK_TELEMETRY, TASK_PERIOD_HZ(500));
         }
+        schedulerSetTaskMaxPeriod(TASK_TELEMETRY, TASK_PERIOD_HZ(50));
     }
 #endif
 
 #ifdef USE_LED_STRIP
     setTaskEnabled(TASK_LEDSTRIP, featureIsEnabled(FEATURE_LED_STRIP));
+    schedulerSetTaskMaxPeriod(TASK_LEDSTRIP, TASK_PERIOD_HZ(20));
 #endif
 
 #ifdef USE_TRANSPONDER
@@ -337,6 +363,7 @@ void tasksInit(void)
 #ifdef USE_OSD
     rescheduleTask(TASK_OSD, TASK_PERIOD_HZ(osdConfig()->task_frequency));
     setTaskEnabled(TASK_OSD, featureIsEnabled(FEATURE_OSD) && osdGetDisplayPort(NULL));
+    schedulerSetTaskMaxPeriod(TASK_OSD, TASK_PERIOD_HZ(5));
 #endif
 
 #ifdef USE_BST
@@ -361,6 +388,7 @@ void tasksInit(void)
 #else
     setTaskEnabled(TASK_CMS, featureIsEnabled(FEATURE_OSD) || featureIsEnabled(FEATURE_DASHBOARD));
 #endif
+    schedulerSetTaskMaxPeriod(TASK_CMS, TASK_PERIOD_HZ(5));
 #endif
 
 #ifdef USE_VTX_CONTROL
@@ -376,6 +404,16 @@ void tasksInit(void)
 #ifdef USE_RCDEVICE
     setTaskEnabled(TASK_RCDEVICE, rcdeviceIsEnabled());
 #endif
+
+#ifdef USE_BLACKBOX
+    // Run at the main frame logging rate, frames captured in the PID loop are queued until the task catches up
+    setTaskEnabled(TASK_BLACKBOX, blackboxConfig()->device != BLACKBOX_DEVICE_NONE);
+    rescheduleTask(TASK_BLACKBOX, targetPidLooptime * blackboxGetTaskRateDenom());
+#endif
+
+#ifdef USE_FLASHFS
+    setTaskEnabled(TASK_FLASHFS, flashfsIsEraseAheadEnabled());
+#endif
 }
 
 #if defined(USE_TASK_STATISTICS)
@@ -464,7 +502,7 @@ task_t tasks[TASK_COUNT] = {
 #endif
 
 #ifdef USE_ESC_SENSOR
-    [TASK_ESC_SENSOR] = DEFINE_TASK("ESC_SENSOR", NULL, NULL, escSensorProcess, TASK_PERIOD_HZ(100), TASK_PRIORITY_LOW),
+    [TASK_ESC_SENSOR] = DEFINE_TASK("ESC_SENSOR", NULL, escSensorCheck, escSensorProcess, TASK_PERIOD_HZ(100), TASK_PRIORITY_LOW),
 #endif
 
 #ifdef USE_CMS
@@ -487,6 +525,14 @@ task_t tasks[TASK_COUNT] = {
     [TASK_ADC_INTERNAL] = DEFINE_TASK("ADCINTERNAL", NULL, NULL, adcInternalProcess, TASK_PERIOD_HZ(1), TASK_PRIORITY_IDLE),
 #endif
 
+#ifdef USE_BLACKBOX
+    [TASK_BLACKBOX] = DEFINE_TASK("BLACKBOX", NULL, NULL, taskBlackbox, TASK_PERIOD_HZ(1000), TASK_PRIORITY_MEDIUM_HIGH), // Freq is updated in tasksInit
+#endif
+
+#ifdef USE_FLASHFS
+    [TASK_FLASHFS] = DEFINE_TASK("FLASHFS", NULL, NULL, flashfsEraseAheadUpdate, TASK_PERIOD_HZ(50), TASK_PRIORITY_IDLE),
+#endif
+
 #ifdef USE_PINIOBOX
     [TASK_PINIOBOX] = DEFINE_TASK("PINIOBOX", NULL, NULL, pinioBoxUpdate, TASK_PERIOD_HZ(20), TASK_PRIORITY_IDLE),
 #endif
@@ -17,6 +17,7 @@
 
 #include <stdint.h>
 #include <math.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -128,6 +129,13 @@ typedef struct {
     float Kd;
 } throttle_s;
 
+// Position and velocity relative to home, propagated with the accelerometer between GPS fixes
+typedef struct {
+    float positionCm[2];        // north and east of home
+    float velocityCmS[3];       // north, east and up
+    bool valid;
+} rescueEstimate_s;
+
 #define GPS_RESCUE_MAX_YAW_RATE         180 // deg/sec max yaw rate
 #define GPS_RESCUE_RATE_SCALE_DEGREES    45 // Scale the commanded yaw rate when the error is less then this angle
 #define GPS_RESCUE_SLOWDOWN_DISTANCE_M  200 // distance from home to start decreasing speed
@@ -144,6 +152,10 @@ typedef struct {
 #define GPS_RESCUE_THROTTLE_I_SCALE 0.1f       // pid scaler for I term
 #define GPS_RESCUE_THROTTLE_D_SCALE 0.0003125f // pid scaler for D term
 
+#define GPS_RESCUE_GRAVITY_CMSS         980.665f
+#define GPS_RESCUE_ESTIMATE_POS_GAIN    0.3f  // fraction of the position error corrected on each GPS fix
+#define GPS_RESCUE_ESTIMATE_VEL_GAIN    0.3f  // fraction of the velocity error corrected on each GPS fix
+
 #ifdef USE_MAG
 #define GPS_RESCUE_USE_MAG              true
 #else
@@ -194,6 +206,7 @@ static bool newGPSData = false;
 
 rescueState_s rescueState;
 throttle_s throttle;
+static rescueEstimate_s rescueEstimate;
 
 /*
  If we have new GPS data, update home heading
@@ -207,11 +220,58 @@ void rescueNewGpsData(void)
 static void rescueStart()
 {
     rescueState.phase = RESCUE_INITIALIZE;
+    rescueEstimate.valid = false;
 }
 
 static void rescueStop()
 {
     rescueState.phase = RESCUE_IDLE;
+    rescueEstimate.valid = false;
+}
+
+/*
+ Advance the rescue position and velocity estimate with the earth frame
+ acceleration, called at PID subprocess rate so the rescue controllers
+ see a fresh position between GPS fixes.
+*/
+void gpsRescuePropagateEstimate(float dT)
+{
+    if (rescueState.phase == RESCUE_IDLE || !rescueEstimate.valid) {
+        return;
+    }
+
+    t_fp_vector_def accEf = { acc.accADC[X], acc.accADC[Y], acc.accADC[Z] };
+    imuTransformVectorBodyToEarth(&accEf);
+
+    const float accScale = acc.dev.acc_1G_rec * GPS_RESCUE_GRAVITY_CMSS * dT;
+    rescueEstimate.velocityCmS[0] += accEf.X * accScale;
+    rescueEstimate.velocityCmS[1] += accEf.Y * accScale;
+    rescueEstimate.velocityCmS[2] += accEf.Z * accScale - GPS_RESCUE_GRAVITY_CMSS * dT;
+
+    rescueEstimate.positionCm[0] += rescueEstimate.velocityCmS[0] * dT;
+    rescueEstimate.positionCm[1] += rescueEstimate.velocityCmS[1] * dT;
+}
+
+// Pull the estimate towards the latest GPS fix, or seed it on the first fix
+static void rescueCorrectEstimate(float zVelocity)
+{
+    const float courseRad = DECIDEGREES_TO_RADIANS(gpsSol.groundCourse);
+    const float gpsPositionCm[2] = { GPS_homeOffsetCm[LAT], GPS_homeOffsetCm[LON] };
+    const float gpsVelocityCmS[3] = { gpsSol.groundSpeed * cos_approx(courseRad), gpsSol.groundSpeed * sin_approx(courseRad), zVelocity };
+
+    if (!rescueEstimate.valid) {
+        memcpy(rescueEstimate.positionCm, gpsPositionCm, sizeof(rescueEstimate.positionCm));
+        memcpy(rescueEstimate.velocityCmS, gpsVelocityCmS, sizeof(rescueEstimate.velocityCmS));
+        rescueEstimate.valid = true;
+        return;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        rescueEstimate.positionCm[i] += (gpsPositionCm[i] - rescueEstimate.positionCm[i]) * GPS_RESCUE_ESTIMATE_POS_GAIN;
+    }
+    for (int i = 0; i < 3; i++) {
+        rescueEstimate.velocityCmS[i] += (gpsVelocityCmS[i] - rescueEstimate.velocityCmS[i]) * GPS_RESCUE_ESTIMATE_VEL_GAIN;
+    }
 }
 
 // Things that need to run regardless of GPS rescue mode being enabled or not
@@ -283,20 +343,26 @@ static void rescueAttainPosition()
 {
     // Speed and altitude controller internal variables
     static float previousSpeedError = 0;
-    static int16_t speedIntegral = 0;
-    int zVelocityError;
-    static int previousZVelocityError = 0;
+    static float speedIntegral = 0;
+    static float pitchAngle = 0;
+    float zVelocityError;
+    static float previousZVelocityError = 0;
     static float zVelocityIntegral = 0;
     static float scalingRate = 0;
-    static int16_t altitudeAdjustment = 0;
+    static float altitudeAdjustment = 0;
+    static timeUs_t previousTimeUs = 0;
+
+    const timeUs_t currentTimeUs = micros();
 
     if (rescueState.phase == RESCUE_INITIALIZE) {
         // Initialize internal variables each time GPS Rescue is started
         previousSpeedError = 0;
         speedIntegral = 0;
+        pitchAngle = gpsRescueAngle[AI_PITCH];
         previousZVelocityError = 0;
         zVelocityIntegral = 0;
         altitudeAdjustment = 0;
+        previousTimeUs = currentTimeUs;
     }
 
     // Point to home if that is in our intent
@@ -306,23 +372,30 @@ static void rescueAttainPosition()
 
     DEBUG_SET(DEBUG_RTH, 3, rescueState.failure); //Failure can change with no new GPS Data
 
-    if (!newGPSData) {
+    // The gains are tuned per GPS fix. With the estimate the loops run on every call, so the
+    // P and I increments are scaled to the fraction of a fix interval each call covers.
+    float iterationScale = 1.0f;
+    if (rescueEstimate.valid) {
+        iterationScale = dTnav > 0.0f ? constrainf((currentTimeUs - previousTimeUs) * 1e-6f / dTnav, 0.0f, 1.0f) : 0.0f;
+    } else if (!newGPSData) {
         return;
     }
+    previousTimeUs = currentTimeUs;
 
     /**
         Speed controller
     */
-    const int16_t speedError = (rescueState.intent.targetGroundspeed - rescueState.sensor.groundSpeed) / 100;
-    const int16_t speedDerivative = speedError - previousSpeedError;
+    const float speedError = (rescueState.intent.targetGroundspeed - rescueState.sensor.groundSpeed) / 100.0f;
+    const float speedDerivative = speedError - previousSpeedError;
 
-    speedIntegral = constrain(speedIntegral + speedError, -100, 100);
+    speedIntegral = constrainf(speedIntegral + speedError * iterationScale, -100, 100);
 
     previousSpeedError = speedError;
 
-    const int16_t angleAdjustment =  gpsRescueConfig()->velP * speedError + (gpsRescueConfig()->velI * speedIntegral) / 100 +  gpsRescueConfig()->velD * speedDerivative;
+    const float angleAdjustment = (gpsRescueConfig()->velP * speedError + (gpsRescueConfig()->velI * speedIntegral) / 100) * iterationScale + gpsRescueConfig()->velD * speedDerivative;
 
-    gpsRescueAngle[AI_PITCH] = constrain(gpsRescueAngle[AI_PITCH] + MIN(angleAdjustment, 80), rescueState.intent.minAngleDeg * 100, rescueState.intent.maxAngleDeg * 100);
+    pitchAngle = constrainf(pitchAngle + MIN(angleAdjustment, 80 * iterationScale), rescueState.intent.minAngleDeg * 100, rescueState.intent.maxAngleDeg * 100);
+    gpsRescueAngle[AI_PITCH] = lrintf(pitchAngle);
 
     const float ct = cos(DECIDEGREES_TO_RADIANS(gpsRescueAngle[AI_PITCH] / 10));
 
@@ -352,25 +425,25 @@ static void rescueAttainPosition()
     }
 
     // I component
-    if (ABS(zVelocityError) < GPS_RESCUE_ITERM_WINDUP) {
-        zVelocityIntegral = constrainf(zVelocityIntegral + zVelocityError / 100.0f, -GPS_RESCUE_MAX_ITERM_ACC, GPS_RESCUE_MAX_ITERM_ACC);
+    if (fabsf(zVelocityError) < GPS_RESCUE_ITERM_WINDUP) {
+        zVelocityIntegral = constrainf(zVelocityIntegral + zVelocityError / 100.0f * iterationScale, -GPS_RESCUE_MAX_ITERM_ACC, GPS_RESCUE_MAX_ITERM_ACC);
     } else {
         zVelocityIntegral = 0;
     }
 
     // D component
-    const int zVelocityDerivative = zVelocityError - previousZVelocityError;
+    const float zVelocityDerivative = zVelocityError - previousZVelocityError;
     previousZVelocityError = zVelocityError;
 
     const int16_t hoverAdjustment = (hoverThrottle - 1000) / ct;
-    altitudeAdjustment = constrain(altitudeAdjustment + (throttle.Kp * zVelocityError + throttle.Ki * zVelocityIntegral + throttle.Kd * zVelocityDerivative),
+    altitudeAdjustment = constrainf(altitudeAdjustment + (throttle.Kp * zVelocityError + throttle.Ki * zVelocityIntegral) * iterationScale + throttle.Kd * zVelocityDerivative,
                                     gpsRescueConfig()->throttleMin - 1000 - hoverAdjustment, gpsRescueConfig()->throttleMax - 1000 - hoverAdjustment);
 
-    rescueThrottle = constrain(1000 + altitudeAdjustment + hoverAdjustment, gpsRescueConfig()->throttleMin, gpsRescueConfig()->throttleMax);
+    rescueThrottle = constrain(1000 + lrintf(altitudeAdjustment) + hoverAdjustment, gpsRescueConfig()->throttleMin, gpsRescueConfig()->throttleMax);
 
     DEBUG_SET(DEBUG_RTH, 0, rescueThrottle);
     DEBUG_SET(DEBUG_RTH, 1, gpsRescueAngle[AI_PITCH]);
-    DEBUG_SET(DEBUG_RTH, 2, altitudeAdjustment);
+    DEBUG_SET(DEBUG_RTH, 2, lrintf(altitudeAdjustment));
 
     DEBUG_SET(DEBUG_GPS_RESCUE_THROTTLE_PID, 0, throttle.Kp * zVelocityError);
     DEBUG_SET(DEBUG_GPS_RESCUE_THROTTLE_PID, 1, throttle.Ki * zVelocityIntegral);
@@ -484,9 +557,29 @@ static void sensorUpdate()
         rescueState.sensor.accMagnitude = (float) sqrtf(sq(acc.accADC[Z]) + sq(acc.accADC[X]) + sq(acc.accADC[Y])) * acc.dev.acc_1G_rec;
         rescueState.sensor.accMagnitudeAvg = (rescueState.sensor.accMagnitudeAvg * 0.8f) + (rescueState.sensor.accMagnitude * 0.2f);
 
+        if (rescueState.phase != RESCUE_IDLE) {
+            rescueCorrectEstimate(rescueState.sensor.zVelocity);
+        }
+
         previousAltitudeCm = rescueState.sensor.currentAltitudeCm;
         previousTimeUs = currentTimeUs;
     }
+
+    if (rescueEstimate.valid) {
+        // Between fixes take position and velocity from the propagated estimate
+        const float northCm = rescueEstimate.positionCm[0];
+        const float eastCm = rescueEstimate.positionCm[1];
+        rescueState.sensor.distanceToHomeM = sqrtf(sq(northCm) + sq(eastCm)) / 100;
+
+        int16_t directionToHome = lrintf(atan2_approx(-eastCm, -northCm) / RAD);
+        if (directionToHome < 0) {
+            directionToHome += 360;
+        }
+        rescueState.sensor.directionToHome = directionToHome;
+
+        rescueState.sensor.groundSpeed = sqrtf(sq(rescueEstimate.velocityCmS[0]) + sq(rescueEstimate.velocityCmS[1]));
+        rescueState.sensor.zVelocity = rescueEstimate.velocityCmS[2];
+    }
 }
 
 // This function checks the following conditions to determine if GPS rescue is available:
@@ -51,6 +51,7 @@ extern int32_t gpsRescueAngle[ANGLE_INDEX_COUNT]; //NOTE: ANGLES ARE IN CENTIDEG
 
 void updateGPSRescueState(void);
 void rescueNewGpsData(void);
+void gpsRescuePropagateEstimate(float dT);
 
 float gpsRescueGetYawRate(void);
 float gpsRescueGetThrottle(void);
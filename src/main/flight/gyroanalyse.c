@@ -23,7 +23,9 @@
  * coding assistance and advice from DieHertz, Rav, eTracer
  * test pilots icr4sh, UAV Tech, Flint723
  */
+#include <math.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -44,10 +46,12 @@
 
 #include "gyroanalyse.h"
 
-// FFT_WINDOW_SIZE defaults to 32 (gyroanalyse.h)
+// The FFT window size defaults to 32, F7 and H7 can also use 64 or 128 (dyn_notch_window)
 // We get 16 frequency bins from 32 consecutive data values
 // Bin 0 is DC and can't be used.
 // Only bins 1 to 15 are usable.
+// The descriptions below are for a 32 point window, larger windows give proportionally narrower bins
+// but take proportionally longer to fill with new data.
 
 // A gyro sample is collected every gyro loop
 // maxSampleCount recent gyro values are accumulated and averaged
@@ -81,25 +85,41 @@
 // Each FFT output bin has width fftSamplingRateHz/32, ie 41.65Hz per bin at 1333Hz
 // Usable bandwidth is half this, ie 666Hz if fftSamplingRateHz is 1333Hz, i.e. bin 1 is 41.65hz, bin 2 83.3hz etc
 
+// With the sliding DFT engine (dyn_notch_engine = SDFT) no FFT is calculated.
+// Instead every downsampled sample updates the DFT bins in the dyn_notch_min_hz to dyn_notch_max_hz range directly:
+//   X[k] = r * W[k] * (X[k] + x[new] - r^N * x[oldest]), W[k] = exp(2 * pi * i * k / N)
+// where r slightly below 1 keeps rounding errors from accumulating.
+// The Hanning window is applied in the frequency domain, Y[k] = 0.5 * X[k] - 0.25 * (X[k - 1] + X[k + 1]),
+// when the magnitudes are calculated. Since the bins are always current, each axis only needs one step
+// to find its peak and update the notches, so all three axes are updated every downsampled sample.
+
 #define DYN_NOTCH_SMOOTH_HZ       4
-#define FFT_BIN_COUNT             (FFT_WINDOW_SIZE / 2) // 16
 #define DYN_NOTCH_CALC_TICKS      (XYZ_AXIS_COUNT * 4) // 4 steps per axis
+#define DYN_NOTCH_SDFT_CALC_TICKS XYZ_AXIS_COUNT       // 1 step per axis
 #define DYN_NOTCH_OSD_MIN_THROTTLE 20
+#define SDFT_DAMPING_FACTOR       0.9999f
 
+static uint8_t FAST_DATA_ZERO_INIT    fftWindowSize;
+static uint8_t FAST_DATA_ZERO_INIT    fftBinCount;
+static uint8_t FAST_DATA_ZERO_INIT    dynNotchEngine;
 static uint16_t FAST_DATA_ZERO_INIT   fftSamplingRateHz;
 static float FAST_DATA_ZERO_INIT      fftResolution;
 static uint8_t FAST_DATA_ZERO_INIT    fftStartBin;
-static float FAST_DATA_ZERO_INIT      dynNotchQ;
-static float FAST_DATA_ZERO_INIT      dynNotch1Ctr;
-static float FAST_DATA_ZERO_INIT      dynNotch2Ctr;
+static uint8_t FAST_DATA_ZERO_INIT    fftEndBin;     // one past the highest bin searched for a peak
+static uint8_t FAST_DATA_ZERO_INIT    fftLowestBin;  // lowest bin with a valid magnitude
+static uint8_t FAST_DATA_ZERO_INIT    sdftStartBin;
+static uint8_t FAST_DATA_ZERO_INIT    sdftEndBin;
+static float FAST_DATA_ZERO_INIT      sdftDampingN;  // SDFT_DAMPING_FACTOR ^ fftWindowSize
+static FAST_DATA_ZERO_INIT float      sdftTwiddle[FFT_BIN_COUNT_MAX + 1][2];
+static FAST_DATA_ZERO_INIT biquadNotchCache_t dynNotchCache;
 static uint16_t FAST_DATA_ZERO_INIT   dynNotchMinHz;
 static uint16_t FAST_DATA_ZERO_INIT   dynNotchMaxHz;
-static bool FAST_DATA                 dualNotch = true;
+static uint8_t FAST_DATA_ZERO_INIT    dynNotchCount;
 static uint16_t FAST_DATA_ZERO_INIT   dynNotchMaxFFT;
 static float FAST_DATA_ZERO_INIT      smoothFactor;
 static uint8_t FAST_DATA_ZERO_INIT    samples;
 // Hanning window, see https://en.wikipedia.org/wiki/Window_function#Hann_.28Hanning.29_window
-static FAST_DATA_ZERO_INIT float hanningWindow[FFT_WINDOW_SIZE];
+static FAST_DATA_ZERO_INIT float hanningWindow[FFT_WINDOW_SIZE_MAX];
 
 void gyroDataAnalyseInit(uint32_t targetLooptimeUs)
 {
@@ -111,15 +131,14 @@ void gyroDataAnalyseInit(uint32_t targetLooptimeUs)
     gyroAnalyseInitialized = true;
 #endif
 
-    dynNotch1Ctr = 1 - gyroConfig()->dyn_notch_width_percent / 100.0f;
-    dynNotch2Ctr = 1 + gyroConfig()->dyn_notch_width_percent / 100.0f;
-    dynNotchQ = gyroConfig()->dyn_notch_q / 100.0f;
+    dynNotchCount = constrain(gyroConfig()->dyn_notch_count, 1, DYN_NOTCH_COUNT_MAX);
+    biquadNotchCacheInit(&dynNotchCache, targetLooptimeUs, gyroConfig()->dyn_notch_q / 100.0f);
     dynNotchMinHz = gyroConfig()->dyn_notch_min_hz;
     dynNotchMaxHz = MAX(2 * dynNotchMinHz, gyroConfig()->dyn_notch_max_hz);
 
-    if (gyroConfig()->dyn_notch_width_percent == 0) {
-        dualNotch = false;
-    }
+    fftWindowSize = 32 << MIN(gyroConfig()->dyn_notch_window, DYN_NOTCH_WINDOW_COUNT - 1);
+    fftBinCount = fftWindowSize / 2;
+    dynNotchEngine = gyroConfig()->dyn_notch_engine;
 
     const int gyroLoopRateHz = lrintf((1.0f / targetLooptimeUs) * 1e6f);
     samples = MAX(1, gyroLoopRateHz / (2 * dynNotchMaxHz)); //600hz, 8k looptime, 13.333
@@ -132,12 +151,31 @@ void gyroDataAnalyseInit(uint32_t targetLooptimeUs)
     // eg 1k, user max 600hz, int(1000/1200) = 1 (max(1,0.8333)) fftSamplingRateHz = 1000hz, range 500Hz
     // the upper limit of DN is always going to be Nyquist
 
-    fftResolution = (float)fftSamplingRateHz / FFT_WINDOW_SIZE; // 41.65hz per bin for medium
+    fftResolution = (float)fftSamplingRateHz / fftWindowSize; // 41.65hz per bin for medium
     fftStartBin = MAX(2, dynNotchMinHz / lrintf(fftResolution)); // can't use bin 0 because it is DC.
-    smoothFactor = 2 * M_PIf * DYN_NOTCH_SMOOTH_HZ / (gyroLoopRateHz / 12); // minimum PT1 k value
 
-    for (int i = 0; i < FFT_WINDOW_SIZE; i++) {
-        hanningWindow[i] = (0.5f - 0.5f * cos_approx(2 * M_PIf * i / (FFT_WINDOW_SIZE - 1)));
+    if (dynNotchEngine == DYN_NOTCH_ENGINE_SDFT) {
+        // only the bins around the notch range are calculated, with one extra each side for the window
+        fftEndBin = MIN(fftBinCount, lrintf(dynNotchMaxHz / fftResolution) + 2);
+        fftStartBin = MIN(fftStartBin, fftEndBin - 1);
+        fftLowestBin = fftStartBin - 1;
+        sdftStartBin = fftLowestBin - 1;
+        sdftEndBin = fftEndBin;
+        sdftDampingN = powf(SDFT_DAMPING_FACTOR, fftWindowSize);
+        for (int k = sdftStartBin; k <= sdftEndBin; k++) {
+            sdftTwiddle[k][0] = SDFT_DAMPING_FACTOR * cos_approx(2 * M_PIf * k / fftWindowSize);
+            sdftTwiddle[k][1] = SDFT_DAMPING_FACTOR * sin_approx(2 * M_PIf * k / fftWindowSize);
+        }
+        // every axis is updated once per downsampled sample rather than once per 12 gyro loops
+        smoothFactor = 2 * M_PIf * DYN_NOTCH_SMOOTH_HZ / fftSamplingRateHz;
+    } else {
+        fftEndBin = fftBinCount;
+        fftLowestBin = 1;
+        smoothFactor = 2 * M_PIf * DYN_NOTCH_SMOOTH_HZ / (gyroLoopRateHz / 12); // minimum PT1 k value
+    }
+
+    for (int i = 0; i < fftWindowSize; i++) {
+        hanningWindow[i] = (0.5f - 0.5f * cos_approx(2 * M_PIf * i / (fftWindowSize - 1)));
     }
 }
 
@@ -147,10 +185,13 @@ void gyroDataAnalyseStateInit(gyroAnalyseState_t *state, uint32_t targetLooptime
     gyroDataAnalyseInit(targetLooptimeUs);
     state->maxSampleCount = samples;
     state->maxSampleCountRcp = 1.0f / state->maxSampleCount;
-    arm_rfft_fast_init_f32(&state->fftInstance, FFT_WINDOW_SIZE);
+    arm_rfft_fast_init_f32(&state->fftInstance, fftWindowSize);
+    memset(state->sdftData, 0, sizeof(state->sdftData));
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-        // any init value
-        state->centerFreq[axis] = dynNotchMaxHz;
+        // any init value, spread the peaks evenly over the notch range
+        for (int p = 0; p < DYN_NOTCH_COUNT_MAX; p++) {
+            state->centerFreq[axis][p] = dynNotchMinHz + (dynNotchMaxHz - dynNotchMinHz) * (p + 1) / (dynNotchCount + 1);
+        }
     }
 }
 
@@ -159,12 +200,26 @@ void gyroDataAnalysePush(gyroAnalyseState_t *state, const int axis, const float
     state->oversampledGyroAccumulator[axis] += sample;
 }
 
-static void gyroDataAnalyseUpdate(gyroAnalyseState_t *state, biquadFilter_t *notchFilterDyn, biquadFilter_t *notchFilterDyn2);
+static void gyroDataAnalyseUpdate(gyroAnalyseState_t *state, biquadFilter_t notchFilterDyn[XYZ_AXIS_COUNT][DYN_NOTCH_COUNT_MAX]);
+static void gyroDataAnalyseUpdateSdft(gyroAnalyseState_t *state, biquadFilter_t notchFilterDyn[XYZ_AXIS_COUNT][DYN_NOTCH_COUNT_MAX]);
+
+// Slide the DFT bins in the notch range along by one sample, called before the sample is added to the circular buffer
+static FAST_CODE void sdftPush(gyroAnalyseState_t *state, const int axis, const float sample)
+{
+    const float delta = sample - sdftDampingN * state->downsampledGyroData[axis][state->circularBufferIdx];
+    float (*bin)[2] = state->sdftData[axis];
+    for (int k = sdftStartBin; k <= sdftEndBin; k++) {
+        const float re = bin[k][0] + delta;
+        const float im = bin[k][1];
+        bin[k][0] = re * sdftTwiddle[k][0] - im * sdftTwiddle[k][1];
+        bin[k][1] = re * sdftTwiddle[k][1] + im * sdftTwiddle[k][0];
+    }
+}
 
 /*
  * Collect gyro data, to be analysed in gyroDataAnalyseUpdate function
  */
-void gyroDataAnalyse(gyroAnalyseState_t *state, biquadFilter_t *notchFilterDyn, biquadFilter_t *notchFilterDyn2)
+void gyroDataAnalyse(gyroAnalyseState_t *state, biquadFilter_t notchFilterDyn[XYZ_AXIS_COUNT][DYN_NOTCH_COUNT_MAX])
 {
     // samples should have been pushed by `gyroDataAnalysePush`
     // if gyro sampling is > 1kHz, accumulate and average multiple gyro samples
@@ -176,6 +231,9 @@ void gyroDataAnalyse(gyroAnalyseState_t *state, biquadFilter_t *notchFilterDyn,
         // calculate mean value of accumulated samples
         for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
             float sample = state->oversampledGyroAccumulator[axis] * state->maxSampleCountRcp;
+            if (dynNotchEngine == DYN_NOTCH_ENGINE_SDFT) {
+                sdftPush(state, axis, sample);
+            }
             state->downsampledGyroData[axis][state->circularBufferIdx] = sample;
             if (axis == 0) {
                 DEBUG_SET(DEBUG_FFT, 2, lrintf(sample));
@@ -184,18 +242,23 @@ void gyroDataAnalyse(gyroAnalyseState_t *state, biquadFilter_t *notchFilterDyn,
             state->oversampledGyroAccumulator[axis] = 0;
         }
 
-        state->circularBufferIdx = (state->circularBufferIdx + 1) % FFT_WINDOW_SIZE;
+        state->circularBufferIdx = (state->circularBufferIdx + 1) % fftWindowSize;
 
         // We need DYN_NOTCH_CALC_TICKS tick to update all axis with newly sampled value
         // recalculation of filters takes 4 calls per axis => each filter gets updated every DYN_NOTCH_CALC_TICKS calls
         // at 4kHz gyro loop rate this means 8kHz / 4 / 3 = 666Hz => update every 1.5ms
         // at 4kHz gyro loop rate this means 4kHz / 4 / 3 = 333Hz => update every 3ms
-        state->updateTicks = DYN_NOTCH_CALC_TICKS;
+        // the sliding DFT only needs one call per axis
+        state->updateTicks = dynNotchEngine == DYN_NOTCH_ENGINE_SDFT ? DYN_NOTCH_SDFT_CALC_TICKS : DYN_NOTCH_CALC_TICKS;
     }
 
     // calculate FFT and update filters
     if (state->updateTicks > 0) {
-        gyroDataAnalyseUpdate(state, notchFilterDyn, notchFilterDyn2);
+        if (dynNotchEngine == DYN_NOTCH_ENGINE_SDFT) {
+            gyroDataAnalyseUpdateSdft(state, notchFilterDyn);
+        } else {
+            gyroDataAnalyseUpdate(state, notchFilterDyn);
+        }
         --state->updateTicks;
     }
 }
@@ -206,10 +269,139 @@ void arm_cfft_radix8by4_f32(arm_cfft_instance_f32 *S, float32_t *p1);
 void arm_radix8_butterfly_f32(float32_t *pSrc, uint16_t fftLen, const float32_t *pCoef, uint16_t twidCoefModifier);
 void arm_bitreversal_32(uint32_t *pSrc, const uint16_t bitRevLen, const uint16_t *pBitRevTable);
 
+// Find the peak frequencies for the current axis from the bin magnitudes in fftData
+// The tallest dynNotchCount local maxima are found, each is then assigned to the tracked peak nearest to it.
+static FAST_CODE void calculatePeakFrequencies(gyroAnalyseState_t *state)
+{
+    const int axis = state->updateAxis;
+
+    // identify the tallest peaks, peakBin[] is kept sorted by descending height
+    uint8_t peakBin[DYN_NOTCH_COUNT_MAX];
+    int peakCount = 0;
+    for (int i = fftStartBin; i < fftEndBin; i++) {
+        const float value = state->fftData[i];
+        if (value > state->fftData[i - 1] && (i + 1 == fftEndBin || value >= state->fftData[i + 1])) { // local maximum
+            int slot;
+            if (peakCount < dynNotchCount) {
+                slot = peakCount++;
+            } else if (value > state->fftData[peakBin[dynNotchCount - 1]]) {
+                slot = dynNotchCount - 1; // replaces the smallest peak
+            } else {
+                continue;
+            }
+            while (slot > 0 && state->fftData[peakBin[slot - 1]] < value) {
+                peakBin[slot] = peakBin[slot - 1];
+                slot--;
+            }
+            peakBin[slot] = i;
+        }
+    }
+
+    uint8_t assignedPeaks = 0;  // bitmask of tracked peaks already updated
+    for (int n = 0; n < peakCount; n++) {
+        const uint8_t binMax = peakBin[n];
+        const float dataMax = state->fftData[binMax];
+
+        // find the minimum either side of the peak
+        float dataMin = 1.0f;
+        float dataMinHi = 1.0f;
+        for (int i = binMax - 1; i > fftLowestBin; i--) { // look for min below max
+            dataMin = state->fftData[i];
+            if (state->fftData[i - 1] > state->fftData[i]) { // up step below this one
+                break;
+            }
+        }
+        for (int i = binMax + 1; i < (fftEndBin - 1); i++) { // // look for min above max
+            dataMinHi = state->fftData[i];
+            if (state->fftData[i] < state->fftData[i + 1]) { // up step above this one
+                break;
+            }
+        }
+        dataMin = fminf(dataMin, dataMinHi);
+
+        // accumulate fftSum and fftWeightedSum from peak bin, and shoulder bins either side of peak
+        float squaredData = dataMax * dataMax;
+        float fftSum = squaredData;
+        float fftWeightedSum = squaredData * binMax;
+
+        // accumulate upper shoulder unless it would be beyond the last bin
+        uint8_t shoulderBin = binMax + 1;
+        if (shoulderBin < fftEndBin) {
+            squaredData = state->fftData[shoulderBin] * state->fftData[shoulderBin];
+            fftSum += squaredData;
+            fftWeightedSum += squaredData * shoulderBin;
+        }
+
+        // accumulate lower shoulder unless lower shoulder would be bin 0 (DC)
+        if (binMax > fftLowestBin) {
+            shoulderBin = binMax - 1;
+            squaredData = state->fftData[shoulderBin] * state->fftData[shoulderBin];
+            fftSum += squaredData;
+            fftWeightedSum += squaredData * shoulderBin;
+        }
+
+        if (fftSum <= 0) {
+            continue;
+        }
+
+        // get centerFreq in Hz from weighted bins
+        // In theory, the index points to the centre frequency of the bin.
+        // at 1333hz, bin widths are 41.65Hz, so bin 2 has the range 83,3Hz to 124,95Hz
+        // Rav feels that maybe centerFreq = (fftMeanIndex + 0.5) * fftResolution; is better
+        // empirical checking shows that not adding 0.5 works better
+        const float fftMeanIndex = fftWeightedSum / fftSum;
+        const float centerFreq = constrainf(fftMeanIndex * fftResolution, dynNotchMinHz, dynNotchMaxHz);
+
+        // the strongest peak claims the nearest tracked peak first
+        int nearest = -1;
+        float nearestDistance = 0.0f;
+        for (int p = 0; p < dynNotchCount; p++) {
+            const float distance = fabsf(state->centerFreq[axis][p] - centerFreq);
+            if (!(assignedPeaks & (1 << p)) && (nearest < 0 || distance < nearestDistance)) {
+                nearest = p;
+                nearestDistance = distance;
+            }
+        }
+        assignedPeaks |= 1 << nearest;
+
+        // PT1 style dynamic smoothing moves rapidly towards big peaks and slowly away, up to 8x faster
+        const float dynamicFactor = constrainf(dataMax / dataMin, 1.0f, 8.0f);
+        state->centerFreq[axis][nearest] += smoothFactor * dynamicFactor * (centerFreq - state->centerFreq[axis][nearest]);
+
+        if (n == 0) {
+            if (calculateThrottlePercentAbs() > DYN_NOTCH_OSD_MIN_THROTTLE) {
+                dynNotchMaxFFT = MAX(dynNotchMaxFFT, state->centerFreq[axis][nearest]);
+            }
+            if (axis == 0) {
+                DEBUG_SET(DEBUG_FFT, 3, lrintf(fftMeanIndex * 100));
+                DEBUG_SET(DEBUG_FFT_FREQ, 1, lrintf(dynamicFactor * 100));
+                DEBUG_SET(DEBUG_DYN_LPF, 1, state->centerFreq[axis][nearest]);
+            }
+        }
+    }
+    // tracked peaks without a matching peak in this window hold their frequency
+
+    if (axis == 0) {
+        DEBUG_SET(DEBUG_FFT_FREQ, 0, state->centerFreq[axis][0]);
+    }
+}
+
+// Move the dynamic notches of the current axis to its peak frequencies, then advance to the next axis
+static FAST_CODE void updateDynamicNotches(gyroAnalyseState_t *state, biquadFilter_t notchFilterDyn[XYZ_AXIS_COUNT][DYN_NOTCH_COUNT_MAX])
+{
+    biquadNotchCoeffs_t coeffs[DYN_NOTCH_COUNT_MAX];
+    biquadNotchCoefficients(&dynNotchCache, state->centerFreq[state->updateAxis], coeffs, dynNotchCount);
+    for (int p = 0; p < dynNotchCount; p++) {
+        biquadFilterSetNotchCoefficients(&notchFilterDyn[state->updateAxis][p], &coeffs[p]);
+    }
+
+    state->updateAxis = (state->updateAxis + 1) % XYZ_AXIS_COUNT;
+}
+
 /*
  * Analyse gyro data
  */
-static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state, biquadFilter_t *notchFilterDyn, biquadFilter_t *notchFilterDyn2)
+static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state, biquadFilter_t notchFilterDyn[XYZ_AXIS_COUNT][DYN_NOTCH_COUNT_MAX])
 {
     enum {
         STEP_ARM_CFFT_F32,
@@ -225,7 +417,7 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state,
     arm_cfft_instance_f32 *Sint = &(state->fftInstance.Sint);
 
     uint32_t startTime = 0;
-    if (debugMode == (DEBUG_FFT_TIME)) {
+    if (debugModeIsEnabled(DEBUG_FFT_TIME)) {
         startTime = micros();
     }
 
@@ -233,7 +425,7 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state,
     switch (state->updateStep) {
         case STEP_ARM_CFFT_F32:
         {
-            switch (FFT_BIN_COUNT) {
+            switch (fftBinCount) {
             case 16:
                 // 16us
                 arm_cfft_radix8by2_f32(Sint, state->fftData);
@@ -244,10 +436,10 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state,
                 break;
             case 64:
                 // 70us
-                arm_radix8_butterfly_f32(state->fftData, FFT_BIN_COUNT, Sint->pTwiddle, 1);
+                arm_radix8_butterfly_f32(state->fftData, fftBinCount, Sint->pTwiddle, 1);
                 break;
             }
-            DEBUG_SET(DEBUG_FFT_TIME, 1, micros() - startTime);
+            DEBUG_SET_IF_ENABLED(DEBUG_FFT_TIME, 1, micros() - startTime);
 
             break;
         }
@@ -255,7 +447,7 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state,
         {
             // 6us
             arm_bitreversal_32((uint32_t*) state->fftData, Sint->bitRevLength, Sint->pBitRevTable);
-            DEBUG_SET(DEBUG_FFT_TIME, 1, micros() - startTime);
+            DEBUG_SET_IF_ENABLED(DEBUG_FFT_TIME, 1, micros() - startTime);
             state->updateStep++;
             FALLTHROUGH;
         }
@@ -264,121 +456,31 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state,
             // 14us
             // this does not work in place => fftData AND rfftData needed
             stage_rfft_f32(&state->fftInstance, state->fftData, state->rfftData);
-            DEBUG_SET(DEBUG_FFT_TIME, 1, micros() - startTime);
+            DEBUG_SET_IF_ENABLED(DEBUG_FFT_TIME, 1, micros() - startTime);
 
             break;
         }
         case STEP_ARM_CMPLX_MAG_F32:
         {
             // 8us
-            arm_cmplx_mag_f32(state->rfftData, state->fftData, FFT_BIN_COUNT);
-            DEBUG_SET(DEBUG_FFT_TIME, 2, micros() - startTime);
+            arm_cmplx_mag_f32(state->rfftData, state->fftData, fftBinCount);
+            DEBUG_SET_IF_ENABLED(DEBUG_FFT_TIME, 2, micros() - startTime);
             state->updateStep++;
             FALLTHROUGH;
         }
         case STEP_CALC_FREQUENCIES:
         {
-            // identify max bin and max/min heights
-            float dataMax = 0.0f;
-            float dataMin = 1.0f;
-            uint8_t binMax = 0;
-            float dataMinHi = 1.0f;
-            for (int i = fftStartBin; i < FFT_BIN_COUNT; i++) {
-                if (state->fftData[i] > state->fftData[i - 1]) { // bin height increased
-                    if (state->fftData[i] > dataMax) {
-                        dataMax = state->fftData[i];
-                        binMax = i;  // tallest bin so far
-                    }
-                }
-            }
-            if (binMax == 0) { // no bin increase, hold prev max bin, dataMin = 1 dataMax = 0, ie move slow
-                binMax = lrintf(state->centerFreq[state->updateAxis] / fftResolution);
-            } else { // there was a max, find min
-                for (int i = binMax - 1; i > 1; i--) { // look for min below max
-                    dataMin = state->fftData[i];
-                    if (state->fftData[i - 1] > state->fftData[i]) { // up step below this one
-                        break;
-                    }
-                }
-                for (int i = binMax + 1; i < (FFT_BIN_COUNT - 1); i++) { // // look for min above max
-                    dataMinHi = state->fftData[i];
-                    if (state->fftData[i] < state->fftData[i + 1]) { // up step above this one
-                        break;
-                    }
-                }
-            }
-            dataMin = fminf(dataMin, dataMinHi);
-
-            // accumulate fftSum and fftWeightedSum from peak bin, and shoulder bins either side of peak
-            float squaredData = state->fftData[binMax] * state->fftData[binMax];
-            float fftSum = squaredData;
-            float fftWeightedSum = squaredData * binMax;
-
-            // accumulate upper shoulder unless it would be FFT_BIN_COUNT
-            uint8_t shoulderBin = binMax + 1;
-            if (shoulderBin < FFT_BIN_COUNT) {
-                squaredData = state->fftData[shoulderBin] * state->fftData[shoulderBin];
-                fftSum += squaredData;
-                fftWeightedSum += squaredData * shoulderBin;
-            }
-
-            // accumulate lower shoulder unless lower shoulder would be bin 0 (DC)
-            if (binMax > 1) {
-                shoulderBin = binMax - 1;
-                squaredData = state->fftData[shoulderBin] * state->fftData[shoulderBin];
-                fftSum += squaredData;
-                fftWeightedSum += squaredData * shoulderBin;
-            }
-
-            // get centerFreq in Hz from weighted bins
-            float centerFreq = dynNotchMaxHz;
-            float fftMeanIndex = 0;
-            if (fftSum > 0) {
-                fftMeanIndex = (fftWeightedSum / fftSum);
-                centerFreq = fftMeanIndex * fftResolution;
-                // In theory, the index points to the centre frequency of the bin.
-                // at 1333hz, bin widths are 41.65Hz, so bin 2 has the range 83,3Hz to 124,95Hz
-                // Rav feels that maybe centerFreq = (fftMeanIndex + 0.5) * fftResolution; is better
-                // empirical checking shows that not adding 0.5 works better
-            } else {
-                centerFreq = state->centerFreq[state->updateAxis];
-            }
-            centerFreq = constrainf(centerFreq, dynNotchMinHz, dynNotchMaxHz);
-
-            // PT1 style dynamic smoothing moves rapidly towards big peaks and slowly away, up to 8x faster
-            float dynamicFactor = constrainf(dataMax / dataMin, 1.0f, 8.0f);
-            state->centerFreq[state->updateAxis] = state->centerFreq[state->updateAxis] + smoothFactor * dynamicFactor * (centerFreq - state->centerFreq[state->updateAxis]);
-
-            if(calculateThrottlePercentAbs() > DYN_NOTCH_OSD_MIN_THROTTLE) {
-                dynNotchMaxFFT = MAX(dynNotchMaxFFT, state->centerFreq[state->updateAxis]);
-            }
-
-            if (state->updateAxis == 0) {
-                DEBUG_SET(DEBUG_FFT, 3, lrintf(fftMeanIndex * 100));
-                DEBUG_SET(DEBUG_FFT_FREQ, 0, state->centerFreq[state->updateAxis]);
-                DEBUG_SET(DEBUG_FFT_FREQ, 1, lrintf(dynamicFactor * 100));
-                DEBUG_SET(DEBUG_DYN_LPF, 1, state->centerFreq[state->updateAxis]);
-            }
-//            if (state->updateAxis == 1) {
-//            DEBUG_SET(DEBUG_FFT_FREQ, 1, state->centerFreq[state->updateAxis]);
-//            }
-            DEBUG_SET(DEBUG_FFT_TIME, 1, micros() - startTime);
+            calculatePeakFrequencies(state);
+            DEBUG_SET_IF_ENABLED(DEBUG_FFT_TIME, 1, micros() - startTime);
 
             break;
         }
         case STEP_UPDATE_FILTERS:
         {
             // 7us
-            // calculate cutoffFreq and notch Q, update notch filter
-            if (dualNotch) {
-                biquadFilterUpdate(&notchFilterDyn[state->updateAxis], state->centerFreq[state->updateAxis] * dynNotch1Ctr, gyro.targetLooptime, dynNotchQ, FILTER_NOTCH);
-                biquadFilterUpdate(&notchFilterDyn2[state->updateAxis], state->centerFreq[state->updateAxis] * dynNotch2Ctr, gyro.targetLooptime, dynNotchQ, FILTER_NOTCH);
-            } else {
-                biquadFilterUpdate(&notchFilterDyn[state->updateAxis], state->centerFreq[state->updateAxis], gyro.targetLooptime, dynNotchQ, FILTER_NOTCH);
-            }
-            DEBUG_SET(DEBUG_FFT_TIME, 1, micros() - startTime);
+            updateDynamicNotches(state, notchFilterDyn);
+            DEBUG_SET_IF_ENABLED(DEBUG_FFT_TIME, 1, micros() - startTime);
 
-            state->updateAxis = (state->updateAxis + 1) % XYZ_AXIS_COUNT;
             state->updateStep++;
             FALLTHROUGH;
         }
@@ -386,13 +488,13 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state,
         {
             // 5us
             // apply hanning window to gyro samples and store result in fftData[i] to be used in step 1 and 2 and 3
-            const uint8_t ringBufIdx = FFT_WINDOW_SIZE - state->circularBufferIdx;
+            const uint8_t ringBufIdx = fftWindowSize - state->circularBufferIdx;
             arm_mult_f32(&state->downsampledGyroData[state->updateAxis][state->circularBufferIdx], &hanningWindow[0], &state->fftData[0], ringBufIdx);
             if (state->circularBufferIdx > 0) {
                 arm_mult_f32(&state->downsampledGyroData[state->updateAxis][0], &hanningWindow[ringBufIdx], &state->fftData[ringBufIdx], state->circularBufferIdx);
             }
 
-            DEBUG_SET(DEBUG_FFT_TIME, 1, micros() - startTime);
+            DEBUG_SET_IF_ENABLED(DEBUG_FFT_TIME, 1, micros() - startTime);
         }
     }
 
@@ -400,6 +502,30 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state,
 }
 
 
+/*
+ * Find the peak of the sliding DFT for one axis and update its notches
+ */
+static FAST_CODE_NOINLINE void gyroDataAnalyseUpdateSdft(gyroAnalyseState_t *state, biquadFilter_t notchFilterDyn[XYZ_AXIS_COUNT][DYN_NOTCH_COUNT_MAX])
+{
+    uint32_t startTime = 0;
+    if (debugModeIsEnabled(DEBUG_FFT_TIME)) {
+        startTime = micros();
+    }
+
+    // apply the Hanning window in the frequency domain and calculate the magnitudes
+    const float (*bin)[2] = state->sdftData[state->updateAxis];
+    for (int k = fftLowestBin; k < fftEndBin; k++) {
+        const float re = 0.5f * bin[k][0] - 0.25f * (bin[k - 1][0] + bin[k + 1][0]);
+        const float im = 0.5f * bin[k][1] - 0.25f * (bin[k - 1][1] + bin[k + 1][1]);
+        state->fftData[k] = sqrtf(re * re + im * im);
+    }
+    DEBUG_SET_IF_ENABLED(DEBUG_FFT_TIME, 2, micros() - startTime);
+
+    calculatePeakFrequencies(state);
+    updateDynamicNotches(state, notchFilterDyn);
+    DEBUG_SET_IF_ENABLED(DEBUG_FFT_TIME, 1, micros() - startTime);
+}
+
 uint16_t getMaxFFT(void) {
     return dynNotchMaxFFT;
 }
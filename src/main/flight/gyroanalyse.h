@@ -24,7 +24,34 @@
 
 #include "common/filter.h"
 
-#define FFT_WINDOW_SIZE 32
+// The FFT window size can be selected at runtime up to FFT_WINDOW_SIZE_MAX
+#ifndef FFT_WINDOW_SIZE_MAX
+#if defined(STM32F7) || defined(STM32H7)
+#define FFT_WINDOW_SIZE_MAX 128
+#else
+#define FFT_WINDOW_SIZE_MAX 32
+#endif
+#endif
+#define FFT_BIN_COUNT_MAX (FFT_WINDOW_SIZE_MAX / 2)
+
+// Number of spectral peaks tracked per axis, each peak drives its own notch (dyn_notch_count)
+#define DYN_NOTCH_COUNT_MAX 5
+
+typedef enum {
+    DYN_NOTCH_WINDOW_32 = 0,
+#if FFT_WINDOW_SIZE_MAX >= 64
+    DYN_NOTCH_WINDOW_64,
+#endif
+#if FFT_WINDOW_SIZE_MAX >= 128
+    DYN_NOTCH_WINDOW_128,
+#endif
+    DYN_NOTCH_WINDOW_COUNT
+} dynNotchWindow_e;
+
+typedef enum {
+    DYN_NOTCH_ENGINE_FFT = 0,
+    DYN_NOTCH_ENGINE_SDFT,
+} dynNotchEngine_e;
 
 typedef struct gyroAnalyseState_s {
     // accumulator for oversampled data => no aliasing and less noise
@@ -35,7 +62,7 @@ typedef struct gyroAnalyseState_s {
 
     // downsampled gyro data circular buffer for frequency analysis
     uint8_t circularBufferIdx;
-    float downsampledGyroData[XYZ_AXIS_COUNT][FFT_WINDOW_SIZE];
+    float downsampledGyroData[XYZ_AXIS_COUNT][FFT_WINDOW_SIZE_MAX];
 
     // update state machine step information
     uint8_t updateTicks;
@@ -43,17 +70,21 @@ typedef struct gyroAnalyseState_s {
     uint8_t updateAxis;
 
     arm_rfft_fast_instance_f32 fftInstance;
-    float fftData[FFT_WINDOW_SIZE];
-    float rfftData[FFT_WINDOW_SIZE];
+    float fftData[FFT_WINDOW_SIZE_MAX];
+    float rfftData[FFT_WINDOW_SIZE_MAX];
+
+    // sliding DFT bins {real, imaginary}, only the bins covering dyn_notch_min_hz to dyn_notch_max_hz are updated
+    float sdftData[XYZ_AXIS_COUNT][FFT_BIN_COUNT_MAX + 1][2];
 
-    float centerFreq[XYZ_AXIS_COUNT];
+    // smoothed frequency of each tracked peak
+    float centerFreq[XYZ_AXIS_COUNT][DYN_NOTCH_COUNT_MAX];
 
 } gyroAnalyseState_t;
 
-STATIC_ASSERT(FFT_WINDOW_SIZE <= (uint8_t) -1, window_size_greater_than_underlying_type);
+STATIC_ASSERT(FFT_WINDOW_SIZE_MAX <= (uint8_t) -1, window_size_greater_than_underlying_type);
 
 void gyroDataAnalyseStateInit(gyroAnalyseState_t *state, uint32_t targetLooptimeUs);
 void gyroDataAnalysePush(gyroAnalyseState_t *state, const int axis, const float sample);
-void gyroDataAnalyse(gyroAnalyseState_t *state, biquadFilter_t *notchFilterDyn, biquadFilter_t *notchFilterDyn2);
+void gyroDataAnalyse(gyroAnalyseState_t *state, biquadFilter_t notchFilterDyn[XYZ_AXIS_COUNT][DYN_NOTCH_COUNT_MAX]);
 uint16_t getMaxFFT(void);
 void resetMaxFFT(void);
@@ -42,6 +42,7 @@
 #include "flight/imu.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
+#include "flight/position.h"
 
 #include "io/gps.h"
 
@@ -79,6 +80,8 @@ static bool imuUpdated = false;
 
 #define SPIN_RATE_LIMIT 20
 
+#define IMU_ACRO_ACC_RATE_HZ 200      // acc rate in acro, where the acc only corrects gyro drift
+
 #define ATTITUDE_RESET_QUIET_TIME 250000   // 250ms - gyro quiet period after disarm before attitude reset
 #define ATTITUDE_RESET_GYRO_LIMIT 15       // 15 deg/sec - gyro limit for quiet period
 #define ATTITUDE_RESET_KP_GAIN    25.0     // dcmKpGain value to use during attitude reset
@@ -101,6 +104,17 @@ static imuRuntimeConfig_t imuRuntimeConfig;
 
 STATIC_UNIT_TESTED float rMat[3][3];
 
+// The attitude core works on q only, every change to it bumps attitudeGeneration.
+// rMat is rebuilt from q when it is next read, and yaw is only converted at the
+// base attitude task rate since the faster level mode rate only needs roll and pitch.
+#define IMU_EULER_YAW_UPDATE_INTERVAL_US 10000
+static uint32_t attitudeGeneration;
+static uint32_t rMatGeneration;
+static timeUs_t eulerYawUpdatedAtUs;
+
+// roll and pitch (decidegrees) carried forward with gyro between attitude updates
+static FAST_DATA_ZERO_INIT float predictedAttitude[2];
+
 STATIC_UNIT_TESTED bool attitudeIsEstablished = false;
 
 // quaternion of sensor frame relative to earth frame
@@ -113,12 +127,13 @@ quaternion offset = QUATERNION_INITIALIZE;
 // absolute angle inclination in multiple of 0.1 degree    180 deg = 1800
 attitudeEulerAngles_t attitude = EULER_INITIALIZE;
 
-PG_REGISTER_WITH_RESET_TEMPLATE(imuConfig_t, imuConfig, PG_IMU_CONFIG, 1);
+PG_REGISTER_WITH_RESET_TEMPLATE(imuConfig_t, imuConfig, PG_IMU_CONFIG, 2);
 
 PG_RESET_TEMPLATE(imuConfig_t, imuConfig,
     .dcm_kp = 2500,                // 1.0 * 10000
     .dcm_ki = 0,                   // 0.003 * 10000
     .small_angle = 25,
+    .level_predict = false,
 );
 
 static void imuQuaternionComputeProducts(quaternion *quat, quaternionProducts *quatProd)
@@ -154,6 +169,15 @@ STATIC_UNIT_TESTED void imuComputeRotationMatrix(void){
     rMat[1][0] = -2.0f * (qP.xy - -qP.wz);
     rMat[2][0] = -2.0f * (qP.xz + -qP.wy);
 #endif
+
+    rMatGeneration = attitudeGeneration;
+}
+
+static void imuUpdateRotationMatrix(void)
+{
+    if (rMatGeneration != attitudeGeneration) {
+        imuComputeRotationMatrix();
+    }
 }
 
 /*
@@ -173,6 +197,7 @@ void imuConfigure(uint16_t throttle_correction_angle, uint8_t throttle_correctio
 {
     imuRuntimeConfig.dcm_kp = imuConfig()->dcm_kp / 10000.0f;
     imuRuntimeConfig.dcm_ki = imuConfig()->dcm_ki / 10000.0f;
+    imuRuntimeConfig.levelPredict = imuConfig()->level_predict;
 
     smallAngleCosZ = cos_approx(degreesToRadians(imuConfig()->small_angle));
 
@@ -221,6 +246,8 @@ static void imuMahonyAHRSupdate(float dt, float gx, float gy, float gz,
 {
     static float integralFBx = 0.0f,  integralFBy = 0.0f, integralFBz = 0.0f;    // integral error terms scaled by Ki
 
+    imuUpdateRotationMatrix();
+
     // Calculate general spin rate (rad/s)
     const float spin_rate = sqrtf(sq(gx) + sq(gy) + sq(gz));
 
@@ -334,13 +361,12 @@ static void imuMahonyAHRSupdate(float dt, float gx, float gy, float gz,
     q.y *= recipNorm;
     q.z *= recipNorm;
 
-    // Pre-compute rotation matrix from quaternion
-    imuComputeRotationMatrix();
+    attitudeGeneration++;
 
     attitudeIsEstablished = true;
 }
 
-STATIC_UNIT_TESTED void imuUpdateEulerAngles(void)
+static void imuComputeEulerAngles(bool updateYaw)
 {
     quaternionProducts buffer;
 
@@ -351,9 +377,13 @@ STATIC_UNIT_TESTED void imuUpdateEulerAngles(void)
        attitude.values.pitch = lrintf(((0.5f * M_PIf) - acos_approx(+2.0f * (buffer.wy - buffer.xz))) * (1800.0f / M_PIf));
        attitude.values.yaw = lrintf((-atan2_approx((+2.0f * (buffer.wz + buffer.xy)), (+1.0f - 2.0f * (buffer.yy + buffer.zz))) * (1800.0f / M_PIf)));
     } else {
+       imuUpdateRotationMatrix();
+
        attitude.values.roll = lrintf(atan2_approx(rMat[2][1], rMat[2][2]) * (1800.0f / M_PIf));
        attitude.values.pitch = lrintf(((0.5f * M_PIf) - acos_approx(-rMat[2][0])) * (1800.0f / M_PIf));
-       attitude.values.yaw = lrintf((-atan2_approx(rMat[1][0], rMat[0][0]) * (1800.0f / M_PIf)));
+       if (updateYaw) {
+           attitude.values.yaw = lrintf((-atan2_approx(rMat[1][0], rMat[0][0]) * (1800.0f / M_PIf)));
+       }
     }
 
     if (attitude.values.yaw < 0) {
@@ -361,6 +391,11 @@ STATIC_UNIT_TESTED void imuUpdateEulerAngles(void)
     }
 }
 
+STATIC_UNIT_TESTED void imuUpdateEulerAngles(void)
+{
+    imuComputeEulerAngles(true);
+}
+
 static bool imuIsAccelerometerHealthy(float *accAverage)
 {
     float accMagnitudeSq = 0;
@@ -548,7 +583,8 @@ static void imuCalculateEstimatedAttitude(timeUs_t currentTimeUs)
     float gyroAverage[XYZ_AXIS_COUNT];
     gyroGetAccumulationAverage(gyroAverage);
 
-    if (accGetAccumulationAverage(accAverage)) {
+    const bool accUpdated = accGetAccumulationAverage(accAverage);
+    if (accUpdated) {
         useAcc = imuIsAccelerometerHealthy(accAverage);
     }
 
@@ -558,8 +594,22 @@ static void imuCalculateEstimatedAttitude(timeUs_t currentTimeUs)
                         useMag,
                         useCOG, courseOverGround,  imuCalcKpGain(currentTimeUs, useAcc, gyroAverage));
 
-    imuUpdateEulerAngles();
+    const bool updateYaw = cmpTimeUs(currentTimeUs, eulerYawUpdatedAtUs) >= IMU_EULER_YAW_UPDATE_INTERVAL_US;
+    if (updateYaw) {
+        eulerYawUpdatedAtUs = currentTimeUs;
+    }
+    imuComputeEulerAngles(updateYaw);
+
+#if defined(USE_BARO) || defined(USE_GPS)
+    // also in climbs and turns, when the acceleration is not used for the attitude
+    if (accUpdated) {
+        predictEstimatedAltitude(accAverage, deltaT * 1e-6f);
+    }
+#endif
 #endif
+
+    predictedAttitude[FD_ROLL] = attitude.values.roll;
+    predictedAttitude[FD_PITCH] = attitude.values.pitch;
 }
 
 static int calculateThrottleAngleCorrection(void)
@@ -581,6 +631,10 @@ static int calculateThrottleAngleCorrection(void)
 void imuUpdateAttitude(timeUs_t currentTimeUs)
 {
     if (sensors(SENSOR_ACC) && acc.isAccelUpdatedAtLeastOnce) {
+        // Self levelling needs the full acc rate, in acro it only corrects gyro drift
+        const bool imuNeedsFullAccRate = !ARMING_FLAG(ARMED) || FLIGHT_MODE(ANGLE_MODE | HORIZON_MODE | GPS_RESCUE_MODE);
+        accSetRequiredRate(ACC_CONSUMER_IMU, imuNeedsFullAccRate ? ACC_RATE_FULL : IMU_ACRO_ACC_RATE_HZ);
+
         IMU_LOCK;
 #if defined(SIMULATOR_BUILD) && defined(SIMULATOR_IMU_SYNC)
         if (imuUpdated == false) {
@@ -605,6 +659,23 @@ void imuUpdateAttitude(timeUs_t currentTimeUs)
         acc.accADC[Z] = 0;
     }
 }
+// Between attitude updates roll and pitch are advanced with the filtered gyro so
+// pidLevel() doesn't see attitude that is up to a full attitude task period old.
+// Body rates are taken as Euler rates, which holds over the short prediction
+// window, and the next attitude update replaces the prediction.
+FAST_CODE void imuPredictLevelAttitude(float dT)
+{
+    if (!imuRuntimeConfig.levelPredict || !attitudeIsEstablished || !(FLIGHT_MODE(ANGLE_MODE) || FLIGHT_MODE(HORIZON_MODE))) {
+        return;
+    }
+
+    IMU_LOCK;
+    predictedAttitude[FD_ROLL] = constrainf(predictedAttitude[FD_ROLL] + gyro.gyroADCf[FD_ROLL] * dT * 10.0f, -1800.0f, 1800.0f);
+    predictedAttitude[FD_PITCH] = constrainf(predictedAttitude[FD_PITCH] + gyro.gyroADCf[FD_PITCH] * dT * 10.0f, -900.0f, 900.0f);
+    attitude.values.roll = lrintf(predictedAttitude[FD_ROLL]);
+    attitude.values.pitch = lrintf(predictedAttitude[FD_PITCH]);
+    IMU_UNLOCK;
+}
 #endif // USE_ACC
 
 bool shouldInitializeGPSHeading()
@@ -622,9 +693,24 @@ bool shouldInitializeGPSHeading()
 
 float getCosTiltAngle(void)
 {
+    imuUpdateRotationMatrix();
     return rMat[2][2];
 }
 
+// Rotate a body frame vector into the earth frame with X north, Y east and Z up
+void imuTransformVectorBodyToEarth(t_fp_vector_def *v)
+{
+    imuUpdateRotationMatrix();
+
+    const float x = rMat[0][0] * v->X + rMat[0][1] * v->Y + rMat[0][2] * v->Z;
+    const float y = rMat[1][0] * v->X + rMat[1][1] * v->Y + rMat[1][2] * v->Z;
+    const float z = rMat[2][0] * v->X + rMat[2][1] * v->Y + rMat[2][2] * v->Z;
+
+    v->X = x;
+    v->Y = -y;
+    v->Z = z;
+}
+
 void getQuaternion(quaternion *quat)
 {
    quat->w = q.w;
@@ -59,6 +59,7 @@ typedef struct imuConfig_s {
     uint16_t dcm_kp;                        // DCM filter proportional gain ( x 10000)
     uint16_t dcm_ki;                        // DCM filter integral gain ( x 10000)
     uint8_t small_angle;
+    uint8_t level_predict;                  // integrate gyro into roll/pitch at PID rate between attitude updates in level modes
 } imuConfig_t;
 
 PG_DECLARE(imuConfig_t, imuConfig);
@@ -66,13 +67,16 @@ PG_DECLARE(imuConfig_t, imuConfig);
 typedef struct imuRuntimeConfig_s {
     float dcm_ki;
     float dcm_kp;
+    bool levelPredict;
 } imuRuntimeConfig_t;
 
 void imuConfigure(uint16_t throttle_correction_angle, uint8_t throttle_correction_value);
 
 float getCosTiltAngle(void);
+void imuTransformVectorBodyToEarth(t_fp_vector_def *v);
 void getQuaternion(quaternion * q);
 void imuUpdateAttitude(timeUs_t currentTimeUs);
+void imuPredictLevelAttitude(float dT);
 
 void imuResetAccelerationSum(void);
 void imuInit(void);
@@ -33,9 +33,6 @@
 
 #include "interpolated_setpoint.h"
 
-static float setpointDeltaImpl[XYZ_AXIS_COUNT];
-static float setpointDelta[XYZ_AXIS_COUNT];
-
 typedef struct laggedMovingAverageCombined_s {
      laggedMovingAverage_t filter;
      float buf[4];
@@ -43,16 +40,28 @@ typedef struct laggedMovingAverageCombined_s {
 
 laggedMovingAverageCombined_t  setpointDeltaAvg[XYZ_AXIS_COUNT];
 
-static float prevSetpointSpeed[XYZ_AXIS_COUNT];
-static float prevAcceleration[XYZ_AXIS_COUNT];
-static float prevRawSetpoint[XYZ_AXIS_COUNT];
-//for smoothing
-static float prevDeltaImpl[XYZ_AXIS_COUNT];
-static float prevBoostAmount[XYZ_AXIS_COUNT];
+// everything kept per axis between RC frames
+typedef struct ffAxisState_s {
+    float prevSetpointSpeed;
+    float prevAcceleration;
+    float prevRawSetpoint;
+    //for smoothing
+    float prevDeltaImpl;
+    float prevBoostAmount;
+    float setpointDelta;
+    uint8_t ffStatus;
+    bool bigStep;
+} ffAxisState_t;
+
+static ffAxisState_t ffAxisState[XYZ_AXIS_COUNT];
 
-static uint8_t ffStatus[XYZ_AXIS_COUNT];
-static bool bigStep[XYZ_AXIS_COUNT];
 static uint8_t averagingCount;
+static float averagingCountInv;
+static float slowStickBoostModifier;
+
+// the RC frame rate only changes with the link, its reciprocal is recalculated then
+static uint16_t rxRefreshRateUs;
+static float rxRateHz;
 
 static float ffMaxRateLimit[XYZ_AXIS_COUNT];
 static float ffMaxRate[XYZ_AXIS_COUNT];
@@ -60,6 +69,9 @@ static float ffMaxRate[XYZ_AXIS_COUNT];
 void interpolatedSpInit(const pidProfile_t *pidProfile) {
     const float ffMaxRateScale = pidProfile->ff_max_rate_limit * 0.01f;
     averagingCount = pidProfile->ff_interpolate_sp;
+    averagingCountInv = averagingCount ? 1.0f / averagingCount : 1.0f;
+    slowStickBoostModifier = 1.0f / (averagingCount + 1);
+    rxRefreshRateUs = 0;
     for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
         ffMaxRate[i] = applyCurve(i, 1.0f);
         ffMaxRateLimit[i] = ffMaxRate[i] * ffMaxRateScale;
@@ -68,122 +80,122 @@ void interpolatedSpInit(const pidProfile_t *pidProfile) {
 }
 
 FAST_CODE_NOINLINE float interpolatedSpApply(int axis, bool newRcFrame, ffInterpolationType_t type) {
+    ffAxisState_t *state = &ffAxisState[axis];
 
     if (newRcFrame) {
-        float rawSetpoint = getRawSetpoint(axis);
-        float absRawSetpoint = fabsf(rawSetpoint);
-        const float rxInterval = getCurrentRxRefreshRate() * 1e-6f;
-        const float rxRate = 1.0f / rxInterval;
-        float setpointSpeed = (rawSetpoint - prevRawSetpoint[axis]) * rxRate;
-        float absSetpointSpeed = fabsf(setpointSpeed);
-        float absPrevSetpointSpeed = fabsf(prevSetpointSpeed[axis]);
+        const uint16_t refreshRateUs = getCurrentRxRefreshRate();
+        if (refreshRateUs != rxRefreshRateUs) {
+            rxRefreshRateUs = refreshRateUs;
+            rxRateHz = 1e6f / refreshRateUs;
+        }
+
+        const float rawSetpoint = getRawSetpoint(axis);
+        const float absRawSetpoint = fabsf(rawSetpoint);
+        float setpointSpeed = (rawSetpoint - state->prevRawSetpoint) * rxRateHz;
+        const float absSetpointSpeed = fabsf(setpointSpeed);
+        const float absPrevSetpointSpeed = fabsf(state->prevSetpointSpeed);
         float setpointAccelerationModifier = 1.0f;
 
         if (setpointSpeed == 0 && absRawSetpoint < 0.98f * ffMaxRate[axis]) {
             // no movement, or sticks at max; ffStatus set
             // the max stick check is needed to prevent interpolation when arriving at max sticks
-            if (prevSetpointSpeed[axis] == 0) {
+            if (state->prevSetpointSpeed == 0) {
                 // no movement on two packets in a row
                 // do nothing now, but may use status = 3 to smooth following packet
-                ffStatus[axis] = 3;
+                state->ffStatus = 3;
             } else {
                 // there was movement on previous packet, now none
-                if (bigStep[axis] == true) {
+                if (state->bigStep) {
                     // previous movement was big; likely an early FrSky packet
                     // don't project these forward or we get a sustained large spike
-                    ffStatus[axis] = 2;
+                    state->ffStatus = 2;
                 } else {
                     // likely a dropped packet
                     // interpolate forward using previous setpoint speed and acceleration
-                    setpointSpeed = prevSetpointSpeed[axis] + prevAcceleration[axis];
+                    setpointSpeed = state->prevSetpointSpeed + state->prevAcceleration;
                     // use status = 1 to halve the step for the next packet
-                    ffStatus[axis] = 1;
+                    state->ffStatus = 1;
                 }
             }
         } else {
             // we have movement; let's consider what happened on previous packets, using ffStatus
-            if (ffStatus[axis] != 0) {
-                if (ffStatus[axis] == 1) {
+            if (state->ffStatus != 0) {
+                if (state->ffStatus == 1) {
                     // was interpolated forward after previous dropped packet after small step
                     // this step is likely twice as tall as it should be
-                    setpointSpeed = setpointSpeed / 2.0f;
-                } else if (ffStatus[axis] == 2) {
+                    setpointSpeed *= 0.5f;
+                } else if (state->ffStatus == 2) {
                     // we are doing nothing for these to avoid exaggerating the FrSky early packet problem
-                } else if (ffStatus[axis] == 3) {
+                } else if (state->ffStatus == 3) {
                     // movement after nothing on previous two packets
                     // reduce boost when higher averaging is used to improve slow stick smoothness
-                    setpointAccelerationModifier /= (averagingCount + 1);
+                    setpointAccelerationModifier = slowStickBoostModifier;
                 }
-                ffStatus[axis] = 0;
+                state->ffStatus = 0;
                 // all is normal
             }
         }
 
-        float setpointAcceleration = setpointSpeed - prevSetpointSpeed[axis];
+        float setpointAcceleration = setpointSpeed - state->prevSetpointSpeed;
 
         // determine if this step was a relatively large one, to use when evaluating next packet
-
-        if (absSetpointSpeed > 1.5f * absPrevSetpointSpeed || absPrevSetpointSpeed > 1.5f * absSetpointSpeed){
-            bigStep[axis] = true;
-        } else {
-            bigStep[axis] = false;
-        }
+        state->bigStep = absSetpointSpeed > 1.5f * absPrevSetpointSpeed || absPrevSetpointSpeed > 1.5f * absSetpointSpeed;
 
         // smooth deadband type suppression of FF jitter when sticks are at or returning to centre
         // only when ff_averaging is 3 or more, for HD or cinematic flying
         if (averagingCount > 2) {
-            const float rawSetpointCentred = absRawSetpoint / averagingCount;
+            const float rawSetpointCentred = absRawSetpoint * averagingCountInv;
             if (rawSetpointCentred < 1.0f) {
                 setpointSpeed *= rawSetpointCentred;
                 setpointAcceleration *= rawSetpointCentred;
             }
         }
 
-        prevAcceleration[axis] = setpointAcceleration;
-     
-        // all values afterwards are small numbers
-        setpointAcceleration *= pidGetDT();
-        setpointDeltaImpl[axis] = setpointSpeed * pidGetDT();
+        state->prevAcceleration = setpointAcceleration;
 
+        // all values afterwards are small numbers
+        const float dT = pidGetDT();
+        setpointAcceleration *= dT;
+        float setpointDeltaImpl = setpointSpeed * dT;
 
         const float ffBoostFactor = pidGetFfBoostFactor();
         float boostAmount = 0.0f;
         if (ffBoostFactor != 0.0f) {
             // calculate boost and prevent kick-back spike at max deflection
-            if (fabsf(rawSetpoint) < 0.95f * ffMaxRate[axis] || absSetpointSpeed > 3.0f * absPrevSetpointSpeed) {
+            if (absRawSetpoint < 0.95f * ffMaxRate[axis] || absSetpointSpeed > 3.0f * absPrevSetpointSpeed) {
                 boostAmount = ffBoostFactor * setpointAcceleration * setpointAccelerationModifier;
             }
         }
 
-        prevSetpointSpeed[axis] = setpointSpeed;
-        prevRawSetpoint[axis] = rawSetpoint;
+        state->prevSetpointSpeed = setpointSpeed;
+        state->prevRawSetpoint = rawSetpoint;
 
         if (axis == FD_ROLL) {
-            DEBUG_SET(DEBUG_FF_INTERPOLATED, 0, lrintf(setpointDeltaImpl[axis] * 100));
+            DEBUG_SET(DEBUG_FF_INTERPOLATED, 0, lrintf(setpointDeltaImpl * 100));
             DEBUG_SET(DEBUG_FF_INTERPOLATED, 1, lrintf(setpointAcceleration * 100));
-            DEBUG_SET(DEBUG_FF_INTERPOLATED, 2, lrintf(((setpointDeltaImpl[axis] + boostAmount) * 100)));
-            DEBUG_SET(DEBUG_FF_INTERPOLATED, 3, ffStatus[axis]);
+            DEBUG_SET(DEBUG_FF_INTERPOLATED, 2, lrintf(((setpointDeltaImpl + boostAmount) * 100)));
+            DEBUG_SET(DEBUG_FF_INTERPOLATED, 3, state->ffStatus);
         }
 
         // first order smoothing of boost to reduce jitter
         const float ffSmoothFactor = pidGetFfSmoothFactor();
-        boostAmount = prevBoostAmount[axis] + ffSmoothFactor * (boostAmount - prevBoostAmount[axis]);
-        prevBoostAmount[axis] = boostAmount;
+        boostAmount = state->prevBoostAmount + ffSmoothFactor * (boostAmount - state->prevBoostAmount);
+        state->prevBoostAmount = boostAmount;
 
-        setpointDeltaImpl[axis] += boostAmount;
+        setpointDeltaImpl += boostAmount;
 
         // first order smoothing of FF (second order boost filtering since boost filtered twice)
-        setpointDeltaImpl[axis] = prevDeltaImpl[axis] + ffSmoothFactor * (setpointDeltaImpl[axis] - prevDeltaImpl[axis]);
-        prevDeltaImpl[axis] = setpointDeltaImpl[axis];
+        setpointDeltaImpl = state->prevDeltaImpl + ffSmoothFactor * (setpointDeltaImpl - state->prevDeltaImpl);
+        state->prevDeltaImpl = setpointDeltaImpl;
 
         // apply averaging
         if (type == FF_INTERPOLATE_ON) {
-            setpointDelta[axis] = setpointDeltaImpl[axis];
+            state->setpointDelta = setpointDeltaImpl;
         } else {
-            setpointDelta[axis] = laggedMovingAverageUpdate(&setpointDeltaAvg[axis].filter, setpointDeltaImpl[axis]);
+            state->setpointDelta = laggedMovingAverageUpdate(&setpointDeltaAvg[axis].filter, setpointDeltaImpl);
         }
     }
-    return setpointDelta[axis];
+    return state->setpointDelta;
 }
 
 FAST_CODE_NOINLINE float applyFfLimit(int axis, float value, float Kp, float currentPidSetpoint) {
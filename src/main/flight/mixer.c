@@ -65,6 +65,8 @@
 #define DYN_LPF_THROTTLE_STEPS           100
 #define DYN_LPF_THROTTLE_UPDATE_DELAY_US 5000 // minimum of 5ms between updates
 
+#define DYN_IDLE_MAX_UPDATE_INTERVAL_US 1000 // dynamic idle runs at least this often while the motor frequency is steady
+
 static FAST_DATA_ZERO_INIT float motorMixRange;
 
 float FAST_DATA_ZERO_INIT motor[MAX_SUPPORTED_MOTORS];
@@ -218,19 +220,26 @@ static void calculateThrottleAndCurrentMotorEndpoints(timeUs_t currentTimeUs)
         throttle = rcCommand[THROTTLE] - PWM_RANGE_MIN + throttleAngleCorrection;
 #ifdef USE_DYN_IDLE
         if (mixerRuntime.idleMinMotorRps > 0.0f) {
-            const float maxIncrease = isAirmodeActivated() ? mixerRuntime.idleMaxIncrease : 0.04f;
+            // the RPM filter moves the minimum motor frequency on as it steps through the motors, the controller
+            // only runs when it has changed and is stepped over the time since it last ran
             const float minRps = rpmMinMotorFrequency();
-            const float targetRpsChangeRate = (mixerRuntime.idleMinMotorRps - minRps) * currentPidProfile->idle_adjustment_speed;
-            const float error = targetRpsChangeRate - (minRps - mixerRuntime.oldMinRps) * pidGetPidFrequency();
-            const float pidSum = constrainf(mixerRuntime.idleP * error, -currentPidProfile->idle_pid_limit, currentPidProfile->idle_pid_limit);
-            motorRangeMinIncrease = constrainf(motorRangeMinIncrease + pidSum * pidGetDT(), 0.0f, maxIncrease);
-            mixerRuntime.oldMinRps = minRps;
+            const timeDelta_t idleDeltaUs = cmpTimeUs(currentTimeUs, mixerRuntime.idleUpdatedAtUs);
+            if (minRps != mixerRuntime.oldMinRps || idleDeltaUs >= DYN_IDLE_MAX_UPDATE_INTERVAL_US) {
+                const float idleDt = MIN(idleDeltaUs, DYN_IDLE_MAX_UPDATE_INTERVAL_US) * 1e-6f;
+                const float maxIncrease = isAirmodeActivated() ? mixerRuntime.idleMaxIncrease : 0.04f;
+                const float targetRpsChangeRate = (mixerRuntime.idleMinMotorRps - minRps) * currentPidProfile->idle_adjustment_speed;
+                const float error = targetRpsChangeRate - (minRps - mixerRuntime.oldMinRps) / idleDt;
+                const float pidSum = constrainf(mixerRuntime.idleP * error, -currentPidProfile->idle_pid_limit, currentPidProfile->idle_pid_limit);
+                motorRangeMinIncrease = constrainf(motorRangeMinIncrease + pidSum * idleDt, 0.0f, maxIncrease);
+                mixerRuntime.oldMinRps = minRps;
+                mixerRuntime.idleUpdatedAtUs = currentTimeUs;
+
+                DEBUG_SET(DEBUG_DYN_IDLE, 0, motorRangeMinIncrease * 1000);
+                DEBUG_SET(DEBUG_DYN_IDLE, 1, targetRpsChangeRate);
+                DEBUG_SET(DEBUG_DYN_IDLE, 2, error);
+                DEBUG_SET(DEBUG_DYN_IDLE, 3, minRps);
+            }
             throttle += mixerRuntime.idleThrottleOffset;
-
-            DEBUG_SET(DEBUG_DYN_IDLE, 0, motorRangeMinIncrease * 1000);
-            DEBUG_SET(DEBUG_DYN_IDLE, 1, targetRpsChangeRate);
-            DEBUG_SET(DEBUG_DYN_IDLE, 2, error);
-            DEBUG_SET(DEBUG_DYN_IDLE, 3, minRps);
         } else {
             motorRangeMinIncrease = 0;
         }
@@ -341,41 +350,96 @@ static void applyFlipOverAfterCrashModeToMotors(void)
     }
 }
 
-static void applyMixToMotors(float motorMix[MAX_SUPPORTED_MOTORS], motorMixer_t *activeMixer)
+#ifdef USE_RPM_FILTER
+#define MOTOR_LAG_COMP_MIN_OUTPUT 0.05f // below this the eRPM feedback is too coarse to compare against
+
+// Feed forward the difference between the commanded and the measured motor speed to make up for motor
+// and ESC lag. The measured speed is brought into motor output units with a slow running estimate of
+// Hz per unit of output, so no motor kV or prop model is needed. Cost is fixed at two divisions per motor.
+static FAST_CODE float applyMotorLagCompensation(int motor, float motorOutput)
+{
+    const float measuredHz = rpmGetFilteredMotorFrequency(motor);
+    if (motorOutput < MOTOR_LAG_COMP_MIN_OUTPUT || measuredHz <= 0.0f) {
+        return motorOutput;
+    }
+
+    pt1Filter_t *hzPerOutputLpf = &mixerRuntime.motorLagCompHzPerOutput[motor];
+    const float hzPerOutputSample = measuredHz / motorOutput;
+    if (hzPerOutputLpf->state == 0.0f) {
+        // seed the estimate so the first corrections after spin up aren't clipped to the limit
+        hzPerOutputLpf->state = hzPerOutputSample;
+    }
+    const float hzPerOutput = pt1FilterApply(hzPerOutputLpf, hzPerOutputSample);
+    const float speedError = motorOutput - measuredHz / hzPerOutput;
+    const float correction = constrainf(mixerRuntime.motorLagCompGain * speedError, -mixerRuntime.motorLagCompLimit, mixerRuntime.motorLagCompLimit);
+
+    if (motor == 0) {
+        DEBUG_SET(DEBUG_MOTOR_LAG_COMP, 0, lrintf(correction * 1000));
+        DEBUG_SET(DEBUG_MOTOR_LAG_COMP, 1, lrintf(speedError * 1000));
+        DEBUG_SET(DEBUG_MOTOR_LAG_COMP, 2, lrintf(measuredHz));
+    }
+
+    return motorOutput + correction;
+}
+#endif
+
+// Scale the roll/pitch/yaw mix, add throttle and constrain to the motor endpoints in a single pass.
+// motorMixScale normalises the mix when its range exceeds the available motor range.
+static void applyMixToMotors(const float motorMix[MAX_SUPPORTED_MOTORS], const motorMixer_t *activeMixer, float motorMixScale)
 {
+    // Disarmed mode
+    if (!ARMING_FLAG(ARMED)) {
+        for (int i = 0; i < mixerRuntime.motorCount; i++) {
+            motor[i] = motor_disarmed[i];
+        }
+        return;
+    }
+
+    // the output limits only depend on the failsafe state, not on the motor
+    const bool failsafeActive = failsafeIsActive();
+    const float motorOutputLimitLow = failsafeActive ? mixerRuntime.disarmMotorOutput : motorRangeMin;
+#ifdef USE_DSHOT
+    const bool avoidDshotReservedRange = failsafeActive && isMotorProtocolDshot();
+#endif
+#ifdef USE_SERVOS
+    const bool tricopter = mixerIsTricopter();
+#endif
+    const float mixScale = motorOutputMixSign * motorMixScale;
+#ifdef USE_RPM_FILTER
+    const bool motorLagComp = mixerRuntime.motorLagCompGain > 0.0f;
+    const timeUs_t motorLagCompStartUs = debugModeIsEnabled(DEBUG_MOTOR_LAG_COMP) ? micros() : 0;
+#endif
+
     // Now add in the desired throttle, but keep in a range that doesn't clip adjusted
     // roll/pitch/yaw. This could move throttle down, but also up for those low throttle flips.
     for (int i = 0; i < mixerRuntime.motorCount; i++) {
-        float motorOutput = motorOutputMixSign * motorMix[i] + throttle * activeMixer[i].throttle;
+        float motorOutput = mixScale * motorMix[i] + throttle * activeMixer[i].throttle;
 #ifdef USE_THRUST_LINEARIZATION
         motorOutput = pidApplyThrustLinearization(motorOutput);
+#endif
+#ifdef USE_RPM_FILTER
+        if (motorLagComp) {
+            motorOutput = applyMotorLagCompensation(i, motorOutput);
+        }
 #endif
         motorOutput = motorOutputMin + motorOutputRange * motorOutput;
 
 #ifdef USE_SERVOS
-        if (mixerIsTricopter()) {
+        if (tricopter) {
             motorOutput += mixerTricopterMotorCorrection(i);
         }
 #endif
-        if (failsafeIsActive()) {
 #ifdef USE_DSHOT
-            if (isMotorProtocolDshot()) {
-                motorOutput = (motorOutput < motorRangeMin) ? mixerRuntime.disarmMotorOutput : motorOutput; // Prevent getting into special reserved range
-            }
-#endif
-            motorOutput = constrain(motorOutput, mixerRuntime.disarmMotorOutput, motorRangeMax);
-        } else {
-            motorOutput = constrain(motorOutput, motorRangeMin, motorRangeMax);
+        if (avoidDshotReservedRange) {
+            motorOutput = (motorOutput < motorRangeMin) ? mixerRuntime.disarmMotorOutput : motorOutput; // Prevent getting into special reserved range
         }
-        motor[i] = motorOutput;
+#endif
+        motor[i] = constrain(motorOutput, motorOutputLimitLow, motorRangeMax);
     }
 
-    // Disarmed mode
-    if (!ARMING_FLAG(ARMED)) {
-        for (int i = 0; i < mixerRuntime.motorCount; i++) {
-            motor[i] = motor_disarmed[i];
-        }
-    }
+#ifdef USE_RPM_FILTER
+    DEBUG_SET_IF_ENABLED(DEBUG_MOTOR_LAG_COMP, 3, micros() - motorLagCompStartUs);
+#endif
 }
 
 static float applyThrottleLimit(float throttle)
@@ -393,6 +457,39 @@ static float applyThrottleLimit(float throttle)
     return throttle;
 }
 
+#ifdef USE_CURRENT_LIMIT
+#define CURRENT_LIMIT_UPDATE_INTERVAL_US 1000   // the ADC averages over a few ms, sampling faster gains nothing
+#define CURRENT_LIMIT_MAX_INTERVAL_US    100000 // don't integrate the charge across a stalled PID loop
+#define CURRENT_LIMIT_P                  1.0f   // throttle reduction per relative overcurrent
+#define CURRENT_LIMIT_I                  5.0f   // throttle reduction per second per relative overcurrent
+#define CURRENT_LIMIT_MIN_FACTOR         0.2f
+
+// Scale the throttle down to hold the current below current_limit, PI controlled on the ADC current meter
+static float applyCurrentLimit(timeUs_t currentTimeUs, float throttle)
+{
+    const timeDelta_t sinceUpdateUs = cmpTimeUs(currentTimeUs, mixerRuntime.currentLimitUpdatedAtUs);
+
+    if (sinceUpdateUs >= CURRENT_LIMIT_UPDATE_INTERVAL_US) {
+        const timeDelta_t intervalUs = MIN(sinceUpdateUs, CURRENT_LIMIT_MAX_INTERVAL_US);
+        const int32_t amperage = currentMeterADCFastRefresh(intervalUs);
+        mixerRuntime.currentLimitUpdatedAtUs = currentTimeUs;
+
+        if (ARMING_FLAG(ARMED)) {
+            const float overcurrent = (amperage - mixerRuntime.currentLimitCentiamps) / mixerRuntime.currentLimitCentiamps;
+            mixerRuntime.currentLimitIntegral = constrainf(mixerRuntime.currentLimitIntegral - CURRENT_LIMIT_I * overcurrent * intervalUs * 1e-6f,
+                CURRENT_LIMIT_MIN_FACTOR, 1.0f);
+            mixerRuntime.currentLimitFactor = constrainf(mixerRuntime.currentLimitIntegral - CURRENT_LIMIT_P * MAX(overcurrent, 0.0f),
+                CURRENT_LIMIT_MIN_FACTOR, 1.0f);
+        } else {
+            mixerRuntime.currentLimitIntegral = 1.0f;
+            mixerRuntime.currentLimitFactor = 1.0f;
+        }
+    }
+
+    return throttle * mixerRuntime.currentLimitFactor;
+}
+#endif
+
 static void applyMotorStop(void)
 {
     for (int i = 0; i < mixerRuntime.motorCount; i++) {
@@ -467,6 +564,12 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs)
         throttle = applyThrottleLimit(throttle);
     }
 
+#ifdef USE_CURRENT_LIMIT
+    if (mixerRuntime.currentLimitCentiamps > 0.0f) {
+        throttle = applyCurrentLimit(currentTimeUs, throttle);
+    }
+#endif
+
     const bool airmodeEnabled = airmodeIsEnabled() || launchControlActive;
 
 #ifdef USE_YAW_SPIN_RECOVERY
@@ -537,10 +640,10 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs)
     mixerThrottle = throttle;
 
     motorMixRange = motorMixMax - motorMixMin;
+    float motorMixScale = 1.0f;
     if (motorMixRange > 1.0f) {
-        for (int i = 0; i < mixerRuntime.motorCount; i++) {
-            motorMix[i] /= motorMixRange;
-        }
+        // the mix is normalised while it is applied to the motors
+        motorMixScale = 1.0f / motorMixRange;
         // Get the maximum correction by setting offset to center when airmode enabled
         if (airmodeEnabled) {
             throttle = 0.5f;
@@ -568,7 +671,7 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs)
         applyMotorStop();
     } else {
         // Apply the mix to motor endpoints
-        applyMixToMotors(motorMix, activeMixer);
+        applyMixToMotors(motorMix, activeMixer, motorMixScale);
     }
 }
 
@@ -37,6 +37,7 @@
 
 #include "flight/mixer_tricopter.h"
 #include "flight/pid.h"
+#include "flight/rpm_filter.h"
 
 #include "rx/rx.h"
 
@@ -44,13 +45,16 @@
 
 #include "mixer_init.h"
 
-PG_REGISTER_WITH_RESET_TEMPLATE(mixerConfig_t, mixerConfig, PG_MIXER_CONFIG, 0);
+#define MOTOR_LAG_COMP_MODEL_CUTOFF_HZ 1.0f // motor speed per unit output only changes with battery sag and prop load
+
+PG_REGISTER_WITH_RESET_TEMPLATE(mixerConfig_t, mixerConfig, PG_MIXER_CONFIG, 1);
 
 PG_RESET_TEMPLATE(mixerConfig_t, mixerConfig,
     .mixerMode = DEFAULT_MIXER,
     .yaw_motors_reversed = false,
     .crashflip_motor_percent = 0,
-    .crashflip_expo = 35
+    .crashflip_expo = 35,
+    .current_limit = 0,
 );
 
 PG_REGISTER_ARRAY(motorMixer_t, MAX_SUPPORTED_MOTORS, customMotorMixer, PG_MOTOR_MIXER, 0);
@@ -302,6 +306,15 @@ void mixerInitProfile(void)
     mixerRuntime.idleMaxIncrease = currentPidProfile->idle_max_increase * 0.001f;
     mixerRuntime.idleP = currentPidProfile->idle_p * 0.0001f;
     mixerRuntime.oldMinRps = 0;
+    mixerRuntime.idleUpdatedAtUs = 0;
+#endif
+
+#ifdef USE_RPM_FILTER
+    mixerRuntime.motorLagCompGain = (isRpmFilterEnabled() && !featureIsEnabled(FEATURE_3D)) ? currentPidProfile->motor_lag_comp / 100.0f : 0.0f;
+    mixerRuntime.motorLagCompLimit = currentPidProfile->motor_lag_comp_limit / 100.0f;
+    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
+        pt1FilterInit(&mixerRuntime.motorLagCompHzPerOutput[i], pt1FilterGain(MOTOR_LAG_COMP_MODEL_CUTOFF_HZ, pidGetDT()));
+    }
 #endif
 
 #if defined(USE_BATTERY_VOLTAGE_SAG_COMPENSATION)
@@ -413,6 +426,16 @@ void mixerInit(mixerMode_e mixerMode)
     mixerRuntime.idleThrottleOffset = getDigitalIdleOffset(motorConfig()) * PWM_RANGE;
 #endif
 
+#ifdef USE_CURRENT_LIMIT
+    // only the ADC current meter can be sampled at the PID loop rate
+    mixerRuntime.currentLimitCentiamps = 0.0f;
+    if (batteryConfig()->currentMeterSource == CURRENT_METER_ADC) {
+        mixerRuntime.currentLimitCentiamps = mixerConfig()->current_limit * 100.0f;
+    }
+    mixerRuntime.currentLimitFactor = 1.0f;
+    mixerRuntime.currentLimitIntegral = 1.0f;
+#endif
+
     mixerConfigureOutput();
 }
 
@@ -22,6 +22,8 @@
 
 #include "platform.h"
 
+#include "common/filter.h"
+
 #include "flight/mixer.h"
 
 
@@ -43,6 +45,18 @@ typedef struct mixerRuntime_s {
     float idleMinMotorRps;
     float idleP;
     float oldMinRps;
+    timeUs_t idleUpdatedAtUs;
+#endif
+#ifdef USE_RPM_FILTER
+    float motorLagCompGain;
+    float motorLagCompLimit;
+    pt1Filter_t motorLagCompHzPerOutput[MAX_SUPPORTED_MOTORS];
+#endif
+#ifdef USE_CURRENT_LIMIT
+    float currentLimitCentiamps;        // 0 if the current limit is off
+    float currentLimitFactor;           // applied to the throttle
+    float currentLimitIntegral;
+    timeUs_t currentLimitUpdatedAtUs;
 #endif
 #if defined(USE_BATTERY_VOLTAGE_SAG_COMPENSATION)
     float vbatSagCompensationFactor;
@@ -87,7 +87,7 @@ FAST_DATA_ZERO_INIT float throttleBoost;
 pt1Filter_t throttleLpf;
 #endif
 
-PG_REGISTER_WITH_RESET_TEMPLATE(pidConfig_t, pidConfig, PG_PID_CONFIG, 2);
+PG_REGISTER_WITH_RESET_TEMPLATE(pidConfig_t, pidConfig, PG_PID_CONFIG, 3);
 
 #if defined(STM32F1)
 #define PID_PROCESS_DENOM_DEFAULT       8
@@ -104,11 +104,13 @@ PG_RESET_TEMPLATE(pidConfig_t, pidConfig,
     .pid_process_denom = PID_PROCESS_DENOM_DEFAULT,
     .runaway_takeoff_prevention = true,
     .runaway_takeoff_deactivate_throttle = 20,  // throttle level % needed to accumulate deactivation time
-    .runaway_takeoff_deactivate_delay = 500     // Accumulated time (in milliseconds) before deactivation in successful takeoff
+    .runaway_takeoff_deactivate_delay = 500,    // Accumulated time (in milliseconds) before deactivation in successful takeoff
+    .pid_outer_denom = 1,
 );
 #else
 PG_RESET_TEMPLATE(pidConfig_t, pidConfig,
-    .pid_process_denom = PID_PROCESS_DENOM_DEFAULT
+    .pid_process_denom = PID_PROCESS_DENOM_DEFAULT,
+    .pid_outer_denom = 1,
 );
 #endif
 
@@ -121,7 +123,7 @@ PG_RESET_TEMPLATE(pidConfig_t, pidConfig,
 
 #define LAUNCH_CONTROL_YAW_ITERM_LIMIT 50 // yaw iterm windup limit when launch mode is "FULL" (all axes)
 
-PG_REGISTER_ARRAY_WITH_RESET_FN(pidProfile_t, PID_PROFILE_COUNT, pidProfiles, PG_PID_PROFILE, 1);
+PG_REGISTER_ARRAY_WITH_RESET_FN(pidProfile_t, PID_PROFILE_COUNT, pidProfiles, PG_PID_PROFILE, 2);
 
 void resetPidProfile(pidProfile_t *pidProfile)
 {
@@ -209,6 +211,8 @@ void resetPidProfile(pidProfile_t *pidProfile)
         .dyn_lpf_curve_expo = 5,
         .level_race_mode = false,
         .vbat_sag_compensation = 0,
+        .motor_lag_comp = 0,
+        .motor_lag_comp_limit = 10,
     );
 #ifndef USE_D_MIN
     pidProfile->pid[PID_ROLL].D = 30;
@@ -302,9 +306,14 @@ void pidAcroTrainerInit(void)
 float pidCompensateThrustLinearization(float throttle)
 {
     if (pidRuntime.thrustLinearization != 0.0f) {
-        // for whoops where a lot of TL is needed, allow more throttle boost
-        const float throttleReversed = (1.0f - throttle);
-        throttle /= 1.0f + pidRuntime.throttleCompensateAmount * powerf(throttleReversed, 2);
+        // the throttle mostly only moves with new RC frames, the compensation is kept until it does
+        if (throttle != pidRuntime.thrustLinearizationThrottle) {
+            pidRuntime.thrustLinearizationThrottle = throttle;
+            // for whoops where a lot of TL is needed, allow more throttle boost
+            const float throttleReversed = (1.0f - throttle);
+            pidRuntime.thrustLinearizationCompensated = throttle / (1.0f + pidRuntime.throttleCompensateAmount * throttleReversed * throttleReversed);
+        }
+        throttle = pidRuntime.thrustLinearizationCompensated;
     }
     return throttle;
 }
@@ -402,70 +411,87 @@ STATIC_UNIT_TESTED FAST_CODE_NOINLINE float pidLevel(int axis, const pidProfile_
     return currentPidSetpoint;
 }
 
-static void handleCrashRecovery(
-    const pidCrashRecovery_e crash_recovery, const rollAndPitchTrims_t *angleTrim,
-    const int axis, const timeUs_t currentTimeUs, const float gyroRate, float *currentPidSetpoint, float *errorRate)
+// Evaluated once per PID cycle, returns true while the setpoints are overridden to level the aircraft
+static bool updateCrashRecovery(const pidCrashRecovery_e crash_recovery, const rollAndPitchTrims_t *angleTrim, const timeUs_t currentTimeUs)
 {
-    if (pidRuntime.inCrashRecoveryMode && cmpTimeUs(currentTimeUs, pidRuntime.crashDetectedAtUs) > pidRuntime.crashTimeDelayUs) {
-        if (crash_recovery == PID_CRASH_RECOVERY_BEEP) {
-            BEEP_ON;
-        }
-        if (axis == FD_YAW) {
-            *errorRate = constrainf(*errorRate, -pidRuntime.crashLimitYaw, pidRuntime.crashLimitYaw);
-        } else {
-            // on roll and pitch axes calculate currentPidSetpoint and errorRate to level the aircraft to recover from crash
-            if (sensors(SENSOR_ACC)) {
-                // errorAngle is deviation from horizontal
-                const float errorAngle =  -(attitude.raw[axis] - angleTrim->raw[axis]) / 10.0f;
-                *currentPidSetpoint = errorAngle * pidRuntime.levelGain;
-                *errorRate = *currentPidSetpoint - gyroRate;
-            }
-        }
-        // reset iterm, since accumulated error before crash is now meaningless
-        // and iterm windup during crash recovery can be extreme, especially on yaw axis
+    if (!pidRuntime.inCrashRecoveryMode || cmpTimeUs(currentTimeUs, pidRuntime.crashDetectedAtUs) <= pidRuntime.crashTimeDelayUs) {
+        return false;
+    }
+
+    if (crash_recovery == PID_CRASH_RECOVERY_BEEP) {
+        BEEP_ON;
+    }
+    // reset iterm, since accumulated error before crash is now meaningless
+    // and iterm windup during crash recovery can be extreme, especially on yaw axis
+    for (int axis = FD_ROLL; axis <= FD_YAW; ++axis) {
         pidData[axis].I = 0.0f;
-        if (cmpTimeUs(currentTimeUs, pidRuntime.crashDetectedAtUs) > pidRuntime.crashTimeLimitUs
-            || (getMotorMixRange() < 1.0f
-                   && fabsf(gyro.gyroADCf[FD_ROLL]) < pidRuntime.crashRecoveryRate
-                   && fabsf(gyro.gyroADCf[FD_PITCH]) < pidRuntime.crashRecoveryRate
-                   && fabsf(gyro.gyroADCf[FD_YAW]) < pidRuntime.crashRecoveryRate)) {
-            if (sensors(SENSOR_ACC)) {
-                // check aircraft nearly level
-                if (ABS(attitude.raw[FD_ROLL] - angleTrim->raw[FD_ROLL]) < pidRuntime.crashRecoveryAngleDeciDegrees
-                   && ABS(attitude.raw[FD_PITCH] - angleTrim->raw[FD_PITCH]) < pidRuntime.crashRecoveryAngleDeciDegrees) {
-                    pidRuntime.inCrashRecoveryMode = false;
-                    BEEP_OFF;
-                }
-            } else {
-                pidRuntime.inCrashRecoveryMode = false;
-                BEEP_OFF;
-            }
+    }
+
+    if (cmpTimeUs(currentTimeUs, pidRuntime.crashDetectedAtUs) > pidRuntime.crashTimeLimitUs
+        || (getMotorMixRange() < 1.0f
+               && fabsf(gyro.gyroADCf[FD_ROLL]) < pidRuntime.crashRecoveryRate
+               && fabsf(gyro.gyroADCf[FD_PITCH]) < pidRuntime.crashRecoveryRate
+               && fabsf(gyro.gyroADCf[FD_YAW]) < pidRuntime.crashRecoveryRate)) {
+        // check aircraft nearly level
+        if (!sensors(SENSOR_ACC)
+            || (ABS(attitude.raw[FD_ROLL] - angleTrim->raw[FD_ROLL]) < pidRuntime.crashRecoveryAngleDeciDegrees
+               && ABS(attitude.raw[FD_PITCH] - angleTrim->raw[FD_PITCH]) < pidRuntime.crashRecoveryAngleDeciDegrees)) {
+            pidRuntime.inCrashRecoveryMode = false;
+            BEEP_OFF;
         }
     }
+
+    return pidRuntime.inCrashRecoveryMode;
+}
+
+static void applyCrashRecovery(
+    const rollAndPitchTrims_t *angleTrim, const int axis, const float gyroRate, float *currentPidSetpoint, float *errorRate)
+{
+    if (axis == FD_YAW) {
+        *errorRate = constrainf(*errorRate, -pidRuntime.crashLimitYaw, pidRuntime.crashLimitYaw);
+    } else if (sensors(SENSOR_ACC)) {
+        // on roll and pitch axes calculate currentPidSetpoint and errorRate to level the aircraft to recover from crash
+        // errorAngle is deviation from horizontal
+        const float errorAngle =  -(attitude.raw[axis] - angleTrim->raw[axis]) / 10.0f;
+        *currentPidSetpoint = errorAngle * pidRuntime.levelGain;
+        *errorRate = *currentPidSetpoint - gyroRate;
+    }
 }
 
+// Evaluated once per PID cycle on the D term deltas and error rates of the axes in axisMask, the axes with D
 static void detectAndSetCrashRecovery(
-    const pidCrashRecovery_e crash_recovery, const int axis,
-    const timeUs_t currentTimeUs, const float delta, const float errorRate)
+    const pidCrashRecovery_e crash_recovery, const uint8_t axisMask,
+    const timeUs_t currentTimeUs, const float *delta, const float *errorRate)
 {
     // if crash recovery is on and accelerometer enabled and there is no gyro overflow, then check for a crash
     // no point in trying to recover if the crash is so severe that the gyro overflows
     if ((crash_recovery || FLIGHT_MODE(GPS_RESCUE_MODE)) && !gyroOverflowDetected()) {
         if (ARMING_FLAG(ARMED)) {
-            if (getMotorMixRange() >= 1.0f && !pidRuntime.inCrashRecoveryMode
-                && fabsf(delta) > pidRuntime.crashDtermThreshold
-                && fabsf(errorRate) > pidRuntime.crashGyroThreshold
-                && fabsf(getSetpointRate(axis)) < pidRuntime.crashSetpointThreshold) {
-                if (crash_recovery == PID_CRASH_RECOVERY_DISARM) {
-                    setArmingDisabled(ARMING_DISABLED_CRASH_DETECTED);
-                    disarm(DISARM_REASON_CRASH_PROTECTION);
-                } else {
-                    pidRuntime.inCrashRecoveryMode = true;
-                    pidRuntime.crashDetectedAtUs = currentTimeUs;
+            bool crashed = false;
+            bool settled = false;
+            for (int axis = FD_ROLL; axis <= FD_YAW; ++axis) {
+                if (axisMask & BIT(axis)) {
+                    const float absErrorRate = fabsf(errorRate[axis]);
+                    const float absSetpointRate = fabsf(getSetpointRate(axis));
+                    crashed |= fabsf(delta[axis]) > pidRuntime.crashDtermThreshold
+                        && absErrorRate > pidRuntime.crashGyroThreshold
+                        && absSetpointRate < pidRuntime.crashSetpointThreshold;
+                    settled |= absErrorRate < pidRuntime.crashGyroThreshold
+                        || absSetpointRate > pidRuntime.crashSetpointThreshold;
                 }
             }
-            if (pidRuntime.inCrashRecoveryMode && cmpTimeUs(currentTimeUs, pidRuntime.crashDetectedAtUs) < pidRuntime.crashTimeDelayUs && (fabsf(errorRate) < pidRuntime.crashGyroThreshold
-                || fabsf(getSetpointRate(axis)) > pidRuntime.crashSetpointThreshold)) {
+
+            if (!pidRuntime.inCrashRecoveryMode) {
+                if (crashed && getMotorMixRange() >= 1.0f) {
+                    if (crash_recovery == PID_CRASH_RECOVERY_DISARM) {
+                        setArmingDisabled(ARMING_DISABLED_CRASH_DETECTED);
+                        disarm(DISARM_REASON_CRASH_PROTECTION);
+                    } else {
+                        pidRuntime.inCrashRecoveryMode = true;
+                        pidRuntime.crashDetectedAtUs = currentTimeUs;
+                    }
+                }
+            } else if (cmpTimeUs(currentTimeUs, pidRuntime.crashDetectedAtUs) < pidRuntime.crashTimeDelayUs && settled) {
                 pidRuntime.inCrashRecoveryMode = false;
                 BEEP_OFF;
             }
@@ -553,14 +579,14 @@ static FAST_CODE_NOINLINE float applyAcroTrainer(int axis, const rollAndPitchTri
 
 static float accelerationLimit(int axis, float currentPidSetpoint)
 {
-    static float previousSetpoint[XYZ_AXIS_COUNT];
-    const float currentVelocity = currentPidSetpoint - previousSetpoint[axis];
+    const float previousSetpoint = pidRuntime.previousAccelerationLimitSetpoint[axis];
+    const float currentVelocity = currentPidSetpoint - previousSetpoint;
 
     if (fabsf(currentVelocity) > pidRuntime.maxVelocity[axis]) {
-        currentPidSetpoint = (currentVelocity > 0) ? previousSetpoint[axis] + pidRuntime.maxVelocity[axis] : previousSetpoint[axis] - pidRuntime.maxVelocity[axis];
+        currentPidSetpoint = (currentVelocity > 0) ? previousSetpoint + pidRuntime.maxVelocity[axis] : previousSetpoint - pidRuntime.maxVelocity[axis];
     }
 
-    previousSetpoint[axis] = currentPidSetpoint;
+    pidRuntime.previousAccelerationLimitSetpoint[axis] = currentPidSetpoint;
     return currentPidSetpoint;
 }
 
@@ -581,7 +607,7 @@ STATIC_UNIT_TESTED void rotateItermAndAxisError()
 {
     if (pidRuntime.itermRotation
 #if defined(USE_ABSOLUTE_CONTROL)
-        || pidRuntime.acGain > 0 || debugMode == DEBUG_AC_ERROR
+        || pidRuntime.acGain > 0 || debugModeIsEnabled(DEBUG_AC_ERROR)
 #endif
         ) {
         const float gyroToAngle = pidRuntime.dT * RAD;
@@ -590,7 +616,7 @@ STATIC_UNIT_TESTED void rotateItermAndAxisError()
             rotationRads[i] = gyro.gyroADCf[i] * gyroToAngle;
         }
 #if defined(USE_ABSOLUTE_CONTROL)
-        if (pidRuntime.acGain > 0 || debugMode == DEBUG_AC_ERROR) {
+        if (pidRuntime.acGain > 0 || debugModeIsEnabled(DEBUG_AC_ERROR)) {
             rotateVector(axisError, rotationRads);
         }
 #endif
@@ -617,10 +643,10 @@ float FAST_CODE applyRcSmoothingDerivativeFilter(int axis, float pidSetpointDelt
     if (pidRuntime.setpointDerivativeLpfInitialized) {
         switch (pidRuntime.rcSmoothingFilterType) {
             case RC_SMOOTHING_DERIVATIVE_PT1:
-                ret = pt1FilterApply(&pidRuntime.setpointDerivativePt1[axis], pidSetpointDelta);
+                ret = pt1FilterApply(&pidRuntime.axisFilter[axis].setpointDerivativePt1, pidSetpointDelta);
                 break;
             case RC_SMOOTHING_DERIVATIVE_BIQUAD:
-                ret = biquadFilterApplyDF1(&pidRuntime.setpointDerivativeBiquad[axis], pidSetpointDelta);
+                ret = biquadFilterApplyDF1(&pidRuntime.axisFilter[axis].setpointDerivativeBiquad, pidSetpointDelta);
                 break;
         }
         if (axis == pidRuntime.rcSmoothingDebugAxis) {
@@ -635,8 +661,8 @@ float FAST_CODE applyRcSmoothingDerivativeFilter(int axis, float pidSetpointDelt
 #if defined(USE_ABSOLUTE_CONTROL)
 STATIC_UNIT_TESTED void applyAbsoluteControl(const int axis, const float gyroRate, float *currentPidSetpoint, float *itermErrorRate)
 {
-    if (pidRuntime.acGain > 0 || debugMode == DEBUG_AC_ERROR) {
-        const float setpointLpf = pt1FilterApply(&pidRuntime.acLpf[axis], *currentPidSetpoint);
+    if (pidRuntime.acGain > 0 || debugModeIsEnabled(DEBUG_AC_ERROR)) {
+        const float setpointLpf = pt1FilterApply(&pidRuntime.axisFilter[axis].acLpf, *currentPidSetpoint);
         const float setpointHpf = fabsf(*currentPidSetpoint - setpointLpf);
         float acErrorRate = 0;
         const float gmaxac = setpointLpf + 2 * setpointHpf;
@@ -649,15 +675,15 @@ STATIC_UNIT_TESTED void applyAbsoluteControl(const int axis, const float gyroRat
             } else {
                 acErrorRate = acErrorRate2;
             }
-            if (fabsf(acErrorRate * pidRuntime.dT) > fabsf(axisError[axis]) ) {
-                acErrorRate = -axisError[axis] * pidRuntime.pidFrequency;
+            if (fabsf(acErrorRate * pidRuntime.outerDT) > fabsf(axisError[axis]) ) {
+                acErrorRate = -axisError[axis] * pidRuntime.outerPidFrequency;
             }
         } else {
             acErrorRate = (gyroRate > gmaxac ? gmaxac : gminac ) - gyroRate;
         }
 
         if (isAirmodeActivated()) {
-            axisError[axis] = constrainf(axisError[axis] + acErrorRate * pidRuntime.dT,
+            axisError[axis] = constrainf(axisError[axis] + acErrorRate * pidRuntime.outerDT,
                 -pidRuntime.acErrorLimit, pidRuntime.acErrorLimit);
             const float acCorrection = constrainf(axisError[axis] * pidRuntime.acGain, -pidRuntime.acLimit, pidRuntime.acLimit);
             *currentPidSetpoint += acCorrection;
@@ -675,7 +701,7 @@ STATIC_UNIT_TESTED void applyAbsoluteControl(const int axis, const float gyroRat
 STATIC_UNIT_TESTED void applyItermRelax(const int axis, const float iterm,
     const float gyroRate, float *itermErrorRate, float *currentPidSetpoint)
 {
-    const float setpointLpf = pt1FilterApply(&pidRuntime.windupLpf[axis], *currentPidSetpoint);
+    const float setpointLpf = pt1FilterApply(&pidRuntime.axisFilter[axis].windupLpf, *currentPidSetpoint);
     const float setpointHpf = fabsf(*currentPidSetpoint - setpointLpf);
 
     if (pidRuntime.itermRelax) {
@@ -775,21 +801,43 @@ static FAST_CODE_NOINLINE float applyLaunchControl(int axis, const rollAndPitchT
 }
 #endif
 
-// Betaflight pid controller, which will be maintained in the future with additional features specialised for current (mini) multirotor usage.
-// Based on 2DOF reference design (matlab)
-void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTimeUs)
+#if defined(USE_ACC)
+// Recalculate the level mode state, only needed when the flight mode flags or the PID profile change
+static void pidUpdateLevelModeState(timeUs_t currentTimeUs)
 {
-    static float previousGyroRateDterm[XYZ_AXIS_COUNT];
-#ifdef USE_INTERPOLATED_SP
-    static FAST_DATA_ZERO_INIT uint32_t lastFrameNumber;
-#endif
-    static float previousRawGyroRateDterm[XYZ_AXIS_COUNT];
+    const bool gpsRescueIsActive = FLIGHT_MODE(GPS_RESCUE_MODE);
+    levelMode_e levelMode;
+    if (FLIGHT_MODE(ANGLE_MODE) || FLIGHT_MODE(HORIZON_MODE) || gpsRescueIsActive) {
+        if (pidRuntime.levelRaceMode && !gpsRescueIsActive) {
+            levelMode = LEVEL_MODE_R;
+        } else {
+            levelMode = LEVEL_MODE_RP;
+        }
+    } else {
+        levelMode = LEVEL_MODE_OFF;
+    }
 
-#if defined(USE_ACC)
-    static timeUs_t levelModeStartTimeUs = 0;
-    static bool gpsRescuePreviousState = false;
+    // Keep track of when we entered a self-level mode so that we can
+    // add a guard time before crash recovery can activate.
+    // Also reset the guard time whenever GPS Rescue is activated.
+    if (levelMode) {
+        if ((pidRuntime.levelModeStartTimeUs == 0) || (gpsRescueIsActive && !pidRuntime.gpsRescuePreviousState)) {
+            pidRuntime.levelModeStartTimeUs = currentTimeUs;
+        }
+    } else {
+        pidRuntime.levelModeStartTimeUs = 0;
+    }
+    pidRuntime.gpsRescuePreviousState = gpsRescueIsActive;
+
+    pidRuntime.levelMode = levelMode;
+    pidRuntime.levelModeFlightModeFlags = flightModeFlags;
+}
 #endif
 
+// Betaflight pid controller, which will be maintained in the future with additional features specialised for current (mini) multirotor usage.
+// Based on 2DOF reference design (matlab)
+void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTimeUs)
+{
     const float tpaFactor = getThrottlePIDAttenuation();
 
 #if defined(USE_ACC)
@@ -812,29 +860,10 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
     const bool launchControlActive = isLaunchControlActive();
 
 #if defined(USE_ACC)
-    const bool gpsRescueIsActive = FLIGHT_MODE(GPS_RESCUE_MODE);
-    levelMode_e levelMode;
-    if (FLIGHT_MODE(ANGLE_MODE) || FLIGHT_MODE(HORIZON_MODE) || gpsRescueIsActive) {
-        if (pidRuntime.levelRaceMode && !gpsRescueIsActive) {
-            levelMode = LEVEL_MODE_R;
-        } else {
-            levelMode = LEVEL_MODE_RP;
-        }
-    } else {
-        levelMode = LEVEL_MODE_OFF;
+    if (flightModeFlags != pidRuntime.levelModeFlightModeFlags) {
+        pidUpdateLevelModeState(currentTimeUs);
     }
-
-    // Keep track of when we entered a self-level mode so that we can
-    // add a guard time before crash recovery can activate.
-    // Also reset the guard time whenever GPS Rescue is activated.
-    if (levelMode) {
-        if ((levelModeStartTimeUs == 0) || (gpsRescueIsActive && !gpsRescuePreviousState)) {
-            levelModeStartTimeUs = currentTimeUs;
-        }
-    } else {
-        levelModeStartTimeUs = 0;
-    }
-    gpsRescuePreviousState = gpsRescueIsActive;
+    const levelMode_e levelMode = pidRuntime.levelMode;
 #endif
 
     // Dynamic i component,
@@ -853,10 +882,26 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
     }
     DEBUG_SET(DEBUG_ANTI_GRAVITY, 0, lrintf(pidRuntime.itermAccelerator * 1000));
 
-    float agGain = pidRuntime.dT * pidRuntime.itermAccelerator * AG_KI;
+    // the I term, iterm relax and absolute control only run every pid_outer_denom loops
+    bool outerLoop = true;
+    if (pidRuntime.outerLoopDenom > 1) {
+        outerLoop = ++pidRuntime.outerLoopCounter >= pidRuntime.outerLoopDenom;
+        if (outerLoop) {
+            pidRuntime.outerLoopCounter = 0;
+        }
+    }
+
+    // the I term integrates over the measured gyro sample intervals since it last ran
+    pidRuntime.itermDtUs += gyro.sampleDtUs;
+    const float itermDt = pidRuntime.itermDtUs * 1e-6f;
+    if (outerLoop) {
+        pidRuntime.itermDtUs = 0.0f;
+    }
+
+    float agGain = itermDt * pidRuntime.itermAccelerator * AG_KI;
 
     // gradually scale back integration when above windup point
-    float dynCi = pidRuntime.dT;
+    float dynCi = itermDt;
     if (pidRuntime.itermWindupPointInv > 1.0f) {
         dynCi *= constrainf((1.0f - getMotorMixRange()) * pidRuntime.itermWindupPointInv, 0.0f, 1.0f);
     }
@@ -873,8 +918,8 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
         // calculated deltaT whenever another task causes the PID
         // loop execution to be delayed.
         const float delta =
-            - (gyroRateDterm[axis] - previousRawGyroRateDterm[axis]) * pidRuntime.pidFrequency / D_LPF_RAW_SCALE;
-        previousRawGyroRateDterm[axis] = gyroRateDterm[axis];
+            - (gyroRateDterm[axis] - pidRuntime.previousRawGyroRateDterm[axis]) * pidRuntime.pidFrequency / D_LPF_RAW_SCALE;
+        pidRuntime.previousRawGyroRateDterm[axis] = gyroRateDterm[axis];
 
         // Log the unfiltered D
         if (axis == FD_ROLL) {
@@ -884,9 +929,8 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
         }
 
         gyroRateDterm[axis] = pidRuntime.dtermNotchApplyFn((filter_t *) &pidRuntime.dtermNotch[axis], gyroRateDterm[axis]);
-        gyroRateDterm[axis] = pidRuntime.dtermLowpassApplyFn((filter_t *) &pidRuntime.dtermLowpass[axis], gyroRateDterm[axis]);
-        gyroRateDterm[axis] = pidRuntime.dtermLowpass2ApplyFn((filter_t *) &pidRuntime.dtermLowpass2[axis], gyroRateDterm[axis]);
     }
+    filterCascade3Apply(&pidRuntime.dtermLowpass, gyroRateDterm);
 
     rotateItermAndAxisError();
 
@@ -896,12 +940,19 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
 
 #ifdef USE_INTERPOLATED_SP
     bool newRcFrame = false;
-    if (lastFrameNumber != getRcFrameNumber()) {
-        lastFrameNumber = getRcFrameNumber();
+    if (pidRuntime.lastRcFrameNumber != getRcFrameNumber()) {
+        pidRuntime.lastRcFrameNumber = getRcFrameNumber();
         newRcFrame = true;
     }
 #endif
 
+#if defined(USE_ACC)
+    const bool crashRecoveryActive = updateCrashRecovery(pidProfile->crash_recovery, angleTrim, currentTimeUs);
+    float crashDelta[XYZ_AXIS_COUNT];
+    float crashErrorRate[XYZ_AXIS_COUNT];
+    uint8_t crashAxisMask = 0;
+#endif
+
     // ----------PID controller----------
     for (int axis = FD_ROLL; axis <= FD_YAW; ++axis) {
 
@@ -958,9 +1009,9 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
         const float gyroRate = gyro.gyroADCf[axis]; // Process variable from gyro output in deg/sec
         float errorRate = currentPidSetpoint - gyroRate; // r - y
 #if defined(USE_ACC)
-        handleCrashRecovery(
-            pidProfile->crash_recovery, angleTrim, axis, currentTimeUs, gyroRate,
-            &currentPidSetpoint, &errorRate);
+        if (crashRecoveryActive) {
+            applyCrashRecovery(angleTrim, axis, gyroRate, &currentPidSetpoint, &errorRate);
+        }
 #endif
 
         const float previousIterm = pidData[axis].I;
@@ -971,12 +1022,22 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
 
 #if defined(USE_ITERM_RELAX)
         if (!launchControlActive && !pidRuntime.inCrashRecoveryMode) {
-            applyItermRelax(axis, previousIterm, gyroRate, &itermErrorRate, &currentPidSetpoint);
+            if (outerLoop) {
+                applyItermRelax(axis, previousIterm, gyroRate, &itermErrorRate, &currentPidSetpoint);
+#ifdef USE_ABSOLUTE_CONTROL
+            } else {
+                // hold the absolute control correction until the next outer loop
+                currentPidSetpoint += pidRuntime.outerSetpointCorrection[axis];
+#endif
+            }
             errorRate = currentPidSetpoint - gyroRate;
         }
 #endif
 #ifdef USE_ABSOLUTE_CONTROL
         float setpointCorrection = currentPidSetpoint - uncorrectedSetpoint;
+        if (outerLoop) {
+            pidRuntime.outerSetpointCorrection[axis] = setpointCorrection;
+        }
 #endif
 
         // --------low-level gyro-based PID based on 2DOF PID controller. ----------
@@ -990,21 +1051,23 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
         }
 
         // -----calculate I component
-        float Ki;
-        float axisDynCi;
+        if (outerLoop) {
+            float Ki;
+            float axisDynCi;
 #ifdef USE_LAUNCH_CONTROL
-        // if launch control is active override the iterm gains and apply iterm windup protection to all axes
-        if (launchControlActive) {
-            Ki = pidRuntime.launchControlKi;
-            axisDynCi = dynCi;
-        } else
+            // if launch control is active override the iterm gains and apply iterm windup protection to all axes
+            if (launchControlActive) {
+                Ki = pidRuntime.launchControlKi;
+                axisDynCi = dynCi;
+            } else
 #endif
-        {
-            Ki = pidRuntime.pidCoefficient[axis].Ki;
-            axisDynCi = (axis == FD_YAW) ? dynCi : pidRuntime.dT; // only apply windup protection to yaw
-        }
+            {
+                Ki = pidRuntime.pidCoefficient[axis].Ki;
+                axisDynCi = (axis == FD_YAW) ? dynCi : itermDt; // only apply windup protection to yaw
+            }
 
-        pidData[axis].I = constrainf(previousIterm + (Ki * axisDynCi + agGain) * itermErrorRate, -pidRuntime.itermLimit, pidRuntime.itermLimit);
+            pidData[axis].I = constrainf(previousIterm + (Ki * axisDynCi + agGain) * itermErrorRate, -pidRuntime.itermLimit, pidRuntime.itermLimit);
+        }
 
         // -----calculate pidSetpointDelta
         float pidSetpointDelta = 0;
@@ -1034,13 +1097,13 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
             // calculated deltaT whenever another task causes the PID
             // loop execution to be delayed.
             const float delta =
-                - (gyroRateDterm[axis] - previousGyroRateDterm[axis]) * pidRuntime.pidFrequency;
+                - (gyroRateDterm[axis] - pidRuntime.previousGyroRateDterm[axis]) * pidRuntime.pidFrequency;
             float preTpaData = pidRuntime.pidCoefficient[axis].Kd * delta;
 
 #if defined(USE_ACC)
-            if (cmpTimeUs(currentTimeUs, levelModeStartTimeUs) > CRASH_RECOVERY_DETECTION_DELAY_US) {
-                detectAndSetCrashRecovery(pidProfile->crash_recovery, axis, currentTimeUs, delta, errorRate);
-            }
+            crashDelta[axis] = delta;
+            crashErrorRate[axis] = errorRate;
+            crashAxisMask |= BIT(axis);
 #endif
 
 #if defined(USE_D_MIN)
@@ -1085,7 +1148,7 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
             }
         }
 
-        previousGyroRateDterm[axis] = gyroRateDterm[axis];
+        pidRuntime.previousGyroRateDterm[axis] = gyroRateDterm[axis];
 
         // -----calculate feedforward component
 #ifdef USE_ABSOLUTE_CONTROL
@@ -1168,6 +1231,12 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
         }
     }
 
+#if defined(USE_ACC)
+    if (cmpTimeUs(currentTimeUs, pidRuntime.levelModeStartTimeUs) > CRASH_RECOVERY_DETECTION_DELAY_US) {
+        detectAndSetCrashRecovery(pidProfile->crash_recovery, crashAxisMask, currentTimeUs, crashDelta, crashErrorRate);
+    }
+#endif
+
     // Disable PID control if at zero throttle or if gyro overflow detected
     // This may look very innefficient, but it is done on purpose to always show real CPU usage as in flight
     if (!pidRuntime.pidStabilisationEnabled || gyroOverflowDetected()) {
@@ -1197,6 +1266,7 @@ void pidSetAcroTrainerState(bool newState)
             pidAcroTrainerInit();
         }
         pidRuntime.acroTrainerActive = newState;
+        accSetRequiredRate(ACC_CONSUMER_ACRO_TRAINER, newState ? ACC_RATE_FULL : 0);
     }
 }
 #endif // USE_ACRO_TRAINER
@@ -1219,21 +1289,24 @@ bool pidAntiGravityEnabled(void)
 void dynLpfDTermUpdate(float throttle)
 {
     unsigned int cutoffFreq;
-    if (pidRuntime.dynLpfFilter != DYN_LPF_NONE) {
+    if (pidRuntime.dynLpfFilter != DYN_LPF_NONE && pidRuntime.dtermLowpass1Section >= 0) {
         if (pidRuntime.dynLpfCurveExpo > 0) {
             cutoffFreq = dynLpfCutoffFreq(throttle, pidRuntime.dynLpfMin, pidRuntime.dynLpfMax, pidRuntime.dynLpfCurveExpo);
         } else {
             cutoffFreq = fmax(dynThrottle(throttle) * pidRuntime.dynLpfMax, pidRuntime.dynLpfMin);
         }
 
-         if (pidRuntime.dynLpfFilter == DYN_LPF_PT1) {
-            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-                pt1FilterUpdateCutoff(&pidRuntime.dtermLowpass[axis].pt1Filter, pt1FilterGain(cutoffFreq, pidRuntime.dT));
-            }
+        // several throttle steps map to the same cutoff, especially where it is clamped to the min
+        if (cutoffFreq == pidRuntime.dynLpfPreviousCutoff) {
+            return;
+        }
+        pidRuntime.dynLpfPreviousCutoff = cutoffFreq;
+
+        if (pidRuntime.dynLpfFilter == DYN_LPF_PT1) {
+            const float gain = pt1FilterGain(cutoffFreq, pidRuntime.dT);
+            filterCascade3UpdatePt1(&pidRuntime.dtermLowpass, pidRuntime.dtermLowpass1Section, gain);
         } else if (pidRuntime.dynLpfFilter == DYN_LPF_BIQUAD) {
-            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-                biquadFilterUpdateLPF(&pidRuntime.dtermLowpass[axis].biquadFilter, cutoffFreq, targetPidLooptime);
-            }
+            filterCascade3UpdateBiquadLPF(&pidRuntime.dtermLowpass, pidRuntime.dtermLowpass1Section, cutoffFreq, targetPidLooptime);
         }
     }
 }
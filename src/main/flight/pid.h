@@ -200,6 +200,8 @@ typedef struct pidProfile_s {
     uint8_t dyn_lpf_curve_expo;             // set the curve for dynamic dterm lowpass filter
     uint8_t level_race_mode;                // NFE race mode - when true pitch setpoint calcualtion is gyro based in level mode
     uint8_t vbat_sag_compensation;          // Reduce motor output by this percentage of the maximum compensation amount
+    uint8_t motor_lag_comp;                 // Boost motor output by this percentage of the difference between commanded and measured motor speed
+    uint8_t motor_lag_comp_limit;           // Max motor lag correction (percent of motor range)
 } pidProfile_t;
 
 PG_DECLARE_ARRAY(pidProfile_t, PID_PROFILE_COUNT, pidProfiles);
@@ -209,6 +211,7 @@ typedef struct pidConfig_s {
     uint8_t runaway_takeoff_prevention;          // off, on - enables pidsum runaway disarm logic
     uint16_t runaway_takeoff_deactivate_delay;   // delay in ms for "in-flight" conditions before deactivation (successful flight)
     uint8_t runaway_takeoff_deactivate_throttle; // minimum throttle percent required during deactivation phase
+    uint8_t pid_outer_denom;                // Processing denominator for the I term, iterm relax and absolute control vs the PID loop
 } pidConfig_t;
 
 PG_DECLARE(pidConfig_t, pidConfig);
@@ -225,11 +228,6 @@ typedef struct pidAxisData_s {
     float Sum;
 } pidAxisData_t;
 
-typedef union dtermLowpass_u {
-    pt1Filter_t pt1Filter;
-    biquadFilter_t biquadFilter;
-} dtermLowpass_t;
-
 typedef struct pidCoefficient_s {
     float Kp;
     float Ki;
@@ -237,17 +235,53 @@ typedef struct pidCoefficient_s {
     float Kf;
 } pidCoefficient_t;
 
+#if defined(USE_ITERM_RELAX) || defined(USE_RC_SMOOTHING_FILTER)
+// The small filters on the setpoint path of one axis, kept together so each pass of the axis loop works on one block
+typedef struct pidAxisFilters_s {
+#ifdef USE_ITERM_RELAX
+    pt1Filter_t windupLpf;
+#endif
+#ifdef USE_ABSOLUTE_CONTROL
+    pt1Filter_t acLpf;
+#endif
+#ifdef USE_RC_SMOOTHING_FILTER
+    pt1Filter_t setpointDerivativePt1;
+    biquadFilter_t setpointDerivativeBiquad;
+#endif
+} pidAxisFilters_t;
+#endif
+
+#define MAX_PID_OUTER_DENOM 8
+
 typedef struct pidRuntime_s {
     float dT;
     float pidFrequency;
+    uint8_t outerLoopDenom;
+    uint8_t outerLoopCounter;
+    float outerDT;              // dT of the I term, iterm relax and absolute control
+    float itermDtUs;            // measured time since the I term last ran
+    float outerPidFrequency;
     bool pidStabilisationEnabled;
     float previousPidSetpoint[XYZ_AXIS_COUNT];
+    float previousGyroRateDterm[XYZ_AXIS_COUNT];
+    float previousRawGyroRateDterm[XYZ_AXIS_COUNT];
+    float previousAccelerationLimitSetpoint[XYZ_AXIS_COUNT];
+#ifdef USE_ACC
+    uint32_t levelModeFlightModeFlags;  // flightModeFlags the level mode state was calculated for
+    uint8_t levelMode;
+    bool gpsRescuePreviousState;
+    timeUs_t levelModeStartTimeUs;
+#endif
+#ifdef USE_INTERPOLATED_SP
+    uint32_t lastRcFrameNumber;
+#endif
+#if defined(USE_ITERM_RELAX) || defined(USE_RC_SMOOTHING_FILTER)
+    pidAxisFilters_t axisFilter[XYZ_AXIS_COUNT];
+#endif
     filterApplyFnPtr dtermNotchApplyFn;
     biquadFilter_t dtermNotch[XYZ_AXIS_COUNT];
-    filterApplyFnPtr dtermLowpassApplyFn;
-    dtermLowpass_t dtermLowpass[XYZ_AXIS_COUNT];
-    filterApplyFnPtr dtermLowpass2ApplyFn;
-    dtermLowpass_t dtermLowpass2[XYZ_AXIS_COUNT];
+    filterCascade3_t dtermLowpass;     // D term lowpass 1 and 2 as the sections of one cascade
+    int8_t dtermLowpass1Section;       // section of the D term lowpass 1, -1 when it is off
     filterApplyFnPtr ptermYawLowpassApplyFn;
     pt1Filter_t ptermYawLowpass;
     bool antiGravityEnabled;
@@ -286,7 +320,6 @@ typedef struct pidRuntime_s {
     bool levelRaceMode;
 
 #ifdef USE_ITERM_RELAX
-    pt1Filter_t windupLpf[XYZ_AXIS_COUNT];
     uint8_t itermRelax;
     uint8_t itermRelaxType;
     uint8_t itermRelaxCutoff;
@@ -297,8 +330,8 @@ typedef struct pidRuntime_s {
     float acGain;
     float acLimit;
     float acErrorLimit;
-    pt1Filter_t acLpf[XYZ_AXIS_COUNT];
     float oldSetpointCorrection[XYZ_AXIS_COUNT];
+    float outerSetpointCorrection[XYZ_AXIS_COUNT];  // held between outer loop iterations
 #endif
 
 #ifdef USE_D_MIN
@@ -315,8 +348,6 @@ typedef struct pidRuntime_s {
 #endif
 
 #ifdef USE_RC_SMOOTHING_FILTER
-    pt1Filter_t setpointDerivativePt1[XYZ_AXIS_COUNT];
-    biquadFilter_t setpointDerivativeBiquad[XYZ_AXIS_COUNT];
     bool setpointDerivativeLpfInitialized;
     uint8_t rcSmoothingDebugAxis;
     uint8_t rcSmoothingFilterType;
@@ -336,6 +367,7 @@ typedef struct pidRuntime_s {
     uint16_t dynLpfMin;
     uint16_t dynLpfMax;
     uint8_t dynLpfCurveExpo;
+    uint16_t dynLpfPreviousCutoff;
 #endif
 
 #ifdef USE_LAUNCH_CONTROL
@@ -352,6 +384,8 @@ typedef struct pidRuntime_s {
 #ifdef USE_THRUST_LINEARIZATION
     float thrustLinearization;
     float throttleCompensateAmount;
+    float thrustLinearizationThrottle;      // input of the last compensation
+    float thrustLinearizationCompensated;
 #endif
 
 #ifdef USE_AIRMODE_LPF
@@ -41,6 +41,7 @@
 #include "flight/pid.h"
 #include "flight/rpm_filter.h"
 
+#include "sensors/acceleration.h"
 #include "sensors/gyro.h"
 #include "sensors/sensors.h"
 
@@ -61,20 +62,54 @@ static void pidSetTargetLooptime(uint32_t pidLooptime)
     targetPidLooptime = pidLooptime;
     pidRuntime.dT = targetPidLooptime * 1e-6f;
     pidRuntime.pidFrequency = 1.0f / pidRuntime.dT;
+    pidRuntime.outerLoopDenom = constrain(pidConfig()->pid_outer_denom, 1, MAX_PID_OUTER_DENOM);
+    pidRuntime.outerLoopCounter = 0;
+    pidRuntime.itermDtUs = 0.0f;
+    pidRuntime.outerDT = pidRuntime.dT * pidRuntime.outerLoopDenom;
+    pidRuntime.outerPidFrequency = 1.0f / pidRuntime.outerDT;
 #ifdef USE_DSHOT
     dshotSetPidLoopTime(targetPidLooptime);
 #endif
 }
 
-void pidInitFilters(const pidProfile_t *pidProfile)
+// When the profile is changed while running, zeroing the filter state makes the D term jump,
+// so filters that stay active only get their coefficients replaced.
+static void pidPt1FilterInit(pt1Filter_t *filter, float k, bool keepState)
+{
+    if (keepState) {
+        pt1FilterUpdateCutoff(filter, k);
+    } else {
+        pt1FilterInit(filter, k);
+    }
+}
+
+static void pidBiquadFilterInit(biquadFilter_t *filter, float filterFreq, float Q, biquadFilterType_e filterType, bool keepState)
+{
+    if (keepState) {
+        biquadFilterUpdate(filter, filterFreq, targetPidLooptime, Q, filterType);
+    } else {
+        biquadFilterInit(filter, filterFreq, targetPidLooptime, Q, filterType);
+    }
+}
+
+static void pidBiquadFilterInitLPF(biquadFilter_t *filter, float filterFreq, bool keepState)
+{
+    if (keepState) {
+        biquadFilterUpdateLPF(filter, filterFreq, targetPidLooptime);
+    } else {
+        biquadFilterInitLPF(filter, filterFreq, targetPidLooptime);
+    }
+}
+
+static void pidInitFiltersState(const pidProfile_t *pidProfile, bool keepState)
 {
     STATIC_ASSERT(FD_YAW == 2, FD_YAW_incorrect); // ensure yaw axis is 2
 
     if (targetPidLooptime == 0) {
         // no looptime set, so set all the filters to null
         pidRuntime.dtermNotchApplyFn = nullFilterApply;
-        pidRuntime.dtermLowpassApplyFn = nullFilterApply;
-        pidRuntime.dtermLowpass2ApplyFn = nullFilterApply;
+        filterCascade3Init(&pidRuntime.dtermLowpass);
+        pidRuntime.dtermLowpass1Section = -1;
         pidRuntime.ptermYawLowpassApplyFn = nullFilterApply;
         return;
     }
@@ -93,10 +128,11 @@ void pidInitFilters(const pidProfile_t *pidProfile)
     }
 
     if (dTermNotchHz != 0 && pidProfile->dterm_notch_cutoff != 0) {
+        const bool keepNotchState = keepState && pidRuntime.dtermNotchApplyFn == (filterApplyFnPtr)biquadFilterApply;
         pidRuntime.dtermNotchApplyFn = (filterApplyFnPtr)biquadFilterApply;
         const float notchQ = filterGetNotchQ(dTermNotchHz, pidProfile->dterm_notch_cutoff);
         for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-            biquadFilterInit(&pidRuntime.dtermNotch[axis], dTermNotchHz, targetPidLooptime, notchQ, FILTER_NOTCH);
+            pidBiquadFilterInit(&pidRuntime.dtermNotch[axis], dTermNotchHz, notchQ, FILTER_NOTCH, keepNotchState);
         }
     } else {
         pidRuntime.dtermNotchApplyFn = nullFilterApply;
@@ -111,76 +147,64 @@ void pidInitFilters(const pidProfile_t *pidProfile)
     }
 #endif
 
+    // both D term lowpasses run as one cascade, the state is kept as long as the number of stages stays the same
+    const filterCascade3_t previousDtermLowpass = pidRuntime.dtermLowpass;
+    filterCascade3Init(&pidRuntime.dtermLowpass);
+    pidRuntime.dtermLowpass1Section = -1;
+
     if (dterm_lowpass_hz > 0 && dterm_lowpass_hz < pidFrequencyNyquist) {
         switch (pidProfile->dterm_filter_type) {
         case FILTER_PT1:
-            pidRuntime.dtermLowpassApplyFn = (filterApplyFnPtr)pt1FilterApply;
-            for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-                pt1FilterInit(&pidRuntime.dtermLowpass[axis].pt1Filter, pt1FilterGain(dterm_lowpass_hz, pidRuntime.dT));
-            }
+            pidRuntime.dtermLowpass1Section = filterCascade3AddPt1(&pidRuntime.dtermLowpass, pt1FilterGain(dterm_lowpass_hz, pidRuntime.dT));
             break;
         case FILTER_BIQUAD:
-#ifdef USE_DYN_LPF
-            pidRuntime.dtermLowpassApplyFn = (filterApplyFnPtr)biquadFilterApplyDF1;
-#else
-            pidRuntime.dtermLowpassApplyFn = (filterApplyFnPtr)biquadFilterApply;
-#endif
-            for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-                biquadFilterInitLPF(&pidRuntime.dtermLowpass[axis].biquadFilter, dterm_lowpass_hz, targetPidLooptime);
-            }
+            pidRuntime.dtermLowpass1Section = filterCascade3AddBiquadLPF(&pidRuntime.dtermLowpass, dterm_lowpass_hz, targetPidLooptime);
             break;
         default:
-            pidRuntime.dtermLowpassApplyFn = nullFilterApply;
             break;
         }
-    } else {
-        pidRuntime.dtermLowpassApplyFn = nullFilterApply;
     }
 
     //2nd Dterm Lowpass Filter
-    if (pidProfile->dterm_lowpass2_hz == 0 || pidProfile->dterm_lowpass2_hz > pidFrequencyNyquist) {
-        pidRuntime.dtermLowpass2ApplyFn = nullFilterApply;
-    } else {
+    if (pidProfile->dterm_lowpass2_hz > 0 && pidProfile->dterm_lowpass2_hz <= pidFrequencyNyquist) {
         switch (pidProfile->dterm_filter2_type) {
         case FILTER_PT1:
-            pidRuntime.dtermLowpass2ApplyFn = (filterApplyFnPtr)pt1FilterApply;
-            for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-                pt1FilterInit(&pidRuntime.dtermLowpass2[axis].pt1Filter, pt1FilterGain(pidProfile->dterm_lowpass2_hz, pidRuntime.dT));
-            }
+            filterCascade3AddPt1(&pidRuntime.dtermLowpass, pt1FilterGain(pidProfile->dterm_lowpass2_hz, pidRuntime.dT));
             break;
         case FILTER_BIQUAD:
-            pidRuntime.dtermLowpass2ApplyFn = (filterApplyFnPtr)biquadFilterApply;
-            for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-                biquadFilterInitLPF(&pidRuntime.dtermLowpass2[axis].biquadFilter, pidProfile->dterm_lowpass2_hz, targetPidLooptime);
-            }
+            filterCascade3AddBiquadLPF(&pidRuntime.dtermLowpass, pidProfile->dterm_lowpass2_hz, targetPidLooptime);
             break;
         default:
-            pidRuntime.dtermLowpass2ApplyFn = nullFilterApply;
             break;
         }
     }
 
+    if (keepState) {
+        filterCascade3CopyState(&pidRuntime.dtermLowpass, &previousDtermLowpass);
+    }
+
     if (pidProfile->yaw_lowpass_hz == 0 || pidProfile->yaw_lowpass_hz > pidFrequencyNyquist) {
         pidRuntime.ptermYawLowpassApplyFn = nullFilterApply;
     } else {
+        const bool keepYawState = keepState && pidRuntime.ptermYawLowpassApplyFn == (filterApplyFnPtr)pt1FilterApply;
         pidRuntime.ptermYawLowpassApplyFn = (filterApplyFnPtr)pt1FilterApply;
-        pt1FilterInit(&pidRuntime.ptermYawLowpass, pt1FilterGain(pidProfile->yaw_lowpass_hz, pidRuntime.dT));
+        pidPt1FilterInit(&pidRuntime.ptermYawLowpass, pt1FilterGain(pidProfile->yaw_lowpass_hz, pidRuntime.dT), keepYawState);
     }
 
 #if defined(USE_THROTTLE_BOOST)
-    pt1FilterInit(&throttleLpf, pt1FilterGain(pidProfile->throttle_boost_cutoff, pidRuntime.dT));
+    pidPt1FilterInit(&throttleLpf, pt1FilterGain(pidProfile->throttle_boost_cutoff, pidRuntime.dT), keepState);
 #endif
 #if defined(USE_ITERM_RELAX)
     if (pidRuntime.itermRelax) {
         for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
-            pt1FilterInit(&pidRuntime.windupLpf[i], pt1FilterGain(pidRuntime.itermRelaxCutoff, pidRuntime.dT));
+            pidPt1FilterInit(&pidRuntime.axisFilter[i].windupLpf, pt1FilterGain(pidRuntime.itermRelaxCutoff, pidRuntime.outerDT), keepState);
         }
     }
 #endif
 #if defined(USE_ABSOLUTE_CONTROL)
     if (pidRuntime.itermRelax) {
         for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
-            pt1FilterInit(&pidRuntime.acLpf[i], pt1FilterGain(pidRuntime.acCutoff, pidRuntime.dT));
+            pidPt1FilterInit(&pidRuntime.axisFilter[i].acLpf, pt1FilterGain(pidRuntime.acCutoff, pidRuntime.outerDT), keepState);
         }
     }
 #endif
@@ -191,23 +215,28 @@ void pidInitFilters(const pidProfile_t *pidProfile)
     // in-flight adjustments and transition from 0 to > 0 in flight the feature
     // won't work because the filter wasn't initialized.
     for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-        biquadFilterInitLPF(&pidRuntime.dMinRange[axis], D_MIN_RANGE_HZ, targetPidLooptime);
-        pt1FilterInit(&pidRuntime.dMinLowpass[axis], pt1FilterGain(D_MIN_LOWPASS_HZ, pidRuntime.dT));
+        pidBiquadFilterInitLPF(&pidRuntime.dMinRange[axis], D_MIN_RANGE_HZ, keepState);
+        pidPt1FilterInit(&pidRuntime.dMinLowpass[axis], pt1FilterGain(D_MIN_LOWPASS_HZ, pidRuntime.dT), keepState);
      }
 #endif
 #if defined(USE_AIRMODE_LPF)
     if (pidProfile->transient_throttle_limit) {
-        pt1FilterInit(&pidRuntime.airmodeThrottleLpf1, pt1FilterGain(7.0f, pidRuntime.dT));
-        pt1FilterInit(&pidRuntime.airmodeThrottleLpf2, pt1FilterGain(20.0f, pidRuntime.dT));
+        pidPt1FilterInit(&pidRuntime.airmodeThrottleLpf1, pt1FilterGain(7.0f, pidRuntime.dT), keepState);
+        pidPt1FilterInit(&pidRuntime.airmodeThrottleLpf2, pt1FilterGain(20.0f, pidRuntime.dT), keepState);
     }
 #endif
 
-    pt1FilterInit(&pidRuntime.antiGravityThrottleLpf, pt1FilterGain(ANTI_GRAVITY_THROTTLE_FILTER_CUTOFF, pidRuntime.dT));
-    pt1FilterInit(&pidRuntime.antiGravitySmoothLpf, pt1FilterGain(ANTI_GRAVITY_SMOOTH_FILTER_CUTOFF, pidRuntime.dT));
+    pidPt1FilterInit(&pidRuntime.antiGravityThrottleLpf, pt1FilterGain(ANTI_GRAVITY_THROTTLE_FILTER_CUTOFF, pidRuntime.dT), keepState);
+    pidPt1FilterInit(&pidRuntime.antiGravitySmoothLpf, pt1FilterGain(ANTI_GRAVITY_SMOOTH_FILTER_CUTOFF, pidRuntime.dT), keepState);
 
     pidRuntime.ffBoostFactor = (float)pidProfile->ff_boost / 10.0f;
 }
 
+void pidInitFilters(const pidProfile_t *pidProfile)
+{
+    pidInitFiltersState(pidProfile, false);
+}
+
 void pidInit(const pidProfile_t *pidProfile)
 {
     pidSetTargetLooptime(gyro.targetLooptime); // Initialize pid looptime
@@ -218,6 +247,14 @@ void pidInit(const pidProfile_t *pidProfile)
 #endif
 }
 
+// Switches to another profile without resetting the running filters, the looptime and
+// the RPM filter do not depend on the profile.
+void pidChangeProfile(const pidProfile_t *pidProfile)
+{
+    pidInitFiltersState(pidProfile, true);
+    pidInitConfig(pidProfile);
+}
+
 #ifdef USE_RC_SMOOTHING_FILTER
 void pidInitSetpointDerivativeLpf(uint16_t filterCutoff, uint8_t debugAxis, uint8_t filterType)
 {
@@ -228,10 +265,10 @@ void pidInitSetpointDerivativeLpf(uint16_t filterCutoff, uint8_t debugAxis, uint
         for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
             switch (pidRuntime.rcSmoothingFilterType) {
                 case RC_SMOOTHING_DERIVATIVE_PT1:
-                    pt1FilterInit(&pidRuntime.setpointDerivativePt1[axis], pt1FilterGain(filterCutoff, pidRuntime.dT));
+                    pt1FilterInit(&pidRuntime.axisFilter[axis].setpointDerivativePt1, pt1FilterGain(filterCutoff, pidRuntime.dT));
                     break;
                 case RC_SMOOTHING_DERIVATIVE_BIQUAD:
-                    biquadFilterInitLPF(&pidRuntime.setpointDerivativeBiquad[axis], filterCutoff, targetPidLooptime);
+                    biquadFilterInitLPF(&pidRuntime.axisFilter[axis].setpointDerivativeBiquad, filterCutoff, targetPidLooptime);
                     break;
             }
         }
@@ -244,10 +281,10 @@ void pidUpdateSetpointDerivativeLpf(uint16_t filterCutoff)
         for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
             switch (pidRuntime.rcSmoothingFilterType) {
                 case RC_SMOOTHING_DERIVATIVE_PT1:
-                    pt1FilterUpdateCutoff(&pidRuntime.setpointDerivativePt1[axis], pt1FilterGain(filterCutoff, pidRuntime.dT));
+                    pt1FilterUpdateCutoff(&pidRuntime.axisFilter[axis].setpointDerivativePt1, pt1FilterGain(filterCutoff, pidRuntime.dT));
                     break;
                 case RC_SMOOTHING_DERIVATIVE_BIQUAD:
-                    biquadFilterUpdateLPF(&pidRuntime.setpointDerivativeBiquad[axis], filterCutoff, targetPidLooptime);
+                    biquadFilterUpdateLPF(&pidRuntime.axisFilter[axis].setpointDerivativeBiquad, filterCutoff, targetPidLooptime);
                     break;
             }
         }
@@ -357,6 +394,7 @@ void pidInitConfig(const pidProfile_t *pidProfile)
     pidRuntime.dynLpfMin = pidProfile->dyn_lpf_dterm_min_hz;
     pidRuntime.dynLpfMax = pidProfile->dyn_lpf_dterm_max_hz;
     pidRuntime.dynLpfCurveExpo = pidProfile->dyn_lpf_curve_expo;
+    pidRuntime.dynLpfPreviousCutoff = 0;
 #endif
 
 #ifdef USE_LAUNCH_CONTROL
@@ -377,6 +415,7 @@ void pidInitConfig(const pidProfile_t *pidProfile)
 #ifdef USE_THRUST_LINEARIZATION
     pidRuntime.thrustLinearization = pidProfile->thrustLinearization / 100.0f;
     pidRuntime.throttleCompensateAmount = pidRuntime.thrustLinearization - 0.5f * powerf(pidRuntime.thrustLinearization, 2);
+    pidRuntime.thrustLinearizationThrottle = -1.0f;
 #endif
 #if defined(USE_D_MIN)
     for (int axis = FD_ROLL; axis <= FD_YAW; ++axis) {
@@ -401,6 +440,14 @@ void pidInitConfig(const pidProfile_t *pidProfile)
 #endif
 
     pidRuntime.levelRaceMode = pidProfile->level_race_mode;
+#ifdef USE_ACC
+    // recalculate the level mode state on the next PID loop
+    pidRuntime.levelModeFlightModeFlags = UINT32_MAX;
+
+    // crash recovery levels the craft from the attitude, so the acc must already be at full rate when a crash is detected
+    const bool crashRecoveryLevels = pidProfile->crash_recovery == PID_CRASH_RECOVERY_ON || pidProfile->crash_recovery == PID_CRASH_RECOVERY_BEEP;
+    accSetRequiredRate(ACC_CONSUMER_CRASH_RECOVERY, crashRecoveryLevels ? ACC_RATE_FULL : 0);
+#endif
 }
 
 void pidCopyProfile(uint8_t dstPidProfileIndex, uint8_t srcPidProfileIndex)
@@ -21,6 +21,7 @@
 #pragma once
 
 void pidInit(const pidProfile_t *pidProfile);
+void pidChangeProfile(const pidProfile_t *pidProfile);
 void pidInitFilters(const pidProfile_t *pidProfile);
 void pidInitConfig(const pidProfile_t *pidProfile);
 void pidSetItermAccelerator(float newItermAccelerator);
@@ -38,6 +38,7 @@
 
 #include "io/gps.h"
 
+#include "sensors/acceleration.h"
 #include "sensors/sensors.h"
 #include "sensors/barometer.h"
 
@@ -50,10 +51,11 @@ typedef enum {
     GPS_ONLY
 } altSource_e;
 
-PG_REGISTER_WITH_RESET_TEMPLATE(positionConfig_t, positionConfig, PG_POSITION, 1);
+PG_REGISTER_WITH_RESET_TEMPLATE(positionConfig_t, positionConfig, PG_POSITION, 2);
 
 PG_RESET_TEMPLATE(positionConfig_t, positionConfig,
     .altSource = DEFAULT,
+    .altVelocityCf = 0,
 );
 
 static int32_t estimatedAltitudeCm = 0;                // in cm
@@ -86,6 +88,84 @@ int16_t calculateEstimatedVario(int32_t baroAlt, const uint32_t dTime) {
 #if defined(USE_BARO) || defined(USE_GPS)
 static bool altitudeOffsetSet = false;
 
+#define ALTITUDE_GRAVITY_CMSS       980.665f
+#define ALTITUDE_ESTIMATE_OMEGA     1.5f    // rad/s, the accelerometer carries the estimate above it, the measured altitude below
+
+// Third order complementary filter: the earth frame vertical acceleration is integrated at attitude task rate, and
+// each measured altitude pulls the altitude, the vertical speed and the accelerometer bias towards it. The vertical
+// speed needs no differentiation of the noisy measurement, so it is not delayed by smoothing.
+typedef struct altitudeEstimate_s {
+    float altitudeCm;
+    float velocityCmS;
+    float accBiasCmSS;
+    uint8_t source;         // measurement the estimate follows, it restarts from the measurement when that changes
+    bool predicted;         // advanced with the accelerometer since the last measurement
+} altitudeEstimate_t;
+
+enum {
+    ALTITUDE_SOURCE_NONE = 0,
+    ALTITUDE_SOURCE_GPS_BARO,
+    ALTITUDE_SOURCE_GPS,
+    ALTITUDE_SOURCE_BARO,
+    ALTITUDE_SOURCE_ABSOLUTE = 0x80,    // before the offset is set on arming
+};
+
+static altitudeEstimate_t altitudeEstimate;
+
+void predictEstimatedAltitude(const float *accBody, float dT)
+{
+    if (altitudeEstimate.source == ALTITUDE_SOURCE_NONE) {
+        return;
+    }
+
+    t_fp_vector_def accEf = { accBody[X], accBody[Y], accBody[Z] };
+    imuTransformVectorBodyToEarth(&accEf);
+
+    const float acceleration = (accEf.Z * acc.dev.acc_1G_rec - 1.0f) * ALTITUDE_GRAVITY_CMSS - altitudeEstimate.accBiasCmSS;
+    altitudeEstimate.altitudeCm += (altitudeEstimate.velocityCmS + 0.5f * acceleration * dT) * dT;
+    altitudeEstimate.velocityCmS += acceleration * dT;
+    altitudeEstimate.predicted = true;
+}
+
+static void correctEstimatedAltitude(int32_t measuredAltitudeCm, uint8_t source, float dT)
+{
+    if (source != altitudeEstimate.source) {
+        // the measurement jumps, keep the vertical speed and the bias but not the altitude
+        altitudeEstimate.altitudeCm = measuredAltitudeCm;
+        altitudeEstimate.source = source;
+        return;
+    }
+
+    const float error = measuredAltitudeCm - altitudeEstimate.altitudeCm;
+    const float omegaDt = ALTITUDE_ESTIMATE_OMEGA * MIN(dT, 0.1f);
+    altitudeEstimate.altitudeCm += 3.0f * omegaDt * error;
+    altitudeEstimate.velocityCmS += 3.0f * ALTITUDE_ESTIMATE_OMEGA * omegaDt * error;
+    altitudeEstimate.accBiasCmSS -= sq(ALTITUDE_ESTIMATE_OMEGA) * omegaDt * error;
+}
+
+#ifdef USE_GPS
+// Complementary filter: the GPS vertical speed carries the estimate between updates and the
+// measured altitude pulls it back, so climbs and descents are followed without the lag of the
+// baro noise lowpass
+static int32_t applyAltitudeVelocityCf(int32_t measuredAltitudeCm, bool active, uint32_t dTime)
+{
+    static float altitudeCm = 0.0f;
+    static bool wasActive = false;
+
+    if (!active || !wasActive) {
+        // restart from the measurement, e.g. when the altitude offset is set on arming
+        altitudeCm = measuredAltitudeCm;
+    } else {
+        const float cf = positionConfig()->altVelocityCf / 100.0f;
+        const float predictedAltitudeCm = altitudeCm + GPS_verticalSpeedInCmS * dTime * 1e-6f;
+        altitudeCm = predictedAltitudeCm * cf + measuredAltitudeCm * (1.0f - cf);
+    }
+    wasActive = active;
+
+    return lrintf(altitudeCm);
+}
+#endif
+
 void calculateEstimatedAltitude(timeUs_t currentTimeUs)
 {
     static timeUs_t previousTimeUs = 0;
@@ -145,29 +225,60 @@ void calculateEstimatedAltitude(timeUs_t currentTimeUs)
     gpsAlt -= gpsAltOffset;
 
 
+    // without accelerometer updates the measurement is used directly and the vario differentiated
+    const bool accAided = altitudeEstimate.predicted;
+    altitudeEstimate.predicted = false;
+    uint8_t source = ALTITUDE_SOURCE_NONE;
+
     if (haveGpsAlt && haveBaroAlt && positionConfig()->altSource == DEFAULT) {
         if (ARMING_FLAG(ARMED)) {
             estimatedAltitudeCm = gpsAlt * gpsTrust + baroAlt * (1 - gpsTrust);
+            source = ALTITUDE_SOURCE_GPS_BARO;
         } else {
             estimatedAltitudeCm = gpsAlt; //absolute altitude is shown before arming, ignore baro
+            source = ALTITUDE_SOURCE_GPS;
         }
 #ifdef USE_VARIO
         // baro is a better source for vario, so ignore gpsVertSpeed
-        estimatedVario = calculateEstimatedVario(baroAlt, dTime);
+        if (!accAided) {
+            estimatedVario = calculateEstimatedVario(baroAlt, dTime);
+        }
 #endif
     } else if (haveGpsAlt && (positionConfig()->altSource == GPS_ONLY || positionConfig()->altSource == DEFAULT )) {
         estimatedAltitudeCm = gpsAlt;
+        source = ALTITUDE_SOURCE_GPS;
 #if defined(USE_VARIO) && defined(USE_GPS)
         estimatedVario = gpsVertSpeed;
 #endif
     } else if (haveBaroAlt && (positionConfig()->altSource == BARO_ONLY || positionConfig()->altSource == DEFAULT)) {
         estimatedAltitudeCm = baroAlt;
+        source = ALTITUDE_SOURCE_BARO;
 #ifdef USE_VARIO
-        estimatedVario = calculateEstimatedVario(baroAlt, dTime);
+        if (!accAided) {
+            estimatedVario = calculateEstimatedVario(baroAlt, dTime);
+        }
 #endif
     }
 
-	
+    if (source != ALTITUDE_SOURCE_NONE) {
+        if (!altitudeOffsetSet) {
+            source |= ALTITUDE_SOURCE_ABSOLUTE;
+        }
+        correctEstimatedAltitude(estimatedAltitudeCm, source, dTime * 1e-6f);
+    } else {
+        altitudeEstimate.source = ALTITUDE_SOURCE_NONE;
+    }
+
+    if (accAided && source != ALTITUDE_SOURCE_NONE) {
+        estimatedAltitudeCm = lrintf(altitudeEstimate.altitudeCm);
+#ifdef USE_VARIO
+        estimatedVario = constrain(lrintf(altitudeEstimate.velocityCmS), SHRT_MIN, SHRT_MAX);
+#endif
+    } else {
+#ifdef USE_GPS
+        estimatedAltitudeCm = applyAltitudeVelocityCf(estimatedAltitudeCm, positionConfig()->altVelocityCf && haveGpsAlt && ARMING_FLAG(ARMED), dTime);
+#endif
+    }
 
     DEBUG_SET(DEBUG_ALTITUDE, 0, (int32_t)(100 * gpsTrust));
     DEBUG_SET(DEBUG_ALTITUDE, 1, baroAlt);
@@ -24,11 +24,13 @@
 
 typedef struct positionConfig_s {
     uint8_t altSource;
+    uint8_t altVelocityCf;      // percent of the estimate carried forward with the GPS vertical speed, 0 to use the measurement only
 } positionConfig_t;
 
 PG_DECLARE(positionConfig_t, positionConfig);
 
 bool isAltitudeOffset(void);
 void calculateEstimatedAltitude(timeUs_t currentTimeUs);
+void predictEstimatedAltitude(const float *accBody, float dT);
 int32_t getEstimatedAltitudeCm(void);
 int16_t getEstimatedVario(void);
@@ -20,7 +20,9 @@
 
 
 #include <math.h>
+#include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -44,23 +46,39 @@
 
 #include "rpm_filter.h"
 
-#define RPM_FILTER_MAXHARMONICS 3
 #define SECONDS_PER_MINUTE      60.0f
 #define ERPM_PER_LSB            100.0f
 #define MIN_UPDATE_T            0.001f
+#define MIN_RELATIVE_CHANGE     0.002f  // budgeted mode, motors that changed frequency by less than this are not updated
 
 
 static pt1Filter_t rpmFilters[MAX_SUPPORTED_MOTORS];
 
+typedef enum {
+    RPM_NOTCH_OFF = 0,
+    RPM_NOTCH_START,    // turned on, the delay line is primed with the next sample
+    RPM_NOTCH_ON,
+} rpmNotchState_e;
+
+// A notch for one motor harmonic, the coefficients are shared by all axes.
+// For a notch b0 == b2 and b1 == a1, so only three coefficients need to be kept.
+typedef struct rpmNotch_s
+{
+    float b0, a1, a2;
+    float x1[XYZ_AXIS_COUNT], x2[XYZ_AXIS_COUNT];
+    float y1[XYZ_AXIS_COUNT], y2[XYZ_AXIS_COUNT];
+    uint8_t state;
+} rpmNotch_t;
+
 typedef struct rpmNotchFilter_s
 {
     uint8_t harmonics;
     float   minHz;
     float   maxHz;
     float   q;
-    float   loopTime;
 
-    biquadFilter_t notch[XYZ_AXIS_COUNT][MAX_SUPPORTED_MOTORS][RPM_FILTER_MAXHARMONICS];
+    biquadNotchCache_t notchCache;
+    rpmNotch_t notch[MAX_SUPPORTED_MOTORS][RPM_FILTER_MAXHARMONICS];
 } rpmNotchFilter_t;
 
 FAST_DATA_ZERO_INIT static float   erpmToHz;
@@ -69,6 +87,8 @@ FAST_DATA_ZERO_INIT static float   minMotorFrequency;
 FAST_DATA_ZERO_INIT static uint8_t numberFilters;
 FAST_DATA_ZERO_INIT static uint8_t numberRpmNotchFilters;
 FAST_DATA_ZERO_INIT static uint8_t filterUpdatesPerIteration;
+FAST_DATA_ZERO_INIT static bool    budgeted;
+FAST_DATA_ZERO_INIT static float   notchMotorFrequency[MAX_SUPPORTED_MOTORS];  // budgeted mode, motor frequency the notches were last set for
 FAST_DATA_ZERO_INIT static float   pidLooptime;
 FAST_DATA_ZERO_INIT static rpmNotchFilter_t filters[2];
 FAST_DATA_ZERO_INIT static rpmNotchFilter_t* gyroFilter;
@@ -80,30 +100,41 @@ FAST_DATA static rpmNotchFilter_t* currentFilter = &filters[0];
 
 
 
-PG_REGISTER_WITH_RESET_FN(rpmFilterConfig_t, rpmFilterConfig, PG_RPM_FILTER_CONFIG, 4);
+PG_REGISTER_WITH_RESET_FN(rpmFilterConfig_t, rpmFilterConfig, PG_RPM_FILTER_CONFIG, 5);
 
 void pgResetFn_rpmFilterConfig(rpmFilterConfig_t *config)
 {
     config->gyro_rpm_notch_harmonics = 3;
     config->gyro_rpm_notch_min = 100;
     config->gyro_rpm_notch_q = 500;
+    config->gyro_rpm_notch_budget = false;
 
     config->rpm_lpf = 150;
 }
 
+// Motors at similar speeds and harmonics of the same motor land on the same whole Hz, so many updates come from the cache
+static FAST_CODE void rpmNotchUpdate(rpmNotchFilter_t *filter, rpmNotch_t *notch, float frequency)
+{
+    biquadNotchCoeffs_t coeffs;
+    biquadNotchCoefficients(&filter->notchCache, &frequency, &coeffs, 1);
+    notch->b0 = coeffs.b0;
+    notch->a1 = coeffs.a1;
+    notch->a2 = coeffs.a2;
+}
+
 static void rpmNotchFilterInit(rpmNotchFilter_t* filter, int harmonics, int minHz, int q, float looptime)
 {
     filter->harmonics = harmonics;
     filter->minHz = minHz;
     filter->q = q / 100.0f;
-    filter->loopTime = looptime;
+    biquadNotchCacheInit(&filter->notchCache, looptime, filter->q);
 
-    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-        for (int motor = 0; motor < getMotorCount(); motor++) {
-            for (int i = 0; i < harmonics; i++) {
-                biquadFilterInit(
-                    &filter->notch[axis][motor][i], minHz * i, looptime, filter->q, FILTER_NOTCH);
-            }
+    memset(filter->notch, 0, sizeof(filter->notch));
+    for (int motor = 0; motor < getMotorCount(); motor++) {
+        for (int i = 0; i < harmonics; i++) {
+            rpmNotchUpdate(filter, &filter->notch[motor][i], minHz * i);
+            // in budgeted mode notches are only turned on once their motor is spinning
+            filter->notch[motor][i].state = budgeted ? RPM_NOTCH_OFF : RPM_NOTCH_ON;
         }
     }
 }
@@ -114,6 +145,8 @@ void rpmFilterInit(const rpmFilterConfig_t *config)
     currentMotor = currentHarmonic = currentFilterNumber = 0;
 
     numberRpmNotchFilters = 0;
+    budgeted = config->gyro_rpm_notch_budget;
+    memset(notchMotorFrequency, 0, sizeof(notchMotorFrequency));
     if (!motorConfig()->dev.useDshotTelemetry) {
         gyroFilter = NULL;
         return;
@@ -122,7 +155,7 @@ void rpmFilterInit(const rpmFilterConfig_t *config)
     pidLooptime = gyro.targetLooptime;
     if (config->gyro_rpm_notch_harmonics) {
         gyroFilter = &filters[numberRpmNotchFilters++];
-        rpmNotchFilterInit(gyroFilter, config->gyro_rpm_notch_harmonics,
+        rpmNotchFilterInit(gyroFilter, MIN(config->gyro_rpm_notch_harmonics, RPM_FILTER_MAXHARMONICS),
                            config->gyro_rpm_notch_min, config->gyro_rpm_notch_q, gyro.targetLooptime);
         // don't go quite to nyquist to avoid oscillations
         gyroFilter->maxHz = 0.48f / (gyro.targetLooptime * 1e-6f);
@@ -142,26 +175,111 @@ void rpmFilterInit(const rpmFilterConfig_t *config)
     filterUpdatesPerIteration = rintf(filtersPerLoopIteration + 0.49f);
 }
 
-static float applyFilter(rpmNotchFilter_t* filter, int axis, float value)
+// Direct form 1 notch applied to all three axes at once, the axes are independent so the FPU can overlap them
+static FAST_CODE void applyFilter(rpmNotchFilter_t* filter, float values[XYZ_AXIS_COUNT])
 {
     if (filter == NULL) {
-        return value;
+        return;
     }
+    float x = values[X];
+    float y = values[Y];
+    float z = values[Z];
     for (int motor = 0; motor < getMotorCount(); motor++) {
         for (int i = 0; i < filter->harmonics; i++) {
-            value = biquadFilterApplyDF1(&filter->notch[axis][motor][i], value);
+            rpmNotch_t *notch = &filter->notch[motor][i];
+            if (notch->state != RPM_NOTCH_ON) {
+                if (notch->state == RPM_NOTCH_OFF) {
+                    continue;
+                }
+                // start from steady state, a notch has unity gain at DC so this avoids a transient
+                notch->x1[X] = notch->x2[X] = notch->y1[X] = notch->y2[X] = x;
+                notch->x1[Y] = notch->x2[Y] = notch->y1[Y] = notch->y2[Y] = y;
+                notch->x1[Z] = notch->x2[Z] = notch->y1[Z] = notch->y2[Z] = z;
+                notch->state = RPM_NOTCH_ON;
+            }
+            const float b0 = notch->b0;
+            const float a1 = notch->a1;
+            const float a2 = notch->a2;
+
+            const float resultX = b0 * (x + notch->x2[X]) + a1 * (notch->x1[X] - notch->y1[X]) - a2 * notch->y2[X];
+            const float resultY = b0 * (y + notch->x2[Y]) + a1 * (notch->x1[Y] - notch->y1[Y]) - a2 * notch->y2[Y];
+            const float resultZ = b0 * (z + notch->x2[Z]) + a1 * (notch->x1[Z] - notch->y1[Z]) - a2 * notch->y2[Z];
+
+            notch->x2[X] = notch->x1[X];
+            notch->x2[Y] = notch->x1[Y];
+            notch->x2[Z] = notch->x1[Z];
+            notch->x1[X] = x;
+            notch->x1[Y] = y;
+            notch->x1[Z] = z;
+            notch->y2[X] = notch->y1[X];
+            notch->y2[Y] = notch->y1[Y];
+            notch->y2[Z] = notch->y1[Z];
+            notch->y1[X] = resultX;
+            notch->y1[Y] = resultY;
+            notch->y1[Z] = resultZ;
+
+            x = resultX;
+            y = resultY;
+            z = resultZ;
         }
     }
-    return value;
+    values[X] = x;
+    values[Y] = y;
+    values[Z] = z;
 }
 
-float rpmFilterGyro(int axis, float value)
+FAST_CODE void rpmFilterGyro(float values[XYZ_AXIS_COUNT])
 {
-    return applyFilter(gyroFilter, axis, value);
+    applyFilter(gyroFilter, values);
 }
 
 FAST_DATA_ZERO_INIT static float motorFrequency[MAX_SUPPORTED_MOTORS];
 
+// The coefficient updates go to the motor whose frequency has changed the most since its notches were last set,
+// and the notches of motors below minHz or with a harmonic above maxHz are turned off rather than clamped
+static FAST_CODE void rpmFilterUpdateBudgeted(rpmNotchFilter_t *filter)
+{
+    for (int motor = 0; motor < getMotorCount(); motor++) {
+        motorFrequency[motor] = erpmToHz * filteredMotorErpm[motor];
+    }
+    minMotorFrequency = 0.0f;
+
+    for (int i = 0; i < filterUpdatesPerIteration; i++) {
+        if (currentHarmonic == 0) {
+            float maxChange = MIN_RELATIVE_CHANGE;
+            int selectedMotor = -1;
+            for (int motor = 0; motor < getMotorCount(); motor++) {
+                const float change = fabsf(motorFrequency[motor] - notchMotorFrequency[motor]) / MAX(notchMotorFrequency[motor], filter->minHz);
+                if (change > maxChange) {
+                    maxChange = change;
+                    selectedMotor = motor;
+                }
+            }
+            if (selectedMotor < 0) {
+                // all the notches are close enough to their motor frequency
+                return;
+            }
+            currentMotor = selectedMotor;
+            notchMotorFrequency[currentMotor] = motorFrequency[currentMotor];
+        }
+
+        rpmNotch_t *notch = &filter->notch[currentMotor][currentHarmonic];
+        const float frequency = (currentHarmonic + 1) * notchMotorFrequency[currentMotor];
+        if (notchMotorFrequency[currentMotor] < filter->minHz || frequency > filter->maxHz) {
+            notch->state = RPM_NOTCH_OFF;
+        } else {
+            rpmNotchUpdate(filter, notch, frequency);
+            if (notch->state == RPM_NOTCH_OFF) {
+                notch->state = RPM_NOTCH_START;
+            }
+        }
+
+        if (++currentHarmonic == filter->harmonics) {
+            currentHarmonic = 0;
+        }
+    }
+}
+
 FAST_CODE_NOINLINE void rpmFilterUpdate()
 {
     if (gyroFilter == NULL) {
@@ -175,25 +293,20 @@ FAST_CODE_NOINLINE void rpmFilterUpdate()
         }
     }
 
+    if (budgeted) {
+        rpmFilterUpdateBudgeted(gyroFilter);
+        return;
+    }
+
     for (int i = 0; i < filterUpdatesPerIteration; i++) {
         float frequency = constrainf(
             (currentHarmonic + 1) * motorFrequency[currentMotor], currentFilter->minHz, currentFilter->maxHz);
-        biquadFilter_t* template = &currentFilter->notch[0][currentMotor][currentHarmonic];
         // uncomment below to debug filter stepping. Need to also comment out motor rpm DEBUG_SET above
         /* DEBUG_SET(DEBUG_RPM_FILTER, 0, harmonic); */
         /* DEBUG_SET(DEBUG_RPM_FILTER, 1, motor); */
         /* DEBUG_SET(DEBUG_RPM_FILTER, 2, currentFilter == &gyroFilter); */
         /* DEBUG_SET(DEBUG_RPM_FILTER, 3, frequency) */
-        biquadFilterUpdate(
-            template, frequency, currentFilter->loopTime, currentFilter->q, FILTER_NOTCH);
-        for (int axis = 1; axis < XYZ_AXIS_COUNT; axis++) {
-            biquadFilter_t* clone = &currentFilter->notch[axis][currentMotor][currentHarmonic];
-            clone->b0 = template->b0;
-            clone->b1 = template->b1;
-            clone->b2 = template->b2;
-            clone->a1 = template->a1;
-            clone->a2 = template->a2;
-        }
+        rpmNotchUpdate(currentFilter, &currentFilter->notch[currentMotor][currentHarmonic], frequency);
 
         if (++currentHarmonic == currentFilter->harmonics) {
             currentHarmonic = 0;
@@ -211,6 +324,12 @@ FAST_CODE_NOINLINE void rpmFilterUpdate()
     }
 }
 
+// Unlike motorFrequency[] this is kept current for every motor on every PID loop
+FAST_CODE float rpmGetFilteredMotorFrequency(int motor)
+{
+    return erpmToHz * filteredMotorErpm[motor];
+}
+
 bool isRpmFilterEnabled(void)
 {
     return (motorConfig()->dev.useDshotTelemetry && rpmFilterConfig()->gyro_rpm_notch_harmonics);
@@ -23,6 +23,8 @@
 #include "common/axis.h"
 #include "pg/pg.h"
 
+#define RPM_FILTER_MAXHARMONICS 4
+
 typedef struct rpmFilterConfig_s
 {
     uint8_t  gyro_rpm_notch_harmonics;   // how many harmonics should be covered with notches? 0 means filter off
@@ -30,12 +32,14 @@ typedef struct rpmFilterConfig_s
     uint16_t gyro_rpm_notch_q;           // q of the notches
 
     uint16_t rpm_lpf;                    // the cutoff of the lpf on reported motor rpm
+    uint8_t  gyro_rpm_notch_budget;      // turn off notches outside minHz..maxHz and update the most changed motors first
 } rpmFilterConfig_t;
 
 PG_DECLARE(rpmFilterConfig_t, rpmFilterConfig);
 
 void  rpmFilterInit(const rpmFilterConfig_t *config);
-float rpmFilterGyro(int axis, float values);
+void  rpmFilterGyro(float values[XYZ_AXIS_COUNT]);
 void  rpmFilterUpdate();
 bool isRpmFilterEnabled(void);
 float rpmMinMotorFrequency();
+float rpmGetFilteredMotorFrequency(int motor);
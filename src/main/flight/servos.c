@@ -97,6 +97,14 @@ static uint8_t servoRuleCount = 0;
 static servoMixer_t currentServoMixer[MAX_SERVO_RULES];
 static int useServo;
 
+// The servo outputs only take a new pulse width once per PWM period, so the mixing is decimated to this many
+// updates per period. Tricopters keep mixing every PID loop, their tail servo is part of the yaw control loop.
+#define SERVO_UPDATES_PER_PERIOD 4
+// The servo lowpass runs at no less than this many times its cutoff
+#define SERVO_LOWPASS_UPDATE_RATIO 4
+
+static uint8_t servoUpdateDenom = 1;
+
 
 #define COUNT_SERVO_RULES(rules) (sizeof(rules) / sizeof(servoMixer_t))
 // mixer rule format servo, input, rate, speed, min, max, box
@@ -324,6 +332,13 @@ static void filterServos(void);
 
 void writeServos(void)
 {
+    static uint8_t servoUpdateCount = 0;
+
+    if (++servoUpdateCount < servoUpdateDenom) {
+        return;
+    }
+    servoUpdateCount = 0;
+
     servoTable();
     filterServos();
 
@@ -446,7 +461,7 @@ void servoMixer(void)
         servo[i] = 0;
     }
 
-    // mix servos according to rules
+    // mix servos according to rules, the speed is per PID loop
     for (int i = 0; i < servoRuleCount; i++) {
         // consider rule if no box assigned or box is active
         if (currentServoMixer[i].box == 0 || IS_RC_MODE_ACTIVE(BOXSERVO1 + currentServoMixer[i].box - 1)) {
@@ -459,10 +474,11 @@ void servoMixer(void)
             if (currentServoMixer[i].speed == 0)
                 currentOutput[i] = input[from];
             else {
+                const int speed = currentServoMixer[i].speed * servoUpdateDenom;
                 if (currentOutput[i] < input[from])
-                    currentOutput[i] = constrain(currentOutput[i] + currentServoMixer[i].speed, currentOutput[i], input[from]);
+                    currentOutput[i] = constrain(currentOutput[i] + speed, currentOutput[i], input[from]);
                 else if (currentOutput[i] > input[from])
-                    currentOutput[i] = constrain(currentOutput[i] - currentServoMixer[i].speed, input[from], currentOutput[i]);
+                    currentOutput[i] = constrain(currentOutput[i] - speed, input[from], currentOutput[i]);
             }
 
             servo[target] += servoDirection(target, from) * constrain(((int32_t)currentOutput[i] * currentServoMixer[i].rate) / 100, min, max);
@@ -538,11 +554,31 @@ bool isMixerUsingServos(void)
 
 static biquadFilter_t servoFilter[MAX_SUPPORTED_SERVOS];
 
+static void servoUpdateRateInit(void)
+{
+    const mixerMode_e mixerMode = getMixerMode();
+    if (mixerMode == MIXER_TRI || mixerMode == MIXER_CUSTOM_TRI) {
+        servoUpdateDenom = 1;
+        return;
+    }
+
+    const uint32_t updateIntervalUs = 1000000 / (servoConfig()->dev.servoPwmRate * SERVO_UPDATES_PER_PERIOD);
+    uint32_t denom = updateIntervalUs / targetPidLooptime;
+    if (servoConfig()->servo_lowpass_freq) {
+        const uint32_t filterIntervalUs = 1000000 / (servoConfig()->servo_lowpass_freq * SERVO_LOWPASS_UPDATE_RATIO);
+        denom = MIN(denom, filterIntervalUs / targetPidLooptime);
+    }
+
+    servoUpdateDenom = constrain(denom, 1, UINT8_MAX);
+}
+
 void servosFilterInit(void)
 {
+    servoUpdateRateInit();
+
     if (servoConfig()->servo_lowpass_freq) {
         for (int servoIdx = 0; servoIdx < MAX_SUPPORTED_SERVOS; servoIdx++) {
-            biquadFilterInitLPF(&servoFilter[servoIdx], servoConfig()->servo_lowpass_freq, targetPidLooptime);
+            biquadFilterInitLPF(&servoFilter[servoIdx], servoConfig()->servo_lowpass_freq, targetPidLooptime * servoUpdateDenom);
         }
     }
 
@@ -60,7 +60,15 @@
     #define ONLY_EXPOSE_FOR_TESTING static
 #endif
 
+// Targets with more RAM can define a larger cache so that more of the log can be waiting for the card
+#ifndef AFATFS_NUM_CACHE_SECTORS
 #define AFATFS_NUM_CACHE_SECTORS 11
+#endif
+
+// FAT sectors covered by the summary of the sectors without free clusters, one bit of RAM each (32GB of 32kB clusters)
+#ifndef AFATFS_FAT_SUMMARY_SECTORS
+#define AFATFS_FAT_SUMMARY_SECTORS 8192
+#endif
 
 // FAT filesystems are allowed to differ from these parameters, but we choose not to support those weird filesystems:
 #define AFATFS_SECTOR_SIZE  512
@@ -470,6 +478,12 @@ typedef struct afatfs_t {
     int cacheDirtyEntries; // The number of cache entries in the AFATFS_CACHE_STATE_DIRTY state
     bool cacheFlushInProgress;
 
+#ifdef AFATFS_MIN_MULTIPLE_BLOCK_WRITE_COUNT
+    // The pre-erased multi-block write which the last flushed sector belongs to, so that flushing can continue it
+    uint32_t multiWriteNextSector;
+    uint32_t multiWriteSectorsRemain;
+#endif
+
     afatfsFile_t openFiles[AFATFS_MAX_OPEN_FILES];
 
 #ifdef AFATFS_USE_FREEFILE
@@ -506,6 +520,14 @@ typedef struct afatfs_t {
      */
     uint32_t lastClusterAllocated;
 
+    /*
+     * One bit per FAT sector known to have no free cluster, so the searches for free clusters skip it without reading
+     * it. Learnt from those searches and from a scan of the FAT in the background once the volume is mounted, and
+     * cleared whenever a cluster of the sector is freed.
+     */
+    uint32_t fatSectorFull[AFATFS_FAT_SUMMARY_SECTORS / 32];
+    uint32_t fatSummaryScanSector; // The next FAT sector to be read by afatfs_fatSummaryScanContinue()
+
     /* Mask to be ANDed with a byte offset within a file to give the offset within the cluster */
     uint32_t byteInClusterMask;
 
@@ -714,10 +736,27 @@ static void afatfs_cacheFlushSector(int cacheIndex)
 #ifdef AFATFS_MIN_MULTIPLE_BLOCK_WRITE_COUNT
     if (cacheDescriptor->consecutiveEraseBlockCount) {
         sdcard_beginWriteBlocks(cacheDescriptor->sectorIndex, cacheDescriptor->consecutiveEraseBlockCount);
+
+        afatfs.multiWriteNextSector = cacheDescriptor->sectorIndex;
+        afatfs.multiWriteSectorsRemain = cacheDescriptor->consecutiveEraseBlockCount;
+    }
+#endif
+
+    const sdcardOperationStatus_e status = sdcard_writeBlock(cacheDescriptor->sectorIndex, afatfs_cacheSectorGetMemory(cacheIndex), afatfs_sdcardWriteComplete, 0);
+
+#ifdef AFATFS_MIN_MULTIPLE_BLOCK_WRITE_COUNT
+    if (status == SDCARD_OPERATION_IN_PROGRESS || status == SDCARD_OPERATION_SUCCESS) {
+        if (afatfs.multiWriteSectorsRemain > 0 && cacheDescriptor->sectorIndex == afatfs.multiWriteNextSector) {
+            afatfs.multiWriteNextSector++;
+            afatfs.multiWriteSectorsRemain--;
+        } else {
+            // Writing out of sequence ends the multi-block write on the card
+            afatfs.multiWriteSectorsRemain = 0;
+        }
     }
 #endif
 
-    switch (sdcard_writeBlock(cacheDescriptor->sectorIndex, afatfs_cacheSectorGetMemory(cacheIndex), afatfs_sdcardWriteComplete, 0)) {
+    switch (status) {
         case SDCARD_OPERATION_IN_PROGRESS:
             // The card will call us back later when the buffer transmission finishes
             afatfs.cacheDirtyEntries--;
@@ -852,29 +891,41 @@ static int afatfs_allocateCacheSector(uint32_t sectorIndex)
  */
 bool afatfs_flush(void)
 {
-    if (afatfs.cacheDirtyEntries > 0) {
-        // Flush the oldest flushable sector
+    // Sectors the card accepts immediately (e.g. into the SDIO driver's burst cache) let us carry on with the next one
+    for (int flushCount = 0; afatfs.cacheDirtyEntries > 0 && flushCount < AFATFS_NUM_CACHE_SECTORS; flushCount++) {
+        // Flush the oldest flushable sector, unless there is one that continues the current multi-block write
         uint32_t earliestSectorTime = 0xFFFFFFFF;
         int earliestSectorIndex = -1;
 
         for (int i = 0; i < AFATFS_NUM_CACHE_SECTORS; i++) {
-            if (afatfs.cacheDescriptor[i].state == AFATFS_CACHE_STATE_DIRTY && !afatfs.cacheDescriptor[i].locked
-                && (earliestSectorIndex == -1 || afatfs.cacheDescriptor[i].writeTimestamp < earliestSectorTime)
-            ) {
-                earliestSectorIndex = i;
-                earliestSectorTime = afatfs.cacheDescriptor[i].writeTimestamp;
+            if (afatfs.cacheDescriptor[i].state == AFATFS_CACHE_STATE_DIRTY && !afatfs.cacheDescriptor[i].locked) {
+#ifdef AFATFS_MIN_MULTIPLE_BLOCK_WRITE_COUNT
+                if (afatfs.multiWriteSectorsRemain > 0 && afatfs.cacheDescriptor[i].sectorIndex == afatfs.multiWriteNextSector) {
+                    earliestSectorIndex = i;
+                    break;
+                }
+#endif
+                if (earliestSectorIndex == -1 || afatfs.cacheDescriptor[i].writeTimestamp < earliestSectorTime) {
+                    earliestSectorIndex = i;
+                    earliestSectorTime = afatfs.cacheDescriptor[i].writeTimestamp;
+                }
             }
         }
 
-        if (earliestSectorIndex > -1) {
-            afatfs_cacheFlushSector(earliestSectorIndex);
+        if (earliestSectorIndex == -1) {
+            // Nothing left that we're allowed to flush
+            return true;
+        }
 
+        afatfs_cacheFlushSector(earliestSectorIndex);
+
+        if (afatfs.cacheDescriptor[earliestSectorIndex].state != AFATFS_CACHE_STATE_IN_SYNC) {
             // That flush will take time to complete so we may as well tell caller to come back later
             return false;
         }
     }
 
-    return true;
+    return afatfs.cacheDirtyEntries == 0;
 }
 
 /**
@@ -1108,6 +1159,22 @@ static void afatfs_getFATPositionForCluster(uint32_t cluster, uint32_t *fatSecto
     }
 }
 
+static bool afatfs_FATSectorIsFull(uint32_t fatSectorIndex)
+{
+    return fatSectorIndex < AFATFS_FAT_SUMMARY_SECTORS && (afatfs.fatSectorFull[fatSectorIndex / 32] & (1U << (fatSectorIndex % 32)));
+}
+
+static void afatfs_FATSectorSetFull(uint32_t fatSectorIndex, bool full)
+{
+    if (fatSectorIndex < AFATFS_FAT_SUMMARY_SECTORS) {
+        if (full) {
+            afatfs.fatSectorFull[fatSectorIndex / 32] |= 1U << (fatSectorIndex % 32);
+        } else {
+            afatfs.fatSectorFull[fatSectorIndex / 32] &= ~(1U << (fatSectorIndex % 32));
+        }
+    }
+}
+
 static bool afatfs_FATIsEndOfChainMarker(uint32_t clusterNumber)
 {
     if (afatfs.filesystemType == FAT_FILESYSTEM_TYPE_FAT32) {
@@ -1180,6 +1247,10 @@ static afatfsOperationStatus_e afatfs_FATSetNextCluster(uint32_t startCluster, u
         } else {
             sector.fat32[fatSectorEntryIndex] = nextCluster;
         }
+
+        if (fat_isFreeSpace(nextCluster)) {
+            afatfs_FATSectorSetFull(fatSectorIndex, false);
+        }
     }
 
     return result;
@@ -1265,10 +1336,22 @@ static afatfsFindClusterStatus_e afatfs_findClusterWithCondition(afatfsClusterSe
 
             // Maintain alignment
             *cluster = roundUpTo(*cluster, jump);
+            afatfs_getFATPositionForCluster(*cluster, &fatSectorIndex, &fatSectorEntryIndex);
             continue; // Go back to check that the new cluster number is within the volume
         }
 #endif
 
+        // Nor in a FAT sector that is known to be full
+        if (lookingForFree && afatfs_FATSectorIsFull(fatSectorIndex)) {
+            *cluster += fatEntriesPerSector - fatSectorEntryIndex;
+            fatSectorIndex++;
+            fatSectorEntryIndex = 0;
+            continue;
+        }
+
+        // Only a search through every entry of the sector can tell that it is full
+        const bool wholeSector = condition == CLUSTER_SEARCH_FREE && fatSectorEntryIndex == 0;
+
         afatfsOperationStatus_e status = afatfs_cacheSector(afatfs_fatSectorToPhysical(0, fatSectorIndex), &sector.bytes, AFATFS_CACHE_READ | AFATFS_CACHE_DISCARDABLE, 0);
 
         switch (status) {
@@ -1304,6 +1387,10 @@ static afatfsFindClusterStatus_e afatfs_findClusterWithCondition(afatfsClusterSe
                     fatSectorEntryIndex += jump;
                 } while (fatSectorEntryIndex < fatEntriesPerSector);
 
+                if (wholeSector) {
+                    afatfs_FATSectorSetFull(fatSectorIndex, true);
+                }
+
                 // Move on to the next FAT sector
                 fatSectorIndex++;
                 fatSectorEntryIndex = 0;
@@ -1443,9 +1530,12 @@ static afatfsOperationStatus_e afatfs_FATFillWithPattern(afatfsFATPattern_e patt
                 memset(sector.bytes + firstEntryIndex * fatEntrySize, 0, (lastEntryIndex - firstEntryIndex) * fatEntrySize);
 
                 *startCluster += lastEntryIndex - firstEntryIndex;
+
+                afatfs_FATSectorSetFull(fatSectorIndex, false);
             break;
         }
 
+        fatSectorIndex++;
         fatPhysicalSector++;
         eraseSectorCount--;
         firstEntryIndex = 0;
@@ -3268,6 +3358,50 @@ static void afatfs_fileOperationContinue(afatfsFile_t *file)
     }
 }
 
+/**
+ * While the filesystem is idle, read the next FAT sector that has not been summarised yet to learn whether it has any
+ * free cluster left, so that the free cluster searches made while logging can skip the full sectors without reading
+ * them.
+ */
+static void afatfs_fatSummaryScanContinue(void)
+{
+    const uint32_t fatEntriesPerSector = afatfs_fatEntriesPerSector();
+    const uint32_t clusterLimit = afatfs.numClusters + FAT_SMALLEST_LEGAL_CLUSTER_NUMBER;
+
+    if (afatfs.fatSummaryScanSector >= AFATFS_FAT_SUMMARY_SECTORS || afatfs.cacheDirtyEntries > 0
+#ifdef AFATFS_USE_FREEFILE
+        || afatfs_fileIsBusy(&afatfs.freeFile)
+#endif
+        || afatfs_fileIsBusy(&afatfs.currentDirectory)) {
+        return;
+    }
+
+    for (int i = 0; i < AFATFS_MAX_OPEN_FILES; i++) {
+        if (afatfs_fileIsBusy(&afatfs.openFiles[i])) {
+            return;
+        }
+    }
+
+    uint32_t cluster = afatfs.fatSummaryScanSector * fatEntriesPerSector;
+
+    if (cluster >= clusterLimit) {
+        afatfs.fatSummaryScanSector = AFATFS_FAT_SUMMARY_SECTORS;
+        return;
+    }
+
+    // Marks the sector as full if no free cluster is found in it
+    switch (afatfs_findClusterWithCondition(CLUSTER_SEARCH_FREE, &cluster, MIN(cluster + fatEntriesPerSector, clusterLimit))) {
+        case AFATFS_FIND_CLUSTER_IN_PROGRESS:
+        break;
+        case AFATFS_FIND_CLUSTER_FATAL:
+            // Leave it to the file operations to report read errors
+            afatfs.fatSummaryScanSector = AFATFS_FAT_SUMMARY_SECTORS;
+        break;
+        default:
+            afatfs.fatSummaryScanSector++;
+    }
+}
+
 /**
  * Check files for pending operations and execute them.
  */
@@ -3563,6 +3697,7 @@ void afatfs_poll(void)
             break;
             case AFATFS_FILESYSTEM_STATE_READY:
                 afatfs_fileOperationsPoll();
+                afatfs_fatSummaryScanContinue();
             break;
             default:
                 ;
@@ -49,6 +49,8 @@
 
 #include "pg/beeper.h"
 
+#include "scheduler/scheduler.h"
+
 #include "sensors/battery.h"
 #include "sensors/sensors.h"
 
@@ -161,6 +163,11 @@ static const uint8_t beep_camCloseBeep[] = {
     10, 8, 5, BEEPER_COMMAND_STOP
 };
 
+// power-on flashes - 10 short
+static const uint8_t beep_systemInit[] = {
+    3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, BEEPER_COMMAND_STOP
+};
+
 // RC Smoothing filter not initialized - 3 short + 1 long
 static const uint8_t beep_rcSmoothingInitFail[] = {
     10, 10, 10, 10, 10, 10, 50, 25, BEEPER_COMMAND_STOP
@@ -178,6 +185,9 @@ static uint8_t beep_multiBeeps[MAX_MULTI_BEEPS + 1];
 #define BEEPER_WARNING_BEEP_2_DURATION 5
 #define BEEPER_WARNING_BEEP_GAP_DURATION 10
 
+// The beeper task runs when the next toggle is due, in between sequences it only polls the beeper switches
+#define BEEPER_IDLE_TASK_PERIOD TASK_PERIOD_HZ(10)
+
 static bool beeperIsOn = false;
 
 // Place in current sequence
@@ -217,7 +227,7 @@ static const beeperTableEntry_t beeperTable[] = {
     { BEEPER_ENTRY(BEEPER_MULTI_BEEPS,           14, beep_multiBeeps,      "MULTI_BEEPS") }, // FIXME having this listed makes no sense since the beep array will not be initialised.
     { BEEPER_ENTRY(BEEPER_DISARM_REPEAT,         15, beep_disarmRepeatBeep, "DISARM_REPEAT") },
     { BEEPER_ENTRY(BEEPER_ARMED,                 16, beep_armedBeep,       "ARMED") },
-    { BEEPER_ENTRY(BEEPER_SYSTEM_INIT,           17, NULL,                 "SYSTEM_INIT") },
+    { BEEPER_ENTRY(BEEPER_SYSTEM_INIT,           17, beep_systemInit,      "SYSTEM_INIT") },
     { BEEPER_ENTRY(BEEPER_USB,                   18, NULL,                 "ON_USB") },
     { BEEPER_ENTRY(BEEPER_BLACKBOX_ERASE,        19, beep_2shortBeeps,     "BLACKBOX_ERASE") },
     { BEEPER_ENTRY(BEEPER_CRASH_FLIP_MODE,       20, beep_2longerBeeps,    "CRASH_FLIP") },
@@ -274,6 +284,9 @@ void beeper(beeperMode_e mode)
 
     beeperPos = 0;
     beeperNextToggleTime = 0;
+
+    // Start the sequence on the next scheduler pass rather than at the idle rate
+    rescheduleTask(TASK_BEEPER, 0);
 }
 
 void beeperSilence(void)
@@ -370,8 +383,8 @@ static void beeperGpsStatus(void)
 #endif
 
 /*
- * Beeper handler function to be called periodically in loop. Updates beeper
- * state via time schedule.
+ * Beeper handler function, run by the beeper task. Updates beeper state via
+ * time schedule and reschedules the task for the next state change.
  */
 void beeperUpdate(timeUs_t currentTimeUs)
 {
@@ -386,10 +399,12 @@ void beeperUpdate(timeUs_t currentTimeUs)
 
     // Beeper routine doesn't need to update if there aren't any sounds ongoing
     if (currentBeeperEntry == NULL) {
+        rescheduleTask(TASK_SELF, BEEPER_IDLE_TASK_PERIOD);
         return;
     }
 
     if (beeperNextToggleTime > currentTimeUs) {
+        rescheduleTask(TASK_SELF, beeperNextToggleTime - currentTimeUs);
         return;
     }
 
@@ -433,6 +448,13 @@ void beeperUpdate(timeUs_t currentTimeUs)
     }
 
     beeperProcessCommand(currentTimeUs);
+
+    if (currentBeeperEntry == NULL) {
+        rescheduleTask(TASK_SELF, BEEPER_IDLE_TASK_PERIOD);
+    } else {
+        // A repeat leaves the toggle time in the past, the next pass then follows straight away
+        rescheduleTask(TASK_SELF, beeperNextToggleTime > currentTimeUs ? beeperNextToggleTime - currentTimeUs : 0);
+    }
 }
 
 /*
@@ -634,6 +634,8 @@ void dashboardUpdate(timeUs_t currentTimeUs)
 
     if (armedState) {
         if (!armedStateChanged) {
+            // Finish sending the armed page if the bus was too busy to take all of it
+            i2c_OLED_flush(bus);
             return;
         }
         dashboardSetPage(PAGE_ARMED);
@@ -682,6 +684,8 @@ void dashboardUpdate(timeUs_t currentTimeUs)
         updateTicker();
     }
 
+    // Only the pages that changed are sent, from the I2C interrupts
+    i2c_OLED_flush(bus);
 }
 
 void dashboardInit(void)
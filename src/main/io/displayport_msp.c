@@ -29,6 +29,7 @@
 
 #include "cli/cli.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "drivers/display.h"
@@ -39,8 +40,32 @@
 #include "msp/msp_protocol.h"
 #include "msp/msp_serial.h"
 
+// Canvas size before row/col adjustment, the adjustments can only shrink it
+#define MSP_DISPLAYPORT_ROWS 13
+#define MSP_DISPLAYPORT_COLS 30
+
+#define MSP_OSD_MAX_STRING_LENGTH 30 // FIXME move this
+
+// Unchanged characters between two changed ones that are resent rather than starting a new write,
+// each write costs a further 10 bytes of MSP framing and subcommand header
+#define MSP_DISPLAYPORT_DELTA_RUN_GAP 4
+// Number of delta frames after which the whole canvas is sent again in case the receiver lost some
+#define MSP_DISPLAYPORT_DELTA_RESYNC_FRAMES 32
+
+typedef struct mspDisplayCanvas_s {
+    uint8_t chars[MSP_DISPLAYPORT_ROWS][MSP_DISPLAYPORT_COLS];
+    uint8_t attrs[MSP_DISPLAYPORT_ROWS][MSP_DISPLAYPORT_COLS];
+} mspDisplayCanvas_t;
+
 static displayPort_t mspDisplayPort;
 
+// With delta updates the writes of a frame go to the pending canvas and drawScreen
+// only sends the cells that differ from what the receiver was last sent.
+static mspDisplayCanvas_t pendingCanvas;
+static mspDisplayCanvas_t sentCanvas;
+static bool resyncRequired = true;
+static uint8_t framesSinceResync;
+
 static int output(displayPort_t *displayPort, uint8_t cmd, uint8_t *buf, int len)
 {
     UNUSED(displayPort);
@@ -54,6 +79,41 @@ static int output(displayPort_t *displayPort, uint8_t cmd, uint8_t *buf, int len
     return mspSerialPush(displayPortProfileMsp()->displayPortSerial, cmd, buf, len, MSP_DIRECTION_REPLY);
 }
 
+static void canvasClear(mspDisplayCanvas_t *canvas)
+{
+    memset(canvas->chars, ' ', sizeof(canvas->chars));
+    memset(canvas->attrs, 0, sizeof(canvas->attrs));
+}
+
+static uint8_t encodeAttr(uint8_t attr)
+{
+    uint8_t mspAttr = displayPortProfileMsp()->attrValues[attr] & ~DISPLAYPORT_MSP_ATTR_BLINK & DISPLAYPORT_MSP_ATTR_MASK;
+
+    if (attr & DISPLAYPORT_ATTR_BLINK) {
+        mspAttr |= DISPLAYPORT_MSP_ATTR_BLINK;
+    }
+
+    return mspAttr;
+}
+
+static int sendString(displayPort_t *displayPort, uint8_t col, uint8_t row, uint8_t mspAttr, const uint8_t *chars, int len)
+{
+    uint8_t buf[MSP_OSD_MAX_STRING_LENGTH + 4];
+
+    if (len >= MSP_OSD_MAX_STRING_LENGTH) {
+        len = MSP_OSD_MAX_STRING_LENGTH;
+    }
+
+    buf[0] = 3;
+    buf[1] = row;
+    buf[2] = col;
+    buf[3] = mspAttr;
+
+    memcpy(&buf[4], chars, len);
+
+    return output(displayPort, MSP_DISPLAYPORT, buf, len + 4);
+}
+
 static int heartbeat(displayPort_t *displayPort)
 {
     uint8_t subcmd[] = { 0 };
@@ -66,6 +126,8 @@ static int heartbeat(displayPort_t *displayPort)
 
 static int grab(displayPort_t *displayPort)
 {
+    resyncRequired = true;
+
     return heartbeat(displayPort);
 }
 
@@ -73,19 +135,96 @@ static int release(displayPort_t *displayPort)
 {
     uint8_t subcmd[] = { 1 };
 
+    resyncRequired = true;
+
     return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
 }
 
-static int clearScreen(displayPort_t *displayPort)
+static int sendClearScreen(displayPort_t *displayPort)
 {
     uint8_t subcmd[] = { 2 };
 
     return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
 }
 
+static int clearScreen(displayPort_t *displayPort)
+{
+    if (displayPortProfileMsp()->useDeltaUpdates) {
+        canvasClear(&pendingCanvas);
+        return 0;
+    }
+
+    return sendClearScreen(displayPort);
+}
+
+// Sends the runs of cells on a row that differ from the sent canvas, returns false if a write failed
+static bool sendRowDelta(displayPort_t *displayPort, uint8_t row, bool *changed)
+{
+    const uint8_t *chars = pendingCanvas.chars[row];
+    const uint8_t *attrs = pendingCanvas.attrs[row];
+    uint8_t *sentChars = sentCanvas.chars[row];
+    uint8_t *sentAttrs = sentCanvas.attrs[row];
+    const int cols = displayPort->cols;
+
+    int col = 0;
+    while (col < cols) {
+        if (chars[col] == sentChars[col] && attrs[col] == sentAttrs[col]) {
+            col++;
+            continue;
+        }
+
+        // Extend the run over changed cells with the same attribute, bridging short unchanged gaps
+        const int start = col;
+        int end = col + 1;
+        for (int i = end; i < cols && i - end < MSP_DISPLAYPORT_DELTA_RUN_GAP && attrs[i] == attrs[start]; i++) {
+            if (chars[i] != sentChars[i] || attrs[i] != sentAttrs[i]) {
+                end = i + 1;
+            }
+        }
+
+        if (sendString(displayPort, start, row, attrs[start], &chars[start], end - start) == 0) {
+            return false;
+        }
+        memcpy(&sentChars[start], &chars[start], end - start);
+        memcpy(&sentAttrs[start], &attrs[start], end - start);
+        *changed = true;
+
+        col = end;
+    }
+
+    return true;
+}
+
 static int drawScreen(displayPort_t *displayPort)
 {
     uint8_t subcmd[] = { 4 };
+
+    if (displayPortProfileMsp()->useDeltaUpdates) {
+        bool changed = false;
+
+        if (resyncRequired || ++framesSinceResync >= MSP_DISPLAYPORT_DELTA_RESYNC_FRAMES) {
+            if (sendClearScreen(displayPort) == 0) {
+                return 0;
+            }
+            canvasClear(&sentCanvas);
+            resyncRequired = false;
+            framesSinceResync = 0;
+            changed = true;
+        }
+
+        for (int row = 0; row < displayPort->rows; row++) {
+            if (!sendRowDelta(displayPort, row, &changed)) {
+                // The receiver no longer matches the sent canvas
+                resyncRequired = true;
+                return 0;
+            }
+        }
+
+        if (!changed) {
+            return 0;
+        }
+    }
+
     return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
 }
 
@@ -96,26 +235,19 @@ static int screenSize(const displayPort_t *displayPort)
 
 static int writeString(displayPort_t *displayPort, uint8_t col, uint8_t row, uint8_t attr, const char *string)
 {
-#define MSP_OSD_MAX_STRING_LENGTH 30 // FIXME move this
-    uint8_t buf[MSP_OSD_MAX_STRING_LENGTH + 4];
-
     int len = strlen(string);
-    if (len >= MSP_OSD_MAX_STRING_LENGTH) {
-        len = MSP_OSD_MAX_STRING_LENGTH;
-    }
 
-    buf[0] = 3;
-    buf[1] = row;
-    buf[2] = col;
-    buf[3] = displayPortProfileMsp()->attrValues[attr] & ~DISPLAYPORT_MSP_ATTR_BLINK & DISPLAYPORT_MSP_ATTR_MASK;
-
-    if (attr & DISPLAYPORT_ATTR_BLINK) {
-        buf[3] |= DISPLAYPORT_MSP_ATTR_BLINK;
+    if (displayPortProfileMsp()->useDeltaUpdates) {
+        if (row >= displayPort->rows || col >= displayPort->cols) {
+            return 0;
+        }
+        len = MIN(len, displayPort->cols - col);
+        memcpy(&pendingCanvas.chars[row][col], string, len);
+        memset(&pendingCanvas.attrs[row][col], encodeAttr(attr), len);
+        return 0;
     }
 
-    memcpy(&buf[4], string, len);
-
-    return output(displayPort, MSP_DISPLAYPORT, buf, len + 4);
+    return sendString(displayPort, col, row, encodeAttr(attr), (const uint8_t *)string, len);
 }
 
 static int writeChar(displayPort_t *displayPort, uint8_t col, uint8_t row, uint8_t attr, uint8_t c)
@@ -141,8 +273,9 @@ static bool isSynced(const displayPort_t *displayPort)
 
 static void redraw(displayPort_t *displayPort)
 {
-    displayPort->rows = 13 + displayPortProfileMsp()->rowAdjust; // XXX Will reflect NTSC/PAL in the future
-    displayPort->cols = 30 + displayPortProfileMsp()->colAdjust;
+    displayPort->rows = MSP_DISPLAYPORT_ROWS + displayPortProfileMsp()->rowAdjust; // XXX Will reflect NTSC/PAL in the future
+    displayPort->cols = MSP_DISPLAYPORT_COLS + displayPortProfileMsp()->colAdjust;
+    resyncRequired = true;
     drawScreen(displayPort);
 }
 
@@ -178,6 +311,7 @@ displayPort_t *displayPortMspInit(void)
         mspDisplayPort.useDeviceBlink = true;
     }
 
+    canvasClear(&pendingCanvas);
     redraw(&mspDisplayPort);
     return &mspDisplayPort;
 }
@@ -38,16 +38,26 @@
 
 #include "platform.h"
 
+#include "common/arena.h"
+#include "common/maths.h"
 #include "common/printf.h"
+#include "common/ring.h"
 #include "drivers/flash.h"
+#include "drivers/time.h"
 
 #include "io/flashfs.h"
 
+#include "pg/flash.h"
+
 static const flashPartition_t *flashPartition = NULL;
 static const flashGeometry_t *flashGeometry = NULL;
 static uint32_t flashfsSize = 0;
 
-static uint8_t flashWriteBuffer[FLASHFS_WRITE_BUFFER_SIZE];
+STATIC_ASSERT(FLASHFS_WRITE_BUFFER_SIZE <= UINT16_MAX, flashfs_write_buffer_too_large);
+STATIC_ASSERT(RING_IS_POWER_OF_TWO(FLASHFS_WRITE_BUFFER_SIZE), flashfs_write_buffer_size_not_power_of_two);
+
+// Claimed from the arena once a flashfs partition is found
+static uint8_t *flashWriteBuffer;
 
 /* The position of our head and tail in the circular flash write buffer.
  *
@@ -56,11 +66,20 @@ static uint8_t flashWriteBuffer[FLASHFS_WRITE_BUFFER_SIZE];
  *
  * When the circular buffer is empty, head == tail
  */
-static uint8_t bufferHead = 0, bufferTail = 0;
+static uint32_t bufferHead = 0, bufferTail = 0;
 
 // The position of the buffer's tail in the overall flash address space:
 static uint32_t tailAddress = 0;
 
+/*
+ * Write buffer statistics, used to size FLASHFS_WRITE_BUFFER_SIZE for a target. A stall is the time an
+ * asynchronous write spends waiting for the flash to finish a previous program or erase operation.
+ */
+static uint16_t bufferHighWater = 0;
+static timeUs_t writeStallStartUs = 0;
+static uint32_t writeStallMaxUs = 0;
+static uint32_t writeStallTotalUs = 0;
+
 static void flashfsClearBuffer(void)
 {
     bufferTail = bufferHead = 0;
@@ -71,9 +90,115 @@ static bool flashfsBufferIsEmpty(void)
     return bufferTail == bufferHead;
 }
 
+/*
+ * Erase ahead: when enabled the volume is used as a ring, and an idle task keeps up to eraseAheadSectors sectors
+ * after the tail erased, so logging never waits for a full chip erase. The oldest data is erased as the tail
+ * approaches it.
+ *
+ * tailSectorErased is true when the sector holding the tail address can be written from the tail onwards, and
+ * erasedSectorsAhead is the number of whole sectors known to be erased after that one.
+ */
+static uint8_t eraseAheadSectors = 0;
+static bool tailSectorErased = false;
+static flashSector_t erasedSectorsAhead = 0;
+
+static bool flashfsBlockIsErased(uint32_t address);
+
+static flashSector_t flashfsGetSectorCount(void)
+{
+    return flashfsSize / flashGeometry->sectorSize;
+}
+
+static flashSector_t flashfsGetNextSector(flashSector_t sector)
+{
+    return (sector + 1) % flashfsGetSectorCount();
+}
+
+static bool flashfsSectorIsErased(flashSector_t sector)
+{
+    return flashfsBlockIsErased(sector * flashGeometry->sectorSize);
+}
+
+/**
+ * Check the flash to find out how much erased space there is after the tail address.
+ */
+static void flashfsEraseAheadScan(void)
+{
+    flashSector_t sector = tailAddress / flashGeometry->sectorSize;
+
+    tailSectorErased = (tailAddress % flashGeometry->sectorSize != 0) || flashfsSectorIsErased(sector);
+    erasedSectorsAhead = 0;
+
+    // Only the configured number of sectors matter, so there is no need to look any further
+    while (erasedSectorsAhead < eraseAheadSectors && erasedSectorsAhead < flashfsGetSectorCount() - 1) {
+        sector = flashfsGetNextSector(sector);
+        if (!flashfsSectorIsErased(sector)) {
+            break;
+        }
+        erasedSectorsAhead++;
+    }
+}
+
 static void flashfsSetTailAddress(uint32_t address)
 {
+    if (!eraseAheadSectors) {
+        tailAddress = address;
+
+        return;
+    }
+
+    const uint32_t sectorSize = flashGeometry->sectorSize;
+
+    if (address >= flashfsSize) {
+        address = 0; // Wrap around to the oldest data
+    }
+
+    const flashSector_t oldSector = tailAddress / sectorSize;
+    const flashSector_t newSector = address / sectorSize;
+
     tailAddress = address;
+
+    if (newSector == oldSector) {
+        return;
+    }
+
+    if (newSector == flashfsGetNextSector(oldSector) && address % sectorSize == 0) {
+        // Writing has moved on into the next sector
+        tailSectorErased = erasedSectorsAhead > 0;
+        if (tailSectorErased) {
+            erasedSectorsAhead--;
+        }
+    } else {
+        flashfsEraseAheadScan();
+    }
+}
+
+/**
+ * Erase the next sector that is needed for the tail to keep moving, if any.
+ *
+ * Returns false if there was nothing to erase.
+ */
+static bool flashfsEraseNextSector(void)
+{
+    const flashSector_t tailSector = tailAddress / flashGeometry->sectorSize;
+
+    if (!tailSectorErased) {
+        flashEraseSector(tailSector * flashGeometry->sectorSize);
+        tailSectorErased = true;
+
+        return true;
+    }
+
+    if (erasedSectorsAhead < eraseAheadSectors && erasedSectorsAhead < flashfsGetSectorCount() - 1) {
+        const flashSector_t sector = (tailSector + 1 + erasedSectorsAhead) % flashfsGetSectorCount();
+
+        flashEraseSector(sector * flashGeometry->sectorSize);
+        erasedSectorsAhead++;
+
+        return true;
+    }
+
+    return false;
 }
 
 void flashfsEraseCompletely(void)
@@ -100,7 +225,12 @@ void flashfsEraseCompletely(void)
 
     flashfsClearBuffer();
 
-    flashfsSetTailAddress(0);
+    // Don't go through flashfsSetTailAddress(), reading the flash to check it would wait for the erase to complete
+    tailAddress = 0;
+    if (eraseAheadSectors) {
+        tailSectorErased = true;
+        erasedSectorsAhead = flashfsGetSectorCount() - 1;
+    }
 }
 
 /**
@@ -151,10 +281,45 @@ uint32_t flashfsGetSize(void)
 
 static uint32_t flashfsTransmitBufferUsed(void)
 {
-    if (bufferHead >= bufferTail)
-        return bufferHead - bufferTail;
+    return ringUsed(FLASHFS_WRITE_BUFFER_SIZE, bufferHead, bufferTail);
+}
+
+static void flashfsUpdateHighWater(void)
+{
+    const uint16_t bufferUsed = flashfsTransmitBufferUsed();
+
+    if (bufferUsed > bufferHighWater) {
+        bufferHighWater = bufferUsed;
+    }
+}
+
+/**
+ * Get the largest number of bytes that have been waiting in the write buffer since the statistics were reset.
+ */
+uint32_t flashfsGetWriteBufferHighWater(void)
+{
+    return bufferHighWater;
+}
+
+/**
+ * Get the longest time an asynchronous write has waited for the flash to become ready.
+ */
+uint32_t flashfsGetWriteStallMaxUs(void)
+{
+    return writeStallMaxUs;
+}
 
-    return FLASHFS_WRITE_BUFFER_SIZE - bufferTail + bufferHead;
+uint32_t flashfsGetWriteStallTotalMs(void)
+{
+    return writeStallTotalUs / 1000;
+}
+
+void flashfsResetWriteStats(void)
+{
+    bufferHighWater = 0;
+    writeStallStartUs = 0;
+    writeStallMaxUs = 0;
+    writeStallTotalUs = 0;
 }
 
 /**
@@ -203,9 +368,19 @@ static uint32_t flashfsWriteBuffers(uint8_t const **buffers, uint32_t *bufferSiz
     }
 
     if (!sync && !flashIsReady()) {
+        if (writeStallStartUs == 0) {
+            writeStallStartUs = micros();
+        }
         return 0;
     }
 
+    if (writeStallStartUs != 0) {
+        const uint32_t stallUs = cmpTimeUs(micros(), writeStallStartUs);
+        writeStallMaxUs = MAX(writeStallMaxUs, stallUs);
+        writeStallTotalUs += stallUs;
+        writeStallStartUs = 0;
+    }
+
     uint32_t bytesTotalRemaining = bytesTotal;
 
     uint16_t pageSize = flashGeometry->pageSize;
@@ -232,6 +407,17 @@ static uint32_t flashfsWriteBuffers(uint8_t const **buffers, uint32_t *bufferSiz
             break;
         }
 
+        if (eraseAheadSectors && !tailSectorErased) {
+            if (!sync) {
+                // The erase ahead task hasn't caught up with us yet
+                if (writeStallStartUs == 0) {
+                    writeStallStartUs = micros();
+                }
+                break;
+            }
+            flashfsEraseNextSector();
+        }
+
         flashPageProgramBegin(tailAddress);
 
         bytesRemainThisIteration = bytesTotalThisIteration;
@@ -285,15 +471,13 @@ static uint32_t flashfsWriteBuffers(uint8_t const **buffers, uint32_t *bufferSiz
  */
 static void flashfsGetDirtyDataBuffers(uint8_t const *buffers[], uint32_t bufferSizes[])
 {
-    buffers[0] = flashWriteBuffer + bufferTail;
-    buffers[1] = flashWriteBuffer + 0;
+    ringSpan_t spans[2];
 
-    if (bufferHead >= bufferTail) {
-        bufferSizes[0] = bufferHead - bufferTail;
-        bufferSizes[1] = 0;
-    } else {
-        bufferSizes[0] = FLASHFS_WRITE_BUFFER_SIZE - bufferTail;
-        bufferSizes[1] = bufferHead;
+    ringUsedSpans(flashWriteBuffer, FLASHFS_WRITE_BUFFER_SIZE, bufferHead, bufferTail, spans);
+
+    for (int i = 0; i < 2; i++) {
+        buffers[i] = spans[i].ptr;
+        bufferSizes[i] = spans[i].len;
     }
 }
 
@@ -317,25 +501,35 @@ uint32_t flashfsGetOffset(void)
  */
 static void flashfsAdvanceTailInBuffer(uint32_t delta)
 {
-    bufferTail += delta;
-
-    // Wrap tail around the end of the buffer
-    if (bufferTail >= FLASHFS_WRITE_BUFFER_SIZE) {
-        bufferTail -= FLASHFS_WRITE_BUFFER_SIZE;
-    }
+    ringConsume(FLASHFS_WRITE_BUFFER_SIZE, &bufferTail, delta);
 
     if (flashfsBufferIsEmpty()) {
         flashfsClearBuffer(); // Bring buffer pointers back to the start to be tidier
     }
 }
 
+/**
+ * Get the number of bytes which must be buffered before an asynchronous write is worth issuing. Every program
+ * operation keeps the flash busy for about as long whether it writes a whole page or a few bytes, so data is held
+ * back until it completes the page at the tail address (or reaches the auto flush length on devices with pages
+ * larger than our buffer).
+ */
+static uint32_t flashfsGetAsyncWriteThreshold(void)
+{
+    const uint32_t bytesToPageEnd = flashGeometry->pageSize - tailAddress % flashGeometry->pageSize;
+
+    return MIN(bytesToPageEnd, (uint32_t)FLASHFS_WRITE_BUFFER_AUTO_FLUSH_LEN);
+}
+
 /**
  * If the flash is ready to accept writes, flush the buffer to it.
  *
+ * Unless force is set, nothing is written until the buffered data fills the rest of the current page.
+ *
  * Returns true if all data in the buffer has been flushed to the device, or false if
  * there is still data to be written (call flush again later).
  */
-bool flashfsFlushAsync(void)
+bool flashfsFlushAsync(bool force)
 {
     if (flashfsBufferIsEmpty()) {
         return true; // Nothing to flush
@@ -346,6 +540,9 @@ bool flashfsFlushAsync(void)
     uint32_t bytesWritten;
 
     flashfsGetDirtyDataBuffers(buffers, bufferSizes);
+    if (!force && bufferSizes[0] + bufferSizes[1] < flashfsGetAsyncWriteThreshold()) {
+        return false;
+    }
     bytesWritten = flashfsWriteBuffers(buffers, bufferSizes, 2, false);
     flashfsAdvanceTailInBuffer(bytesWritten);
 
@@ -393,14 +590,16 @@ void flashfsSeekRel(int32_t offset)
  */
 void flashfsWriteByte(uint8_t byte)
 {
-    flashWriteBuffer[bufferHead++] = byte;
-
-    if (bufferHead >= FLASHFS_WRITE_BUFFER_SIZE) {
-        bufferHead = 0;
+    if (!flashfsIsSupported()) {
+        return;
     }
 
+    ringPut(flashWriteBuffer, FLASHFS_WRITE_BUFFER_SIZE, &bufferHead, &bufferTail, byte);
+
+    flashfsUpdateHighWater();
+
     if (flashfsTransmitBufferUsed() >= FLASHFS_WRITE_BUFFER_AUTO_FLUSH_LEN) {
-        flashfsFlushAsync();
+        flashfsFlushAsync(false);
     }
 }
 
@@ -415,6 +614,10 @@ void flashfsWrite(const uint8_t *data, unsigned int len, bool sync)
     uint8_t const * buffers[3];
     uint32_t bufferSizes[3];
 
+    if (!flashfsIsSupported()) {
+        return;
+    }
+
     // There could be two dirty buffers to write out already:
     flashfsGetDirtyDataBuffers(buffers, bufferSizes);
 
@@ -423,10 +626,10 @@ void flashfsWrite(const uint8_t *data, unsigned int len, bool sync)
     bufferSizes[2] = len;
 
     /*
-     * Would writing this data to our buffer cause our buffer to reach the flush threshold? If so try to write through
+     * Would writing this data to our buffer complete the current page? If so try to write through
      * to the flash now
      */
-    if (bufferSizes[0] + bufferSizes[1] + bufferSizes[2] >= FLASHFS_WRITE_BUFFER_AUTO_FLUSH_LEN) {
+    if (bufferSizes[0] + bufferSizes[1] + bufferSizes[2] >= flashfsGetAsyncWriteThreshold()) {
         uint32_t bytesWritten;
 
         // Attempt to write all three buffers through to the flash asynchronously
@@ -467,25 +670,9 @@ void flashfsWrite(const uint8_t *data, unsigned int len, bool sync)
     }
 
     // Buffer up the data the user supplied instead of writing it right away
+    ringWrite(flashWriteBuffer, FLASHFS_WRITE_BUFFER_SIZE, &bufferHead, &bufferTail, data, len);
 
-    // First write the portion before we wrap around the end of the circular buffer
-    unsigned int bufferBytesBeforeWrap = FLASHFS_WRITE_BUFFER_SIZE - bufferHead;
-
-    unsigned int firstPortion = len < bufferBytesBeforeWrap ? len : bufferBytesBeforeWrap;
-
-    memcpy(flashWriteBuffer + bufferHead, data, firstPortion);
-
-    bufferHead += firstPortion;
-
-    data += firstPortion;
-    len -= firstPortion;
-
-    // If we wrap the head around, write the remainder to the start of the buffer (if any)
-    if (bufferHead == FLASHFS_WRITE_BUFFER_SIZE) {
-        memcpy(flashWriteBuffer + 0, data, len);
-
-        bufferHead = len;
-    }
+    flashfsUpdateHighWater();
 }
 
 /**
@@ -511,63 +698,68 @@ int flashfsReadAbs(uint32_t address, uint8_t *buffer, unsigned int len)
     return bytesRead;
 }
 
-/**
- * Find the offset of the start of the free space on the device (or the size of the device if it is full).
+/* Find the start of the free space on the device by examining the beginning of blocks with a binary search,
+ * looking for ones that appear to be erased. We can achieve this with good accuracy because an erased block
+ * is all bits set to 1, which pretty much never appears in reasonable size substrings of blackbox logs.
+ *
+ * To do better we might write a volume header instead, which would mark how much free space remains. But keeping
+ * a header up to date while logging would incur more writes to the flash, which would consume precious write
+ * bandwidth and block more often.
  */
-int flashfsIdentifyStartOfFreeSpace(void)
-{
-    /* Find the start of the free space on the device by examining the beginning of blocks with a binary search,
-     * looking for ones that appear to be erased. We can achieve this with good accuracy because an erased block
-     * is all bits set to 1, which pretty much never appears in reasonable size substrings of blackbox logs.
-     *
-     * To do better we might write a volume header instead, which would mark how much free space remains. But keeping
-     * a header up to date while logging would incur more writes to the flash, which would consume precious write
-     * bandwidth and block more often.
+enum {
+    /* We can choose whatever power of 2 size we like, which determines how much wastage of free space we'll have
+     * at the end of the last written data. But smaller blocksizes will require more searching.
      */
+    FREE_BLOCK_SIZE = 2048, // XXX This can't be smaller than page size for underlying flash device.
 
-    enum {
-        /* We can choose whatever power of 2 size we like, which determines how much wastage of free space we'll have
-         * at the end of the last written data. But smaller blocksizes will require more searching.
-         */
-        FREE_BLOCK_SIZE = 2048, // XXX This can't be smaller than page size for underlying flash device.
-
-        /* We don't expect valid data to ever contain this many consecutive uint32_t's of all 1 bits: */
-        FREE_BLOCK_TEST_SIZE_INTS = 4, // i.e. 16 bytes
-        FREE_BLOCK_TEST_SIZE_BYTES = FREE_BLOCK_TEST_SIZE_INTS * sizeof(uint32_t)
-    };
+    /* We don't expect valid data to ever contain this many consecutive uint32_t's of all 1 bits: */
+    FREE_BLOCK_TEST_SIZE_INTS = 4, // i.e. 16 bytes
+    FREE_BLOCK_TEST_SIZE_BYTES = FREE_BLOCK_TEST_SIZE_INTS * sizeof(uint32_t)
+};
 
-    STATIC_ASSERT(FREE_BLOCK_SIZE >= FLASH_MAX_PAGE_SIZE, FREE_BLOCK_SIZE_too_small);
+STATIC_ASSERT(FREE_BLOCK_SIZE >= FLASH_MAX_PAGE_SIZE, FREE_BLOCK_SIZE_too_small);
 
+/**
+ * Returns true if the block starting at the given address appears to be erased, false if it has been written to or
+ * the flash timed out.
+ */
+static bool flashfsBlockIsErased(uint32_t address)
+{
     union {
         uint8_t bytes[FREE_BLOCK_TEST_SIZE_BYTES];
         uint32_t ints[FREE_BLOCK_TEST_SIZE_INTS];
     } testBuffer;
 
-    int left = 0; // Smallest block index in the search region
-    int right = flashfsSize / FREE_BLOCK_SIZE; // One past the largest block index in the search region
+    if (flashReadBytes(address, testBuffer.bytes, FREE_BLOCK_TEST_SIZE_BYTES) < FREE_BLOCK_TEST_SIZE_BYTES) {
+        // Unexpected timeout from flash, so report the block as used
+        return false;
+    }
+
+    // Checking the buffer 4 bytes at a time like this is probably faster than byte-by-byte, but I didn't benchmark it :)
+    for (int i = 0; i < FREE_BLOCK_TEST_SIZE_INTS; i++) {
+        if (testBuffer.ints[i] != 0xFFFFFFFF) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Find the first erased block in [start...end), which must hold written data followed by erased blocks.
+ * Returns end if there are no erased blocks.
+ */
+static uint32_t flashfsFindStartOfFreeSpace(uint32_t start, uint32_t end)
+{
+    int left = start / FREE_BLOCK_SIZE; // Smallest block index in the search region
+    int right = end / FREE_BLOCK_SIZE; // One past the largest block index in the search region
     int mid;
     int result = right;
-    int i;
-    bool blockErased;
 
     while (left < right) {
         mid = (left + right) / 2;
 
-        if (flashReadBytes(mid * FREE_BLOCK_SIZE, testBuffer.bytes, FREE_BLOCK_TEST_SIZE_BYTES) < FREE_BLOCK_TEST_SIZE_BYTES) {
-            // Unexpected timeout from flash, so bail early (reporting the device fuller than it really is)
-            break;
-        }
-
-        // Checking the buffer 4 bytes at a time like this is probably faster than byte-by-byte, but I didn't benchmark it :)
-        blockErased = true;
-        for (i = 0; i < FREE_BLOCK_TEST_SIZE_INTS; i++) {
-            if (testBuffer.ints[i] != 0xFFFFFFFF) {
-                blockErased = false;
-                break;
-            }
-        }
-
-        if (blockErased) {
+        if (flashfsBlockIsErased(mid * FREE_BLOCK_SIZE)) {
             /* This erased block might be the leftmost erased block in the volume, but we'll need to continue the
              * search leftwards to find out:
              */
@@ -582,6 +774,63 @@ int flashfsIdentifyStartOfFreeSpace(void)
     return result * FREE_BLOCK_SIZE;
 }
 
+/**
+ * Find the offset of the start of the free space on the device (or the size of the device if it is full).
+ */
+int flashfsIdentifyStartOfFreeSpace(void)
+{
+    return flashfsFindStartOfFreeSpace(0, flashfsSize);
+}
+
+/**
+ * Find the start of the free space when the volume is used as a ring, where it follows the newest data and may
+ * be anywhere on the device. Returns 0 if every sector is erased or every sector has been written.
+ */
+static uint32_t flashfsIdentifyStartOfFreeSpaceInRing(void)
+{
+    const flashSector_t sectorCount = flashfsGetSectorCount();
+    bool previousSectorErased = flashfsSectorIsErased(sectorCount - 1);
+
+    for (flashSector_t sector = 0; sector < sectorCount; sector++) {
+        const bool sectorErased = flashfsSectorIsErased(sector);
+
+        if (sectorErased && !previousSectorErased) {
+            // The newest data ends somewhere in the previous sector
+            const flashSector_t previousSector = (sector + sectorCount - 1) % sectorCount;
+            const uint32_t previousSectorStart = previousSector * flashGeometry->sectorSize;
+
+            return flashfsFindStartOfFreeSpace(previousSectorStart, previousSectorStart + flashGeometry->sectorSize) % flashfsSize;
+        }
+        previousSectorErased = sectorErased;
+    }
+
+    return 0;
+}
+
+/**
+ * Call regularly from an idle task to keep the configured number of sectors erased ahead of the tail.
+ */
+void flashfsEraseAheadUpdate(timeUs_t currentTimeUs)
+{
+    UNUSED(currentTimeUs);
+
+    if (!eraseAheadSectors || !flashIsReady()) {
+        return;
+    }
+
+    // Don't hold up a page that is ready to be written with an erase
+    if (flashfsTransmitBufferUsed() >= flashfsGetAsyncWriteThreshold()) {
+        return;
+    }
+
+    flashfsEraseNextSector();
+}
+
+bool flashfsIsEraseAheadEnabled(void)
+{
+    return eraseAheadSectors > 0;
+}
+
 /**
  * Returns true if the file pointer is at the end of the device.
  */
@@ -621,8 +870,27 @@ void flashfsInit(void)
         return;
     }
 
+    if (!flashWriteBuffer) {
+        flashWriteBuffer = arenaAlloc(ARENA_OWNER_FLASHFS, FLASHFS_WRITE_BUFFER_SIZE);
+        if (!flashWriteBuffer) {
+            return;
+        }
+    }
+
     flashfsSize = FLASH_PARTITION_SECTOR_COUNT(flashPartition) * flashGeometry->sectorSize;
 
+    eraseAheadSectors = flashConfig()->eraseAheadSectors;
+    if (eraseAheadSectors) {
+        // Nothing could be written if every sector was erased ahead of the tail
+        eraseAheadSectors = MIN(eraseAheadSectors, flashfsGetSectorCount() - 1);
+
+        flashfsClearBuffer();
+        tailAddress = flashfsIdentifyStartOfFreeSpaceInRing();
+        flashfsEraseAheadScan();
+
+        return;
+    }
+
     // Start the file pointer off at the beginning of free space so caller can start writing immediately
     flashfsSeekAbs(flashfsIdentifyStartOfFreeSpace());
 }
@@ -20,11 +20,17 @@
 
 #pragma once
 
-#define FLASHFS_WRITE_BUFFER_SIZE 128
+#include "common/time.h"
+
+// Large enough to fill the next page while the previous one is being programmed, targets with more RAM
+// can define a larger size so that the buffer also absorbs flash erase and program stalls
+#ifndef FLASHFS_WRITE_BUFFER_SIZE
+#define FLASHFS_WRITE_BUFFER_SIZE 512
+#endif
 #define FLASHFS_WRITE_BUFFER_USABLE (FLASHFS_WRITE_BUFFER_SIZE - 1)
 
-// Automatically trigger a flush when this much data is in the buffer
-#define FLASHFS_WRITE_BUFFER_AUTO_FLUSH_LEN 64
+// Automatically trigger a flush when this much data is in the buffer, or sooner if it completes a page
+#define FLASHFS_WRITE_BUFFER_AUTO_FLUSH_LEN 256
 
 void flashfsEraseCompletely(void);
 void flashfsEraseRange(uint32_t start, uint32_t end);
@@ -45,7 +51,7 @@ void flashfsWrite(const uint8_t *data, unsigned int len, bool sync);
 
 int flashfsReadAbs(uint32_t offset, uint8_t *data, unsigned int len);
 
-bool flashfsFlushAsync(void);
+bool flashfsFlushAsync(bool force);
 void flashfsFlushSync(void);
 
 void flashfsClose(void);
@@ -57,3 +63,11 @@ bool flashfsIsEOF(void);
 
 bool flashfsVerifyEntireFlash(void);
 
+uint32_t flashfsGetWriteBufferHighWater(void);
+uint32_t flashfsGetWriteStallMaxUs(void);
+uint32_t flashfsGetWriteStallTotalMs(void);
+void flashfsResetWriteStats(void);
+
+void flashfsEraseAheadUpdate(timeUs_t currentTimeUs);
+bool flashfsIsEraseAheadEnabled(void);
+
@@ -35,6 +35,9 @@
 #define FRSKY_OSD_CHAR_TOTAL_BYTES (FRSKY_OSD_CHAR_DATA_BYTES + FRSKY_OSD_CHAR_METADATA_BYTES)
 
 #define FRSKY_OSD_SEND_BUFFER_SIZE 192
+// Encoded packets waiting for the UART, large enough to hold a complete OSD frame
+#define FRSKY_OSD_FRAME_BUFFER_SIZE 1024
+#define FRSKY_OSD_PACKET_MAX_OVERHEAD 7 // preamble, uvarint length and crc
 #define FRSKY_OSD_RECV_BUFFER_SIZE 128
 
 #define FRSKY_OSD_CMD_RESPONSE_ERROR 0
@@ -217,6 +220,11 @@ typedef struct frskyOsdState_s {
         uint8_t data[FRSKY_OSD_SEND_BUFFER_SIZE];
         uint8_t pos;
     } sendBuffer;
+    struct {
+        uint8_t data[FRSKY_OSD_FRAME_BUFFER_SIZE];
+        uint16_t head;
+        uint16_t tail;
+    } frameBuffer;
     struct {
         uint8_t state;
         uint8_t crc;
@@ -268,11 +276,27 @@ static void frskyOsdResetSendBuffer(void)
     state.sendBuffer.pos = 0;
 }
 
+// Writes as much of the frame buffer as the UART accepts, waiting for all of it if blocking is set
+static void frskyOsdDrainFrameBuffer(bool blocking)
+{
+    while (state.frameBuffer.tail < state.frameBuffer.head) {
+        uint32_t count = MIN(serialTxBytesFree(state.port), (uint32_t)(state.frameBuffer.head - state.frameBuffer.tail));
+        if (count == 0) {
+            if (!blocking) {
+                return;
+            }
+            continue;
+        }
+        serialWriteBuf(state.port, &state.frameBuffer.data[state.frameBuffer.tail], count);
+        state.frameBuffer.tail += count;
+    }
+    state.frameBuffer.head = 0;
+    state.frameBuffer.tail = 0;
+}
+
 static void frskyOsdProcessCommandU8(uint8_t *crc, uint8_t c)
 {
-    while (serialTxBytesFree(state.port) == 0) {
-    };
-    serialWrite(state.port, c);
+    state.frameBuffer.data[state.frameBuffer.head++] = c;
     if (crc) {
         *crc = crc8_dvb_s2(*crc, c);
     }
@@ -302,6 +326,9 @@ static void frskyOsdStateReset(serialPort_t *port)
     state.info.viewport.width = 0;
     state.info.viewport.height = 0;
 
+    state.frameBuffer.head = 0;
+    state.frameBuffer.tail = 0;
+
     state.port = port;
     state.initialized = false;
 }
@@ -479,6 +506,7 @@ static bool frskyOsdSendSyncCommand(uint8_t cmd, const void *data, size_t size,
     frskyOsdClearReceiveBuffer();
     frskyOsdSendCommand(cmd, data, size);
     frskyOsdFlushSendBuffer();
+    frskyOsdDrainFrameBuffer(true);
     timeMs_t end = millis() + timeout;
     while (millis() < end) {
         frskyOsdUpdateReceiveBuffer();
@@ -540,6 +568,9 @@ void frskyOsdUpdate(void)
     if (!state.port) {
         return;
     }
+    // Send the rest of the last frame as the UART accepts it
+    frskyOsdDrainFrameBuffer(false);
+
     frskyOsdUpdateReceiveBuffer();
 
     if (frskyOsdIsResponseAvailable()) {
@@ -583,9 +614,15 @@ void frskyOsdCommitTransaction(void)
     frskyOsdFlushSendBuffer();
 }
 
+// Encodes the pending commands as a packet into the frame buffer, which is written to the
+// UART without waiting for it so that a committed frame goes out over the following OSD updates
 void frskyOsdFlushSendBuffer(void)
 {
     if (state.sendBuffer.pos > 0) {
+        if (state.frameBuffer.head + state.sendBuffer.pos + FRSKY_OSD_PACKET_MAX_OVERHEAD > FRSKY_OSD_FRAME_BUFFER_SIZE) {
+            // The frame buffer can't hold the packet, fall back to waiting for the UART
+            frskyOsdDrainFrameBuffer(true);
+        }
         frskyOsdProcessCommandU8(NULL, FRSKY_OSD_PREAMBLE_BYTE_0);
         frskyOsdProcessCommandU8(NULL, FRSKY_OSD_PREAMBLE_BYTE_1);
 
@@ -601,6 +638,7 @@ void frskyOsdFlushSendBuffer(void)
         frskyOsdProcessCommandU8(NULL, crc);
         state.sendBuffer.pos = 0;
     }
+    frskyOsdDrainFrameBuffer(false);
 }
 
 bool frskyOsdReadFontCharacter(unsigned char_address, osdCharacter_t *chr)
@@ -66,6 +66,7 @@
 #define LOG_UBLOX_SVINFO 'I'
 #define LOG_UBLOX_POSLLH 'P'
 #define LOG_UBLOX_VELNED 'V'
+#define LOG_UBLOX_PVT    'T'
 
 #define GPS_SV_MAXSATS   16
 
@@ -153,6 +154,17 @@ static const uint8_t ubloxInit[] = {
     0xB5, 0x62, 0x06, 0x08, 0x06, 0x00, 0xC8, 0x00, 0x01, 0x00, 0x01, 0x00, 0xDE, 0x6A,             // set rate to 5Hz (measurement period: 200ms, navigation rate: 1 cycle)
 };
 
+// Replace the separate navigation messages by NAV-PVT at 10Hz, u-blox 7 and later only
+static const uint8_t ubloxPvtInit[] = {
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x02, 0x00, 0x0D, 0x46,           // disable POSLLH
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x03, 0x00, 0x0E, 0x48,           // disable STATUS
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x06, 0x00, 0x11, 0x4E,           // disable SOL
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x12, 0x00, 0x1D, 0x66,           // disable VELNED
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x07, 0x01, 0x13, 0x51,           // set PVT MSG rate
+
+    0xB5, 0x62, 0x06, 0x08, 0x06, 0x00, 0x64, 0x00, 0x01, 0x00, 0x01, 0x00, 0x7A, 0x12,             // set rate to 10Hz (measurement period: 100ms, navigation rate: 1 cycle)
+};
+
 static const uint8_t ubloxAirborne[] = {
     //Preprocessor Airborne_1g Dynamic Platform Model Option
     #if defined(GPS_UBLOX_MODE_AIRBORNE_1G)
@@ -240,7 +252,7 @@ typedef enum {
 gpsData_t gpsData;
 
 
-PG_REGISTER_WITH_RESET_TEMPLATE(gpsConfig_t, gpsConfig, PG_GPS_CONFIG, 0);
+PG_REGISTER_WITH_RESET_TEMPLATE(gpsConfig_t, gpsConfig, PG_GPS_CONFIG, 1);
 
 PG_RESET_TEMPLATE(gpsConfig_t, gpsConfig,
     .provider = GPS_NMEA,
@@ -249,6 +261,7 @@ PG_RESET_TEMPLATE(gpsConfig_t, gpsConfig,
     .autoBaud = GPS_AUTOBAUD_OFF,
     .gps_ublox_use_galileo = false,
     .gps_ublox_mode = UBLOX_AIRBORNE,
+    .gps_ublox_use_pvt = false,
     .gps_set_home_point_once = false,
     .gps_use_3d_speed = false,
     .sbas_integrity = false
@@ -464,8 +477,11 @@ void gpsInitUblox(void)
             }
 
             if (gpsData.messageState == GPS_MESSAGE_STATE_INIT) {
-                if (gpsData.state_position < sizeof(ubloxInit)) {
-                    if (gpsData.state_position < sizeof(ubloxAirborne)) {
+                const size_t initLength = sizeof(ubloxInit) + (gpsConfig()->gps_ublox_use_pvt ? sizeof(ubloxPvtInit) : 0);
+                if (gpsData.state_position < initLength) {
+                    if (gpsData.state_position >= sizeof(ubloxInit)) {
+                        serialWrite(gpsPort, ubloxPvtInit[gpsData.state_position - sizeof(ubloxInit)]);
+                    } else if (gpsData.state_position < sizeof(ubloxAirborne)) {
                         if (gpsConfig()->gps_ublox_mode == UBLOX_AIRBORNE) {
                             serialWrite(gpsPort, ubloxAirborne[gpsData.state_position]);
                         } else {
@@ -1148,6 +1164,41 @@ typedef struct {
     uint32_t heading_accuracy;
 } ubx_nav_velned;
 
+typedef struct {
+    uint32_t time;              // GPS msToW
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t min;
+    uint8_t sec;
+    uint8_t valid;
+    uint32_t tAcc;
+    int32_t nano;
+    uint8_t fixType;
+    uint8_t flags;
+    uint8_t flags2;
+    uint8_t numSV;
+    int32_t lon;
+    int32_t lat;
+    int32_t height;
+    int32_t hMSL;               // mm
+    uint32_t hAcc;
+    uint32_t vAcc;
+    int32_t velN;               // mm/s
+    int32_t velE;
+    int32_t velD;
+    int32_t gSpeed;
+    int32_t headMot;            // deg * 100000
+    uint32_t sAcc;
+    uint32_t headAcc;
+    uint16_t pDOP;
+    uint8_t reserved1[6];
+    int32_t headVeh;
+    int16_t magDec;
+    uint16_t magAcc;
+} ubx_nav_pvt;
+
 typedef struct {
     uint8_t chn;                // Channel number, 255 for SVx not assigned to channel
     uint8_t svid;               // Satellite ID
@@ -1183,6 +1234,7 @@ enum {
     MSG_POSLLH = 0x2,
     MSG_STATUS = 0x3,
     MSG_SOL = 0x6,
+    MSG_PVT = 0x7,
     MSG_VELNED = 0x12,
     MSG_SVINFO = 0x30,
     MSG_CFG_PRT = 0x00,
@@ -1206,6 +1258,12 @@ enum {
     NAV_STATUS_TIME_SECOND_VALID = 8
 } ubx_nav_status_bits;
 
+enum {
+    NAV_PVT_VALID_DATE = 1,
+    NAV_PVT_VALID_TIME = 2,
+    NAV_PVT_FLAGS_GNSS_FIX_OK = 1
+} ubx_nav_pvt_bits;
+
 // Packet checksum accumulators
 static uint8_t _ck_a;
 static uint8_t _ck_b;
@@ -1249,6 +1307,7 @@ static union {
     ubx_nav_status status;
     ubx_nav_solution solution;
     ubx_nav_velned velned;
+    ubx_nav_pvt pvt;
     ubx_nav_svinfo svinfo;
     ubx_ack ack;
     uint8_t bytes[UBLOX_PAYLOAD_SIZE];
@@ -1306,6 +1365,41 @@ static bool UBLOX_parse_gps(void)
         }
 #endif
         break;
+    case MSG_PVT:
+        // a single message carries the position, speed and fix, so it completes a solution on its own
+        *gpsPacketLogChar = LOG_UBLOX_PVT;
+        next_fix = (_buffer.pvt.flags & NAV_PVT_FLAGS_GNSS_FIX_OK) && (_buffer.pvt.fixType == FIX_3D);
+        if (next_fix) {
+            ENABLE_STATE(GPS_FIX);
+        } else {
+            DISABLE_STATE(GPS_FIX);
+        }
+        gpsSol.llh.lon = _buffer.pvt.lon;
+        gpsSol.llh.lat = _buffer.pvt.lat;
+        gpsSol.llh.altCm = _buffer.pvt.hMSL / 10;  //alt in cm
+        gpsSol.numSat = _buffer.pvt.numSV;
+        gpsSol.hdop = _buffer.pvt.pDOP;
+        gpsSol.speed3d = (uint16_t)(sqrtf(sq((float)_buffer.pvt.velN) + sq((float)_buffer.pvt.velE) + sq((float)_buffer.pvt.velD)) / 10); // cm/s
+        gpsSol.groundSpeed = _buffer.pvt.gSpeed / 10;    // cm/s
+        gpsSol.groundCourse = (uint16_t) (_buffer.pvt.headMot / 10000);     // Heading 2D deg * 100000 rescaled to deg * 10
+#ifdef USE_RTC_TIME
+        //set clock, when gps time is available
+        if (!rtcHasTime() && (_buffer.pvt.valid & NAV_PVT_VALID_DATE) && (_buffer.pvt.valid & NAV_PVT_VALID_TIME)) {
+            dateTime_t dt = {
+                .year = _buffer.pvt.year,
+                .month = _buffer.pvt.month,
+                .day = _buffer.pvt.day,
+                .hours = _buffer.pvt.hour,
+                .minutes = _buffer.pvt.min,
+                .seconds = _buffer.pvt.sec,
+                .millis = (_buffer.pvt.nano > 0) ? _buffer.pvt.nano / 1000000 : 0,
+            };
+            rtcSetDateTime(&dt);
+        }
+#endif
+        _new_position = true;
+        _new_speed = true;
+        break;
     case MSG_VELNED:
         *gpsPacketLogChar = LOG_UBLOX_VELNED;
         gpsSol.speed3d = _buffer.velned.speed_3d;       // cm/s
@@ -1471,11 +1565,27 @@ void gpsEnablePassthrough(serialPort_t *gpsPassthroughPort)
 }
 
 float GPS_scaleLonDown = 1.0f;  // this is used to offset the shrinking longitude as we go towards the poles
+int32_t GPS_homeOffsetCm[2];    // position relative to home in cm, north in [LAT] and east in [LON]
+
+#define DISTANCE_BETWEEN_TWO_LONGITUDE_POINTS_AT_EQUATOR_IN_HUNDREDS_OF_KILOMETERS 1.113195f
+#define TAN_89_99_DEGREES 5729.57795f
+
+// cm per 1/10 000 000 degree in Q16, latitude is fixed and longitude shrinks towards the poles
+#define GPS_CM_PER_E7_DEGREE_Q16 ((int32_t)(DISTANCE_BETWEEN_TWO_LONGITUDE_POINTS_AT_EQUATOR_IN_HUNDREDS_OF_KILOMETERS * (1 << 16) + 0.5f))
+static int32_t GPS_lonCmPerE7DegreeQ16 = GPS_CM_PER_E7_DEGREE_Q16;
 
 void GPS_calc_longitude_scaling(int32_t lat)
 {
     float rads = (fabsf((float)lat) / 10000000.0f) * 0.0174532925f;
     GPS_scaleLonDown = cos_approx(rads);
+    GPS_lonCmPerE7DegreeQ16 = lrintf(GPS_scaleLonDown * DISTANCE_BETWEEN_TWO_LONGITUDE_POINTS_AT_EQUATOR_IN_HUNDREDS_OF_KILOMETERS * (1 << 16));
+}
+
+// Project the current position into the local north/east frame anchored at home
+static void GPS_updateHomeOffset(void)
+{
+    GPS_homeOffsetCm[LAT] = ((int64_t)(gpsSol.llh.lat - GPS_home[LAT]) * GPS_CM_PER_E7_DEGREE_Q16) >> 16;
+    GPS_homeOffsetCm[LON] = ((int64_t)(gpsSol.llh.lon - GPS_home[LON]) * GPS_lonCmPerE7DegreeQ16) >> 16;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -1483,7 +1593,7 @@ void GPS_calc_longitude_scaling(int32_t lat)
 //
 static void GPS_calculateDistanceFlownVerticalSpeed(bool initialize)
 {
-    static int32_t lastCoord[2] = { 0, 0 };
+    static int32_t lastOffsetCm[2] = { 0, 0 };
     static int32_t lastAlt;
     static int32_t lastMillis;
 
@@ -1497,9 +1607,7 @@ static void GPS_calculateDistanceFlownVerticalSpeed(bool initialize)
             uint16_t speed = gpsConfig()->gps_use_3d_speed ? gpsSol.speed3d : gpsSol.groundSpeed;
             // Only add up movement when speed is faster than minimum threshold
             if (speed > GPS_DISTANCE_FLOWN_MIN_SPEED_THRESHOLD_CM_S) {
-                uint32_t dist;
-                int32_t dir;
-                GPS_distance_cm_bearing(&gpsSol.llh.lat, &gpsSol.llh.lon, &lastCoord[LAT], &lastCoord[LON], &dist, &dir);
+                uint32_t dist = sqrtf(sq((float)(GPS_homeOffsetCm[LAT] - lastOffsetCm[LAT])) + sq((float)(GPS_homeOffsetCm[LON] - lastOffsetCm[LON])));
                 if (gpsConfig()->gps_use_3d_speed) {
                     dist = sqrtf(powf(gpsSol.llh.altCm - lastAlt, 2.0f) + powf(dist, 2.0f));
                 }
@@ -1509,8 +1617,8 @@ static void GPS_calculateDistanceFlownVerticalSpeed(bool initialize)
         GPS_verticalSpeedInCmS = (gpsSol.llh.altCm - lastAlt) * 1000 / (currentMillis - lastMillis);
         GPS_verticalSpeedInCmS = constrain(GPS_verticalSpeedInCmS, -1500, 1500);
     }
-    lastCoord[LON] = gpsSol.llh.lon;
-    lastCoord[LAT] = gpsSol.llh.lat;
+    lastOffsetCm[LAT] = GPS_homeOffsetCm[LAT];
+    lastOffsetCm[LON] = GPS_homeOffsetCm[LON];
     lastAlt = gpsSol.llh.altCm;
     lastMillis = currentMillis;
 }
@@ -1526,32 +1634,22 @@ void GPS_reset_home_position(void)
             ENABLE_STATE(GPS_FIX_HOME);
         }
     }
+    GPS_updateHomeOffset();
     GPS_calculateDistanceFlownVerticalSpeed(true); //Initialize
 }
 
-////////////////////////////////////////////////////////////////////////////////////
-#define DISTANCE_BETWEEN_TWO_LONGITUDE_POINTS_AT_EQUATOR_IN_HUNDREDS_OF_KILOMETERS 1.113195f
-#define TAN_89_99_DEGREES 5729.57795f
-// Get distance between two points in cm
-// Get bearing from pos1 to pos2, returns an 1deg = 100 precision
-void GPS_distance_cm_bearing(int32_t *currentLat1, int32_t *currentLon1, int32_t *destinationLat2, int32_t *destinationLon2, uint32_t *dist, int32_t *bearing)
-{
-    float dLat = *destinationLat2 - *currentLat1; // difference of latitude in 1/10 000 000 degrees
-    float dLon = (float)(*destinationLon2 - *currentLon1) * GPS_scaleLonDown;
-    *dist = sqrtf(sq(dLat) + sq(dLon)) * DISTANCE_BETWEEN_TWO_LONGITUDE_POINTS_AT_EQUATOR_IN_HUNDREDS_OF_KILOMETERS;
-
-    *bearing = 9000.0f + atan2_approx(-dLat, dLon) * TAN_89_99_DEGREES;      // Convert the output radians to 100xdeg
-    if (*bearing < 0)
-        *bearing += 36000;
-}
-
 void GPS_calculateDistanceAndDirectionToHome(void)
 {
     if (STATE(GPS_FIX_HOME)) {      // If we don't have home set, do not display anything
-        uint32_t dist;
-        int32_t dir;
-        GPS_distance_cm_bearing(&gpsSol.llh.lat, &gpsSol.llh.lon, &GPS_home[LAT], &GPS_home[LON], &dist, &dir);
-        GPS_distanceToHome = dist / 100;
+        const float north = GPS_homeOffsetCm[LAT];
+        const float east = GPS_homeOffsetCm[LON];
+        GPS_distanceToHome = sqrtf(sq(north) + sq(east)) / 100;
+
+        // bearing from the current position back to home, 1deg = 100 precision
+        int32_t dir = 9000.0f + atan2_approx(north, -east) * TAN_89_99_DEGREES;
+        if (dir < 0) {
+            dir += 36000;
+        }
         GPS_directionToHome = dir / 100;
     } else {
         GPS_distanceToHome = 0;
@@ -1575,6 +1673,7 @@ void onGpsNewData(void)
     // prevent runup from bad GPS
     dTnav = MIN(dTnav, 1.0f);
 
+    GPS_updateHomeOffset();
     GPS_calculateDistanceAndDirectionToHome();
     if (ARMING_FLAG(ARMED)) {
         GPS_calculateDistanceFlownVerticalSpeed(false);
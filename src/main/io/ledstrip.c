@@ -464,8 +464,59 @@ static const struct {
     {0,             LED_MODE_ORIENTATION},
 };
 
+// inputs of the fixed layers, these are only recomputed when one of them changes
+typedef struct fixedLayerInputs_s {
+    uint16_t flightModeFlags;
+    bool armed;
+    uint8_t batteryPercent;
+    uint8_t rssiPercent;
+    int16_t auxInput;
+} fixedLayerInputs_t;
+
+static fixedLayerInputs_t fixedLayerInputs;
+static hsvColor_t fixedLayerColors[LED_MAX_STRIP_LENGTH];
+static bool fixedLayersValid = false;
+static bool throttleOverlayUsed = false;
+
+static void invalidateLedFixedLayers(void)
+{
+    fixedLayersValid = false;
+}
+
+static bool updateFixedLayerInputs(void)
+{
+    fixedLayerInputs_t inputs = {
+        .flightModeFlags = flightModeFlags,
+        .armed = ARMING_FLAG(ARMED),
+        .batteryPercent = calculateBatteryPercentageRemaining(),
+        .rssiPercent = getRssiPercent(),
+        // only follow the aux channel when the throttle overlay uses it, so stick noise doesn't force a recompute
+        .auxInput = throttleOverlayUsed ? rcData[ledStripStatusModeConfig()->ledstrip_aux_channel] : 0,
+    };
+
+    const bool changed = !fixedLayersValid
+        || inputs.flightModeFlags != fixedLayerInputs.flightModeFlags
+        || inputs.armed != fixedLayerInputs.armed
+        || inputs.batteryPercent != fixedLayerInputs.batteryPercent
+        || inputs.rssiPercent != fixedLayerInputs.rssiPercent
+        || inputs.auxInput != fixedLayerInputs.auxInput;
+
+    fixedLayerInputs = inputs;
+    fixedLayersValid = true;
+
+    return changed;
+}
+
 static void applyLedFixedLayers(void)
 {
+    if (!updateFixedLayerInputs()) {
+        // nothing the fixed layers depend on changed, restore them from the cache
+        for (int ledIndex = 0; ledIndex < ledCounts.count; ledIndex++) {
+            setLedHsv(ledIndex, &fixedLayerColors[ledIndex]);
+        }
+        return;
+    }
+
     for (int ledIndex = 0; ledIndex < ledCounts.count; ledIndex++) {
         const ledConfig_t *ledConfig = &ledStripStatusModeConfig()->ledConfigs[ledIndex];
         hsvColor_t color = *getSC(LED_SCOLOR_BACKGROUND);
@@ -481,7 +532,7 @@ static void applyLedFixedLayers(void)
             hsvColor_t previousColor = ledStripStatusModeConfig()->colors[(ledGetColor(ledConfig) - 1 + LED_CONFIGURABLE_COLOR_COUNT) % LED_CONFIGURABLE_COLOR_COUNT];
 
             if (ledGetOverlayBit(ledConfig, LED_OVERLAY_THROTTLE)) {   //smooth fade with selected Aux channel of all HSV values from previousColor through color to nextColor
-                const int auxInput = rcData[ledStripStatusModeConfig()->ledstrip_aux_channel];
+                const int auxInput = fixedLayerInputs.auxInput;
                 int centerPWM = (PWM_RANGE_MIN + PWM_RANGE_MAX) / 2;
                 if (auxInput < centerPWM) {
                     color.h = scaleRange(auxInput, PWM_RANGE_MIN, centerPWM, previousColor.h, color.h);
@@ -509,17 +560,17 @@ static void applyLedFixedLayers(void)
             break;
 
         case LED_FUNCTION_ARM_STATE:
-            color = ARMING_FLAG(ARMED) ? *getSC(LED_SCOLOR_ARMED) : *getSC(LED_SCOLOR_DISARMED);
+            color = fixedLayerInputs.armed ? *getSC(LED_SCOLOR_ARMED) : *getSC(LED_SCOLOR_DISARMED);
             break;
 
         case LED_FUNCTION_BATTERY:
             color = HSV(RED);
-            hOffset += MAX(scaleRange(calculateBatteryPercentageRemaining(), 0, 100, -30, 120), 0);
+            hOffset += MAX(scaleRange(fixedLayerInputs.batteryPercent, 0, 100, -30, 120), 0);
             break;
 
         case LED_FUNCTION_RSSI:
             color = HSV(RED);
-            hOffset += MAX(scaleRange(getRssiPercent(), 0, 100, -30, 120), 0);
+            hOffset += MAX(scaleRange(fixedLayerInputs.rssiPercent, 0, 100, -30, 120), 0);
             break;
 
         default:
@@ -527,11 +578,12 @@ static void applyLedFixedLayers(void)
         }
 
         if ((fn != LED_FUNCTION_COLOR) && ledGetOverlayBit(ledConfig, LED_OVERLAY_THROTTLE)) {
-            const int auxInput = rcData[ledStripStatusModeConfig()->ledstrip_aux_channel];
+            const int auxInput = fixedLayerInputs.auxInput;
             hOffset += scaleRange(auxInput, PWM_RANGE_MIN, PWM_RANGE_MAX, 0, HSV_HUE_MAX + 1);
         }
 
         color.h = (color.h + hOffset) % (HSV_HUE_MAX + 1);
+        fixedLayerColors[ledIndex] = color;
         setLedHsv(ledIndex, &color);
     }
 }
@@ -1042,6 +1094,9 @@ void updateRequiredOverlay(void)
     disabledTimerMask |= !isOverlayTypeUsed(LED_OVERLAY_VTX) << timVtx;
 #endif
     disabledTimerMask |= !isOverlayTypeUsed(LED_OVERLAY_INDICATOR) << timIndicator;
+
+    throttleOverlayUsed = isOverlayTypeUsed(LED_OVERLAY_THROTTLE);
+    invalidateLedFixedLayers();
 }
 
 static void applyStatusProfile(timeUs_t now) {
@@ -1118,6 +1173,8 @@ bool parseColor(int index, const char *colorConfig)
         memset(color, 0, sizeof(*color));
     }
 
+    invalidateLedFixedLayers();
+
     return result;
 }
 
@@ -1144,6 +1201,9 @@ bool setModeColor(ledModeIndex_e modeIndex, int modeColorIndex, int colorIndex)
     } else {
         return false;
     }
+
+    invalidateLedFixedLayers();
+
     return true;
 }
 #endif
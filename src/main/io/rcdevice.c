@@ -172,11 +172,45 @@ static void runcamDeviceSendPacket(runcamDevice_t *device, uint8_t command, uint
     serialWriteBuf(device->serialPort, sbufPtr(&buf), sbufBytesRemaining(&buf));
 }
 
+static void runcamSplitSendCommand(runcamDevice_t *device, uint8_t argument);
+
+// Only the request at the front of the queue is on the wire, the ones behind it are sent
+// when it completes so their responses can't get mixed up in the shared receive buffer.
+static void rcdeviceSendFrontRequest(timeMs_t currentTimeMs)
+{
+    rcdeviceResponseParseContext_t *respCtx = rcdeviceRespCtxQueuePeekFront(&waitingResponseQueue);
+    if (respCtx == NULL) {
+        return;
+    }
+
+    runcamDeviceFlushRxBuffer(respCtx->device);
+
+    respCtx->recvRespLen = 0;
+    respCtx->timeoutTimestamp = currentTimeMs + respCtx->timeout;
+
+    if (respCtx->protocolVersion == RCDEVICE_PROTOCOL_VERSION_1_0) {
+        runcamDeviceSendPacket(respCtx->device, respCtx->command, respCtx->paramData, respCtx->paramDataLen);
+    } else if (respCtx->protocolVersion == RCDEVICE_PROTOCOL_RCSPLIT_VERSION) {
+        runcamSplitSendCommand(respCtx->device, respCtx->command);
+    }
+}
+
+static void rcdeviceQueueRequest(rcdeviceResponseParseContext_t *respCtx)
+{
+    if (rcdeviceRespCtxQueuePush(&waitingResponseQueue, respCtx) && waitingResponseQueue.itemCount == 1) {
+        rcdeviceSendFrontRequest(millis());
+    }
+}
+
+static void rcdeviceFinishFrontRequest(timeMs_t currentTimeMs)
+{
+    rcdeviceRespCtxQueueShift(&waitingResponseQueue);
+    rcdeviceSendFrontRequest(currentTimeMs);
+}
+
 // a common way to send a packet to device, and get response from the device.
 static void runcamDeviceSendRequestAndWaitingResp(runcamDevice_t *device, uint8_t commandID, uint8_t *paramData, uint8_t paramDataLen, timeMs_t tiemout, int maxRetryTimes, void *userInfo, rcdeviceRespParseFunc parseFunc)
 {
-    runcamDeviceFlushRxBuffer(device);
-
     rcdeviceResponseParseContext_t responseCtx;
     memset(&responseCtx, 0, sizeof(rcdeviceResponseParseContext_t));
     responseCtx.recvBuf = recvBuf;
@@ -184,7 +218,6 @@ static void runcamDeviceSendRequestAndWaitingResp(runcamDevice_t *device, uint8_
     responseCtx.maxRetryTimes = maxRetryTimes;
     responseCtx.expectedRespLen = runcamDeviceGetRespLen(commandID);
     responseCtx.timeout = tiemout;
-    responseCtx.timeoutTimestamp = millis() + tiemout;
     responseCtx.parserFunc = parseFunc;
     responseCtx.device = device;
     responseCtx.protocolVersion = RCDEVICE_PROTOCOL_VERSION_1_0;
@@ -194,10 +227,7 @@ static void runcamDeviceSendRequestAndWaitingResp(runcamDevice_t *device, uint8_
     }
 
     responseCtx.userInfo = userInfo;
-    if (rcdeviceRespCtxQueuePush(&waitingResponseQueue, &responseCtx)) {
-        // send packet
-        runcamDeviceSendPacket(device, commandID, paramData, paramDataLen);
-    }
+    rcdeviceQueueRequest(&responseCtx);
 }
 
 static void runcamDeviceParseV1DeviceInfo(rcdeviceResponseParseContext_t *ctx)
@@ -254,8 +284,6 @@ static void runcamSplitSendCommand(runcamDevice_t *device, uint8_t argument)
 static void runcamDeviceParseV2DeviceInfo(rcdeviceResponseParseContext_t *ctx)
 {
     if (ctx->result != RCDEVICE_RESP_SUCCESS) {
-        runcamDeviceFlushRxBuffer(ctx->device);
-
         rcdeviceResponseParseContext_t responseCtx;
         memset(&responseCtx, 0, sizeof(rcdeviceResponseParseContext_t));
         responseCtx.recvBuf = recvBuf;
@@ -263,13 +291,11 @@ static void runcamDeviceParseV2DeviceInfo(rcdeviceResponseParseContext_t *ctx)
         responseCtx.maxRetryTimes = rcdeviceConfig()->initDeviceAttempts;
         responseCtx.expectedRespLen = 5;
         responseCtx.timeout = rcdeviceConfig()->initDeviceAttemptInterval;
-        responseCtx.timeoutTimestamp = millis() + rcdeviceConfig()->initDeviceAttemptInterval;
         responseCtx.parserFunc = runcamDeviceParseV1DeviceInfo;
         responseCtx.device = ctx->device;
         responseCtx.protocolVersion = RCDEVICE_PROTOCOL_RCSPLIT_VERSION;
-        rcdeviceRespCtxQueuePush(&waitingResponseQueue, &responseCtx);
-
-        runcamSplitSendCommand(ctx->device, 0xFF);
+        // sent once the failed request has left the queue
+        rcdeviceQueueRequest(&responseCtx);
         return;
     }
     runcamDevice_t *device = ctx->device;
@@ -356,14 +382,7 @@ static rcdeviceResponseParseContext_t* getWaitingResponse(timeMs_t currentTimeMs
     rcdeviceResponseParseContext_t *respCtx = rcdeviceRespCtxQueuePeekFront(&waitingResponseQueue);
     while (respCtx != NULL && respCtx->timeoutTimestamp != 0 && currentTimeMs > respCtx->timeoutTimestamp) {
         if (respCtx->maxRetryTimes > 0) {
-            if (respCtx->protocolVersion == RCDEVICE_PROTOCOL_VERSION_1_0) {
-                runcamDeviceSendPacket(respCtx->device, respCtx->command, respCtx->paramData, respCtx->paramDataLen);
-            } else if (respCtx->protocolVersion == RCDEVICE_PROTOCOL_RCSPLIT_VERSION) {
-                runcamSplitSendCommand(respCtx->device, respCtx->command);
-            }
-
-            respCtx->recvRespLen = 0;
-            respCtx->timeoutTimestamp = currentTimeMs + respCtx->timeout;
+            rcdeviceSendFrontRequest(currentTimeMs);
             respCtx->maxRetryTimes -= 1;
             respCtx = NULL;
             break;
@@ -373,8 +392,8 @@ static rcdeviceResponseParseContext_t* getWaitingResponse(timeMs_t currentTimeMs
                 respCtx->parserFunc(respCtx);
             }
 
-            // dequeue and get next waiting response context
-            rcdeviceRespCtxQueueShift(&waitingResponseQueue);
+            // dequeue and send the next waiting request
+            rcdeviceFinishFrontRequest(currentTimeMs);
             respCtx = rcdeviceRespCtxQueuePeekFront(&waitingResponseQueue);
         }
     }
@@ -440,9 +459,9 @@ void rcdeviceReceive(timeUs_t currentTimeUs)
                 respCtx->parserFunc(respCtx);
             }
 
-            if (respCtx->result == RCDEVICE_RESP_SUCCESS) {
-                rcdeviceRespCtxQueueShift(&waitingResponseQueue);
-            }
+            // the parser has been told about a bad CRC as well, and the request must not keep
+            // collecting bytes beyond the expected length until it times out
+            rcdeviceFinishFrontRequest(millis());
         }
     }
 
@@ -117,7 +117,7 @@ typedef struct runcamDevice_s {
     bool isReady;
 } runcamDevice_t;
 
-#define MAX_WAITING_RESPONSES 1
+#define MAX_WAITING_RESPONSES 4
 
 typedef enum {
     RCDEVICE_RESP_SUCCESS = 0,
@@ -241,6 +241,11 @@ static void rcdevice5KeySimulationProcess(timeUs_t currentTimeUs)
     }
 
     if (isButtonPressed) {
+        // a release already on its way is not sent again
+        if (waitingDeviceResponse) {
+            return;
+        }
+
         if (IS_MID(YAW) && IS_MID(PITCH) && IS_MID(ROLL)) {
             rcdeviceSend5KeyOSDCableSimualtionEvent(RCDEVICE_CAM_KEY_RELEASE);
             waitingDeviceResponse = true;
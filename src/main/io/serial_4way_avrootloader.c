@@ -68,6 +68,8 @@
 
 #define START_BIT_TIMEOUT_MS 2
 
+// The bootloaders run at a fixed 19200 baud, this and the one ESC the host talks to at a time limit the flashing
+// speed, not the time spent here between the bits
 #define BIT_TIME (52)       // 52uS
 #define BIT_TIME_HALVE      (BIT_TIME >> 1) // 26uS
 #define BIT_TIME_3_4        (BIT_TIME_HALVE + (BIT_TIME_HALVE >> 1))   // 39uS
@@ -42,6 +42,8 @@
 
 #include "io/transponder_ir.h"
 
+#include "scheduler/scheduler.h"
+
 PG_REGISTER_WITH_RESET_FN(transponderConfig_t, transponderConfig, PG_TRANSPONDER_CONFIG, 0);
 
 void pgResetFn_transponderConfig(transponderConfig_t *transponderConfig)
@@ -61,6 +63,10 @@ static bool transponderRepeat = false;
 // timers
 static timeUs_t nextUpdateAtUs = 0;
 
+// The task sleeps until the next transmission is due instead of polling for it
+#define TRANSPONDER_IDLE_TASK_PERIOD_US (1000 * 1000 / 10)
+#define TRANSPONDER_BUSY_TASK_PERIOD_US (1000 * 1000 / 250)
+
 #define JITTER_DURATION_COUNT (sizeof(jitterDurations) / sizeof(uint8_t))
 static uint8_t jitterDurations[] = {0,9,4,8,3,9,6,7,1,6,9,7,8,2,6};
 
@@ -74,12 +80,19 @@ void transponderUpdate(timeUs_t currentTimeUs)
 {
     static uint32_t jitterIndex = 0;
 
-    if (!(transponderInitialised && transponderRepeat && isTransponderIrReady())) {
+    if (!(transponderInitialised && transponderRepeat)) {
+        rescheduleTask(TASK_SELF, TRANSPONDER_IDLE_TASK_PERIOD_US);
+        return;
+    }
+
+    const timeDelta_t timeToUpdateUs = cmpTimeUs(nextUpdateAtUs, currentTimeUs);
+    if (timeToUpdateUs > 0) {
+        rescheduleTask(TASK_SELF, timeToUpdateUs);
         return;
     }
 
-    const bool updateNow = (timeDelta_t)(currentTimeUs - nextUpdateAtUs) >= 0L;
-    if (!updateNow) {
+    if (!isTransponderIrReady()) {
+        rescheduleTask(TASK_SELF, TRANSPONDER_BUSY_TASK_PERIOD_US);
         return;
     }
 
@@ -101,6 +114,8 @@ void transponderUpdate(timeUs_t currentTimeUs)
 #endif
 
     transponderIrTransmit();
+
+    rescheduleTask(TASK_SELF, cmpTimeUs(nextUpdateAtUs, currentTimeUs));
 }
 
 void transponderInit(void)
@@ -506,9 +506,7 @@ static void saSendFrame(uint8_t *buf, int len)
             break;
         }
 
-        for (int i = 0 ; i < len ; i++) {
-            serialWrite(smartAudioSerialPort, buf[i]);
-        }
+        serialWriteBuf(smartAudioSerialPort, buf, len);
 
         saStat.pktsent++;
     } else {
@@ -534,6 +532,12 @@ static void saSendFrame(uint8_t *buf, int len)
  * command is outstanding must be queued for later processing.
  *   The queueing also handles the case in which multiple commands are
  * required to implement a user level command.
+ *
+ * Command coalescing:
+ *   Each command is built in its own static buffer, so a queued entry always
+ * sends the latest value written to it. vtx.c re-issues a setting on every
+ * pass until the device reports it, so a command whose buffer is already
+ * queued is not queued again and each change costs a single round trip.
  */
 
 // Retransmission
@@ -577,8 +581,29 @@ static bool saQueueFull(void)
     return ((sa_qhead + 1) % SA_QSIZE) == sa_qtail;
 }
 
+static bool saQueueContains(const uint8_t *buf)
+{
+    for (uint8_t i = sa_qtail; i != sa_qhead; i = (i + 1) % SA_QSIZE) {
+        if (sa_queue[i].buf == buf) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 static void saQueueCmd(uint8_t *buf, int len)
 {
+    if (buf[2] == SACMD(SA_CMD_GET_SETTINGS)) {
+        // GetSettings orders the set-freq workaround, so only coalesce it with the entry just before it
+        if (!saQueueEmpty() && sa_queue[(sa_qhead + SA_QSIZE - 1) % SA_QSIZE].buf == buf) {
+            return;
+        }
+    } else if (saQueueContains(buf)) {
+        // Already pending and the buffer now holds the latest value
+        return;
+    }
+
     if (saQueueFull()) {
         return;
     }
@@ -701,9 +726,9 @@ bool vtxSmartAudioInit(void)
     if (portConfig) {
         portOptions_e portOptions = SERIAL_STOPBITS_2 | SERIAL_BIDIR_NOPULL;
 #if defined(USE_VTX_COMMON)
-        portOptions = portOptions | (vtxConfig()->halfDuplex ? SERIAL_BIDIR | SERIAL_BIDIR_PP : SERIAL_UNIDIR);
+        portOptions = portOptions | (vtxConfig()->halfDuplex ? SERIAL_BIDIR | SERIAL_BIDIR_PP | SERIAL_BIDIR_NOECHO : SERIAL_UNIDIR);
 #else
-        portOptions = SERIAL_BIDIR;
+        portOptions = SERIAL_BIDIR | SERIAL_BIDIR_NOECHO;
 #endif
 
         smartAudioSerialPort = openSerialPort(portConfig->identifier, FUNCTION_VTX_SMARTAUDIO, NULL, NULL, 4800, MODE_RXTX, portOptions);
@@ -43,7 +43,9 @@ void FAST_CODE FAST_CODE_NOINLINE run(void)
     while (true) {
         scheduler();
         processLoopback();
-#ifdef SIMULATOR_BUILD
+#if defined(SIMULATOR_LOCKSTEP)
+        lockstepAdvance();
+#elif defined(SIMULATOR_BUILD)
         delayMicroseconds_real(50); // max rate 20kHz
 #endif
     }
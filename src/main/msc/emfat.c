@@ -600,7 +600,10 @@ void fill_dir_sector(emfat_t *emfat, uint8_t *data, emfat_entry_t *entry, uint32
     }
 }
 
-void read_data_sector(emfat_t *emfat, uint8_t *data, uint32_t rel_sect)
+// Reads up to num_sectors consecutive data sectors, returns how many were read (at least one).
+// Runs of sectors inside the same file are passed to its read callback in one call so that the backing
+// store (e.g. flash) can service them with a single bulk transfer.
+int read_data_sectors(emfat_t *emfat, uint8_t *data, uint32_t rel_sect, int num_sectors)
 {
     emfat_entry_t *le;
     uint32_t cluster;
@@ -614,32 +617,46 @@ void read_data_sector(emfat_t *emfat, uint8_t *data, uint32_t rel_sect)
             int i;
             for (i = 0; i < SECT / 4; i++)
                 ((uint32_t *)data)[i] = 0xEFBEADDE;
-            return;
+            return 1;
         }
         emfat->priv.last_entry = le;
     }
 
     if (le->dir) {
         fill_dir_sector(emfat, data, le, rel_sect);
-        return;
+        return 1;
     }
 
     if (le->readcb == NULL) {
         memset(data, 0, SECT);
-    } else {
-        uint32_t offset = cluster - le->priv.first_clust;
-        offset = offset * CLUST + rel_sect * SECT;
-        le->readcb(data, SECT, offset + le->offset, le);
+        return 1;
     }
 
-    return;
+    // Only coalesce within the clusters holding the file content, reserved space is read sector by sector
+    int count = 1;
+    if (cluster <= le->priv.last_clust) {
+        const uint32_t sectorsLeftInFile = (le->priv.last_clust - cluster + 1) * 8 - rel_sect;
+        if (sectorsLeftInFile < (uint32_t)num_sectors) {
+            count = sectorsLeftInFile;
+        } else {
+            count = num_sectors;
+        }
+    }
+
+    uint32_t offset = cluster - le->priv.first_clust;
+    offset = offset * CLUST + rel_sect * SECT;
+    le->readcb(data, count * SECT, offset + le->offset, le);
+
+    return count;
 }
 
 void emfat_read(emfat_t *emfat, uint8_t *data, uint32_t sector, int num_sectors)
 {
     while (num_sectors > 0) {
+        int count = 1;
+
         if (sector >= emfat->priv.root_lba) {
-            read_data_sector(emfat, data, sector - emfat->priv.root_lba);
+            count = read_data_sectors(emfat, data, sector - emfat->priv.root_lba, num_sectors);
         } else if (sector == 0) {
             read_mbr_sector(emfat, data);
         } else if (sector == emfat->priv.fsinfo_lba) {
@@ -653,9 +670,9 @@ void emfat_read(emfat_t *emfat, uint8_t *data, uint32_t sector, int num_sectors)
         } else {
             memset(data, 0, SECT);
         }
-        data += SECT;
-        num_sectors--;
-        sector++;
+        data += count * SECT;
+        num_sectors -= count;
+        sector += count;
     }
 }
 
@@ -252,7 +252,18 @@ static void bblog_read_proc(uint8_t *dest, int size, uint32_t offset, emfat_entr
 {
     UNUSED(entry);
 
-    flashfsReadAbs(offset, dest, size);
+    // Multi-sector requests arrive here in one piece, some flash drivers return short reads at page boundaries
+    while (size > 0) {
+        const int bytesRead = flashfsReadAbs(offset, dest, size);
+        if (bytesRead <= 0) {
+            // Past the end of the volume
+            memset(dest, 0xFF, size);
+            break;
+        }
+        dest += bytesRead;
+        offset += bytesRead;
+        size -= bytesRead;
+    }
 }
 
 static const emfat_entry_t entriesPredefined[] =
@@ -32,6 +32,7 @@
 
 #include "build/build_config.h"
 #include "build/debug.h"
+#include "build/pc_sampling.h"
 #include "build/version.h"
 
 #include "cli/cli.h"
@@ -39,6 +40,7 @@
 #include "common/axis.h"
 #include "common/bitarray.h"
 #include "common/color.h"
+#include "common/crc.h"
 #include "common/huffman.h"
 #include "common/maths.h"
 #include "common/streambuf.h"
@@ -59,11 +61,14 @@
 #include "drivers/io.h"
 #include "drivers/motor.h"
 #include "drivers/osd.h"
+#include "drivers/persistent.h"
 #include "drivers/pwm_output.h"
 #include "drivers/sdcard.h"
 #include "drivers/serial.h"
 #include "drivers/serial_escserial.h"
+#include "drivers/stack_check.h"
 #include "drivers/system.h"
+#include "drivers/time.h"
 #include "drivers/transponder_ir.h"
 #include "drivers/usb_msc.h"
 #include "drivers/vtx_common.h"
@@ -115,6 +120,7 @@
 #include "pg/board.h"
 #include "pg/gyrodev.h"
 #include "pg/motor.h"
+#include "pg/pg.h"
 #include "pg/rx.h"
 #include "pg/rx_spi.h"
 #include "pg/usb.h"
@@ -193,6 +199,8 @@ typedef enum {
 
 #define RTC_NOT_SUPPORTED 0xff
 
+#define MSP_TASK_HISTOGRAM_CHECK_FUNC 0xff
+
 typedef enum {
     DEFAULTS_TYPE_BASE = 0,
     DEFAULTS_TYPE_CUSTOM,
@@ -465,7 +473,22 @@ enum compressionType_e {
     HUFFMAN
 };
 
-static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uint16_t size, bool useLegacyFormat, bool allowCompression)
+// State of a windowed MSP_DATAFLASH_READ, chunks are pushed to the reader without waiting for further requests
+typedef struct mspDataflashStream_s {
+    mspDescriptor_t srcDesc;
+    uint32_t address;
+    uint16_t size;
+    uint8_t chunksRemaining;
+    bool allowCompression;
+} mspDataflashStream_t;
+
+static mspDataflashStream_t dataflashStream;
+
+/*
+ * Returns the number of bytes of flash consumed by the reply, which is the address the next chunk should be read from
+ * relative to the address of this one.
+ */
+static uint32_t serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uint16_t size, bool useLegacyFormat, bool allowCompression)
 {
     STATIC_ASSERT(MSP_PORT_DATAFLASH_INFO_SIZE >= 16, MSP_PORT_DATAFLASH_INFO_SIZE_invalid);
 
@@ -514,6 +537,8 @@ static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uin
                 sbufWriteU8(dst, 0);
             }
         }
+
+        return bytesRead;
     } else {
 #ifdef USE_HUFFMAN
         // compress in 256-byte chunks
@@ -553,6 +578,10 @@ static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uin
         // payload
         sbufWriteU16(dst, bytesReadTotal);
         sbufAdvance(dst, state.bytesWritten);
+
+        return bytesReadTotal;
+#else
+        return 0;
 #endif
     }
 }
@@ -717,8 +746,8 @@ static bool mspCommonProcessOutCommand(int16_t cmdMSP, sbuf_t *dst, mspPostProce
         break;
 
     case MSP_DEBUG:
-        for (int i = 0; i < DEBUG16_VALUE_COUNT; i++) {
-            sbufWriteU16(dst, debug[i]);      // 4 variables are here for general monitoring purpose
+        for (int i = 0; i < DEBUG_GROUP_VALUE_COUNT; i++) {
+            sbufWriteU16(dst, debug[i]);      // 4 variables of the first debug mode are here for general monitoring purpose
         }
         break;
 
@@ -1200,6 +1229,41 @@ static bool mspProcessOutCommand(int16_t cmdMSP, sbuf_t *dst)
         }
         break;
 
+#ifdef USE_PC_SAMPLING
+    case MSP2_PC_SAMPLES:
+        {
+            // the host polls until the reply is short, the samples left behind are sent with the next one
+            sbufWriteU16(dst, pcSamplingLostCount());
+
+            uint32_t pc;
+            while (sbufBytesRemaining(dst) >= (int)sizeof(pc) && pcSamplingRead(&pc)) {
+                sbufWriteU32(dst, pc);
+            }
+        }
+        break;
+#endif
+
+    case MSP2_STACK_STATS:
+        sbufWriteU32(dst, stackTotalSize());
+#ifdef USE_STACK_CHECK
+        sbufWriteU32(dst, stackUsedSize());
+        sbufWriteU8(dst, STACK_CHECK_IRQ_LEVELS);
+        for (unsigned level = 0; level < STACK_CHECK_IRQ_LEVELS; level++) {
+            sbufWriteU32(dst, stackIrqUsedSize(level));
+        }
+#else
+        sbufWriteU32(dst, 0);
+        sbufWriteU8(dst, 0);
+#endif
+        for (persistentObjectId_e id = PERSISTENT_OBJECT_FAULT_PC; id <= PERSISTENT_OBJECT_FAULT_ADDRESS; id++) {
+#ifdef USE_PERSISTENT_OBJECTS
+            sbufWriteU32(dst, persistentObjectRead(id));
+#else
+            sbufWriteU32(dst, 0);
+#endif
+        }
+        break;
+
     case MSP_RC:
         for (int i = 0; i < rxRuntimeState.channelCount; i++) {
             sbufWriteU16(dst, rcData[i]);
@@ -1737,7 +1801,7 @@ static bool mspProcessOutCommand(int16_t cmdMSP, sbuf_t *dst)
         // Added in MSP API 1.42
 #if defined(USE_GYRO_DATA_ANALYSE)
         sbufWriteU8(dst, 0); // DEPRECATED 1.43: dyn_notch_range
-        sbufWriteU8(dst, gyroConfig()->dyn_notch_width_percent);
+        sbufWriteU8(dst, 0); // DEPRECATED 1.44: dyn_notch_width_percent
         sbufWriteU16(dst, gyroConfig()->dyn_notch_q);
         sbufWriteU16(dst, gyroConfig()->dyn_notch_min_hz);
 #else
@@ -1765,6 +1829,12 @@ static bool mspProcessOutCommand(int16_t cmdMSP, sbuf_t *dst)
 #else
         sbufWriteU8(dst, 0);
 #endif
+#if defined(USE_GYRO_DATA_ANALYSE)
+        // Added in MSP API 1.44
+        sbufWriteU8(dst, gyroConfig()->dyn_notch_count);
+#else
+        sbufWriteU8(dst, 0);
+#endif
 
         break;
     case MSP_PID_ADVANCED:
@@ -1962,6 +2032,59 @@ static bool mspProcessOutCommand(int16_t cmdMSP, sbuf_t *dst)
     return !unsupportedCommand;
 }
 
+// Size of the MSP2_PG_READ and MSP2_PG_WRITE header in front of the group data
+#define MSP_PG_TRANSFER_HEADER_SIZE 9
+
+static mspResult_e mspFcPgReadCommand(sbuf_t *dst, sbuf_t *src)
+{
+    if (sbufBytesRemaining(src) < 4) {
+        return MSP_RESULT_ERROR;
+    }
+    const pgRegistry_t *pg = pgFind(sbufReadU16(src));
+    const uint16_t offset = sbufReadU16(src);
+    if (!pg || offset > pgSize(pg)) {
+        return MSP_RESULT_ERROR;
+    }
+
+    const uint16_t length = MIN(pgSize(pg) - offset, sbufBytesRemaining(dst) - MSP_PG_TRANSFER_HEADER_SIZE);
+    sbufWriteU16(dst, pgN(pg));
+    sbufWriteU8(dst, pgVersion(pg));
+    sbufWriteU16(dst, pgSize(pg));
+    sbufWriteU16(dst, crc16_ccitt_update(0, pg->address, pgSize(pg)));
+    sbufWriteU16(dst, offset);
+    sbufWriteData(dst, pg->address + offset, length);
+
+    return MSP_RESULT_ACK;
+}
+
+static mspResult_e mspFcPgWriteCommand(sbuf_t *src)
+{
+    if (ARMING_FLAG(ARMED) || sbufBytesRemaining(src) < MSP_PG_TRANSFER_HEADER_SIZE) {
+        return MSP_RESULT_ERROR;
+    }
+    const pgRegistry_t *pg = pgFind(sbufReadU16(src));
+    const uint8_t version = sbufReadU8(src);
+    const uint16_t size = sbufReadU16(src);
+    const uint16_t crc = sbufReadU16(src);
+    const uint16_t offset = sbufReadU16(src);
+    const uint16_t length = sbufBytesRemaining(src);
+    // Only a group stored by the same firmware layout can be taken as is
+    if (!pg || version != pgVersion(pg) || size != pgSize(pg) || offset + length > size) {
+        return MSP_RESULT_ERROR;
+    }
+
+    // Chunks are collected in the copy so that the group only changes once all of it has arrived intact
+    sbufReadData(src, pg->copy + offset, length);
+    if (offset + length == size) {
+        if (crc16_ccitt_update(0, pg->copy, size) != crc) {
+            return MSP_RESULT_ERROR;
+        }
+        memcpy(pg->address, pg->copy, size);
+    }
+
+    return MSP_RESULT_ACK;
+}
+
 static mspResult_e mspFcProcessOutCommandWithArg(mspDescriptor_t srcDesc, int16_t cmdMSP, sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
 {
 
@@ -2012,6 +2135,33 @@ static mspResult_e mspFcProcessOutCommandWithArg(mspDescriptor_t srcDesc, int16_
         }
 
         break;
+    case MSP2_PG_READ:
+        return mspFcPgReadCommand(dst, src);
+
+#if defined(USE_TASK_STATISTICS)
+    case MSP2_TASK_HISTOGRAM:
+        {
+            if (sbufBytesRemaining(src) == 0) {
+                return MSP_RESULT_ERROR;
+            }
+            const uint8_t taskId = sbufReadU8(src);
+            taskHistogram_t histogram;
+            if (taskId == MSP_TASK_HISTOGRAM_CHECK_FUNC) {
+                getCheckFuncHistogram(&histogram);
+            } else if (taskId < TASK_COUNT) {
+                getTaskHistogram(taskId, &histogram);
+            } else {
+                return MSP_RESULT_ERROR;
+            }
+
+            sbufWriteU8(dst, taskId);
+            sbufWriteU8(dst, TASK_STATS_HISTOGRAM_BUCKET_COUNT);
+            for (int i = 0; i < TASK_STATS_HISTOGRAM_BUCKET_COUNT; i++) {
+                sbufWriteU16(dst, histogram.count[i]);
+            }
+        }
+        break;
+#endif
     case MSP_MULTIPLE_MSP:
         {
             uint8_t maxMSPs = 0;
@@ -2126,28 +2276,133 @@ static mspResult_e mspFcProcessOutCommandWithArg(mspDescriptor_t srcDesc, int16_
 }
 
 #ifdef USE_FLASHFS
-static void mspFcDataFlashReadCommand(sbuf_t *dst, sbuf_t *src)
+static void mspFcDataFlashReadCommand(mspDescriptor_t srcDesc, sbuf_t *dst, sbuf_t *src)
 {
     const unsigned int dataSize = sbufBytesRemaining(src);
     const uint32_t readAddress = sbufReadU32(src);
     uint16_t readLength;
     bool allowCompression = false;
+    uint8_t chunkCount = 1;
     bool useLegacyFormat;
     if (dataSize >= sizeof(uint32_t) + sizeof(uint16_t)) {
         readLength = sbufReadU16(src);
         if (sbufBytesRemaining(src)) {
             allowCompression = sbufReadU8(src);
         }
+        if (sbufBytesRemaining(src)) {
+            // Number of consecutive chunks to stream back without further requests
+            chunkCount = MAX(sbufReadU8(src), 1);
+        }
         useLegacyFormat = false;
     } else {
         readLength = 128;
         useLegacyFormat = true;
     }
 
-    serializeDataflashReadReply(dst, readAddress, readLength, useLegacyFormat, allowCompression);
+    const uint32_t bytesConsumed = serializeDataflashReadReply(dst, readAddress, readLength, useLegacyFormat, allowCompression);
+
+    // Any new read request replaces a stream that is still in progress
+    dataflashStream.srcDesc = srcDesc;
+    dataflashStream.address = readAddress + bytesConsumed;
+    dataflashStream.size = readLength;
+    dataflashStream.allowCompression = allowCompression;
+    dataflashStream.chunksRemaining = bytesConsumed ? chunkCount - 1 : 0;
 }
 #endif
 
+#define MSP_MAX_SUBSCRIBED_COMMANDS 8
+
+// State of an MSP2_SUBSCRIBE, the subscribed replies are pushed to the subscriber once per interval
+typedef struct mspSubscription_s {
+    mspDescriptor_t srcDesc;
+    uint16_t intervalMs;
+    timeMs_t roundStartMs;
+    uint8_t count;
+    uint8_t next;
+    uint16_t cmd[MSP_MAX_SUBSCRIBED_COMMANDS];
+} mspSubscription_t;
+
+static mspSubscription_t subscription;
+
+static mspResult_e mspFcSubscribeCommand(mspDescriptor_t srcDesc, sbuf_t *src)
+{
+    // An interval with no commands, or an interval of 0, ends the subscription
+    if (sbufBytesRemaining(src) < 2 || sbufBytesRemaining(src) > (int)sizeof(uint16_t) * (MSP_MAX_SUBSCRIBED_COMMANDS + 1)) {
+        return MSP_RESULT_ERROR;
+    }
+
+    subscription.srcDesc = srcDesc;
+    subscription.intervalMs = sbufReadU16(src);
+    subscription.count = 0;
+    while (sbufBytesRemaining(src) >= 2) {
+        subscription.cmd[subscription.count++] = sbufReadU16(src);
+    }
+    if (!subscription.intervalMs) {
+        subscription.count = 0;
+    }
+    subscription.next = 0;
+    subscription.roundStartMs = millis() - subscription.intervalMs;
+
+    return MSP_RESULT_ACK;
+}
+
+static mspResult_e mspFcProcessSubscription(mspPacket_t *reply)
+{
+    if (subscription.next == 0) {
+        const timeMs_t currentTimeMs = millis();
+        if (currentTimeMs - subscription.roundStartMs < subscription.intervalMs) {
+            return MSP_RESULT_NO_REPLY;
+        }
+        subscription.roundStartMs = currentTimeMs;
+    }
+
+    const uint16_t cmdMSP = subscription.cmd[subscription.next];
+    subscription.next = (subscription.next + 1) % subscription.count;
+
+    // Only commands without arguments or side effects can be subscribed to, anything else is skipped
+    mspPostProcessFnPtr mspPostProcessFn = NULL;
+    if (!mspCommonProcessOutCommand(cmdMSP, &reply->buf, &mspPostProcessFn) && !mspProcessOutCommand(cmdMSP, &reply->buf)) {
+        return MSP_RESULT_NO_REPLY;
+    }
+
+    reply->cmd = cmdMSP;
+    reply->result = MSP_RESULT_ACK;
+    return MSP_RESULT_ACK;
+}
+
+/*
+ * Produces the next unsolicited reply of a stream started by an earlier command on srcDesc.
+ * Returns MSP_RESULT_NO_REPLY if there is nothing to send.
+ */
+mspResult_e mspFcProcessStream(mspDescriptor_t srcDesc, mspPacket_t *reply)
+{
+#ifdef USE_FLASHFS
+    if (dataflashStream.chunksRemaining && dataflashStream.srcDesc == srcDesc) {
+        if (ARMING_FLAG(ARMED)) {
+            // Don't compete with the logger for the flash chip in flight
+            dataflashStream.chunksRemaining = 0;
+            return MSP_RESULT_NO_REPLY;
+        }
+
+        const uint32_t bytesConsumed = serializeDataflashReadReply(&reply->buf, dataflashStream.address, dataflashStream.size, false, dataflashStream.allowCompression);
+
+        dataflashStream.address += bytesConsumed;
+        // An empty chunk tells the reader the end of the volume was reached
+        dataflashStream.chunksRemaining = bytesConsumed ? dataflashStream.chunksRemaining - 1 : 0;
+
+        reply->cmd = MSP_DATAFLASH_READ;
+        reply->result = MSP_RESULT_ACK;
+        return MSP_RESULT_ACK;
+    }
+#endif
+
+    if (subscription.count && subscription.srcDesc == srcDesc) {
+        return mspFcProcessSubscription(reply);
+    }
+
+    return MSP_RESULT_NO_REPLY;
+}
+
 static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, int16_t cmdMSP, sbuf_t *src)
 {
     uint32_t i;
@@ -2402,6 +2657,12 @@ static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, int16_t cmdMSP,
 #endif
 #endif
 
+    case MSP2_SUBSCRIBE:
+        return mspFcSubscribeCommand(srcDesc, src);
+
+    case MSP2_PG_WRITE:
+        return mspFcPgWriteCommand(src);
+
     case MSP_SET_MOTOR:
         for (int i = 0; i < getMotorCount(); i++) {
             motor_disarmed[i] = motorConvertFromExternal(sbufReadU16(src));
@@ -2580,7 +2841,7 @@ static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, int16_t cmdMSP,
             // Added in MSP API 1.42
 #if defined(USE_GYRO_DATA_ANALYSE)
             sbufReadU8(src); // DEPRECATED: dyn_notch_range
-            gyroConfigMutable()->dyn_notch_width_percent = sbufReadU8(src);
+            sbufReadU8(src); // DEPRECATED 1.44: dyn_notch_width_percent
             gyroConfigMutable()->dyn_notch_q = sbufReadU16(src);
             gyroConfigMutable()->dyn_notch_min_hz = sbufReadU16(src);
 #else
@@ -2613,6 +2874,14 @@ static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, int16_t cmdMSP,
             sbufReadU8(src);
 #endif
         }
+        if (sbufBytesRemaining(src) >= 1) {
+            // Added in MSP API 1.44
+#if defined(USE_GYRO_DATA_ANALYSE)
+            gyroConfigMutable()->dyn_notch_count = sbufReadU8(src);
+#else
+            sbufReadU8(src);
+#endif
+        }
 
         // reinitialize the gyro filters with the new values
         validateAndFixGyroConfig();
@@ -3268,6 +3537,7 @@ static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, int16_t cmdMSP,
             color->s = sbufReadU8(src);
             color->v = sbufReadU8(src);
         }
+        reevaluateLedConfig();
         break;
 #endif
 
@@ -3642,6 +3912,31 @@ static mspResult_e mspCommonProcessInCommand(mspDescriptor_t srcDesc, int16_t cm
 /*
  * Returns MSP_RESULT_ACK, MSP_RESULT_ERROR or MSP_RESULT_NO_REPLY
  */
+// Which of the command switches below handles a command only depends on its id, so it is remembered to skip
+// the switches that would not match next time round
+typedef enum {
+    MSP_HANDLER_UNKNOWN = 0,
+    MSP_HANDLER_COMMON_OUT,
+    MSP_HANDLER_OUT,
+    MSP_HANDLER_OUT_WITH_ARG,
+    MSP_HANDLER_IN,
+} mspHandler_e;
+
+#define MSP_HANDLER_CACHE_SIZE 32 // must be a power of 2
+
+typedef struct mspHandlerCacheEntry_s {
+    int16_t cmd;
+    uint8_t handler;
+} mspHandlerCacheEntry_t;
+
+static mspHandlerCacheEntry_t mspHandlerCache[MSP_HANDLER_CACHE_SIZE];
+
+static mspHandlerCacheEntry_t *mspHandlerCacheEntry(int16_t cmdMSP)
+{
+    // Folds the MSPv2 id ranges onto the MSPv1 ones
+    return &mspHandlerCache[(cmdMSP ^ (cmdMSP >> 5) ^ (cmdMSP >> 12)) & (MSP_HANDLER_CACHE_SIZE - 1)];
+}
+
 mspResult_e mspFcProcessCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn)
 {
     int ret = MSP_RESULT_ACK;
@@ -3651,23 +3946,36 @@ mspResult_e mspFcProcessCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPa
     // initialize reply by default
     reply->cmd = cmd->cmd;
 
-    if (mspCommonProcessOutCommand(cmdMSP, dst, mspPostProcessFn)) {
+    mspHandlerCacheEntry_t *cacheEntry = mspHandlerCacheEntry(cmdMSP);
+    const mspHandler_e cachedHandler = cacheEntry->cmd == cmdMSP ? cacheEntry->handler : MSP_HANDLER_UNKNOWN;
+    mspHandler_e handler = MSP_HANDLER_UNKNOWN;
+
+    if ((!cachedHandler || cachedHandler == MSP_HANDLER_COMMON_OUT) && mspCommonProcessOutCommand(cmdMSP, dst, mspPostProcessFn)) {
         ret = MSP_RESULT_ACK;
-    } else if (mspProcessOutCommand(cmdMSP, dst)) {
+        handler = MSP_HANDLER_COMMON_OUT;
+    } else if ((!cachedHandler || cachedHandler == MSP_HANDLER_OUT) && mspProcessOutCommand(cmdMSP, dst)) {
         ret = MSP_RESULT_ACK;
-    } else if ((ret = mspFcProcessOutCommandWithArg(srcDesc, cmdMSP, src, dst, mspPostProcessFn)) != MSP_RESULT_CMD_UNKNOWN) {
-        /* ret */;
+        handler = MSP_HANDLER_OUT;
+    } else if ((!cachedHandler || cachedHandler == MSP_HANDLER_OUT_WITH_ARG) && (ret = mspFcProcessOutCommandWithArg(srcDesc, cmdMSP, src, dst, mspPostProcessFn)) != MSP_RESULT_CMD_UNKNOWN) {
+        handler = MSP_HANDLER_OUT_WITH_ARG;
     } else if (cmdMSP == MSP_SET_PASSTHROUGH) {
         mspFcSetPassthroughCommand(dst, src, mspPostProcessFn);
         ret = MSP_RESULT_ACK;
 #ifdef USE_FLASHFS
     } else if (cmdMSP == MSP_DATAFLASH_READ) {
-        mspFcDataFlashReadCommand(dst, src);
+        mspFcDataFlashReadCommand(srcDesc, dst, src);
         ret = MSP_RESULT_ACK;
 #endif
     } else {
         ret = mspCommonProcessInCommand(srcDesc, cmdMSP, src, mspPostProcessFn);
+        handler = MSP_HANDLER_IN;
+    }
+
+    if (handler) {
+        cacheEntry->cmd = cmdMSP;
+        cacheEntry->handler = handler;
     }
+
     reply->result = ret;
     return ret;
 }
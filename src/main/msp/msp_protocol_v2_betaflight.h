@@ -21,3 +21,9 @@
 #define MSP2_BETAFLIGHT_BIND                0x3000
 #define MSP2_MOTOR_OUTPUT_REORDERING        0x3001
 #define MSP2_SET_MOTOR_OUTPUT_REORDERING    0x3002
+#define MSP2_TASK_HISTOGRAM                 0x3003  //in message  task id, or 255 for the RX check function
+#define MSP2_SUBSCRIBE                      0x3004  //in message  interval in ms and up to 8 command ids to push at that interval
+#define MSP2_PG_READ                        0x3005  //out message raw contents of a parameter group, from an offset
+#define MSP2_PG_WRITE                       0x3006  //in message  raw contents of a parameter group, from an offset
+#define MSP2_PC_SAMPLES                     0x3007  //out message lost sample count and the program counters sampled since the last request
+#define MSP2_STACK_STATS                    0x3008  //out message stack size, stack used, stack used per interrupt priority and the last hard fault context
@@ -28,6 +28,7 @@
 
 #include "cli/cli.h"
 
+#include "common/maths.h"
 #include "common/streambuf.h"
 #include "common/utils.h"
 #include "common/crc.h"
@@ -42,8 +43,33 @@
 
 static mspPort_t mspPorts[MAX_MSP_PORT_COUNT];
 
+#define MSP_MAX_COMMANDS_PER_PROCESS 8
+
+// Shared by all ports, replies are encoded and sent before the next one is built
+static uint8_t mspSerialOutBuf[MSP_PORT_OUTBUF_SIZE];
+
+// Remainder of a reply larger than the free TX buffer space, pushed out by mspSerialProcess as the buffer drains.
+// Its payload points into mspSerialOutBuf so there is at most one, and no other reply is built until it has been sent.
+static struct {
+    mspPort_t *port;
+    uint8_t hdr[16];
+    uint8_t crc[2];
+    struct {
+        const uint8_t *ptr;
+        uint16_t len;
+    } part[3]; // header, payload and checksum still to be written
+} mspPendingReply;
+
+static void clearPendingReply(mspPort_t *mspPort)
+{
+    if (mspPendingReply.port == mspPort) {
+        mspPendingReply.port = NULL;
+    }
+}
+
 static void resetMspPort(mspPort_t *mspPortToReset, serialPort_t *serialPort, bool sharedWithTelemetry)
 {
+    clearPendingReply(mspPortToReset);
     memset(mspPortToReset, 0, sizeof(mspPort_t));
 
     mspPortToReset->port = serialPort;
@@ -81,6 +107,7 @@ void mspSerialReleasePortIfAllocated(serialPort_t *serialPort)
         mspPort_t *candidateMspPort = &mspPorts[portIndex];
         if (candidateMspPort->port == serialPort) {
             closeSerialPort(serialPort);
+            clearPendingReply(candidateMspPort);
             memset(candidateMspPort, 0, sizeof(mspPort_t));
         }
     }
@@ -92,6 +119,7 @@ void mspSerialReleaseSharedTelemetryPorts(void) {
         mspPort_t *candidateMspPort = &mspPorts[portIndex];
         if (candidateMspPort->sharedWithTelemetry) {
             closeSerialPort(candidateMspPort->port);
+            clearPendingReply(candidateMspPort);
             memset(candidateMspPort, 0, sizeof(mspPort_t));
         }
     }
@@ -282,17 +310,66 @@ static uint8_t mspSerialChecksumBuf(uint8_t checksum, const uint8_t *data, int l
 }
 
 #define JUMBO_FRAME_SIZE_LIMIT 255
-static int mspSerialSendFrame(mspPort_t *msp, const uint8_t * hdr, int hdrLen, const uint8_t * data, int dataLen, const uint8_t * crc, int crcLen)
+// Returns true once the whole of the pending reply has been written
+static bool mspSerialSendPendingReply(bool blocking)
 {
-    // We are allowed to send out the response if
-    //  a) TX buffer is completely empty (we are talking to well-behaving party that follows request-response scheduling;
-    //     this allows us to transmit jumbo frames bigger than TX buffer (serialWriteBuf will block, but for jumbo frames we don't care)
-    //  b) Response fits into TX buffer
-    const int totalFrameLength = hdrLen + dataLen + crcLen;
-    if (!isSerialTransmitBufferEmpty(msp->port) && ((int)serialTxBytesFree(msp->port) < totalFrameLength)) {
+    serialPort_t *port = mspPendingReply.port->port;
+    bool sent = true;
+
+    serialBeginWrite(port);
+    for (unsigned i = 0; i < ARRAYLEN(mspPendingReply.part); i++) {
+        const uint16_t len = blocking ? mspPendingReply.part[i].len : MIN(mspPendingReply.part[i].len, serialTxBytesFree(port));
+        serialWriteBuf(port, mspPendingReply.part[i].ptr, len);
+        mspPendingReply.part[i].ptr += len;
+        mspPendingReply.part[i].len -= len;
+        if (mspPendingReply.part[i].len) {
+            sent = false;
+            break;
+        }
+    }
+    serialEndWrite(port);
+
+    if (sent) {
+        mspPendingReply.port = NULL;
+    }
+
+    return sent;
+}
+
+static int mspSerialSendFrame(mspPort_t *msp, const uint8_t * hdr, int hdrLen, const uint8_t * data, int dataLen, const uint8_t * crc, int crcLen, bool canDefer)
+{
+    // Never interleave with the remainder of a reply still being sent
+    if (mspPendingReply.port == msp) {
         return 0;
     }
 
+    const int totalFrameLength = hdrLen + dataLen + crcLen;
+    if ((int)serialTxBytesFree(msp->port) < totalFrameLength) {
+        if (canDefer) {
+            // Send what fits now and leave the rest to mspSerialProcess instead of blocking in serialWriteBuf
+            memcpy(mspPendingReply.hdr, hdr, hdrLen);
+            memcpy(mspPendingReply.crc, crc, crcLen);
+            mspPendingReply.part[0].ptr = mspPendingReply.hdr;
+            mspPendingReply.part[0].len = hdrLen;
+            mspPendingReply.part[1].ptr = data;
+            mspPendingReply.part[1].len = dataLen;
+            mspPendingReply.part[2].ptr = mspPendingReply.crc;
+            mspPendingReply.part[2].len = crcLen;
+            mspPendingReply.port = msp;
+
+            mspSerialSendPendingReply(false);
+
+            return totalFrameLength;
+        }
+
+        // Otherwise we are only allowed to send out the response if TX buffer is completely empty (we are talking to
+        // well-behaving party that follows request-response scheduling; this allows us to transmit jumbo frames bigger
+        // than TX buffer (serialWriteBuf will block, but for jumbo frames we don't care)
+        if (!isSerialTransmitBufferEmpty(msp->port)) {
+            return 0;
+        }
+    }
+
     // Transmit frame
     serialBeginWrite(msp->port);
     serialWriteBuf(msp->port, hdr, hdrLen);
@@ -303,7 +380,7 @@ static int mspSerialSendFrame(mspPort_t *msp, const uint8_t * hdr, int hdrLen, c
     return totalFrameLength;
 }
 
-static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e mspVersion)
+static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e mspVersion, bool canDefer)
 {
     static const uint8_t mspMagic[MSP_VERSION_COUNT] = MSP_VERSION_MAGIC_INITIALIZER;
     const int dataLen = sbufBytesRemaining(&packet->buf);
@@ -388,15 +465,13 @@ static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e msp
     }
 
     // Send the frame
-    return mspSerialSendFrame(msp, hdrBuf, hdrLen, sbufPtr(&packet->buf), dataLen, crcBuf, crcLen);
+    return mspSerialSendFrame(msp, hdrBuf, hdrLen, sbufPtr(&packet->buf), dataLen, crcBuf, crcLen, canDefer);
 }
 
 static mspPostProcessFnPtr mspSerialProcessReceivedCommand(mspPort_t *msp, mspProcessCommandFnPtr mspProcessCommandFn)
 {
-    static uint8_t outBuf[MSP_PORT_OUTBUF_SIZE];
-
     mspPacket_t reply = {
-        .buf = { .ptr = outBuf, .end = ARRAYEND(outBuf), },
+        .buf = { .ptr = mspSerialOutBuf, .end = ARRAYEND(mspSerialOutBuf), },
         .cmd = -1,
         .flags = 0,
         .result = 0,
@@ -417,12 +492,35 @@ static mspPostProcessFnPtr mspSerialProcessReceivedCommand(mspPort_t *msp, mspPr
 
     if (status != MSP_RESULT_NO_REPLY) {
         sbufSwitchToReader(&reply.buf, outBufHead); // change streambuf direction
-        mspSerialEncode(msp, &reply, msp->mspVersion);
+        mspSerialEncode(msp, &reply, msp->mspVersion, true);
     }
 
     return mspPostProcessFn;
 }
 
+static void mspSerialProcessStream(mspPort_t *msp, mspProcessStreamFnPtr mspProcessStreamFn)
+{
+    // Only build the next chunk once the previous one has left, so the stream is paced by the link rather than
+    // overrunning the TX buffer
+    if (!isSerialTransmitBufferEmpty(msp->port)) {
+        return;
+    }
+
+    mspPacket_t reply = {
+        .buf = { .ptr = mspSerialOutBuf, .end = ARRAYEND(mspSerialOutBuf), },
+        .cmd = -1,
+        .flags = 0,
+        .result = 0,
+        .direction = MSP_DIRECTION_REPLY,
+    };
+    uint8_t *outBufHead = reply.buf.ptr;
+
+    if (mspProcessStreamFn(msp->descriptor, &reply) != MSP_RESULT_NO_REPLY) {
+        sbufSwitchToReader(&reply.buf, outBufHead);
+        mspSerialEncode(msp, &reply, msp->mspVersion, true);
+    }
+}
+
 static void mspEvaluateNonMspData(mspPort_t * mspPort, uint8_t receivedChar)
 {
    if (receivedChar == serialConfig()->reboot_character) {
@@ -488,7 +586,7 @@ static void mspSerialProcessReceivedReply(mspPort_t *msp, mspProcessReplyFnPtr m
  *
  * Called periodically by the scheduler.
  */
-void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn, mspProcessReplyFnPtr mspProcessReplyFn)
+void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn, mspProcessReplyFnPtr mspProcessReplyFn, mspProcessStreamFnPtr mspProcessStreamFn)
 {
     for (uint8_t portIndex = 0; portIndex < MAX_MSP_PORT_COUNT; portIndex++) {
         mspPort_t * const mspPort = &mspPorts[portIndex];
@@ -496,7 +594,13 @@ void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessComm
             continue;
         }
 
+        if (mspPendingReply.port && (mspPendingReply.port != mspPort || !mspSerialSendPendingReply(false))) {
+            // Incoming commands stay queued in the RX buffer until the shared reply buffer is free again
+            continue;
+        }
+
         mspPostProcessFnPtr mspPostProcessFn = NULL;
+        unsigned commandCount = 0;
 
         if (serialRxBytesWaiting(mspPort->port)) {
             // There are bytes incoming - abort pending request
@@ -519,16 +623,29 @@ void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessComm
                     }
 
                     mspPort->c_state = MSP_IDLE;
-                    break; // process one command at a time so as not to block.
+
+                    // Carry on with commands the host has pipelined, their replies go out in order. Stop once a reply
+                    // has to wait for TX buffer space or a post-process action is due, and after a bounded number so
+                    // as not to block.
+                    if (mspPostProcessFn || mspPendingReply.port || ++commandCount >= MSP_MAX_COMMANDS_PER_PROCESS) {
+                        break;
+                    }
                 }
             }
 
             if (mspPostProcessFn) {
+                if (mspPendingReply.port) {
+                    mspSerialSendPendingReply(true);
+                }
                 waitForSerialPortToFinishTransmitting(mspPort->port);
                 mspPostProcessFn(mspPort->port);
             }
         } else {
             mspProcessPendingRequest(mspPort);
+
+            if (mspProcessStreamFn && mspPort->c_state == MSP_IDLE) {
+                mspSerialProcessStream(mspPort, mspProcessStreamFn);
+            }
         }
     }
 }
@@ -577,7 +694,8 @@ int mspSerialPush(serialPortIdentifier_e port, uint8_t cmd, uint8_t *data, int d
             .direction = direction,
         };
 
-        ret = mspSerialEncode(mspPort, &push, MSP_V1);
+        // The pushed data belongs to the caller, so it cannot be left pending
+        ret = mspSerialEncode(mspPort, &push, MSP_V1, false);
     }
     return ret; // return the number of bytes written
 }
@@ -598,7 +716,7 @@ uint32_t mspSerialTxBytesFree(void)
             continue;
         }
 
-        const uint32_t bytesFree = serialTxBytesFree(mspPort->port);
+        const uint32_t bytesFree = mspPendingReply.port == mspPort ? 0 : serialTxBytesFree(mspPort->port);
         if (bytesFree < ret) {
             ret = bytesFree;
         }
@@ -67,7 +67,11 @@ typedef enum {
     MSP_PENDING_BOOTLOADER_FLASH,
 } mspPendingSystemRequest_e;
 
+#ifdef STM32F1
 #define MSP_PORT_INBUF_SIZE 192
+#else
+#define MSP_PORT_INBUF_SIZE 256
+#endif
 #ifdef USE_FLASHFS
 #ifdef STM32F1
 #define MSP_PORT_DATAFLASH_BUFFER_SIZE 1024
@@ -76,8 +80,10 @@ typedef enum {
 #endif
 #define MSP_PORT_DATAFLASH_INFO_SIZE 16
 #define MSP_PORT_OUTBUF_SIZE (MSP_PORT_DATAFLASH_BUFFER_SIZE + MSP_PORT_DATAFLASH_INFO_SIZE)
-#else
+#elif defined(STM32F1)
 #define MSP_PORT_OUTBUF_SIZE 256
+#else
+#define MSP_PORT_OUTBUF_SIZE 512
 #endif
 
 typedef struct __attribute__((packed)) {
@@ -118,7 +124,7 @@ typedef struct mspPort_s {
 
 void mspSerialInit(void);
 bool mspSerialWaiting(void);
-void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn, mspProcessReplyFnPtr mspProcessReplyFn);
+void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn, mspProcessReplyFnPtr mspProcessReplyFn, mspProcessStreamFnPtr mspProcessStreamFn);
 void mspSerialAllocatePorts(void);
 void mspSerialReleasePortIfAllocated(struct serialPort_s *serialPort);
 void mspSerialReleaseSharedTelemetryPorts(void);
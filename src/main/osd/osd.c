@@ -125,6 +125,7 @@ static bool showVisualBeeper = false;
 static statistic_t stats;
 timeUs_t resumeRefreshAt = 0;
 #define REFRESH_1S    1000 * 1000
+#define OSD_G_FORCE_ACC_RATE_HZ 500     // acc rate for the G force element and max G stat
 
 static uint8_t armState;
 #ifdef USE_OSD_PROFILES
@@ -138,6 +139,7 @@ static bool suppressStatsDisplay = false;
 static uint8_t osdStatsRowCount = 0;
 
 static bool backgroundLayerSupported = false;
+static bool osdDrawElementsInProgress = false;
 
 #ifdef USE_ESC_SENSOR
 escSensorData_t *osdEscDataCombined;
@@ -145,7 +147,7 @@ escSensorData_t *osdEscDataCombined;
 
 STATIC_ASSERT(OSD_POS_MAX == OSD_POS(31,31), OSD_POS_MAX_incorrect);
 
-PG_REGISTER_WITH_RESET_FN(osdConfig_t, osdConfig, PG_OSD_CONFIG, 9);
+PG_REGISTER_WITH_RESET_FN(osdConfig_t, osdConfig, PG_OSD_CONFIG, 10);
 
 PG_REGISTER_WITH_RESET_FN(osdElementConfig_t, osdElementConfig, PG_OSD_ELEMENT_CONFIG, 0);
 
@@ -250,12 +252,13 @@ void osdAnalyzeActiveElements(void)
     osdDrawActiveElementsBackground(osdDisplayPort);
 }
 
-static void osdDrawElements(timeUs_t currentTimeUs)
+// Prepares the screen for a new frame of elements, returns false if there are none to draw
+static bool osdStartDrawElements(void)
 {
     // Hide OSD when OSDSW mode is active
     if (IS_RC_MODE_ACTIVE(BOXOSD)) {
         displayClearScreen(osdDisplayPort);
-        return;
+        return false;
     }
 
     if (backgroundLayerSupported) {
@@ -268,7 +271,29 @@ static void osdDrawElements(timeUs_t currentTimeUs)
         displayClearScreen(osdDisplayPort);
     }
 
-    osdDrawActiveElements(osdDisplayPort, currentTimeUs);
+    return true;
+}
+
+// Draws the next slice of elements, finishing the frame and returning true once all are drawn
+static bool osdContinueDrawElements(timeUs_t currentTimeUs)
+{
+    bool frameComplete = true;
+
+#ifdef USE_CMS
+    // If the CMS grabbed the display part way through the frame the rest is abandoned
+    if (!displayIsGrabbed(osdDisplayPort))
+#endif
+    {
+        frameComplete = osdDrawActiveElements(osdDisplayPort, currentTimeUs, osdConfig()->frame_budget_us);
+    }
+
+    osdDrawElementsInProgress = !frameComplete;
+    if (frameComplete) {
+        displayHeartbeat(osdDisplayPort);
+        displayCommitTransaction(osdDisplayPort);
+    }
+
+    return frameComplete;
 }
 
 const uint16_t osdTimerDefault[OSD_TIMER_COUNT] = {
@@ -341,6 +366,7 @@ void pgResetFn_osdConfig(osdConfig_t *osdConfig)
     osdConfig->camera_frame_height = 11;
 
     osdConfig->task_frequency = 60;
+    osdConfig->frame_budget_us = OSD_FRAME_BUDGET_US_DEFAULT;
 }
 
 void pgResetFn_osdElementConfig(osdElementConfig_t *osdElementConfig)
@@ -885,13 +911,21 @@ static timeDelta_t osdShowArmed(void)
     return ret;
 }
 
-STATIC_UNIT_TESTED void osdRefresh(timeUs_t currentTimeUs)
+/*
+ * Returns false while the elements of the frame are still being drawn, in which
+ * case the next call continues drawing them rather than starting a new frame.
+ */
+STATIC_UNIT_TESTED bool osdRefresh(timeUs_t currentTimeUs)
 {
     static timeUs_t lastTimeUs = 0;
     static bool osdStatsEnabled = false;
     static bool osdStatsVisible = false;
     static timeUs_t osdStatsRefreshTimeUs;
 
+    if (osdDrawElementsInProgress) {
+        return osdContinueDrawElements(currentTimeUs);
+    }
+
     // detect arm/disarm
     if (armState != ARMING_FLAG(ARMED)) {
         if (ARMING_FLAG(ARMED)) {
@@ -950,7 +984,7 @@ STATIC_UNIT_TESTED void osdRefresh(timeUs_t currentTimeUs)
                 resumeRefreshAt = currentTimeUs;
             }
             displayHeartbeat(osdDisplayPort);
-            return;
+            return true;
         } else {
             displayClearScreen(osdDisplayPort);
             resumeRefreshAt = 0;
@@ -966,8 +1000,9 @@ STATIC_UNIT_TESTED void osdRefresh(timeUs_t currentTimeUs)
 #endif
 
 #if defined(USE_ACC)
-    if (sensors(SENSOR_ACC)
-       && (VISIBLE(osdElementConfig()->item_pos[OSD_G_FORCE]) || osdStatGetState(OSD_STAT_MAX_G_FORCE))) {
+    const bool osdNeedsGForce = VISIBLE(osdElementConfig()->item_pos[OSD_G_FORCE]) || osdStatGetState(OSD_STAT_MAX_G_FORCE);
+    accSetRequiredRate(ACC_CONSUMER_OSD, osdNeedsGForce ? OSD_G_FORCE_ACC_RATE_HZ : 0);
+    if (sensors(SENSOR_ACC) && osdNeedsGForce) {
             // only calculate the G force if the element is visible or the stat is enabled
         for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
             const float a = accAverage[axis];
@@ -982,10 +1017,14 @@ STATIC_UNIT_TESTED void osdRefresh(timeUs_t currentTimeUs)
 #endif
     {
         osdUpdateAlarms();
-        osdDrawElements(currentTimeUs);
+        if (osdStartDrawElements()) {
+            return osdContinueDrawElements(currentTimeUs);
+        }
         displayHeartbeat(osdDisplayPort);
     }
     displayCommitTransaction(osdDisplayPort);
+
+    return true;
 }
 
 /*
@@ -1031,7 +1070,11 @@ void osdUpdate(timeUs_t currentTimeUs)
 #endif
 
     if (counter % DRAW_FREQ_DENOM == 0) {
-        osdRefresh(currentTimeUs);
+        // Hold the counter until the elements of the frame have all been drawn so
+        // that a partially drawn frame is never sent to the display
+        if (!osdRefresh(currentTimeUs)) {
+            return;
+        }
         showVisualBeeper = false;
     } else {
         bool doDrawScreen = true;
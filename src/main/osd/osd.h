@@ -51,6 +51,8 @@ extern const char * const osdTimerSourceNames[OSD_NUM_TIMER_TYPES];
 
 #define OSD_TASK_FREQUENCY_MIN 30
 #define OSD_TASK_FREQUENCY_MAX 300
+#define OSD_FRAME_BUDGET_US_DEFAULT 250
+#define OSD_FRAME_BUDGET_US_MAX 2000
 
 #define OSD_PROFILE_BITS_POS 11
 #define OSD_PROFILE_MASK    (((1 << OSD_PROFILE_COUNT) - 1) << OSD_PROFILE_BITS_POS)
@@ -289,6 +291,7 @@ typedef struct osdConfig_s {
     uint8_t camera_frame_width;               // The width of the box for the camera frame element
     uint8_t camera_frame_height;              // The height of the box for the camera frame element
     uint16_t task_frequency;
+    uint16_t frame_budget_us;                 // time spent drawing elements per task run, 0 draws the whole frame at once
 } osdConfig_t;
 
 PG_DECLARE(osdConfig_t, osdConfig);
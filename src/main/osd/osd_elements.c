@@ -51,6 +51,13 @@
     Add the mapping for the element ID to the background drawing function to the
     osdElementBackgroundFunction array.
 
+    Refresh rate and change detection:
+    ----------------------------------
+    If the element only renders through element->buff, it can be added to the
+    osdElementRefresh array. The element is then only formatted again when its key
+    function returns a different value, and no more often than its period. In
+    between, the cached text is written instead.
+
     Accelerometer reqirement:
     -------------------------
     If the new element utilizes the accelerometer, add it to the osdElementsNeedAccelerometer() function.
@@ -130,6 +137,14 @@
 #define AH_SYMBOL_COUNT 9
 #define AH_SIDEBAR_WIDTH_POS 7
 #define AH_SIDEBAR_HEIGHT_POS 3
+#define AH_COLUMN_HALF_WIDTH 4
+#define AH_COLUMN_COUNT (2 * AH_COLUMN_HALF_WIDTH + 1)
+#define AH_COLUMN_HIDDEN 0xFF
+
+typedef struct ahColumn_s {
+    uint8_t row;        // character row relative to the element, AH_COLUMN_HIDDEN if off the horizon
+    uint8_t symbol;
+} ahColumn_t;
 
 // Stick overlay size
 #define OSD_STICK_OVERLAY_WIDTH 7
@@ -177,6 +192,21 @@ static unsigned activeOsdElementCount = 0;
 static uint8_t activeOsdElementArray[OSD_ITEM_COUNT];
 static bool backgroundLayerSupported = false;
 
+// Formatted output of the active elements listed in osdElementRefresh
+#define OSD_ELEMENT_CACHE_COUNT 16
+
+typedef struct osdElementCache_s {
+    uint32_t key;
+    timeMs_t formattedAtMs;
+    bool valid;
+    uint8_t attr;
+    char buff[OSD_ELEMENT_BUFFER_LENGTH];
+} osdElementCache_t;
+
+static osdElementCache_t elementCache[OSD_ELEMENT_CACHE_COUNT];
+static unsigned elementCacheCount = 0;
+static uint8_t elementCacheIndex[OSD_ITEM_COUNT];   // index + 1 into elementCache, 0 if the element isn't cached
+
 // Blink control
 static bool blinkState = true;
 static uint32_t blinkBits[(OSD_ITEM_COUNT + 31) / 32];
@@ -346,21 +376,27 @@ void osdFormatTime(char * buff, osd_timer_precision_e precision, timeUs_t time)
     const int minutes = seconds / 60;
     seconds = seconds % 60;
 
+    // the timers are drawn on every refresh, so they skip the format string parsing
+    buff = i2aPad(minutes, 2, '0', buff);
+    *buff++ = ':';
+    buff = i2aPad(seconds, 2, '0', buff);
+
     switch (precision) {
     case OSD_TIMER_PREC_SECOND:
     default:
-        tfp_sprintf(buff, "%02d:%02d", minutes, seconds);
         break;
     case OSD_TIMER_PREC_HUNDREDTHS:
         {
             const int hundredths = (time / 10000) % 100;
-            tfp_sprintf(buff, "%02d:%02d.%02d", minutes, seconds, hundredths);
+            *buff++ = '.';
+            i2aPad(hundredths, 2, '0', buff);
             break;
         }
     case OSD_TIMER_PREC_TENTHS:
         {
             const int tenths = (time / 100000) % 10;
-            tfp_sprintf(buff, "%02d:%02d.%01d", minutes, seconds, tenths);
+            *buff++ = '.';
+            i2aPad(tenths, 1, '0', buff);
             break;
         }
     }
@@ -592,10 +628,30 @@ static void osdElementArtificialHorizon(osdElementParms_t *element)
     }
     pitchAngle -= 41; // 41 = 4 * AH_SYMBOL_COUNT + 5
 
-    for (int x = -4; x <= 4; x++) {
-        const int y = ((-rollAngle * x) / 64) - pitchAngle;
-        if (y >= 0 && y <= 81) {
-            osdDisplayWriteChar(element, element->elemPosX + x, element->elemPosY + (y / AH_SYMBOL_COUNT), DISPLAYPORT_ATTR_NONE, (SYM_AH_BAR9_0 + (y % AH_SYMBOL_COUNT)));
+    // The bar only moves in steps of a character row/glyph, so the per-column
+    // layout is kept and only recalculated when the constrained attitude changes
+    static ahColumn_t ahColumns[AH_COLUMN_COUNT];
+    static int lastRollAngle = INT16_MIN;
+    static int lastPitchAngle = INT16_MIN;
+    if (rollAngle != lastRollAngle || pitchAngle != lastPitchAngle) {
+        lastRollAngle = rollAngle;
+        lastPitchAngle = pitchAngle;
+        for (int x = -AH_COLUMN_HALF_WIDTH; x <= AH_COLUMN_HALF_WIDTH; x++) {
+            const int y = ((-rollAngle * x) / 64) - pitchAngle;
+            ahColumn_t *column = &ahColumns[x + AH_COLUMN_HALF_WIDTH];
+            if (y >= 0 && y <= 81) {
+                column->row = y / AH_SYMBOL_COUNT;
+                column->symbol = SYM_AH_BAR9_0 + (y % AH_SYMBOL_COUNT);
+            } else {
+                column->row = AH_COLUMN_HIDDEN;
+            }
+        }
+    }
+
+    for (int x = -AH_COLUMN_HALF_WIDTH; x <= AH_COLUMN_HALF_WIDTH; x++) {
+        const ahColumn_t *column = &ahColumns[x + AH_COLUMN_HALF_WIDTH];
+        if (column->row != AH_COLUMN_HIDDEN) {
+            osdDisplayWriteChar(element, element->elemPosX + x, element->elemPosY + column->row, DISPLAYPORT_ATTR_NONE, column->symbol);
         }
     }
 
@@ -607,7 +663,9 @@ static void osdElementAverageCellVoltage(osdElementParms_t *element)
 {
     const int cellV = getBatteryAverageCellVoltage();
     element->buff[0] = osdGetBatterySymbol(cellV);
-    tfp_sprintf(element->buff + 1, "%d.%02d%c", cellV / 100, cellV % 100, SYM_VOLT);
+    char *ptr = fixed2a(cellV, 2, 0, element->buff + 1);
+    *ptr++ = SYM_VOLT;
+    *ptr = 0;
 }
 
 static void osdElementCompassBar(osdElementParms_t *element)
@@ -719,7 +777,9 @@ static void osdElementCrosshairs(osdElementParms_t *element)
 static void osdElementCurrentDraw(osdElementParms_t *element)
 {
     const int32_t amperage = getAmperage();
-    tfp_sprintf(element->buff, "%3d.%02d%c", abs(amperage) / 100, abs(amperage) % 100, SYM_AMP);
+    char *ptr = fixed2a(abs(amperage), 2, 6, element->buff);
+    *ptr++ = SYM_AMP;
+    *ptr = 0;
 }
 
 static void osdElementDebug(osdElementParms_t *element)
@@ -1019,7 +1079,9 @@ static void osdElementLogStatus(osdElementParms_t *element)
 
 static void osdElementMahDrawn(osdElementParms_t *element)
 {
-    tfp_sprintf(element->buff, "%4d%c", getMAhDrawn(), SYM_MAH);
+    char *ptr = i2aPad(getMAhDrawn(), 4, ' ', element->buff);
+    *ptr++ = SYM_MAH;
+    *ptr = 0;
 }
 
 static void osdElementMainBatteryUsage(osdElementParms_t *element)
@@ -1050,12 +1112,15 @@ static void osdElementMainBatteryVoltage(osdElementParms_t *element)
     int batteryVoltage = getBatteryVoltage();
 
     element->buff[0] = osdGetBatterySymbol(getBatteryAverageCellVoltage());
+    char *ptr;
     if (batteryVoltage >= 1000) {
         batteryVoltage = (batteryVoltage + 5) / 10;
-        tfp_sprintf(element->buff + 1, "%d.%d%c", batteryVoltage / 10, batteryVoltage % 10, SYM_VOLT);
+        ptr = fixed2a(batteryVoltage, 1, 0, element->buff + 1);
     } else {
-        tfp_sprintf(element->buff + 1, "%d.%02d%c", batteryVoltage / 100, batteryVoltage % 100, SYM_VOLT);
+        ptr = fixed2a(batteryVoltage, 2, 0, element->buff + 1);
     }
+    *ptr++ = SYM_VOLT;
+    *ptr = 0;
 }
 
 static void osdElementMotorDiagnostics(osdElementParms_t *element)
@@ -1161,7 +1226,10 @@ static void osdElementRemainingTimeEstimate(osdElementParms_t *element)
     } else if (mAhDrawn > osdConfig()->cap_alarm) {
         tfp_sprintf(element->buff, "00:00");
     } else {
-        const int remaining_time = (int)((osdConfig()->cap_alarm - mAhDrawn) * ((float)osdFlyTime) / mAhDrawn);
+        // at the recent average current of the battery model rather than the average of the whole flight
+        const int32_t amperage = getBatteryAverageAmperage();
+        const int remaining_time = amperage > 0 ? (osdConfig()->cap_alarm - mAhDrawn) * 360 / amperage
+            : (int)((osdConfig()->cap_alarm - mAhDrawn) * ((float)osdFlyTime) / mAhDrawn);
         osdFormatTime(element->buff, OSD_TIMER_PREC_SECOND, remaining_time);
     }
 }
@@ -1173,7 +1241,8 @@ static void osdElementRssi(osdElementParms_t *element)
         osdRssi = 99;
     }
 
-    tfp_sprintf(element->buff, "%c%2d", SYM_RSSI, osdRssi);
+    element->buff[0] = SYM_RSSI;
+    i2aPad(osdRssi, 2, ' ', element->buff + 1);
 }
 
 #ifdef USE_RTC_TIME
@@ -1241,7 +1310,8 @@ static void osdElementStickOverlay(osdElementParms_t *element)
 
 static void osdElementThrottlePosition(osdElementParms_t *element)
 {
-    tfp_sprintf(element->buff, "%c%3d", SYM_THR, calculateThrottlePercent());
+    element->buff[0] = SYM_THR;
+    i2aPad(calculateThrottlePercent(), 3, ' ', element->buff + 1);
 }
 
 static void osdElementTimer(osdElementParms_t *element)
@@ -1283,13 +1353,22 @@ static void osdElementVtxChannel(osdElementParms_t *element)
 }
 #endif // USE_VTX_COMMON
 
-static void osdElementWarnings(osdElementParms_t *element)
+// The warning to display, see osdUpdateWarning()
+static char osdWarningText[OSD_ELEMENT_BUFFER_LENGTH];
+static uint8_t osdWarningAttr;
+
+// Evaluates the warning conditions once per OSD frame, along with the alarms, so that
+// drawing the warnings element only has to copy the result
+static void osdUpdateWarning(char *buff, uint8_t *attr)
 {
 #define OSD_WARNINGS_MAX_SIZE 12
 #define OSD_FORMAT_MESSAGE_BUFFER_SIZE (OSD_WARNINGS_MAX_SIZE + 1)
 
     STATIC_ASSERT(OSD_FORMAT_MESSAGE_BUFFER_SIZE <= OSD_ELEMENT_BUFFER_LENGTH, osd_warnings_size_exceeds_buffer_size);
 
+    buff[0] = '\0';
+    *attr = DISPLAYPORT_ATTR_NONE;
+
     const batteryState_e batteryState = getBatteryState();
     const timeUs_t currentTimeUs = micros();
 
@@ -1324,8 +1403,8 @@ static void osdElementWarnings(osdElementParms_t *element)
                 } while (!(flags & (1 << armingDisabledDisplayIndex)));
             }
 
-            tfp_sprintf(element->buff, "%s", armingDisableFlagNames[armingDisabledDisplayIndex]);
-            element->attr = DISPLAYPORT_ATTR_WARNING;
+            tfp_sprintf(buff, "%s", armingDisableFlagNames[armingDisabledDisplayIndex]);
+            *attr = DISPLAYPORT_ATTR_WARNING;
             return;
         } else {
             armingDisabledUpdateTimeUs = 0;
@@ -1339,25 +1418,25 @@ static void osdElementWarnings(osdElementParms_t *element)
             armingDelayTime = 0;
         }
         if (armingDelayTime >= (DSHOT_BEACON_GUARD_DELAY_US / 1e5 - 5)) {
-            tfp_sprintf(element->buff, " BEACON ON"); // Display this message for the first 0.5 seconds
+            tfp_sprintf(buff, " BEACON ON"); // Display this message for the first 0.5 seconds
         } else {
-            tfp_sprintf(element->buff, "ARM IN %d.%d", armingDelayTime / 10, armingDelayTime % 10);
+            tfp_sprintf(buff, "ARM IN %d.%d", armingDelayTime / 10, armingDelayTime % 10);
         }
-        element->attr = DISPLAYPORT_ATTR_INFO;
+        *attr = DISPLAYPORT_ATTR_INFO;
         return;
     }
 #endif // USE_DSHOT
     if (osdWarnGetState(OSD_WARNING_FAIL_SAFE) && failsafeIsActive()) {
-        tfp_sprintf(element->buff, "FAIL SAFE");
-        element->attr = DISPLAYPORT_ATTR_CRITICAL;
+        tfp_sprintf(buff, "FAIL SAFE");
+        *attr = DISPLAYPORT_ATTR_CRITICAL;
         SET_BLINK(OSD_WARNINGS);
         return;
     }
 
     // Warn when in flip over after crash mode
     if (osdWarnGetState(OSD_WARNING_CRASH_FLIP) && isFlipOverAfterCrashActive()) {
-        tfp_sprintf(element->buff, "CRASH FLIP");
-        element->attr = DISPLAYPORT_ATTR_INFO;
+        tfp_sprintf(buff, "CRASH FLIP");
+        *attr = DISPLAYPORT_ATTR_INFO;
         return;
     }
 
@@ -1367,11 +1446,11 @@ static void osdElementWarnings(osdElementParms_t *element)
 #ifdef USE_ACC
         if (sensors(SENSOR_ACC)) {
             const int pitchAngle = constrain((attitude.raw[FD_PITCH] - accelerometerConfig()->accelerometerTrims.raw[FD_PITCH]) / 10, -90, 90);
-            tfp_sprintf(element->buff, "LAUNCH %d", pitchAngle);
+            tfp_sprintf(buff, "LAUNCH %d", pitchAngle);
         } else
 #endif // USE_ACC
         {
-            tfp_sprintf(element->buff, "LAUNCH");
+            tfp_sprintf(buff, "LAUNCH");
         }
 
         // Blink the message if the throttle is within 10% of the launch setting
@@ -1379,23 +1458,23 @@ static void osdElementWarnings(osdElementParms_t *element)
             SET_BLINK(OSD_WARNINGS);
         }
 
-        element->attr = DISPLAYPORT_ATTR_INFO;
+        *attr = DISPLAYPORT_ATTR_INFO;
         return;
     }
 #endif // USE_LAUNCH_CONTROL
 
     // RSSI
     if (osdWarnGetState(OSD_WARNING_RSSI) && (getRssiPercent() < osdConfig()->rssi_alarm)) {
-        tfp_sprintf(element->buff, "RSSI LOW");
-        element->attr = DISPLAYPORT_ATTR_WARNING;
+        tfp_sprintf(buff, "RSSI LOW");
+        *attr = DISPLAYPORT_ATTR_WARNING;
         SET_BLINK(OSD_WARNINGS);
         return;
     }
 #ifdef USE_RX_RSSI_DBM
     // rssi dbm
     if (osdWarnGetState(OSD_WARNING_RSSI_DBM) && (getRssiDbm() < osdConfig()->rssi_dbm_alarm)) {
-        tfp_sprintf(element->buff, "RSSI DBM");
-        element->attr = DISPLAYPORT_ATTR_WARNING;
+        tfp_sprintf(buff, "RSSI DBM");
+        *attr = DISPLAYPORT_ATTR_WARNING;
         SET_BLINK(OSD_WARNINGS);
         return;
     }
@@ -1404,16 +1483,16 @@ static void osdElementWarnings(osdElementParms_t *element)
 #ifdef USE_RX_LINK_QUALITY_INFO
     // Link Quality
     if (osdWarnGetState(OSD_WARNING_LINK_QUALITY) && (rxGetLinkQualityPercent() < osdConfig()->link_quality_alarm)) {
-        tfp_sprintf(element->buff, "LINK QUALITY");
-        element->attr = DISPLAYPORT_ATTR_WARNING;
+        tfp_sprintf(buff, "LINK QUALITY");
+        *attr = DISPLAYPORT_ATTR_WARNING;
         SET_BLINK(OSD_WARNINGS);
         return;
     }
 #endif // USE_RX_LINK_QUALITY_INFO
 
     if (osdWarnGetState(OSD_WARNING_BATTERY_CRITICAL) && batteryState == BATTERY_CRITICAL) {
-        tfp_sprintf(element->buff, " LAND NOW");
-        element->attr = DISPLAYPORT_ATTR_CRITICAL;
+        tfp_sprintf(buff, " LAND NOW");
+        *attr = DISPLAYPORT_ATTR_CRITICAL;
         SET_BLINK(OSD_WARNINGS);
         return;
     }
@@ -1424,8 +1503,8 @@ static void osdElementWarnings(osdElementParms_t *element)
        gpsRescueIsConfigured() &&
        !gpsRescueIsDisabled() &&
        !gpsRescueIsAvailable()) {
-        tfp_sprintf(element->buff, "RESCUE N/A");
-        element->attr = DISPLAYPORT_ATTR_WARNING;
+        tfp_sprintf(buff, "RESCUE N/A");
+        *attr = DISPLAYPORT_ATTR_WARNING;
         SET_BLINK(OSD_WARNINGS);
         return;
     }
@@ -1437,8 +1516,8 @@ static void osdElementWarnings(osdElementParms_t *element)
 
         statistic_t *stats = osdGetStats();
         if (cmpTimeUs(stats->armed_time, OSD_GPS_RESCUE_DISABLED_WARNING_DURATION_US) < 0) {
-            tfp_sprintf(element->buff, "RESCUE OFF");
-            element->attr = DISPLAYPORT_ATTR_WARNING;
+            tfp_sprintf(buff, "RESCUE OFF");
+            *attr = DISPLAYPORT_ATTR_WARNING;
             SET_BLINK(OSD_WARNINGS);
             return;
         }
@@ -1448,8 +1527,8 @@ static void osdElementWarnings(osdElementParms_t *element)
 
     // Show warning if in HEADFREE flight mode
     if (FLIGHT_MODE(HEADFREE_MODE)) {
-        tfp_sprintf(element->buff, "HEADFREE");
-        element->attr = DISPLAYPORT_ATTR_WARNING;
+        tfp_sprintf(buff, "HEADFREE");
+        *attr = DISPLAYPORT_ATTR_WARNING;
         SET_BLINK(OSD_WARNINGS);
         return;
     }
@@ -1457,8 +1536,8 @@ static void osdElementWarnings(osdElementParms_t *element)
 #ifdef USE_ADC_INTERNAL
     const int16_t coreTemperature = getCoreTemperatureCelsius();
     if (osdWarnGetState(OSD_WARNING_CORE_TEMPERATURE) && coreTemperature >= osdConfig()->core_temp_alarm) {
-        tfp_sprintf(element->buff, "CORE %c: %3d%c", SYM_TEMPERATURE, osdConvertTemperatureToSelectedUnit(coreTemperature), osdGetTemperatureSymbolForSelectedUnit());
-        element->attr = DISPLAYPORT_ATTR_WARNING;
+        tfp_sprintf(buff, "CORE %c: %3d%c", SYM_TEMPERATURE, osdConvertTemperatureToSelectedUnit(coreTemperature), osdGetTemperatureSymbolForSelectedUnit());
+        *attr = DISPLAYPORT_ATTR_WARNING;
         SET_BLINK(OSD_WARNINGS);
         return;
     }
@@ -1509,8 +1588,8 @@ static void osdElementWarnings(osdElementParms_t *element)
         escWarningMsg[pos] = '\0';
 
         if (escWarningCount > 0) {
-            tfp_sprintf(element->buff, "%s", escWarningMsg);
-            element->attr = DISPLAYPORT_ATTR_WARNING;
+            tfp_sprintf(buff, "%s", escWarningMsg);
+            *attr = DISPLAYPORT_ATTR_WARNING;
             SET_BLINK(OSD_WARNINGS);
             return;
         }
@@ -1518,8 +1597,8 @@ static void osdElementWarnings(osdElementParms_t *element)
 #endif // USE_ESC_SENSOR
 
     if (osdWarnGetState(OSD_WARNING_BATTERY_WARNING) && batteryState == BATTERY_WARNING) {
-        tfp_sprintf(element->buff, "LOW BATTERY");
-        element->attr = DISPLAYPORT_ATTR_WARNING;
+        tfp_sprintf(buff, "LOW BATTERY");
+        *attr = DISPLAYPORT_ATTR_WARNING;
         SET_BLINK(OSD_WARNINGS);
         return;
     }
@@ -1527,8 +1606,8 @@ static void osdElementWarnings(osdElementParms_t *element)
 #ifdef USE_RC_SMOOTHING_FILTER
     // Show warning if rc smoothing hasn't initialized the filters
     if (osdWarnGetState(OSD_WARNING_RC_SMOOTHING) && ARMING_FLAG(ARMED) && !rcSmoothingInitializationComplete()) {
-        tfp_sprintf(element->buff, "RCSMOOTHING");
-        element->attr = DISPLAYPORT_ATTR_WARNING;
+        tfp_sprintf(buff, "RCSMOOTHING");
+        *attr = DISPLAYPORT_ATTR_WARNING;
         SET_BLINK(OSD_WARNINGS);
         return;
     }
@@ -1536,8 +1615,8 @@ static void osdElementWarnings(osdElementParms_t *element)
 
     // Show warning if mah consumed is over the configured limit
     if (osdWarnGetState(OSD_WARNING_OVER_CAP) && ARMING_FLAG(ARMED) && osdConfig()->cap_alarm > 0 && getMAhDrawn() >= osdConfig()->cap_alarm) {
-        tfp_sprintf(element->buff, "OVER CAP");
-        element->attr = DISPLAYPORT_ATTR_WARNING;
+        tfp_sprintf(buff, "OVER CAP");
+        *attr = DISPLAYPORT_ATTR_WARNING;
         SET_BLINK(OSD_WARNINGS);
         return;
     }
@@ -1545,20 +1624,26 @@ static void osdElementWarnings(osdElementParms_t *element)
     // Show warning if battery is not fresh
     if (osdWarnGetState(OSD_WARNING_BATTERY_NOT_FULL) && !(ARMING_FLAG(ARMED) || ARMING_FLAG(WAS_EVER_ARMED)) && (getBatteryState() == BATTERY_OK)
           && getBatteryAverageCellVoltage() < batteryConfig()->vbatfullcellvoltage) {
-        tfp_sprintf(element->buff, "BATT < FULL");
-        element->attr = DISPLAYPORT_ATTR_INFO;
+        tfp_sprintf(buff, "BATT < FULL");
+        *attr = DISPLAYPORT_ATTR_INFO;
         return;
     }
 
     // Visual beeper
     if (osdWarnGetState(OSD_WARNING_VISUAL_BEEPER) && osdGetVisualBeeperState()) {
-        tfp_sprintf(element->buff, "  * * * *");
-        element->attr = DISPLAYPORT_ATTR_INFO;
+        tfp_sprintf(buff, "  * * * *");
+        *attr = DISPLAYPORT_ATTR_INFO;
         return;
     }
 
 }
 
+static void osdElementWarnings(osdElementParms_t *element)
+{
+    strcpy(element->buff, osdWarningText);
+    element->attr = osdWarningAttr;
+}
+
 // Define the order in which the elements are drawn.
 // Elements positioned later in the list will overlay the earlier
 // ones if their character positions overlap
@@ -1752,6 +1837,117 @@ const osdElementDrawFn osdElementDrawFunction[OSD_ITEM_COUNT] = {
 #endif
 };
 
+// Cheap values that change whenever the text of the element would, see osdElementRefresh
+
+typedef uint32_t (*osdElementKeyFn)(void);
+
+typedef struct osdElementRefresh_s {
+    osdElementKeyFn keyFn;  // NULL to format again every periodMs
+    uint16_t periodMs;      // minimum time between formatting the element
+} osdElementRefresh_t;
+
+static uint32_t osdKeyRssi(void)
+{
+    return getRssi();
+}
+
+static uint32_t osdKeyMainBatteryVoltage(void)
+{
+    return getBatteryVoltage() | (getBatteryAverageCellVoltage() << 16);
+}
+
+static uint32_t osdKeyAverageCellVoltage(void)
+{
+    return getBatteryAverageCellVoltage();
+}
+
+static uint32_t osdKeyCurrentDraw(void)
+{
+    return getAmperage();
+}
+
+static uint32_t osdKeyMahDrawn(void)
+{
+    return getMAhDrawn();
+}
+
+static uint32_t osdKeyAltitude(void)
+{
+    bool haveSensor = false;
+#ifdef USE_BARO
+    haveSensor = sensors(SENSOR_BARO);
+#endif
+#ifdef USE_GPS
+    haveSensor = haveSensor || (sensors(SENSOR_GPS) && STATE(GPS_FIX));
+#endif
+    return ((uint32_t)getEstimatedAltitudeCm() << 3) | (osdConfig()->units << 1) | haveSensor;
+}
+
+static uint32_t osdKeyDisarmed(void)
+{
+    return ARMING_FLAG(ARMED);
+}
+
+#ifdef USE_GPS
+static uint32_t osdKeyGpsSats(void)
+{
+    return gpsSol.numSat | (gpsSol.hdop << 8) | (osdConfig()->gps_sats_show_hdop << 24);
+}
+
+static uint32_t osdKeyGpsSpeed(void)
+{
+    return (gpsConfig()->gps_use_3d_speed ? gpsSol.speed3d : gpsSol.groundSpeed) | (osdConfig()->units << 16);
+}
+
+static uint32_t osdKeyGpsLatitude(void)
+{
+    return gpsSol.llh.lat;
+}
+
+static uint32_t osdKeyGpsLongitude(void)
+{
+    return gpsSol.llh.lon;
+}
+#endif
+
+#ifdef USE_ADC_INTERNAL
+static uint32_t osdKeyCoreTemperature(void)
+{
+    return getCoreTemperatureCelsius() | (osdConfig()->units << 16);
+}
+#endif
+
+#ifdef USE_RX_LINK_QUALITY_INFO
+static uint32_t osdKeyLinkQuality(void)
+{
+    return rxGetLinkQuality() | (rxGetRfMode() << 16) | (linkQualitySource << 24);
+}
+#endif
+
+static const osdElementRefresh_t osdElementRefresh[OSD_ITEM_COUNT] = {
+    [OSD_RSSI_VALUE]              = { osdKeyRssi, 0 },
+    [OSD_MAIN_BATT_VOLTAGE]       = { osdKeyMainBatteryVoltage, 0 },
+    [OSD_CURRENT_DRAW]            = { osdKeyCurrentDraw, 0 },
+    [OSD_MAH_DRAWN]               = { osdKeyMahDrawn, 0 },
+#ifdef USE_GPS
+    [OSD_GPS_SPEED]               = { osdKeyGpsSpeed, 0 },
+    [OSD_GPS_SATS]                = { osdKeyGpsSats, 0 },
+    [OSD_GPS_LON]                 = { osdKeyGpsLongitude, 200 },
+    [OSD_GPS_LAT]                 = { osdKeyGpsLatitude, 200 },
+#endif
+    [OSD_ALTITUDE]                = { osdKeyAltitude, 0 },
+    [OSD_AVG_CELL_VOLTAGE]        = { osdKeyAverageCellVoltage, 0 },
+    [OSD_DEBUG]                   = { NULL, 100 },
+    [OSD_MAIN_BATT_USAGE]         = { osdKeyMahDrawn, 0 },
+    [OSD_DISARMED]                = { osdKeyDisarmed, 0 },
+#ifdef USE_ADC_INTERNAL
+    [OSD_CORE_TEMPERATURE]        = { osdKeyCoreTemperature, 0 },
+#endif
+#ifdef USE_RX_LINK_QUALITY_INFO
+    [OSD_LINK_QUALITY]            = { osdKeyLinkQuality, 0 },
+#endif
+};
+
 // Define the mapping between the OSD element id and the function to draw its background (static part)
 // Only necessary to define the entries that actually have a background function
 
@@ -1770,6 +1966,12 @@ static void osdAddActiveElement(osd_items_e element)
 {
     if (VISIBLE(osdElementConfig()->item_pos[element])) {
         activeOsdElementArray[activeOsdElementCount++] = element;
+
+        const osdElementRefresh_t *refresh = &osdElementRefresh[element];
+        if ((refresh->keyFn || refresh->periodMs) && elementCacheCount < OSD_ELEMENT_CACHE_COUNT) {
+            elementCache[elementCacheCount].valid = false;
+            elementCacheIndex[element] = ++elementCacheCount;
+        }
     }
 }
 
@@ -1779,6 +1981,8 @@ static void osdAddActiveElement(osd_items_e element)
 void osdAddActiveElements(void)
 {
     activeOsdElementCount = 0;
+    elementCacheCount = 0;
+    memset(elementCacheIndex, 0, sizeof(elementCacheIndex));
 
 #ifdef USE_ACC
     if (sensors(SENSOR_ACC)) {
@@ -1821,7 +2025,7 @@ void osdAddActiveElements(void)
 #endif
 }
 
-static void osdDrawSingleElement(displayPort_t *osdDisplayPort, uint8_t item)
+static void osdDrawSingleElement(displayPort_t *osdDisplayPort, uint8_t item, timeMs_t currentTimeMs)
 {
     if (!osdElementDrawFunction[item]) {
         // Element has no drawing function
@@ -1833,17 +2037,43 @@ static void osdDrawSingleElement(displayPort_t *osdDisplayPort, uint8_t item)
 
     uint8_t elemPosX = OSD_X(osdElementConfig()->item_pos[item]);
     uint8_t elemPosY = OSD_Y(osdElementConfig()->item_pos[item]);
-    char buff[OSD_ELEMENT_BUFFER_LENGTH] = "";
 
     osdElementParms_t element;
     element.item = item;
     element.elemPosX = elemPosX;
     element.elemPosY = elemPosY;
-    element.buff = (char *)&buff;
     element.osdDisplayPort = osdDisplayPort;
     element.drawElement = true;
     element.attr = DISPLAYPORT_ATTR_NONE;
 
+    osdElementCache_t *cache = elementCacheIndex[item] ? &elementCache[elementCacheIndex[item] - 1] : NULL;
+    if (cache) {
+        // The screen is redrawn every cycle, so an unchanged element still writes its cached text
+        const osdElementRefresh_t *refresh = &osdElementRefresh[item];
+        const uint32_t key = refresh->keyFn ? refresh->keyFn() : 0;
+        const bool tooSoon = currentTimeMs - cache->formattedAtMs < refresh->periodMs;
+        if (cache->valid && (tooSoon || (refresh->keyFn && key == cache->key))) {
+            element.buff = cache->buff;
+            osdDisplayWrite(&element, elemPosX, elemPosY, cache->attr, cache->buff);
+            return;
+        }
+
+        memset(cache->buff, 0, sizeof(cache->buff));
+        element.buff = cache->buff;
+        osdElementDrawFunction[item](&element);
+        cache->key = key;
+        cache->formattedAtMs = currentTimeMs;
+        cache->attr = element.attr;
+        cache->valid = element.drawElement;
+        if (element.drawElement) {
+            osdDisplayWrite(&element, elemPosX, elemPosY, element.attr, cache->buff);
+        }
+        return;
+    }
+
+    char buff[OSD_ELEMENT_BUFFER_LENGTH] = "";
+    element.buff = (char *)&buff;
+
     // Call the element drawing function
     osdElementDrawFunction[item](&element);
     if (element.drawElement) {
@@ -1877,29 +2107,50 @@ static void osdDrawSingleElementBackground(displayPort_t *osdDisplayPort, uint8_
     }
 }
 
-void osdDrawActiveElements(displayPort_t *osdDisplayPort, timeUs_t currentTimeUs)
+// Draws the active elements starting where the previous call stopped. Drawing stops once
+// budgetUs has been used (at least one element is always drawn, a budget of 0 draws them all)
+// and returns true when the last element of the frame has been drawn.
+bool osdDrawActiveElements(displayPort_t *osdDisplayPort, timeUs_t currentTimeUs, timeDelta_t budgetUs)
 {
+    static unsigned activeElementIndex = 0;
+
+    if (activeElementIndex == 0) {
 #ifdef USE_GPS
-    static bool lastGpsSensorState;
-    // Handle the case that the GPS_SENSOR may be delayed in activation
-    // or deactivate if communication is lost with the module.
-    const bool currentGpsSensorState = sensors(SENSOR_GPS);
-    if (lastGpsSensorState != currentGpsSensorState) {
-        lastGpsSensorState = currentGpsSensorState;
-        osdAnalyzeActiveElements();
-    }
+        static bool lastGpsSensorState;
+        // Handle the case that the GPS_SENSOR may be delayed in activation
+        // or deactivate if communication is lost with the module.
+        const bool currentGpsSensorState = sensors(SENSOR_GPS);
+        if (lastGpsSensorState != currentGpsSensorState) {
+            lastGpsSensorState = currentGpsSensorState;
+            osdAnalyzeActiveElements();
+        }
 #endif // USE_GPS
 
-    blinkState = (currentTimeUs / 200000) % 2;
+        blinkState = (currentTimeUs / 200000) % 2;
+    }
 
-    for (unsigned i = 0; i < activeOsdElementCount; i++) {
+    const timeUs_t startTimeUs = micros();
+
+    while (activeElementIndex < activeOsdElementCount) {
+        const uint8_t item = activeOsdElementArray[activeElementIndex++];
         if (!backgroundLayerSupported) {
             // If the background layer isn't supported then we
             // have to draw the element's static layer as well.
-            osdDrawSingleElementBackground(osdDisplayPort, activeOsdElementArray[i]);
+            osdDrawSingleElementBackground(osdDisplayPort, item);
+        }
+        osdDrawSingleElement(osdDisplayPort, item, currentTimeUs / 1000);
+
+        if (budgetUs && cmpTimeUs(micros(), startTimeUs) >= budgetUs) {
+            break;
         }
-        osdDrawSingleElement(osdDisplayPort, activeOsdElementArray[i]);
     }
+
+    if (activeElementIndex < activeOsdElementCount) {
+        return false;
+    }
+
+    activeElementIndex = 0;
+    return true;
 }
 
 void osdDrawActiveElementsBackground(displayPort_t *osdDisplayPort)
@@ -2014,6 +2265,10 @@ void osdUpdateAlarms(void)
         }
     }
 #endif
+
+    if (VISIBLE(osdElementConfig()->item_pos[OSD_WARNINGS])) {
+        osdUpdateWarning(osdWarningText, &osdWarningAttr);
+    }
 }
 
 #ifdef USE_ACC
@@ -34,6 +34,7 @@ typedef struct displayPortProfile_s {
 
     uint8_t attrValues[4];     // NORMAL, INFORMATIONAL, WARNING, CRITICAL
     uint8_t useDeviceBlink;    // Use device local blink capability
+    uint8_t useDeltaUpdates;   // Only send the characters that changed since the last drawScreen
 } displayPortProfile_t;
 
 PG_DECLARE(displayPortProfile_t, displayPortProfileMsp);
@@ -30,6 +30,7 @@ typedef struct flashConfig_s {
     ioTag_t csTag;
     uint8_t spiDevice;
     uint8_t quadSpiDevice;
+    uint8_t eraseAheadSectors;          // Sectors kept erased ahead of the flashfs tail, 0 to log until the flash is full
 } flashConfig_t;
 
 PG_DECLARE(flashConfig_t, flashConfig);
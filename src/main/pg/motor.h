@@ -49,6 +49,7 @@ typedef struct motorDevConfig_s {
     uint8_t  useDshotBitbang;
     uint8_t  useDshotBitbangedTimer;
     uint8_t  motorOutputReordering[MAX_SUPPORTED_MOTORS]; // Reindexing motors for "remap motors" feature in Configurator
+    uint8_t  useDshotEdt;                   // Enable extended DShot telemetry frames (temperature, voltage, current)
 } motorDevConfig_t;
 
 typedef struct motorConfig_s {
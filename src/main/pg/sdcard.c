@@ -34,7 +34,7 @@
 #include "drivers/dma.h"
 #include "drivers/dma_reqmap.h"
 
-PG_REGISTER_WITH_RESET_FN(sdcardConfig_t, sdcardConfig, PG_SDCARD_CONFIG, 1);
+PG_REGISTER_WITH_RESET_FN(sdcardConfig_t, sdcardConfig, PG_SDCARD_CONFIG, 2);
 
 void pgResetFn_sdcardConfig(sdcardConfig_t *config)
 {
@@ -43,7 +43,8 @@ void pgResetFn_sdcardConfig(sdcardConfig_t *config)
 
     // We can safely handle SPI and SDIO cases separately on custom targets, as these are exclusive per target.
     // On generic targets, SPI has precedence over SDIO; SDIO must be post-flash configured.
-    config->useDma = false;
+    // DMA is used for the block writes whenever a stream can be found for the SPI TX
+    config->useDma = true;
     config->device = SPI_DEV_TO_CFG(SPIINVALID);
     config->mode = SDCARD_MODE_NONE;
 
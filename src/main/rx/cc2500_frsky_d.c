@@ -188,6 +188,7 @@ rx_spi_received_e frSkyDHandlePacket(uint8_t * const packet, uint8_t * const pro
 {
     static timeUs_t lastPacketReceivedTime = 0;
     static timeUs_t telemetryTimeUs;
+    static bool packetReadPending;
 
     rx_spi_received_e ret = RX_SPI_RECEIVED_NONE;
 
@@ -218,11 +219,21 @@ rx_spi_received_e frSkyDHandlePacket(uint8_t * const packet, uint8_t * const pro
         FALLTHROUGH; //!!TODO -check this fall through is correct
     // here FS code could be
     case STATE_DATA:
-        if (rxSpiGetExtiState()) {
-            uint8_t ccLen = cc2500ReadReg(CC2500_3B_RXBYTES | CC2500_READ_BURST) & 0x7F;
+        if (packetReadPending || rxSpiGetExtiState()) {
             bool packetOk = false;
-            if (ccLen >= 20) {
-                cc2500ReadFifo(packet, 20);
+            if (!packetReadPending) {
+                uint8_t ccLen = cc2500ReadReg(CC2500_3B_RXBYTES | CC2500_READ_BURST) & 0x7F;
+                if (ccLen >= 20) {
+                    cc2500ReadFifoStart(packet, 20);
+                    packetReadPending = true;
+                }
+            }
+            if (packetReadPending && cc2500ReadFifoBusy()) {
+                // the packet is still being read, handle it on the next call
+                break;
+            }
+            if (packetReadPending) {
+                packetReadPending = false;
                 if (packet[19] & 0x80) {
                     packetOk = true;
                     missingPackets = 0;
@@ -318,6 +318,7 @@ rx_spi_received_e frSkyXHandlePacket(uint8_t * const packet, uint8_t * const pro
     static timeUs_t packetTimerUs;
 
     static bool frameReceived;
+    static bool packetReadPending;
     static timeDelta_t receiveDelayUs;
     static uint8_t channelsToSkip = 1;
     static uint32_t packetErrors = 0;
@@ -353,10 +354,16 @@ rx_spi_received_e frSkyXHandlePacket(uint8_t * const packet, uint8_t * const pro
         FALLTHROUGH;
         // here FS code could be
     case STATE_DATA:
-        if (rxSpiGetExtiState() && (!frameReceived)) {
-            uint8_t ccLen = cc2500ReadReg(CC2500_3B_RXBYTES | CC2500_READ_BURST) & 0x7F;
-            if (ccLen >= packetLength) {
-                cc2500ReadFifo(packet, packetLength);
+        if (packetReadPending || (rxSpiGetExtiState() && (!frameReceived))) {
+            if (!packetReadPending) {
+                uint8_t ccLen = cc2500ReadReg(CC2500_3B_RXBYTES | CC2500_READ_BURST) & 0x7F;
+                if (ccLen >= packetLength) {
+                    cc2500ReadFifoStart(packet, packetLength);
+                    packetReadPending = true;
+                }
+            }
+            if (packetReadPending && !cc2500ReadFifoBusy()) {
+                packetReadPending = false;
                 if (isValidPacket(packet)) {
                     missingPackets = 0;
                     timeoutUs = 1;
@@ -428,6 +435,10 @@ rx_spi_received_e frSkyXHandlePacket(uint8_t * const packet, uint8_t * const pro
                 }
             }
         }
+        if (packetReadPending) {
+            // the packet is still being read, handle it on the next call
+            break;
+        }
         if (telemetryReceived) {
             if (cmpTimeUs(micros(), packetTimerUs) > receiveDelayUs) { // if received or not received in this time sent telemetry data
                 *protocolState = STATE_TELEMETRY;
@@ -31,6 +31,7 @@
 #include "build/debug.h"
 
 #include "common/crc.h"
+#include "common/encoding.h"
 #include "common/maths.h"
 #include "common/utils.h"
 
@@ -46,6 +47,8 @@
 #include "rx/rx.h"
 #include "rx/crsf.h"
 
+#include "scheduler/scheduler.h"
+
 #include "telemetry/crsf.h"
 
 #define CRSF_TIME_NEEDED_PER_FRAME_US   1100 // 700 ms + 400 ms for potential ad-hoc request
@@ -61,7 +64,7 @@
 STATIC_UNIT_TESTED bool crsfFrameDone = false;
 STATIC_UNIT_TESTED crsfFrame_t crsfFrame;
 STATIC_UNIT_TESTED crsfFrame_t crsfChannelDataFrame;
-STATIC_UNIT_TESTED uint32_t crsfChannelData[CRSF_MAX_CHANNEL];
+STATIC_UNIT_TESTED uint16_t crsfChannelData[CRSF_MAX_CHANNEL];
 
 static serialPort_t *serialPort;
 static timeUs_t crsfFrameStartAtUs = 0;
@@ -97,28 +100,6 @@ static timeUs_t lastRcFrameTimeUs = 0;
  *
  */
 
-struct crsfPayloadRcChannelsPacked_s {
-    // 176 bits of data (11 bits per channel * 16 channels) = 22 bytes.
-    unsigned int chan0 : 11;
-    unsigned int chan1 : 11;
-    unsigned int chan2 : 11;
-    unsigned int chan3 : 11;
-    unsigned int chan4 : 11;
-    unsigned int chan5 : 11;
-    unsigned int chan6 : 11;
-    unsigned int chan7 : 11;
-    unsigned int chan8 : 11;
-    unsigned int chan9 : 11;
-    unsigned int chan10 : 11;
-    unsigned int chan11 : 11;
-    unsigned int chan12 : 11;
-    unsigned int chan13 : 11;
-    unsigned int chan14 : 11;
-    unsigned int chan15 : 11;
-} __attribute__ ((__packed__));
-
-typedef struct crsfPayloadRcChannelsPacked_s crsfPayloadRcChannelsPacked_t;
-
 #if defined(USE_CRSF_LINK_STATISTICS)
 /*
  * 0x14 Link statistics
@@ -151,6 +132,8 @@ typedef struct crsfPayloadLinkstatistics_s {
 } crsfLinkStatistics_t;
 
 static timeUs_t lastLinkStatisticsFrameUs;
+static timeUs_t lastDownlinkStatisticsUs;
+static uint8_t downlinkLinkQuality;
 
 static void handleCrsfLinkStatisticsFrame(const crsfLinkStatistics_t* statsPtr, timeUs_t currentTimeUs)
 {
@@ -175,24 +158,18 @@ static void handleCrsfLinkStatisticsFrame(const crsfLinkStatistics_t* statsPtr,
     }
 #endif
 
-    switch (debugMode) {
-    case DEBUG_CRSF_LINK_STATISTICS_UPLINK:
-        DEBUG_SET(DEBUG_CRSF_LINK_STATISTICS_UPLINK, 0, stats.uplink_RSSI_1);
-        DEBUG_SET(DEBUG_CRSF_LINK_STATISTICS_UPLINK, 1, stats.uplink_RSSI_2);
-        DEBUG_SET(DEBUG_CRSF_LINK_STATISTICS_UPLINK, 2, stats.uplink_Link_quality);
-        DEBUG_SET(DEBUG_CRSF_LINK_STATISTICS_UPLINK, 3, stats.rf_Mode);
-        break;
-    case DEBUG_CRSF_LINK_STATISTICS_PWR:
-        DEBUG_SET(DEBUG_CRSF_LINK_STATISTICS_PWR, 0, stats.active_antenna);
-        DEBUG_SET(DEBUG_CRSF_LINK_STATISTICS_PWR, 1, stats.uplink_SNR);
-        DEBUG_SET(DEBUG_CRSF_LINK_STATISTICS_PWR, 2, stats.uplink_TX_Power);
-        break;
-    case DEBUG_CRSF_LINK_STATISTICS_DOWN:
-        DEBUG_SET(DEBUG_CRSF_LINK_STATISTICS_DOWN, 0, stats.downlink_RSSI);
-        DEBUG_SET(DEBUG_CRSF_LINK_STATISTICS_DOWN, 1, stats.downlink_Link_quality);
-        DEBUG_SET(DEBUG_CRSF_LINK_STATISTICS_DOWN, 2, stats.downlink_SNR);
-        break;
-    }
+    DEBUG_SET(DEBUG_CRSF_LINK_STATISTICS_UPLINK, 0, stats.uplink_RSSI_1);
+    DEBUG_SET(DEBUG_CRSF_LINK_STATISTICS_UPLINK, 1, stats.uplink_RSSI_2);
+    DEBUG_SET(DEBUG_CRSF_LINK_STATISTICS_UPLINK, 2, stats.uplink_Link_quality);
+    DEBUG_SET(DEBUG_CRSF_LINK_STATISTICS_UPLINK, 3, stats.rf_Mode);
+
+    DEBUG_SET(DEBUG_CRSF_LINK_STATISTICS_PWR, 0, stats.active_antenna);
+    DEBUG_SET(DEBUG_CRSF_LINK_STATISTICS_PWR, 1, stats.uplink_SNR);
+    DEBUG_SET(DEBUG_CRSF_LINK_STATISTICS_PWR, 2, stats.uplink_TX_Power);
+
+    DEBUG_SET(DEBUG_CRSF_LINK_STATISTICS_DOWN, 0, stats.downlink_RSSI);
+    DEBUG_SET(DEBUG_CRSF_LINK_STATISTICS_DOWN, 1, stats.downlink_Link_quality);
+    DEBUG_SET(DEBUG_CRSF_LINK_STATISTICS_DOWN, 2, stats.downlink_SNR);
 
 }
 #endif
@@ -220,6 +197,7 @@ static void crsfCheckRssi(uint32_t currentTimeUs) {
 }
 #endif
 
+#if defined(UNIT_TEST)
 STATIC_UNIT_TESTED uint8_t crsfFrameCRC(void)
 {
     // CRC includes type and payload
@@ -229,6 +207,7 @@ STATIC_UNIT_TESTED uint8_t crsfFrameCRC(void)
     }
     return crc;
 }
+#endif
 
 // Receive ISR callback, called back from serial port
 STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
@@ -236,6 +215,7 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
     UNUSED(data);
 
     static uint8_t crsfFramePosition = 0;
+    static uint8_t crsfFrameCrc;
     const timeUs_t currentTimeUs = microsISR();
 
 #ifdef DEBUG_CRSF_PACKETS
@@ -256,18 +236,25 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
     const int fullFrameLength = crsfFramePosition < 3 ? 5 : crsfFrame.frame.frameLength + CRSF_FRAME_LENGTH_ADDRESS + CRSF_FRAME_LENGTH_FRAMELENGTH;
 
     if (crsfFramePosition < fullFrameLength) {
+        // the CRC covers the type and payload, it is accumulated as they arrive rather than over the whole frame at the end
+        if (crsfFramePosition == CRSF_PAYLOAD_OFFSET) {
+            crsfFrameCrc = crc8_dvb_s2(0, c);
+        } else if (crsfFramePosition > CRSF_PAYLOAD_OFFSET && crsfFramePosition < fullFrameLength - 1) {
+            crsfFrameCrc = crc8_dvb_s2(crsfFrameCrc, c);
+        }
         crsfFrame.bytes[crsfFramePosition++] = (uint8_t)c;
         if (crsfFramePosition >= fullFrameLength) {
             crsfFramePosition = 0;
-            const uint8_t crc = crsfFrameCRC();
-            if (crc == crsfFrame.bytes[fullFrameLength - 1]) {
+            if (crsfFrameCrc == crsfFrame.bytes[fullFrameLength - 1]) {
                 switch (crsfFrame.frame.type)
                 {
                     case CRSF_FRAMETYPE_RC_CHANNELS_PACKED:
                         if (crsfFrame.frame.deviceAddress == CRSF_ADDRESS_FLIGHT_CONTROLLER) {
                             lastRcFrameTimeUs = currentTimeUs;
                             crsfFrameDone = true;
-                            memcpy(&crsfChannelDataFrame, &crsfFrame, sizeof(crsfFrame));
+                            schedulerSetFollowUpTask(TASK_RX);
+                            // only the channel data is needed by crsfFrameStatus()
+                            memcpy(&crsfChannelDataFrame.frame.payload, &crsfFrame.frame.payload, CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE);
                         }
                         break;
 
@@ -295,11 +282,15 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
 
                     case CRSF_FRAMETYPE_LINK_STATISTICS: {
                          // if to FC and 10 bytes + CRSF_FRAME_ORIGIN_DEST_SIZE
-                         if ((rssiSource == RSSI_SOURCE_RX_PROTOCOL_CRSF) &&
-                             (crsfFrame.frame.deviceAddress == CRSF_ADDRESS_FLIGHT_CONTROLLER) &&
+                         if ((crsfFrame.frame.deviceAddress == CRSF_ADDRESS_FLIGHT_CONTROLLER) &&
                              (crsfFrame.frame.frameLength == CRSF_FRAME_ORIGIN_DEST_SIZE + CRSF_FRAME_LINK_STATISTICS_PAYLOAD_SIZE)) {
                              const crsfLinkStatistics_t* statsFrame = (const crsfLinkStatistics_t*)&crsfFrame.frame.payload;
-                             handleCrsfLinkStatisticsFrame(statsFrame, currentTimeUs);
+                             // the telemetry schedule adapts to the downlink whatever the RSSI source is
+                             downlinkLinkQuality = statsFrame->downlink_Link_quality;
+                             lastDownlinkStatisticsUs = currentTimeUs;
+                             if (rssiSource == RSSI_SOURCE_RX_PROTOCOL_CRSF) {
+                                 handleCrsfLinkStatisticsFrame(statsFrame, currentTimeUs);
+                             }
                          }
                         break;
                     }
@@ -323,23 +314,7 @@ STATIC_UNIT_TESTED uint8_t crsfFrameStatus(rxRuntimeState_t *rxRuntimeState)
         crsfFrameDone = false;
 
         // unpack the RC channels
-        const crsfPayloadRcChannelsPacked_t* const rcChannels = (crsfPayloadRcChannelsPacked_t*)&crsfChannelDataFrame.frame.payload;
-        crsfChannelData[0] = rcChannels->chan0;
-        crsfChannelData[1] = rcChannels->chan1;
-        crsfChannelData[2] = rcChannels->chan2;
-        crsfChannelData[3] = rcChannels->chan3;
-        crsfChannelData[4] = rcChannels->chan4;
-        crsfChannelData[5] = rcChannels->chan5;
-        crsfChannelData[6] = rcChannels->chan6;
-        crsfChannelData[7] = rcChannels->chan7;
-        crsfChannelData[8] = rcChannels->chan8;
-        crsfChannelData[9] = rcChannels->chan9;
-        crsfChannelData[10] = rcChannels->chan10;
-        crsfChannelData[11] = rcChannels->chan11;
-        crsfChannelData[12] = rcChannels->chan12;
-        crsfChannelData[13] = rcChannels->chan13;
-        crsfChannelData[14] = rcChannels->chan14;
-        crsfChannelData[15] = rcChannels->chan15;
+        unpackChannels11Bit(crsfChannelData, (const uint8_t *)&crsfChannelDataFrame.frame.payload);
         return RX_FRAME_COMPLETE;
     }
     return RX_FRAME_PENDING;
@@ -419,6 +394,17 @@ bool crsfRxInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
     return serialPort != NULL;
 }
 
+// Downlink (telemetry) link quality in percent reported by the receiver, 100 if it isn't known
+uint8_t crsfRxGetDownlinkLinkQuality(void)
+{
+#if defined(USE_CRSF_LINK_STATISTICS)
+    if (lastDownlinkStatisticsUs && cmpTimeUs(micros(), lastDownlinkStatisticsUs) <= CRSF_LINK_STATUS_UPDATE_TIMEOUT_US) {
+        return downlinkLinkQuality;
+    }
+#endif
+    return 100;
+}
+
 bool crsfRxIsActive(void)
 {
     return serialPort != NULL;
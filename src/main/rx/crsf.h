@@ -60,3 +60,4 @@ struct rxConfig_s;
 struct rxRuntimeState_s;
 bool crsfRxInit(const struct rxConfig_s *initialRxConfig, struct rxRuntimeState_s *rxRuntimeState);
 bool crsfRxIsActive(void);
+uint8_t crsfRxGetDownlinkLinkQuality(void);
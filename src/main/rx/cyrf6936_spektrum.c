@@ -458,7 +458,7 @@ static void checkTimeout(void)
             break;
 #ifdef USE_RX_SPEKTRUM_TELEMETRY
         case DSM_RECEIVER_TLM:
-            DEBUG_SET(DEBUG_RX_SPEKTRUM_SPI, 2, (cyrf6936ReadRegister(CYRF6936_TX_IRQ_STATUS) & CYRF6936_TXC_IRQ) == 0);
+            DEBUG_SET_IF_ENABLED(DEBUG_RX_SPEKTRUM_SPI, 2, (cyrf6936ReadRegister(CYRF6936_TX_IRQ_STATUS) & CYRF6936_TXC_IRQ) == 0);
             dsmReceiverSetNextChannel();
             dsmReceiver.status = DSM_RECEIVER_RECV;
             dsmReceiver.timeout = (dsmReceiver.numChannels < 8 ? DSM_RECV_LONG_TIMEOUT_US : DSM_RECV_MID_TIMEOUT_US) - DSM_TELEMETRY_TIMEOUT_US;
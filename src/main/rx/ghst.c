@@ -46,6 +46,8 @@
 #include "rx/rx.h"
 #include "rx/ghst.h"
 
+#include "scheduler/scheduler.h"
+
 #include "telemetry/ghst.h"
 
 #define GHST_PORT_OPTIONS               (SERIAL_STOPBITS_1 | SERIAL_PARITY_NO | SERIAL_BIDIR | SERIAL_BIDIR_PP)
@@ -163,6 +165,7 @@ STATIC_UNIT_TESTED void ghstDataReceive(uint16_t c, void *data)
             // handled in ghstFrameStatus
             memcpy(&ghstValidatedFrame, &ghstIncomingFrame, sizeof(ghstIncomingFrame));
             ghstFrameAvailable = true;
+            schedulerSetFollowUpTask(TASK_RX);
 
             // remember what time the incoming (Rx) packet ended, so that we can ensure a quite bus before sending telemetry
             ghstRxFrameEndAtUs = microsISR();
@@ -106,7 +106,6 @@ static uint32_t needRxSignalMaxDelayUs;
 static uint32_t suspendRxSignalUntil = 0;
 static uint8_t  skipRxSamples = 0;
 
-static int16_t rcRaw[MAX_SUPPORTED_RC_CHANNEL_COUNT];     // interval [1000;2000]
 int16_t rcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];     // interval [1000;2000]
 uint32_t rcInvalidPulsPeriod[MAX_SUPPORTED_RC_CHANNEL_COUNT];
 
@@ -121,7 +120,11 @@ uint32_t rcInvalidPulsPeriod[MAX_SUPPORTED_RC_CHANNEL_COUNT];
 #define SKIP_RC_SAMPLES_ON_RESUME  2                // flush 2 samples to drop wrong measurements (timing independent)
 
 rxRuntimeState_t rxRuntimeState;
-static uint8_t rcSampleIndex = 0;
+
+#if defined(USE_PWM) || defined(USE_PPM)
+static int16_t rcSamples[MAX_SUPPORTED_RX_PARALLEL_PWM_OR_PPM_CHANNEL_COUNT][PPM_AND_PWM_SAMPLE_COUNT];
+static movingSum_t rcSampleSums[MAX_SUPPORTED_RX_PARALLEL_PWM_OR_PPM_CHANNEL_COUNT];
+#endif
 
 PG_REGISTER_ARRAY_WITH_RESET_FN(rxChannelRangeConfig_t, NON_AUX_CHANNEL_COUNT, rxChannelRangeConfigs, PG_RX_CHANNEL_RANGE_CONFIG, 0);
 void pgResetFn_rxChannelRangeConfigs(rxChannelRangeConfig_t *rxChannelRangeConfigs)
@@ -276,7 +279,11 @@ void rxInit(void)
     rxRuntimeState.rcReadRawFn = nullReadRawRC;
     rxRuntimeState.rcFrameStatusFn = nullFrameStatus;
     rxRuntimeState.rcProcessFrameFn = nullProcessFrame;
-    rcSampleIndex = 0;
+#if defined(USE_PWM) || defined(USE_PPM)
+    for (int i = 0; i < MAX_SUPPORTED_RX_PARALLEL_PWM_OR_PPM_CHANNEL_COUNT; i++) {
+        movingSumInit(&rcSampleSums[i], rcSamples[i], PPM_AND_PWM_SAMPLE_COUNT);
+    }
+#endif
     needRxSignalMaxDelayUs = DELAY_10_HZ;
 
     for (int i = 0; i < MAX_SUPPORTED_RC_CHANNEL_COUNT; i++) {
@@ -400,16 +407,12 @@ void resumeRxPwmPpmSignal(void)
 #ifdef USE_RX_LINK_QUALITY_INFO
 #define LINK_QUALITY_SAMPLE_COUNT 16
 
+static int16_t linkQualitySamples[LINK_QUALITY_SAMPLE_COUNT];
+static movingSum_t linkQualitySum = { .buf = linkQualitySamples, .windowSize = LINK_QUALITY_SAMPLE_COUNT };
+
 STATIC_UNIT_TESTED uint16_t updateLinkQualitySamples(uint16_t value)
 {
-    static uint16_t samples[LINK_QUALITY_SAMPLE_COUNT];
-    static uint8_t sampleIndex = 0;
-    static uint16_t sum = 0;
-
-    sum += value - samples[sampleIndex];
-    samples[sampleIndex] = value;
-    sampleIndex = (sampleIndex + 1) % LINK_QUALITY_SAMPLE_COUNT;
-    return sum / LINK_QUALITY_SAMPLE_COUNT;
+    return movingSumUpdate(&linkQualitySum, value) / LINK_QUALITY_SAMPLE_COUNT;
 }
 
 void rxSetRfMode(uint8_t rfModeValue)
@@ -523,28 +526,15 @@ bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs)
 #if defined(USE_PWM) || defined(USE_PPM)
 static uint16_t calculateChannelMovingAverage(uint8_t chan, uint16_t sample)
 {
-    static int16_t rcSamples[MAX_SUPPORTED_RX_PARALLEL_PWM_OR_PPM_CHANNEL_COUNT][PPM_AND_PWM_SAMPLE_COUNT];
-    static int16_t rcDataMean[MAX_SUPPORTED_RX_PARALLEL_PWM_OR_PPM_CHANNEL_COUNT];
-    static bool rxSamplesCollected = false;
-
-    const uint8_t currentSampleIndex = rcSampleIndex % PPM_AND_PWM_SAMPLE_COUNT;
-
-    // update the recent samples and compute the average of them
-    rcSamples[chan][currentSampleIndex] = sample;
+    movingSum_t *channelSum = &rcSampleSums[chan];
+    const int32_t sum = movingSumUpdate(channelSum, sample);
 
     // avoid returning an incorrect average which would otherwise occur before enough samples
-    if (!rxSamplesCollected) {
-        if (rcSampleIndex < PPM_AND_PWM_SAMPLE_COUNT) {
-            return sample;
-        }
-        rxSamplesCollected = true;
+    if (!channelSum->primed) {
+        return sample;
     }
 
-    rcDataMean[chan] = 0;
-    for (int sampleIndex = 0; sampleIndex < PPM_AND_PWM_SAMPLE_COUNT; sampleIndex++) {
-        rcDataMean[chan] += rcSamples[chan][sampleIndex];
-    }
-    return rcDataMean[chan] / PPM_AND_PWM_SAMPLE_COUNT;
+    return sum / PPM_AND_PWM_SAMPLE_COUNT;
 }
 #endif
 
@@ -591,33 +581,18 @@ STATIC_UNIT_TESTED uint16_t applyRxChannelRangeConfiguraton(int sample, const rx
     return sample;
 }
 
-static void readRxChannelsApplyRanges(void)
+static uint16_t readRxChannel(uint8_t rawChannel)
 {
-    for (int channel = 0; channel < rxChannelCount; channel++) {
-
-        const uint8_t rawChannel = channel < RX_MAPPABLE_CHANNEL_COUNT ? rxConfig()->rcmap[channel] : channel;
-
-        // sample the channel
-        uint16_t sample;
 #if defined(USE_RX_MSP_OVERRIDE)
-        if (rxConfig()->msp_override_channels_mask) {
-            sample = rxMspOverrideReadRawRc(&rxRuntimeState, rxConfig(), rawChannel);
-        } else
-#endif
-        {
-            sample = rxRuntimeState.rcReadRawFn(&rxRuntimeState, rawChannel);
-        }
-
-        // apply the rx calibration
-        if (channel < NON_AUX_CHANNEL_COUNT) {
-            sample = applyRxChannelRangeConfiguraton(sample, rxChannelRangeConfigs(channel));
-        }
-
-        rcRaw[channel] = sample;
+    if (rxConfig()->msp_override_channels_mask) {
+        return rxMspOverrideReadRawRc(&rxRuntimeState, rxConfig(), rawChannel);
     }
+#endif
+    return rxRuntimeState.rcReadRawFn(&rxRuntimeState, rawChannel);
 }
 
-static void detectAndApplySignalLossBehaviour(void)
+// Sample, remap and calibrate each channel and apply the signal loss behaviour in a single pass
+static void readRxChannelsAndApplySignalLossBehaviour(void)
 {
     const uint32_t currentTimeMs = millis();
 
@@ -626,9 +601,22 @@ static void detectAndApplySignalLossBehaviour(void)
     DEBUG_SET(DEBUG_RX_SIGNAL_LOSS, 0, rxSignalReceived);
     DEBUG_SET(DEBUG_RX_SIGNAL_LOSS, 1, rxIsInFailsafeMode);
 
+#if defined(USE_PWM) || defined(USE_PPM)
+    const bool smoothChannels = rxRuntimeState.rxProvider == RX_PROVIDER_PARALLEL_PWM || rxRuntimeState.rxProvider == RX_PROVIDER_PPM;
+#endif
+    const uint8_t *rcmap = rxConfig()->rcmap;
+    const rxChannelRangeConfig_t *ranges = rxChannelRangeConfigs(0);
+
     rxFlightChannelsValid = true;
     for (int channel = 0; channel < rxChannelCount; channel++) {
-        uint16_t sample = rcRaw[channel];
+        const bool isFlightChannel = channel < NON_AUX_CHANNEL_COUNT;
+
+        uint16_t sample = readRxChannel(channel < RX_MAPPABLE_CHANNEL_COUNT ? rcmap[channel] : channel);
+
+        // apply the rx calibration
+        if (isFlightChannel) {
+            sample = applyRxChannelRangeConfiguraton(sample, &ranges[channel]);
+        }
 
         const bool validPulse = useValueFromRx && isPulseValid(sample);
 
@@ -639,13 +627,13 @@ static void detectAndApplySignalLossBehaviour(void)
                 continue;           // skip to next channel to hold channel value MAX_INVALID_PULS_TIME
             } else {
                 sample = getRxfailValue(channel);   // after that apply rxfail value
-                if (channel < NON_AUX_CHANNEL_COUNT) {
+                if (isFlightChannel) {
                     rxFlightChannelsValid = false;
                 }
             }
         }
 #if defined(USE_PWM) || defined(USE_PPM)
-        if (rxRuntimeState.rxProvider == RX_PROVIDER_PARALLEL_PWM || rxRuntimeState.rxProvider == RX_PROVIDER_PPM) {
+        if (smoothChannels) {
             // smooth output for PWM and PPM
             rcData[channel] = calculateChannelMovingAverage(channel, sample);
         } else
@@ -689,10 +677,7 @@ bool calculateRxChannelsAndUpdateFailsafe(timeUs_t currentTimeUs)
         return true;
     }
 
-    readRxChannelsApplyRanges();
-    detectAndApplySignalLossBehaviour();
-
-    rcSampleIndex++;
+    readRxChannelsAndApplySignalLossBehaviour();
 
     return true;
 }
@@ -718,16 +703,12 @@ void setRssiDirect(uint16_t newRssi, rssiSource_e source)
 
 #define RSSI_SAMPLE_COUNT 16
 
+static int16_t rssiSamples[RSSI_SAMPLE_COUNT];
+static movingSum_t rssiSum = { .buf = rssiSamples, .windowSize = RSSI_SAMPLE_COUNT };
+
 static uint16_t updateRssiSamples(uint16_t value)
 {
-    static uint16_t samples[RSSI_SAMPLE_COUNT];
-    static uint8_t sampleIndex = 0;
-    static unsigned sum = 0;
-
-    sum += value - samples[sampleIndex];
-    samples[sampleIndex] = value;
-    sampleIndex = (sampleIndex + 1) % RSSI_SAMPLE_COUNT;
-    return sum / RSSI_SAMPLE_COUNT;
+    return movingSumUpdate(&rssiSum, value) / RSSI_SAMPLE_COUNT;
 }
 
 void setRssi(uint16_t rssiValue, rssiSource_e source)
@@ -828,16 +809,12 @@ int16_t getRssiDbm(void)
 
 #define RSSI_SAMPLE_COUNT_DBM 16
 
+static int16_t rssiDbmSamples[RSSI_SAMPLE_COUNT_DBM];
+static movingSum_t rssiDbmSum = { .buf = rssiDbmSamples, .windowSize = RSSI_SAMPLE_COUNT_DBM };
+
 static int16_t updateRssiDbmSamples(int16_t value)
 {
-    static int16_t samplesdbm[RSSI_SAMPLE_COUNT_DBM];
-    static uint8_t sampledbmIndex = 0;
-    static int sumdbm = 0;
-
-    sumdbm += value - samplesdbm[sampledbmIndex];
-    samplesdbm[sampledbmIndex] = value;
-    sampledbmIndex = (sampledbmIndex + 1) % RSSI_SAMPLE_COUNT_DBM;
-    return sumdbm / RSSI_SAMPLE_COUNT_DBM;
+    return movingSumUpdate(&rssiDbmSum, value) / RSSI_SAMPLE_COUNT_DBM;
 }
 
 void setRssiDbm(int16_t rssiDbmValue, rssiSource_e source)
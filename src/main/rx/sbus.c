@@ -44,6 +44,8 @@
 #include "rx/sbus.h"
 #include "rx/sbus_channels.h"
 
+#include "scheduler/scheduler.h"
+
 /*
  * Observations
  *
@@ -136,6 +138,7 @@ static void sbusDataReceive(uint16_t c, void *data)
             sbusFrameData->done = false;
         } else {
             sbusFrameData->done = true;
+            schedulerSetFollowUpTask(TASK_RX);
             DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_FRAME_TIME, sbusFrameTime);
         }
     }
@@ -33,6 +33,7 @@
 #include "common/time.h"
 #include "common/utils.h"
 
+#include "drivers/system.h"
 #include "drivers/time.h"
 
 #include "fc/core.h"
@@ -44,10 +45,41 @@
 #define TASK_AVERAGE_EXECUTE_PADDING_US 5   // Add a little padding to the average execution time
 
 // DEBUG_SCHEDULER, timings for:
-// 0 - gyroUpdate()
-// 1 - pidController()
-// 2 - time spent in scheduler
-// 3 - time spent executing check function
+// 0 - number of tasks examined by the scheduler this cycle
+// 1 - number of time driven tasks skipped as not yet due
+// 2 - time spent in scheduler, in 0.1us
+// 3 - time spent executing check function, in 0.1us
+
+#if defined(USE_SCHEDULER_CLOCK)
+#if defined(USE_TASK_STATISTICS_CYCLE_COUNTER)
+#error "USE_SCHEDULER_CLOCK measures the task statistics on the scheduler clock, not with the cycle counter"
+#endif
+static const schedulerClock_t *schedulerClock;
+static const schedulerCostModel_t *schedulerCostModel;
+
+static timeUs_t schedulerMicros(void)
+{
+    return schedulerClock ? schedulerClock->now() : micros();
+}
+#else
+#define schedulerMicros()       micros()
+#endif
+
+#if defined(USE_TASK_STATISTICS_CYCLE_COUNTER)
+// Execution times are measured with the DWT cycle counter, which is cheaper to read and finer grained
+// than micros(), and only converted to time when they are reported
+#define statsTimeNow()          getCycleCounter()
+#define statsTimeToUs(t)        clockCyclesToMicros(t)
+#define statsTimeTo10thUs(t)    clockCyclesTo10thMicros(t)
+#define statsTimeToNs(t)        clockCyclesToNanos(t)
+#define statsTotalTimeToUs(t)   ((timeUs_t)((t) / clockMicrosToCycles(1)))
+#else
+#define statsTimeNow()          schedulerMicros()
+#define statsTimeToUs(t)        (t)
+#define statsTimeTo10thUs(t)    ((t) * 10)
+#define statsTimeToNs(t)        ((t) * 1000)
+#define statsTotalTimeToUs(t)   ((timeUs_t)(t))
+#endif
 
 static FAST_DATA_ZERO_INIT task_t *currentTask = NULL;
 
@@ -62,16 +94,121 @@ STATIC_UNIT_TESTED FAST_DATA_ZERO_INIT int taskQueueSize = 0;
 
 static FAST_DATA int periodCalculationBasisOffset = offsetof(task_t, lastExecutedAtUs);
 static FAST_DATA_ZERO_INIT bool gyroEnabled;
+#if defined(USE_GYRO_EXTI_REALTIME)
+static FAST_DATA_ZERO_INIT bool realtimeInterruptEnabled;
+#endif
+// Event driven task flagged from interrupt context as having fresh data, it runs ahead of the priority order
+static FAST_DATA_ZERO_INIT task_t * volatile followUpTask;
+
+// Load governor, stretches the periods of the tasks given a maximum period while the system load is high
+#define LOAD_GOVERNOR_HYSTERESIS_PERCENT 10
+#define LOAD_GOVERNOR_STRETCH_STEP_UP_PERCENT 50
+#define LOAD_GOVERNOR_STRETCH_STEP_DOWN_PERCENT 25
+#define LOAD_GOVERNOR_STRETCH_MAX_PERCENT 1000
+
+static uint8_t loadGovernorThresholdPercent;  // 0 if the governor is disabled
+static uint16_t loadGovernorStretchPercent = LOAD_PERCENTAGE_ONE;
 
 // No need for a linked list for the queue, since items are only inserted at startup
 
 STATIC_UNIT_TESTED FAST_DATA_ZERO_INIT task_t* taskQueueArray[TASK_COUNT + 1]; // extra item for NULL pointer at end of queue
 
+// The enabled non-realtime tasks are additionally split into two ready queues so that the scheduler
+// only has to examine the tasks which can actually run:
+// - time driven tasks are kept in order of their next due time, so the scan stops at the first task that isn't due
+// - event driven tasks are kept in priority order and have their checkFunc polled every cycle
+STATIC_UNIT_TESTED FAST_DATA_ZERO_INIT task_t* taskDueQueueArray[TASK_COUNT + 1];
+STATIC_UNIT_TESTED FAST_DATA_ZERO_INIT int taskDueQueueSize = 0;
+STATIC_UNIT_TESTED FAST_DATA_ZERO_INIT task_t* taskEventQueueArray[TASK_COUNT + 1];
+STATIC_UNIT_TESTED FAST_DATA_ZERO_INIT int taskEventQueueSize = 0;
+
+static inline timeUs_t taskDueAtUs(const task_t *task)
+{
+    return task->lastExecutedAtUs + task->desiredPeriodUs;
+}
+
+static int readyQueueIndexOf(task_t * const *queue, int queueSize, const task_t *task)
+{
+    for (int ii = 0; ii < queueSize; ++ii) {
+        if (queue[ii] == task) {
+            return ii;
+        }
+    }
+    return -1;
+}
+
+static void dueQueueInsert(task_t *task)
+{
+    const timeUs_t dueAtUs = taskDueAtUs(task);
+    int ii = taskDueQueueSize;
+    // Scan backwards as a task which has just been executed will normally be due last
+    while (ii > 0 && cmpTimeUs(taskDueAtUs(taskDueQueueArray[ii - 1]), dueAtUs) > 0) {
+        taskDueQueueArray[ii] = taskDueQueueArray[ii - 1];
+        --ii;
+    }
+    taskDueQueueArray[ii] = task;
+    ++taskDueQueueSize;
+}
+
+static void eventQueueInsert(task_t *task)
+{
+    int ii = taskEventQueueSize;
+    while (ii > 0 && taskEventQueueArray[ii - 1]->staticPriority < task->staticPriority) {
+        taskEventQueueArray[ii] = taskEventQueueArray[ii - 1];
+        --ii;
+    }
+    taskEventQueueArray[ii] = task;
+    ++taskEventQueueSize;
+}
+
+static void readyQueueAdd(task_t *task)
+{
+    if (task->staticPriority == TASK_PRIORITY_REALTIME) {
+        // Realtime tasks are run directly by the scheduler
+        return;
+    }
+    if (task->checkFunc) {
+        eventQueueInsert(task);
+    } else {
+        dueQueueInsert(task);
+    }
+}
+
+static void readyQueueRemove(task_t *task)
+{
+    int ii = readyQueueIndexOf(taskDueQueueArray, taskDueQueueSize, task);
+    if (ii >= 0) {
+        memmove(&taskDueQueueArray[ii], &taskDueQueueArray[ii + 1], sizeof(task) * (taskDueQueueSize - ii));
+        --taskDueQueueSize;
+        return;
+    }
+    ii = readyQueueIndexOf(taskEventQueueArray, taskEventQueueSize, task);
+    if (ii >= 0) {
+        memmove(&taskEventQueueArray[ii], &taskEventQueueArray[ii + 1], sizeof(task) * (taskEventQueueSize - ii));
+        --taskEventQueueSize;
+    }
+}
+
+// Restore the due time ordering after a task's last execution time or period has changed
+static void dueQueueReposition(task_t *task)
+{
+    const int ii = readyQueueIndexOf(taskDueQueueArray, taskDueQueueSize, task);
+    if (ii >= 0) {
+        memmove(&taskDueQueueArray[ii], &taskDueQueueArray[ii + 1], sizeof(task) * (taskDueQueueSize - ii));
+        --taskDueQueueSize;
+        dueQueueInsert(task);
+    }
+}
+
 void queueClear(void)
 {
     memset(taskQueueArray, 0, sizeof(taskQueueArray));
     taskQueuePos = 0;
     taskQueueSize = 0;
+    memset(taskDueQueueArray, 0, sizeof(taskDueQueueArray));
+    taskDueQueueSize = 0;
+    memset(taskEventQueueArray, 0, sizeof(taskEventQueueArray));
+    taskEventQueueSize = 0;
 }
 
 bool queueContains(task_t *task)
@@ -94,6 +231,7 @@ bool queueAdd(task_t *task)
             memmove(&taskQueueArray[ii+1], &taskQueueArray[ii], sizeof(task) * (taskQueueSize - ii));
             taskQueueArray[ii] = task;
             ++taskQueueSize;
+            readyQueueAdd(task);
             return true;
         }
     }
@@ -106,6 +244,7 @@ bool queueRemove(task_t *task)
         if (taskQueueArray[ii] == task) {
             memmove(&taskQueueArray[ii], &taskQueueArray[ii+1], sizeof(task) * (taskQueueSize - ii));
             --taskQueueSize;
+            readyQueueRemove(task);
             return true;
         }
     }
@@ -129,6 +268,75 @@ FAST_CODE task_t *queueNext(void)
     return taskQueueArray[++taskQueuePos]; // guaranteed to be NULL at end of queue
 }
 
+static timeDelta_t governedPeriodUs(const task_t *task)
+{
+    if (task->maxPeriodUs == 0) {
+        return task->nominalPeriodUs;
+    }
+    const timeDelta_t stretchedPeriodUs = task->nominalPeriodUs * loadGovernorStretchPercent / LOAD_PERCENTAGE_ONE;
+    return MAX(task->nominalPeriodUs, MIN(stretchedPeriodUs, task->maxPeriodUs));
+}
+
+static void loadGovernorApply(void)
+{
+    for (taskId_e taskId = 0; taskId < TASK_COUNT; taskId++) {
+        task_t *task = getTask(taskId);
+        if (task->maxPeriodUs) {
+            const timeDelta_t periodUs = governedPeriodUs(task);
+            if (periodUs != task->desiredPeriodUs) {
+                task->desiredPeriodUs = periodUs;
+                dueQueueReposition(task);
+            }
+        }
+    }
+}
+
+STATIC_UNIT_TESTED void loadGovernorUpdate(uint16_t loadPercent)
+{
+    uint16_t stretchPercent = loadGovernorStretchPercent;
+
+    if (loadGovernorThresholdPercent == 0) {
+        stretchPercent = LOAD_PERCENTAGE_ONE;
+    } else if (loadPercent > loadGovernorThresholdPercent) {
+        stretchPercent = MIN(stretchPercent + LOAD_GOVERNOR_STRETCH_STEP_UP_PERCENT, LOAD_GOVERNOR_STRETCH_MAX_PERCENT);
+    } else if (loadPercent + LOAD_GOVERNOR_HYSTERESIS_PERCENT < loadGovernorThresholdPercent) {
+        stretchPercent = MAX(stretchPercent - LOAD_GOVERNOR_STRETCH_STEP_DOWN_PERCENT, LOAD_PERCENTAGE_ONE);
+    }
+
+    if (stretchPercent != loadGovernorStretchPercent) {
+        loadGovernorStretchPercent = stretchPercent;
+        loadGovernorApply();
+    }
+}
+
+// Allow the load governor to stretch the period of the task up to maxPeriodUs, 0 to exclude the task
+void schedulerSetTaskMaxPeriod(taskId_e taskId, timeDelta_t maxPeriodUs)
+{
+    if (taskId < TASK_COUNT) {
+        task_t *task = getTask(taskId);
+        if (task->maxPeriodUs == 0) {
+            task->nominalPeriodUs = task->desiredPeriodUs;
+        }
+        task->maxPeriodUs = maxPeriodUs;
+        task->desiredPeriodUs = governedPeriodUs(task);
+        dueQueueReposition(task);
+    }
+}
+
+// Stretch the governed task periods while the average system load is above loadPercent, 0 to disable
+void schedulerSetLoadGovernor(uint8_t loadPercent)
+{
+    loadGovernorThresholdPercent = loadPercent;
+    if (loadPercent == 0) {
+        loadGovernorUpdate(0);
+    }
+}
+
+uint16_t getLoadGovernorStretchPercent(void)
+{
+    return loadGovernorStretchPercent;
+}
+
 void taskSystemLoad(timeUs_t currentTimeUs)
 {
     UNUSED(currentTimeUs);
@@ -142,20 +350,69 @@ void taskSystemLoad(timeUs_t currentTimeUs)
 #if defined(SIMULATOR_BUILD)
     averageSystemLoadPercent = 0;
 #endif
+
+    loadGovernorUpdate(averageSystemLoadPercent);
 }
 
 #if defined(USE_TASK_STATISTICS)
-timeUs_t checkFuncMaxExecutionTimeUs;
-timeUs_t checkFuncTotalExecutionTimeUs;
-timeUs_t checkFuncMovingSumExecutionTimeUs;
+uint32_t checkFuncMaxExecutionTime;
+uint64_t checkFuncTotalExecutionTime;
+uint32_t checkFuncMovingSumExecutionTime;
 timeUs_t checkFuncMovingSumDeltaTimeUs;
+static taskHistogram_t checkFuncHistogram;
 
 void getCheckFuncInfo(cfCheckFuncInfo_t *checkFuncInfo)
 {
-    checkFuncInfo->maxExecutionTimeUs = checkFuncMaxExecutionTimeUs;
-    checkFuncInfo->totalExecutionTimeUs = checkFuncTotalExecutionTimeUs;
-    checkFuncInfo->averageExecutionTimeUs = checkFuncMovingSumExecutionTimeUs / TASK_STATS_MOVING_SUM_COUNT;
+    checkFuncInfo->maxExecutionTimeUs = statsTimeToUs(checkFuncMaxExecutionTime);
+    checkFuncInfo->totalExecutionTimeUs = statsTotalTimeToUs(checkFuncTotalExecutionTime);
+    checkFuncInfo->averageExecutionTimeUs = statsTimeToUs(checkFuncMovingSumExecutionTime / TASK_STATS_MOVING_SUM_COUNT);
     checkFuncInfo->averageDeltaTimeUs = checkFuncMovingSumDeltaTimeUs / TASK_STATS_MOVING_SUM_COUNT;
+    checkFuncInfo->maxExecutionTimeNs = statsTimeToNs(checkFuncMaxExecutionTime);
+    checkFuncInfo->averageExecutionTimeNs = statsTimeToNs(checkFuncMovingSumExecutionTime / TASK_STATS_MOVING_SUM_COUNT);
+}
+
+void getCheckFuncHistogram(taskHistogram_t *histogram)
+{
+    *histogram = checkFuncHistogram;
+}
+
+void getTaskHistogram(taskId_e taskId, taskHistogram_t *histogram)
+{
+    *histogram = getTask(taskId)->executionTimeHistogram;
+}
+
+static void taskHistogramAdd(taskHistogram_t *histogram, timeUs_t executionTimeUs)
+{
+    const int bucket = executionTimeUs ? MIN(32 - __builtin_clz(executionTimeUs), TASK_STATS_HISTOGRAM_BUCKET_COUNT - 1) : 0;
+    if (histogram->count[bucket] == UINT16_MAX) {
+        // Halve all the counts, this keeps the shape of the distribution
+        for (int ii = 0; ii < TASK_STATS_HISTOGRAM_BUCKET_COUNT; ii++) {
+            histogram->count[ii] >>= 1;
+        }
+    }
+    histogram->count[bucket]++;
+}
+
+// Returns the upper bound of the bucket containing the given percentile, 0 if the histogram is empty
+timeUs_t taskHistogramPercentileUs(const taskHistogram_t *histogram, uint16_t permille)
+{
+    uint32_t total = 0;
+    for (int ii = 0; ii < TASK_STATS_HISTOGRAM_BUCKET_COUNT; ii++) {
+        total += histogram->count[ii];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    const uint32_t threshold = (total * permille + 999) / 1000;
+    uint32_t sum = 0;
+    for (int ii = 0; ii < TASK_STATS_HISTOGRAM_BUCKET_COUNT; ii++) {
+        sum += histogram->count[ii];
+        if (sum >= threshold) {
+            return 1 << ii;
+        }
+    }
+    return 1 << (TASK_STATS_HISTOGRAM_BUCKET_COUNT - 1);
 }
 #endif
 
@@ -167,23 +424,26 @@ void getTaskInfo(taskId_e taskId, taskInfo_t * taskInfo)
 #if defined(USE_TASK_STATISTICS)
     taskInfo->taskName = getTask(taskId)->taskName;
     taskInfo->subTaskName = getTask(taskId)->subTaskName;
-    taskInfo->maxExecutionTimeUs = getTask(taskId)->maxExecutionTimeUs;
-    taskInfo->totalExecutionTimeUs = getTask(taskId)->totalExecutionTimeUs;
-    taskInfo->averageExecutionTimeUs = getTask(taskId)->movingSumExecutionTimeUs / TASK_STATS_MOVING_SUM_COUNT;
+    taskInfo->maxExecutionTimeUs = statsTimeToUs(getTask(taskId)->maxExecutionTime);
+    taskInfo->totalExecutionTimeUs = statsTotalTimeToUs(getTask(taskId)->totalExecutionTime);
+    taskInfo->averageExecutionTimeUs = statsTimeToUs(getTask(taskId)->movingSumExecutionTime / TASK_STATS_MOVING_SUM_COUNT);
+    taskInfo->maxExecutionTimeNs = statsTimeToNs(getTask(taskId)->maxExecutionTime);
+    taskInfo->averageExecutionTimeNs = statsTimeToNs(getTask(taskId)->movingSumExecutionTime / TASK_STATS_MOVING_SUM_COUNT);
     taskInfo->averageDeltaTimeUs = getTask(taskId)->movingSumDeltaTimeUs / TASK_STATS_MOVING_SUM_COUNT;
     taskInfo->latestDeltaTimeUs = getTask(taskId)->taskLatestDeltaTimeUs;
     taskInfo->movingAverageCycleTimeUs = getTask(taskId)->movingAverageCycleTimeUs;
+    taskInfo->maxJitterUs = getTask(taskId)->maxJitterUs;
+    taskInfo->averageJitterUs = getTask(taskId)->movingSumJitterUs / TASK_STATS_MOVING_SUM_COUNT;
 #endif
 }
 
 void rescheduleTask(taskId_e taskId, timeDelta_t newPeriodUs)
 {
-    if (taskId == TASK_SELF) {
-        task_t *task = currentTask;
-        task->desiredPeriodUs = MAX(SCHEDULER_DELAY_LIMIT, newPeriodUs);  // Limit delay to 100us (10 kHz) to prevent scheduler clogging
-    } else if (taskId < TASK_COUNT) {
-        task_t *task = getTask(taskId);
-        task->desiredPeriodUs = MAX(SCHEDULER_DELAY_LIMIT, newPeriodUs);  // Limit delay to 100us (10 kHz) to prevent scheduler clogging
+    if (taskId == TASK_SELF || taskId < TASK_COUNT) {
+        task_t *task = taskId == TASK_SELF ? currentTask : getTask(taskId);
+        task->nominalPeriodUs = MAX(SCHEDULER_DELAY_LIMIT, newPeriodUs);  // Limit delay to 100us (10 kHz) to prevent scheduler clogging
+        task->desiredPeriodUs = governedPeriodUs(task);
+        dueQueueReposition(task);
     }
 }
 
@@ -219,15 +479,21 @@ void schedulerResetTaskStatistics(taskId_e taskId)
 {
 #if defined(USE_TASK_STATISTICS)
     if (taskId == TASK_SELF) {
-        currentTask->movingSumExecutionTimeUs = 0;
+        currentTask->movingSumExecutionTime = 0;
         currentTask->movingSumDeltaTimeUs = 0;
-        currentTask->totalExecutionTimeUs = 0;
-        currentTask->maxExecutionTimeUs = 0;
+        currentTask->totalExecutionTime = 0;
+        currentTask->maxExecutionTime = 0;
+        currentTask->movingSumJitterUs = 0;
+        currentTask->maxJitterUs = 0;
+        memset(&currentTask->executionTimeHistogram, 0, sizeof(currentTask->executionTimeHistogram));
     } else if (taskId < TASK_COUNT) {
-        getTask(taskId)->movingSumExecutionTimeUs = 0;
+        getTask(taskId)->movingSumExecutionTime = 0;
         getTask(taskId)->movingSumDeltaTimeUs = 0;
-        getTask(taskId)->totalExecutionTimeUs = 0;
-        getTask(taskId)->maxExecutionTimeUs = 0;
+        getTask(taskId)->totalExecutionTime = 0;
+        getTask(taskId)->maxExecutionTime = 0;
+        getTask(taskId)->movingSumJitterUs = 0;
+        getTask(taskId)->maxJitterUs = 0;
+        memset(&getTask(taskId)->executionTimeHistogram, 0, sizeof(getTask(taskId)->executionTimeHistogram));
     }
 #else
     UNUSED(taskId);
@@ -238,9 +504,11 @@ void schedulerResetTaskMaxExecutionTime(taskId_e taskId)
 {
 #if defined(USE_TASK_STATISTICS)
     if (taskId == TASK_SELF) {
-        currentTask->maxExecutionTimeUs = 0;
+        currentTask->maxExecutionTime = 0;
+        currentTask->maxJitterUs = 0;
     } else if (taskId < TASK_COUNT) {
-        getTask(taskId)->maxExecutionTimeUs = 0;
+        getTask(taskId)->maxExecutionTime = 0;
+        getTask(taskId)->maxJitterUs = 0;
     }
 #else
     UNUSED(taskId);
@@ -250,13 +518,14 @@ void schedulerResetTaskMaxExecutionTime(taskId_e taskId)
 #if defined(USE_TASK_STATISTICS)
 void schedulerResetCheckFunctionMaxExecutionTime(void)
 {
-    checkFuncMaxExecutionTimeUs = 0;
+    checkFuncMaxExecutionTime = 0;
 }
 #endif
 
 void schedulerInit(void)
 {
     calculateTaskStatistics = true;
+    loadGovernorStretchPercent = LOAD_PERCENTAGE_ONE;
     queueClear();
     queueAdd(getTask(TASK_SYSTEM));
 }
@@ -275,9 +544,34 @@ inline static timeUs_t getPeriodCalculationBasis(const task_t* task)
     }
 }
 
-FAST_CODE timeUs_t schedulerExecuteTask(task_t *selectedTask, timeUs_t currentTimeUs)
+// With a scheduler cost model the clock is advanced by the modelled time of each task and check function call
+static inline void schedulerChargeTask(const task_t *task, timeUs_t currentTimeUs)
+{
+#if defined(USE_SCHEDULER_CLOCK)
+    if (schedulerCostModel && schedulerCostModel->taskCostUs) {
+        schedulerClock->advance(schedulerCostModel->taskCostUs(task, currentTimeUs));
+    }
+#else
+    UNUSED(task);
+    UNUSED(currentTimeUs);
+#endif
+}
+
+static inline bool schedulerCheckTask(task_t *task, timeUs_t currentTimeUs)
+{
+    const bool signalled = task->checkFunc(currentTimeUs, cmpTimeUs(currentTimeUs, task->lastExecutedAtUs));
+#if defined(USE_SCHEDULER_CLOCK)
+    if (schedulerCostModel && schedulerCostModel->checkFuncCostUs) {
+        schedulerClock->advance(schedulerCostModel->checkFuncCostUs(task, currentTimeUs, signalled));
+    }
+#endif
+    return signalled;
+}
+
+// Returns the execution time of the task if task statistics are being calculated, in statistics time units
+FAST_CODE uint32_t schedulerExecuteTask(task_t *selectedTask, timeUs_t currentTimeUs)
 {
-    timeUs_t taskExecutionTimeUs = 0;
+    uint32_t taskExecutionTime = 0;
 
     if (selectedTask) {
         currentTask = selectedTask;
@@ -292,22 +586,76 @@ FAST_CODE timeUs_t schedulerExecuteTask(task_t *selectedTask, timeUs_t currentTi
         // Execute task
 #if defined(USE_TASK_STATISTICS)
         if (calculateTaskStatistics) {
-            const timeUs_t currentTimeBeforeTaskCallUs = micros();
-            selectedTask->taskFunc(currentTimeBeforeTaskCallUs);
-            taskExecutionTimeUs = micros() - currentTimeBeforeTaskCallUs;
-            selectedTask->movingSumExecutionTimeUs += taskExecutionTimeUs - selectedTask->movingSumExecutionTimeUs / TASK_STATS_MOVING_SUM_COUNT;
+#if defined(USE_TASK_STATISTICS_CYCLE_COUNTER)
+            const uint32_t taskStartTime = statsTimeNow();
+            selectedTask->taskFunc(currentTimeUs);
+#else
+            const timeUs_t taskStartTime = schedulerMicros();
+            selectedTask->taskFunc(taskStartTime);
+            schedulerChargeTask(selectedTask, taskStartTime);
+#endif
+            taskExecutionTime = statsTimeNow() - taskStartTime;
+            selectedTask->movingSumExecutionTime += taskExecutionTime - selectedTask->movingSumExecutionTime / TASK_STATS_MOVING_SUM_COUNT;
             selectedTask->movingSumDeltaTimeUs += selectedTask->taskLatestDeltaTimeUs - selectedTask->movingSumDeltaTimeUs / TASK_STATS_MOVING_SUM_COUNT;
-            selectedTask->totalExecutionTimeUs += taskExecutionTimeUs;   // time consumed by scheduler + task
-            selectedTask->maxExecutionTimeUs = MAX(selectedTask->maxExecutionTimeUs, taskExecutionTimeUs);
+            selectedTask->totalExecutionTime += taskExecutionTime;   // time consumed by scheduler + task
+            selectedTask->maxExecutionTime = MAX(selectedTask->maxExecutionTime, taskExecutionTime);
             selectedTask->movingAverageCycleTimeUs += 0.05f * (period - selectedTask->movingAverageCycleTimeUs);
+            const timeUs_t jitterUs = ABS(selectedTask->taskLatestDeltaTimeUs - selectedTask->desiredPeriodUs);
+            selectedTask->movingSumJitterUs += jitterUs - selectedTask->movingSumJitterUs / TASK_STATS_MOVING_SUM_COUNT;
+            selectedTask->maxJitterUs = MAX(selectedTask->maxJitterUs, jitterUs);
+            taskHistogramAdd(&selectedTask->executionTimeHistogram, statsTimeToUs(taskExecutionTime));
         } else
 #endif
         {
             selectedTask->taskFunc(currentTimeUs);
+            schedulerChargeTask(selectedTask, currentTimeUs);
         }
     }
 
-    return taskExecutionTimeUs;
+    return taskExecutionTime;
+}
+
+static FAST_CODE uint32_t schedulerExecuteRealtimeTasks(timeUs_t currentTimeUs)
+{
+    uint32_t taskExecutionTime = schedulerExecuteTask(getTask(TASK_GYRO), currentTimeUs);
+    if (gyroFilterReady()) {
+        taskExecutionTime += schedulerExecuteTask(getTask(TASK_FILTER), currentTimeUs);
+    }
+    if (pidLoopReady()) {
+        taskExecutionTime += schedulerExecuteTask(getTask(TASK_PID), currentTimeUs);
+    }
+    return taskExecutionTime;
+}
+
+#if defined(USE_GYRO_EXTI_REALTIME)
+// Called from the gyro data ready interrupt at NVIC_PRIO_GYRO_INT_EXTI, preempting whichever background task is running
+FAST_CODE void schedulerRealtimeInterrupt(void)
+{
+    if (!realtimeInterruptEnabled) {
+        return;
+    }
+    // The preempted task may still reference itself as TASK_SELF
+    task_t *preemptedTask = currentTask;
+    schedulerExecuteRealtimeTasks(schedulerMicros());
+    currentTask = preemptedTask;
+}
+
+void schedulerEnableRealtimeInterrupt(void)
+{
+    realtimeInterruptEnabled = true;
+}
+
+bool schedulerRealtimeInterruptEnabled(void)
+{
+    return realtimeInterruptEnabled;
+}
+#endif
+
+// On equal dynamic priority prefer the task with the higher static priority, as the ready queues are not in priority order
+static inline bool schedulerIsHigherPriority(const task_t *task, const task_t *selectedTask, uint16_t selectedTaskDynamicPriority)
+{
+    return task->dynamicPriority > selectedTaskDynamicPriority
+        || (selectedTask && task->dynamicPriority == selectedTaskDynamicPriority && task->staticPriority > selectedTask->staticPriority);
 }
 
 #if defined(UNIT_TEST)
@@ -326,88 +674,118 @@ static void readSchedulerLocals(task_t *selectedTask, uint8_t selectedTaskDynami
 FAST_CODE void scheduler(void)
 {
     // Cache currentTime
-    const timeUs_t schedulerStartTimeUs = micros();
-    timeUs_t currentTimeUs = schedulerStartTimeUs;
-    timeUs_t taskExecutionTimeUs = 0;
+    timeUs_t currentTimeUs = schedulerMicros();
+#if defined(SCHEDULER_DEBUG)
+    const uint32_t schedulerStartTime = statsTimeNow();
+#endif
+    uint32_t taskExecutionTime = 0;
     task_t *selectedTask = NULL;
     uint16_t selectedTaskDynamicPriority = 0;
     uint16_t waitingTasks = 0;
     bool realtimeTaskRan = false;
     timeDelta_t gyroTaskDelayUs = 0;
+#if defined(USE_GYRO_EXTI_REALTIME)
+    // When the realtime tasks are run from the gyro interrupt only background tasks are scheduled here
+    const bool gyroPolled = gyroEnabled && !realtimeInterruptEnabled;
+#else
+    const bool gyroPolled = gyroEnabled;
+#endif
 
-    if (gyroEnabled) {
+    if (gyroPolled) {
         // Realtime gyro/filtering/PID tasks get complete priority
         task_t *gyroTask = getTask(TASK_GYRO);
         const timeUs_t gyroExecuteTimeUs = getPeriodCalculationBasis(gyroTask) + gyroTask->desiredPeriodUs;
         gyroTaskDelayUs = cmpTimeUs(gyroExecuteTimeUs, currentTimeUs);  // time until the next expected gyro sample
         if (cmpTimeUs(currentTimeUs, gyroExecuteTimeUs) >= 0) {
-            taskExecutionTimeUs = schedulerExecuteTask(gyroTask, currentTimeUs);
-            if (gyroFilterReady()) {
-                taskExecutionTimeUs += schedulerExecuteTask(getTask(TASK_FILTER), currentTimeUs);
-            }
-            if (pidLoopReady()) {
-                taskExecutionTimeUs += schedulerExecuteTask(getTask(TASK_PID), currentTimeUs);
-            }
-            currentTimeUs = micros();
+            taskExecutionTime = schedulerExecuteRealtimeTasks(currentTimeUs);
+            currentTimeUs = schedulerMicros();
             realtimeTaskRan = true;
         }
     }
 
-    if (!gyroEnabled || realtimeTaskRan || (gyroTaskDelayUs > GYRO_TASK_GUARD_INTERVAL_US)) {
+    if (!gyroPolled || realtimeTaskRan || (gyroTaskDelayUs > GYRO_TASK_GUARD_INTERVAL_US)) {
         // The task to be invoked
 
-        // Update task dynamic priorities
-        for (task_t *task = queueFirst(); task != NULL; task = queueNext()) {
-            if (task->staticPriority != TASK_PRIORITY_REALTIME) {
-                // Task has checkFunc - event driven
-                if (task->checkFunc) {
+        // Update dynamic priorities of the time driven tasks which are due, in order of their due time
+        int dueTaskCount = 0;
+        for (; dueTaskCount < taskDueQueueSize; ++dueTaskCount) {
+            task_t *task = taskDueQueueArray[dueTaskCount];
+            // Task is time-driven, dynamicPriority is last execution age (measured in desiredPeriods)
+            // Task age is calculated from last execution
+            task->taskAgeCycles = ((currentTimeUs - task->lastExecutedAtUs) / task->desiredPeriodUs);
+            if (task->taskAgeCycles == 0) {
+                // This and all following tasks are not yet due
+                break;
+            }
+            task->dynamicPriority = 1 + task->staticPriority * task->taskAgeCycles;
+            waitingTasks++;
+
+            if (schedulerIsHigherPriority(task, selectedTask, selectedTaskDynamicPriority)) {
+                selectedTaskDynamicPriority = task->dynamicPriority;
+                selectedTask = task;
+            }
+        }
+
+        // Poll the event driven tasks
+        task_t *followUp = NULL;
+        for (int ii = 0; ii < taskEventQueueSize; ++ii) {
+            task_t *task = taskEventQueueArray[ii];
 #if defined(SCHEDULER_DEBUG)
-                    const timeUs_t currentTimeBeforeCheckFuncCallUs = micros();
+            const timeUs_t currentTimeBeforeCheckFuncCallUs = schedulerMicros();
 #else
-                    const timeUs_t currentTimeBeforeCheckFuncCallUs = currentTimeUs;
+            const timeUs_t currentTimeBeforeCheckFuncCallUs = currentTimeUs;
 #endif
-                    // Increase priority for event driven tasks
-                    if (task->dynamicPriority > 0) {
-                        task->taskAgeCycles = 1 + ((currentTimeUs - task->lastSignaledAtUs) / task->desiredPeriodUs);
-                        task->dynamicPriority = 1 + task->staticPriority * task->taskAgeCycles;
-                        waitingTasks++;
-                    } else if (task->checkFunc(currentTimeBeforeCheckFuncCallUs, cmpTimeUs(currentTimeBeforeCheckFuncCallUs, task->lastExecutedAtUs))) {
+#if defined(USE_TASK_STATISTICS_CYCLE_COUNTER)
+            const uint32_t checkFuncStartTime = statsTimeNow();
+#elif defined(SCHEDULER_DEBUG) || defined(USE_TASK_STATISTICS)
+            const timeUs_t checkFuncStartTime = currentTimeBeforeCheckFuncCallUs;
+#endif
+            // Increase priority for event driven tasks
+            if (task->dynamicPriority > 0) {
+                task->taskAgeCycles = 1 + ((currentTimeUs - task->lastSignaledAtUs) / task->desiredPeriodUs);
+                task->dynamicPriority = 1 + task->staticPriority * task->taskAgeCycles;
+                waitingTasks++;
+            } else if (schedulerCheckTask(task, currentTimeBeforeCheckFuncCallUs)) {
 #if defined(SCHEDULER_DEBUG)
-                        DEBUG_SET(DEBUG_SCHEDULER, 3, micros() - currentTimeBeforeCheckFuncCallUs);
+                DEBUG_SET(DEBUG_SCHEDULER, 3, statsTimeTo10thUs(statsTimeNow() - checkFuncStartTime));
 #endif
 #if defined(USE_TASK_STATISTICS)
-                        if (calculateTaskStatistics) {
-                            const uint32_t checkFuncExecutionTimeUs = micros() - currentTimeBeforeCheckFuncCallUs;
-                            checkFuncMovingSumExecutionTimeUs += checkFuncExecutionTimeUs - checkFuncMovingSumExecutionTimeUs / TASK_STATS_MOVING_SUM_COUNT;
-                            checkFuncMovingSumDeltaTimeUs += task->taskLatestDeltaTimeUs - checkFuncMovingSumDeltaTimeUs / TASK_STATS_MOVING_SUM_COUNT;
-                            checkFuncTotalExecutionTimeUs += checkFuncExecutionTimeUs;   // time consumed by scheduler + task
-                            checkFuncMaxExecutionTimeUs = MAX(checkFuncMaxExecutionTimeUs, checkFuncExecutionTimeUs);
-                        }
-#endif
-                        task->lastSignaledAtUs = currentTimeBeforeCheckFuncCallUs;
-                        task->taskAgeCycles = 1;
-                        task->dynamicPriority = 1 + task->staticPriority;
-                        waitingTasks++;
-                    } else {
-                        task->taskAgeCycles = 0;
-                    }
-                } else {
-                    // Task is time-driven, dynamicPriority is last execution age (measured in desiredPeriods)
-                    // Task age is calculated from last execution
-                    task->taskAgeCycles = ((currentTimeUs - getPeriodCalculationBasis(task)) / task->desiredPeriodUs);
-                    if (task->taskAgeCycles > 0) {
-                        task->dynamicPriority = 1 + task->staticPriority * task->taskAgeCycles;
-                        waitingTasks++;
-                    }
+                if (calculateTaskStatistics) {
+                    const uint32_t checkFuncExecutionTime = statsTimeNow() - checkFuncStartTime;
+                    checkFuncMovingSumExecutionTime += checkFuncExecutionTime - checkFuncMovingSumExecutionTime / TASK_STATS_MOVING_SUM_COUNT;
+                    checkFuncMovingSumDeltaTimeUs += task->taskLatestDeltaTimeUs - checkFuncMovingSumDeltaTimeUs / TASK_STATS_MOVING_SUM_COUNT;
+                    checkFuncTotalExecutionTime += checkFuncExecutionTime;   // time consumed by scheduler + task
+                    checkFuncMaxExecutionTime = MAX(checkFuncMaxExecutionTime, checkFuncExecutionTime);
+                    taskHistogramAdd(&checkFuncHistogram, statsTimeToUs(checkFuncExecutionTime));
                 }
+#endif
+                task->lastSignaledAtUs = currentTimeBeforeCheckFuncCallUs;
+                task->taskAgeCycles = 1;
+                task->dynamicPriority = 1 + task->staticPriority;
+                waitingTasks++;
+            } else {
+                task->taskAgeCycles = 0;
+            }
 
-                if (task->dynamicPriority > selectedTaskDynamicPriority) {
-                    selectedTaskDynamicPriority = task->dynamicPriority;
-                    selectedTask = task;
-                }
+            if (schedulerIsHigherPriority(task, selectedTask, selectedTaskDynamicPriority)) {
+                selectedTaskDynamicPriority = task->dynamicPriority;
+                selectedTask = task;
+            }
+            if (task == followUpTask && task->dynamicPriority > 0) {
+                followUp = task;
             }
         }
 
+        if (followUp) {
+            selectedTaskDynamicPriority = followUp->dynamicPriority;
+            selectedTask = followUp;
+        }
+
+#if defined(SCHEDULER_DEBUG)
+        DEBUG_SET(DEBUG_SCHEDULER, 0, dueTaskCount + taskEventQueueSize);
+        DEBUG_SET(DEBUG_SCHEDULER, 1, taskDueQueueSize - dueTaskCount);
+#endif
+
         totalWaitingTasksSamples++;
         totalWaitingTasks += waitingTasks;
 
@@ -415,13 +793,18 @@ FAST_CODE void scheduler(void)
             timeDelta_t taskRequiredTimeUs = TASK_AVERAGE_EXECUTE_FALLBACK_US;  // default average time if task statistics are not available
 #if defined(USE_TASK_STATISTICS)
             if (calculateTaskStatistics) {
-                taskRequiredTimeUs = selectedTask->movingSumExecutionTimeUs / TASK_STATS_MOVING_SUM_COUNT + TASK_AVERAGE_EXECUTE_PADDING_US;
+                taskRequiredTimeUs = statsTimeToUs(selectedTask->movingSumExecutionTime / TASK_STATS_MOVING_SUM_COUNT) + TASK_AVERAGE_EXECUTE_PADDING_US;
             }
 #endif
             // Add in the time spent so far in check functions and the scheduler logic
-            taskRequiredTimeUs += cmpTimeUs(micros(), currentTimeUs);
-            if (!gyroEnabled || realtimeTaskRan || (taskRequiredTimeUs < gyroTaskDelayUs)) {
-                taskExecutionTimeUs += schedulerExecuteTask(selectedTask, currentTimeUs);
+            taskRequiredTimeUs += cmpTimeUs(schedulerMicros(), currentTimeUs);
+            if (!gyroPolled || realtimeTaskRan || (taskRequiredTimeUs < gyroTaskDelayUs)) {
+                taskExecutionTime += schedulerExecuteTask(selectedTask, currentTimeUs);
+                if (!selectedTask->checkFunc) {
+                    dueQueueReposition(selectedTask);
+                } else if (selectedTask == followUpTask) {
+                    followUpTask = NULL;
+                }
             } else {
                 selectedTask = NULL;
             }
@@ -430,9 +813,15 @@ FAST_CODE void scheduler(void)
 
 
 #if defined(SCHEDULER_DEBUG)
-    DEBUG_SET(DEBUG_SCHEDULER, 2, micros() - schedulerStartTimeUs - taskExecutionTimeUs); // time spent in scheduler
+    DEBUG_SET(DEBUG_SCHEDULER, 2, statsTimeTo10thUs(statsTimeNow() - schedulerStartTime - taskExecutionTime)); // time spent in scheduler
 #else
-    UNUSED(taskExecutionTimeUs);
+    UNUSED(taskExecutionTime);
+#endif
+
+#if defined(USE_SCHEDULER_CLOCK)
+    if (schedulerCostModel) {
+        schedulerClock->advance(schedulerCostModel->passCostUs);
+    }
 #endif
 
 #if defined(UNIT_TEST)
@@ -445,6 +834,22 @@ void schedulerEnableGyro(void)
     gyroEnabled = true;
 }
 
+// Safe to call from interrupt context. The task is run by the next scheduler pass that finds it ready, as soon as
+// the realtime tasks allow, so its latency is bounded by the gyro task period rather than by the other tasks.
+FAST_CODE void schedulerSetFollowUpTask(taskId_e taskId)
+{
+    followUpTask = getTask(taskId);
+}
+
+#if defined(USE_SCHEDULER_CLOCK)
+// A cost model needs a clock to advance, passing NULL for the clock returns the scheduler to micros()
+void schedulerSetClock(const schedulerClock_t *clock, const schedulerCostModel_t *costModel)
+{
+    schedulerClock = clock;
+    schedulerCostModel = clock ? costModel : NULL;
+}
+#endif
+
 uint16_t getAverageSystemLoadPercent(void)
 {
     return averageSystemLoadPercent;
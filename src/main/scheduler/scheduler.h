@@ -31,6 +31,8 @@
 
 #if defined(USE_TASK_STATISTICS)
 #define TASK_STATS_MOVING_SUM_COUNT 32
+// Execution times are binned on a log2 scale, bucket 0 holds times below 1us and bucket n times below (1 << n) us
+#define TASK_STATS_HISTOGRAM_BUCKET_COUNT 16
 #endif
 
 #define LOAD_PERCENTAGE_ONE 100
@@ -50,8 +52,16 @@ typedef struct {
     timeUs_t     totalExecutionTimeUs;
     timeUs_t     averageExecutionTimeUs;
     timeUs_t     averageDeltaTimeUs;
+    uint32_t     maxExecutionTimeNs;
+    uint32_t     averageExecutionTimeNs;
 } cfCheckFuncInfo_t;
 
+#if defined(USE_TASK_STATISTICS)
+typedef struct {
+    uint16_t count[TASK_STATS_HISTOGRAM_BUCKET_COUNT];
+} taskHistogram_t;
+#endif
+
 typedef struct {
     const char * taskName;
     const char * subTaskName;
@@ -64,6 +74,10 @@ typedef struct {
     timeUs_t     averageExecutionTimeUs;
     timeUs_t     averageDeltaTimeUs;
     float        movingAverageCycleTimeUs;
+    timeUs_t     maxJitterUs;
+    timeUs_t     averageJitterUs;
+    uint32_t     maxExecutionTimeNs;
+    uint32_t     averageExecutionTimeNs;
 } taskInfo_t;
 
 typedef enum {
@@ -145,6 +159,14 @@ typedef enum {
     TASK_PINIOBOX,
 #endif
 
+#ifdef USE_BLACKBOX
+    TASK_BLACKBOX,
+#endif
+
+#ifdef USE_FLASHFS
+    TASK_FLASHFS,
+#endif
+
     /* Count of real tasks */
     TASK_COUNT,
 
@@ -163,6 +185,8 @@ typedef struct {
     void (*taskFunc)(timeUs_t currentTimeUs);
     timeDelta_t desiredPeriodUs;      // target period of execution
     const int8_t staticPriority;    // dynamicPriority grows in steps of this size
+    timeDelta_t maxPeriodUs;          // longest period the load governor may stretch to, 0 if not governed
+    timeDelta_t nominalPeriodUs;      // period set by rescheduleTask() before any stretching, only used if governed
 
     // Scheduling
     uint16_t dynamicPriority;       // measurement of how old task was last executed, used to avoid task starvation
@@ -173,17 +197,41 @@ typedef struct {
     timeUs_t lastDesiredAt;         // time of last desired execution
 
 #if defined(USE_TASK_STATISTICS)
-    // Statistics
+    // Statistics, execution times are in CPU cycles with USE_TASK_STATISTICS_CYCLE_COUNTER, otherwise in us
     float    movingAverageCycleTimeUs;
-    timeUs_t movingSumExecutionTimeUs;  // moving sum over 32 samples
+    uint32_t movingSumExecutionTime;  // moving sum over 32 samples
     timeUs_t movingSumDeltaTimeUs;  // moving sum over 32 samples
-    timeUs_t maxExecutionTimeUs;
-    timeUs_t totalExecutionTimeUs;    // total time consumed by task since boot
+    uint32_t maxExecutionTime;
+    uint64_t totalExecutionTime;    // total time consumed by task since boot
+    timeUs_t movingSumJitterUs;       // moving sum over 32 samples of the deviation from desiredPeriodUs
+    timeUs_t maxJitterUs;
+    taskHistogram_t executionTimeHistogram;
 #endif
 } task_t;
 
+#if defined(USE_SCHEDULER_CLOCK)
+// Time source and task cost model for running the scheduler on a simulated clock, so scheduling policies can be
+// measured deterministically on the host. The scheduler takes the time from now() instead of micros(), and with a
+// cost model advances the clock by the modelled execution time of each task and check function it calls.
+typedef struct schedulerClock_s {
+    timeUs_t (*now)(void);
+    void (*advance)(timeDelta_t deltaUs);
+} schedulerClock_t;
+
+typedef struct schedulerCostModel_s {
+    timeDelta_t (*taskCostUs)(const task_t *task, timeUs_t currentTimeUs);
+    timeDelta_t (*checkFuncCostUs)(const task_t *task, timeUs_t currentTimeUs, bool signalled);
+    timeDelta_t passCostUs;         // overhead of each scheduler() call
+} schedulerCostModel_t;
+#endif
+
 void getCheckFuncInfo(cfCheckFuncInfo_t *checkFuncInfo);
 void getTaskInfo(taskId_e taskId, taskInfo_t *taskInfo);
+#if defined(USE_TASK_STATISTICS)
+void getCheckFuncHistogram(taskHistogram_t *histogram);
+void getTaskHistogram(taskId_e taskId, taskHistogram_t *histogram);
+timeUs_t taskHistogramPercentileUs(const taskHistogram_t *histogram, uint16_t permille);
+#endif
 void rescheduleTask(taskId_e taskId, timeDelta_t newPeriodUs);
 void setTaskEnabled(taskId_e taskId, bool newEnabledState);
 timeDelta_t getTaskDeltaTimeUs(taskId_e taskId);
@@ -194,8 +242,20 @@ void schedulerResetCheckFunctionMaxExecutionTime(void);
 
 void schedulerInit(void);
 void scheduler(void);
-timeUs_t schedulerExecuteTask(task_t *selectedTask, timeUs_t currentTimeUs);
+uint32_t schedulerExecuteTask(task_t *selectedTask, timeUs_t currentTimeUs);
 void taskSystemLoad(timeUs_t currentTimeUs);
 void schedulerOptimizeRate(bool optimizeRate);
 void schedulerEnableGyro(void);
+void schedulerSetFollowUpTask(taskId_e taskId);
+#if defined(USE_GYRO_EXTI_REALTIME)
+void schedulerEnableRealtimeInterrupt(void);
+bool schedulerRealtimeInterruptEnabled(void);
+void schedulerRealtimeInterrupt(void);
+#endif
 uint16_t getAverageSystemLoadPercent(void);
+void schedulerSetTaskMaxPeriod(taskId_e taskId, timeDelta_t maxPeriodUs);
+void schedulerSetLoadGovernor(uint8_t loadPercent);
+uint16_t getLoadGovernorStretchPercent(void);
+#if defined(USE_SCHEDULER_CLOCK)
+void schedulerSetClock(const schedulerClock_t *clock, const schedulerCostModel_t *costModel);
+#endif
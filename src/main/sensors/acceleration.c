@@ -29,10 +29,16 @@
 
 #include "common/axis.h"
 #include "common/filter.h"
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "config/feature.h"
 
+#ifdef USE_GYRO_EXTI_REALTIME
+#include "build/atomic.h"
+#include "drivers/nvic.h"
+#endif
+
 #include "sensors/acceleration_init.h"
 #include "sensors/boardalignment.h"
 
@@ -51,9 +57,20 @@ void accUpdate(timeUs_t currentTimeUs, rollAndPitchTrims_t *rollAndPitchTrims)
 {
     UNUSED(currentTimeUs);
 
+#ifdef USE_GYRO_EXTI_REALTIME
+    // The gyro may be read from its data ready interrupt, so keep it off the bus while the accelerometer is read
+    bool accReadOk = false;
+    ATOMIC_BLOCK(NVIC_PRIO_GYRO_INT_EXTI) {
+        accReadOk = acc.dev.readFn(&acc.dev);
+    }
+    if (!accReadOk) {
+        return;
+    }
+#else
     if (!acc.dev.readFn(&acc.dev)) {
         return;
     }
+#endif
     acc.isAccelUpdatedAtLeastOnce = true;
 
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
@@ -89,6 +106,36 @@ void accUpdate(timeUs_t currentTimeUs, rollAndPitchTrims_t *rollAndPitchTrims)
     }
 }
 
+void accSetRequiredRate(accConsumer_e consumer, uint16_t rateHz)
+{
+    accelerationRuntime.requiredRateHz[consumer] = rateHz;
+}
+
+// Returns true if the acc task needs rescheduling to the new acc.updateRateHz
+bool accUpdateRate(void)
+{
+    uint16_t rateHz = ACC_RATE_MIN_HZ;
+    for (int i = 0; i < ACC_CONSUMER_COUNT; i++) {
+        rateHz = MAX(rateHz, accelerationRuntime.requiredRateHz[i]);
+    }
+    rateHz = MIN(rateHz, acc.sampleRateHz);
+
+    if (rateHz == acc.updateRateHz) {
+        return false;
+    }
+    acc.updateRateHz = rateHz;
+
+    if (accelerationRuntime.accLpfCutHz) {
+        // Only update the coefficients so the filter output doesn't step on a rate change
+        const uint32_t accSampleTimeUs = 1e6 / rateHz;
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            biquadFilterUpdateLPF(&accelerationRuntime.accFilter[axis], accelerationRuntime.accLpfCutHz, accSampleTimeUs);
+        }
+    }
+
+    return true;
+}
+
 bool accGetAccumulationAverage(float *accumulationAverage)
 {
     if (accelerationRuntime.accumulatedMeasurementCount > 0) {
@@ -49,9 +49,22 @@ typedef enum {
     ACC_FAKE
 } accelerationSensor_e;
 
+// Users of the accelerometer register the update rate they need, the acc task runs at the highest request
+typedef enum {
+    ACC_CONSUMER_IMU = 0,
+    ACC_CONSUMER_OSD,
+    ACC_CONSUMER_ACRO_TRAINER,
+    ACC_CONSUMER_CRASH_RECOVERY,
+    ACC_CONSUMER_COUNT
+} accConsumer_e;
+
+#define ACC_RATE_FULL   UINT16_MAX  // request the full sensor sample rate
+#define ACC_RATE_MIN_HZ 100         // the acc task never runs slower than the attitude task
+
 typedef struct acc_s {
     accDev_t dev;
     uint16_t sampleRateHz;
+    uint16_t updateRateHz;      // rate the acc task currently runs at, follows the consumer requests
     float accADC[XYZ_AXIS_COUNT];
     bool isAccelUpdatedAtLeastOnce;
 } acc_t;
@@ -87,6 +100,8 @@ void accStartCalibration(void);
 void resetRollAndPitchTrims(rollAndPitchTrims_t *rollAndPitchTrims);
 void accUpdate(timeUs_t currentTimeUs, rollAndPitchTrims_t *rollAndPitchTrims);
 bool accGetAccumulationAverage(float *accumulation);
+void accSetRequiredRate(accConsumer_e consumer, uint16_t rateHz);
+bool accUpdateRate(void);
 union flightDynamicsTrims_u;
 void setAccelerationTrims(union flightDynamicsTrims_u *accelerationTrimsToUse);
 void accInitFilters(void);
@@ -32,6 +32,7 @@ typedef struct accelerationRuntime_s {
     int accumulatedMeasurementCount;
     float accumulatedMeasurements[XYZ_AXIS_COUNT];
     uint16_t calibratingA;      // the calibration is done is the main loop. Calibrating decreases at each cycle down to 0, then we enter in a normal mode.
+    uint16_t requiredRateHz[ACC_CONSUMER_COUNT];
 } accelerationRuntime_t;
 
 extern accelerationRuntime_t accelerationRuntime;
@@ -383,7 +383,7 @@ uint32_t baroUpdate(void)
     static barometerState_e state = BAROMETER_NEEDS_PRESSURE_START;
     timeUs_t sleepTime = 1000; // Wait 1ms between states
 
-    if (debugMode == DEBUG_BARO) {
+    if (debugModeIsEnabled(DEBUG_BARO)) {
         debug[0] = state;
     }
 
@@ -434,7 +434,7 @@ uint32_t baroUpdate(void)
                 state = BAROMETER_NEEDS_TEMPERATURE_START;
             }
 
-            if (debugMode == DEBUG_BARO) {
+            if (debugModeIsEnabled(DEBUG_BARO)) {
                 debug[1] = baroTemperature;
                 debug[2] = baroPressure;
                 debug[3] = baroPressureSum;
@@ -447,9 +447,37 @@ uint32_t baroUpdate(void)
     return sleepTime;
 }
 
+#define BARO_ALTITUDE_EXPONENT 0.190295f
+#define BARO_ALTITUDE_POLY_RANGE 0.05f  // relative pressure change, about 400m, before the expansion is moved (error < 1cm)
+
+// Altitude as a cubic in the relative pressure offset from refPressure, (1 + x)^k expanded by the binomial series
+static struct {
+    float refPressure;
+    float refPressureRec;
+    float coeff[4];
+} altitudePoly;
+
+static void altitudePolyInit(const float pressure)
+{
+    const float k = BARO_ALTITUDE_EXPONENT;
+    const float scaled = powf(pressure / 101325.0f, k) * 4433000.0f;
+
+    altitudePoly.refPressure = pressure;
+    altitudePoly.refPressureRec = 1.0f / pressure;
+    altitudePoly.coeff[0] = 4433000.0f - scaled;
+    altitudePoly.coeff[1] = -scaled * k;
+    altitudePoly.coeff[2] = -scaled * k * (k - 1.0f) / 2.0f;
+    altitudePoly.coeff[3] = -scaled * k * (k - 1.0f) * (k - 2.0f) / 6.0f;
+}
+
 static float pressureToAltitude(const float pressure)
 {
-    return (1.0f - powf(pressure / 101325.0f, 0.190295f)) * 4433000.0f;
+    float x = (pressure - altitudePoly.refPressure) * altitudePoly.refPressureRec;
+    if (altitudePoly.refPressure == 0.0f || fabsf(x) > BARO_ALTITUDE_POLY_RANGE) {
+        altitudePolyInit(pressure);
+        x = 0.0f;
+    }
+    return altitudePoly.coeff[0] + x * (altitudePoly.coeff[1] + x * (altitudePoly.coeff[2] + x * altitudePoly.coeff[3]));
 }
 
 int32_t baroCalculateAltitude(void)
@@ -474,7 +502,8 @@ void performBaroCalibrationCycle(void)
 
     baroGroundPressure -= baroGroundPressure / 8;
     baroGroundPressure += baroPressureSum / PRESSURE_SAMPLE_COUNT;
-    baroGroundAltitude = (1.0f - pow_approx((baroGroundPressure / 8) / 101325.0f, 0.190259f)) * 4433000.0f;
+    // same conversion as the flight altitude so their errors cancel
+    baroGroundAltitude = lrintf(pressureToAltitude((float)(baroGroundPressure / 8)));
 
     if (baroGroundPressure == savedGroundPressure) {
         calibratingB = 0;
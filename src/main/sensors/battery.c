@@ -46,6 +46,7 @@
 #include "pg/pg_ids.h"
 
 #include "sensors/battery.h"
+#include "sensors/battery_estimator.h"
 
 /**
  * terminology: meter vs sensors
@@ -76,6 +77,8 @@ static batteryState_e batteryState;
 static batteryState_e voltageState;
 static batteryState_e consumptionState;
 
+static batteryEstimator_t batteryEstimator;
+
 #ifndef DEFAULT_CURRENT_METER_SOURCE
 #ifdef USE_VIRTUAL_CURRENT_METER
 #define DEFAULT_CURRENT_METER_SOURCE CURRENT_METER_VIRTUAL
@@ -125,10 +128,26 @@ PG_RESET_TEMPLATE(batteryConfig_t, batteryConfig,
     .vbatDurationForCritical = 0,
 );
 
-void batteryUpdateVoltage(timeUs_t currentTimeUs)
+static void batteryUpdateEstimate(timeUs_t currentTimeUs)
 {
-    UNUSED(currentTimeUs);
+    static timeUs_t estimateUpdatedAtUs = 0;
+    const timeDelta_t deltaUs = cmpTimeUs(currentTimeUs, estimateUpdatedAtUs);
+    estimateUpdatedAtUs = currentTimeUs;
+
+    const batteryEstimatorInput_t input = {
+        .voltage = voltageMeter.unfiltered,
+        .amperage = currentMeter.amperageLatest,
+        .mAhDrawn = currentMeter.mAhDrawn,
+        .cellCount = batteryCellCount,
+        .capacity = batteryConfig()->batteryCapacity,
+        .emptyCellVoltage = batteryConfig()->vbatmincellvoltage,
+        .fullCellVoltage = CELL_VOLTAGE_FULL_CV,
+    };
+    batteryEstimatorUpdate(&batteryEstimator, &input, deltaUs);
+}
 
+void batteryUpdateVoltage(timeUs_t currentTimeUs)
+{
     switch (batteryConfig()->voltageMeterSource) {
 #ifdef USE_ESC_SENSOR
         case VOLTAGE_METER_ESC:
@@ -151,6 +170,11 @@ void batteryUpdateVoltage(timeUs_t currentTimeUs)
 
     DEBUG_SET(DEBUG_BATTERY, 0, voltageMeter.unfiltered);
     DEBUG_SET(DEBUG_BATTERY, 1, voltageMeter.displayFiltered);
+
+    // without a current meter the battery current task doesn't run
+    if (batteryConfig()->currentMeterSource == CURRENT_METER_NONE) {
+        batteryUpdateEstimate(currentTimeUs);
+    }
 }
 
 static void updateBatteryBeeperAlert(void)
@@ -358,6 +382,7 @@ void batteryInit(void)
     lowVoltageCutoff.startTime = 0;
 
     voltageMeterReset(&voltageMeter);
+    batteryEstimatorInit(&batteryEstimator);
 
     voltageMeterGenericInit();
     switch (batteryConfig()->voltageMeterSource) {
@@ -413,6 +438,7 @@ void batteryUpdateCurrentMeter(timeUs_t currentTimeUs)
     UNUSED(currentTimeUs);
     if (batteryCellCount == 0) {
         currentMeterReset(&currentMeter);
+        batteryUpdateEstimate(currentTimeUs);
         return;
     }
 
@@ -458,22 +484,14 @@ void batteryUpdateCurrentMeter(timeUs_t currentTimeUs)
             currentMeterReset(&currentMeter);
             break;
     }
+
+    batteryUpdateEstimate(currentTimeUs);
 }
 
+// Cached by the battery tasks, see batteryUpdateEstimate()
 uint8_t calculateBatteryPercentageRemaining(void)
 {
-    uint8_t batteryPercentage = 0;
-    if (batteryCellCount > 0) {
-        uint16_t batteryCapacity = batteryConfig()->batteryCapacity;
-
-        if (batteryCapacity > 0) {
-            batteryPercentage = constrain(((float)batteryCapacity - currentMeter.mAhDrawn) * 100 / batteryCapacity, 0, 100);
-        } else {
-            batteryPercentage = constrain((((uint32_t)voltageMeter.displayFiltered - (batteryConfig()->vbatmincellvoltage * batteryCellCount)) * 100) / ((batteryConfig()->vbatmaxcellvoltage - batteryConfig()->vbatmincellvoltage) * batteryCellCount), 0, 100);
-        }
-    }
-
-    return batteryPercentage;
+    return batteryEstimator.stateOfCharge;
 }
 
 void batteryUpdateAlarms(void)
@@ -539,3 +557,18 @@ int32_t getMAhDrawn(void)
 {
     return currentMeter.mAhDrawn;
 }
+
+uint16_t getBatteryRestingVoltage(void)
+{
+    return batteryEstimator.restingVoltage;
+}
+
+int32_t getBatteryAverageAmperage(void)
+{
+    return batteryEstimator.averageAmperage;
+}
+
+int32_t getBatteryTimeRemaining(void)
+{
+    return batteryEstimator.timeRemainingS;
+}
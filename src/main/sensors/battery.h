@@ -115,6 +115,11 @@ int32_t getAmperage(void);
 int32_t getAmperageLatest(void);
 int32_t getMAhDrawn(void);
 
+// Results of the battery model, updated by the battery tasks
+uint16_t getBatteryRestingVoltage(void);    // 0.01V, the voltage without the sag of the current drawn
+int32_t getBatteryAverageAmperage(void);    // 0.01A, over about 10s
+int32_t getBatteryTimeRemaining(void);      // s until batteryCapacity is used, -1 if unknown
+
 void batteryUpdateCurrentMeter(timeUs_t currentTimeUs);
 
 const lowVoltageCutoff_t *getLowVoltageCutoff(void);
@@ -0,0 +1,131 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+#include "common/utils.h"
+
+#include "battery_estimator.h"
+
+#define INTERNAL_RESISTANCE_DEFAULT     0.010f  // ohm per cell, a typical pack with its leads
+#define INTERNAL_RESISTANCE_MIN         0.001f
+#define INTERNAL_RESISTANCE_MAX         0.100f
+#define INTERNAL_RESISTANCE_GAIN        0.1f    // weight of a new resistance measurement
+#define CURRENT_STEP_MIN                5.0f    // A, smaller steps are buried in the ADC noise
+#define POLARISATION_TIME_CONSTANT_S    20.0f
+#define RESTING_VOLTAGE_TIME_CONSTANT_S 2.0f
+#define AVERAGE_AMPERAGE_TIME_CONSTANT_S 10.0f
+
+// Open circuit voltage of a LiPo cell at 0, 10, ... 100% charge, as a fraction of the empty to full range
+static const float stateOfChargeVoltage[] = {
+    0.000f, 0.422f, 0.478f, 0.522f, 0.556f, 0.600f, 0.633f, 0.689f, 0.756f, 0.867f, 1.000f
+};
+
+#define STATE_OF_CHARGE_STEP (100 / (ARRAYLEN(stateOfChargeVoltage) - 1))
+
+static float decay(float value, float target, float dT, float timeConstant)
+{
+    return value + (target - value) * dT / (timeConstant + dT);
+}
+
+uint8_t batteryEstimatorStateOfCharge(uint16_t cellVoltage, uint16_t emptyCellVoltage, uint16_t fullCellVoltage)
+{
+    if (fullCellVoltage <= emptyCellVoltage) {
+        return 0;
+    }
+
+    const float level = ((float)cellVoltage - emptyCellVoltage) / (fullCellVoltage - emptyCellVoltage);
+    if (level <= 0.0f) {
+        return 0;
+    }
+
+    for (unsigned i = 1; i < ARRAYLEN(stateOfChargeVoltage); i++) {
+        if (level < stateOfChargeVoltage[i]) {
+            const float fraction = (level - stateOfChargeVoltage[i - 1]) / (stateOfChargeVoltage[i] - stateOfChargeVoltage[i - 1]);
+            return lrintf((i - 1 + fraction) * STATE_OF_CHARGE_STEP);
+        }
+    }
+
+    return 100;
+}
+
+void batteryEstimatorInit(batteryEstimator_t *estimator)
+{
+    memset(estimator, 0, sizeof(*estimator));
+    estimator->internalResistance = INTERNAL_RESISTANCE_DEFAULT;
+    estimator->timeRemainingS = -1;
+}
+
+void batteryEstimatorUpdate(batteryEstimator_t *estimator, const batteryEstimatorInput_t *input, timeDelta_t deltaUs)
+{
+    if (input->cellCount == 0) {
+        batteryEstimatorInit(estimator);
+        return;
+    }
+
+    const float dT = deltaUs * 1e-6f;
+    const float cellVoltage = input->voltage * 0.01f / input->cellCount;
+    const float amperage = input->amperage * 0.01f;
+
+    if (estimator->initialised) {
+        // the cell voltage step over a current step is across the internal resistance alone,
+        // the polarisation is too slow to follow it
+        const float currentStep = amperage - estimator->amperage;
+        if (fabsf(currentStep) >= CURRENT_STEP_MIN) {
+            const float resistance = (estimator->cellVoltage - cellVoltage) / currentStep;
+            if (resistance >= INTERNAL_RESISTANCE_MIN && resistance <= INTERNAL_RESISTANCE_MAX) {
+                estimator->internalResistance += (resistance - estimator->internalResistance) * INTERNAL_RESISTANCE_GAIN;
+            }
+        }
+
+        estimator->polarisationVoltage = decay(estimator->polarisationVoltage, amperage * estimator->internalResistance, dT, POLARISATION_TIME_CONSTANT_S);
+        estimator->restingCellVoltage = decay(estimator->restingCellVoltage,
+            cellVoltage + amperage * estimator->internalResistance + estimator->polarisationVoltage, dT, RESTING_VOLTAGE_TIME_CONSTANT_S);
+        estimator->averageAmperageF = decay(estimator->averageAmperageF, amperage, dT, AVERAGE_AMPERAGE_TIME_CONSTANT_S);
+    } else {
+        estimator->restingCellVoltage = cellVoltage + amperage * estimator->internalResistance;
+        estimator->averageAmperageF = amperage;
+        estimator->initialised = true;
+    }
+    estimator->cellVoltage = cellVoltage;
+    estimator->amperage = amperage;
+
+    const uint16_t restingCellVoltage = lrintf(estimator->restingCellVoltage * 100);
+    estimator->restingVoltage = restingCellVoltage * input->cellCount;
+    estimator->averageAmperage = lrintf(estimator->averageAmperageF * 100);
+
+    estimator->timeRemainingS = -1;
+    if (input->capacity > 0) {
+        const int32_t remainingMAh = MAX(input->capacity - input->mAhDrawn, 0);
+        estimator->stateOfCharge = MIN(remainingMAh * 100 / input->capacity, 100);
+        if (estimator->averageAmperage > 0) {
+            // mAh * 3600 s/h / (centiamps * 10 mA/cA)
+            estimator->timeRemainingS = remainingMAh * 360 / estimator->averageAmperage;
+        }
+    } else {
+        estimator->stateOfCharge = batteryEstimatorStateOfCharge(restingCellVoltage, input->emptyCellVoltage, input->fullCellVoltage);
+    }
+}
@@ -0,0 +1,60 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+
+// Equivalent circuit model of the battery: the open circuit voltage of the state of charge behind the
+// internal resistance and one RC branch for the slow polarisation sag. The resistance is learned from
+// the voltage steps seen at current steps. Everything is per cell, the pack current flows through all.
+
+typedef struct batteryEstimatorInput_s {
+    uint16_t voltage;               // 0.01V, unfiltered
+    int32_t amperage;               // 0.01A, unfiltered, 0 if there is no current meter
+    int32_t mAhDrawn;
+    uint8_t cellCount;              // 0 if there is no battery
+    uint16_t capacity;              // mAh, 0 if unknown
+    uint16_t emptyCellVoltage;      // 0.01V
+    uint16_t fullCellVoltage;       // 0.01V
+} batteryEstimatorInput_t;
+
+typedef struct batteryEstimator_s {
+    bool initialised;
+    float internalResistance;       // ohm
+    float polarisationVoltage;      // V
+    float cellVoltage;              // V, last sample
+    float amperage;                 // A, last sample
+    float restingCellVoltage;       // V, filtered
+    float averageAmperageF;         // A, filtered
+
+    // results, valid until the next update
+    uint16_t restingVoltage;        // 0.01V, of the pack
+    int32_t averageAmperage;        // 0.01A
+    uint8_t stateOfCharge;          // percent
+    int32_t timeRemainingS;         // until the capacity is used, -1 if unknown
+} batteryEstimator_t;
+
+void batteryEstimatorInit(batteryEstimator_t *estimator);
+void batteryEstimatorUpdate(batteryEstimator_t *estimator, const batteryEstimatorInput_t *input, timeDelta_t deltaUs);
+uint8_t batteryEstimatorStateOfCharge(uint16_t cellVoltage, uint16_t emptyCellVoltage, uint16_t fullCellVoltage);
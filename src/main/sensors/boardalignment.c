@@ -132,3 +132,24 @@ FAST_CODE void alignSensorViaRotation(float *dest, uint8_t rotation)
         alignBoard(dest);
     }
 }
+
+// Build the matrix equivalent to aligning a vector with alignSensorViaMatrix() or alignSensorViaRotation(),
+// board alignment included, by aligning each of the unit vectors in turn
+void buildAlignmentMatrix(fp_rotationMatrix_t *dest, uint8_t rotation, fp_rotationMatrix_t *sensorRotationMatrix)
+{
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        float v[XYZ_AXIS_COUNT] = { 0.0f, 0.0f, 0.0f };
+        v[axis] = 1.0f;
+
+        if (rotation == ALIGN_CUSTOM) {
+            alignSensorViaMatrix(v, sensorRotationMatrix);
+        } else {
+            alignSensorViaRotation(v, rotation);
+        }
+
+        // applyRotation() sums m[input axis][output axis] * input
+        dest->m[axis][X] = v[X];
+        dest->m[axis][Y] = v[Y];
+        dest->m[axis][Z] = v[Z];
+    }
+}
@@ -35,5 +35,6 @@ PG_DECLARE(boardAlignment_t, boardAlignment);
 
 void alignSensorViaMatrix(float *dest, fp_rotationMatrix_t* rotationMatrix);
 void alignSensorViaRotation(float *dest, uint8_t rotation);
+void buildAlignmentMatrix(fp_rotationMatrix_t *dest, uint8_t rotation, fp_rotationMatrix_t *sensorRotationMatrix);
 
 void initBoardAlignment(const boardAlignment_t *boardAlignment);
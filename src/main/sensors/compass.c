@@ -21,12 +21,14 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+#include <math.h>
 
 #include "platform.h"
 
 #if defined(USE_MAG)
 
 #include "common/axis.h"
+#include "common/maths.h"
 
 #include "config/config.h"
 
@@ -58,14 +60,31 @@
 
 #include "compass.h"
 
+#define COMPASS_CALIBRATION_TIME_US       30000000    // 30s: you have 30s to turn the multi in all directions
+#define COMPASS_FIT_PARAMETER_COUNT       6
+#define COMPASS_FIT_MIN_SAMPLES           50
+#define COMPASS_FIT_INITIAL_COVARIANCE    10000.0f
+
+// Recursive least squares fit of an axis aligned ellipsoid a*x^2 + b*y^2 + c*z^2 + d*x + e*y + f*z = 1 to the samples,
+// its centre is the hard iron offset and the ratio of its radii the soft iron gains. Each sample updates the fit
+// in place, so none are kept, and the fit can end as soon as it is good rather than after the whole time.
+typedef struct compassFit_s {
+    float theta[COMPASS_FIT_PARAMETER_COUNT];
+    float P[COMPASS_FIT_PARAMETER_COUNT][COMPASS_FIT_PARAMETER_COUNT];
+    float sampleScale;      // samples are divided by the length of the first one to keep the fit well conditioned
+    uint16_t sampleCount;
+} compassFit_t;
+
 static timeUs_t tCal = 0;
 static flightDynamicsTrims_t magZeroTempMin;
 static flightDynamicsTrims_t magZeroTempMax;
+static compassFit_t compassFit;
+static float magGain[XYZ_AXIS_COUNT];
 
 magDev_t magDev;
 mag_t mag;                   // mag access functions
 
-PG_REGISTER_WITH_RESET_FN(compassConfig_t, compassConfig, PG_COMPASS_CONFIG, 3);
+PG_REGISTER_WITH_RESET_FN(compassConfig_t, compassConfig, PG_COMPASS_CONFIG, 4);
 
 void pgResetFn_compassConfig(compassConfig_t *compassConfig)
 {
@@ -299,6 +318,13 @@ bool compassDetect(magDev_t *dev, sensor_align_e *alignment)
 }
 #endif // !SIMULATOR_BUILD
 
+static void compassSetGain(void)
+{
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        magGain[axis] = 1.0f + compassConfig()->magGain.raw[axis] / 1000.0f;
+    }
+}
+
 bool compassInit(void)
 {
     // initialize and calibration. turn on led during mag calibration (calibration routine blinks it)
@@ -322,6 +348,8 @@ bool compassInit(void)
 
     buildRotationMatrixFromAlignment(&compassConfig()->mag_customAlignment, &magDev.rotationMatrix);
 
+    compassSetGain();
+
     return true;
 }
 
@@ -330,6 +358,110 @@ bool compassIsHealthy(void)
     return (mag.magADC[X] != 0) && (mag.magADC[Y] != 0) && (mag.magADC[Z] != 0);
 }
 
+static void compassFitReset(void)
+{
+    memset(&compassFit, 0, sizeof(compassFit));
+    // a sphere of the length of the first sample around the origin to start from
+    for (int i = 0; i < COMPASS_FIT_PARAMETER_COUNT; i++) {
+        compassFit.theta[i] = (i < XYZ_AXIS_COUNT) ? 1.0f : 0.0f;
+        compassFit.P[i][i] = COMPASS_FIT_INITIAL_COVARIANCE;
+    }
+}
+
+static void compassFitUpdate(const float *sample)
+{
+    if (compassFit.sampleCount == 0) {
+        compassFit.sampleScale = MAX(sqrtf(sq(sample[X]) + sq(sample[Y]) + sq(sample[Z])), 1.0f);
+    }
+    ++compassFit.sampleCount;
+
+    float phi[COMPASS_FIT_PARAMETER_COUNT];
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float u = sample[axis] / compassFit.sampleScale;
+        phi[axis] = u * u;
+        phi[XYZ_AXIS_COUNT + axis] = u;
+    }
+
+    // P is symmetric, so P * phi is also phi' * P
+    float pPhi[COMPASS_FIT_PARAMETER_COUNT];
+    float denominator = 1.0f;
+    float prediction = 0.0f;
+    for (int i = 0; i < COMPASS_FIT_PARAMETER_COUNT; i++) {
+        pPhi[i] = 0.0f;
+        for (int j = 0; j < COMPASS_FIT_PARAMETER_COUNT; j++) {
+            pPhi[i] += compassFit.P[i][j] * phi[j];
+        }
+        denominator += phi[i] * pPhi[i];
+        prediction += phi[i] * compassFit.theta[i];
+    }
+
+    const float error = (1.0f - prediction) / denominator;
+    for (int i = 0; i < COMPASS_FIT_PARAMETER_COUNT; i++) {
+        compassFit.theta[i] += pPhi[i] * error;
+        for (int j = i; j < COMPASS_FIT_PARAMETER_COUNT; j++) {
+            compassFit.P[i][j] -= pPhi[i] * pPhi[j] / denominator;
+            compassFit.P[j][i] = compassFit.P[i][j];
+        }
+    }
+}
+
+// Centre and radii of the fitted ellipsoid, false if the fit is not an ellipsoid yet
+static bool compassFitSolve(float *zero, float *radius)
+{
+    float constant = 1.0f;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float a = compassFit.theta[axis];
+        if (a <= 0.0f) {
+            return false;
+        }
+        zero[axis] = -compassFit.theta[XYZ_AXIS_COUNT + axis] / (2.0f * a);
+        constant += a * sq(zero[axis]);
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        radius[axis] = sqrtf(constant / compassFit.theta[axis]) * compassFit.sampleScale;
+        zero[axis] *= compassFit.sampleScale;
+    }
+    return true;
+}
+
+// The fit is good once the samples span well over half of the ellipsoid along every axis
+static bool compassFitIsComplete(const float *radius)
+{
+    if (compassFit.sampleCount < COMPASS_FIT_MIN_SAMPLES) {
+        return false;
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        if (magZeroTempMax.raw[axis] - magZeroTempMin.raw[axis] < 1.2f * radius[axis]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void compassEndCalibration(bool fitValid, const float *zero, const float *radius)
+{
+    flightDynamicsTrims_t *magZero = &compassConfigMutable()->magZero;
+    flightDynamicsTrims_t *magGainConfig = &compassConfigMutable()->magGain;
+
+    tCal = 0;
+    if (fitValid) {
+        // scale every axis to the mean radius, which leaves the field strength as it was
+        const float meanRadius = (radius[X] + radius[Y] + radius[Z]) / 3.0f;
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            magZero->raw[axis] = lrintf(zero[axis]);
+            magGainConfig->raw[axis] = constrain(lrintf((meanRadius / radius[axis] - 1.0f) * 1000.0f), -500, 500);
+        }
+    } else {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            magZero->raw[axis] = (magZeroTempMin.raw[axis] + magZeroTempMax.raw[axis]) / 2; // Calculate offsets
+            magGainConfig->raw[axis] = 0;
+        }
+    }
+    compassSetGain();
+
+    saveConfigAndNotify();
+}
+
 void compassStartCalibration(void)
 {
     tCal = micros();
@@ -339,6 +471,9 @@ void compassStartCalibration(void)
         magZeroTempMin.raw[axis] = mag.magADC[axis];
         magZeroTempMax.raw[axis] = mag.magADC[axis];
     }
+    memset(&compassConfigMutable()->magGain, 0, sizeof(compassConfig()->magGain));
+    compassSetGain();
+    compassFitReset();
 }
 
 bool compassIsCalibrationComplete(void)
@@ -348,8 +483,10 @@ bool compassIsCalibrationComplete(void)
 
 void compassUpdate(timeUs_t currentTimeUs)
 {
-
-    magDev.read(&magDev, magADCRaw);
+    if (!magDev.read(&magDev, magADCRaw)) {
+        // No new sample this cycle, e.g. the bus transfer started last cycle is still in flight
+        return;
+    }
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
         mag.magADC[axis] = magADCRaw[axis];
     }
@@ -361,13 +498,15 @@ void compassUpdate(timeUs_t currentTimeUs)
 
     flightDynamicsTrims_t *magZero = &compassConfigMutable()->magZero;
     if (magInit) {              // we apply offset only once mag calibration is done
-        mag.magADC[X] -= magZero->raw[X];
-        mag.magADC[Y] -= magZero->raw[Y];
-        mag.magADC[Z] -= magZero->raw[Z];
+        mag.magADC[X] = (mag.magADC[X] - magZero->raw[X]) * magGain[X];
+        mag.magADC[Y] = (mag.magADC[Y] - magZero->raw[Y]) * magGain[Y];
+        mag.magADC[Z] = (mag.magADC[Z] - magZero->raw[Z]) * magGain[Z];
     }
 
     if (tCal != 0) {
-        if ((currentTimeUs - tCal) < 30000000) {    // 30s: you have 30s to turn the multi in all directions
+        float zero[XYZ_AXIS_COUNT];
+        float radius[XYZ_AXIS_COUNT];
+        if ((currentTimeUs - tCal) < COMPASS_CALIBRATION_TIME_US) {
             LED0_TOGGLE;
             for (int axis = 0; axis < 3; axis++) {
                 if (mag.magADC[axis] < magZeroTempMin.raw[axis])
@@ -375,13 +514,14 @@ void compassUpdate(timeUs_t currentTimeUs)
                 if (mag.magADC[axis] > magZeroTempMax.raw[axis])
                     magZeroTempMax.raw[axis] = mag.magADC[axis];
             }
-        } else {
-            tCal = 0;
-            for (int axis = 0; axis < 3; axis++) {
-                magZero->raw[axis] = (magZeroTempMin.raw[axis] + magZeroTempMax.raw[axis]) / 2; // Calculate offsets
+            compassFitUpdate(mag.magADC);
+            if (compassFitSolve(zero, radius) && compassFitIsComplete(radius)) {
+                compassEndCalibration(true, zero, radius);
             }
-
-            saveConfigAndNotify();
+        } else {
+            // out of time, the fit is still better than the extents if the samples span enough of it
+            const bool fitValid = compassFitSolve(zero, radius) && compassFit.sampleCount >= COMPASS_FIT_MIN_SAMPLES;
+            compassEndCalibration(fitValid, zero, radius);
         }
     }
 }
@@ -57,6 +57,7 @@ typedef struct compassConfig_s {
     ioTag_t interruptTag;
     flightDynamicsTrims_t magZero;
     sensorAlignment_t mag_customAlignment;
+    flightDynamicsTrims_t magGain;          // soft iron correction, deviation of the gain of each axis from unity in 1/1000
 } compassConfig_t;
 
 PG_DECLARE(compassConfig_t, compassConfig);
@@ -151,6 +151,12 @@ void currentMeterADCRefresh(int32_t lastUpdateAt)
     currentMeterADCState.amperageLatest = currentMeterADCToCentiamps(iBatSample);
     currentMeterADCState.amperage = currentMeterADCToCentiamps(pt1FilterApply(&adciBatFilter, iBatSample));
 
+#ifdef USE_CURRENT_LIMIT
+    if (currentMeterADCState.fastRefreshed) {
+        currentMeterADCState.fastRefreshed = false;
+        return;
+    }
+#endif
     updateCurrentmAhDrawnState(&currentMeterADCState.mahDrawnState, currentMeterADCState.amperageLatest, lastUpdateAt);
 #else
     UNUSED(lastUpdateAt);
@@ -161,6 +167,27 @@ void currentMeterADCRefresh(int32_t lastUpdateAt)
 #endif
 }
 
+#ifdef USE_CURRENT_LIMIT
+// Sample the current sensor from the PID loop, returns the current in centiamps.
+// The drawn charge is integrated at this rate too, until the next currentMeterADCRefresh() without a
+// fast refresh in between falls back to integrating at the battery task rate.
+int32_t currentMeterADCFastRefresh(int32_t lastUpdateAt)
+{
+#ifdef USE_ADC
+    const int32_t amperage = currentMeterADCToCentiamps(adcGetChannel(ADC_CURRENT));
+
+    updateCurrentmAhDrawnState(&currentMeterADCState.mahDrawnState, amperage, lastUpdateAt);
+    currentMeterADCState.fastRefreshed = true;
+
+    return amperage;
+#else
+    UNUSED(lastUpdateAt);
+
+    return 0;
+#endif
+}
+#endif
+
 void currentMeterADCRead(currentMeter_t *meter)
 {
     meter->amperageLatest = currentMeterADCState.amperageLatest;
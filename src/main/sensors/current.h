@@ -67,6 +67,9 @@ typedef struct currentMeterADCState_s {
     currentMeterMAhDrawnState_t mahDrawnState;
     int32_t amperage;           // current read by current sensor in centiampere (1/100th A)
     int32_t amperageLatest;     // current read by current sensor in centiampere (1/100th A) (unfiltered)
+#ifdef USE_CURRENT_LIMIT
+    bool fastRefreshed;         // the charge was integrated by currentMeterADCFastRefresh() since the last refresh
+#endif
 } currentMeterADCState_t;
 
 typedef struct currentSensorADCConfig_s {
@@ -121,6 +124,9 @@ void currentMeterReset(currentMeter_t *meter);
 void currentMeterADCInit(void);
 void currentMeterADCRefresh(int32_t lastUpdateAt);
 void currentMeterADCRead(currentMeter_t *meter);
+#ifdef USE_CURRENT_LIMIT
+int32_t currentMeterADCFastRefresh(int32_t lastUpdateAt);
+#endif
 
 void currentMeterVirtualInit(void);
 void currentMeterVirtualRefresh(int32_t lastUpdateAt, bool armed, bool throttleLowAndMotorStop, int32_t throttleOffset);
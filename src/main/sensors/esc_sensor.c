@@ -41,7 +41,9 @@
 #include "drivers/timer.h"
 #include "drivers/motor.h"
 #include "drivers/dshot.h"
+#include "drivers/dshot_command.h"
 #include "drivers/dshot_dpwm.h"
+#include "drivers/pwm_output.h"
 #include "drivers/serial.h"
 #include "drivers/serial_uart.h"
 
@@ -49,6 +51,8 @@
 
 #include "config/config.h"
 
+#include "fc/runtime_config.h"
+
 #include "flight/mixer.h"
 
 #include "io/serial.h"
@@ -107,7 +111,26 @@ typedef enum {
 
 #define ESC_SENSOR_BAUDRATE 115200
 #define ESC_BOOTTIME 5000               // 5 seconds
-#define ESC_REQUEST_TIMEOUT 100         // 100 ms (data transfer takes only 900us)
+#define ESC_SENSOR_IDLE_PERIOD_US 10000 // how often the task runs while no frame is expected
+
+/*
+All ESCs reply on the same telemetry wire, so only one request can be outstanding. The next request is made as
+soon as a frame has been received, for the motor whose data is the oldest, so the link is kept busy with back to
+back frames. The time given to a motor to reply is learned from its replies, and a motor that stops replying
+is asked less and less often, so that it does not hold up the others.
+*/
+#define ESC_REQUEST_TIMEOUT_US 100000       // until a motor has replied (data transfer takes only 900us)
+#define ESC_REPLY_TIMEOUT_MIN_US 3000       // then twice its last reply time, at least this
+#define ESC_RETRY_DELAY_US 10000            // delay before asking a motor again after a timeout,
+#define ESC_RETRY_DELAY_MAX_US 1000000      // doubled with each further timeout up to this
+#define ESC_DATA_STALE_MAX_US 1000000       // data older than this is not ordered any further
+
+typedef struct escSensorMotorState_s {
+    timeUs_t updatedAtUs;               // time of the last valid frame
+    timeUs_t timedOutAtUs;
+    timeDelta_t timeoutUs;              // for the reply to a request
+    timeDelta_t retryDelayUs;           // 0 if the last request did not time out
+} escSensorMotorState_t;
 
 #define TELEMETRY_FRAME_SIZE 10
 static uint8_t telemetryBuffer[TELEMETRY_FRAME_SIZE] = { 0, };
@@ -121,8 +144,9 @@ static serialPort_t *escSensorPort = NULL;
 static escSensorData_t escSensorData[MAX_SUPPORTED_MOTORS];
 
 static escSensorTriggerState_t escSensorTriggerState = ESC_SENSOR_TRIGGER_STARTUP;
-static uint32_t escTriggerTimestamp;
+static timeUs_t escTriggerTimestampUs;
 static uint8_t escSensorMotor = 0;      // motor index
+static escSensorMotorState_t escSensorMotorState[MAX_SUPPORTED_MOTORS];
 
 static escSensorData_t combinedEscSensorData;
 static bool combinedDataNeedsUpdate = true;
@@ -130,6 +154,22 @@ static bool combinedDataNeedsUpdate = true;
 static uint16_t totalTimeoutCount = 0;
 static uint16_t totalCrcErrorCount = 0;
 
+#ifdef USE_DSHOT_TELEMETRY
+/*
+ * Without an ESC sensor port the data can come from extended DShot telemetry (EDT) frames, which the ESCs
+ * interleave with the eRPM frames on the bidirectional DShot line. All motors report at once, there is no
+ * round robin polling.
+ */
+#define ESC_DSHOT_AGE_INTERVAL_MS 100   // data age step without new extended frames
+
+static bool escSensorUseDshotTelemetry = false;
+static bool escSensorDshotEdtRequested = false;
+static timeMs_t escSensorDshotLastUpdateMs;
+static uint16_t escSensorDshotFrameCount[MAX_SUPPORTED_MOTORS];
+static timeMs_t escSensorDshotFrameTimeMs[MAX_SUPPORTED_MOTORS];
+static float escSensorDshotConsumption[MAX_SUPPORTED_MOTORS];
+#endif
+
 void startEscDataRead(uint8_t *frameBuffer, uint8_t frameLength)
 {
     buffer = frameBuffer;
@@ -209,9 +249,20 @@ static void escSensorDataReceive(uint16_t c, void *data)
 
 bool escSensorInit(void)
 {
+    escSensorTriggerState = ESC_SENSOR_TRIGGER_STARTUP;
+    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i = i + 1) {
+        escSensorData[i].dataAge = ESC_DATA_INVALID;
+        escSensorMotorState[i] = (escSensorMotorState_t) { .timeoutUs = ESC_REQUEST_TIMEOUT_US };
+    }
+
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_ESC_SENSOR);
     if (!portConfig) {
+#ifdef USE_DSHOT_TELEMETRY
+        escSensorUseDshotTelemetry = motorConfig()->dev.useDshotTelemetry && motorConfig()->dev.useDshotEdt;
+        return escSensorUseDshotTelemetry;
+#else
         return false;
+#endif
     }
 
     portOptions_e options = SERIAL_NOT_INVERTED  | (escSensorConfig()->halfDuplex ? SERIAL_BIDIR : 0);
@@ -219,10 +270,6 @@ bool escSensorInit(void)
     // Initialize serial port
     escSensorPort = openSerialPort(portConfig->identifier, FUNCTION_ESC_SENSOR, escSensorDataReceive, NULL, ESC_SENSOR_BAUDRATE, MODE_RX, options);
 
-    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i = i + 1) {
-        escSensorData[i].dataAge = ESC_DATA_INVALID;
-    }
-
     return escSensorPort != NULL;
 }
 
@@ -248,7 +295,7 @@ uint8_t calculateCrc8(const uint8_t *Buf, const uint8_t BufLen)
     return crc;
 }
 
-static uint8_t decodeEscFrame(void)
+static uint8_t decodeEscFrame(timeUs_t currentTimeUs)
 {
     if (!isFrameComplete()) {
         return ESC_SENSOR_FRAME_PENDING;
@@ -268,6 +315,11 @@ static uint8_t decodeEscFrame(void)
 
         combinedDataNeedsUpdate = true;
 
+        escSensorMotorState_t *motorState = &escSensorMotorState[escSensorMotor];
+        motorState->updatedAtUs = currentTimeUs;
+        motorState->timeoutUs = MAX(2 * cmpTimeUs(currentTimeUs, escTriggerTimestampUs), ESC_REPLY_TIMEOUT_MIN_US);
+        motorState->retryDelayUs = 0;
+
         frameStatus = ESC_SENSOR_FRAME_COMPLETE;
 
         if (escSensorMotor < 4) {
@@ -290,12 +342,107 @@ static void increaseDataAge(void)
     }
 }
 
-static void selectNextMotor(void)
+static void escSensorTimeout(timeUs_t currentTimeUs)
+{
+    escSensorMotorState_t *motorState = &escSensorMotorState[escSensorMotor];
+    motorState->timedOutAtUs = currentTimeUs;
+    motorState->timeoutUs = MIN(2 * motorState->timeoutUs, ESC_REQUEST_TIMEOUT_US);
+    motorState->retryDelayUs = motorState->retryDelayUs ? MIN(2 * motorState->retryDelayUs, ESC_RETRY_DELAY_MAX_US) : ESC_RETRY_DELAY_US;
+}
+
+// Select the motor with the oldest data, leaving out those waiting to be retried after a timeout.
+// On equal age the motors are taken in turn, starting after the last one asked.
+static bool selectNextMotor(timeUs_t currentTimeUs)
 {
-    escSensorMotor++;
-    if (escSensorMotor == getMotorCount()) {
-        escSensorMotor = 0;
+    const uint8_t motorCount = getMotorCount();
+    const uint8_t lastMotor = escSensorMotor;
+    bool selected = false;
+    uint32_t oldestAgeUs = 0;
+
+    for (int n = 1; n <= motorCount; n++) {
+        const uint8_t i = (lastMotor + n) % motorCount;
+        escSensorMotorState_t *motorState = &escSensorMotorState[i];
+        if (motorState->retryDelayUs && currentTimeUs - motorState->timedOutAtUs < (uint32_t)motorState->retryDelayUs) {
+            continue;
+        }
+        uint32_t ageUs = currentTimeUs - motorState->updatedAtUs;
+        if (ageUs > ESC_DATA_STALE_MAX_US) {
+            motorState->updatedAtUs = currentTimeUs - ESC_DATA_STALE_MAX_US;
+            ageUs = ESC_DATA_STALE_MAX_US;
+        }
+        if (!selected || ageUs > oldestAgeUs) {
+            escSensorMotor = i;
+            oldestAgeUs = ageUs;
+            selected = true;
+        }
     }
+
+    return selected;
+}
+
+#ifdef USE_DSHOT_TELEMETRY
+static void escSensorDshotProcess(timeMs_t currentTimeMs)
+{
+    // The ESCs only send extended frames once asked to, after they have detected the protocol
+    if (!escSensorDshotEdtRequested) {
+        if (dshotStreamingCommandsAreEnabled() && !ARMING_FLAG(ARMED)) {
+            dshotCommandWrite(ALL_MOTORS, getMotorCount(), DSHOT_CMD_EXTENDED_TELEMETRY_ENABLE, DSHOT_CMD_TYPE_INLINE);
+            escSensorDshotEdtRequested = true;
+            escSensorDshotLastUpdateMs = currentTimeMs;
+        }
+        return;
+    }
+
+    const timeMs_t deltaMs = currentTimeMs - escSensorDshotLastUpdateMs;
+    escSensorDshotLastUpdateMs = currentTimeMs;
+
+    for (int i = 0; i < getMotorCount(); i++) {
+        escSensorData_t *escData = &escSensorData[i];
+        const dshotTelemetryMotorState_t *motorState = &dshotTelemetryState.motorState[i];
+        uint16_t value;
+
+        if (motorState->extendedFrameCount != escSensorDshotFrameCount[i]) {
+            escSensorDshotFrameCount[i] = motorState->extendedFrameCount;
+            escSensorDshotFrameTimeMs[i] = currentTimeMs;
+            escData->dataAge = 0;
+        } else if (escData->dataAge < ESC_DATA_INVALID && currentTimeMs - escSensorDshotFrameTimeMs[i] >= ESC_DSHOT_AGE_INTERVAL_MS) {
+            escSensorDshotFrameTimeMs[i] = currentTimeMs;
+            escData->dataAge++;
+        }
+
+        if (getDshotTelemetryData(i, DSHOT_TELEMETRY_TYPE_TEMPERATURE, &value)) {
+            escData->temperature = value;
+        }
+        if (getDshotTelemetryData(i, DSHOT_TELEMETRY_TYPE_VOLTAGE, &value)) {
+            escData->voltage = value * 25;
+        }
+        if (getDshotTelemetryData(i, DSHOT_TELEMETRY_TYPE_CURRENT, &value)) {
+            escData->current = value * 100;
+            // The ESCs do not report consumption over DShot, integrate the current
+            escSensorDshotConsumption[i] += escData->current * deltaMs / (100 * 3600.0f);
+            escData->consumption = escSensorDshotConsumption[i];
+        }
+        escData->rpm = getDshotTelemetry(i);
+
+        if (i < 4) {
+            DEBUG_SET(DEBUG_ESC_SENSOR_RPM, i, calcEscRpm(escData->rpm) / 10);
+            DEBUG_SET(DEBUG_ESC_SENSOR_TMP, i, escData->temperature);
+        }
+    }
+
+    combinedDataNeedsUpdate = true;
+}
+#endif
+
+// Signals the task when the requested frame has been received or the request has timed out, otherwise it
+// runs every ESC_SENSOR_IDLE_PERIOD_US
+bool escSensorCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs)
+{
+    if (escSensorTriggerState == ESC_SENSOR_TRIGGER_PENDING) {
+        return isFrameComplete() || cmpTimeUs(currentTimeUs, escTriggerTimestampUs) >= escSensorMotorState[escSensorMotor].timeoutUs;
+    }
+
+    return currentDeltaTimeUs >= ESC_SENSOR_IDLE_PERIOD_US;
 }
 
 // XXX Review ESC sensor under refactored motor handling
@@ -304,6 +451,15 @@ void escSensorProcess(timeUs_t currentTimeUs)
 {
     const timeMs_t currentTimeMs = currentTimeUs / 1000;
 
+#ifdef USE_DSHOT_TELEMETRY
+    if (escSensorUseDshotTelemetry) {
+        if (motorIsEnabled()) {
+            escSensorDshotProcess(currentTimeMs);
+        }
+        return;
+    }
+#endif
+
     if (!escSensorPort || !motorIsEnabled()) {
         return;
     }
@@ -315,31 +471,18 @@ void escSensorProcess(timeUs_t currentTimeUs)
                 escSensorTriggerState = ESC_SENSOR_TRIGGER_READY;
             }
 
-            break;
-        case ESC_SENSOR_TRIGGER_READY:
-            escTriggerTimestamp = currentTimeMs;
-
-            startEscDataRead(telemetryBuffer, TELEMETRY_FRAME_SIZE);
-            motorDmaOutput_t * const motor = getMotorDmaOutput(escSensorMotor);
-            motor->protocolControl.requestTelemetry = true;
-            escSensorTriggerState = ESC_SENSOR_TRIGGER_PENDING;
-
-            DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_MOTOR_INDEX, escSensorMotor + 1);
-
             break;
         case ESC_SENSOR_TRIGGER_PENDING:
-            if (currentTimeMs < escTriggerTimestamp + ESC_REQUEST_TIMEOUT) {
-                uint8_t state = decodeEscFrame();
+            if (cmpTimeUs(currentTimeUs, escTriggerTimestampUs) < escSensorMotorState[escSensorMotor].timeoutUs) {
+                uint8_t state = decodeEscFrame(currentTimeUs);
                 switch (state) {
                     case ESC_SENSOR_FRAME_COMPLETE:
-                        selectNextMotor();
                         escSensorTriggerState = ESC_SENSOR_TRIGGER_READY;
 
                         break;
                     case ESC_SENSOR_FRAME_FAILED:
                         increaseDataAge();
 
-                        selectNextMotor();
                         escSensorTriggerState = ESC_SENSOR_TRIGGER_READY;
 
                         DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_NUM_CRC_ERRORS, ++totalCrcErrorCount);
@@ -348,15 +491,35 @@ void escSensorProcess(timeUs_t currentTimeUs)
                         break;
                 }
             } else {
-                // Move on to next ESC, we'll come back to this one
+                // Move on to the other ESCs, this one is asked again after a delay
                 increaseDataAge();
+                escSensorTimeout(currentTimeUs);
 
-                selectNextMotor();
                 escSensorTriggerState = ESC_SENSOR_TRIGGER_READY;
 
                 DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_NUM_TIMEOUTS, ++totalTimeoutCount);
             }
 
+            if (escSensorTriggerState != ESC_SENSOR_TRIGGER_READY) {
+                break;
+            }
+
+            // Request the next frame right away
+            FALLTHROUGH;
+        case ESC_SENSOR_TRIGGER_READY:
+            if (!selectNextMotor(currentTimeUs)) {
+                break;
+            }
+
+            escTriggerTimestampUs = currentTimeUs;
+
+            startEscDataRead(telemetryBuffer, TELEMETRY_FRAME_SIZE);
+            motorDmaOutput_t * const motor = getMotorDmaOutput(escSensorMotor);
+            motor->protocolControl.requestTelemetry = true;
+            escSensorTriggerState = ESC_SENSOR_TRIGGER_PENDING;
+
+            DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_MOTOR_INDEX, escSensorMotor + 1);
+
             break;
     }
 }
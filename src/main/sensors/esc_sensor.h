@@ -44,6 +44,7 @@ typedef struct {
 #define ESC_BATTERY_AGE_MAX 10
 
 bool escSensorInit(void);
+bool escSensorCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs);
 void escSensorProcess(timeUs_t currentTime);
 
 #define ESC_SENSOR_COMBINED 255
@@ -21,6 +21,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+#include <float.h>
 #include <math.h>
 #include <stdlib.h>
 
@@ -54,7 +55,6 @@
 
 #include "scheduler/scheduler.h"
 
-#include "sensors/boardalignment.h"
 #include "sensors/gyro.h"
 #include "sensors/gyro_init.h"
 
@@ -62,6 +62,10 @@
 #define USE_GYRO_SLEW_LIMITER
 #endif
 
+#if defined(USE_GYRO_OVERFLOW_CHECK) || defined(USE_YAW_SPIN_RECOVERY)
+#define USE_GYRO_ANOMALY_CHECK
+#endif
+
 FAST_DATA_ZERO_INIT gyro_t gyro;
 
 static FAST_DATA_ZERO_INIT bool overflowDetected;
@@ -76,13 +80,34 @@ static FAST_DATA_ZERO_INIT bool yawSpinDetected;
 static FAST_DATA_ZERO_INIT timeUs_t yawSpinTimeUs;
 #endif
 
+#ifdef USE_GYRO_ANOMALY_CHECK
+#ifndef GYRO_ANOMALY_CHECK_DISARMED_DENOM
+#define GYRO_ANOMALY_CHECK_DISARMED_DENOM 8  // disarmed, only every 8th gyro sample is checked
+#endif
+static FAST_DATA_ZERO_INIT bool anomalyCheckEnabled;
+static FAST_DATA_ZERO_INIT float anomalyTriggerRate[XYZ_AXIS_COUNT];   // lowest rate any enabled check triggers at
+static FAST_DATA_ZERO_INIT uint8_t anomalyCheckCount;
+#ifdef USE_GYRO_OVERFLOW_CHECK
+static FAST_DATA_ZERO_INIT bool overflowCheckEnabled;
+#endif
+
+#if defined(USE_GYRO_OVERFLOW_CHECK) && defined(USE_YAW_SPIN_RECOVERY)
+#define ANOMALY_DETECTED() (overflowDetected || yawSpinDetected)
+#elif defined(USE_GYRO_OVERFLOW_CHECK)
+#define ANOMALY_DETECTED() (overflowDetected)
+#else
+#define ANOMALY_DETECTED() (yawSpinDetected)
+#endif
+#endif
+
 static FAST_DATA_ZERO_INIT float accumulatedMeasurements[XYZ_AXIS_COUNT];
 static FAST_DATA_ZERO_INIT float gyroPrevious[XYZ_AXIS_COUNT];
-static FAST_DATA_ZERO_INIT int accumulatedMeasurementCount;
+static FAST_DATA_ZERO_INIT float accumulatedMeasurementTimeUs;
 
 static FAST_DATA_ZERO_INIT int16_t gyroSensorTemperature;
 
 FAST_DATA uint8_t activePidLoopDenom = 1;
+FAST_DATA uint8_t activeGyroUpdateDenom = 1;    // gyro task runs per PID loop, each reading gyro.fifoDepth samples
 
 static bool firstArmingCalibrationWasStarted = false;
 
@@ -97,43 +122,48 @@ STATIC_UNIT_TESTED gyroDev_t * const gyroDevPtr = &gyro.gyroSensor1.gyroDev;
 #define GYRO_OVERFLOW_TRIGGER_THRESHOLD 31980  // 97.5% full scale (1950dps for 2000dps gyro)
 #define GYRO_OVERFLOW_RESET_THRESHOLD 30340    // 92.5% full scale (1850dps for 2000dps gyro)
 
-PG_REGISTER_WITH_RESET_FN(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 8);
+PG_REGISTER_WITH_RESET_TEMPLATE(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 15);
 
 #ifndef GYRO_CONFIG_USE_GYRO_DEFAULT
 #define GYRO_CONFIG_USE_GYRO_DEFAULT GYRO_CONFIG_USE_GYRO_1
 #endif
 
-void pgResetFn_gyroConfig(gyroConfig_t *gyroConfig)
-{
-    gyroConfig->gyroCalibrationDuration = 125;        // 1.25 seconds
-    gyroConfig->gyroMovementCalibrationThreshold = 48;
-    gyroConfig->gyro_hardware_lpf = GYRO_HARDWARE_LPF_NORMAL;
-    gyroConfig->gyro_lowpass_type = FILTER_PT1;
-    gyroConfig->gyro_lowpass_hz = 200;  // NOTE: dynamic lpf is enabled by default so this setting is actually
-                                        // overridden and the static lowpass 1 is disabled. We can't set this
-                                        // value to 0 otherwise Configurator versions 10.4 and earlier will also
-                                        // reset the lowpass filter type to PT1 overriding the desired BIQUAD setting.
-    gyroConfig->gyro_lowpass2_type = FILTER_PT1;
-    gyroConfig->gyro_lowpass2_hz = 250;
-    gyroConfig->gyro_high_fsr = false;
-    gyroConfig->gyro_to_use = GYRO_CONFIG_USE_GYRO_DEFAULT;
-    gyroConfig->gyro_soft_notch_hz_1 = 0;
-    gyroConfig->gyro_soft_notch_cutoff_1 = 0;
-    gyroConfig->gyro_soft_notch_hz_2 = 0;
-    gyroConfig->gyro_soft_notch_cutoff_2 = 0;
-    gyroConfig->checkOverflow = GYRO_OVERFLOW_CHECK_ALL_AXES;
-    gyroConfig->gyro_offset_yaw = 0;
-    gyroConfig->yaw_spin_recovery = YAW_SPIN_RECOVERY_AUTO;
-    gyroConfig->yaw_spin_threshold = 1950;
-    gyroConfig->dyn_lpf_gyro_min_hz = 200;
-    gyroConfig->dyn_lpf_gyro_max_hz = 500;
-    gyroConfig->dyn_notch_max_hz = 600;
-    gyroConfig->dyn_notch_width_percent = 8;
-    gyroConfig->dyn_notch_q = 120;
-    gyroConfig->dyn_notch_min_hz = 150;
-    gyroConfig->gyro_filter_debug_axis = FD_ROLL;
-    gyroConfig->dyn_lpf_curve_expo = 5;
-}
+PG_RESET_TEMPLATE(gyroConfig_t, gyroConfig,
+    .gyroCalibrationDuration = 125,        // 1.25 seconds
+    .gyroMovementCalibrationThreshold = 48,
+    .gyro_hardware_lpf = GYRO_HARDWARE_LPF_NORMAL,
+    .gyro_lowpass_type = FILTER_PT1,
+    .gyro_lowpass_hz = 200,  // NOTE: dynamic lpf is enabled by default so this setting is actually
+                             // overridden and the static lowpass 1 is disabled. We can't set this
+                             // value to 0 otherwise Configurator versions 10.4 and earlier will also
+                             // reset the lowpass filter type to PT1 overriding the desired BIQUAD setting.
+    .gyro_lowpass2_type = FILTER_PT1,
+    .gyro_lowpass2_hz = 250,
+    .gyro_high_fsr = false,
+    .gyro_to_use = GYRO_CONFIG_USE_GYRO_DEFAULT,
+    .gyro_soft_notch_hz_1 = 0,
+    .gyro_soft_notch_cutoff_1 = 0,
+    .gyro_soft_notch_hz_2 = 0,
+    .gyro_soft_notch_cutoff_2 = 0,
+    .checkOverflow = GYRO_OVERFLOW_CHECK_ALL_AXES,
+    .gyro_offset_yaw = 0,
+    .yaw_spin_recovery = YAW_SPIN_RECOVERY_AUTO,
+    .yaw_spin_threshold = 1950,
+    .dyn_lpf_gyro_min_hz = 200,
+    .dyn_lpf_gyro_max_hz = 500,
+    .dyn_notch_max_hz = 600,
+    .dyn_notch_count = 3,
+    .dyn_notch_q = 120,
+    .dyn_notch_min_hz = 150,
+    .gyro_filter_debug_axis = FD_ROLL,
+    .dyn_lpf_curve_expo = 5,
+    .dyn_notch_window = 0,   // 32 sample window
+    .dyn_notch_engine = 0,   // FFT
+    .gyro_fifo_depth = 1,
+    .gyro_fusion = 0,        // AVERAGE
+    .gyro_decimation = false,
+    .gyroCalibrationTracking = false,
+);
 
 #ifdef USE_GYRO_DATA_ANALYSE
 bool isDynamicFilterActive(void)
@@ -165,19 +195,15 @@ FAST_CODE bool gyroIsCalibrationComplete(void)
     }
 }
 
-static bool isOnFinalGyroCalibrationCycle(const gyroCalibration_t *gyroCalibration)
-{
-    return gyroCalibration->cyclesRemaining == 1;
-}
-
 static int32_t gyroCalculateCalibratingCycles(void)
 {
     return (gyroConfig()->gyroCalibrationDuration * 10000) / gyro.sampleLooptime;
 }
 
-static bool isOnFirstGyroCalibrationCycle(const gyroCalibration_t *gyroCalibration)
+static void gyroCalibrationResetWindow(gyroCalibration_t *calibration)
 {
-    return gyroCalibration->cyclesRemaining == gyroCalculateCalibratingCycles();
+    calibration->blockCount = 0;
+    calibration->blockCyclesRemaining = 0;
 }
 
 static void gyroSetCalibrationCycles(gyroSensor_t *gyroSensor)
@@ -188,7 +214,15 @@ static void gyroSetCalibrationCycles(gyroSensor_t *gyroSensor)
         return;
     }
 #endif
-    gyroSensor->calibration.cyclesRemaining = gyroCalculateCalibratingCycles();
+    gyroCalibration_t *calibration = &gyroSensor->calibration;
+    calibration->blockCycles = MAX(gyroCalculateCalibratingCycles() / GYRO_CALIBRATION_BLOCK_COUNT, 1);
+    calibration->cyclesRemaining = calibration->blockCycles * GYRO_CALIBRATION_BLOCK_COUNT;
+    gyroCalibrationResetWindow(calibration);
+
+    // gyroZero is set to zero until calibration complete
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        gyroSensor->gyroDev.gyroZero[axis] = 0.0f;
+    }
 }
 
 void gyroStartCalibration(bool isFirstArmingCalibration)
@@ -212,51 +246,148 @@ bool isFirstArmingGyroCalibrationRunning(void)
     return firstArmingCalibrationWasStarted && !gyroIsCalibrationComplete();
 }
 
-STATIC_UNIT_TESTED void performGyroCalibration(gyroSensor_t *gyroSensor, uint8_t gyroMovementCalibrationThreshold)
+static void gyroCalibrationDropOldestBlock(gyroCalibration_t *calibration)
 {
+    --calibration->blockCount;
+    memmove(calibration->blockMean[0], calibration->blockMean[1], calibration->blockCount * sizeof(calibration->blockMean[0]));
+    memmove(calibration->blockM2[0], calibration->blockM2[1], calibration->blockCount * sizeof(calibration->blockM2[0]));
+}
+
+// Mean and standard deviation of all the samples of the window, merged from those of its blocks
+static void gyroCalibrationWindowDeviation(const gyroCalibration_t *calibration, float *mean, float *stddev)
+{
+    const int32_t samples = calibration->blockCycles * calibration->blockCount;
+
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-        // Reset g[axis] at start of calibration
-        if (isOnFirstGyroCalibrationCycle(&gyroSensor->calibration)) {
-            gyroSensor->calibration.sum[axis] = 0.0f;
-            devClear(&gyroSensor->calibration.var[axis]);
-            // gyroZero is set to zero until calibration complete
-            gyroSensor->gyroDev.gyroZero[axis] = 0.0f;
+        float sum = 0.0f;
+        for (int block = 0; block < calibration->blockCount; block++) {
+            sum += calibration->blockMean[block][axis];
         }
+        mean[axis] = sum / calibration->blockCount;
 
-        // Sum up CALIBRATING_GYRO_TIME_US readings
-        gyroSensor->calibration.sum[axis] += gyroSensor->gyroDev.gyroADCRaw[axis];
-        devPush(&gyroSensor->calibration.var[axis], gyroSensor->gyroDev.gyroADCRaw[axis]);
+        float m2 = 0.0f;
+        for (int block = 0; block < calibration->blockCount; block++) {
+            const float offset = calibration->blockMean[block][axis] - mean[axis];
+            m2 += calibration->blockM2[block][axis] + calibration->blockCycles * offset * offset;
+        }
+        stddev[axis] = (samples > 1) ? sqrtf(m2 / (samples - 1)) : 0.0f;
+    }
+}
 
-        if (isOnFinalGyroCalibrationCycle(&gyroSensor->calibration)) {
-            const float stddev = devStandardDeviation(&gyroSensor->calibration.var[axis]);
-            // DEBUG_GYRO_CALIBRATION records the standard deviation of roll
-            // into the spare field - debug[3], in DEBUG_GYRO_RAW
-            if (axis == X) {
-                DEBUG_SET(DEBUG_GYRO_RAW, DEBUG_GYRO_CALIBRATION, lrintf(stddev));
-            }
+// The samples are collected in blocks and the calibration window slides over them a block at a time. Moving the
+// model only discards the blocks it disturbed, so the calibration completes a window after it is still again
+// instead of starting over. Returns true with the window mean in zero when a full window of still blocks is ready.
+static bool gyroCalibrationUpdateWindow(gyroCalibration_t *calibration, const gyroDev_t *gyroDev, uint8_t gyroMovementCalibrationThreshold, float *zero)
+{
+    if (calibration->blockCyclesRemaining == 0) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            devClear(&calibration->var[axis]);
+        }
+        calibration->blockCyclesRemaining = calibration->blockCycles;
+    }
 
-            // check deviation and startover in case the model was moved
-            if (gyroMovementCalibrationThreshold && stddev > gyroMovementCalibrationThreshold) {
-                gyroSetCalibrationCycles(gyroSensor);
-                return;
-            }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        devPush(&calibration->var[axis], gyroDev->gyroADCRaw[axis]);
+    }
 
-            // please take care with exotic boardalignment !!
-            gyroSensor->gyroDev.gyroZero[axis] = gyroSensor->calibration.sum[axis] / gyroCalculateCalibratingCycles();
-            if (axis == Z) {
-              gyroSensor->gyroDev.gyroZero[axis] -= ((float)gyroConfig()->gyro_offset_yaw / 100);
-            }
-        }
+    if (--calibration->blockCyclesRemaining > 0) {
+        return false;
     }
 
-    if (isOnFinalGyroCalibrationCycle(&gyroSensor->calibration)) {
-        schedulerResetTaskStatistics(TASK_SELF); // so calibration cycles do not pollute tasks statistics
-        if (!firstArmingCalibrationWasStarted || (getArmingDisableFlags() & ~ARMING_DISABLED_CALIBRATING) == 0) {
-            beeper(BEEPER_GYRO_CALIBRATED);
+    if (calibration->blockCount == GYRO_CALIBRATION_BLOCK_COUNT) {
+        gyroCalibrationDropOldestBlock(calibration);
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        calibration->blockMean[calibration->blockCount][axis] = calibration->var[axis].m_oldM;
+        calibration->blockM2[calibration->blockCount][axis] = calibration->var[axis].m_oldS;
+    }
+    ++calibration->blockCount;
+
+    // drop the oldest blocks until the rest of the window is still
+    float mean[XYZ_AXIS_COUNT];
+    float stddev[XYZ_AXIS_COUNT];
+    while (calibration->blockCount > 0) {
+        gyroCalibrationWindowDeviation(calibration, mean, stddev);
+        // DEBUG_GYRO_CALIBRATION records the standard deviation of roll
+        // into the spare field - debug[3], in DEBUG_GYRO_RAW
+        DEBUG_SET(DEBUG_GYRO_RAW, DEBUG_GYRO_CALIBRATION, lrintf(stddev[X]));
+
+        if (!gyroMovementCalibrationThreshold
+            || (stddev[X] <= gyroMovementCalibrationThreshold && stddev[Y] <= gyroMovementCalibrationThreshold && stddev[Z] <= gyroMovementCalibrationThreshold)) {
+            break;
         }
+        gyroCalibrationDropOldestBlock(calibration);
+    }
+
+    if (calibration->blockCount < GYRO_CALIBRATION_BLOCK_COUNT) {
+        return false;
     }
 
-    --gyroSensor->calibration.cyclesRemaining;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        zero[axis] = mean[axis];
+    }
+    // please take care with exotic boardalignment !!
+    zero[Z] -= ((float)gyroConfig()->gyro_offset_yaw / 100);
+
+    return true;
+}
+
+STATIC_UNIT_TESTED void performGyroCalibration(gyroSensor_t *gyroSensor, uint8_t gyroMovementCalibrationThreshold)
+{
+    gyroCalibration_t *calibration = &gyroSensor->calibration;
+    if (calibration->cyclesRemaining == 0) {
+        return;
+    }
+
+    float zero[XYZ_AXIS_COUNT];
+    if (!gyroCalibrationUpdateWindow(calibration, &gyroSensor->gyroDev, gyroMovementCalibrationThreshold, zero)) {
+        const int32_t blockCyclesRemaining = calibration->blockCyclesRemaining ? calibration->blockCyclesRemaining : calibration->blockCycles;
+        calibration->cyclesRemaining = blockCyclesRemaining + (GYRO_CALIBRATION_BLOCK_COUNT - 1 - calibration->blockCount) * calibration->blockCycles;
+        return;
+    }
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        gyroSensor->gyroDev.gyroZero[axis] = zero[axis];
+    }
+    gyroSetSampleTransform(gyroSensor);
+    schedulerResetTaskStatistics(TASK_SELF); // so calibration cycles do not pollute tasks statistics
+    if (!firstArmingCalibrationWasStarted || (getArmingDisableFlags() & ~ARMING_DISABLED_CALIBRATING) == 0) {
+        beeper(BEEPER_GYRO_CALIBRATED);
+    }
+
+    calibration->cyclesRemaining = 0;
+}
+
+// While disarmed the window keeps sliding after the calibration, and every still window moves the zero offsets to
+// its mean, so they follow the drift of the gyro as it warms up. Drift is slow, so a window whose blocks differ by
+// more than a quarter of the noise limit, or whose mean is further off than the noise limit, is taken for the model
+// being turned and ignored.
+static void gyroTrackCalibration(gyroSensor_t *gyroSensor)
+{
+    const gyroCalibration_t *calibration = &gyroSensor->calibration;
+    const uint8_t gyroMovementCalibrationThreshold = gyroConfig()->gyroMovementCalibrationThreshold;
+    float zero[XYZ_AXIS_COUNT];
+
+    if (!gyroMovementCalibrationThreshold
+        || !gyroCalibrationUpdateWindow(&gyroSensor->calibration, &gyroSensor->gyroDev, gyroMovementCalibrationThreshold, zero)) {
+        return;
+    }
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        if (fabsf(zero[axis] - gyroSensor->gyroDev.gyroZero[axis]) > gyroMovementCalibrationThreshold) {
+            return;
+        }
+        const float windowMean = zero[axis] + ((axis == Z) ? (float)gyroConfig()->gyro_offset_yaw / 100 : 0.0f);
+        for (int block = 0; block < calibration->blockCount; block++) {
+            if (fabsf(calibration->blockMean[block][axis] - windowMean) * 4 > gyroMovementCalibrationThreshold) {
+                return;
+            }
+        }
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        gyroSensor->gyroDev.gyroZero[axis] = zero[axis];
+    }
+    gyroSetSampleTransform(gyroSensor);
 }
 
 #if defined(USE_GYRO_SLEW_LIMITER)
@@ -267,12 +398,11 @@ FAST_CODE int32_t gyroSlewLimiter(gyroSensor_t *gyroSensor, int axis)
         // don't use the slew limiter if overflow checking is on or gyro is not subject to overflow bug
         return ret;
     }
-    if (abs(ret - gyroSensor->gyroDev.gyroADCRawPrevious[axis]) > (1<<14)) {
-        // there has been a large change in value, so assume overflow has occurred and return the previous value
-        ret = gyroSensor->gyroDev.gyroADCRawPrevious[axis];
-    } else {
-        gyroSensor->gyroDev.gyroADCRawPrevious[axis] = ret;
-    }
+    // a large change in value is taken as an overflow and the previous value is returned,
+    // it is stored back unchanged in that case so both outcomes are the same select
+    const int32_t previous = gyroSensor->gyroDev.gyroADCRawPrevious[axis];
+    ret = abs(ret - previous) > (1<<14) ? previous : ret;
+    gyroSensor->gyroDev.gyroADCRawPrevious[axis] = ret;
     return ret;
 }
 #endif
@@ -299,85 +429,185 @@ static FAST_CODE_NOINLINE void handleOverflow(timeUs_t currentTimeUs)
         overflowTimeUs = currentTimeUs;
     }
 }
+#endif // USE_GYRO_OVERFLOW_CHECK
+
+#ifdef USE_YAW_SPIN_RECOVERY
+static FAST_CODE_NOINLINE void handleYawSpin(timeUs_t currentTimeUs)
+{
+    const float yawSpinResetRate = yawSpinRecoveryThreshold - 100.0f;
+    if (fabsf(gyro.gyroADCf[Z]) < yawSpinResetRate) {
+        // testing whether 20ms of consecutive OK gyro yaw values is enough
+        if (cmpTimeUs(currentTimeUs, yawSpinTimeUs) > 20000) {
+            yawSpinDetected = false;
+        }
+    } else {
+        // reset the yaw spin time
+        yawSpinTimeUs = currentTimeUs;
+    }
+}
+#endif // USE_YAW_SPIN_RECOVERY
 
-static FAST_CODE void checkForOverflow(timeUs_t currentTimeUs)
+#ifdef USE_GYRO_ANOMALY_CHECK
+#ifdef USE_GYRO_OVERFLOW_CHECK
+static FAST_CODE_NOINLINE bool detectOverflow(timeUs_t currentTimeUs)
 {
     // check for overflow to handle Yaw Spin To The Moon (YSTTM)
     // ICM gyros are specified to +/- 2000 deg/sec, in a crash they can go out of spec.
     // This can cause an overflow and sign reversal in the output.
     // Overflow and sign reversal seems to result in a gyro value of +1996 or -1996.
-    if (overflowDetected) {
-        handleOverflow(currentTimeUs);
-    } else {
-#ifndef SIMULATOR_BUILD
-        // check for overflow in the axes set in overflowAxisMask
-        gyroOverflow_e overflowCheck = GYRO_OVERFLOW_NONE;
+    if (!overflowCheckEnabled) {
+        return false;
+    }
 
-        // This will need to be revised if we ever allow different sensor types to be
-        // used simultaneously. In that case the scale might be different between sensors.
-        // It's complicated by the fact that we're using filtered gyro data here which is
-        // after both sensors are scaled and averaged.
-        const float gyroOverflowTriggerRate = GYRO_OVERFLOW_TRIGGER_THRESHOLD * gyro.scale;
+    // check for overflow in the axes set in overflowAxisMask
+    gyroOverflow_e overflowCheck = GYRO_OVERFLOW_NONE;
 
-        if (fabsf(gyro.gyroADCf[X]) > gyroOverflowTriggerRate) {
-            overflowCheck |= GYRO_OVERFLOW_X;
-        }
-        if (fabsf(gyro.gyroADCf[Y]) > gyroOverflowTriggerRate) {
-            overflowCheck |= GYRO_OVERFLOW_Y;
-        }
-        if (fabsf(gyro.gyroADCf[Z]) > gyroOverflowTriggerRate) {
-            overflowCheck |= GYRO_OVERFLOW_Z;
-        }
-        if (overflowCheck & gyro.overflowAxisMask) {
-            overflowDetected = true;
-            overflowTimeUs = currentTimeUs;
+    // This will need to be revised if we ever allow different sensor types to be
+    // used simultaneously. In that case the scale might be different between sensors.
+    // It's complicated by the fact that we're using filtered gyro data here which is
+    // after both sensors are scaled and averaged.
+    const float gyroOverflowTriggerRate = GYRO_OVERFLOW_TRIGGER_THRESHOLD * gyro.scale;
+
+    if (fabsf(gyro.gyroADCf[X]) > gyroOverflowTriggerRate) {
+        overflowCheck |= GYRO_OVERFLOW_X;
+    }
+    if (fabsf(gyro.gyroADCf[Y]) > gyroOverflowTriggerRate) {
+        overflowCheck |= GYRO_OVERFLOW_Y;
+    }
+    if (fabsf(gyro.gyroADCf[Z]) > gyroOverflowTriggerRate) {
+        overflowCheck |= GYRO_OVERFLOW_Z;
+    }
+    if (overflowCheck & gyro.overflowAxisMask) {
+        overflowDetected = true;
+        overflowTimeUs = currentTimeUs;
 #ifdef USE_YAW_SPIN_RECOVERY
-            yawSpinDetected = false;
+        yawSpinDetected = false;
 #endif // USE_YAW_SPIN_RECOVERY
-        }
-#endif // SIMULATOR_BUILD
+        return true;
     }
+
+    return false;
 }
 #endif // USE_GYRO_OVERFLOW_CHECK
 
+static FAST_CODE_NOINLINE void handleAnomaly(timeUs_t currentTimeUs)
+{
+#ifdef USE_GYRO_OVERFLOW_CHECK
+    if (overflowDetected) {
+        handleOverflow(currentTimeUs);
+        return;
+    }
+    // an overflow takes over from a yaw spin
+    if (detectOverflow(currentTimeUs)) {
+        return;
+    }
+#endif
 #ifdef USE_YAW_SPIN_RECOVERY
-static FAST_CODE_NOINLINE void handleYawSpin(timeUs_t currentTimeUs)
+    handleYawSpin(currentTimeUs);
+#endif
+}
+
+// Called when a rate is beyond the lowest trigger rate of its axis, works out which of the checks hit
+static FAST_CODE_NOINLINE void detectAnomaly(timeUs_t currentTimeUs)
 {
-    const float yawSpinResetRate = yawSpinRecoveryThreshold - 100.0f;
-    if (fabsf(gyro.gyroADCf[Z]) < yawSpinResetRate) {
-        // testing whether 20ms of consecutive OK gyro yaw values is enough
-        if (cmpTimeUs(currentTimeUs, yawSpinTimeUs) > 20000) {
-            yawSpinDetected = false;
-        }
-    } else {
-        // reset the yaw spin time
+#ifdef USE_GYRO_OVERFLOW_CHECK
+    if (detectOverflow(currentTimeUs)) {
+        return;
+    }
+#endif
+
+#ifdef USE_YAW_SPIN_RECOVERY
+    // if not in overflow mode, handle yaw spins above threshold
+    if (yawSpinRecoveryEnabled && fabsf(gyro.gyroADCf[Z]) > yawSpinRecoveryThreshold) {
+        yawSpinDetected = true;
         yawSpinTimeUs = currentTimeUs;
     }
+#endif // USE_YAW_SPIN_RECOVERY
 }
 
-static FAST_CODE void checkForYawSpin(timeUs_t currentTimeUs)
+static FAST_CODE void checkForAnomalies(timeUs_t currentTimeUs)
 {
-    // if not in overflow mode, handle yaw spins above threshold
-#ifdef USE_GYRO_OVERFLOW_CHECK
-    if (overflowDetected) {
-        yawSpinDetected = false;
+    // once detected, the reset conditions are checked on every cycle
+    if (ANOMALY_DETECTED()) {
+        handleAnomaly(currentTimeUs);
         return;
     }
-#endif // USE_GYRO_OVERFLOW_CHECK
 
-    if (yawSpinDetected) {
-        handleYawSpin(currentTimeUs);
-    } else {
+    if (!ARMING_FLAG(ARMED) && ++anomalyCheckCount < GYRO_ANOMALY_CHECK_DISARMED_DENOM) {
+        return;
+    }
+    anomalyCheckCount = 0;
+
+    // one compare per axis against the lowest trigger rate of all checks, combined without branches
+    const bool triggered = (fabsf(gyro.gyroADCf[X]) > anomalyTriggerRate[X])
+        | (fabsf(gyro.gyroADCf[Y]) > anomalyTriggerRate[Y])
+        | (fabsf(gyro.gyroADCf[Z]) > anomalyTriggerRate[Z]);
+    if (triggered) {
+        detectAnomaly(currentTimeUs);
+    }
+}
+
+// Collect the trigger rates of the enabled checks, after gyroInit() and whenever the yaw spin threshold changes
+void gyroInitAnomalyCheck(void)
+{
+    anomalyCheckEnabled = false;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        anomalyTriggerRate[axis] = FLT_MAX;
+    }
+
 #ifndef SIMULATOR_BUILD
-        // check for spin on yaw axis only
-         if (abs((int)gyro.gyroADCf[Z]) > yawSpinRecoveryThreshold) {
-            yawSpinDetected = true;
-            yawSpinTimeUs = currentTimeUs;
+#ifdef USE_GYRO_OVERFLOW_CHECK
+    overflowCheckEnabled = gyroConfig()->checkOverflow && !gyro.gyroHasOverflowProtection;
+    if (overflowCheckEnabled) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            if (gyro.overflowAxisMask & (1 << axis)) {
+                anomalyTriggerRate[axis] = GYRO_OVERFLOW_TRIGGER_THRESHOLD * gyro.scale;
+                anomalyCheckEnabled = true;
+            }
         }
+    }
+#endif
+#ifdef USE_YAW_SPIN_RECOVERY
+    if (yawSpinRecoveryEnabled) {
+        anomalyTriggerRate[Z] = MIN(anomalyTriggerRate[Z], yawSpinRecoveryThreshold);
+        anomalyCheckEnabled = true;
+    }
+#endif
 #endif // SIMULATOR_BUILD
+}
+#endif // USE_GYRO_ANOMALY_CHECK
+
+static FAST_CODE void gyroProcessSensorSample(gyroSensor_t *gyroSensor)
+{
+    if (isGyroSensorCalibrationComplete(gyroSensor)) {
+#if defined(USE_GYRO_SLEW_LIMITER)
+        const float x = gyroSlewLimiter(gyroSensor, X);
+        const float y = gyroSlewLimiter(gyroSensor, Y);
+        const float z = gyroSlewLimiter(gyroSensor, Z);
+#else
+        const float x = gyroSensor->gyroDev.gyroADCRaw[X];
+        const float y = gyroSensor->gyroDev.gyroADCRaw[Y];
+        const float z = gyroSensor->gyroDev.gyroADCRaw[Z];
+#endif
+
+        // zero offset, scale and alignment in a single multiply-add pass, see gyroSetSampleTransform()
+        const fp_rotationMatrix_t *transform = &gyroSensor->sampleTransform;
+        gyroSensor->gyroDev.gyroADC[X] = transform->m[0][X] * x + transform->m[1][X] * y + transform->m[2][X] * z - gyroSensor->sampleOffset[X];
+        gyroSensor->gyroDev.gyroADC[Y] = transform->m[0][Y] * x + transform->m[1][Y] * y + transform->m[2][Y] * z - gyroSensor->sampleOffset[Y];
+        gyroSensor->gyroDev.gyroADC[Z] = transform->m[0][Z] * x + transform->m[1][Z] * y + transform->m[2][Z] * z - gyroSensor->sampleOffset[Z];
+
+        if (gyroConfig()->gyroCalibrationTracking) {
+            if (!ARMING_FLAG(ARMED)) {
+                gyroTrackCalibration(gyroSensor);
+            } else {
+                // start tracking afresh on disarming
+                gyroCalibrationResetWindow(&gyroSensor->calibration);
+            }
+        }
+    } else {
+        performGyroCalibration(gyroSensor, gyroConfig()->gyroMovementCalibrationThreshold);
     }
 }
-#endif // USE_YAW_SPIN_RECOVERY
 
 static FAST_CODE FAST_CODE_NOINLINE void gyroUpdateSensor(gyroSensor_t *gyroSensor)
 {
@@ -386,75 +616,185 @@ static FAST_CODE FAST_CODE_NOINLINE void gyroUpdateSensor(gyroSensor_t *gyroSens
     }
     gyroSensor->gyroDev.dataReady = false;
 
-    if (isGyroSensorCalibrationComplete(gyroSensor)) {
-        // move 16-bit gyro data into 32-bit variables to avoid overflows in calculations
+    gyroProcessSensorSample(gyroSensor);
+}
 
-#if defined(USE_GYRO_SLEW_LIMITER)
-        gyroSensor->gyroDev.gyroADC[X] = gyroSlewLimiter(gyroSensor, X) - gyroSensor->gyroDev.gyroZero[X];
-        gyroSensor->gyroDev.gyroADC[Y] = gyroSlewLimiter(gyroSensor, Y) - gyroSensor->gyroDev.gyroZero[Y];
-        gyroSensor->gyroDev.gyroADC[Z] = gyroSlewLimiter(gyroSensor, Z) - gyroSensor->gyroDev.gyroZero[Z];
-#else
-        gyroSensor->gyroDev.gyroADC[X] = gyroSensor->gyroDev.gyroADCRaw[X] - gyroSensor->gyroDev.gyroZero[X];
-        gyroSensor->gyroDev.gyroADC[Y] = gyroSensor->gyroDev.gyroADCRaw[Y] - gyroSensor->gyroDev.gyroZero[Y];
-        gyroSensor->gyroDev.gyroADC[Z] = gyroSensor->gyroDev.gyroADCRaw[Z] - gyroSensor->gyroDev.gyroZero[Z];
+static FAST_CODE void gyroAccumulateSample(void)
+{
+#ifdef USE_GYRO_DECIMATION
+    if (gyro.decimationEnabled) {
+        float samples[XYZ_AXIS_COUNT] = { gyro.gyroADC[X], gyro.gyroADC[Y], gyro.gyroADC[Z] };
+        if (gyro.downsampleFilterEnabled) {
+            gyro.lowpass2FilterApplyFn((filter3_t *)&gyro.lowpass2Filter, samples);
+        }
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            // sampleSum keeps the latest decimated output until the filter task picks it up
+            firDecimatorApply(&gyro.decimator[axis], samples[axis], &gyro.sampleSum[axis]);
+        }
+        return;
+    }
 #endif
 
-        if (gyroSensor->gyroDev.gyroAlign == ALIGN_CUSTOM) {
-            alignSensorViaMatrix(gyroSensor->gyroDev.gyroADC, &gyroSensor->gyroDev.rotationMatrix);
-        } else {
-            alignSensorViaRotation(gyroSensor->gyroDev.gyroADC, gyroSensor->gyroDev.gyroAlign);
-        }
+    if (gyro.downsampleFilterEnabled) {
+        // using gyro lowpass 2 filter for downsampling
+        gyro.sampleSum[X] = gyro.gyroADC[X];
+        gyro.sampleSum[Y] = gyro.gyroADC[Y];
+        gyro.sampleSum[Z] = gyro.gyroADC[Z];
+        gyro.lowpass2FilterApplyFn((filter3_t *)&gyro.lowpass2Filter, gyro.sampleSum);
     } else {
-        performGyroCalibration(gyroSensor, gyroConfig()->gyroMovementCalibrationThreshold);
+        // using simple averaging for downsampling
+        gyro.sampleSum[X] += gyro.gyroADC[X];
+        gyro.sampleSum[Y] += gyro.gyroADC[Y];
+        gyro.sampleSum[Z] += gyro.gyroADC[Z];
+        gyro.sampleCount++;
     }
 }
 
+#ifdef USE_MULTI_GYRO
+#define GYRO_FUSION_WINDOW_SAMPLES 1024   // samples between noise estimates
+#define GYRO_FUSION_MIN_WEIGHT 0.2f       // so that a gyro which stops changing can't take over completely
+
+static FAST_CODE_NOINLINE void gyroUpdateFusionWeights(gyroFusion_t *fusion)
+{
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float variance1 = devVariance(&fusion->noise[0][axis]);
+        const float variance2 = devVariance(&fusion->noise[1][axis]);
+
+        // inverse variance weighting gives the lowest noise combination of the two gyros
+        if (variance1 + variance2 > 0.0f) {
+            fusion->weight[axis] = constrainf(variance2 / (variance1 + variance2), GYRO_FUSION_MIN_WEIGHT, 1.0f - GYRO_FUSION_MIN_WEIGHT);
+        }
+
+        if (axis == (int)gyro.gyroDebugAxis) {
+            DEBUG_SET(DEBUG_GYRO_FUSION, 0, lrintf(fusion->weight[axis] * 1000.0f));
+            DEBUG_SET(DEBUG_GYRO_FUSION, 1, lrintf(sqrtf(variance1) * 100.0f));
+            DEBUG_SET(DEBUG_GYRO_FUSION, 2, lrintf(sqrtf(variance2) * 100.0f));
+        }
+
+        devClear(&fusion->noise[0][axis]);
+        devClear(&fusion->noise[1][axis]);
+    }
+}
+
+static FAST_CODE void gyroFuseNoiseWeighted(gyroFusion_t *fusion)
+{
+    const float *sample1 = gyro.gyroSensor1.gyroDev.gyroADC;
+    const float *sample2 = gyro.gyroSensor2.gyroDev.gyroADC;
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        // Both gyros see the same rotation, which changes little from one sample to the next,
+        // so the spread of the sample to sample change is dominated by each gyro's own noise
+        if (fusion->primed) {
+            devPush(&fusion->noise[0][axis], sample1[axis] - fusion->previous[0][axis]);
+            devPush(&fusion->noise[1][axis], sample2[axis] - fusion->previous[1][axis]);
+        }
+        fusion->previous[0][axis] = sample1[axis];
+        fusion->previous[1][axis] = sample2[axis];
+
+        gyro.gyroADC[axis] = fusion->weight[axis] * sample1[axis] + (1.0f - fusion->weight[axis]) * sample2[axis];
+    }
+    fusion->primed = true;
+
+    if (fusion->noise[0][X].m_n >= GYRO_FUSION_WINDOW_SAMPLES) {
+        gyroUpdateFusionWeights(fusion);
+    }
+}
+#endif
+
+#ifdef USE_GYRO_FIFO
+// A FIFO burst read returns several samples at once, each of which goes through calibration,
+// alignment and downsampling exactly as if it had been read on its own
+static FAST_CODE_NOINLINE void gyroUpdateSensorFifo(gyroSensor_t *gyroSensor)
+{
+    gyroDev_t *gyroDev = &gyroSensor->gyroDev;
+
+    if (!gyroDev->readFn(gyroDev)) {
+        return;
+    }
+    gyroDev->dataReady = false;
+
+    for (int i = 0; i < gyroDev->fifoSampleCount; i++) {
+        gyroDev->gyroADCRaw[X] = gyroDev->fifoSamples[i][X];
+        gyroDev->gyroADCRaw[Y] = gyroDev->fifoSamples[i][Y];
+        gyroDev->gyroADCRaw[Z] = gyroDev->fifoSamples[i][Z];
+
+        gyroProcessSensorSample(gyroSensor);
+        if (isGyroSensorCalibrationComplete(gyroSensor)) {
+            gyro.gyroADC[X] = gyroDev->gyroADC[X];
+            gyro.gyroADC[Y] = gyroDev->gyroADC[Y];
+            gyro.gyroADC[Z] = gyroDev->gyroADC[Z];
+        }
+        gyroAccumulateSample();
+    }
+}
+#endif
+
 FAST_CODE void gyroUpdate(void)
 {
+#ifdef USE_GYRO_TIMESTAMP
+    // the data about to be read was signalled by the latest interrupt
+    gyro.sampleCycles = gyro.rawSensorDev->dataReadyCycles;
+#endif
+
+#ifdef USE_GYRO_FIFO
+    if (gyro.fifoDepth > 1) {
+        // only used with a single gyro, see gyroInitSensor()
+#ifdef USE_MULTI_GYRO
+        gyroUpdateSensorFifo((gyro.gyroToUse == GYRO_CONFIG_USE_GYRO_2) ? &gyro.gyroSensor2 : &gyro.gyroSensor1);
+#else
+        gyroUpdateSensorFifo(&gyro.gyroSensor1);
+#endif
+        return;
+    }
+#endif
+
     switch (gyro.gyroToUse) {
     case GYRO_CONFIG_USE_GYRO_1:
         gyroUpdateSensor(&gyro.gyroSensor1);
         if (isGyroSensorCalibrationComplete(&gyro.gyroSensor1)) {
-            gyro.gyroADC[X] = gyro.gyroSensor1.gyroDev.gyroADC[X] * gyro.gyroSensor1.gyroDev.scale;
-            gyro.gyroADC[Y] = gyro.gyroSensor1.gyroDev.gyroADC[Y] * gyro.gyroSensor1.gyroDev.scale;
-            gyro.gyroADC[Z] = gyro.gyroSensor1.gyroDev.gyroADC[Z] * gyro.gyroSensor1.gyroDev.scale;
+            gyro.gyroADC[X] = gyro.gyroSensor1.gyroDev.gyroADC[X];
+            gyro.gyroADC[Y] = gyro.gyroSensor1.gyroDev.gyroADC[Y];
+            gyro.gyroADC[Z] = gyro.gyroSensor1.gyroDev.gyroADC[Z];
         }
         break;
 #ifdef USE_MULTI_GYRO
     case GYRO_CONFIG_USE_GYRO_2:
         gyroUpdateSensor(&gyro.gyroSensor2);
         if (isGyroSensorCalibrationComplete(&gyro.gyroSensor2)) {
-            gyro.gyroADC[X] = gyro.gyroSensor2.gyroDev.gyroADC[X] * gyro.gyroSensor2.gyroDev.scale;
-            gyro.gyroADC[Y] = gyro.gyroSensor2.gyroDev.gyroADC[Y] * gyro.gyroSensor2.gyroDev.scale;
-            gyro.gyroADC[Z] = gyro.gyroSensor2.gyroDev.gyroADC[Z] * gyro.gyroSensor2.gyroDev.scale;
+            gyro.gyroADC[X] = gyro.gyroSensor2.gyroDev.gyroADC[X];
+            gyro.gyroADC[Y] = gyro.gyroSensor2.gyroDev.gyroADC[Y];
+            gyro.gyroADC[Z] = gyro.gyroSensor2.gyroDev.gyroADC[Z];
         }
         break;
     case GYRO_CONFIG_USE_GYRO_BOTH:
         gyroUpdateSensor(&gyro.gyroSensor1);
         gyroUpdateSensor(&gyro.gyroSensor2);
         if (isGyroSensorCalibrationComplete(&gyro.gyroSensor1) && isGyroSensorCalibrationComplete(&gyro.gyroSensor2)) {
-            gyro.gyroADC[X] = ((gyro.gyroSensor1.gyroDev.gyroADC[X] * gyro.gyroSensor1.gyroDev.scale) + (gyro.gyroSensor2.gyroDev.gyroADC[X] * gyro.gyroSensor2.gyroDev.scale)) / 2.0f;
-            gyro.gyroADC[Y] = ((gyro.gyroSensor1.gyroDev.gyroADC[Y] * gyro.gyroSensor1.gyroDev.scale) + (gyro.gyroSensor2.gyroDev.gyroADC[Y] * gyro.gyroSensor2.gyroDev.scale)) / 2.0f;
-            gyro.gyroADC[Z] = ((gyro.gyroSensor1.gyroDev.gyroADC[Z] * gyro.gyroSensor1.gyroDev.scale) + (gyro.gyroSensor2.gyroDev.gyroADC[Z] * gyro.gyroSensor2.gyroDev.scale)) / 2.0f;
+            if (gyro.fusion.noiseWeighted) {
+                gyroFuseNoiseWeighted(&gyro.fusion);
+            } else {
+                gyro.gyroADC[X] = (gyro.gyroSensor1.gyroDev.gyroADC[X] + gyro.gyroSensor2.gyroDev.gyroADC[X]) / 2.0f;
+                gyro.gyroADC[Y] = (gyro.gyroSensor1.gyroDev.gyroADC[Y] + gyro.gyroSensor2.gyroDev.gyroADC[Y]) / 2.0f;
+                gyro.gyroADC[Z] = (gyro.gyroSensor1.gyroDev.gyroADC[Z] + gyro.gyroSensor2.gyroDev.gyroADC[Z]) / 2.0f;
+            }
         }
         break;
 #endif
     }
 
-    if (gyro.downsampleFilterEnabled) {
-        // using gyro lowpass 2 filter for downsampling
-        gyro.sampleSum[X] = gyro.lowpass2FilterApplyFn((filter_t *)&gyro.lowpass2Filter[X], gyro.gyroADC[X]);
-        gyro.sampleSum[Y] = gyro.lowpass2FilterApplyFn((filter_t *)&gyro.lowpass2Filter[Y], gyro.gyroADC[Y]);
-        gyro.sampleSum[Z] = gyro.lowpass2FilterApplyFn((filter_t *)&gyro.lowpass2Filter[Z], gyro.gyroADC[Z]);
-    } else {
-        // using simple averaging for downsampling
-        gyro.sampleSum[X] += gyro.gyroADC[X];
-        gyro.sampleSum[Y] += gyro.gyroADC[Y];
-        gyro.sampleSum[Z] += gyro.gyroADC[Z];
-        gyro.sampleCount++;
-    }
+    gyroAccumulateSample();
+}
+
+// Static notch stage and vector lowpass stage of each gyro filter chain variant
+static FAST_CODE float gyroStaticNotchApplyGeneric(int axis, float value)
+{
+    value = gyro.notchFilter1ApplyFn((filter_t *)&gyro.notchFilter1[axis], value);
+    return gyro.notchFilter2ApplyFn((filter_t *)&gyro.notchFilter2[axis], value);
 }
 
+#define GYRO_FILTER_STATIC_NOTCH_APPLY(axis, value) gyroStaticNotchApplyGeneric(axis, value)
+#define GYRO_FILTER_LOWPASS_APPLY(values) gyro.lowpassFilterApplyFn((filter3_t *)&gyro.lowpassFilter, values)
+
 #define GYRO_FILTER_FUNCTION_NAME filterGyro
 #define GYRO_FILTER_DEBUG_SET(mode, index, value) do { UNUSED(mode); UNUSED(index); UNUSED(value); } while (0)
 #define GYRO_FILTER_AXIS_DEBUG_SET(axis, mode, index, value) do { UNUSED(axis); UNUSED(mode); UNUSED(index); UNUSED(value); } while (0)
@@ -471,17 +811,92 @@ FAST_CODE void gyroUpdate(void)
 #undef GYRO_FILTER_DEBUG_SET
 #undef GYRO_FILTER_AXIS_DEBUG_SET
 
+#undef GYRO_FILTER_STATIC_NOTCH_APPLY
+#undef GYRO_FILTER_LOWPASS_APPLY
+
+// Variants without debug output or static notches, the lowpass is called directly
+#define GYRO_FILTER_DEBUG_SET(mode, index, value) do { UNUSED(mode); UNUSED(index); UNUSED(value); } while (0)
+#define GYRO_FILTER_AXIS_DEBUG_SET(axis, mode, index, value) do { UNUSED(axis); UNUSED(mode); UNUSED(index); UNUSED(value); } while (0)
+#define GYRO_FILTER_STATIC_NOTCH_APPLY(axis, value) (UNUSED(axis), (value))
+
+#define GYRO_FILTER_FUNCTION_NAME filterGyroNoLpf
+#define GYRO_FILTER_LOWPASS_APPLY(values) UNUSED(values)
+#include "gyro_filter_impl.c"
+#undef GYRO_FILTER_FUNCTION_NAME
+#undef GYRO_FILTER_LOWPASS_APPLY
+
+#define GYRO_FILTER_FUNCTION_NAME filterGyroPt1
+#define GYRO_FILTER_LOWPASS_APPLY(values) pt1Filter3Apply(&gyro.lowpassFilter.pt1FilterState, values)
+#include "gyro_filter_impl.c"
+#undef GYRO_FILTER_FUNCTION_NAME
+#undef GYRO_FILTER_LOWPASS_APPLY
+
+#define GYRO_FILTER_FUNCTION_NAME filterGyroBiquad
+#ifdef USE_DYN_LPF
+#define GYRO_FILTER_LOWPASS_APPLY(values) biquadFilter3ApplyDF1(&gyro.lowpassFilter.biquadFilterState, values)
+#else
+#define GYRO_FILTER_LOWPASS_APPLY(values) biquadFilter3Apply(&gyro.lowpassFilter.biquadFilterState, values)
+#endif
+#include "gyro_filter_impl.c"
+#undef GYRO_FILTER_FUNCTION_NAME
+#undef GYRO_FILTER_LOWPASS_APPLY
+
+#undef GYRO_FILTER_STATIC_NOTCH_APPLY
+
+#undef GYRO_FILTER_DEBUG_SET
+#undef GYRO_FILTER_AXIS_DEBUG_SET
+
+#ifdef USE_GYRO_TIMESTAMP
+// A missed or late interrupt gives an interval that isn't the sample spacing
+#define GYRO_SAMPLE_DT_MIN_RATIO 0.5f
+#define GYRO_SAMPLE_DT_MAX_RATIO 1.5f
+
+static FAST_CODE void gyroUpdateSampleDt(void)
+{
+    const uint32_t sampleCycles = gyro.sampleCycles;
+    gyro.sampleDtUs = gyro.targetLooptime;
+
+    if (sampleCycles && gyro.filteredSampleCycles) {
+        const float dtUs = (sampleCycles - gyro.filteredSampleCycles) * gyro.cyclesToUs;
+        if (dtUs > gyro.targetLooptime * GYRO_SAMPLE_DT_MIN_RATIO && dtUs < gyro.targetLooptime * GYRO_SAMPLE_DT_MAX_RATIO) {
+            gyro.sampleDtUs = dtUs;
+        }
+        DEBUG_SET(DEBUG_GYRO_SAMPLE_DT, 0, lrintf(gyro.sampleDtUs * 10.0f));
+        DEBUG_SET(DEBUG_GYRO_SAMPLE_DT, 1, lrintf(MIN(dtUs, 3276.0f) * 10.0f));
+        DEBUG_SET(DEBUG_GYRO_SAMPLE_DT, 2, gyro.targetLooptime * 10);
+    }
+    gyro.filteredSampleCycles = sampleCycles;
+}
+#endif
+
 FAST_CODE void gyroFiltering(timeUs_t currentTimeUs)
 {
-    if (gyro.gyroDebugMode == DEBUG_NONE) {
-        filterGyro();
-    } else {
+#ifdef USE_GYRO_TIMESTAMP
+    gyroUpdateSampleDt();
+#endif
+
+    if (gyro.gyroDebugMode != DEBUG_NONE) {
         filterGyroDebug();
+    } else {
+        switch (gyro.filterChain) {
+        case GYRO_FILTER_CHAIN_NO_LPF:
+            filterGyroNoLpf();
+            break;
+        case GYRO_FILTER_CHAIN_PT1:
+            filterGyroPt1();
+            break;
+        case GYRO_FILTER_CHAIN_BIQUAD:
+            filterGyroBiquad();
+            break;
+        default:
+            filterGyro();
+            break;
+        }
     }
 
 #ifdef USE_GYRO_DATA_ANALYSE
     if (isDynamicFilterActive()) {
-        gyroDataAnalyse(&gyro.gyroAnalyseState, gyro.notchFilterDyn, gyro.notchFilterDyn2);
+        gyroDataAnalyse(&gyro.gyroAnalyseState, gyro.notchFilterDyn);
     }
 #endif
 
@@ -490,16 +905,16 @@ FAST_CODE void gyroFiltering(timeUs_t currentTimeUs)
         case GYRO_CONFIG_USE_GYRO_1:
             DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 0, gyro.gyroSensor1.gyroDev.gyroADCRaw[X]);
             DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 1, gyro.gyroSensor1.gyroDev.gyroADCRaw[Y]);
-            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 0, lrintf(gyro.gyroSensor1.gyroDev.gyroADC[X] * gyro.gyroSensor1.gyroDev.scale));
-            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 1, lrintf(gyro.gyroSensor1.gyroDev.gyroADC[Y] * gyro.gyroSensor1.gyroDev.scale));
+            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 0, lrintf(gyro.gyroSensor1.gyroDev.gyroADC[X]));
+            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 1, lrintf(gyro.gyroSensor1.gyroDev.gyroADC[Y]));
             break;
 
 #ifdef USE_MULTI_GYRO
         case GYRO_CONFIG_USE_GYRO_2:
             DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 2, gyro.gyroSensor2.gyroDev.gyroADCRaw[X]);
             DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 3, gyro.gyroSensor2.gyroDev.gyroADCRaw[Y]);
-            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 2, lrintf(gyro.gyroSensor2.gyroDev.gyroADC[X] * gyro.gyroSensor2.gyroDev.scale));
-            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 3, lrintf(gyro.gyroSensor2.gyroDev.gyroADC[Y] * gyro.gyroSensor2.gyroDev.scale));
+            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 2, lrintf(gyro.gyroSensor2.gyroDev.gyroADC[X]));
+            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 3, lrintf(gyro.gyroSensor2.gyroDev.gyroADC[Y]));
             break;
 
     case GYRO_CONFIG_USE_GYRO_BOTH:
@@ -507,37 +922,31 @@ FAST_CODE void gyroFiltering(timeUs_t currentTimeUs)
             DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 1, gyro.gyroSensor1.gyroDev.gyroADCRaw[Y]);
             DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 2, gyro.gyroSensor2.gyroDev.gyroADCRaw[X]);
             DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 3, gyro.gyroSensor2.gyroDev.gyroADCRaw[Y]);
-            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 0, lrintf(gyro.gyroSensor1.gyroDev.gyroADC[X] * gyro.gyroSensor1.gyroDev.scale));
-            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 1, lrintf(gyro.gyroSensor1.gyroDev.gyroADC[Y] * gyro.gyroSensor1.gyroDev.scale));
-            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 2, lrintf(gyro.gyroSensor2.gyroDev.gyroADC[X] * gyro.gyroSensor2.gyroDev.scale));
-            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 3, lrintf(gyro.gyroSensor2.gyroDev.gyroADC[Y] * gyro.gyroSensor2.gyroDev.scale));
-            DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, 0, lrintf((gyro.gyroSensor1.gyroDev.gyroADC[X] * gyro.gyroSensor1.gyroDev.scale) - (gyro.gyroSensor2.gyroDev.gyroADC[X] * gyro.gyroSensor2.gyroDev.scale)));
-            DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, 1, lrintf((gyro.gyroSensor1.gyroDev.gyroADC[Y] * gyro.gyroSensor1.gyroDev.scale) - (gyro.gyroSensor2.gyroDev.gyroADC[Y] * gyro.gyroSensor2.gyroDev.scale)));
-            DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, 2, lrintf((gyro.gyroSensor1.gyroDev.gyroADC[Z] * gyro.gyroSensor1.gyroDev.scale) - (gyro.gyroSensor2.gyroDev.gyroADC[Z] * gyro.gyroSensor2.gyroDev.scale)));
+            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 0, lrintf(gyro.gyroSensor1.gyroDev.gyroADC[X]));
+            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 1, lrintf(gyro.gyroSensor1.gyroDev.gyroADC[Y]));
+            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 2, lrintf(gyro.gyroSensor2.gyroDev.gyroADC[X]));
+            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 3, lrintf(gyro.gyroSensor2.gyroDev.gyroADC[Y]));
+            DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, 0, lrintf(gyro.gyroSensor1.gyroDev.gyroADC[X] - gyro.gyroSensor2.gyroDev.gyroADC[X]));
+            DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, 1, lrintf(gyro.gyroSensor1.gyroDev.gyroADC[Y] - gyro.gyroSensor2.gyroDev.gyroADC[Y]));
+            DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, 2, lrintf(gyro.gyroSensor1.gyroDev.gyroADC[Z] - gyro.gyroSensor2.gyroDev.gyroADC[Z]));
             break;
 #endif
         }
     }
 
-#ifdef USE_GYRO_OVERFLOW_CHECK
-    if (gyroConfig()->checkOverflow && !gyro.gyroHasOverflowProtection) {
-        checkForOverflow(currentTimeUs);
-    }
-#endif
-
-#ifdef USE_YAW_SPIN_RECOVERY
-    if (yawSpinRecoveryEnabled) {
-        checkForYawSpin(currentTimeUs);
+#ifdef USE_GYRO_ANOMALY_CHECK
+    if (anomalyCheckEnabled) {
+        checkForAnomalies(currentTimeUs);
     }
 #endif
 
     if (!overflowDetected) {
         for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
             // integrate using trapezium rule to avoid bias
-            accumulatedMeasurements[axis] += 0.5f * (gyroPrevious[axis] + gyro.gyroADCf[axis]) * gyro.targetLooptime;
+            accumulatedMeasurements[axis] += 0.5f * (gyroPrevious[axis] + gyro.gyroADCf[axis]) * gyro.sampleDtUs;
             gyroPrevious[axis] = gyro.gyroADCf[axis];
         }
-        accumulatedMeasurementCount++;
+        accumulatedMeasurementTimeUs += gyro.sampleDtUs;
     }
 
 #if !defined(USE_GYRO_OVERFLOW_CHECK) && !defined(USE_YAW_SPIN_RECOVERY)
@@ -547,14 +956,13 @@ FAST_CODE void gyroFiltering(timeUs_t currentTimeUs)
 
 bool gyroGetAccumulationAverage(float *accumulationAverage)
 {
-    if (accumulatedMeasurementCount) {
+    if (accumulatedMeasurementTimeUs > 0.0f) {
         // If we have gyro data accumulated, calculate average rate that will yield the same rotation
-        const timeUs_t accumulatedMeasurementTimeUs = accumulatedMeasurementCount * gyro.targetLooptime;
         for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
             accumulationAverage[axis] = accumulatedMeasurements[axis] / accumulatedMeasurementTimeUs;
             accumulatedMeasurements[axis] = 0.0f;
         }
-        accumulatedMeasurementCount = 0;
+        accumulatedMeasurementTimeUs = 0.0f;
         return true;
     } else {
         for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
@@ -632,17 +1040,19 @@ void dynLpfGyroUpdate(float throttle)
         } else {
             cutoffFreq = fmax(dynThrottle(throttle) * gyro.dynLpfMax, gyro.dynLpfMin);
         }
+        // several throttle steps map to the same cutoff, especially where it is clamped to the min
+        if (cutoffFreq == gyro.dynLpfPreviousCutoff) {
+            return;
+        }
+        gyro.dynLpfPreviousCutoff = cutoffFreq;
+
         if (gyro.dynLpfFilter == DYN_LPF_PT1) {
             DEBUG_SET(DEBUG_DYN_LPF, 2, cutoffFreq);
-            const float gyroDt = gyro.targetLooptime * 1e-6f;
-            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-                pt1FilterUpdateCutoff(&gyro.lowpassFilter[axis].pt1FilterState, pt1FilterGain(cutoffFreq, gyroDt));
-            }
+            const float gain = pt1FilterGain(cutoffFreq, gyro.targetLooptime * 1e-6f);
+            pt1Filter3UpdateCutoff(&gyro.lowpassFilter.pt1FilterState, gain);
         } else if (gyro.dynLpfFilter == DYN_LPF_BIQUAD) {
             DEBUG_SET(DEBUG_DYN_LPF, 2, cutoffFreq);
-            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-                biquadFilterUpdateLPF(&gyro.lowpassFilter[axis].biquadFilterState, cutoffFreq, gyro.targetLooptime);
-            }
+            biquadFilter3UpdateLPF(&gyro.lowpassFilter.biquadFilterState, cutoffFreq, gyro.targetLooptime);
         }
     }
 }
@@ -673,5 +1083,8 @@ void initYawSpinRecovery(int maxYawRate)
 
     yawSpinRecoveryEnabled = enabledFlag;
     yawSpinRecoveryThreshold = threshold;
+    yawSpinDetected = false;
+
+    gyroInitAnomalyCheck();
 }
 #endif
@@ -44,10 +44,18 @@
 #endif
 
 typedef union gyroLowpassFilter_u {
-    pt1Filter_t pt1FilterState;
-    biquadFilter_t biquadFilterState;
+    pt1Filter3_t pt1FilterState;
+    biquadFilter3_t biquadFilterState;
 } gyroLowpassFilter_t;
 
+// Gyro filter chain variants, the common configurations run a chain with the filter calls resolved at compile time
+typedef enum {
+    GYRO_FILTER_CHAIN_GENERIC = 0,  // static notches, unusual lowpass or debug, uses the filter function pointers
+    GYRO_FILTER_CHAIN_NO_LPF,       // no static notches, no lowpass
+    GYRO_FILTER_CHAIN_PT1,          // no static notches, PT1 lowpass
+    GYRO_FILTER_CHAIN_BIQUAD,       // no static notches, biquad lowpass
+} gyroFilterChain_e;
+
 typedef enum gyroDetectionFlags_e {
     GYRO_NONE_MASK = 0,
     GYRO_1_MASK = BIT(0),
@@ -58,42 +66,80 @@ typedef enum gyroDetectionFlags_e {
 #endif
 } gyroDetectionFlags_t;
 
+#define GYRO_CALIBRATION_BLOCK_COUNT 4 // the calibration window slides by a quarter of gyro_calib_duration
+
 typedef struct gyroCalibration_s {
-    float sum[XYZ_AXIS_COUNT];
-    stdev_t var[XYZ_AXIS_COUNT];
-    int32_t cyclesRemaining;
+    stdev_t var[XYZ_AXIS_COUNT];                                        // samples of the block being collected
+    float blockMean[GYRO_CALIBRATION_BLOCK_COUNT][XYZ_AXIS_COUNT];      // still blocks in the window, oldest first
+    float blockM2[GYRO_CALIBRATION_BLOCK_COUNT][XYZ_AXIS_COUNT];        // sum of squared deviations from the block mean
+    int32_t blockCycles;
+    int32_t blockCyclesRemaining;
+    int32_t cyclesRemaining;                                            // until the window can be complete, 0 once calibrated
+    uint8_t blockCount;
 } gyroCalibration_t;
 
 typedef struct gyroSensor_s {
     gyroDev_t gyroDev;
     gyroCalibration_t calibration;
+    fp_rotationMatrix_t sampleTransform;        // scale and sensor/board alignment applied to each raw sample
+    float sampleOffset[XYZ_AXIS_COUNT];         // calibrated zero offset after sampleTransform
 } gyroSensor_t;
 
+#ifdef USE_MULTI_GYRO
+typedef enum {
+    GYRO_FUSION_AVERAGE = 0,
+    GYRO_FUSION_NOISE_WEIGHTED,
+} gyroFusion_e;
+
+typedef struct gyroFusion_s {
+    bool noiseWeighted;
+    bool primed;                                    // previous holds a sample from each gyro
+    float weight[XYZ_AXIS_COUNT];                   // weight of the first gyro, the second gyro gets the rest
+    float previous[2][XYZ_AXIS_COUNT];
+    stdev_t noise[2][XYZ_AXIS_COUNT];               // sample to sample change of each gyro over the current window
+} gyroFusion_t;
+#endif
+
 typedef struct gyro_s {
     uint16_t sampleRateHz;
     uint32_t targetLooptime;
     uint32_t sampleLooptime;
+    float sampleDtUs;                  // measured interval between the samples filtered, targetLooptime if it can't be measured
+#ifdef USE_GYRO_TIMESTAMP
+    uint32_t sampleCycles;             // data ready interrupt time of the latest sample read
+    uint32_t filteredSampleCycles;     // data ready interrupt time of the sample filtered last
+    float cyclesToUs;
+#endif
     float scale;
     float gyroADC[XYZ_AXIS_COUNT];     // aligned, calibrated, scaled, but unfiltered data from the sensor(s)
     float gyroADCf[XYZ_AXIS_COUNT];    // filtered gyro data
     uint8_t sampleCount;               // gyro sensor sample counter
+    uint8_t fifoDepth;                 // gyro sensor samples read by each gyro task run
     float sampleSum[XYZ_AXIS_COUNT];   // summed samples used for downsampling
     bool downsampleFilterEnabled;      // if true then downsample using gyro lowpass 2, otherwise use averaging
+    bool decimationEnabled;            // if true every sample goes through the FIR decimator, which leaves its output in sampleSum
+#ifdef USE_GYRO_DECIMATION
+    firDecimator_t decimator[XYZ_AXIS_COUNT];
+    float decimatorCoeffs[FIR_DECIMATOR_MAX_FACTOR * FIR_DECIMATOR_TAPS_PER_PHASE];
+#endif
 
     gyroSensor_t gyroSensor1;
 #ifdef USE_MULTI_GYRO
     gyroSensor_t gyroSensor2;
+    gyroFusion_t fusion;               // combines the two gyros when both are used
 #endif
 
     gyroDev_t *rawSensorDev;           // pointer to the sensor providing the raw data for DEBUG_GYRO_RAW
 
+    uint8_t filterChain;               // gyroFilterChain_e selected from the filter configuration
+
     // lowpass gyro soft filter
-    filterApplyFnPtr lowpassFilterApplyFn;
-    gyroLowpassFilter_t lowpassFilter[XYZ_AXIS_COUNT];
+    filter3ApplyFnPtr lowpassFilterApplyFn;
+    gyroLowpassFilter_t lowpassFilter;
 
     // lowpass2 gyro soft filter
-    filterApplyFnPtr lowpass2FilterApplyFn;
-    gyroLowpassFilter_t lowpass2Filter[XYZ_AXIS_COUNT];
+    filter3ApplyFnPtr lowpass2FilterApplyFn;
+    gyroLowpassFilter_t lowpass2Filter;
 
     // notch filters
     filterApplyFnPtr notchFilter1ApplyFn;
@@ -102,12 +148,10 @@ typedef struct gyro_s {
     filterApplyFnPtr notchFilter2ApplyFn;
     biquadFilter_t notchFilter2[XYZ_AXIS_COUNT];
 
-    filterApplyFnPtr notchFilterDynApplyFn;
-    filterApplyFnPtr notchFilterDynApplyFn2;
-    biquadFilter_t notchFilterDyn[XYZ_AXIS_COUNT];
-    biquadFilter_t notchFilterDyn2[XYZ_AXIS_COUNT];
-
 #ifdef USE_GYRO_DATA_ANALYSE
+    uint8_t notchFilterDynCount;
+    biquadFilter_t notchFilterDyn[XYZ_AXIS_COUNT][DYN_NOTCH_COUNT_MAX];
+
     gyroAnalyseState_t gyroAnalyseState;
 #endif
 
@@ -123,6 +167,7 @@ typedef struct gyro_s {
     uint16_t dynLpfMin;
     uint16_t dynLpfMax;
     uint8_t dynLpfCurveExpo;
+    uint16_t dynLpfPreviousCutoff;
 #endif
 
 #ifdef USE_GYRO_OVERFLOW_CHECK
@@ -133,6 +178,7 @@ typedef struct gyro_s {
 
 extern gyro_t gyro;
 extern uint8_t activePidLoopDenom;
+extern uint8_t activeGyroUpdateDenom;
 
 enum {
     GYRO_OVERFLOW_CHECK_NONE = 0,
@@ -191,7 +237,7 @@ typedef struct gyroConfig_s {
     uint16_t dyn_lpf_gyro_max_hz;
 
     uint16_t dyn_notch_max_hz;
-    uint8_t  dyn_notch_width_percent;
+    uint8_t  dyn_notch_count;
     uint16_t dyn_notch_q;
     uint16_t dyn_notch_min_hz;
 
@@ -199,6 +245,13 @@ typedef struct gyroConfig_s {
 
     uint8_t gyrosDetected; // What gyros should detection be attempted for on startup. Automatically set on first startup.
     uint8_t dyn_lpf_curve_expo; // set the curve for dynamic gyro lowpass filter
+    uint8_t dyn_notch_window;   // FFT window size index, 32 << dyn_notch_window samples
+    uint8_t dyn_notch_engine;   // full FFT or sliding DFT peak detection
+    uint8_t gyro_fifo_depth;    // samples accumulated in the sensor FIFO per data ready interrupt, 1 to read every sample
+    uint8_t gyro_fusion;        // how the two gyros are combined when both are used, gyroFusion_e
+    uint8_t gyro_decimation;    // decimate from the sample rate to the PID rate with a FIR rather than averaging
+    uint8_t gyroSpiDetectHint[MAX_GYRODEV_COUNT]; // SPI detect function that found each gyro on the last startup, plus one. Automatically set.
+    uint8_t gyroCalibrationTracking; // keep following the gyro zero offsets while disarmed and still
 } gyroConfig_t;
 
 PG_DECLARE(gyroConfig_t, gyroConfig);
@@ -221,6 +274,9 @@ void dynLpfGyroUpdate(float throttle);
 #ifdef USE_YAW_SPIN_RECOVERY
 void initYawSpinRecovery(int maxYawRate);
 #endif
+#if defined(USE_GYRO_OVERFLOW_CHECK) || defined(USE_YAW_SPIN_RECOVERY)
+void gyroInitAnomalyCheck(void);
+#endif
 #ifdef USE_GYRO_DATA_ANALYSE
 bool isDynamicFilterActive(void);
 #endif
@@ -69,7 +69,9 @@
 
 #include "pg/gyrodev.h"
 
+#include "sensors/boardalignment.h"
 #include "sensors/gyro.h"
+#include "sensors/gyro_init.h"
 #include "sensors/sensors.h"
 
 #ifdef USE_GYRO_DATA_ANALYSE
@@ -132,18 +134,15 @@ static void gyroInitFilterNotch2(uint16_t notchHz, uint16_t notchCutoffHz)
 #ifdef USE_GYRO_DATA_ANALYSE
 static void gyroInitFilterDynamicNotch()
 {
-    gyro.notchFilterDynApplyFn = nullFilterApply;
-    gyro.notchFilterDynApplyFn2 = nullFilterApply;
+    gyro.notchFilterDynCount = 0;
 
     if (isDynamicFilterActive()) {
-        gyro.notchFilterDynApplyFn = (filterApplyFnPtr)biquadFilterApplyDF1; // must be this function, not DF2
-        if(gyroConfig()->dyn_notch_width_percent != 0) {
-            gyro.notchFilterDynApplyFn2 = (filterApplyFnPtr)biquadFilterApplyDF1; // must be this function, not DF2
-        }
+        gyro.notchFilterDynCount = constrain(gyroConfig()->dyn_notch_count, 1, DYN_NOTCH_COUNT_MAX);
         const float notchQ = filterGetNotchQ(DYNAMIC_NOTCH_DEFAULT_CENTER_HZ, DYNAMIC_NOTCH_DEFAULT_CUTOFF_HZ); // any defaults OK here
         for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-            biquadFilterInit(&gyro.notchFilterDyn[axis], DYNAMIC_NOTCH_DEFAULT_CENTER_HZ, gyro.targetLooptime, notchQ, FILTER_NOTCH);
-            biquadFilterInit(&gyro.notchFilterDyn2[axis], DYNAMIC_NOTCH_DEFAULT_CENTER_HZ, gyro.targetLooptime, notchQ, FILTER_NOTCH);
+            for (int p = 0; p < gyro.notchFilterDynCount; p++) {
+                biquadFilterInit(&gyro.notchFilterDyn[axis][p], DYNAMIC_NOTCH_DEFAULT_CENTER_HZ, gyro.targetLooptime, notchQ, FILTER_NOTCH);
+            }
         }
     }
 }
@@ -151,18 +150,18 @@ static void gyroInitFilterDynamicNotch()
 
 static bool gyroInitLowpassFilterLpf(int slot, int type, uint16_t lpfHz, uint32_t looptime)
 {
-    filterApplyFnPtr *lowpassFilterApplyFn;
+    filter3ApplyFnPtr *lowpassFilterApplyFn;
     gyroLowpassFilter_t *lowpassFilter = NULL;
 
     switch (slot) {
     case FILTER_LOWPASS:
         lowpassFilterApplyFn = &gyro.lowpassFilterApplyFn;
-        lowpassFilter = gyro.lowpassFilter;
+        lowpassFilter = &gyro.lowpassFilter;
         break;
 
     case FILTER_LOWPASS2:
         lowpassFilterApplyFn = &gyro.lowpass2FilterApplyFn;
-        lowpassFilter = gyro.lowpass2Filter;
+        lowpassFilter = &gyro.lowpass2Filter;
         break;
 
     default:
@@ -180,27 +179,23 @@ static bool gyroInitLowpassFilterLpf(int slot, int type, uint16_t lpfHz, uint32_
 
     // Dereference the pointer to null before checking valid cutoff and filter
     // type. It will be overridden for positive cases.
-    *lowpassFilterApplyFn = nullFilterApply;
+    *lowpassFilterApplyFn = nullFilter3Apply;
 
     // If lowpass cutoff has been specified and is less than the Nyquist frequency
     if (lpfHz && lpfHz <= gyroFrequencyNyquist) {
         switch (type) {
         case FILTER_PT1:
-            *lowpassFilterApplyFn = (filterApplyFnPtr) pt1FilterApply;
-            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-                pt1FilterInit(&lowpassFilter[axis].pt1FilterState, gain);
-            }
+            *lowpassFilterApplyFn = (filter3ApplyFnPtr) pt1Filter3Apply;
+            pt1Filter3Init(&lowpassFilter->pt1FilterState, gain);
             ret = true;
             break;
         case FILTER_BIQUAD:
 #ifdef USE_DYN_LPF
-            *lowpassFilterApplyFn = (filterApplyFnPtr) biquadFilterApplyDF1;
+            *lowpassFilterApplyFn = (filter3ApplyFnPtr) biquadFilter3ApplyDF1;
 #else
-            *lowpassFilterApplyFn = (filterApplyFnPtr) biquadFilterApply;
+            *lowpassFilterApplyFn = (filter3ApplyFnPtr) biquadFilter3Apply;
 #endif
-            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-                biquadFilterInitLPF(&lowpassFilter[axis].biquadFilterState, lpfHz, looptime);
-            }
+            biquadFilter3InitLPF(&lowpassFilter->biquadFilterState, lpfHz, looptime);
             ret = true;
             break;
         }
@@ -229,9 +224,51 @@ static void dynLpfFilterInit()
     gyro.dynLpfMin = gyroConfig()->dyn_lpf_gyro_min_hz;
     gyro.dynLpfMax = gyroConfig()->dyn_lpf_gyro_max_hz;
     gyro.dynLpfCurveExpo = gyroConfig()->dyn_lpf_curve_expo;
+    gyro.dynLpfPreviousCutoff = 0;
+}
+#endif
+
+// Select the filter chain variant matching the filter function pointers set up by the init functions above
+#ifdef USE_GYRO_DECIMATION
+static void gyroInitDecimation(void)
+{
+    gyro.decimationEnabled = false;
+
+    // only worth it when several samples are filtered down to each PID loop sample
+    const uint32_t factor = gyro.sampleLooptime ? gyro.targetLooptime / gyro.sampleLooptime : 0;
+    if (!gyroConfig()->gyro_decimation || factor < 2 || factor > FIR_DECIMATOR_MAX_FACTOR) {
+        return;
+    }
+
+    firDecimatorInitCoeffs(gyro.decimatorCoeffs, factor);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        firDecimatorInit(&gyro.decimator[axis], gyro.decimatorCoeffs, factor);
+    }
+    gyro.decimationEnabled = true;
 }
 #endif
 
+static void gyroInitFilterChain(void)
+{
+    gyro.filterChain = GYRO_FILTER_CHAIN_GENERIC;
+
+    if (gyro.notchFilter1ApplyFn != nullFilterApply || gyro.notchFilter2ApplyFn != nullFilterApply) {
+        return;
+    }
+
+    if (gyro.lowpassFilterApplyFn == nullFilter3Apply) {
+        gyro.filterChain = GYRO_FILTER_CHAIN_NO_LPF;
+    } else if (gyro.lowpassFilterApplyFn == (filter3ApplyFnPtr)pt1Filter3Apply) {
+        gyro.filterChain = GYRO_FILTER_CHAIN_PT1;
+#ifdef USE_DYN_LPF
+    } else if (gyro.lowpassFilterApplyFn == (filter3ApplyFnPtr)biquadFilter3ApplyDF1) {
+#else
+    } else if (gyro.lowpassFilterApplyFn == (filter3ApplyFnPtr)biquadFilter3Apply) {
+#endif
+        gyro.filterChain = GYRO_FILTER_CHAIN_BIQUAD;
+    }
+}
+
 void gyroInitFilters(void)
 {
     uint16_t gyro_lowpass_hz = gyroConfig()->gyro_lowpass_hz;
@@ -255,9 +292,13 @@ void gyroInitFilters(void)
       gyroConfig()->gyro_lowpass2_hz,
       gyro.sampleLooptime
     );
+#ifdef USE_GYRO_DECIMATION
+    gyroInitDecimation();
+#endif
 
     gyroInitFilterNotch1(gyroConfig()->gyro_soft_notch_hz_1, gyroConfig()->gyro_soft_notch_cutoff_1);
     gyroInitFilterNotch2(gyroConfig()->gyro_soft_notch_hz_2, gyroConfig()->gyro_soft_notch_cutoff_2);
+    gyroInitFilterChain();
 #ifdef USE_GYRO_DATA_ANALYSE
     gyroInitFilterDynamicNotch();
 #endif
@@ -294,10 +335,24 @@ void gyroInitSensor(gyroSensor_t *gyroSensor, const gyroDeviceConfig_t *config)
     buildRotationMatrixFromAlignment(&config->customAlignment, &gyroSensor->gyroDev.rotationMatrix);
     gyroSensor->gyroDev.mpuIntExtiTag = config->extiTag;
     gyroSensor->gyroDev.hardware_lpf = gyroConfig()->gyro_hardware_lpf;
+#ifdef USE_GYRO_FIFO
+    // Drivers able to burst read the sensor FIFO set the deepest burst they support when detected.
+    // Each gyro task run must read the same number of samples from every gyro, so bursts need a single gyro.
+    uint8_t fifoDepth = MIN(gyroConfig()->gyro_fifo_depth, gyroSensor->gyroDev.fifoDepth);
+    if (gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_BOTH) {
+        fifoDepth = 1;
+    }
+    gyroSensor->gyroDev.fifoDepth = MAX(fifoDepth, 1);
+#endif
 
     // The targetLooptime gets set later based on the active sensor's gyroSampleRateHz and pid_process_denom
     gyroSensor->gyroDev.gyroSampleRateHz = gyroSetSampleRate(&gyroSensor->gyroDev);
     gyroSensor->gyroDev.initFn(&gyroSensor->gyroDev);
+#ifdef USE_SPI_DMA
+    if (gyroSensor->gyroDev.bus.bustype == BUSTYPE_SPI) {
+        mpuGyroSpiDmaInit(&gyroSensor->gyroDev);
+    }
+#endif
 
     // As new gyros are supported, be sure to add them below based on whether they are subject to the overflow/inversion bug
     // Any gyro not explicitly defined will default to not having built-in overflow protection as a safe alternative.
@@ -331,9 +386,29 @@ void gyroInitSensor(gyroSensor_t *gyroSensor, const gyroDeviceConfig_t *config)
         break;
     }
 
+    gyroSetSampleTransform(gyroSensor);
+
     gyroInitSensorFilters(gyroSensor);
 }
 
+// Fold the scale and the sensor and board alignment into one matrix, and the zero offset into an offset
+// after it, so that each sample is calibrated, scaled and aligned in one pass. Rebuilt when calibration completes.
+void gyroSetSampleTransform(gyroSensor_t *gyroSensor)
+{
+    gyroDev_t *gyroDev = &gyroSensor->gyroDev;
+    fp_rotationMatrix_t alignment;
+
+    buildAlignmentMatrix(&alignment, gyroDev->gyroAlign, &gyroDev->rotationMatrix);
+
+    for (int out = 0; out < XYZ_AXIS_COUNT; out++) {
+        gyroSensor->sampleOffset[out] = 0.0f;
+        for (int in = 0; in < XYZ_AXIS_COUNT; in++) {
+            gyroSensor->sampleTransform.m[in][out] = alignment.m[in][out] * gyroDev->scale;
+            gyroSensor->sampleOffset[out] += gyroSensor->sampleTransform.m[in][out] * gyroDev->gyroZero[in];
+        }
+    }
+}
+
 STATIC_UNIT_TESTED gyroHardware_e gyroDetect(gyroDev_t *dev)
 {
     gyroHardware_e gyroHardware = GYRO_DEFAULT;
@@ -546,6 +621,30 @@ void gyroPreInit(void)
 #endif
 }
 
+#if defined(USE_MULTI_GYRO)
+static bool gyroCanUseBoth(void)
+{
+    if (gyroDetectionFlags & GYRO_IDENTICAL_MASK) {
+        return true;
+    }
+
+    // With noise weighting the scaled samples of different gyro types can be combined as long as they arrive together
+    return gyro.fusion.noiseWeighted && ((gyroDetectionFlags & GYRO_ALL_MASK) == GYRO_ALL_MASK)
+        && gyroSetSampleRate(&gyro.gyroSensor1.gyroDev) == gyroSetSampleRate(&gyro.gyroSensor2.gyroDev);
+}
+
+static void gyroInitFusion(gyroFusion_t *fusion)
+{
+    fusion->noiseWeighted = (gyroConfig()->gyro_fusion == GYRO_FUSION_NOISE_WEIGHTED);
+    fusion->primed = false;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        fusion->weight[axis] = 0.5f;
+        devClear(&fusion->noise[0][axis]);
+        devClear(&fusion->noise[1][axis]);
+    }
+}
+#endif
+
 bool gyroInit(void)
 {
 #ifdef USE_GYRO_OVERFLOW_CHECK
@@ -562,21 +661,23 @@ bool gyroInit(void)
     gyro.useDualGyroDebugging = false;
     gyro.gyroHasOverflowProtection = true;
 
-    switch (debugMode) {
-    case DEBUG_FFT:
-    case DEBUG_FFT_FREQ:
-    case DEBUG_GYRO_RAW:
-    case DEBUG_GYRO_SCALED:
-    case DEBUG_GYRO_FILTERED:
-    case DEBUG_DYN_LPF:
-    case DEBUG_GYRO_SAMPLE:
-        gyro.gyroDebugMode = debugMode;
-        break;
-    case DEBUG_DUAL_GYRO_DIFF:
-    case DEBUG_DUAL_GYRO_RAW:
-    case DEBUG_DUAL_GYRO_SCALED:
-        gyro.useDualGyroDebugging = true;
-        break;
+    for (int i = 0; i < DEBUG_GROUP_COUNT; i++) {
+        switch (debugModes[i]) {
+        case DEBUG_FFT:
+        case DEBUG_FFT_FREQ:
+        case DEBUG_GYRO_RAW:
+        case DEBUG_GYRO_SCALED:
+        case DEBUG_GYRO_FILTERED:
+        case DEBUG_DYN_LPF:
+        case DEBUG_GYRO_SAMPLE:
+            gyro.gyroDebugMode = debugModes[i];
+            break;
+        case DEBUG_DUAL_GYRO_DIFF:
+        case DEBUG_DUAL_GYRO_RAW:
+        case DEBUG_DUAL_GYRO_SCALED:
+            gyro.useDualGyroDebugging = true;
+            break;
+        }
     }
 
     gyroDetectionFlags = GYRO_NONE_MASK;
@@ -585,11 +686,15 @@ bool gyroInit(void)
     gyro.gyroToUse = gyroConfig()->gyro_to_use;
     gyro.gyroDebugAxis = gyroConfig()->gyro_filter_debug_axis;
 
+    gyro.gyroSensor1.gyroDev.spiDetectIndex = gyroConfig()->gyroSpiDetectHint[0];
     if ((!gyrosToScan || (gyrosToScan & GYRO_1_MASK)) && gyroDetectSensor(&gyro.gyroSensor1, gyroDeviceConfig(0))) {
         gyroDetectionFlags |= GYRO_1_MASK;
     }
 
 #if defined(USE_MULTI_GYRO)
+    gyroInitFusion(&gyro.fusion);
+
+    gyro.gyroSensor2.gyroDev.spiDetectIndex = gyroConfig()->gyroSpiDetectHint[1];
     if ((!gyrosToScan || (gyrosToScan & GYRO_2_MASK)) && gyroDetectSensor(&gyro.gyroSensor2, gyroDeviceConfig(1))) {
         gyroDetectionFlags |= GYRO_2_MASK;
     }
@@ -605,6 +710,17 @@ bool gyroInit(void)
         eepromWriteRequired = true;
     }
 
+    if ((gyroDetectionFlags & GYRO_1_MASK) && gyroConfig()->gyroSpiDetectHint[0] != gyro.gyroSensor1.gyroDev.spiDetectIndex) {
+        gyroConfigMutable()->gyroSpiDetectHint[0] = gyro.gyroSensor1.gyroDev.spiDetectIndex;
+        eepromWriteRequired = true;
+    }
+#if defined(USE_MULTI_GYRO)
+    if ((gyroDetectionFlags & GYRO_2_MASK) && gyroConfig()->gyroSpiDetectHint[1] != gyro.gyroSensor2.gyroDev.spiDetectIndex) {
+        gyroConfigMutable()->gyroSpiDetectHint[1] = gyro.gyroSensor2.gyroDev.spiDetectIndex;
+        eepromWriteRequired = true;
+    }
+#endif
+
 #if defined(USE_MULTI_GYRO)
     if ((gyro.gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH && !((gyroDetectionFlags & GYRO_ALL_MASK) == GYRO_ALL_MASK))
         || (gyro.gyroToUse == GYRO_CONFIG_USE_GYRO_1 && !(gyroDetectionFlags & GYRO_1_MASK))
@@ -619,11 +735,12 @@ bool gyroInit(void)
         eepromWriteRequired = true;
     }
 
-    // Only allow using both gyros simultaneously if they are the same hardware type.
+    // Only allow using both gyros simultaneously if they are the same hardware type, or can be fused by noise weighting.
     if (((gyroDetectionFlags & GYRO_ALL_MASK) == GYRO_ALL_MASK) && gyro.gyroSensor1.gyroDev.gyroHardware == gyro.gyroSensor2.gyroDev.gyroHardware) {
         gyroDetectionFlags |= GYRO_IDENTICAL_MASK;
-    } else if (gyro.gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
-        // If the user selected "BOTH" and they are not the same type, then reset to using only the first gyro.
+    }
+    if (gyro.gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH && !gyroCanUseBoth()) {
+        // If the user selected "BOTH" and the gyros can't be combined, then reset to using only the first gyro.
         gyro.gyroToUse = GYRO_CONFIG_USE_GYRO_1;
         gyroConfigMutable()->gyro_to_use = gyro.gyroToUse;
         eepromWriteRequired = true;
@@ -647,8 +764,7 @@ bool gyroInit(void)
     }
 
     // Copy the sensor's scale to the high-level gyro object. If running in "BOTH" mode
-    // then logic above requires both sensors to be the same so we'll use sensor1's scale.
-    // This will need to be revised if we ever allow different sensor types to be used simultaneously.
+    // the samples are already scaled per sensor, so sensor1's scale only describes the raw data.
     // Likewise determine the appropriate raw data for use in DEBUG_GYRO_RAW
     gyro.scale = gyro.gyroSensor1.gyroDev.scale;
     gyro.rawSensorDev = &gyro.gyroSensor1.gyroDev;
@@ -667,6 +783,10 @@ bool gyroInit(void)
         gyro.accSampleRateHz = 0;
     }
 
+#if defined(USE_GYRO_OVERFLOW_CHECK) || defined(USE_YAW_SPIN_RECOVERY)
+    gyroInitAnomalyCheck();
+#endif
+
     return true;
 }
 
@@ -678,6 +798,13 @@ gyroDetectionFlags_t getGyroDetectionFlags(void)
 void gyroSetTargetLooptime(uint8_t pidDenom)
 {
     activePidLoopDenom = pidDenom;
+#ifdef USE_GYRO_FIFO
+    gyro.fifoDepth = (gyro.rawSensorDev && gyro.rawSensorDev->fifoDepth) ? gyro.rawSensorDev->fifoDepth : 1;
+#else
+    gyro.fifoDepth = 1;
+#endif
+    // pid_process_denom is a multiple of the FIFO depth once the config has been validated
+    activeGyroUpdateDenom = MAX(activePidLoopDenom / gyro.fifoDepth, 1);
     if (gyro.sampleRateHz) {
         gyro.sampleLooptime = 1e6 / gyro.sampleRateHz;
         gyro.targetLooptime = activePidLoopDenom * 1e6 / gyro.sampleRateHz;
@@ -685,8 +812,32 @@ void gyroSetTargetLooptime(uint8_t pidDenom)
         gyro.sampleLooptime = 0;
         gyro.targetLooptime = 0;
     }
+    gyro.sampleDtUs = gyro.targetLooptime;
+#ifdef USE_GYRO_TIMESTAMP
+    gyro.cyclesToUs = 1.0f / clockMicrosToCycles(1);
+    gyro.filteredSampleCycles = 0;
+#endif
 }
 
+#ifdef USE_GYRO_EXTI_REALTIME
+bool gyroSetDataReadyCallback(void (*callback)(void))
+{
+    // The realtime tasks can only be driven by a single data ready interrupt
+    if (gyro.gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
+        return false;
+    }
+
+    gyroDev_t *gyroDev = &ACTIVE_GYRO->gyroDev;
+    if (gyroDev->mpuIntExtiTag == IO_TAG_NONE) {
+        return false;
+    }
+
+    gyroDev->dataReadyCallback = callback;
+
+    return true;
+}
+#endif
+
 const busDevice_t *gyroSensorBus(void)
 {
     return &ACTIVE_GYRO->gyroDev.bus;
@@ -28,7 +28,9 @@ void gyroPreInit(void);
 bool gyroInit(void);
 void gyroInitFilters(void);
 void gyroInitSensor(gyroSensor_t *gyroSensor, const gyroDeviceConfig_t *config);
+void gyroSetSampleTransform(gyroSensor_t *gyroSensor);
 gyroDetectionFlags_t getGyroDetectionFlags(void);
+bool gyroSetDataReadyCallback(void (*callback)(void));
 const busDevice_t *gyroSensorBus(void);
 struct mpuDetectionResult_s;
 const struct mpuDetectionResult_s *gyroMpuDetectionResult(void);
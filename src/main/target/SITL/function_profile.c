@@ -0,0 +1,120 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Per-function call counter for SITL builds made with FUNCTION_PROFILE=yes.
+ *
+ * Every function compiled with -finstrument-functions calls __cyg_profile_func_enter(), which counts
+ * the call against the function address. The counts are written to FUNCTION_PROFILE_FILE when SITL
+ * exits, together with the runtime address of main() so that the addresses can be matched against
+ * the symbols of the (possibly position independent) SITL executable by src/utils/make_fast_code_list.py.
+ */
+
+#ifdef USE_FUNCTION_PROFILE
+
+#include <signal.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define FUNCTION_PROFILE_FILE "function_profile.txt"
+#define FUNCTION_PROFILE_SLOTS 8192 // power of 2, well above the number of functions in the firmware
+
+#define NO_INSTRUMENT __attribute__((no_instrument_function))
+
+typedef struct functionProfileSlot_s {
+    void *fn;
+    uint64_t count;
+} functionProfileSlot_t;
+
+static functionProfileSlot_t functionProfile[FUNCTION_PROFILE_SLOTS];
+
+extern int main(void);
+
+void __cyg_profile_func_enter(void *fn, void *callSite) NO_INSTRUMENT;
+void __cyg_profile_func_exit(void *fn, void *callSite) NO_INSTRUMENT;
+
+void __cyg_profile_func_enter(void *fn, void *callSite)
+{
+    (void)callSite;
+
+    unsigned index = ((uintptr_t)fn >> 2) & (FUNCTION_PROFILE_SLOTS - 1);
+    for (unsigned probe = 0; probe < FUNCTION_PROFILE_SLOTS; probe++) {
+        functionProfileSlot_t *slot = &functionProfile[index];
+        void *current = __atomic_load_n(&slot->fn, __ATOMIC_RELAXED);
+        if (current == NULL) {
+            // claim the free slot, another thread may be claiming it at the same time
+            if (!__atomic_compare_exchange_n(&slot->fn, &current, fn, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED) && current != fn) {
+                index = (index + 1) & (FUNCTION_PROFILE_SLOTS - 1);
+                continue;
+            }
+            current = fn;
+        }
+        if (current == fn) {
+            __atomic_fetch_add(&slot->count, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        index = (index + 1) & (FUNCTION_PROFILE_SLOTS - 1);
+    }
+}
+
+void __cyg_profile_func_exit(void *fn, void *callSite)
+{
+    (void)fn;
+    (void)callSite;
+}
+
+static NO_INSTRUMENT void functionProfileWrite(void)
+{
+    FILE *file = fopen(FUNCTION_PROFILE_FILE, "w");
+    if (!file) {
+        printf("[profile]Unable to write %s\n", FUNCTION_PROFILE_FILE);
+        return;
+    }
+
+    fprintf(file, "main 0x%" PRIxPTR "\n", (uintptr_t)main);
+    for (unsigned i = 0; i < FUNCTION_PROFILE_SLOTS; i++) {
+        if (functionProfile[i].fn) {
+            fprintf(file, "%p %llu\n", functionProfile[i].fn, (unsigned long long)functionProfile[i].count);
+        }
+    }
+    fclose(file);
+
+    printf("[profile]Call counts written to %s\n", FUNCTION_PROFILE_FILE);
+}
+
+static NO_INSTRUMENT void functionProfileSignalHandler(int signal)
+{
+    (void)signal;
+
+    // SITL normally runs until interrupted, exit() runs the atexit() handler that writes the counts
+    exit(0);
+}
+
+static NO_INSTRUMENT __attribute__((constructor)) void functionProfileInit(void)
+{
+    atexit(functionProfileWrite);
+    signal(SIGINT, functionProfileSignalHandler);
+    signal(SIGTERM, functionProfileSignalHandler);
+}
+
+#endif // USE_FUNCTION_PROFILE
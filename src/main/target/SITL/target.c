@@ -25,6 +25,7 @@
 #include <string.h>
 
 #include <errno.h>
+#include <signal.h>
 #include <time.h>
 
 #include "common/maths.h"
@@ -70,6 +71,30 @@ static udpLink_t stateLink, pwmLink;
 static pthread_mutex_t updateLock;
 static pthread_mutex_t mainLoopLock;
 
+#ifdef SIMULATOR_LOCKSTEP
+/*
+ * Lock-step simulation: the firmware clock only advances in the main loop, SIMULATOR_LOCKSTEP_STEP_US per pass.
+ * Each state packet from the simulator lets the firmware run for the simulated time since the previous packet,
+ * after which the motor outputs are sent back and the main loop waits for the next packet. The packet is applied
+ * from the main loop too, so a run only depends on the packets and not on the speed of the host.
+ *
+ * Without packets for SIMULATOR_LOCKSTEP_TIMEOUT_US of real time the clock runs on by the same amount, so the
+ * firmware can still be configured while no simulator is connected.
+ */
+#define SIMULATOR_LOCKSTEP_STEP_US      1
+#define SIMULATOR_LOCKSTEP_TIMEOUT_US   100000
+
+static pthread_mutex_t lockstepLock;
+static pthread_cond_t lockstepCond;
+static fdm_packet lockstepPkt;          // latest packet from the simulator, handed to the main loop
+static bool lockstepPktPending = false;
+
+// only written by the main loop
+static uint64_t lockstepTimeUs = 0;
+static uint64_t lockstepTargetUs = 0;
+static bool lockstepReplyPending = false;
+#endif
+
 int timeval_sub(struct timespec *result, struct timespec *x, struct timespec *y);
 
 int lockMainPID(void) {
@@ -152,13 +177,18 @@ void updateState(const fdm_packet* pkt) {
     imuUpdateAttitude(micros());
 #endif
 
-
+#ifdef SIMULATOR_LOCKSTEP
+    // run the firmware for the step of this packet, then answer it
+    lockstepTargetUs = MAX(lockstepTargetUs, lockstepTimeUs) + (uint64_t)(deltaSim * 1e6);
+    lockstepReplyPending = true;
+#else
     if (deltaSim < 0.02 && deltaSim > 0) { // simulator should run faster than 50Hz
 //        simRate = simRate * 0.5 + (1e6 * deltaSim / (realtime_now - last_realtime)) * 0.5;
         struct timespec out_ts;
         timeval_sub(&out_ts, &now_ts, &last_ts);
         simRate = deltaSim / (out_ts.tv_sec + 1e-9*out_ts.tv_nsec);
     }
+#endif
 //    printf("simRate = %lf, millis64 = %lu, millis64_real = %lu, deltaSim = %lf\n", simRate, millis64(), millis64_real(), deltaSim*1e6);
 
     last_timestamp = pkt->timestamp;
@@ -167,13 +197,113 @@ void updateState(const fdm_packet* pkt) {
     last_ts.tv_sec = now_ts.tv_sec;
     last_ts.tv_nsec = now_ts.tv_nsec;
 
+#ifndef SIMULATOR_LOCKSTEP
     pthread_mutex_unlock(&updateLock); // can send PWM output now
+#endif
 
 #if defined(SIMULATOR_GYROPID_SYNC)
     pthread_mutex_unlock(&mainLoopLock); // can run main loop
 #endif
 }
 
+#ifdef SIMULATOR_LOCKSTEP
+void lockstepAdvance(void)
+{
+    if (lockstepTimeUs >= lockstepTargetUs) {
+        if (lockstepReplyPending) {
+            lockstepReplyPending = false;
+            sendMotorUpdate();
+        }
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += SIMULATOR_LOCKSTEP_TIMEOUT_US * 1000;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000;
+        deadline.tv_nsec %= 1000000000;
+
+        bool received = false;
+        fdm_packet pkt;
+        pthread_mutex_lock(&lockstepLock);
+        while (!lockstepPktPending && workerRunning) {
+            if (pthread_cond_timedwait(&lockstepCond, &lockstepLock, &deadline) == ETIMEDOUT) {
+                break;
+            }
+        }
+        if (lockstepPktPending) {
+            pkt = lockstepPkt;
+            lockstepPktPending = false;
+            received = true;
+        }
+        pthread_mutex_unlock(&lockstepLock);
+
+        if (received) {
+            updateState(&pkt);
+        } else {
+            lockstepTargetUs = lockstepTimeUs + SIMULATOR_LOCKSTEP_TIMEOUT_US;
+        }
+    }
+
+    // other threads read the clock as well
+    __atomic_store_n(&lockstepTimeUs, lockstepTimeUs + SIMULATOR_LOCKSTEP_STEP_US, __ATOMIC_RELAXED);
+}
+
+static void lockstepAdvanceBy(uint64_t us)
+{
+    __atomic_store_n(&lockstepTimeUs, lockstepTimeUs + us, __ATOMIC_RELAXED);
+}
+
+static void lockstepPrintStats(void)
+{
+    const uint64_t realUs = micros64_real();
+    printf("[lockstep]simulated %.3fs in %.3fs, %.2fx real time\n", lockstepTimeUs * 1e-6, realUs * 1e-6, realUs ? (double)lockstepTimeUs / realUs : 0);
+    printf("[lockstep]task                rate/hz  avg/ns  max/ns  total/ms\n");
+    for (taskId_e taskId = 0; taskId < TASK_COUNT; taskId++) {
+        taskInfo_t taskInfo;
+        getTaskInfo(taskId, &taskInfo);
+        if (taskInfo.isEnabled && taskInfo.averageDeltaTimeUs) {
+            printf("[lockstep]%-18s %8d %7u %7u %9u\n", taskInfo.taskName, (int)(1000000 / taskInfo.averageDeltaTimeUs),
+                taskInfo.averageExecutionTimeNs, taskInfo.maxExecutionTimeNs, taskInfo.totalExecutionTimeUs / 1000);
+        }
+    }
+}
+
+static void lockstepSignalHandler(int signal)
+{
+    UNUSED(signal);
+
+    // exit() runs the atexit() handler that prints the statistics
+    exit(0);
+}
+#endif
+
+#if defined(SIMULATOR_LOCKSTEP) || defined(USE_BENCHMARK)
+// Cycles are nanoseconds of the real clock, in lockstep the simulated one stands still while a task runs
+uint32_t getCycleCounter(void)
+{
+    return nanos64_real();
+}
+
+uint32_t clockCyclesToMicros(uint32_t clockCycles)
+{
+    return clockCycles / 1000;
+}
+
+uint32_t clockCyclesTo10thMicros(uint32_t clockCycles)
+{
+    return clockCycles / 100;
+}
+
+uint32_t clockCyclesToNanos(uint32_t clockCycles)
+{
+    return clockCycles;
+}
+
+uint32_t clockMicrosToCycles(uint32_t micros)
+{
+    return micros * 1000;
+}
+#endif
+
 static void* udpThread(void* data) {
     UNUSED(data);
     int n = 0;
@@ -182,7 +312,15 @@ static void* udpThread(void* data) {
         n = udpRecv(&stateLink, &fdmPkt, sizeof(fdm_packet), 100);
         if (n == sizeof(fdm_packet)) {
 //            printf("[data]new fdm %d\n", n);
+#ifdef SIMULATOR_LOCKSTEP
+            pthread_mutex_lock(&lockstepLock);
+            lockstepPkt = fdmPkt;
+            lockstepPktPending = true;
+            pthread_cond_signal(&lockstepCond);
+            pthread_mutex_unlock(&lockstepLock);
+#else
             updateState(&fdmPkt);
+#endif
         }
     }
 
@@ -225,6 +363,17 @@ void systemInit(void) {
         exit(1);
     }
 
+#ifdef SIMULATOR_LOCKSTEP
+    if (pthread_mutex_init(&lockstepLock, NULL) != 0 || pthread_cond_init(&lockstepCond, NULL) != 0) {
+        printf("Create lockstepLock error!\n");
+        exit(1);
+    }
+    atexit(lockstepPrintStats);
+    signal(SIGINT, lockstepSignalHandler);
+    signal(SIGTERM, lockstepSignalHandler);
+    printf("[system]Lock-step simulation\n");
+#endif
+
     ret = pthread_create(&tcpWorker, NULL, tcpThread, NULL);
     if (ret != 0) {
         printf("Create tcpWorker error!\n");
@@ -303,6 +452,9 @@ uint64_t millis64_real() {
 }
 
 uint64_t micros64() {
+#ifdef SIMULATOR_LOCKSTEP
+    return __atomic_load_n(&lockstepTimeUs, __ATOMIC_RELAXED);
+#endif
     static uint64_t last = 0;
     static uint64_t out = 0;
     uint64_t now = nanos64_real();
@@ -315,6 +467,9 @@ uint64_t micros64() {
 }
 
 uint64_t millis64() {
+#ifdef SIMULATOR_LOCKSTEP
+    return __atomic_load_n(&lockstepTimeUs, __ATOMIC_RELAXED) / 1000;
+#endif
     static uint64_t last = 0;
     static uint64_t out = 0;
     uint64_t now = nanos64_real();
@@ -342,7 +497,12 @@ void microsleep(uint32_t usec) {
 }
 
 void delayMicroseconds(uint32_t us) {
+#ifdef SIMULATOR_LOCKSTEP
+    // busy waits take simulated time only
+    lockstepAdvanceBy(us);
+#else
     microsleep(us / simRate);
+#endif
 }
 
 void delayMicroseconds_real(uint32_t us) {
@@ -350,6 +510,10 @@ void delayMicroseconds_real(uint32_t us) {
 }
 
 void delay(uint32_t ms) {
+#ifdef SIMULATOR_LOCKSTEP
+    lockstepAdvanceBy((uint64_t)ms * 1000);
+    return;
+#endif
     uint64_t start = millis64();
 
     while ((millis64() - start) < ms) {
@@ -458,6 +622,10 @@ static void pwmCompleteMotorUpdate(void)
     pwmPkt.motor_speed[1] = motorsPwm[2] / outScale;
     pwmPkt.motor_speed[2] = motorsPwm[3] / outScale;
 
+#ifdef SIMULATOR_LOCKSTEP
+    // sent by lockstepAdvance() once the step of the state packet is done
+    return;
+#endif
     // get one "fdm_packet" can only send one "servo_packet"!!
     if (pthread_mutex_trylock(&updateLock) != 0) return;
     udpSend(&pwmLink, &pwmPkt, sizeof(servo_packet));
@@ -565,8 +733,11 @@ void FLASH_Lock(void) {
 }
 
 FLASH_Status FLASH_ErasePage(uintptr_t Page_Address) {
-    UNUSED(Page_Address);
 //    printf("[FLASH_ErasePage]%x\n", Page_Address);
+    if ((Page_Address >= (uintptr_t)eepromData) && (Page_Address < (uintptr_t)ARRAYEND(eepromData))) {
+        // erased flash reads as 0xFF, the config log relies on it to find free space
+        memset((void *)Page_Address, 0xFF, MIN(FLASH_PAGE_SIZE, (uintptr_t)ARRAYEND(eepromData) - Page_Address));
+    }
     return FLASH_COMPLETE;
 }
 
@@ -44,6 +44,7 @@
 #define EEPROM_FILENAME "eeprom.bin"
 #define CONFIG_IN_FILE
 #define EEPROM_SIZE     32768
+#define FLASH_PAGE_SIZE (0x400)
 
 #define U_ID_0 0
 #define U_ID_1 1
@@ -91,6 +92,12 @@
 #define USE_PARAMETER_GROUPS
 
 #undef USE_STACK_CHECK // I think SITL don't need this
+#ifndef SIMULATOR_LOCKSTEP
+#undef USE_TASK_STATISTICS_CYCLE_COUNTER
+#endif
+#undef USE_LATENCY_STATS
+#undef USE_PC_SAMPLING
+#undef USE_GYRO_TIMESTAMP
 #undef USE_DASHBOARD
 #undef USE_TELEMETRY_LTM
 #undef USE_ADC
@@ -256,5 +263,6 @@ uint64_t micros64(void);
 uint64_t millis64(void);
 
 int lockMainPID(void);
+void lockstepAdvance(void);
 
 
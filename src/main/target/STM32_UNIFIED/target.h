@@ -256,4 +256,12 @@
 #define USE_ACCGYRO_BMI270
 
 #define USE_BARO_BMP085
+
+// Keep the parsed custom defaults as a binary image, costs CUSTOM_DEFAULTS_IMAGE_SIZE bytes of RAM
+#define USE_CUSTOM_DEFAULTS_IMAGE
+#endif
+
+#ifdef USE_BOARD_FEATURES
+// Generated from the board's unified target configuration when building with CONFIG=<board>
+#include "board_features.h"
 #endif
@@ -396,6 +396,8 @@ extern uint8_t __config_end;
 
 #if defined(USE_CUSTOM_DEFAULTS)
 #define USE_CUSTOM_DEFAULTS_ADDRESS
+#else
+#undef USE_CUSTOM_DEFAULTS_IMAGE
 #endif
 
 #if !defined(USE_EXTI)
@@ -70,6 +70,7 @@
 #define USE_PERSISTENT_OBJECTS
 #define USE_CUSTOM_DEFAULTS_ADDRESS
 #define USE_SPI_TRANSACTION
+#define USE_SPI_DMA             // Non-blocking SPI sequences, used when SPI_TX and SPI_RX DMA are both configured for the bus
 
 #if defined(STM32F40_41xxx) || defined(STM32F411xE)
 #define USE_OVERCLOCK
@@ -100,6 +101,9 @@
 #define USE_PERSISTENT_OBJECTS
 #define USE_CUSTOM_DEFAULTS_ADDRESS
 #define USE_SPI_TRANSACTION
+#define FLASHFS_WRITE_BUFFER_SIZE 2048
+#define USE_BLACKBOX_CAPTURE_WINDOW
+#define AFATFS_NUM_CACHE_SECTORS 24
 #endif // STM32F7
 
 #ifdef STM32H7
@@ -123,7 +127,10 @@
 #define USE_USB_MSC
 #define USE_RTC_TIME
 #define USE_PERSISTENT_MSC_RTC
-#define USE_DSHOT_CACHE_MGMT
+#define FLASHFS_WRITE_BUFFER_SIZE 8192 // Four W25N01G pages, enough to ride out a block erase at high logging rates
+#define USE_BLACKBOX_CAPTURE_WINDOW
+#define BLACKBOX_PRETRIGGER_FRAMES 256
+#define AFATFS_NUM_CACHE_SECTORS 64 // 32KB of the log can be waiting for the card
 #endif
 
 #ifdef STM32G4
@@ -213,6 +220,27 @@
 #define DMA_RAM_RW
 #endif
 
+// Buffers a DMA controller reads (_W, written by the CPU), writes (_R, read by the CPU) or both (_RW).
+// They are placed in memory the data cache does not hold, so no cache maintenance is needed around
+// the transfers: D2 SRAM mapped shareable by the MPU on H7 and DTCM on F7. Other MCUs have no data cache.
+#if defined(STM32H7)
+#define DMA_BUFFER_W DMA_RAM
+#define DMA_BUFFER_R DMA_RAM
+#define DMA_BUFFER_RW DMA_RAM
+#elif defined(STM32G4)
+#define DMA_BUFFER_W DMA_RAM_W
+#define DMA_BUFFER_R DMA_RAM_R
+#define DMA_BUFFER_RW DMA_RAM_RW
+#elif defined(STM32F7)
+#define DMA_BUFFER_W FAST_DATA_ZERO_INIT
+#define DMA_BUFFER_R FAST_DATA_ZERO_INIT
+#define DMA_BUFFER_RW FAST_DATA_ZERO_INIT
+#else
+#define DMA_BUFFER_W
+#define DMA_BUFFER_R
+#define DMA_BUFFER_RW
+#endif
+
 #define USE_BRUSHED_ESC_AUTODETECT  // Detect if brushed motors are connected and set defaults appropriately to avoid motors spinning on boot
 
 #define USE_MOTOR
@@ -221,9 +249,12 @@
 #define USE_TIMER
 
 #define USE_CLI
+#define USE_DEBUG_MODES         // Write the values of the selected debug modes, undefine to leave DEBUG_SET out of the build
 #define USE_SERIAL_PASSTHROUGH
 #define USE_TASK_STATISTICS
+#define USE_TASK_STATISTICS_CYCLE_COUNTER  // Time the task statistics with the DWT cycle counter rather than micros()
 #define USE_GYRO_REGISTER_DUMP  // Adds gyroregisters command to cli to dump configured register values
+#define USE_GYRO_TIMESTAMP      // Time gyro samples at the data ready interrupt, so filtering and the I-term use the measured sample interval
 #define USE_IMU_CALC
 #define USE_PPM
 #define USE_SERIAL_RX
@@ -255,6 +286,7 @@
 #endif
 
 #if (TARGET_FLASH_SIZE > 128)
+#define USE_CLI_SETTING_INDEX   // Look up setting names in a sorted index rather than the whole value table
 #define USE_GYRO_OVERFLOW_CHECK
 #define USE_YAW_SPIN_RECOVERY
 #define USE_DSHOT_DMAR
@@ -354,6 +386,7 @@
 
 #if (TARGET_FLASH_SIZE > 256)
 #define USE_AIRMODE_LPF
+#define USE_CURRENT_LIMIT
 #define USE_CANVAS
 #define USE_DASHBOARD
 #define USE_FRSKYOSD
@@ -362,6 +395,8 @@
 #define USE_GPS_UBLOX
 #define USE_GPS_RESCUE
 #define USE_GYRO_DLPF_EXPERIMENTAL
+#define USE_GYRO_FIFO
+#define USE_GYRO_DECIMATION
 #define USE_OSD
 #define USE_OSD_OVER_MSP_DISPLAYPORT
 #define USE_MULTI_GYRO
@@ -389,6 +424,8 @@
 #define USE_TELEMETRY_SENSORS_DISABLED_DETAILS
 #define USE_VTX_TABLE
 #define USE_PERSISTENT_STATS
+#define USE_LATENCY_STATS       // Adds latency command to cli to report gyro sample to motor output latency
+#define USE_PC_SAMPLING         // Samples the program counter every SysTick for MSP2_PC_SAMPLES
 #define USE_PROFILE_NAMES
 #define USE_SERIALRX_SRXL2     // Spektrum SRXL2 protocol
 #define USE_INTERPOLATED_SP
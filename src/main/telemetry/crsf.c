@@ -68,6 +68,8 @@
 
 
 #define CRSF_CYCLETIME_US                   100000 // 100ms, 10 Hz
+#define CRSF_TELEMETRY_LQ_MIN               25     // Downlink link quality below which the frame rate is not reduced any further
+#define CRSF_TELEMETRY_LQ_DEGRADED          70     // Downlink link quality below which low priority frames are sent every other cycle
 #define CRSF_DEVICEINFO_VERSION             0x01
 #define CRSF_DEVICEINFO_PARAMETER_COUNT     0
 
@@ -190,14 +192,15 @@ void crsfFrameBatterySensor(sbuf_t *dst)
     // use sbufWrite since CRC does not include frame length
     sbufWriteU8(dst, CRSF_FRAME_BATTERY_SENSOR_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC);
     sbufWriteU8(dst, CRSF_FRAMETYPE_BATTERY_SENSOR);
+    const telemetrySnapshot_t *snapshot = telemetryGetSnapshot();
     if (telemetryConfig()->report_cell_voltage) {
-        sbufWriteU16BigEndian(dst, (getBatteryAverageCellVoltage() + 5) / 10); // vbat is in units of 0.01V
+        sbufWriteU16BigEndian(dst, (snapshot->batteryAverageCellVoltage + 5) / 10); // vbat is in units of 0.01V
     } else {
-        sbufWriteU16BigEndian(dst, getLegacyBatteryVoltage());
+        sbufWriteU16BigEndian(dst, snapshot->legacyBatteryVoltage);
     }
-    sbufWriteU16BigEndian(dst, getAmperage() / 10);
-    const uint32_t mAhDrawn = getMAhDrawn();
-    const uint8_t batteryRemainingPercentage = calculateBatteryPercentageRemaining();
+    sbufWriteU16BigEndian(dst, snapshot->amperage / 10);
+    const uint32_t mAhDrawn = snapshot->mAhDrawn;
+    const uint8_t batteryRemainingPercentage = snapshot->batteryRemainingPercentage;
     sbufWriteU8(dst, (mAhDrawn >> 16));
     sbufWriteU8(dst, (mAhDrawn >> 8));
     sbufWriteU8(dst, (uint8_t)mAhDrawn);
@@ -239,9 +242,10 @@ void crsfFrameAttitude(sbuf_t *dst)
 {
      sbufWriteU8(dst, CRSF_FRAME_ATTITUDE_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC);
      sbufWriteU8(dst, CRSF_FRAMETYPE_ATTITUDE);
-     sbufWriteU16BigEndian(dst, DECIDEGREES_TO_RADIANS10000(attitude.values.pitch));
-     sbufWriteU16BigEndian(dst, DECIDEGREES_TO_RADIANS10000(attitude.values.roll));
-     sbufWriteU16BigEndian(dst, DECIDEGREES_TO_RADIANS10000(attitude.values.yaw));
+     const attitudeEulerAngles_t *snapshotAttitude = &telemetryGetSnapshot()->attitude;
+     sbufWriteU16BigEndian(dst, DECIDEGREES_TO_RADIANS10000(snapshotAttitude->values.pitch));
+     sbufWriteU16BigEndian(dst, DECIDEGREES_TO_RADIANS10000(snapshotAttitude->values.roll));
+     sbufWriteU16BigEndian(dst, DECIDEGREES_TO_RADIANS10000(snapshotAttitude->values.yaw));
 }
 
 /*
@@ -416,17 +420,18 @@ static void crsfFrameDisplayPortClear(sbuf_t *dst)
 
 #define BV(x)  (1 << (x)) // bit value
 
-// schedule array to decide how often each type of frame is sent
+// schedule array to decide how often each type of frame is sent, in order of priority
 typedef enum {
     CRSF_FRAME_START_INDEX = 0,
     CRSF_FRAME_ATTITUDE_INDEX = CRSF_FRAME_START_INDEX,
     CRSF_FRAME_BATTERY_SENSOR_INDEX,
-    CRSF_FRAME_FLIGHT_MODE_INDEX,
     CRSF_FRAME_GPS_INDEX,
+    CRSF_FRAME_FLIGHT_MODE_INDEX,
     CRSF_SCHEDULE_COUNT_MAX
 } crsfFrameTypeIndex_e;
 
 static uint8_t crsfScheduleCount;
+static uint8_t crsfSchedulePriorityCount; // leading schedule entries that are sent every cycle on a degraded downlink
 static uint8_t crsfSchedule[CRSF_SCHEDULE_COUNT_MAX];
 
 #if defined(USE_MSP_OVER_TELEMETRY)
@@ -453,9 +458,10 @@ void crsfSendMspResponse(uint8_t *payload)
 }
 #endif
 
-static void processCrsf(void)
+static void processCrsf(bool downlinkDegraded)
 {
     static uint8_t crsfScheduleIndex = 0;
+    static bool skipLowPriority = false;
 
     const uint8_t currentSchedule = crsfSchedule[crsfScheduleIndex];
 
@@ -473,11 +479,6 @@ static void processCrsf(void)
         crsfFinalize(dst);
     }
 
-    if (currentSchedule & BV(CRSF_FRAME_FLIGHT_MODE_INDEX)) {
-        crsfInitializeFrame(dst);
-        crsfFrameFlightMode(dst);
-        crsfFinalize(dst);
-    }
 #ifdef USE_GPS
     if (currentSchedule & BV(CRSF_FRAME_GPS_INDEX)) {
         crsfInitializeFrame(dst);
@@ -485,7 +486,19 @@ static void processCrsf(void)
         crsfFinalize(dst);
     }
 #endif
-    crsfScheduleIndex = (crsfScheduleIndex + 1) % crsfScheduleCount;
+    if (currentSchedule & BV(CRSF_FRAME_FLIGHT_MODE_INDEX)) {
+        crsfInitializeFrame(dst);
+        crsfFrameFlightMode(dst);
+        crsfFinalize(dst);
+    }
+
+    // on a degraded downlink every other cycle only sends the high priority frames, rather than
+    // encoding frames the link has no room for
+    crsfScheduleIndex++;
+    if (crsfScheduleIndex >= crsfScheduleCount || (skipLowPriority && crsfScheduleIndex >= crsfSchedulePriorityCount)) {
+        crsfScheduleIndex = 0;
+        skipLowPriority = downlinkDegraded && !skipLowPriority;
+    }
 }
 
 void crsfScheduleDeviceInfoResponse(void)
@@ -517,13 +530,14 @@ void initCrsfTelemetry(void)
         || (isAmperageConfigured() && telemetryIsSensorEnabled(SENSOR_CURRENT | SENSOR_FUEL))) {
         crsfSchedule[index++] = BV(CRSF_FRAME_BATTERY_SENSOR_INDEX);
     }
-    crsfSchedule[index++] = BV(CRSF_FRAME_FLIGHT_MODE_INDEX);
+    crsfSchedulePriorityCount = MAX(index, 1);
 #ifdef USE_GPS
     if (featureIsEnabled(FEATURE_GPS)
        && telemetryIsSensorEnabled(SENSOR_ALTITUDE | SENSOR_LAT_LONG | SENSOR_GROUND_SPEED | SENSOR_HEADING)) {
         crsfSchedule[index++] = BV(CRSF_FRAME_GPS_INDEX);
     }
 #endif
+    crsfSchedule[index++] = BV(CRSF_FRAME_FLIGHT_MODE_INDEX);
     crsfScheduleCount = (uint8_t)index;
  }
 
@@ -629,9 +643,12 @@ void handleCrsfTelemetry(timeUs_t currentTimeUs)
 
     // Actual telemetry data only needs to be sent at a low frequency, ie 10Hz
     // Spread out scheduled frames evenly so each frame is sent at the same frequency.
-    if (currentTimeUs >= crsfLastCycleTime + (CRSF_CYCLETIME_US / crsfScheduleCount)) {
+    // Frames are spaced further apart as the downlink link quality drops, as more of them would be lost.
+    const uint8_t downlinkLinkQuality = MAX(crsfRxGetDownlinkLinkQuality(), CRSF_TELEMETRY_LQ_MIN);
+    const uint32_t frameIntervalUs = CRSF_CYCLETIME_US / crsfScheduleCount * 100 / downlinkLinkQuality;
+    if (currentTimeUs >= crsfLastCycleTime + frameIntervalUs) {
         crsfLastCycleTime = currentTimeUs;
-        processCrsf();
+        processCrsf(downlinkLinkQuality < CRSF_TELEMETRY_LQ_DEGRADED);
     }
 }
 
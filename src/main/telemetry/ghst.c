@@ -96,14 +96,15 @@ void ghstFramePackTelemetry(sbuf_t *dst)
     sbufWriteU8(dst, GHST_FRAME_PACK_PAYLOAD_SIZE + GHST_FRAME_LENGTH_CRC + GHST_FRAME_LENGTH_TYPE);
     sbufWriteU8(dst, 0x23);                     // GHST_DL_PACK_STAT
 
+    const telemetrySnapshot_t *snapshot = telemetryGetSnapshot();
     if (telemetryConfig()->report_cell_voltage) {
-        sbufWriteU16(dst, getBatteryAverageCellVoltage());      // units of 10mV
+        sbufWriteU16(dst, snapshot->batteryAverageCellVoltage); // units of 10mV
     } else {
-        sbufWriteU16(dst, getBatteryVoltage());
+        sbufWriteU16(dst, snapshot->batteryVoltage);
     }
-    sbufWriteU16(dst, getAmperage());                           // units of 10mA
+    sbufWriteU16(dst, snapshot->amperage);                      // units of 10mA
 
-    sbufWriteU16(dst, getMAhDrawn() / 10);                      // units of 10mAh (range of 0-655.36Ah)
+    sbufWriteU16(dst, snapshot->mAhDrawn / 10);                 // units of 10mAh (range of 0-655.36Ah)
 
     sbufWriteU8(dst, 0x00);                     // Rx Voltage, units of 100mV (not passed from BF, added in Ghost Rx)
 
@@ -183,8 +183,9 @@ static void ltm_sframe(void)
     if (failsafeIsActive())
         lt_statemode |= 2;
     ltm_initialise_packet('S');
-    ltm_serialise_16(getBatteryVoltage() * 10); // vbat converted to mV
-    ltm_serialise_16((uint16_t)constrain(getMAhDrawn(), 0, UINT16_MAX)); // consumption in mAh (65535 mAh max)
+    const telemetrySnapshot_t *snapshot = telemetryGetSnapshot();
+    ltm_serialise_16(snapshot->batteryVoltage * 10); // vbat converted to mV
+    ltm_serialise_16((uint16_t)constrain(snapshot->mAhDrawn, 0, UINT16_MAX)); // consumption in mAh (65535 mAh max)
     ltm_serialise_8(constrain(scaleRange(getRssi(), 0, RSSI_MAX_VALUE, 0, 255), 0, 255));        // scaled RSSI (uchar)
     ltm_serialise_8(0);              // no airspeed
     ltm_serialise_8((lt_flightmode << 2) | lt_statemode);
@@ -197,10 +198,11 @@ static void ltm_sframe(void)
  */
 static void ltm_aframe(void)
 {
+    const attitudeEulerAngles_t *snapshotAttitude = &telemetryGetSnapshot()->attitude;
     ltm_initialise_packet('A');
-    ltm_serialise_16(DECIDEGREES_TO_DEGREES(attitude.values.pitch));
-    ltm_serialise_16(DECIDEGREES_TO_DEGREES(attitude.values.roll));
-    ltm_serialise_16(DECIDEGREES_TO_DEGREES(attitude.values.yaw));
+    ltm_serialise_16(DECIDEGREES_TO_DEGREES(snapshotAttitude->values.pitch));
+    ltm_serialise_16(DECIDEGREES_TO_DEGREES(snapshotAttitude->values.roll));
+    ltm_serialise_16(DECIDEGREES_TO_DEGREES(snapshotAttitude->values.yaw));
     ltm_finalise();
 }
 
@@ -20,6 +20,8 @@
 
 #pragma once
 
+#define TELEMETRY_MAVLINK_MAXRATE 50
+
 void initMAVLinkTelemetry(void);
 void handleMAVLinkTelemetry(void);
 void checkMAVLinkTelemetryState(void);
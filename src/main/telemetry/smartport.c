@@ -275,6 +275,19 @@ smartPortPayload_t *smartPortDataReceive(uint16_t c, bool *clearToSend, smartPor
     return NULL;
 }
 
+static uint8_t *smartPortStuffByte(uint8_t *frame, uint8_t c)
+{
+    // smart port escape sequence
+    if (c == FSSP_DLE || c == FSSP_START_STOP) {
+        *frame++ = FSSP_DLE;
+        *frame++ = c ^ FSSP_DLE_XOR;
+    } else {
+        *frame++ = c;
+    }
+
+    return frame;
+}
+
 void smartPortSendByte(uint8_t c, uint16_t *checksum, serialPort_t *port)
 {
     // smart port escape sequence
@@ -297,12 +310,19 @@ bool smartPortPayloadContainsMSP(const smartPortPayload_t *payload)
 
 void smartPortWriteFrameSerial(const smartPortPayload_t *payload, serialPort_t *port, uint16_t checksum)
 {
-    uint8_t *data = (uint8_t *)payload;
+    // stuff the frame into a local buffer so it goes out in one write, worst case every byte is escaped
+    uint8_t frame[(sizeof(smartPortPayload_t) + 1) * 2];
+    uint8_t *frameEnd = frame;
+
+    const uint8_t *data = (const uint8_t *)payload;
     for (unsigned i = 0; i < sizeof(smartPortPayload_t); i++) {
-        smartPortSendByte(*data++, &checksum, port);
+        frameEnd = smartPortStuffByte(frameEnd, *data);
+        frskyCheckSumStep(&checksum, *data++);
     }
     frskyCheckSumFini(&checksum);
-    smartPortSendByte(checksum, NULL, port);
+    frameEnd = smartPortStuffByte(frameEnd, checksum);
+
+    serialWriteBuf(port, frame, frameEnd - frame);
 }
 
 static void smartPortWriteFrameInternal(const smartPortPayload_t *payload)
@@ -481,7 +501,7 @@ static void freeSmartPortTelemetryPort(void)
 static void configureSmartPortTelemetryPort(void)
 {
     if (portConfig) {
-        portOptions_e portOptions = (telemetryConfig()->halfDuplex ? SERIAL_BIDIR : SERIAL_UNIDIR) | (telemetryConfig()->telemetry_inverted ? SERIAL_NOT_INVERTED : SERIAL_INVERTED);
+        portOptions_e portOptions = (telemetryConfig()->halfDuplex ? SERIAL_BIDIR | SERIAL_BIDIR_NOECHO : SERIAL_UNIDIR) | (telemetryConfig()->telemetry_inverted ? SERIAL_NOT_INVERTED : SERIAL_INVERTED);
 
         smartPortSerialPort = openSerialPort(portConfig->identifier, FUNCTION_TELEMETRY_SMARTPORT, NULL, NULL, SMARTPORT_BAUD, SMARTPORT_UART_MODE, portOptions);
     }
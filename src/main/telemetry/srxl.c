@@ -234,9 +234,9 @@ bool srxlFrameRpm(sbuf_t *dst, timeUs_t currentTimeUs)
     sbufWriteU8(dst, SRXL_FRAMETYPE_SID);
     sbufWriteU16BigEndian(dst, getMotorAveragePeriod());    // pulse leading edges
     if (telemetryConfig()->report_cell_voltage) {
-        sbufWriteU16BigEndian(dst, getBatteryAverageCellVoltage()); // Cell voltage is in units of 0.01V
+        sbufWriteU16BigEndian(dst, telemetryGetSnapshot()->batteryAverageCellVoltage); // Cell voltage is in units of 0.01V
     } else {
-        sbufWriteU16BigEndian(dst, getBatteryVoltage());   // vbat is in units of 0.01V
+        sbufWriteU16BigEndian(dst, telemetryGetSnapshot()->batteryVoltage);   // vbat is in units of 0.01V
     }
     sbufWriteU16BigEndian(dst, coreTemp);                   // temperature
     sbufFill(dst, STRU_TELE_RPM_EMPTY_FIELDS_VALUE, STRU_TELE_RPM_EMPTY_FIELDS_COUNT);
@@ -439,8 +439,9 @@ typedef struct
 
 bool srxlFrameFlightPackCurrent(sbuf_t *dst, timeUs_t currentTimeUs)
 {
-    uint16_t amps = getAmperage() / 10;
-    uint16_t mah  = getMAhDrawn();
+    const telemetrySnapshot_t *snapshot = telemetryGetSnapshot();
+    uint16_t amps = snapshot->amperage / 10;
+    uint16_t mah  = snapshot->mAhDrawn;
     static uint16_t sentAmps;
     static uint16_t sentMah;
     static timeUs_t lastTimeSentFPmAh = 0;
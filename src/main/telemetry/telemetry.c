@@ -47,6 +47,8 @@
 
 #include "rx/rx.h"
 
+#include "sensors/battery.h"
+
 #include "telemetry/telemetry.h"
 #include "telemetry/frsky_hub.h"
 #include "telemetry/hott.h"
@@ -60,7 +62,7 @@
 #include "telemetry/ibus.h"
 #include "telemetry/msp_shared.h"
 
-PG_REGISTER_WITH_RESET_TEMPLATE(telemetryConfig_t, telemetryConfig, PG_TELEMETRY_CONFIG, 4);
+PG_REGISTER_WITH_RESET_TEMPLATE(telemetryConfig_t, telemetryConfig, PG_TELEMETRY_CONFIG, 5);
 
 PG_RESET_TEMPLATE(telemetryConfig_t, telemetryConfig,
     .telemetry_inverted = false,
@@ -80,6 +82,11 @@ PG_RESET_TEMPLATE(telemetryConfig_t, telemetryConfig,
     },
     .disabledSensors = ESC_SENSOR_ALL,
     .mavlink_mah_as_heading_divisor = 0,
+    .mavlink_extended_status_rate = 2,
+    .mavlink_rc_channels_rate = 5,
+    .mavlink_position_rate = 2,
+    .mavlink_extra1_rate = 10,
+    .mavlink_extra2_rate = 10,
 );
 
 void telemetryInit(void)
@@ -199,8 +206,31 @@ void telemetryCheckState(void)
 #endif
 }
 
+static telemetrySnapshot_t telemetrySnapshot;
+static bool telemetrySnapshotValid = false;
+
+// Sampled on first use after each telemetry task run, so protocols running together share the work
+const telemetrySnapshot_t *telemetryGetSnapshot(void)
+{
+    if (!telemetrySnapshotValid) {
+        telemetrySnapshot.batteryVoltage = getBatteryVoltage();
+        telemetrySnapshot.legacyBatteryVoltage = getLegacyBatteryVoltage();
+        telemetrySnapshot.batteryAverageCellVoltage = getBatteryAverageCellVoltage();
+        telemetrySnapshot.amperage = getAmperage();
+        telemetrySnapshot.mAhDrawn = getMAhDrawn();
+        telemetrySnapshot.batteryRemainingPercentage = calculateBatteryPercentageRemaining();
+        telemetrySnapshot.attitude = attitude;
+
+        telemetrySnapshotValid = true;
+    }
+
+    return &telemetrySnapshot;
+}
+
 void telemetryProcess(uint32_t currentTime)
 {
+    telemetrySnapshotValid = false;
+
 #ifdef USE_TELEMETRY_FRSKY_HUB
     handleFrSkyHubTelemetry(currentTime);
 #else
@@ -29,6 +29,8 @@
 
 #include "common/unit.h"
 
+#include "flight/imu.h"
+
 #include "io/serial.h"
 
 #include "pg/pg.h"
@@ -83,11 +85,27 @@ typedef struct telemetryConfig_s {
     uint8_t report_cell_voltage;
     uint8_t flysky_sensors[IBUS_SENSOR_COUNT];
     uint16_t mavlink_mah_as_heading_divisor;
+    uint8_t mavlink_extended_status_rate;
+    uint8_t mavlink_rc_channels_rate;
+    uint8_t mavlink_position_rate;
+    uint8_t mavlink_extra1_rate;
+    uint8_t mavlink_extra2_rate;
     uint32_t disabledSensors; // bit flags
 } telemetryConfig_t;
 
 PG_DECLARE(telemetryConfig_t, telemetryConfig);
 
+// Values shared by the telemetry protocols, sampled once per telemetry task run
+typedef struct telemetrySnapshot_s {
+    uint16_t batteryVoltage;            // 0.01V
+    uint16_t legacyBatteryVoltage;      // 0.1V
+    uint16_t batteryAverageCellVoltage; // 0.01V
+    int32_t amperage;                   // 0.01A
+    int32_t mAhDrawn;
+    uint8_t batteryRemainingPercentage;
+    attitudeEulerAngles_t attitude;     // decidegrees
+} telemetrySnapshot_t;
+
 extern serialPort_t *telemetrySharedPort;
 
 void telemetryInit(void);
@@ -99,3 +117,5 @@ void telemetryProcess(uint32_t currentTime);
 bool telemetryDetermineEnabledState(portSharing_e portSharing);
 
 bool telemetryIsSensorEnabled(sensor_e sensor);
+
+const telemetrySnapshot_t *telemetryGetSnapshot(void);
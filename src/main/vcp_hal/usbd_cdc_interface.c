@@ -67,7 +67,8 @@
 #define APP_RX_DATA_SIZE  2048
 #define APP_TX_DATA_SIZE  2048
 
-#define APP_TX_BLOCK_SIZE 512
+// A whole contiguous part of the ring buffer can go as one multi-packet transfer
+#define APP_TX_BLOCK_SIZE APP_TX_DATA_SIZE
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
@@ -82,7 +82,7 @@
 #define USBD_SUPPORT_USER_STRING              0
 #define USBD_SELF_POWERED                     1
 #define USBD_DEBUG_LEVEL                      0
-#define MSC_MEDIA_PACKET                      512U
+#define MSC_MEDIA_PACKET                      4096U // Lets a multi-sector SCSI read reach the storage backend in one call
 #define USE_USB_FS
 
 /* Exported macro ------------------------------------------------------------*/
@@ -0,0 +1,76 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Minimal host benchmark harness with the shape of Google Benchmark, which is not part of lib/.
+//
+//     BENCH(pt1FilterApply)
+//     {
+//         pt1Filter_t filter;
+//         pt1FilterInit(&filter, 0.1f);
+//         while (state.keepRunning()) {
+//             benchDoNotOptimize(pt1FilterApply(&filter, 1.0f));
+//         }
+//     }
+//
+// Every benchmark is run with a doubling iteration count until it takes at least the minimum time,
+// the results are printed and written as Google Benchmark JSON with --benchmark_out=<file> so that
+// its compare tools can be used on them. The numbers are host numbers, they show relative changes
+// but not the cycle counts on a flight controller.
+
+class BenchState {
+public:
+    explicit BenchState(uint64_t iterations) : remaining(iterations) {}
+
+    bool keepRunning()
+    {
+        return remaining-- > 0;
+    }
+
+private:
+    uint64_t remaining;
+};
+
+typedef void (*benchFn_t)(BenchState &state);
+
+struct BenchRegistration {
+    BenchRegistration(const char *name, benchFn_t fn);
+};
+
+#define BENCH(name) \
+    static void bench_##name(BenchState &state); \
+    static BenchRegistration benchRegistration_##name(#name, bench_##name); \
+    static void bench_##name(BenchState &state)
+
+// Keeps the compiler from dropping the computation of value
+template <typename T>
+inline void benchDoNotOptimize(T const &value)
+{
+    __asm__ volatile("" : : "r,m"(value) : "memory");
+}
+
+// Makes pending stores visible to the compiler, e.g. before reading a filter state back
+inline void benchClobberMemory(void)
+{
+    __asm__ volatile("" : : : "memory");
+}
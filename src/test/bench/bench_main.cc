@@ -0,0 +1,168 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+// Options, named like the Google Benchmark ones
+//   --benchmark_filter=<text>      only run the benchmarks with text in their name
+//   --benchmark_min_time=<seconds> minimum run time of each benchmark, 0.2 by default
+//   --benchmark_out=<file>         write the results as JSON to file
+
+#define BENCH_MAX_COUNT 64
+#define BENCH_MAX_ITERATIONS (1ULL << 40)
+
+typedef struct benchEntry_s {
+    const char *name;
+    benchFn_t fn;
+} benchEntry_t;
+
+typedef struct benchResult_s {
+    const char *name;
+    uint64_t iterations;
+    double realNs;
+    double cpuNs;
+} benchResult_t;
+
+static benchEntry_t benchEntries[BENCH_MAX_COUNT];
+static int benchCount;
+
+BenchRegistration::BenchRegistration(const char *name, benchFn_t fn)
+{
+    if (benchCount == BENCH_MAX_COUNT) {
+        fprintf(stderr, "too many benchmarks, raise BENCH_MAX_COUNT\n");
+        exit(1);
+    }
+    benchEntries[benchCount].name = name;
+    benchEntries[benchCount].fn = fn;
+    benchCount++;
+}
+
+static double clockSeconds(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static benchResult_t benchRun(const benchEntry_t *entry, double minTime)
+{
+    benchResult_t result = { entry->name, 0, 0, 0 };
+
+    for (uint64_t iterations = 1; iterations <= BENCH_MAX_ITERATIONS; iterations *= 2) {
+        BenchState state(iterations);
+        const double realStart = clockSeconds(CLOCK_MONOTONIC);
+        const double cpuStart = clockSeconds(CLOCK_PROCESS_CPUTIME_ID);
+        entry->fn(state);
+        const double real = clockSeconds(CLOCK_MONOTONIC) - realStart;
+        const double cpu = clockSeconds(CLOCK_PROCESS_CPUTIME_ID) - cpuStart;
+
+        result.iterations = iterations;
+        result.realNs = real * 1e9 / iterations;
+        result.cpuNs = cpu * 1e9 / iterations;
+        if (real >= minTime) {
+            break;
+        }
+    }
+
+    return result;
+}
+
+static void benchWriteJson(const char *filename, const char *executable, const benchResult_t *results, int count)
+{
+    FILE *file = fopen(filename, "w");
+    if (!file) {
+        fprintf(stderr, "unable to write %s\n", filename);
+        exit(1);
+    }
+
+    char date[32];
+    const time_t now = time(NULL);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"context\": {\n");
+    fprintf(file, "    \"date\": \"%s\",\n", date);
+    fprintf(file, "    \"executable\": \"%s\",\n", executable);
+    fprintf(file, "    \"num_cpus\": %ld,\n", sysconf(_SC_NPROCESSORS_ONLN));
+    fprintf(file, "    \"library_build_type\": \"release\"\n");
+    fprintf(file, "  },\n");
+    fprintf(file, "  \"benchmarks\": [\n");
+    for (int i = 0; i < count; i++) {
+        fprintf(file, "    {\n");
+        fprintf(file, "      \"name\": \"%s\",\n", results[i].name);
+        fprintf(file, "      \"run_name\": \"%s\",\n", results[i].name);
+        fprintf(file, "      \"run_type\": \"iteration\",\n");
+        fprintf(file, "      \"iterations\": %llu,\n", (unsigned long long)results[i].iterations);
+        fprintf(file, "      \"real_time\": %.4f,\n", results[i].realNs);
+        fprintf(file, "      \"cpu_time\": %.4f,\n", results[i].cpuNs);
+        fprintf(file, "      \"time_unit\": \"ns\"\n");
+        fprintf(file, "    }%s\n", i + 1 < count ? "," : "");
+    }
+    fprintf(file, "  ]\n");
+    fprintf(file, "}\n");
+
+    fclose(file);
+}
+
+int main(int argc, char **argv)
+{
+    const char *filter = NULL;
+    const char *out = NULL;
+    double minTime = 0.2;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strncmp(argv[i], "--benchmark_filter=", 19)) {
+            filter = argv[i] + 19;
+        } else if (!strncmp(argv[i], "--benchmark_min_time=", 21)) {
+            minTime = atof(argv[i] + 21);
+        } else if (!strncmp(argv[i], "--benchmark_out=", 16)) {
+            out = argv[i] + 16;
+        } else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    static benchResult_t results[BENCH_MAX_COUNT];
+    int resultCount = 0;
+
+    printf("%-40s %14s %14s %14s\n", "Benchmark", "Time", "CPU", "Iterations");
+    for (int i = 0; i < benchCount; i++) {
+        if (filter && !strstr(benchEntries[i].name, filter)) {
+            continue;
+        }
+        const benchResult_t result = benchRun(&benchEntries[i], minTime);
+        printf("%-40s %11.2f ns %11.2f ns %14llu\n", result.name, result.realNs, result.cpuNs, (unsigned long long)result.iterations);
+        results[resultCount++] = result;
+    }
+
+    if (out) {
+        benchWriteJson(out, argv[0], results, resultCount);
+    }
+
+    return 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "blackbox/blackbox_encoding.h"
+    #include "blackbox/blackbox_io.h"
+}
+
+#include "bench.h"
+
+#define SAMPLE_COUNT 256 // power of 2
+
+// small deltas as in a blackbox P frame, with the occasional large one
+static int32_t deltas[SAMPLE_COUNT][8];
+
+static void initDeltas(void)
+{
+    uint32_t seed = 1;
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        for (int j = 0; j < 8; j++) {
+            seed = seed * 1103515245 + 12345;
+            const int32_t value = (seed >> 16) & 0xff;
+            deltas[i][j] = (i % 16 == 0) ? value * 97 : value - 128;
+        }
+    }
+}
+
+BENCH(blackboxWriteSignedVBArray_8)
+{
+    initDeltas();
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        blackboxWriteSignedVBArray(deltas[i++ & (SAMPLE_COUNT - 1)], 8);
+    }
+}
+
+BENCH(blackboxWriteTag8_8SVB)
+{
+    initDeltas();
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        blackboxWriteTag8_8SVB(deltas[i++ & (SAMPLE_COUNT - 1)], 8);
+    }
+}
+
+BENCH(blackboxWriteTag2_3S32)
+{
+    initDeltas();
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        blackboxWriteTag2_3S32(deltas[i++ & (SAMPLE_COUNT - 1)]);
+    }
+}
+
+BENCH(blackboxWriteTag8_4S16)
+{
+    initDeltas();
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        blackboxWriteTag8_4S16(deltas[i++ & (SAMPLE_COUNT - 1)]);
+    }
+}
+
+// STUBS
+
+extern "C" {
+
+int32_t blackboxHeaderBudget;
+static uint8_t blackboxSink;
+
+void blackboxWrite(uint8_t value)
+{
+    blackboxSink += value;
+    benchClobberMemory();
+}
+
+int blackboxWriteString(const char *s)
+{
+    int length = 0;
+    while (s[length]) {
+        blackboxWrite(s[length++]);
+    }
+    return length;
+}
+
+}
@@ -0,0 +1,69 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+
+extern "C" {
+    #include "common/crc.h"
+}
+
+#include "bench.h"
+
+// the size of a large MSP reply
+#define FRAME_SIZE 64
+
+static uint8_t frame[FRAME_SIZE];
+
+static void initFrame(void)
+{
+    for (int i = 0; i < FRAME_SIZE; i++) {
+        frame[i] = i * 73 + 11;
+    }
+}
+
+BENCH(crc8_dvb_s2_update_64)
+{
+    initFrame();
+    uint8_t crc = 0;
+    while (state.keepRunning()) {
+        crc = crc8_dvb_s2_update(crc, frame, FRAME_SIZE);
+        benchDoNotOptimize(crc);
+    }
+}
+
+BENCH(crc16_ccitt_update_64)
+{
+    initFrame();
+    uint16_t crc = 0;
+    while (state.keepRunning()) {
+        crc = crc16_ccitt_update(crc, frame, FRAME_SIZE);
+        benchDoNotOptimize(crc);
+    }
+}
+
+BENCH(crc8_xor_update_64)
+{
+    initFrame();
+    uint8_t crc = 0;
+    while (state.keepRunning()) {
+        crc = crc8_xor_update(crc, frame, FRAME_SIZE);
+        benchDoNotOptimize(crc);
+    }
+}
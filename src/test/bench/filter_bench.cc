@@ -0,0 +1,233 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <math.h>
+
+extern "C" {
+    #include "common/axis.h"
+    #include "common/filter.h"
+    #include "common/maths.h"
+}
+
+#include "bench.h"
+
+#define SAMPLE_COUNT 1024 // power of 2
+#define LOOPTIME_US 125
+
+// gyro like input, a few vibration tones on top of stick movement
+static float samples[SAMPLE_COUNT][XYZ_AXIS_COUNT];
+
+static void initSamples(void)
+{
+    static bool initialised;
+    if (initialised) {
+        return;
+    }
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            const float t = i * LOOPTIME_US * 1e-6f;
+            samples[i][axis] = 200.0f * sinf(2 * M_PIf * 3 * t + axis)
+                + 20.0f * sinf(2 * M_PIf * 180 * t) + 5.0f * sinf(2 * M_PIf * (350 + 40 * axis) * t);
+        }
+    }
+    initialised = true;
+}
+
+// one call per axis, as the gyro and D term loops did before the vector filters
+BENCH(pt1FilterApply_3axes)
+{
+    initSamples();
+    pt1Filter_t filter[XYZ_AXIS_COUNT];
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        pt1FilterInit(&filter[axis], pt1FilterGain(100, LOOPTIME_US * 1e-6f));
+    }
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        const float *v = samples[i++ & (SAMPLE_COUNT - 1)];
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            benchDoNotOptimize(pt1FilterApply(&filter[axis], v[axis]));
+        }
+    }
+}
+
+BENCH(pt1Filter3Apply)
+{
+    initSamples();
+    pt1Filter3_t filter;
+    pt1Filter3Init(&filter, pt1FilterGain(100, LOOPTIME_US * 1e-6f));
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        const float *v = samples[i++ & (SAMPLE_COUNT - 1)];
+        float values[XYZ_AXIS_COUNT] = { v[X], v[Y], v[Z] };
+        pt1Filter3Apply(&filter, values);
+        benchDoNotOptimize(values);
+    }
+}
+
+BENCH(biquadFilterApplyDF1_3axes)
+{
+    initSamples();
+    biquadFilter_t filter[XYZ_AXIS_COUNT];
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        biquadFilterInitLPF(&filter[axis], 100, LOOPTIME_US);
+    }
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        const float *v = samples[i++ & (SAMPLE_COUNT - 1)];
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            benchDoNotOptimize(biquadFilterApplyDF1(&filter[axis], v[axis]));
+        }
+    }
+}
+
+BENCH(biquadFilterApply_3axes)
+{
+    initSamples();
+    biquadFilter_t filter[XYZ_AXIS_COUNT];
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        biquadFilterInitLPF(&filter[axis], 100, LOOPTIME_US);
+    }
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        const float *v = samples[i++ & (SAMPLE_COUNT - 1)];
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            benchDoNotOptimize(biquadFilterApply(&filter[axis], v[axis]));
+        }
+    }
+}
+
+BENCH(biquadFilter3ApplyDF1)
+{
+    initSamples();
+    biquadFilter3_t filter;
+    biquadFilter3InitLPF(&filter, 100, LOOPTIME_US);
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        const float *v = samples[i++ & (SAMPLE_COUNT - 1)];
+        float values[XYZ_AXIS_COUNT] = { v[X], v[Y], v[Z] };
+        biquadFilter3ApplyDF1(&filter, values);
+        benchDoNotOptimize(values);
+    }
+}
+
+// D term lowpass 1 and 2 as a PT1 and a biquad
+BENCH(filterCascade3Apply_pt1_biquad)
+{
+    initSamples();
+    filterCascade3_t filter;
+    filterCascade3Init(&filter);
+    filterCascade3AddPt1(&filter, pt1FilterGain(100, LOOPTIME_US * 1e-6f));
+    filterCascade3AddBiquadLPF(&filter, 150, LOOPTIME_US);
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        const float *v = samples[i++ & (SAMPLE_COUNT - 1)];
+        float values[XYZ_AXIS_COUNT] = { v[X], v[Y], v[Z] };
+        filterCascade3Apply(&filter, values);
+        benchDoNotOptimize(values);
+    }
+}
+
+BENCH(biquadFilterUpdate_notch)
+{
+    biquadFilter_t filter;
+    biquadFilterInit(&filter, 200, LOOPTIME_US, 3.0f, FILTER_NOTCH);
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        biquadFilterUpdate(&filter, 150.0f + (i++ & 255), LOOPTIME_US, 3.0f, FILTER_NOTCH);
+        benchDoNotOptimize(filter);
+    }
+}
+
+// a notch sweeping over more frequencies than the cache holds, every update is a miss
+BENCH(biquadNotchCoefficients_miss)
+{
+    biquadNotchCache_t cache;
+    biquadNotchCacheInit(&cache, LOOPTIME_US, 3.0f);
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        const float frequency = 150.0f + (i++ & 255);
+        biquadNotchCoeffs_t coeffs;
+        biquadNotchCoefficients(&cache, &frequency, &coeffs, 1);
+        benchDoNotOptimize(coeffs);
+    }
+}
+
+BENCH(biquadNotchCoefficients_hit)
+{
+    biquadNotchCache_t cache;
+    biquadNotchCacheInit(&cache, LOOPTIME_US, 3.0f);
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        const float frequency = 150.0f + (i++ & 15);
+        biquadNotchCoeffs_t coeffs;
+        biquadNotchCoefficients(&cache, &frequency, &coeffs, 1);
+        benchDoNotOptimize(coeffs);
+    }
+}
+
+BENCH(slewFilterApply)
+{
+    initSamples();
+    slewFilter_t filter;
+    slewFilterInit(&filter, 50.0f, 100.0f);
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        benchDoNotOptimize(slewFilterApply(&filter, samples[i++ & (SAMPLE_COUNT - 1)][X]));
+    }
+}
+
+BENCH(quickMedianFilter3)
+{
+    initSamples();
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        const float *v = samples[i++ & (SAMPLE_COUNT - 1)];
+        int32_t values[3] = { (int32_t)v[X], (int32_t)v[Y], (int32_t)v[Z] };
+        benchDoNotOptimize(quickMedianFilter3(values));
+    }
+}
+
+BENCH(quickMedianFilter5f)
+{
+    initSamples();
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        const unsigned n = i++;
+        float values[5];
+        for (int j = 0; j < 5; j++) {
+            values[j] = samples[(n + j * 37) & (SAMPLE_COUNT - 1)][X];
+        }
+        benchDoNotOptimize(quickMedianFilter5f(values));
+    }
+}
+
+BENCH(sin_cos_approx)
+{
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        float sn, cs;
+        sin_cos_approx((i++ & 1023) * (M_PIf / 1024), &sn, &cs);
+        benchDoNotOptimize(sn);
+        benchDoNotOptimize(cs);
+    }
+}
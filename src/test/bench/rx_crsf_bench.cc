@@ -0,0 +1,101 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include <platform.h>
+
+    #include "build/debug.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+    #include "pg/rx.h"
+
+    #include "common/crc.h"
+
+    #include "drivers/serial.h"
+    #include "io/serial.h"
+
+    #include "rx/rx.h"
+    #include "rx/crsf.h"
+
+    #include "scheduler/scheduler.h"
+
+    rssiSource_e rssiSource;
+
+    void crsfDataReceive(uint16_t c, void *data);
+    uint8_t crsfFrameStatus(rxRuntimeState_t *rxRuntimeState);
+
+    PG_REGISTER(rxConfig_t, rxConfig, PG_RX_CONFIG, 0);
+}
+
+#include "bench.h"
+
+// RC channels frame of 16 11 bit channels
+static uint8_t rcFrame[CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + 4];
+static uint32_t benchTimeUs;
+
+static void initRcFrame(void)
+{
+    rcFrame[0] = CRSF_ADDRESS_FLIGHT_CONTROLLER;
+    rcFrame[1] = CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC;
+    rcFrame[2] = CRSF_FRAMETYPE_RC_CHANNELS_PACKED;
+    for (int i = 0; i < CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE; i++) {
+        rcFrame[3 + i] = i * 37 + 5;
+    }
+    rcFrame[sizeof(rcFrame) - 1] = crc8_dvb_s2_update(0, &rcFrame[2], CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + 1);
+}
+
+// receive the bytes of one frame as the serial interrupt would and unpack the channels
+BENCH(crsfRcFrame)
+{
+    initRcFrame();
+    rxRuntimeState_t rxRuntimeState;
+    while (state.keepRunning()) {
+        // far enough apart for every frame to be seen as a new one
+        benchTimeUs += 10000;
+        for (unsigned i = 0; i < sizeof(rcFrame); i++) {
+            crsfDataReceive(rcFrame[i], NULL);
+        }
+        benchDoNotOptimize(crsfFrameStatus(&rxRuntimeState));
+    }
+}
+
+// STUBS
+
+extern "C" {
+
+int32_t debug[DEBUG_VALUE_STORAGE_COUNT];
+uint32_t micros(void) { return benchTimeUs; }
+uint32_t microsISR(void) { return micros(); }
+void schedulerSetFollowUpTask(taskId_e) {}
+serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) { return NULL; }
+const serialPortConfig_t *findSerialPortConfig(serialPortFunction_e) { return NULL; }
+bool telemetryCheckRxPortShared(const serialPortConfig_t *) { return false; }
+serialPort_t *telemetrySharedPort = NULL;
+void crsfScheduleDeviceInfoResponse(void) {}
+void crsfScheduleMspResponse(void) {}
+bool bufferMspFrame(uint8_t *, int) { return true; }
+bool isBatteryVoltageAvailable(void) { return true; }
+bool isAmperageAvailable(void) { return true; }
+
+}
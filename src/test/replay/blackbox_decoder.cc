@@ -0,0 +1,553 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "blackbox/blackbox.h"
+    #include "blackbox/blackbox_fielddefs.h"
+}
+
+#include "blackbox_decoder.h"
+
+static const char logStartMarker[] = "H Product:Blackbox flight data recorder by Nicholas Sherlock\n";
+static const char frameTypes[] = "IPSGHE";
+
+static bool isFrameType(uint8_t c)
+{
+    return c && strchr(frameTypes, c);
+}
+
+#define ENCODED_GROUP_MAX 8
+
+static int32_t signExtend(uint32_t value, int bits)
+{
+    const uint32_t signBit = 1u << (bits - 1);
+    return (int32_t)((value ^ signBit) - signBit);
+}
+
+namespace {
+
+// Bounds checked reads of the blackboxWrite*() encodings in blackbox_encoding.c
+class Reader {
+public:
+    Reader(const uint8_t *&pos, const uint8_t *end, bool &eof) : pos(pos), end(end), eof(eof) {}
+
+    uint8_t byte()
+    {
+        if (pos >= end) {
+            eof = true;
+            return 0;
+        }
+        return *pos++;
+    }
+
+    uint32_t unsignedVB()
+    {
+        uint32_t value = 0;
+        // at most 5 bytes for 32 bits
+        for (int shift = 0; shift < 35; shift += 7) {
+            const uint8_t b = byte();
+            value |= (uint32_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) {
+                return value;
+            }
+        }
+        eof = true;
+        return 0;
+    }
+
+    int32_t signedVB()
+    {
+        const uint32_t value = unsignedVB();
+        return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+    }
+
+    int32_t bytesLE(int count)
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < count; i++) {
+            value |= (uint32_t)byte() << (8 * i);
+        }
+        return signExtend(value, 8 * count);
+    }
+
+    // blackboxWriteTag2_3S32() and the 32 bit case of blackboxWriteTag2_3SVariable()
+    void tag2_3S32(int32_t *values)
+    {
+        const uint8_t lead = byte();
+        switch (lead >> 6) {
+        case 0:
+            values[0] = signExtend((lead >> 4) & 0x03, 2);
+            values[1] = signExtend((lead >> 2) & 0x03, 2);
+            values[2] = signExtend(lead & 0x03, 2);
+            break;
+        case 1: {
+            values[0] = signExtend(lead & 0x0F, 4);
+            const uint8_t b = byte();
+            values[1] = signExtend(b >> 4, 4);
+            values[2] = signExtend(b & 0x0F, 4);
+            break;
+        }
+        case 2:
+            values[0] = signExtend(lead & 0x3F, 6);
+            values[1] = signExtend(byte() & 0x3F, 6);
+            values[2] = signExtend(byte() & 0x3F, 6);
+            break;
+        default:
+            tag2Bytes(lead, values);
+            break;
+        }
+    }
+
+    void tag2_3SVariable(int32_t *values)
+    {
+        const uint8_t lead = byte();
+        switch (lead >> 6) {
+        case 0:
+            values[0] = signExtend((lead >> 4) & 0x03, 2);
+            values[1] = signExtend((lead >> 2) & 0x03, 2);
+            values[2] = signExtend(lead & 0x03, 2);
+            break;
+        case 1: {
+            // 554 bits per field  ss11 1112 2222 3333
+            const uint8_t b = byte();
+            values[0] = signExtend((lead >> 1) & 0x1F, 5);
+            values[1] = signExtend(((lead & 0x01) << 4) | (b >> 4), 5);
+            values[2] = signExtend(b & 0x0F, 4);
+            break;
+        }
+        case 2: {
+            // 877 bits per field  ss11 1111 1122 2222 2333 3333
+            const uint8_t b1 = byte();
+            const uint8_t b2 = byte();
+            values[0] = signExtend(((lead & 0x3F) << 2) | (b1 >> 6), 8);
+            values[1] = signExtend(((b1 & 0x3F) << 1) | (b2 >> 7), 7);
+            values[2] = signExtend(b2 & 0x7F, 7);
+            break;
+        }
+        default:
+            tag2Bytes(lead, values);
+            break;
+        }
+    }
+
+    // blackboxWriteTag8_4S16(), data version 2
+    void tag8_4S16(int32_t *values)
+    {
+        uint8_t selector = byte();
+        bool nibble = false;
+        uint8_t buffer = 0;
+
+        for (int i = 0; i < 4; i++, selector >>= 2) {
+            switch (selector & 0x03) {
+            case 0:
+                values[i] = 0;
+                break;
+            case 1:
+                if (!nibble) {
+                    buffer = byte();
+                    values[i] = signExtend(buffer >> 4, 4);
+                } else {
+                    values[i] = signExtend(buffer & 0x0F, 4);
+                }
+                nibble = !nibble;
+                break;
+            case 2:
+                if (!nibble) {
+                    values[i] = signExtend(byte(), 8);
+                } else {
+                    const uint8_t high = buffer << 4;
+                    buffer = byte();
+                    values[i] = signExtend(high | (buffer >> 4), 8);
+                }
+                break;
+            default:
+                if (!nibble) {
+                    const uint8_t high = byte();
+                    values[i] = signExtend((high << 8) | byte(), 16);
+                } else {
+                    const uint8_t middle = byte();
+                    const uint32_t high = (buffer & 0x0F) << 12;
+                    buffer = byte();
+                    values[i] = signExtend(high | (middle << 4) | (buffer >> 4), 16);
+                }
+                break;
+            }
+        }
+    }
+
+    // blackboxWriteTag8_8SVB(), a single value is written without the header byte
+    void tag8_8SVB(int32_t *values, int count)
+    {
+        if (count == 1) {
+            values[0] = signedVB();
+            return;
+        }
+
+        uint8_t header = byte();
+        for (int i = 0; i < count; i++, header >>= 1) {
+            values[i] = (header & 0x01) ? signedVB() : 0;
+        }
+    }
+
+private:
+    void tag2Bytes(uint8_t selector, int32_t *values)
+    {
+        for (int i = 0; i < 3; i++, selector >>= 2) {
+            values[i] = bytesLE((selector & 0x03) + 1);
+        }
+    }
+
+    const uint8_t *&pos;
+    const uint8_t *end;
+    bool &eof;
+};
+
+std::vector<std::string> splitList(const std::string &text)
+{
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= text.size()) {
+        const size_t comma = text.find(',', start);
+        const size_t stop = comma == std::string::npos ? text.size() : comma;
+        items.push_back(text.substr(start, stop - start));
+        start = stop + 1;
+    }
+    return items;
+}
+
+std::vector<int> toInts(const std::vector<std::string> &items)
+{
+    std::vector<int> values;
+    for (const std::string &item : items) {
+        values.push_back(strtol(item.c_str(), nullptr, 0));
+    }
+    return values;
+}
+
+}
+
+std::vector<size_t> blackboxLogFind(const uint8_t *data, size_t size)
+{
+    std::vector<size_t> offsets;
+    const size_t markerLength = strlen(logStartMarker);
+
+    for (size_t i = 0; i + markerLength <= size; i++) {
+        if (data[i] == 'H' && !memcmp(data + i, logStartMarker, markerLength)) {
+            offsets.push_back(i);
+            i += markerLength - 1;
+        }
+    }
+
+    return offsets;
+}
+
+bool BlackboxLog::hasHeader(const char *name) const
+{
+    return headers.count(name) != 0;
+}
+
+std::string BlackboxLog::header(const char *name) const
+{
+    const auto it = headers.find(name);
+    return it == headers.end() ? std::string() : it->second;
+}
+
+std::vector<int> BlackboxLog::headerInts(const char *name) const
+{
+    return hasHeader(name) ? toInts(splitList(header(name))) : std::vector<int>();
+}
+
+int BlackboxLog::headerInt(const char *name, int fallback) const
+{
+    const std::vector<int> values = headerInts(name);
+    return values.empty() ? fallback : values[0];
+}
+
+int BlackboxLog::fieldIndex(const char *name) const
+{
+    for (size_t i = 0; i < mainFieldNames.size(); i++) {
+        if (mainFieldNames[i] == name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// "H Field I name:a,b,c" defines the fields of a frame type, every other header is kept as a string
+bool BlackboxLog::parseHeaderLine(const std::string &line)
+{
+    const size_t colon = line.find(':');
+    if (line.compare(0, 2, "H ") || colon == std::string::npos) {
+        return false;
+    }
+
+    const std::string name = line.substr(2, colon - 2);
+    const std::string value = line.substr(colon + 1);
+
+    if (name.compare(0, 6, "Field ") || name.size() < 9) {
+        headers[name] = value;
+        return true;
+    }
+
+    const char type = name[6];
+    const std::string property = name.substr(8);
+    // the P frames share the field names and signs of the I frames
+    frameDef_t &def = frameDefs[type == 'P' ? 'I' : type];
+
+    if (property == "name") {
+        def.names = splitList(value);
+    } else if (property == "signed") {
+        def.isSigned = toInts(splitList(value));
+    } else if (property == "predictor") {
+        (type == 'P' ? def.deltaPredictor : def.predictor) = toInts(splitList(value));
+    } else if (property == "encoding") {
+        (type == 'P' ? def.deltaEncoding : def.encoding) = toInts(splitList(value));
+    }
+
+    return true;
+}
+
+bool BlackboxLog::decodeFields(const frameDef_t &def, bool delta, std::vector<int64_t> &values)
+{
+    const std::vector<int> &predictors = delta ? def.deltaPredictor : def.predictor;
+    const std::vector<int> &encodings = delta ? def.deltaEncoding : def.encoding;
+    const size_t count = def.names.size();
+    if (predictors.size() != count || encodings.size() != count) {
+        return false;
+    }
+
+    Reader reader(pos, end, eof);
+    const bool mainFrame = &def == &frameDefs['I'];
+    const bool history = mainFrame && historyValid;
+
+    values.assign(count, 0);
+    for (size_t i = 0; i < count; ) {
+        int32_t raw[ENCODED_GROUP_MAX];
+        size_t group = 1;
+
+        switch (encodings[i]) {
+        case FLIGHT_LOG_FIELD_ENCODING_SIGNED_VB:
+            raw[0] = reader.signedVB();
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_UNSIGNED_VB:
+            raw[0] = reader.unsignedVB();
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_NEG_14BIT:
+            raw[0] = -signExtend(reader.unsignedVB() & 0x3FFF, 14);
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_NULL:
+            raw[0] = 0;
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_TAG8_4S16:
+            group = 4;
+            reader.tag8_4S16(raw);
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_TAG2_3S32:
+            group = 3;
+            reader.tag2_3S32(raw);
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_TAG2_3SVARIABLE:
+            group = 3;
+            reader.tag2_3SVariable(raw);
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_TAG8_8SVB:
+            // all the consecutive fields with this encoding, up to 8
+            while (group < ENCODED_GROUP_MAX && i + group < count && encodings[i + group] == FLIGHT_LOG_FIELD_ENCODING_TAG8_8SVB) {
+                group++;
+            }
+            reader.tag8_8SVB(raw, group);
+            break;
+        default:
+            return false;
+        }
+
+        for (size_t j = 0; j < group && i < count; j++, i++) {
+            int64_t prediction = 0;
+
+            switch (predictors[i]) {
+            case FLIGHT_LOG_FIELD_PREDICTOR_PREVIOUS:
+                prediction = history ? previous[i] : 0;
+                break;
+            case FLIGHT_LOG_FIELD_PREDICTOR_STRAIGHT_LINE:
+                prediction = history ? 2 * previous[i] - previous2[i] : 0;
+                break;
+            case FLIGHT_LOG_FIELD_PREDICTOR_AVERAGE_2:
+                prediction = history ? (previous[i] + previous2[i]) / 2 : 0;
+                break;
+            case FLIGHT_LOG_FIELD_PREDICTOR_MINTHROTTLE:
+                prediction = headerInt("minthrottle", 0);
+                break;
+            case FLIGHT_LOG_FIELD_PREDICTOR_MOTOR_0: {
+                const int motor0 = fieldIndex("motor[0]");
+                prediction = motor0 >= 0 && (size_t)motor0 < i ? values[motor0] : 0;
+                break;
+            }
+            case FLIGHT_LOG_FIELD_PREDICTOR_INC:
+                // loopIteration advances by the P interval between P frames
+                prediction = (history ? previous[i] : 0) + headerInt("P interval", 1);
+                break;
+            case FLIGHT_LOG_FIELD_PREDICTOR_1500:
+                prediction = 1500;
+                break;
+            case FLIGHT_LOG_FIELD_PREDICTOR_VBATREF:
+                prediction = headerInt("vbatref", 0);
+                break;
+            case FLIGHT_LOG_FIELD_PREDICTOR_LAST_MAIN_FRAME_TIME:
+                prediction = lastMainFrameTime;
+                break;
+            case FLIGHT_LOG_FIELD_PREDICTOR_MINMOTOR:
+                prediction = headerInt("motorOutput", 0);
+                break;
+            default:
+                break;
+            }
+
+            int64_t value = prediction + raw[j];
+            const bool isSigned = i < def.isSigned.size() && def.isSigned[i];
+            value = isSigned ? (int64_t)(int32_t)value : (int64_t)(uint32_t)value;
+            values[i] = value;
+        }
+    }
+
+    return !eof;
+}
+
+bool BlackboxLog::decodeFrame(char type)
+{
+    Reader reader(pos, end, eof);
+    std::vector<int64_t> values;
+
+    switch (type) {
+    case 'I':
+    case 'P': {
+        if (!decodeFields(frameDefs['I'], type == 'P', values)) {
+            return false;
+        }
+        if (type == 'P' && !historyValid) {
+            // the frame decoded but its predictions are meaningless, wait for the next I frame
+            return true;
+        }
+
+        previous2 = type == 'I' ? values : previous;
+        previous = values;
+        historyValid = true;
+
+        const int time = fieldIndex("time");
+        if (time >= 0) {
+            lastMainFrameTime = values[time];
+        }
+
+        frames.push_back({ type, values });
+        return true;
+    }
+    case 'S':
+    case 'G':
+    case 'H':
+        return frameDefs.count(type) && decodeFields(frameDefs[type], false, values);
+    case 'E': {
+        switch (reader.byte()) {
+        case FLIGHT_LOG_EVENT_SYNC_BEEP:
+        case FLIGHT_LOG_EVENT_DISARM:
+            reader.unsignedVB();
+            break;
+        case FLIGHT_LOG_EVENT_FLIGHTMODE:
+        case FLIGHT_LOG_EVENT_LOGGING_RESUME:
+            reader.unsignedVB();
+            reader.unsignedVB();
+            break;
+        case FLIGHT_LOG_EVENT_INFLIGHT_ADJUSTMENT:
+            if (reader.byte() & FLIGHT_LOG_EVENT_INFLIGHT_ADJUSTMENT_FUNCTION_FLOAT_VALUE_FLAG) {
+                reader.bytesLE(4);
+            } else {
+                reader.signedVB();
+            }
+            break;
+        case FLIGHT_LOG_EVENT_LOG_END: {
+            static const char endMessage[] = "End of log";
+            if ((size_t)(end - pos) < sizeof(endMessage) || memcmp(pos, endMessage, sizeof(endMessage))) {
+                return false;
+            }
+            pos += sizeof(endMessage);
+            logEnded = true;
+            break;
+        }
+        default:
+            return false;
+        }
+        return !eof;
+    }
+    default:
+        return false;
+    }
+}
+
+bool BlackboxLog::parse(const uint8_t *data, size_t size)
+{
+    pos = data;
+    end = data + size;
+    eof = false;
+
+    // the headers are text lines up to the first frame
+    while (pos < end && *pos == 'H') {
+        const uint8_t *lineEnd = (const uint8_t *)memchr(pos, '\n', end - pos);
+        if (!lineEnd) {
+            return false;
+        }
+        parseHeaderLine(std::string((const char *)pos, lineEnd - pos));
+        pos = lineEnd + 1;
+    }
+
+    if (!frameDefs.count('I')) {
+        return false;
+    }
+    mainFieldNames = frameDefs['I'].names;
+
+    const std::vector<size_t> logs = blackboxLogFind(data + 1, size - 1);
+    if (!logs.empty()) {
+        // stop at the start of the next log in the file
+        end = data + 1 + logs[0];
+    }
+
+    while (pos < end && !logEnded) {
+        const uint8_t *frameStart = pos;
+        const char type = *pos++;
+        eof = false;
+
+        const size_t framesBefore = frames.size();
+        const bool decoded = isFrameType(type) && decodeFrame(type);
+        // a good frame is followed by the next frame or the end of the log
+        if (decoded && (pos == end || logEnded || isFrameType(*pos))) {
+            continue;
+        }
+
+        frames.resize(framesBefore);
+        corruptFrames++;
+        historyValid = false;
+        pos = frameStart + 1;
+    }
+
+    return true;
+}
@@ -0,0 +1,89 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+// Decoder for the logs written by blackbox/blackbox.c, the reverse of writeIntraframe() and writeInterframe().
+//
+// Only the main (I and P) frames are kept, slow, GPS and event frames are decoded to skip over them. A frame is
+// only accepted when the byte after it starts a frame too, otherwise it is counted as corrupt and the P frames are
+// dropped up to the next I frame, since their predictions no longer have a valid history.
+
+typedef struct blackboxLogFrame_s {
+    char type;                     // 'I' or 'P'
+    std::vector<int64_t> values;   // in the order of the main field names
+} blackboxLogFrame_t;
+
+class BlackboxLog {
+public:
+    // Decodes the log starting at data, which must begin with the product header line
+    bool parse(const uint8_t *data, size_t size);
+
+    bool hasHeader(const char *name) const;
+    std::string header(const char *name) const;
+    // The comma separated integers of a header, fallback if the header is missing
+    std::vector<int> headerInts(const char *name) const;
+    int headerInt(const char *name, int fallback) const;
+
+    // Index of a main field such as "gyroADC[0]", -1 if the field was not logged
+    int fieldIndex(const char *name) const;
+
+    std::vector<std::string> mainFieldNames;
+    std::vector<blackboxLogFrame_t> frames;
+    unsigned corruptFrames = 0;
+    bool logEnded = false;
+
+private:
+    typedef struct frameDef_s {
+        std::vector<std::string> names;
+        std::vector<int> isSigned;
+        std::vector<int> predictor;
+        std::vector<int> encoding;
+        std::vector<int> deltaPredictor;
+        std::vector<int> deltaEncoding;
+    } frameDef_t;
+
+    bool parseHeaderLine(const std::string &line);
+    bool decodeFields(const frameDef_t &def, bool delta, std::vector<int64_t> &values);
+    bool decodeFrame(char type);
+
+    std::map<std::string, std::string> headers;
+    std::map<char, frameDef_t> frameDefs;
+
+    const uint8_t *pos = nullptr;
+    const uint8_t *end = nullptr;
+    bool eof = false;
+
+    // main frame history for the P frame predictions, valid until a corrupt frame
+    std::vector<int64_t> previous;
+    std::vector<int64_t> previous2;
+    bool historyValid = false;
+    int64_t lastMainFrameTime = 0;
+};
+
+// Offsets of the logs in a file, a flight controller appends a new one every time logging starts
+std::vector<size_t> blackboxLogFind(const uint8_t *data, size_t size);
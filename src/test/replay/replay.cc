@@ -0,0 +1,586 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+    #include "common/axis.h"
+    #include "common/maths.h"
+    #include "config/config.h"
+    #include "config/feature.h"
+    #include "drivers/accgyro/accgyro_fake.h"
+    #include "drivers/pwm_output.h"
+    #include "drivers/time.h"
+    #include "fc/controlrate_profile.h"
+    #include "fc/core.h"
+    #include "fc/rc.h"
+    #include "fc/rc_controls.h"
+    #include "fc/rc_modes.h"
+    #include "fc/runtime_config.h"
+    #include "flight/failsafe.h"
+    #include "flight/imu.h"
+    #include "flight/mixer.h"
+    #include "flight/mixer_init.h"
+    #include "flight/pid.h"
+    #include "flight/pid_init.h"
+    #include "io/beeper.h"
+    #include "pg/motor.h"
+    #include "pg/pg.h"
+    #include "pg/rx.h"
+    #include "rx/rx.h"
+    #include "scheduler/scheduler.h"
+    #include "sensors/acceleration.h"
+    #include "sensors/gyro.h"
+    #include "sensors/gyro_init.h"
+    #include "sensors/sensors.h"
+
+    STATIC_UNIT_TESTED bool fakeGyroRead(gyroDev_t *gyro);
+}
+
+#include "blackbox_decoder.h"
+
+// Replays blackbox logs through the flight pipeline on the host:
+//
+//     replay [--csv=<file>] [--airmode] <log file>
+//
+// The configuration is rebuilt from the log headers, then for every main frame the logged gyro and RC drive
+// gyroUpdate(), gyroFiltering(), pidController() and mixTable() for as many loops as the frame time covers.
+// The filtered gyro, the PID terms and the motor outputs are compared with the logged ones and the time
+// taken by every stage is reported, so the same logs can be run through two builds to see what a change
+// does to the outputs and the cost of the flight loop.
+//
+// The unfiltered gyro is only logged with debug_mode (or debug_mode_2) GYRO_SCALED, other logs are replayed
+// from the logged filtered gyro, which is reported. The RC input is the logged PID setpoint, the rates and the
+// RC smoothing are not replayed. The RPM filter and the dynamic notch are not part of this build.
+
+#define REPLAY_MAX_LOOPS_PER_FRAME 64   // longer gaps are logging pauses, replay them as a single loop
+
+typedef enum {
+    STAGE_GYRO_UPDATE,
+    STAGE_GYRO_FILTERING,
+    STAGE_PID_CONTROLLER,
+    STAGE_MIX_TABLE,
+    STAGE_COUNT
+} replayStage_e;
+
+static const char * const stageNames[STAGE_COUNT] = {
+    "gyroUpdate",
+    "gyroFiltering",
+    "pidController",
+    "mixTable"
+};
+
+typedef struct stageTiming_s {
+    uint64_t calls;
+    double ns;
+} stageTiming_t;
+
+// The logged RC, read by the stubs of the fc/rc.c functions below
+static float replaySetpoint[XYZ_AXIS_COUNT];
+static float replayRcDeflection[XYZ_AXIS_COUNT];
+static float replayThrottlePIDAttenuation = 1.0f;
+static bool replayAirmode;
+static bool replayAirmodeOption;
+// every log frame is taken as a new RC frame for the feedforward
+static uint32_t replayRcFrameNumber;
+static uint16_t replayRxRefreshRate;
+
+static double clockNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+template <typename T>
+static void setFromHeader(const BlackboxLog &log, const char *name, unsigned index, T *value)
+{
+    const std::vector<int> values = log.headerInts(name);
+    if (index < values.size()) {
+        *value = values[index];
+    }
+}
+
+static void applyHeaders(const BlackboxLog &log)
+{
+    gyroConfig_t *gyroCfg = gyroConfigMutable();
+    setFromHeader(log, "gyro_hardware_lpf", 0, &gyroCfg->gyro_hardware_lpf);
+    setFromHeader(log, "gyro_lowpass_type", 0, &gyroCfg->gyro_lowpass_type);
+    setFromHeader(log, "gyro_lowpass_hz", 0, &gyroCfg->gyro_lowpass_hz);
+    setFromHeader(log, "gyro_lowpass2_type", 0, &gyroCfg->gyro_lowpass2_type);
+    setFromHeader(log, "gyro_lowpass2_hz", 0, &gyroCfg->gyro_lowpass2_hz);
+    setFromHeader(log, "gyro_notch_hz", 0, &gyroCfg->gyro_soft_notch_hz_1);
+    setFromHeader(log, "gyro_notch_hz", 1, &gyroCfg->gyro_soft_notch_hz_2);
+    setFromHeader(log, "gyro_notch_cutoff", 0, &gyroCfg->gyro_soft_notch_cutoff_1);
+    setFromHeader(log, "gyro_notch_cutoff", 1, &gyroCfg->gyro_soft_notch_cutoff_2);
+#ifdef USE_DYN_LPF
+    setFromHeader(log, "gyro_lowpass_dyn_hz", 0, &gyroCfg->dyn_lpf_gyro_min_hz);
+    setFromHeader(log, "gyro_lowpass_dyn_hz", 1, &gyroCfg->dyn_lpf_gyro_max_hz);
+#endif
+    // the replayed samples need no calibration
+    gyroCfg->gyroMovementCalibrationThreshold = 0;
+
+    pidConfigMutable()->pid_process_denom = log.headerInt("pid_process_denom", pidConfig()->pid_process_denom);
+
+    pidProfile_t *pidProfile = pidProfilesMutable(0);
+    static const char * const pidHeaders[] = { "rollPID", "pitchPID", "yawPID" };
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        setFromHeader(log, pidHeaders[axis], 0, &pidProfile->pid[axis].P);
+        setFromHeader(log, pidHeaders[axis], 1, &pidProfile->pid[axis].I);
+        setFromHeader(log, pidHeaders[axis], 2, &pidProfile->pid[axis].D);
+        setFromHeader(log, "feedforward_weight", axis, &pidProfile->pid[axis].F);
+#ifdef USE_D_MIN
+        setFromHeader(log, "d_min", axis, &pidProfile->d_min[axis]);
+#endif
+    }
+#ifdef USE_D_MIN
+    setFromHeader(log, "d_min_gain", 0, &pidProfile->d_min_gain);
+    setFromHeader(log, "d_min_advance", 0, &pidProfile->d_min_advance);
+#endif
+    setFromHeader(log, "dterm_filter_type", 0, &pidProfile->dterm_filter_type);
+    setFromHeader(log, "dterm_lowpass_hz", 0, &pidProfile->dterm_lowpass_hz);
+#ifdef USE_DYN_LPF
+    setFromHeader(log, "dterm_lowpass_dyn_hz", 0, &pidProfile->dyn_lpf_dterm_min_hz);
+    setFromHeader(log, "dterm_lowpass_dyn_hz", 1, &pidProfile->dyn_lpf_dterm_max_hz);
+#endif
+    setFromHeader(log, "dterm_filter2_type", 0, &pidProfile->dterm_filter2_type);
+    setFromHeader(log, "dterm_lowpass2_hz", 0, &pidProfile->dterm_lowpass2_hz);
+    setFromHeader(log, "yaw_lowpass_hz", 0, &pidProfile->yaw_lowpass_hz);
+    setFromHeader(log, "dterm_notch_hz", 0, &pidProfile->dterm_notch_hz);
+    setFromHeader(log, "dterm_notch_cutoff", 0, &pidProfile->dterm_notch_cutoff);
+    setFromHeader(log, "iterm_windup", 0, &pidProfile->itermWindupPointPercent);
+#ifdef USE_ITERM_RELAX
+    setFromHeader(log, "iterm_relax", 0, &pidProfile->iterm_relax);
+    setFromHeader(log, "iterm_relax_type", 0, &pidProfile->iterm_relax_type);
+    setFromHeader(log, "iterm_relax_cutoff", 0, &pidProfile->iterm_relax_cutoff);
+#endif
+    setFromHeader(log, "pidAtMinThrottle", 0, &pidProfile->pidAtMinThrottle);
+    setFromHeader(log, "anti_gravity_mode", 0, &pidProfile->antiGravityMode);
+    setFromHeader(log, "anti_gravity_threshold", 0, &pidProfile->itermThrottleThreshold);
+    setFromHeader(log, "anti_gravity_gain", 0, &pidProfile->itermAcceleratorGain);
+#ifdef USE_ABSOLUTE_CONTROL
+    setFromHeader(log, "abs_control_gain", 0, &pidProfile->abs_control_gain);
+#endif
+#ifdef USE_INTEGRATED_YAW_CONTROL
+    setFromHeader(log, "use_integrated_yaw", 0, &pidProfile->use_integrated_yaw);
+#endif
+    setFromHeader(log, "feedforward_transition", 0, &pidProfile->feedForwardTransition);
+#ifdef USE_INTERPOLATED_SP
+    setFromHeader(log, "ff_interpolate_sp", 0, &pidProfile->ff_interpolate_sp);
+    setFromHeader(log, "ff_max_rate_limit", 0, &pidProfile->ff_max_rate_limit);
+#endif
+    setFromHeader(log, "ff_boost", 0, &pidProfile->ff_boost);
+    setFromHeader(log, "acc_limit_yaw", 0, &pidProfile->yawRateAccelLimit);
+    setFromHeader(log, "acc_limit", 0, &pidProfile->rateAccelLimit);
+    setFromHeader(log, "pidsum_limit", 0, &pidProfile->pidSumLimit);
+    setFromHeader(log, "pidsum_limit_yaw", 0, &pidProfile->pidSumLimitYaw);
+
+    controlRateConfig_t *rates = controlRateProfilesMutable(0);
+    setFromHeader(log, "tpa_rate", 0, &rates->dynThrPID);
+    setFromHeader(log, "tpa_breakpoint", 0, &rates->tpa_breakpoint);
+
+    motorConfig_t *motor = motorConfigMutable();
+    setFromHeader(log, "minthrottle", 0, &motor->minthrottle);
+    setFromHeader(log, "maxthrottle", 0, &motor->maxthrottle);
+    setFromHeader(log, "motor_pwm_protocol", 0, &motor->dev.motorPwmProtocol);
+    setFromHeader(log, "motor_pwm_rate", 0, &motor->dev.motorPwmRate);
+    setFromHeader(log, "use_unsynced_pwm", 0, &motor->dev.useUnsyncedPwm);
+    setFromHeader(log, "dshot_idle_value", 0, &motor->digitalIdleOffsetValue);
+
+    setFromHeader(log, "features", 0, &featureConfigMutable()->enabledFeatures);
+
+    systemConfigMutable()->debug_mode = log.headerInt("debug_mode", DEBUG_NONE);
+    systemConfigMutable()->debug_mode_2 = log.headerInt("debug_mode_2", DEBUG_NONE);
+}
+
+static mixerMode_e mixerModeForMotors(int motorCount)
+{
+    switch (motorCount) {
+    case 6:
+        return MIXER_HEX6X;
+    case 8:
+        return MIXER_OCTOX8;
+    default:
+        return MIXER_QUADX;
+    }
+}
+
+// Difference of a replayed and a logged value over the frames compared
+class FieldDiff {
+public:
+    FieldDiff(const std::string &name, int logIndex) : name(name), logIndex(logIndex) {}
+
+    void add(int64_t logged, int64_t replayed)
+    {
+        const double diff = (double)replayed - logged;
+        count++;
+        sumSquares += diff * diff;
+        if (fabs(diff) > maxDiff) {
+            maxDiff = fabs(diff);
+        }
+    }
+
+    std::string name;
+    int logIndex;
+    uint64_t count = 0;
+    double sumSquares = 0;
+    double maxDiff = 0;
+};
+
+static bool replayLog(const BlackboxLog &log, int logNumber, FILE *csv)
+{
+    if (log.frames.empty() || log.fieldIndex("time") < 0) {
+        printf("log %d: no main frames\n", logNumber);
+        return false;
+    }
+
+    pgResetAll();
+    applyHeaders(log);
+
+    int motorCount = 0;
+    while (motorCount < MAX_SUPPORTED_MOTORS && log.fieldIndex(("motor[" + std::to_string(motorCount) + "]").c_str()) >= 0) {
+        motorCount++;
+    }
+    mixerConfigMutable()->mixerMode = mixerModeForMotors(motorCount);
+    replayAirmode = replayAirmodeOption || featureIsEnabled(FEATURE_AIRMODE);
+
+    debugInit();
+
+    // same order as init(), with the gyro running at the logged sample rate
+    gyroInit();
+    const int sampleLooptime = log.headerInt("looptime", 125);
+    gyro.rawSensorDev->gyroSampleRateHz = 1000000 / sampleLooptime;
+    gyro.sampleRateHz = gyro.rawSensorDev->gyroSampleRateHz;
+    gyroSetTargetLooptime(pidConfig()->pid_process_denom);
+    gyroInitFilters();
+    gyroDev_t *gyroDev = gyro.rawSensorDev;
+    gyroDev->readFn = fakeGyroRead;
+
+    currentPidProfile = pidProfilesMutable(0);
+    loadControlRateProfile();
+    mixerInit((mixerMode_e)mixerConfig()->mixerMode);
+    // the DShot endpoints are not built for the host, the logged ones apply to every protocol
+    const std::vector<int> motorOutput = log.headerInts("motorOutput");
+    if (motorOutput.size() == 2) {
+        mixerRuntime.motorOutputLow = motorOutput[0];
+        mixerRuntime.motorOutputHigh = motorOutput[1];
+    }
+    mixerInitProfile();
+    pidInit(currentPidProfile);
+    pidStabilisationState(PID_STABILISATION_ON);
+    ENABLE_ARMING_FLAG(ARMED);
+
+    // the gyro input, unfiltered when one of the debug modes logged it
+    int gyroInput = -1;
+    const char *gyroInputName = "gyroADC (filtered)";
+    if (debugModes[0] == DEBUG_GYRO_SCALED) {
+        gyroInput = log.fieldIndex("debug[0]");
+    } else if (debugModes[1] == DEBUG_GYRO_SCALED) {
+        gyroInput = log.fieldIndex("debug[4]");
+    }
+    if (gyroInput >= 0) {
+        gyroInputName = "debug GYRO_SCALED";
+    } else {
+        gyroInput = log.fieldIndex("gyroADC[0]");
+    }
+    if (gyroInput < 0) {
+        printf("log %d: no gyro logged\n", logNumber);
+        return false;
+    }
+
+    const int timeIndex = log.fieldIndex("time");
+    const int setpointIndex = log.fieldIndex("setpoint[0]");
+    const int rcCommandIndex = log.fieldIndex("rcCommand[0]");
+
+    std::vector<FieldDiff> diffs;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        diffs.push_back(FieldDiff("gyroADC[" + std::to_string(axis) + "]", log.fieldIndex(("gyroADC[" + std::to_string(axis) + "]").c_str())));
+    }
+    static const char * const pidTerms[] = { "axisP", "axisI", "axisD", "axisF" };
+    for (const char *term : pidTerms) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            const std::string name = std::string(term) + "[" + std::to_string(axis) + "]";
+            diffs.push_back(FieldDiff(name, log.fieldIndex(name.c_str())));
+        }
+    }
+    for (int i = 0; i < motorCount; i++) {
+        const std::string name = "motor[" + std::to_string(i) + "]";
+        diffs.push_back(FieldDiff(name, log.fieldIndex(name.c_str())));
+    }
+
+    if (csv) {
+        fprintf(csv, "log,time");
+        for (const FieldDiff &diff : diffs) {
+            if (diff.logIndex >= 0) {
+                fprintf(csv, ",%s,%s replayed", diff.name.c_str(), diff.name.c_str());
+            }
+        }
+        fprintf(csv, "\n");
+    }
+
+    stageTiming_t timing[STAGE_COUNT] = {};
+    const int pidLooptime = gyro.targetLooptime;
+    const int gyroUpdatesPerLoop = activeGyroUpdateDenom;
+    int64_t previousTime = log.frames[0].values[timeIndex] - pidLooptime;
+    unsigned gaps = 0;
+
+    for (const blackboxLogFrame_t &frame : log.frames) {
+        const std::vector<int64_t> &values = frame.values;
+        const int64_t frameTime = values[timeIndex];
+
+        int loops = pidLooptime ? lrint((double)(frameTime - previousTime) / pidLooptime) : 1;
+        if (loops < 1 || loops > REPLAY_MAX_LOOPS_PER_FRAME) {
+            gaps++;
+            loops = 1;
+        }
+        replayRcFrameNumber++;
+        replayRxRefreshRate = constrain(frameTime - previousTime, 1, UINT16_MAX);
+        previousTime = frameTime;
+
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            if (setpointIndex >= 0) {
+                replaySetpoint[axis] = values[setpointIndex + axis];
+            }
+            if (rcCommandIndex >= 0) {
+                replayRcDeflection[axis] = values[rcCommandIndex + axis] / 500.0f;
+                rcCommand[axis] = values[rcCommandIndex + axis];
+            }
+        }
+        if (rcCommandIndex >= 0) {
+            rcCommand[THROTTLE] = values[rcCommandIndex + THROTTLE];
+            rcData[THROTTLE] = rcCommand[THROTTLE];
+        }
+
+        const controlRateConfig_t *rates = controlRateProfiles(0);
+        replayThrottlePIDAttenuation = 1.0f;
+        if (rcData[THROTTLE] >= rates->tpa_breakpoint) {
+            const int range = MAX(2000 - rates->tpa_breakpoint, 1);
+            replayThrottlePIDAttenuation = (100 - (int)rates->dynThrPID * MIN(rcData[THROTTLE] - rates->tpa_breakpoint, range) / range) / 100.0f;
+        }
+
+        // the logged sample is held for all the gyro updates until the next frame
+        const int16_t x = constrain(values[gyroInput + X], INT16_MIN, INT16_MAX);
+        const int16_t y = constrain(values[gyroInput + Y], INT16_MIN, INT16_MAX);
+        const int16_t z = constrain(values[gyroInput + Z], INT16_MIN, INT16_MAX);
+
+        for (int loop = 0; loop < loops; loop++) {
+            const timeUs_t currentTimeUs = frameTime - (loops - 1 - loop) * pidLooptime;
+
+            double start = clockNs();
+            for (int i = 0; i < gyroUpdatesPerLoop; i++) {
+                fakeGyroSet(gyroDev, x, y, z);
+                gyroUpdate();
+            }
+            double stop = clockNs();
+            timing[STAGE_GYRO_UPDATE].ns += stop - start;
+            timing[STAGE_GYRO_UPDATE].calls += gyroUpdatesPerLoop;
+
+            start = stop;
+            gyroFiltering(currentTimeUs);
+            stop = clockNs();
+            timing[STAGE_GYRO_FILTERING].ns += stop - start;
+
+            start = stop;
+            pidController(currentPidProfile, currentTimeUs);
+            stop = clockNs();
+            timing[STAGE_PID_CONTROLLER].ns += stop - start;
+
+            start = stop;
+            mixTable(currentTimeUs);
+            stop = clockNs();
+            timing[STAGE_MIX_TABLE].ns += stop - start;
+
+            timing[STAGE_GYRO_FILTERING].calls++;
+            timing[STAGE_PID_CONTROLLER].calls++;
+            timing[STAGE_MIX_TABLE].calls++;
+        }
+
+        // replayed values truncated like loadMainState() does
+        if (csv) {
+            fprintf(csv, "%d,%lld", logNumber, (long long)frameTime);
+        }
+        for (size_t i = 0; i < diffs.size(); i++) {
+            FieldDiff &diff = diffs[i];
+            int64_t replayed;
+            if (i < XYZ_AXIS_COUNT) {
+                replayed = lrintf(gyro.gyroADCf[i]);
+            } else if (i < XYZ_AXIS_COUNT * 5) {
+                const pidAxisData_t *data = &pidData[(i - XYZ_AXIS_COUNT) % XYZ_AXIS_COUNT];
+                static const float pidAxisData_t::*terms[] = { &pidAxisData_t::P, &pidAxisData_t::I, &pidAxisData_t::D, &pidAxisData_t::F };
+                replayed = (int32_t)(data->*terms[(i - XYZ_AXIS_COUNT) / XYZ_AXIS_COUNT]);
+            } else {
+                replayed = (int16_t)motor[i - XYZ_AXIS_COUNT * 5];
+            }
+            if (diff.logIndex >= 0) {
+                diff.add(values[diff.logIndex], replayed);
+                if (csv) {
+                    fprintf(csv, ",%lld,%lld", (long long)values[diff.logIndex], (long long)replayed);
+                }
+            }
+        }
+        if (csv) {
+            fprintf(csv, "\n");
+        }
+    }
+
+    const double seconds = (log.frames.back().values[timeIndex] - log.frames.front().values[timeIndex]) * 1e-6;
+    printf("log %d: %zu frames over %.1f s, %u corrupt, %u gaps, gyro input %s, %d us PID loop with %d gyro updates\n",
+        logNumber, log.frames.size(), seconds, log.corruptFrames, gaps, gyroInputName, pidLooptime, gyroUpdatesPerLoop);
+
+    printf("%15s %10s %10s\n", "field", "rms diff", "max diff");
+    for (const FieldDiff &diff : diffs) {
+        if (diff.logIndex >= 0 && diff.count) {
+            printf("%15s %10.2f %10.0f\n", diff.name.c_str(), sqrt(diff.sumSquares / diff.count), diff.maxDiff);
+        }
+    }
+
+    printf("%15s %10s %10s\n", "stage", "calls", "ns/call");
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        printf("%15s %10llu %10.1f\n", stageNames[stage], (unsigned long long)timing[stage].calls,
+            timing[stage].calls ? timing[stage].ns / timing[stage].calls : 0.0);
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const char *filename = NULL;
+    const char *csvFilename = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strncmp(argv[i], "--csv=", 6)) {
+            csvFilename = argv[i] + 6;
+        } else if (!strcmp(argv[i], "--airmode")) {
+            replayAirmodeOption = true;
+        } else if (argv[i][0] != '-' && !filename) {
+            filename = argv[i];
+        } else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (!filename) {
+        fprintf(stderr, "usage: %s [--csv=<file>] [--airmode] <log file>\n", argv[0]);
+        return 1;
+    }
+
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        fprintf(stderr, "unable to read %s\n", filename);
+        return 1;
+    }
+    std::vector<uint8_t> data;
+    uint8_t buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.insert(data.end(), buffer, buffer + count);
+    }
+    fclose(file);
+
+    FILE *csv = NULL;
+    if (csvFilename) {
+        csv = fopen(csvFilename, "w");
+        if (!csv) {
+            fprintf(stderr, "unable to write %s\n", csvFilename);
+            return 1;
+        }
+    }
+
+    const std::vector<size_t> offsets = blackboxLogFind(data.data(), data.size());
+    if (offsets.empty()) {
+        fprintf(stderr, "%s has no blackbox logs\n", filename);
+        return 1;
+    }
+
+    int replayed = 0;
+    for (size_t i = 0; i < offsets.size(); i++) {
+        BlackboxLog log;
+        if (log.parse(data.data() + offsets[i], data.size() - offsets[i]) && replayLog(log, i + 1, csv)) {
+            replayed++;
+        }
+    }
+
+    if (csv) {
+        fclose(csv);
+    }
+
+    return replayed ? 0 : 1;
+}
+
+// STUBS
+
+extern "C" {
+
+PG_REGISTER(accelerometerConfig_t, accelerometerConfig, PG_ACCELEROMETER_CONFIG, 0);
+PG_REGISTER(flight3DConfig_t, flight3DConfig, PG_MOTOR_3D_CONFIG, 0);
+PG_REGISTER(systemConfig_t, systemConfig, PG_SYSTEM_CONFIG, 0);
+
+pidProfile_t *currentPidProfile;
+float rcCommand[4];
+int16_t rcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+attitudeEulerAngles_t attitude;
+pwmOutputPort_t motors[MAX_SUPPORTED_MOTORS];
+
+uint8_t detectedSensors[SENSOR_INDEX_COUNT] = { GYRO_NONE, ACC_NONE };
+
+uint32_t micros(void) { return 0; }
+uint32_t millis(void) { return 0; }
+void beeper(beeperMode_e) {}
+void beeperConfirmationBeeps(uint8_t) {}
+void systemBeep(bool) {}
+timeDelta_t getGyroUpdateRate(void) { return gyro.targetLooptime; }
+void schedulerResetTaskStatistics(taskId_e) {}
+void writeEEPROM(void) {}
+void disarm(flightLogDisarmReason_e) {}
+void delay(timeMs_t) {}
+void delayMicroseconds(timeUs_t) {}
+motorDevice_t *motorPwmDevInit(const motorDevConfig_t *, uint16_t, uint8_t, bool) { return NULL; }
+void accSetRequiredRate(accConsumer_e, uint16_t) {}
+bool IS_RC_MODE_ACTIVE(boxId_e) { return false; }
+bool failsafeIsActive(void) { return false; }
+bool isFlipOverAfterCrashActive(void) { return false; }
+bool isLaunchControlActive(void) { return false; }
+void parseRcChannels(const char *, rxConfig_t *) {}
+
+float getSetpointRate(int axis) { return replaySetpoint[axis]; }
+float getRcDeflection(int axis) { return replayRcDeflection[axis]; }
+float getRcDeflectionAbs(int axis) { return fabsf(replayRcDeflection[axis]); }
+float getThrottlePIDAttenuation(void) { return replayThrottlePIDAttenuation; }
+bool isAirmodeActivated(void) { return replayAirmode; }
+bool airmodeIsEnabled(void) { return replayAirmode; }
+bool isMotorsReversed(void) { return false; }
+void initRcProcessing(void) {}
+float getRawSetpoint(int axis) { return replaySetpoint[axis]; }
+float applyCurve(int axis, float deflection) { return deflection * controlRateProfiles(0)->rate_limit[axis]; }
+uint32_t getRcFrameNumber(void) { return replayRcFrameNumber; }
+uint16_t getCurrentRxRefreshRate(void) { return replayRxRefreshRate; }
+}
@@ -0,0 +1,580 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/maths.h"
+    #include "common/utils.h"
+    #include "fc/tasks.h"
+    #include "scheduler/scheduler.h"
+}
+
+#include "task_dump.h"
+
+// Runs scheduler/scheduler.c on the host against simulated tasks, to see whether a configuration keeps up
+// before it is flown:
+//
+//     schedsim [options] <dump file>
+//
+//     --duration=<s>              simulated time, one hour by default
+//     --task=<name>:<hz>[:<us>]   enable a task or change its rate, optionally taking <us> per run
+//     --scale=<factor>            scale all the execution times, e.g. for a slower MCU
+//     --overhead=<us>             time of a scheduler pass, 1 us by default
+//     --governor=<load>           task_governor_load, 0 (off) by default
+//     --optimize-rate             schedule the gyro from its desired time like scheduler_optimize_rate
+//     --seed=<n>                  seed of the execution time sampling
+//
+// The dump file holds the output of the 'tasks' and 'tasks hist' CLI commands of the flight controller.
+// Every dumped task takes execution times drawn from its histogram, or its average if only 'tasks' was
+// dumped, and the RX check function takes the time of its own histogram every time a frame is
+// signalled. The priorities and the default periods are those of fc/tasks.c, the periods that are set
+// up from the configuration are taken from the measured rates.
+//
+// The gyro delivers a sample every gyro period, samples the gyro task does not read before the next one
+// are counted as missed. RX frames arrive at the dumped RX rate. The latency of a task is the time from
+// when it became due, or its frame or gyro sample arrived, to when it ran, the age is taskAgeCycles at
+// that point.
+// The realtime tasks are polled, the gyro interrupt of USE_GYRO_EXTI_REALTIME is not simulated.
+
+#define SIM_LATENCY_BUCKET_COUNT 10000  // 1 us buckets, the last one holds all the longer latencies
+
+typedef struct simTaskDef_s {
+    taskId_e taskId;
+    const char *name;           // as printed by the 'tasks' CLI command
+    const char *subTaskName;
+    int8_t staticPriority;
+    int periodHz;               // the default of fc/tasks.c
+    bool configuredRate;        // rate is set from the configuration, use the dumped one
+    int maxPeriodHz;            // lowest rate the load governor may stretch the task to, 0 if not governed
+    bool eventDriven;
+} simTaskDef_t;
+
+// Mirrors the task table and tasksInit() of fc/tasks.c
+static const simTaskDef_t simTaskDefs[] = {
+    { TASK_SYSTEM,              "SYSTEM",             "LOAD",   TASK_PRIORITY_MEDIUM_HIGH, 10,   false, 0,  false },
+    { TASK_MAIN,                "SYSTEM",             "UPDATE", TASK_PRIORITY_MEDIUM_HIGH, 1000, false, 0,  false },
+    { TASK_SERIAL,              "SERIAL",             NULL,     TASK_PRIORITY_LOW,         100,  true,  0,  false },
+    { TASK_BATTERY_ALERTS,      "BATTERY_ALERTS",     NULL,     TASK_PRIORITY_MEDIUM,      5,    false, 0,  false },
+    { TASK_BATTERY_VOLTAGE,     "BATTERY_VOLTAGE",    NULL,     TASK_PRIORITY_MEDIUM,      50,   true,  0,  false },
+    { TASK_BATTERY_CURRENT,     "BATTERY_CURRENT",    NULL,     TASK_PRIORITY_MEDIUM,      50,   false, 0,  false },
+    { TASK_TRANSPONDER,         "TRANSPONDER",        NULL,     TASK_PRIORITY_LOW,         250,  false, 0,  false },
+    { TASK_STACK_CHECK,         "STACKCHECK",         NULL,     TASK_PRIORITY_IDLE,        10,   false, 0,  false },
+    { TASK_GYRO,                "GYRO",               NULL,     TASK_PRIORITY_REALTIME,    8000, true,  0,  false },
+    { TASK_FILTER,              "FILTER",             NULL,     TASK_PRIORITY_REALTIME,    8000, true,  0,  false },
+    { TASK_PID,                 "PID",                NULL,     TASK_PRIORITY_REALTIME,    8000, true,  0,  false },
+    { TASK_ACCEL,               "ACC",                NULL,     TASK_PRIORITY_MEDIUM,      1000, true,  0,  false },
+    { TASK_ATTITUDE,            "ATTITUDE",           NULL,     TASK_PRIORITY_MEDIUM,      100,  true,  0,  false },
+    { TASK_RX,                  "RX",                 NULL,     TASK_PRIORITY_HIGH,        33,   false, 0,  true },
+    { TASK_DISPATCH,            "DISPATCH",           NULL,     TASK_PRIORITY_HIGH,        1000, false, 0,  false },
+    { TASK_BEEPER,              "BEEPER",             NULL,     TASK_PRIORITY_LOW,         100,  false, 0,  false },
+    { TASK_GPS,                 "GPS",                NULL,     TASK_PRIORITY_MEDIUM,      100,  false, 0,  false },
+    { TASK_COMPASS,             "COMPASS",            NULL,     TASK_PRIORITY_LOW,         10,   false, 0,  false },
+    { TASK_BARO,                "BARO",               NULL,     TASK_PRIORITY_LOW,         20,   true,  0,  false },
+    { TASK_ALTITUDE,            "ALTITUDE",           NULL,     TASK_PRIORITY_LOW,         40,   false, 0,  false },
+    { TASK_DASHBOARD,           "DASHBOARD",          NULL,     TASK_PRIORITY_LOW,         10,   false, 2,  false },
+    { TASK_OSD,                 "OSD",                NULL,     TASK_PRIORITY_LOW,         60,   true,  5,  false },
+    { TASK_TELEMETRY,           "TELEMETRY",          NULL,     TASK_PRIORITY_LOW,         250,  true,  50, false },
+    { TASK_LEDSTRIP,            "LEDSTRIP",           NULL,     TASK_PRIORITY_LOW,         100,  false, 20, false },
+    { TASK_BST_MASTER_PROCESS,  "BST_MASTER_PROCESS", NULL,     TASK_PRIORITY_IDLE,        50,   false, 0,  false },
+    { TASK_ESC_SENSOR,          "ESC_SENSOR",         NULL,     TASK_PRIORITY_LOW,         100,  true,  0,  false },  // event driven, at its dumped rate
+    { TASK_CMS,                 "CMS",                NULL,     TASK_PRIORITY_LOW,         20,   false, 5,  false },
+    { TASK_VTXCTRL,             "VTXCTRL",            NULL,     TASK_PRIORITY_IDLE,        5,    false, 0,  false },
+    { TASK_RCDEVICE,            "RCDEVICE",           NULL,     TASK_PRIORITY_MEDIUM,      20,   false, 0,  false },
+    { TASK_CAMCTRL,             "CAMCTRL",            NULL,     TASK_PRIORITY_IDLE,        5,    false, 0,  false },
+    { TASK_ADC_INTERNAL,        "ADCINTERNAL",        NULL,     TASK_PRIORITY_IDLE,        1,    false, 0,  false },
+    { TASK_BLACKBOX,            "BLACKBOX",           NULL,     TASK_PRIORITY_MEDIUM_HIGH, 1000, true,  0,  false },
+    { TASK_FLASHFS,             "FLASHFS",            NULL,     TASK_PRIORITY_IDLE,        50,   false, 0,  false },
+    { TASK_PINIOBOX,            "PINIOBOX",           NULL,     TASK_PRIORITY_IDLE,        20,   false, 0,  false },
+    { TASK_RANGEFINDER,         "RANGEFINDER",        NULL,     TASK_PRIORITY_IDLE,        10,   false, 0,  false },
+};
+
+typedef struct simTask_s {
+    const simTaskDef_t *def;
+    bool enabled;
+    int rateHz;
+
+    // execution time model
+    std::vector<double> cumulative;     // running sum of the histogram buckets
+    double maxUs;
+    double fixedUs;                     // used without a histogram
+
+    // statistics
+    uint64_t runs;
+    double totalUs;
+    double lastRunUs;
+    double latencySumUs;
+    double latencyMaxUs;
+    std::vector<uint64_t> latencyBuckets;
+    uint16_t maxAgeCycles;
+} simTask_t;
+
+static double simNowUs;
+static double simScale = 1.0;
+static uint64_t simRandomState = 0x853c49e6748fea9bULL;
+static uint64_t simExecutions;
+
+static simTask_t simTasks[TASK_COUNT];
+// task_t has a const member, so the tasks are constructed in place like the initialised task table of fc/tasks.c
+static task_t *tasks = static_cast<task_t *>(calloc(TASK_COUNT, sizeof(task_t)));
+
+// the realtime task chain of fc/core.c
+static int gyroUpdateDenom = 1;
+static int pidUpdateCounter;
+static double gyroPeriodUs;
+static uint64_t gyroLastSample;
+static uint64_t gyroMissedSamples;
+
+static double rxFramePeriodUs;
+static double rxNextFrameUs;
+static double rxPendingFrameUs = -1;     // arrival of the frame not yet handled, -1 if none
+static uint64_t rxFrames;
+static uint64_t rxMissedFrames;
+static simTask_t rxCheckFunc;
+
+static double loadSum;
+static uint64_t loadSamples;
+static uint16_t loadMax;
+static uint16_t governorStretchMax = LOAD_PERCENTAGE_ONE;
+
+static double simRandom(void)
+{
+    // xorshift64*
+    simRandomState ^= simRandomState >> 12;
+    simRandomState ^= simRandomState << 25;
+    simRandomState ^= simRandomState >> 27;
+    return ((simRandomState * 0x2545f4914f6cdd1dULL) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static void simTimingFromDump(simTask_t *task, const taskDumpEntry_t *dump)
+{
+    task->fixedUs = dump->averageUs;
+    task->maxUs = dump->maxUs;
+    task->cumulative.clear();
+    double sum = 0;
+    for (uint32_t count : dump->histogram) {
+        sum += count;
+        task->cumulative.push_back(sum);
+    }
+    if (sum == 0) {
+        task->cumulative.clear();
+    }
+}
+
+// An execution time from the log2 histogram, uniform within the bucket and capped at the dumped maximum
+static double simSampleUs(const simTask_t *task)
+{
+    double us = task->fixedUs;
+    if (!task->cumulative.empty()) {
+        const double pick = simRandom() * task->cumulative.back();
+        size_t bucket = 0;
+        while (bucket + 1 < task->cumulative.size() && task->cumulative[bucket] <= pick) {
+            bucket++;
+        }
+        const double low = bucket ? (1 << (bucket - 1)) : 0;
+        const double high = 1 << bucket;
+        us = low + simRandom() * (high - low);
+        if (task->maxUs >= low) {
+            us = MIN(us, task->maxUs);
+        }
+    }
+    return us * simScale;
+}
+
+static void simLatencyAdd(simTask_t *task, double latencyUs)
+{
+    latencyUs = MAX(latencyUs, 0.0);
+    task->latencySumUs += latencyUs;
+    task->latencyMaxUs = MAX(task->latencyMaxUs, latencyUs);
+    task->latencyBuckets[MIN((size_t)latencyUs, task->latencyBuckets.size() - 1)]++;
+}
+
+static double simLatencyPercentileUs(const simTask_t *task, double fraction)
+{
+    const uint64_t target = ceil(task->runs * fraction);
+    uint64_t sum = 0;
+    for (size_t i = 0; i < task->latencyBuckets.size(); i++) {
+        sum += task->latencyBuckets[i];
+        if (sum >= target && sum) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+static void simTaskRun(taskId_e taskId, timeUs_t currentTimeUs)
+{
+    UNUSED(currentTimeUs);
+
+    simTask_t *task = &simTasks[taskId];
+    const task_t *schedulerTask = &tasks[taskId];
+
+    if (taskId == TASK_GYRO) {
+        const uint64_t sample = simNowUs / gyroPeriodUs;
+        if (sample > gyroLastSample + 1) {
+            gyroMissedSamples += sample - gyroLastSample - 1;
+        }
+        gyroLastSample = sample;
+        simLatencyAdd(task, simNowUs - sample * gyroPeriodUs);
+
+        if (pidUpdateCounter % gyroUpdateDenom == 0) {
+            pidUpdateCounter = 0;
+        }
+        pidUpdateCounter++;
+    } else if (taskId == TASK_RX) {
+        if (rxPendingFrameUs >= 0) {
+            simLatencyAdd(task, simNowUs - rxPendingFrameUs);
+            rxPendingFrameUs = -1;
+        }
+    } else if (schedulerTask->staticPriority != TASK_PRIORITY_REALTIME) {
+        const double dueUs = (task->runs ? task->lastRunUs : 0) + schedulerTask->desiredPeriodUs;
+        simLatencyAdd(task, simNowUs - dueUs);
+        task->maxAgeCycles = MAX(task->maxAgeCycles, schedulerTask->taskAgeCycles);
+    } else {
+        // the filter and PID tasks from the gyro sample they work on
+        simLatencyAdd(task, simNowUs - gyroLastSample * gyroPeriodUs);
+    }
+
+    if (taskId == TASK_SYSTEM) {
+        taskSystemLoad(currentTimeUs);
+        loadSum += getAverageSystemLoadPercent();
+        loadSamples++;
+        loadMax = MAX(loadMax, getAverageSystemLoadPercent());
+        governorStretchMax = MAX(governorStretchMax, getLoadGovernorStretchPercent());
+    }
+
+    const double executionUs = simSampleUs(task);
+    task->runs++;
+    task->totalUs += executionUs;
+    task->lastRunUs = simNowUs;
+    simNowUs += executionUs;
+    simExecutions++;
+}
+
+template <int taskId>
+static void simTaskFunc(timeUs_t currentTimeUs)
+{
+    simTaskRun((taskId_e)taskId, currentTimeUs);
+}
+
+typedef void (*simTaskFunc_t)(timeUs_t currentTimeUs);
+
+template <int count>
+struct SimTaskFuncs {
+    static void fill(simTaskFunc_t *funcs)
+    {
+        funcs[count - 1] = simTaskFunc<count - 1>;
+        SimTaskFuncs<count - 1>::fill(funcs);
+    }
+};
+
+template <>
+struct SimTaskFuncs<0> {
+    static void fill(simTaskFunc_t *) {}
+};
+
+// RX frames are signalled as soon as they have arrived, a frame replaced by the next one before it was handled is missed
+static bool simRxCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs)
+{
+    UNUSED(currentTimeUs);
+    UNUSED(currentDeltaTimeUs);
+
+    bool signalled = false;
+    while (rxFramePeriodUs > 0 && simNowUs >= rxNextFrameUs) {
+        if (rxPendingFrameUs >= 0) {
+            rxMissedFrames++;
+        }
+        rxPendingFrameUs = rxNextFrameUs;
+        rxNextFrameUs += rxFramePeriodUs;
+        rxFrames++;
+        signalled = true;
+    }
+    if (signalled) {
+        simNowUs += simSampleUs(&rxCheckFunc);
+    }
+    return rxPendingFrameUs >= 0;
+}
+
+static bool parseTaskOption(const char *option, std::string &name, int &rateHz, double &us)
+{
+    const char *colon = strchr(option, ':');
+    if (!colon) {
+        return false;
+    }
+    name.assign(option, colon - option);
+    char *end;
+    rateHz = strtol(colon + 1, &end, 10);
+    us = -1;
+    if (*end == ':') {
+        us = atof(end + 1);
+    } else if (*end) {
+        return false;
+    }
+    return true;
+}
+
+static simTask_t *simTaskByName(const std::string &name, int occurrence)
+{
+    for (simTask_t &task : simTasks) {
+        if (task.def && name == task.def->name && (occurrence < 0 || occurrence == (task.def->taskId == TASK_MAIN))) {
+            return &task;
+        }
+    }
+    return nullptr;
+}
+
+// The next time the scheduler has something to do if nothing ran in this pass
+static double simNextEventUs(void)
+{
+    const timeUs_t nowUs = simNowUs;
+    timeDelta_t nextDeltaUs = INT32_MAX;
+    for (const simTask_t &simTask : simTasks) {
+        if (!simTask.enabled || simTask.def->eventDriven) {
+            continue;
+        }
+        const task_t *task = &tasks[simTask.def->taskId];
+        if (task->staticPriority == TASK_PRIORITY_REALTIME && simTask.def->taskId != TASK_GYRO) {
+            continue;
+        }
+        const timeDelta_t deltaUs = cmpTimeUs(task->lastExecutedAtUs + task->desiredPeriodUs, nowUs);
+        if (deltaUs > 0) {
+            nextDeltaUs = MIN(nextDeltaUs, deltaUs);
+        }
+    }
+    double nextUs = floor(simNowUs) + nextDeltaUs;
+    if (rxFramePeriodUs > 0) {
+        nextUs = MIN(nextUs, rxNextFrameUs);
+    }
+    return nextUs;
+}
+
+static const char *simTaskLabel(const simTaskDef_t *def)
+{
+    static char label[32];
+    snprintf(label, sizeof(label), "%s%s%s", def->name, def->subTaskName ? "/" : "", def->subTaskName ? def->subTaskName : "");
+    return label;
+}
+
+int main(int argc, char **argv)
+{
+    const char *filename = NULL;
+    double durationS = 3600;
+    double overheadUs = 1;
+    int governorLoad = 0;
+    bool optimizeRate = false;
+    std::vector<const char *> taskOptions;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strncmp(argv[i], "--duration=", 11)) {
+            durationS = atof(argv[i] + 11);
+        } else if (!strncmp(argv[i], "--task=", 7)) {
+            taskOptions.push_back(argv[i] + 7);
+        } else if (!strncmp(argv[i], "--scale=", 8)) {
+            simScale = atof(argv[i] + 8);
+        } else if (!strncmp(argv[i], "--overhead=", 11)) {
+            overheadUs = atof(argv[i] + 11);
+        } else if (!strncmp(argv[i], "--governor=", 11)) {
+            governorLoad = atoi(argv[i] + 11);
+        } else if (!strcmp(argv[i], "--optimize-rate")) {
+            optimizeRate = true;
+        } else if (!strncmp(argv[i], "--seed=", 7)) {
+            simRandomState ^= strtoull(argv[i] + 7, NULL, 0);
+        } else if (argv[i][0] != '-' && !filename) {
+            filename = argv[i];
+        } else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (!filename) {
+        fprintf(stderr, "usage: %s [--duration=<s>] [--task=<name>:<hz>[:<us>]] [--scale=<factor>] [--overhead=<us>] [--governor=<load>] [--optimize-rate] [--seed=<n>] <dump file>\n", argv[0]);
+        return 1;
+    }
+
+    std::ifstream file(filename);
+    if (!file) {
+        fprintf(stderr, "unable to read %s\n", filename);
+        return 1;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    TaskDump dump;
+    if (!dump.parse(text.str())) {
+        fprintf(stderr, "%s: no 'tasks' output found\n", filename);
+        return 1;
+    }
+
+    // the dumped tasks, then the command line changes
+    for (const simTaskDef_t &def : simTaskDefs) {
+        simTask_t *task = &simTasks[def.taskId];
+        task->def = &def;
+        task->rateHz = def.periodHz;
+        task->latencyBuckets.assign(SIM_LATENCY_BUCKET_COUNT, 0);
+        const taskDumpEntry_t *entry = dump.find(def.name, def.taskId == TASK_MAIN);
+        if (entry) {
+            task->enabled = true;
+            if (def.configuredRate || def.eventDriven) {
+                task->rateHz = entry->rateHz ? entry->rateHz : def.periodHz;
+            }
+            simTimingFromDump(task, entry);
+        }
+    }
+    for (const taskDumpEntry_t &entry : dump.tasks) {
+        if (!simTaskByName(entry.name, entry.occurrence)) {
+            fprintf(stderr, "ignoring unknown task %s\n", entry.name.c_str());
+        }
+    }
+    simTimingFromDump(&rxCheckFunc, &dump.checkFunc);
+
+    for (const char *option : taskOptions) {
+        std::string name;
+        int rateHz;
+        double us;
+        simTask_t *task;
+        if (!parseTaskOption(option, name, rateHz, us) || !(task = simTaskByName(name, -1)) || rateHz < 0) {
+            fprintf(stderr, "bad task option %s, expected <name>:<hz>[:<us>]\n", option);
+            return 1;
+        }
+        task->enabled = true;
+        if (rateHz) {
+            task->rateHz = rateHz;
+        }
+        if (us >= 0) {
+            task->fixedUs = us;
+            task->cumulative.clear();
+        }
+    }
+
+    simTask_t *gyroTask = &simTasks[TASK_GYRO];
+    simTask_t *pidTask = &simTasks[TASK_PID];
+    if (!gyroTask->enabled || !pidTask->enabled) {
+        fprintf(stderr, "the GYRO and PID tasks must be in the dump\n");
+        return 1;
+    }
+    simTasks[TASK_SYSTEM].enabled = true;
+    simTasks[TASK_FILTER].enabled = true;
+    simTasks[TASK_FILTER].rateHz = pidTask->rateHz;
+    gyroUpdateDenom = MAX(1, (int)lrint((double)gyroTask->rateHz / pidTask->rateHz));
+    gyroPeriodUs = 1e6 / gyroTask->rateHz;
+    if (simTasks[TASK_RX].enabled && simTasks[TASK_RX].rateHz) {
+        rxFramePeriodUs = 1e6 / simTasks[TASK_RX].rateHz;
+        rxNextFrameUs = rxFramePeriodUs;
+    }
+
+    // same as tasksInit() with the simulated tasks
+    simTaskFunc_t taskFuncs[TASK_COUNT];
+    SimTaskFuncs<TASK_COUNT>::fill(taskFuncs);
+    for (const simTaskDef_t &def : simTaskDefs) {
+        new (&tasks[def.taskId]) task_t {
+            def.name,
+            def.subTaskName,
+            def.eventDriven ? simRxCheck : NULL,
+            taskFuncs[def.taskId],
+            TASK_PERIOD_HZ(def.periodHz),
+            def.staticPriority,
+        };
+    }
+
+    schedulerInit();
+    for (const simTask_t &task : simTasks) {
+        if (task.enabled) {
+            const taskId_e taskId = task.def->taskId;
+            setTaskEnabled(taskId, true);
+            // the rate of an event driven task is its frame rate, it keeps the fallback period
+            rescheduleTask(taskId, TASK_PERIOD_HZ(task.def->eventDriven ? task.def->periodHz : task.rateHz));
+            if (task.def->maxPeriodHz) {
+                schedulerSetTaskMaxPeriod(taskId, TASK_PERIOD_HZ(task.def->maxPeriodHz));
+            }
+        }
+    }
+    rescheduleTask(TASK_GYRO, lrint(gyroPeriodUs));
+    schedulerOptimizeRate(optimizeRate);
+    schedulerSetLoadGovernor(governorLoad);
+    schedulerEnableGyro();
+
+    const double endUs = durationS * 1e6;
+    uint64_t passes = 0;
+    while (simNowUs < endUs) {
+        const uint64_t executions = simExecutions;
+        scheduler();
+        simNowUs += overheadUs;
+        if (simExecutions == executions) {
+            simNowUs = MAX(simNowUs, simNextEventUs());
+        }
+        passes++;
+    }
+
+    const double simulatedS = simNowUs * 1e-6;
+    const uint64_t gyroSamples = simNowUs / gyroPeriodUs;
+    printf("simulated %.1f s in %llu scheduler passes, load average %.0f%% max %d%%, governor stretch max %d%%\n",
+        simulatedS, (unsigned long long)passes, loadSamples ? loadSum / loadSamples : 0.0, loadMax, governorStretchMax);
+    printf("gyro: %llu samples at %d Hz, %llu missed (%.4f%%), PID every %d samples\n",
+        (unsigned long long)gyroSamples, gyroTask->rateHz, (unsigned long long)gyroMissedSamples,
+        gyroSamples ? 100.0 * gyroMissedSamples / gyroSamples : 0.0, gyroUpdateDenom);
+    if (rxFramePeriodUs > 0) {
+        printf("rx: %llu frames at %d Hz, %llu missed\n", (unsigned long long)rxFrames, simTasks[TASK_RX].rateHz, (unsigned long long)rxMissedFrames);
+    }
+
+    printf("%-22s %7s %8s %7s %7s %8s %8s %8s %7s\n", "task", "rate/hz", "actual", "avg/us", "load",
+        "lat/us", "p99/us", "max/us", "max age");
+    for (const simTask_t &task : simTasks) {
+        if (!task.enabled) {
+            continue;
+        }
+        const double actualHz = task.runs / simulatedS;
+        printf("%-22s %7d %8.1f %7.1f %6.1f%% %8.1f %8.0f %8.0f %7d\n", simTaskLabel(task.def),
+            1000000 / tasks[task.def->taskId].desiredPeriodUs, actualHz, task.runs ? task.totalUs / task.runs : 0.0,
+            100.0 * task.totalUs / simNowUs, task.runs ? task.latencySumUs / task.runs : 0.0,
+            simLatencyPercentileUs(&task, 0.99), task.latencyMaxUs, task.maxAgeCycles);
+    }
+
+    return 0;
+}
+
+// STUBS
+
+extern "C" {
+
+uint32_t micros(void) { return (uint64_t)simNowUs; }
+
+task_t *getTask(unsigned taskId) { return &tasks[taskId]; }
+
+bool gyroFilterReady(void)
+{
+    return pidUpdateCounter % gyroUpdateDenom == 0;
+}
+
+bool pidLoopReady(void)
+{
+    return (pidUpdateCounter % gyroUpdateDenom) == (gyroUpdateDenom / 2);
+}
+}
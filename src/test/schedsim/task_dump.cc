@@ -0,0 +1,139 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <sstream>
+
+#include "task_dump.h"
+
+static const char checkFuncPrefix[] = "RX Check Function";
+
+static std::vector<long> parseNumbers(const char *text)
+{
+    std::vector<long> numbers;
+    char *end;
+    while (*text) {
+        const long value = strtol(text, &end, 10);
+        if (end == text) {
+            text++;
+            continue;
+        }
+        numbers.push_back(value);
+        // skip the decimals of the load percentages
+        text = end;
+        if (*text == '.') {
+            strtol(text + 1, &end, 10);
+            text = end;
+        }
+    }
+    return numbers;
+}
+
+static std::string trim(const std::string &text)
+{
+    const size_t start = text.find_first_not_of(' ');
+    const size_t end = text.find_last_not_of(' ');
+    return start == std::string::npos ? "" : text.substr(start, end - start + 1);
+}
+
+const taskDumpEntry_t *TaskDump::find(const char *name, int occurrence) const
+{
+    for (const taskDumpEntry_t &task : tasks) {
+        if (task.name == name && task.occurrence == occurrence) {
+            return &task;
+        }
+    }
+    return nullptr;
+}
+
+taskDumpEntry_t *TaskDump::entry(const std::string &name, int occurrence)
+{
+    for (taskDumpEntry_t &task : tasks) {
+        if (task.name == name && task.occurrence == occurrence) {
+            return &task;
+        }
+    }
+    tasks.push_back({ name, occurrence, 0, 0, 0, {} });
+    return &tasks.back();
+}
+
+bool TaskDump::parse(const std::string &text)
+{
+    std::istringstream lines(text);
+    std::string line;
+    std::map<std::string, int> seen;
+    bool histogramList = false;
+    bool found = false;
+
+    while (std::getline(lines, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+
+        if (line.compare(0, 9, "Task list") == 0) {
+            seen.clear();
+            histogramList = line.find("p99") != std::string::npos;
+            continue;
+        }
+
+        taskDumpEntry_t *task;
+        std::vector<long> numbers;
+        const size_t open = line.find(" - (");
+        const size_t close = line.find(')');
+        if (line.compare(0, sizeof(checkFuncPrefix) - 1, checkFuncPrefix) == 0) {
+            task = &checkFunc;
+            numbers = parseNumbers(line.c_str() + sizeof(checkFuncPrefix) - 1);
+            if (!histogramList) {
+                // max/us avg/us total/ms
+                numbers.insert(numbers.begin(), 0);
+            }
+        } else if (open != std::string::npos && close != std::string::npos && close > open) {
+            const std::string name = trim(line.substr(open + 4, close - open - 4));
+            task = entry(name, seen[name]++);
+            numbers = parseNumbers(line.c_str() + close + 1);
+        } else {
+            continue;
+        }
+
+        if (histogramList) {
+            // the buckets followed by the p99 and p999 bounds
+            if (numbers.size() < 3) {
+                continue;
+            }
+            task->histogram.assign(numbers.begin(), numbers.end() - 2);
+        } else {
+            // rate/hz, then max/us and avg/us if task_statistics is on
+            if (numbers.empty()) {
+                continue;
+            }
+            task->rateHz = numbers[0];
+            if (numbers.size() >= 3) {
+                task->maxUs = numbers[1];
+                task->averageUs = numbers[2];
+            }
+        }
+        found = true;
+    }
+
+    return found;
+}
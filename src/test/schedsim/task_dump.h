@@ -0,0 +1,54 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+// Reader for the task statistics printed by the 'tasks' and 'tasks hist' CLI commands, the text of both is
+// simply pasted into one file. Tasks are identified by their name and by how often the name was seen
+// before in the same list, as the SYSTEM load and update tasks share their name and the ids depend on
+// the build.
+
+typedef struct taskDumpEntry_s {
+    std::string name;
+    int occurrence;                     // 0 for the first task of this name in a list
+    int rateHz;                         // measured, 0 if not dumped
+    int maxUs;
+    int averageUs;
+    std::vector<uint32_t> histogram;    // log2 buckets of getTaskHistogram(), empty if not dumped
+} taskDumpEntry_t;
+
+class TaskDump {
+public:
+    // Returns false if no task line was recognised in text
+    bool parse(const std::string &text);
+
+    const taskDumpEntry_t *find(const char *name, int occurrence) const;
+
+    std::vector<taskDumpEntry_t> tasks;
+    taskDumpEntry_t checkFunc = { "RX Check Function", 0, 0, 0, 0, {} };
+
+private:
+    taskDumpEntry_t *entry(const std::string &name, int occurrence);
+};
@@ -62,8 +62,8 @@ extern "C" {
     int16_t rcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
     uint16_t averageSystemLoadPercent = 0;
     uint8_t cliMode = 0;
-    uint8_t debugMode = 0;
-    int16_t debug[DEBUG16_VALUE_COUNT];
+    uint8_t debugModes[DEBUG_GROUP_COUNT];
+    int32_t debug[DEBUG_VALUE_STORAGE_COUNT];
     pidProfile_t *currentPidProfile;
     controlRateConfig_t *currentControlRateProfile;
     attitudeEulerAngles_t attitude;
@@ -74,9 +74,12 @@ extern "C" {
     rxRuntimeState_t rxRuntimeState = {};
     uint16_t GPS_distanceToHome = 0;
     int16_t GPS_directionToHome = 0;
+    int32_t GPS_homeOffsetCm[2];
+    float dTnav;
     acc_t acc = {};
     bool mockIsUpright = false;
     uint8_t activePidLoopDenom = 1;
+    uint8_t activeGyroUpdateDenom = 1;
 }
 
 uint32_t simulationFeatureFlags = 0;
@@ -1074,6 +1077,7 @@ extern "C" {
     void processRcCommand(void) {}
     void updateGpsStateForHomeAndHoldMode(void) {}
     void blackboxUpdate(timeUs_t) {}
+    void blackboxCaptureIteration(timeUs_t) {}
     void transponderUpdate(timeUs_t) {}
     void GPS_reset_home_position(void) {}
     void accStartCalibration(void) {}
@@ -1101,6 +1105,12 @@ extern "C" {
     void compassStartCalibration(void) {}
     bool compassIsCalibrationComplete(void) { return true; }
     bool isUpright(void) { return mockIsUpright; }
+    void imuPredictLevelAttitude(float) {}
+    void imuTransformVectorBodyToEarth(t_fp_vector_def *) {}
+    float sin_approx(float) { return 0.0f; }
+    float cos_approx(float) { return 0.0f; }
+    float atan2_approx(float, float) { return 0.0f; }
+    float pidGetDT(void) { return 0.0f; }
     void blackboxLogEvent(FlightLogEvent, union flightLogEventData_u *) {};
     void gyroFiltering(timeUs_t) {};
     timeDelta_t rxGetFrameDelta(timeDelta_t *) { return 0; }
@@ -0,0 +1,132 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "sensors/battery_estimator.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_CELL_COUNT 4
+#define TEST_UPDATE_US  20000   // the 50Hz battery current task
+
+// 4S LiPo with 15 mOhm per cell and a polarisation of the same resistance
+typedef struct testBattery_s {
+    float openCircuitVoltage;   // V per cell
+    float resistance;
+    float polarisationVoltage;
+} testBattery_t;
+
+static batteryEstimatorInput_t sample(testBattery_t *battery, float amperage)
+{
+    const float dT = TEST_UPDATE_US * 1e-6f;
+    battery->polarisationVoltage += (amperage * battery->resistance - battery->polarisationVoltage) * dT / 20.0f;
+
+    const float cellVoltage = battery->openCircuitVoltage - amperage * battery->resistance - battery->polarisationVoltage;
+    batteryEstimatorInput_t input = {
+        .voltage = (uint16_t)lrintf(cellVoltage * TEST_CELL_COUNT * 100),
+        .amperage = (int32_t)lrintf(amperage * 100),
+        .mAhDrawn = 0,
+        .cellCount = TEST_CELL_COUNT,
+        .capacity = 0,
+        .emptyCellVoltage = 330,
+        .fullCellVoltage = 420,
+    };
+    return input;
+}
+
+TEST(BatteryEstimatorTest, StateOfChargeFromVoltage)
+{
+    EXPECT_EQ(0, batteryEstimatorStateOfCharge(320, 330, 420));
+    EXPECT_EQ(0, batteryEstimatorStateOfCharge(330, 330, 420));
+    EXPECT_EQ(100, batteryEstimatorStateOfCharge(420, 330, 420));
+    EXPECT_EQ(100, batteryEstimatorStateOfCharge(435, 330, 420));
+
+    // the flat middle of the discharge curve
+    EXPECT_NEAR(50, batteryEstimatorStateOfCharge(384, 330, 420), 1);
+
+    // increasing over the whole range
+    uint8_t last = 0;
+    for (uint16_t cellVoltage = 330; cellVoltage <= 420; cellVoltage++) {
+        const uint8_t stateOfCharge = batteryEstimatorStateOfCharge(cellVoltage, 330, 420);
+        EXPECT_GE(stateOfCharge, last);
+        last = stateOfCharge;
+    }
+}
+
+TEST(BatteryEstimatorTest, RestingVoltageUnderLoad)
+{
+    batteryEstimator_t estimator;
+    batteryEstimatorInit(&estimator);
+    testBattery_t battery = { 3.84f, 0.015f, 0.0f };
+
+    // throttle punches of 30A for 2s
+    for (int punch = 0; punch < 30; punch++) {
+        for (int i = 0; i < 200; i++) {
+            const float amperage = i < 100 ? 30.0f : 2.0f;
+            const batteryEstimatorInput_t input = sample(&battery, amperage);
+            batteryEstimatorUpdate(&estimator, &input, TEST_UPDATE_US);
+        }
+    }
+    EXPECT_NEAR(battery.resistance, estimator.internalResistance, 0.002f);
+
+    // hovering with the voltage sagged by 0.3V, the resting voltage stays at the open circuit voltage
+    for (int i = 0; i < 500; i++) {
+        const batteryEstimatorInput_t input = sample(&battery, 20.0f);
+        batteryEstimatorUpdate(&estimator, &input, TEST_UPDATE_US);
+        if (i == 499) {
+            EXPECT_LT(input.voltage, 1536 - 100);
+        }
+    }
+    EXPECT_NEAR(1536, estimator.restingVoltage, 8);
+    EXPECT_NEAR(50, estimator.stateOfCharge, 3);
+    EXPECT_EQ(-1, estimator.timeRemainingS);
+}
+
+TEST(BatteryEstimatorTest, TimeRemainingFromCapacity)
+{
+    batteryEstimator_t estimator;
+    batteryEstimatorInit(&estimator);
+    testBattery_t battery = { 3.84f, 0.015f, 0.0f };
+
+    batteryEstimatorInput_t input = sample(&battery, 10.0f);
+    input.capacity = 1000;
+    input.mAhDrawn = 500;
+    batteryEstimatorUpdate(&estimator, &input, TEST_UPDATE_US);
+
+    EXPECT_EQ(50, estimator.stateOfCharge);
+    EXPECT_EQ(1000, estimator.averageAmperage);
+    EXPECT_EQ(180, estimator.timeRemainingS);
+
+    // more drawn than the capacity
+    input.mAhDrawn = 1200;
+    batteryEstimatorUpdate(&estimator, &input, TEST_UPDATE_US);
+    EXPECT_EQ(0, estimator.stateOfCharge);
+    EXPECT_EQ(0, estimator.timeRemainingS);
+
+    // no battery
+    input.cellCount = 0;
+    batteryEstimatorUpdate(&estimator, &input, TEST_UPDATE_US);
+    EXPECT_EQ(0, estimator.stateOfCharge);
+    EXPECT_EQ(-1, estimator.timeRemainingS);
+}
@@ -28,6 +28,7 @@
 extern "C" {
     #include "platform.h"
     #include "target.h"
+    #include "build/debug.h"
     #include "cms/cms.h"
     #include "cms/cms_types.h"
     #include "fc/rc_modes.h"
@@ -135,7 +136,7 @@ CMS_Menu cmsx_menuMain = {
     .entries = menuMainEntries,
 };
 uint8_t armingFlags;
-int16_t debug[4];
+int32_t debug[DEBUG_VALUE_STORAGE_COUNT];
 int16_t rcData[18];
 void delay(uint32_t) {}
 uint32_t micros(void) { return 0; }
@@ -62,6 +62,175 @@ TEST(FilterUnittest, TestPt1FilterApply)
     EXPECT_FLOAT_EQ(-200.08142, filter.state);
 }
 
+TEST(FilterUnittest, TestBiquadFilterCopyCoefficients)
+{
+    biquadFilter_t source;
+    biquadFilter_t filter;
+    biquadFilterInitLPF(&source, 100.0f, 125);
+    biquadFilterInitLPF(&filter, 250.0f, 125);
+    biquadFilterApplyDF1(&filter, 1.0f);
+    const float y1 = filter.y1;
+
+    biquadFilterCopyCoefficients(&filter, &source);
+
+    EXPECT_FLOAT_EQ(source.b0, filter.b0);
+    EXPECT_FLOAT_EQ(source.b1, filter.b1);
+    EXPECT_FLOAT_EQ(source.b2, filter.b2);
+    EXPECT_FLOAT_EQ(source.a1, filter.a1);
+    EXPECT_FLOAT_EQ(source.a2, filter.a2);
+    // state is kept
+    EXPECT_FLOAT_EQ(1.0f, filter.x1);
+    EXPECT_FLOAT_EQ(y1, filter.y1);
+}
+
+TEST(FilterUnittest, TestBiquadNotchCoefficients)
+{
+    biquadNotchCache_t cache;
+    biquadNotchCacheInit(&cache, 125, 3.0f);
+
+    const float frequencies[] = { 150.0f, 300.0f, 150.4f, 214.0f + BIQUAD_NOTCH_CACHE_SIZE };
+    const int count = sizeof(frequencies) / sizeof(frequencies[0]);
+    biquadNotchCoeffs_t coeffs[count];
+    biquadNotchCoefficients(&cache, frequencies, coeffs, count);
+
+    // computed for whole Hz, the same as the biquadFilterInit() notch
+    const float wholeHz[] = { 150.0f, 300.0f, 150.0f, 214.0f + BIQUAD_NOTCH_CACHE_SIZE };
+    for (int i = 0; i < count; i++) {
+        biquadFilter_t notch;
+        biquadFilterInit(&notch, wholeHz[i], 125, 3.0f, FILTER_NOTCH);
+        EXPECT_NEAR(notch.b0, coeffs[i].b0, 1e-6f);
+        EXPECT_NEAR(notch.b1, coeffs[i].a1, 1e-6f);
+        EXPECT_NEAR(notch.b2, coeffs[i].b0, 1e-6f);
+        EXPECT_NEAR(notch.a1, coeffs[i].a1, 1e-6f);
+        EXPECT_NEAR(notch.a2, coeffs[i].a2, 1e-6f);
+    }
+
+    // a frequency sharing the cache slot of another replaces it
+    const float sharedSlot = 214.0f;
+    biquadNotchCoeffs_t replaced;
+    biquadNotchCoefficients(&cache, &sharedSlot, &replaced, 1);
+    EXPECT_NE(coeffs[3].a1, replaced.a1);
+
+    // the state of a filter is kept when its coefficients are replaced
+    biquadFilter_t filter;
+    biquadFilterInit(&filter, 100.0f, 125, 3.0f, FILTER_NOTCH);
+    biquadFilterApplyDF1(&filter, 1.0f);
+    const float y1 = filter.y1;
+    biquadFilterSetNotchCoefficients(&filter, &coeffs[0]);
+    EXPECT_FLOAT_EQ(coeffs[0].b0, filter.b0);
+    EXPECT_FLOAT_EQ(coeffs[0].b0, filter.b2);
+    EXPECT_FLOAT_EQ(coeffs[0].a1, filter.b1);
+    EXPECT_FLOAT_EQ(y1, filter.y1);
+}
+
+TEST(FilterUnittest, TestPt1Filter3MatchesPt1Filter)
+{
+    const float gain = pt1FilterGain(100.0f, 0.000125f);
+    pt1Filter_t filter[XYZ_AXIS_COUNT];
+    pt1Filter3_t filter3;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        pt1FilterInit(&filter[axis], gain);
+    }
+    pt1Filter3Init(&filter3, gain);
+
+    for (int i = 0; i < 50; i++) {
+        float values[XYZ_AXIS_COUNT] = { 1800.0f, -300.0f + i * 10.0f, (i & 1) ? 50.0f : -50.0f };
+        float expected[XYZ_AXIS_COUNT];
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            expected[axis] = pt1FilterApply(&filter[axis], values[axis]);
+        }
+        pt1Filter3Apply(&filter3, values);
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            EXPECT_FLOAT_EQ(expected[axis], values[axis]);
+        }
+    }
+}
+
+TEST(FilterUnittest, TestBiquadFilter3MatchesBiquadFilter)
+{
+    biquadFilter_t filterDF1[XYZ_AXIS_COUNT];
+    biquadFilter_t filterDF2[XYZ_AXIS_COUNT];
+    biquadFilter3_t filter3DF1;
+    biquadFilter3_t filter3DF2;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        biquadFilterInitLPF(&filterDF1[axis], 100.0f, 125);
+        biquadFilterInitLPF(&filterDF2[axis], 100.0f, 125);
+    }
+    biquadFilter3InitLPF(&filter3DF1, 100.0f, 125);
+    biquadFilter3InitLPF(&filter3DF2, 100.0f, 125);
+
+    for (int i = 0; i < 50; i++) {
+        if (i == 25) {
+            // the coefficients change and the state is kept
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                biquadFilterUpdateLPF(&filterDF1[axis], 250.0f, 125);
+            }
+            biquadFilter3UpdateLPF(&filter3DF1, 250.0f, 125);
+        }
+
+        float valuesDF1[XYZ_AXIS_COUNT] = { 1800.0f, -300.0f + i * 10.0f, (i & 1) ? 50.0f : -50.0f };
+        float valuesDF2[XYZ_AXIS_COUNT] = { valuesDF1[X], valuesDF1[Y], valuesDF1[Z] };
+        float expectedDF1[XYZ_AXIS_COUNT];
+        float expectedDF2[XYZ_AXIS_COUNT];
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            expectedDF1[axis] = biquadFilterApplyDF1(&filterDF1[axis], valuesDF1[axis]);
+            expectedDF2[axis] = biquadFilterApply(&filterDF2[axis], valuesDF2[axis]);
+        }
+        biquadFilter3ApplyDF1(&filter3DF1, valuesDF1);
+        biquadFilter3Apply(&filter3DF2, valuesDF2);
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            EXPECT_FLOAT_EQ(expectedDF1[axis], valuesDF1[axis]);
+            EXPECT_FLOAT_EQ(expectedDF2[axis], valuesDF2[axis]);
+        }
+    }
+}
+
+TEST(FilterUnittest, TestFilterCascade3MatchesFilterChain)
+{
+    const float gain = pt1FilterGain(100.0f, 0.000125f);
+    pt1Filter_t pt1[XYZ_AXIS_COUNT];
+    biquadFilter_t biquad[XYZ_AXIS_COUNT];
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        pt1FilterInit(&pt1[axis], gain);
+        biquadFilterInitLPF(&biquad[axis], 150.0f, 125);
+    }
+
+    filterCascade3_t cascade;
+    filterCascade3Init(&cascade);
+    EXPECT_EQ(0, filterCascade3AddPt1(&cascade, gain));
+    EXPECT_EQ(1, filterCascade3AddBiquadLPF(&cascade, 150.0f, 125));
+    EXPECT_EQ(2, filterCascade3AddPt1(&cascade, gain));
+    EXPECT_EQ(-1, filterCascade3AddPt1(&cascade, gain));
+    cascade.sectionCount = 2;
+
+    for (int i = 0; i < 50; i++) {
+        if (i == 25) {
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                pt1FilterUpdateCutoff(&pt1[axis], pt1FilterGain(200.0f, 0.000125f));
+            }
+            filterCascade3UpdatePt1(&cascade, 0, pt1FilterGain(200.0f, 0.000125f));
+        }
+
+        float values[XYZ_AXIS_COUNT] = { 1800.0f, -300.0f + i * 10.0f, (i & 1) ? 50.0f : -50.0f };
+        float expected[XYZ_AXIS_COUNT];
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            expected[axis] = biquadFilterApplyDF1(&biquad[axis], pt1FilterApply(&pt1[axis], values[axis]));
+        }
+        filterCascade3Apply(&cascade, values);
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            EXPECT_NEAR(expected[axis], values[axis], 0.01f);
+        }
+    }
+
+    // an empty cascade passes the values through
+    filterCascade3Init(&cascade);
+    float values[XYZ_AXIS_COUNT] = { 1.0f, 2.0f, 3.0f };
+    filterCascade3Apply(&cascade, values);
+    EXPECT_FLOAT_EQ(1.0f, values[X]);
+    EXPECT_FLOAT_EQ(2.0f, values[Y]);
+    EXPECT_FLOAT_EQ(3.0f, values[Z]);
+}
+
 TEST(FilterUnittest, TestSlewFilterInit)
 {
     slewFilter_t filter;
@@ -114,3 +283,45 @@ TEST(FilterUnittest, TestSlewFilter)
     slewFilterApply(&filter, 200.0f);
     EXPECT_EQ(200, filter.state);
 }
+
+TEST(FilterUnittest, TestFirDecimator)
+{
+    const uint8_t factor = 4;
+    float coeffs[FIR_DECIMATOR_MAX_FACTOR * FIR_DECIMATOR_TAPS_PER_PHASE];
+    firDecimatorInitCoeffs(coeffs, factor);
+
+    firDecimator_t filter;
+    firDecimatorInit(&filter, coeffs, factor);
+
+    // one output for every factor inputs, and unity gain at DC once the taps are filled
+    float output = 0.0f;
+    int outputs = 0;
+    for (int i = 0; i < factor * FIR_DECIMATOR_TAPS_PER_PHASE * 2; i++) {
+        const bool ready = firDecimatorApply(&filter, 100.0f, &output);
+        EXPECT_EQ((i % factor) == factor - 1, ready);
+        outputs += ready;
+    }
+    EXPECT_EQ(FIR_DECIMATOR_TAPS_PER_PHASE * 2, outputs);
+    EXPECT_NEAR(100.0f, output, 0.01f);
+
+    // a tone at the input Nyquist frequency is removed
+    firDecimatorInit(&filter, coeffs, factor);
+    float maxOutput = 0.0f;
+    for (int i = 0; i < factor * FIR_DECIMATOR_TAPS_PER_PHASE * 4; i++) {
+        if (firDecimatorApply(&filter, (i & 1) ? 100.0f : -100.0f, &output) && i >= factor * FIR_DECIMATOR_TAPS_PER_PHASE) {
+            maxOutput = fmaxf(maxOutput, fabsf(output));
+        }
+    }
+    EXPECT_GT(1.0f, maxOutput);
+
+    // a tone at a quarter of the output rate passes
+    firDecimatorInit(&filter, coeffs, factor);
+    maxOutput = 0.0f;
+    for (int i = 0; i < factor * FIR_DECIMATOR_TAPS_PER_PHASE * 8; i++) {
+        const float input = 100.0f * sinf(2.0f * M_PI * i / (factor * 4));
+        if (firDecimatorApply(&filter, input, &output) && i >= factor * FIR_DECIMATOR_TAPS_PER_PHASE) {
+            maxOutput = fmaxf(maxOutput, fabsf(output));
+        }
+    }
+    EXPECT_NEAR(100.0f, maxOutput, 10.0f);
+}
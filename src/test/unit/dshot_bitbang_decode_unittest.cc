@@ -0,0 +1,153 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "drivers/dshot.h"
+    #include "drivers/dshot_bitbang_decode.h"
+
+    dshotTelemetryState_t dshotTelemetryState;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define BUFFER_LENGTH 140
+#define IDLE_SAMPLES 6
+
+// 4b/5b GCR encoding used by bidirectional DShot telemetry
+static const uint8_t gcrEncode[16] = {
+    0x19, 0x1b, 0x12, 0x13, 0x1d, 0x15, 0x16, 0x17,
+    0x1a, 0x09, 0x0a, 0x0b, 0x1e, 0x0d, 0x0e, 0x0f
+};
+
+// Build the 21 bit telemetry frame for an eeem mmmm mmmm period value, a 1 marks a level transition
+static uint32_t telemetryFrame(uint16_t period)
+{
+    const uint16_t csum = ~(period ^ (period >> 4) ^ (period >> 8)) & 0xf;
+    const uint16_t value = (period << 4) | csum;
+
+    uint32_t gcr = 0;
+    for (int nibble = 3; nibble >= 0; nibble--) {
+        gcr = (gcr << 5) | gcrEncode[(value >> (nibble * 4)) & 0xf];
+    }
+
+    return (1 << 20) | gcr;
+}
+
+// Add the 3x oversampled, idle high waveform of a frame on one pin of the port buffer
+static void addFrame(uint16_t buffer[], int pin, uint32_t frame, int delaySamples)
+{
+    int level = 1;
+    int sample = 0;
+
+    for (; sample < delaySamples; sample++) {
+        buffer[sample] |= level << pin;
+    }
+    for (int bit = 20; bit >= 0; bit--) {
+        if (frame & (1 << bit)) {
+            level = !level;
+        }
+        for (int i = 0; i < 3; i++, sample++) {
+            buffer[sample] |= level << pin;
+        }
+    }
+    for (; sample < BUFFER_LENGTH; sample++) {
+        buffer[sample] |= 1 << pin;
+    }
+}
+
+TEST(DshotBitbangDecodeTest, DecodesAllPinsOfPort)
+{
+    // given
+    uint16_t buffer[BUFFER_LENGTH];
+    memset(buffer, 0, sizeof(buffer));
+
+    const uint16_t periods[] = { 0x100, 0x2ff, 0x480, 0x7a3 };
+    const int pinsUsed[] = { 0, 3, 7, 12 };
+
+    uint16_t pinMask = 0;
+    for (unsigned i = 0; i < ARRAYLEN(pinsUsed); i++) {
+        addFrame(buffer, pinsUsed[i], telemetryFrame(periods[i]), IDLE_SAMPLES + i * 2);
+        pinMask |= 1 << pinsUsed[i];
+    }
+
+    // when
+    uint32_t values[16];
+    decode_bb_port(buffer, BUFFER_LENGTH, pinMask, values);
+
+    // then
+    for (unsigned i = 0; i < ARRAYLEN(pinsUsed); i++) {
+        EXPECT_EQ((uint32_t)periods[i], values[pinsUsed[i]]);
+        EXPECT_EQ(decode_bb(buffer, BUFFER_LENGTH, pinsUsed[i]), values[pinsUsed[i]]);
+    }
+}
+
+TEST(DshotBitbangDecodeTest, ReportsPinsWithoutTelemetry)
+{
+    // given
+    uint16_t buffer[BUFFER_LENGTH];
+    memset(buffer, 0, sizeof(buffer));
+
+    // pin 1 carries a frame, pin 2 stays idle high
+    addFrame(buffer, 1, telemetryFrame(0x234), IDLE_SAMPLES);
+    for (int i = 0; i < BUFFER_LENGTH; i++) {
+        buffer[i] |= 1 << 2;
+    }
+
+    // when
+    uint32_t values[16];
+    decode_bb_port(buffer, BUFFER_LENGTH, (1 << 1) | (1 << 2), values);
+
+    // then
+    EXPECT_EQ(0x234u, values[1]);
+    EXPECT_EQ((uint32_t)BB_NOEDGE, values[2]);
+}
+
+TEST(DshotBitbangDecodeTest, MatchesSinglePinDecoder)
+{
+    // Corrupted frames must be classified the same way as decode_bb() does
+    srand(42);
+
+    for (int run = 0; run < 1000; run++) {
+        uint16_t buffer[BUFFER_LENGTH];
+        memset(buffer, 0, sizeof(buffer));
+
+        for (int pin = 0; pin < 4; pin++) {
+            addFrame(buffer, pin, telemetryFrame(rand() & 0xfff), IDLE_SAMPLES + rand() % 8);
+        }
+        // flip a few random samples
+        for (int i = 0; i < 3; i++) {
+            buffer[rand() % BUFFER_LENGTH] ^= 1 << (rand() % 4);
+        }
+
+        uint32_t values[16];
+        decode_bb_port(buffer, BUFFER_LENGTH, 0x000f, values);
+
+        for (int pin = 0; pin < 4; pin++) {
+            EXPECT_EQ(decode_bb(buffer, BUFFER_LENGTH, pin), values[pin]);
+        }
+    }
+}
@@ -78,6 +78,33 @@ TEST(EncodingTest, FloatToIntEncodingTest)
     }
 }
 
+TEST(EncodingTest, Unpack11BitChannelsTest)
+{
+    // given
+    uint8_t packed[22];
+    uint32_t seed = 0x12345678;
+    for (int round = 0; round < 100; round++) {
+        for (unsigned i = 0; i < sizeof(packed); i++) {
+            seed = seed * 1103515245 + 12345;
+            packed[i] = seed >> 16;
+        }
+
+        // when
+        uint16_t channels[16];
+        unpackChannels11Bit(channels, packed);
+
+        // then
+        for (int ch = 0; ch < 16; ch++) {
+            uint16_t expected = 0;
+            for (int bit = 0; bit < 11; bit++) {
+                const int pos = ch * 11 + bit;
+                expected |= ((packed[pos / 8] >> (pos % 8)) & 1) << bit;
+            }
+            EXPECT_EQ(expected, channels[ch]);
+        }
+    }
+}
+
 // STUBS
 
 extern "C" {
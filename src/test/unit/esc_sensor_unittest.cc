@@ -0,0 +1,201 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+    #include "config/feature.h"
+    #include "drivers/dshot.h"
+    #include "drivers/dshot_dpwm.h"
+    #include "drivers/motor.h"
+    #include "drivers/serial.h"
+    #include "flight/mixer.h"
+    #include "io/serial.h"
+    #include "pg/motor.h"
+    #include "sensors/esc_sensor.h"
+
+    PG_REGISTER(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 0);
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_MOTOR_COUNT 4
+#define TEST_FRAME_SIZE 10
+
+extern "C" {
+    static uint8_t motorCount = TEST_MOTOR_COUNT;
+    static motorDmaOutput_t dmaMotors[MAX_SUPPORTED_MOTORS];
+    static serialPort_t escSerialPort;
+    static serialPortConfig_t escSerialPortConfig;
+    static serialReceiveCallbackPtr escSerialReceive;
+
+    bool featureIsEnabled(uint32_t) { return true; }
+    uint8_t getMotorCount(void) { return motorCount; }
+    bool motorIsEnabled(void) { return true; }
+    motorDmaOutput_t *getMotorDmaOutput(uint8_t index) { return &dmaMotors[index]; }
+
+    const serialPortConfig_t *findSerialPortConfig(serialPortFunction_e) { return &escSerialPortConfig; }
+    serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr callback,
+        void *, uint32_t, portMode_e, portOptions_e)
+    {
+        escSerialReceive = callback;
+        return &escSerialPort;
+    }
+}
+
+static const timeUs_t startTimeUs = 6000000;   // after ESC_BOOTTIME
+
+// Returns the motor the telemetry request is pending for, -1 if none or more than one
+static int requestedMotor(void)
+{
+    int motor = -1;
+    for (int i = 0; i < motorCount; i++) {
+        if (dmaMotors[i].protocolControl.requestTelemetry) {
+            if (motor >= 0) {
+                return -1;
+            }
+            motor = i;
+        }
+    }
+    return motor;
+}
+
+// The DShot frame carrying the request clears the flag, the ESC replies over the serial line
+static void replyFrame(int motor, uint8_t temperature)
+{
+    dmaMotors[motor].protocolControl.requestTelemetry = false;
+
+    uint8_t frame[TEST_FRAME_SIZE] = { temperature, 0x06, 0x40, 0, 0x20, 0, 0x10, 0x01, 0x00 };
+    frame[TEST_FRAME_SIZE - 1] = calculateCrc8(frame, TEST_FRAME_SIZE - 1);
+    for (int i = 0; i < TEST_FRAME_SIZE; i++) {
+        escSerialReceive(frame[i], NULL);
+    }
+}
+
+static void initEscSensor(uint8_t count)
+{
+    motorCount = count;
+    motorConfigMutable()->motorPoleCount = 14;
+    memset(dmaMotors, 0, sizeof(dmaMotors));
+    EXPECT_TRUE(escSensorInit());
+
+    // the first call after the boot time leaves the startup state, the second makes the first request
+    escSensorProcess(startTimeUs);
+    escSensorProcess(startTimeUs + 10000);
+}
+
+TEST(EscSensorTest, RequestsBackToBack)
+{
+    initEscSensor(TEST_MOTOR_COUNT);
+    timeUs_t timeUs = startTimeUs + 10000;
+
+    // the motors are asked in turn, the next request is made as soon as a frame arrives
+    const int firstMotor = requestedMotor();
+    ASSERT_GE(firstMotor, 0);
+    for (int request = 0; request < 3 * TEST_MOTOR_COUNT; request++) {
+        const int motor = (firstMotor + request) % TEST_MOTOR_COUNT;
+        EXPECT_EQ(motor, requestedMotor());
+        EXPECT_FALSE(escSensorCheck(timeUs, 0));
+        timeUs += 1000;
+        replyFrame(motor, 30 + motor);
+        EXPECT_TRUE(escSensorCheck(timeUs, 0));
+        escSensorProcess(timeUs);
+        EXPECT_EQ(0, getEscSensorData(motor)->dataAge);
+        EXPECT_EQ(30 + motor, getEscSensorData(motor)->temperature);
+        EXPECT_EQ(0x0640, getEscSensorData(motor)->voltage);
+    }
+}
+
+TEST(EscSensorTest, TimeoutDoesNotStallOtherMotors)
+{
+    initEscSensor(TEST_MOTOR_COUNT);
+    timeUs_t timeUs = startTimeUs + 10000;
+
+    // all motors reply once, which sets their reply timeouts to the minimum of 3ms
+    for (int motor = 0; motor < TEST_MOTOR_COUNT; motor++) {
+        timeUs += 1000;
+        replyFrame(requestedMotor(), 30);
+        escSensorProcess(timeUs);
+    }
+
+    // the next motor stops replying
+    const int silentMotor = requestedMotor();
+    ASSERT_GE(silentMotor, 0);
+    timeUs += 2900;
+    EXPECT_FALSE(escSensorCheck(timeUs, 0));
+    timeUs += 100;
+    EXPECT_TRUE(escSensorCheck(timeUs, 0));
+    escSensorProcess(timeUs);
+    EXPECT_EQ(1, getEscSensorData(silentMotor)->dataAge);
+
+    // the others are served while it waits to be retried
+    dmaMotors[silentMotor].protocolControl.requestTelemetry = false;
+    int replies[TEST_MOTOR_COUNT] = { 0 };
+    const timeUs_t retryUs = timeUs + 10000;
+    while (cmpTimeUs(retryUs, timeUs) > 0) {
+        const int motor = requestedMotor();
+        ASSERT_GE(motor, 0);
+        ASSERT_NE(silentMotor, motor);
+        timeUs += 1000;
+        replyFrame(motor, 30);
+        escSensorProcess(timeUs);
+        replies[motor]++;
+    }
+    for (int motor = 0; motor < TEST_MOTOR_COUNT; motor++) {
+        if (motor != silentMotor) {
+            EXPECT_GE(replies[motor], 3);
+        }
+    }
+
+    // after the retry delay its data is the oldest and it is asked first
+    EXPECT_EQ(silentMotor, requestedMotor());
+    timeUs += 1000;
+    replyFrame(silentMotor, 40);
+    escSensorProcess(timeUs);
+    EXPECT_EQ(0, getEscSensorData(silentMotor)->dataAge);
+    EXPECT_EQ(40, getEscSensorData(silentMotor)->temperature);
+}
+
+TEST(EscSensorTest, CrcErrorMovesOn)
+{
+    initEscSensor(2);
+    timeUs_t timeUs = startTimeUs + 10000;
+
+    const int motor = requestedMotor();
+    ASSERT_GE(motor, 0);
+    dmaMotors[motor].protocolControl.requestTelemetry = false;
+    for (int i = 0; i < TEST_FRAME_SIZE; i++) {
+        escSerialReceive(i, NULL);
+    }
+    timeUs += 1000;
+    escSensorProcess(timeUs);
+    EXPECT_EQ(ESC_DATA_INVALID, getEscSensorData(motor)->dataAge);
+    EXPECT_EQ(1 - motor, requestedMotor());
+}
+
+// STUBS
+
+extern "C" {
+    uint8_t debugMode;
+    int32_t debug[DEBUG_VALUE_STORAGE_COUNT];
+    uint8_t armingFlags;
+}
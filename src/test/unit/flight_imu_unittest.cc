@@ -199,6 +199,37 @@ TEST(FlightImuTest, TestSmallAngle)
     EXPECT_FALSE(isUpright());
 }
 
+TEST(FlightImuTest, TestLevelPredict)
+{
+    // given
+    imuConfigMutable()->level_predict = true;
+    imuConfigure(0, 0);
+    attitudeIsEstablished = true;
+    attitude.values.roll = 0;
+    attitude.values.pitch = 0;
+    gyro.gyroADCf[FD_ROLL] = 100.0f;
+    gyro.gyroADCf[FD_PITCH] = -50.0f;
+
+    // when not in a level mode
+    imuPredictLevelAttitude(0.01f);
+
+    // expect
+    EXPECT_EQ(0, attitude.values.roll);
+    EXPECT_EQ(0, attitude.values.pitch);
+
+    // when
+    enableFlightMode(ANGLE_MODE);
+    imuPredictLevelAttitude(0.01f);
+
+    // expect
+    EXPECT_EQ(10, attitude.values.roll);
+    EXPECT_EQ(-5, attitude.values.pitch);
+
+    disableFlightMode(ANGLE_MODE);
+    imuConfigMutable()->level_predict = false;
+    imuConfigure(0, 0);
+}
+
 // STUBS
 
 extern "C" {
@@ -213,8 +244,8 @@ mag_t mag;
 gpsSolutionData_t gpsSol;
 int16_t GPS_verticalSpeedInCmS;
 
-uint8_t debugMode;
-int16_t debug[DEBUG16_VALUE_COUNT];
+uint8_t debugModes[DEBUG_GROUP_COUNT];
+int32_t debug[DEBUG_VALUE_STORAGE_COUNT];
 
 uint8_t stateFlags;
 uint16_t flightModeFlags;
@@ -246,6 +277,7 @@ void performBaroCalibrationCycle(void) {}
 int32_t baroCalculateAltitude(void) { return 0; }
 bool gyroGetAccumulationAverage(float *) { return false; }
 bool accGetAccumulationAverage(float *) { return false; }
+void accSetRequiredRate(accConsumer_e, uint16_t) {}
 void mixerSetThrottleAngleCorrection(int) {};
 bool gpsRescueIsRunning(void) { return false; }
 bool isFixedWing(void) { return false; }
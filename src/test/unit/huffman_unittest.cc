@@ -16,6 +16,7 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 
 extern "C" {
     #include "common/huffman.h"
@@ -319,7 +320,7 @@ void huffmanInitDecodeLenIndex(void)
     }
 }
 
-int huffmanDecodeBuf(uint8_t *outBuf, int outBufLen, const uint8_t *inBuf, int inBufLen, int inBufCharacterCount, const huffmanTree_t *huffmanTree)
+int huffmanDecodeBufTree(uint8_t *outBuf, int outBufLen, const uint8_t *inBuf, int inBufLen, int inBufCharacterCount, const huffmanTree_t *huffmanTree)
 {
     static bool initialized = false;
     if (!initialized) {
@@ -510,7 +511,7 @@ TEST(HuffmanUnittest, TestHuffmanDecode)
     #define HUFF_BUF_LEN1 1
     #define HUFF_BUF_COUNT1 1
     const uint8_t inBuf1[HUFF_BUF_LEN1] = {0xc0}; // 11
-    len = huffmanDecodeBuf(outBuf, OUTBUF_LEN, inBuf1, HUFF_BUF_LEN1, HUFF_BUF_COUNT1, huffmanTree);
+    len = huffmanDecodeBufTree(outBuf, OUTBUF_LEN, inBuf1, HUFF_BUF_LEN1, HUFF_BUF_COUNT1, huffmanTree);
     EXPECT_EQ(1, len);
     EXPECT_EQ(0x00, (int)outBuf[0]);
     EXPECT_EQ(-1, huffManLenIndex[0]);
@@ -525,7 +526,7 @@ TEST(HuffmanUnittest, TestHuffmanDecode)
     #define HUFF_BUF_LEN2 1
     #define HUFF_BUF_COUNT2 3
     const uint8_t inBuf2[HUFF_BUF_LEN2] = {0xed}; // 11 101 101
-    len = huffmanDecodeBuf(outBuf, OUTBUF_LEN, inBuf2, HUFF_BUF_LEN2, HUFF_BUF_COUNT2, huffmanTree);
+    len = huffmanDecodeBufTree(outBuf, OUTBUF_LEN, inBuf2, HUFF_BUF_LEN2, HUFF_BUF_COUNT2, huffmanTree);
     EXPECT_EQ(3, len);
     EXPECT_EQ(0x00, (int)outBuf[0]);
     EXPECT_EQ(0x01, (int)outBuf[1]);
@@ -534,7 +535,7 @@ TEST(HuffmanUnittest, TestHuffmanDecode)
     #define HUFF_BUF_LEN3 5
     #define HUFF_BUF_COUNT3 8
     const uint8_t inBuf3[HUFF_BUF_LEN3] = {0xec, 0xc6, 0x0e, 0xb8, 0xd8};
-    len = huffmanDecodeBuf(outBuf, OUTBUF_LEN, inBuf3, HUFF_BUF_LEN3, HUFF_BUF_COUNT3, huffmanTree);
+    len = huffmanDecodeBufTree(outBuf, OUTBUF_LEN, inBuf3, HUFF_BUF_LEN3, HUFF_BUF_COUNT3, huffmanTree);
     EXPECT_EQ(8, len);
     EXPECT_EQ(0x00, (int)outBuf[0]);
     EXPECT_EQ(0x01, (int)outBuf[1]);
@@ -546,6 +547,74 @@ TEST(HuffmanUnittest, TestHuffmanDecode)
     EXPECT_EQ(0x07, (int)outBuf[7]);
 }
 
+TEST(HuffmanUnittest, TestHuffmanEncodeOverflow)
+{
+    const uint8_t inBuf[4] = {0,1,2,3};
+    // 11 101 1001 10001 needs 2 bytes
+    EXPECT_EQ(2, huffmanEncodeBuf(outBuf, 2, inBuf, 4, huffmanTable));
+    EXPECT_EQ(-1, huffmanEncodeBuf(outBuf, 1, inBuf, 4, huffmanTable));
+
+    // 11 101 101 fills the byte exactly
+    const uint8_t inBufFull[3] = {0,1,1};
+    EXPECT_EQ(1, huffmanEncodeBuf(outBuf, 1, inBufFull, 3, huffmanTable));
+    EXPECT_EQ(0xed, (int)outBuf[0]);
+
+    // a failed call leaves the streaming state as it was
+    huffmanState_t state = {
+        .bytesWritten = 0,
+        .outByte = outBuf,
+        .outBufLen = 1,
+        .outBit = 0x80,
+    };
+    *state.outByte = 0;
+    EXPECT_EQ(0, huffmanEncodeBufStreaming(&state, inBuf, 2, huffmanTable));
+    EXPECT_EQ(-1, huffmanEncodeBufStreaming(&state, inBuf + 2, 2, huffmanTable));
+    EXPECT_EQ(0, state.bytesWritten);
+    EXPECT_EQ(0x04, state.outBit);
+    EXPECT_EQ(0xe8, (int)outBuf[0]);
+}
+
+TEST(HuffmanUnittest, TestHuffmanDecodeTable)
+{
+    static huffmanDecodeTable_t decodeTable;
+    huffmanInitDecodeTable(&decodeTable, huffmanTable);
+
+    const uint8_t inBuf3[5] = {0xec, 0xc6, 0x0e, 0xb8, 0xd8};
+    int len = huffmanDecodeBuf(outBuf, OUTBUF_LEN, inBuf3, 5, 8, &decodeTable);
+    EXPECT_EQ(8, len);
+    for (int ii = 0; ii < 8; ++ii) {
+        EXPECT_EQ(ii, (int)outBuf[ii]);
+    }
+
+    // every character round trips, encoded in chunks and decoded by both decoders
+    uint8_t inBuf[256];
+    for (int ii = 0; ii < 256; ++ii) {
+        inBuf[ii] = (ii * 37) & 0xff;
+    }
+    static uint8_t compressed[512];
+    huffmanState_t state = {
+        .bytesWritten = 0,
+        .outByte = compressed,
+        .outBufLen = sizeof(compressed),
+        .outBit = 0x80,
+    };
+    *state.outByte = 0;
+    for (int ii = 0; ii < 256; ii += 7) {
+        EXPECT_EQ(0, huffmanEncodeBufStreaming(&state, inBuf + ii, ii + 7 > 256 ? 256 - ii : 7, huffmanTable));
+    }
+    const int compressedLen = state.bytesWritten + (state.outBit != 0x80 ? 1 : 0);
+
+    static uint8_t decoded[256];
+    EXPECT_EQ(256, huffmanDecodeBuf(decoded, sizeof(decoded), compressed, compressedLen, 256, &decodeTable));
+    EXPECT_EQ(0, memcmp(inBuf, decoded, sizeof(inBuf)));
+    memset(decoded, 0, sizeof(decoded));
+    EXPECT_EQ(256, huffmanDecodeBufTree(decoded, sizeof(decoded), compressed, compressedLen, 256, huffmanTree));
+    EXPECT_EQ(0, memcmp(inBuf, decoded, sizeof(inBuf)));
+
+    // input ending inside a code
+    EXPECT_EQ(-1, huffmanDecodeBuf(decoded, sizeof(decoded), compressed, compressedLen - 1, 256, &decodeTable));
+}
+
 // STUBS
 
 extern "C" {
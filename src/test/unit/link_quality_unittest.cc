@@ -61,6 +61,8 @@ extern "C" {
 
     #include "rx/rx.h"
 
+    #include "scheduler/scheduler.h"
+
     #include "sensors/battery.h"
 
     attitudeEulerAngles_t attitude;
@@ -85,7 +87,7 @@ extern "C" {
 
     timeUs_t simulationTime = 0;
 
-    void osdRefresh(timeUs_t currentTimeUs);
+    bool osdRefresh(timeUs_t currentTimeUs);
     uint16_t updateLinkQualitySamples(uint16_t value);
 #define LINK_QUALITY_SAMPLE_COUNT 16
 }
@@ -100,8 +102,8 @@ extern "C" {
     PG_REGISTER(flight3DConfig_t, flight3DConfig, PG_MOTOR_3D_CONFIG, 0);
 
     boxBitmask_t rcModeActivationMask;
-    int16_t debug[DEBUG16_VALUE_COUNT];
-    uint8_t debugMode = 0;
+    int32_t debug[DEBUG_VALUE_STORAGE_COUNT];
+    uint8_t debugModes[DEBUG_GROUP_COUNT];
 
     uint16_t updateLinkQualitySamples(uint16_t value);
 
@@ -410,6 +412,8 @@ extern "C" {
         return micros();
     }
 
+    void schedulerSetFollowUpTask(taskId_e) {}
+
     uint32_t millis() {
         return micros() / 1000;
     }
@@ -425,6 +429,7 @@ extern "C" {
     uint16_t getBatteryAverageCellVoltage() { return  420; }
     int32_t getAmperage() { return 0; }
     int32_t getMAhDrawn() { return 0; }
+    int32_t getBatteryAverageAmperage() { return 0; }
     int32_t getEstimatedAltitudeCm() { return 0; }
     int32_t getEstimatedVario() { return 0; }
     int32_t blackboxGetLogNumber() { return 0; }
@@ -553,4 +558,6 @@ extern "C" {
     float getMotorOutputLow(void) { return 1000.0; }
 
     float getMotorOutputHigh(void) { return 2047.0; }
+
+    void accSetRequiredRate(accConsumer_e, uint16_t) {}
 }
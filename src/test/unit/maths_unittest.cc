@@ -225,6 +225,69 @@ TEST(MathsUnittest, TestRotateVectorAroundAxis)
     expectVectorsAreEqual(&vector, &expected_result, 1e-5);
 }
 
+// The sorting networks are checked against the middle of a plain sort
+static int32_t referenceMedian(const int32_t *v, int n)
+{
+    int32_t sorted[9];
+    for (int i = 0; i < n; i++) {
+        sorted[i] = v[i];
+    }
+    for (int i = 1; i < n; i++) {
+        for (int j = i; j > 0 && sorted[j - 1] > sorted[j]; j--) {
+            const int32_t temp = sorted[j];
+            sorted[j] = sorted[j - 1];
+            sorted[j - 1] = temp;
+        }
+    }
+    return sorted[n / 2];
+}
+
+static void testMedian(int n, int32_t (*median)(int32_t *), float (*medianf)(float *))
+{
+    // pseudo random values from a small range, so that equal values come up often
+    uint32_t seed = 1;
+    for (int round = 0; round < 5040; round++) {
+        int32_t v[9];
+        float vf[9];
+        for (int i = 0; i < n; i++) {
+            seed = seed * 1103515245 + 12345;
+            v[i] = (seed >> 16) % (round & 1 ? n : 3) - 1;
+            vf[i] = v[i] * 0.5f;
+        }
+        const int32_t expected = referenceMedian(v, n);
+        EXPECT_EQ(expected, median(v));
+        EXPECT_FLOAT_EQ(expected * 0.5f, medianf(vf));
+    }
+}
+
+TEST(MathsUnittest, TestQuickMedianFilter)
+{
+    testMedian(3, quickMedianFilter3, quickMedianFilter3f);
+    testMedian(5, quickMedianFilter5, quickMedianFilter5f);
+    testMedian(7, quickMedianFilter7, quickMedianFilter7f);
+    testMedian(9, quickMedianFilter9, quickMedianFilter9f);
+}
+
+TEST(MathsUnittest, TestMovingSum)
+{
+    int16_t buf[4];
+    movingSum_t movingSum;
+    movingSumInit(&movingSum, buf, 4);
+
+    // the window starts out as zeros
+    EXPECT_EQ(10, movingSumUpdate(&movingSum, 10));
+    EXPECT_EQ(30, movingSumUpdate(&movingSum, 20));
+    EXPECT_EQ(60, movingSumUpdate(&movingSum, 30));
+    EXPECT_FALSE(movingSum.primed);
+    EXPECT_EQ(100, movingSumUpdate(&movingSum, 40));
+    EXPECT_TRUE(movingSum.primed);
+
+    // then the oldest sample drops out
+    EXPECT_EQ(90, movingSumUpdate(&movingSum, 0));
+    EXPECT_EQ(-30, movingSumUpdate(&movingSum, -100));
+    EXPECT_EQ(-30 - 30 + 1000, movingSumUpdate(&movingSum, 1000));
+}
+
 #if defined(FAST_MATH) || defined(VERY_FAST_MATH)
 TEST(MathsUnittest, TestFastTrigonometrySinCos)
 {
@@ -247,6 +310,21 @@ TEST(MathsUnittest, TestFastTrigonometrySinCos)
     EXPECT_LE(cosError, 3.5e-6);
 }
 
+TEST(MathsUnittest, TestFastTrigonometrySinCosCombined)
+{
+    double sinError = 0;
+    double cosError = 0;
+    for (float x = -10 * M_PI; x < 10 * M_PI; x += M_PI / 300) {
+        float sinResult, cosResult;
+        sin_cos_approx(x, &sinResult, &cosResult);
+        sinError = MAX(sinError, fabs(sinResult - sinf(x)));
+        cosError = MAX(cosError, fabs(cosResult - cosf(x)));
+    }
+    printf("sin_cos_approx maximum absolute error = %e (sin), %e (cos)\n", sinError, cosError);
+    EXPECT_LE(sinError, 3e-6);
+    EXPECT_LE(cosError, 3.5e-6);
+}
+
 TEST(MathsUnittest, TestFastTrigonometryATan2)
 {
     double error = 0;
@@ -272,4 +350,21 @@ TEST(MathsUnittest, TestFastTrigonometryACos)
     printf("acos_approx maximum absolute error = %e rads (%e degree)\n", error, error / M_PI * 180.0f);
     EXPECT_LE(error, 1e-4);
 }
+
+TEST(MathsUnittest, TestFastExpLog)
+{
+    double expError = 0;
+    for (float x = -10.0f; x < 10.0f; x += 0.01f) {
+        expError = MAX(expError, fabs(exp_approx(x) / expf(x) - 1.0f));
+    }
+    printf("exp_approx maximum relative error = %e\n", expError);
+    EXPECT_LE(expError, 1e-5);
+
+    double logError = 0;
+    for (float x = 0.001f; x < 1000.0f; x *= 1.01f) {
+        logError = MAX(logError, fabs(log_approx(x) - logf(x)));
+    }
+    printf("log_approx maximum absolute error = %e\n", logError);
+    EXPECT_LE(logError, 2e-5);
+}
 #endif
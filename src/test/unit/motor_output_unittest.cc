@@ -19,9 +19,12 @@
  */
 
 #include <stdint.h>
+#include <math.h>
 #include <iostream>
 
 extern "C" {
+    #include "common/utils.h"
+
     #include "drivers/dshot.h"
 }
 
@@ -77,3 +80,59 @@ TEST(MotorOutputUnittest, TestFixMotorOutputReordering)
     validateAndfixMotorOutputReordering(a9_initial, size);
     EXPECT_TRUE( 0 == memcmp(a9_expected, a9_initial, sizeof(a9_expected)));
 }
+
+// Timer clocks feeding the bitbang pacer timers (TIM1/TIM8) on the supported MCUs
+static const uint32_t pacerTimerClocks[] = {
+    168000000,  // F405
+    170000000,  // G474
+    216000000,  // F7x2, F7x5
+    200000000,  // H743 at 400MHz
+    240000000,  // H743 at 480MHz
+    275000000,  // H723 at 550MHz
+};
+
+// DShot150 .. DShot1200 symbol rates [symbol/sec]
+static const uint32_t dshotSymbolRates[] = { 150000, 300000, 600000, 1200000 };
+
+TEST(MotorOutputUnittest, TestDshotPacerPeriodAccuracy)
+{
+    for (unsigned i = 0; i < ARRAYLEN(pacerTimerClocks); i++) {
+        for (unsigned j = 0; j < ARRAYLEN(dshotSymbolRates); j++) {
+            // bitbang uses 3 states per symbol
+            const uint32_t stateRate = dshotSymbolRates[j] * 3;
+
+            const uint32_t period = dshotPacerPeriod(pacerTimerClocks[i], stateRate);
+            const float error = fabsf((float)pacerTimerClocks[i] / period - stateRate) / stateRate;
+
+            EXPECT_LT(error, 0.01f) << "timer clock " << pacerTimerClocks[i] << " symbol rate " << dshotSymbolRates[j];
+        }
+    }
+}
+
+TEST(MotorOutputUnittest, TestDshotPacerPeriodRounding)
+{
+    // DShot1200 on an F405: 46.67 ticks per state
+    EXPECT_EQ(47u, dshotPacerPeriod(168000000, 3600000));
+    // exact divisions are unchanged
+    EXPECT_EQ(120u, dshotPacerPeriod(216000000, 1800000));
+}
+
+TEST(MotorOutputUnittest, TestDshotFrameInterval)
+{
+    // DShot frame of 17 symbol times as computed by the bitbang driver
+    const uint32_t dshot300FrameUs = 1000000 * 17 / 300000;
+    const uint32_t dshot600FrameUs = 1000000 * 17 / 600000;
+    const uint32_t dshot1200FrameUs = 1000000 * 17 / 1200000;
+
+    // 16kHz PID loop without telemetry
+    EXPECT_LE(dshotFrameIntervalUs(dshot600FrameUs, false), 62u);
+    EXPECT_LE(dshotFrameIntervalUs(dshot1200FrameUs, false), 62u);
+
+    // 8kHz PID loop with bidirectional telemetry
+    EXPECT_LE(dshotFrameIntervalUs(dshot600FrameUs, true), 125u);
+    EXPECT_LE(dshotFrameIntervalUs(dshot1200FrameUs, true), 125u);
+    EXPECT_GT(dshotFrameIntervalUs(dshot300FrameUs, true), 125u);
+
+    // bidirectional frames always take longer
+    EXPECT_GT(dshotFrameIntervalUs(dshot1200FrameUs, true), dshotFrameIntervalUs(dshot1200FrameUs, false) + 30);
+}
@@ -17,6 +17,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <chrono>
 #include <stdio.h>
 #include <string.h>
 
@@ -62,14 +63,14 @@ extern "C" {
     #include "rx/rx.h"
     #include "flight/mixer.h"
 
-    void osdRefresh(timeUs_t currentTimeUs);
+    bool osdRefresh(timeUs_t currentTimeUs);
     void osdFormatTime(char * buff, osd_timer_precision_e precision, timeUs_t time);
     int osdConvertTemperatureToSelectedUnit(int tempInDegreesCelcius);
 
     uint16_t rssi;
     attitudeEulerAngles_t attitude;
     pidProfile_t *currentPidProfile;
-    int16_t debug[DEBUG16_VALUE_COUNT];
+    int32_t debug[DEBUG_VALUE_STORAGE_COUNT];
     int16_t rcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
     uint8_t GPS_numSat;
     uint16_t GPS_distanceToHome;
@@ -1130,12 +1131,59 @@ TEST_F(OsdTest, TestConvertTemperatureUnits)
     EXPECT_EQ(osdConvertTemperatureToSelectedUnit(41), 106);
 }
 
+/*
+ * Benchmarks drawing frames with every element visible, reporting the time taken and the
+ * number of characters written to the display per frame so that regressions show up in the log.
+ */
+TEST_F(OsdTest, TestRefreshBenchmark)
+{
+    // given
+    // every element visible in the middle of the screen
+    for (int i = 0; i < OSD_ITEM_COUNT; i++) {
+        osdElementConfigMutable()->item_pos[i] = OSD_POS(10, 7) | OSD_PROFILE_1_FLAG;
+    }
+    osdAnalyzeActiveElements();
+
+    // and
+    // a PID profile for the PID elements
+    static pidProfile_t pidProfile;
+    currentPidProfile = &pidProfile;
+
+    // and
+    // the craft is flying
+    doTestArm(false);
+
+    // when
+    // frames are drawn while the values change
+    const int frames = 1000;
+    testDisplayPortCharsWritten = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        simulationTime += 1e5;
+        simulationBatteryVoltage = 1500 + frame % 100;
+        simulationAltitude = frame;
+        rssi = 1024 - frame;
+        while (!osdRefresh(simulationTime));
+    }
+    const auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    printf("OSD benchmark: %.2f us/frame, %u chars/frame\n", (double)elapsedUs / frames, testDisplayPortCharsWritten / frames);
+    RecordProperty("usPerFrame", (int)(elapsedUs / frames));
+    RecordProperty("charsPerFrame", (int)(testDisplayPortCharsWritten / frames));
+
+    // then
+    // every frame drew something
+    EXPECT_GE(testDisplayPortCharsWritten, (unsigned)frames);
+}
+
 // STUBS
 extern "C" {
     bool featureIsEnabled(uint32_t f) { return simulationFeatureFlags & f; }
 
     void beeperConfirmationBeeps(uint8_t) {}
 
+    void accSetRequiredRate(accConsumer_e, uint16_t) {}
+
     bool isModeActivationConditionPresent(boxId_e) {
         return false;
     }
@@ -1192,6 +1240,10 @@ extern "C" {
         return simulationMahDrawn;
     }
 
+    int32_t getBatteryAverageAmperage() {
+        return simulationBatteryAmperage;
+    }
+
     int32_t getEstimatedAltitudeCm() {
         return simulationAltitude;
     }
@@ -30,8 +30,8 @@ float simulatedRcDeflection[3] = { 0,0,0 };
 float simulatedThrottlePIDAttenuation = 1.0f;
 float simulatedMotorMixRange = 0.0f;
 
-int16_t debug[DEBUG16_VALUE_COUNT];
-uint8_t debugMode;
+int32_t debug[DEBUG_VALUE_STORAGE_COUNT];
+uint8_t debugModes[DEBUG_GROUP_COUNT];
 
 extern "C" {
     #include "build/debug.h"
@@ -81,6 +81,7 @@ extern "C" {
     void beeperConfirmationBeeps(uint8_t) { }
     bool isLaunchControlActive(void) {return unitLaunchControlActive; }
     void disarm(flightLogDisarmReason_e) { }
+    void accSetRequiredRate(accConsumer_e, uint16_t) { }
     float applyFFLimit(int axis, float value, float Kp, float currentPidSetpoint) {
         UNUSED(axis);
         UNUSED(Kp);
@@ -146,6 +147,7 @@ void setDefaultTestSettings(void) {
     pidProfile->level_race_mode = false,
 
     gyro.targetLooptime = 8000;
+    gyro.sampleDtUs = 8000;
 }
 
 timeUs_t currentTestTime(void) {
@@ -335,6 +337,30 @@ TEST(pidControllerTest, testPidLoop) {
     EXPECT_FLOAT_EQ(0, pidData[FD_YAW].D);
 }
 
+TEST(pidControllerTest, testOuterLoopDenom) {
+    resetTest();
+    pidConfigMutable()->pid_outer_denom = 2;
+    pidInit(pidProfile);
+    ENABLE_ARMING_FLAG(ARMED);
+    pidStabilisationState(PID_STABILISATION_ON);
+
+    // I is only updated on every second loop, with twice the dT
+    gyro.gyroADCf[FD_ROLL] = 100;
+    pidController(pidProfile, currentTestTime());
+    EXPECT_NEAR(-128.1, pidData[FD_ROLL].P, calculateTolerance(-128.1));
+    EXPECT_FLOAT_EQ(0, pidData[FD_ROLL].I);
+
+    pidController(pidProfile, currentTestTime());
+    EXPECT_NEAR(-128.1, pidData[FD_ROLL].P, calculateTolerance(-128.1));
+    EXPECT_NEAR(-15.6, pidData[FD_ROLL].I, calculateTolerance(-15.6));
+
+    pidController(pidProfile, currentTestTime());
+    EXPECT_NEAR(-15.6, pidData[FD_ROLL].I, calculateTolerance(-15.6));
+
+    pidController(pidProfile, currentTestTime());
+    EXPECT_NEAR(-31.2, pidData[FD_ROLL].I, calculateTolerance(-31.2));
+}
+
 TEST(pidControllerTest, testPidLevel) {
     // Make sure to start with fresh values
     resetTest();
@@ -473,7 +499,14 @@ TEST(pidControllerTest, testCrashRecoveryMode) {
     }
 
     EXPECT_TRUE(crashRecoveryModeActive());
-    // Add additional verifications
+
+    // the I terms are reset while recovering, which ends once the aircraft is level and the gyro has settled
+    pidData[FD_PITCH].I = 10;
+    gyro.gyroADCf[FD_ROLL] = 50;
+    simulatedMotorMixRange = 0.5f;
+    pidController(pidProfile, currentTestTime() + 2000000);
+    EXPECT_FALSE(crashRecoveryModeActive());
+    EXPECT_FLOAT_EQ(0, pidData[FD_PITCH].I);
 }
 
 TEST(pidControllerTest, testFeedForward) {
@@ -624,6 +657,42 @@ TEST(pidControllerTest, testDtermFiltering) {
 // TODO
 }
 
+TEST(pidControllerTest, testProfileChangeKeepsFilterState) {
+    // Reference run without a profile change, with a D term lowpass below the nyquist frequency of the test looptime
+    resetTest();
+    pidProfile->dterm_lowpass_hz = 30;
+    pidProfile->dyn_lpf_dterm_min_hz = 0;
+    pidInit(pidProfile);
+    ENABLE_ARMING_FLAG(ARMED);
+    pidStabilisationState(PID_STABILISATION_ON);
+
+    gyro.gyroADCf[FD_ROLL] = 50;
+    for (int loop = 0; loop < 5; loop++) {
+        pidController(pidProfile, currentTestTime());
+    }
+    gyro.gyroADCf[FD_ROLL] = 60;
+    pidController(pidProfile, currentTestTime());
+    const float expectedD = pidData[FD_ROLL].D;
+    EXPECT_NE(0, expectedD);
+
+    // Changing to a profile with the same filters in the middle of the run must not disturb the D term
+    resetTest();
+    pidProfile->dterm_lowpass_hz = 30;
+    pidProfile->dyn_lpf_dterm_min_hz = 0;
+    pidInit(pidProfile);
+    ENABLE_ARMING_FLAG(ARMED);
+    pidStabilisationState(PID_STABILISATION_ON);
+
+    gyro.gyroADCf[FD_ROLL] = 50;
+    for (int loop = 0; loop < 5; loop++) {
+        pidController(pidProfile, currentTestTime());
+    }
+    pidChangeProfile(pidProfile);
+    gyro.gyroADCf[FD_ROLL] = 60;
+    pidController(pidProfile, currentTestTime());
+    EXPECT_FLOAT_EQ(expectedD, pidData[FD_ROLL].D);
+}
+
 TEST(pidControllerTest, testItermRotationHandling) {
     resetTest();
     pidInit(pidProfile);
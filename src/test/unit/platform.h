@@ -31,6 +31,9 @@
 #define FAST_CODE_NOINLINE
 #define FAST_DATA_ZERO_INIT
 #define FAST_DATA
+#define DMA_BUFFER_W
+#define DMA_BUFFER_R
+#define DMA_BUFFER_RW
 
 #define PID_PROFILE_COUNT 3
 #define CONTROL_RATE_PROFILE_COUNT  6
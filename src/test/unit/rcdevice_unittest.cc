@@ -709,6 +709,46 @@ TEST(RCDeviceTest, Test5KeyOSDCableSimulationProtocol)
     }
 }
 
+TEST(RCDeviceTest, TestRequestQueuedBehindPendingRequest)
+{
+    resetRCDeviceStatus();
+
+    memset(&testData, 0, sizeof(testData));
+    testData.isRunCamSplitOpenPortSupported = true;
+    testData.isRunCamSplitPortConfigurated = true;
+    testData.isAllowBufferReadWrite = true;
+    testData.maxTimesOfRespDataAvailable = 0;
+    uint8_t responseData[] = { 0xCC, 0x01, 0x37, 0x00, 0xBD };
+    addResponseData(responseData, sizeof(responseData), true);
+    rcdeviceInit();
+    testData.millis += 3001;
+    rcdeviceReceive(millis() * 1000);
+    testData.millis += minTimeout;
+    testData.responseDataReadPos = 0;
+    testData.indexOfCurrentRespBuf = 0;
+    rcdeviceReceive(millis() * 1000);
+    testData.millis += minTimeout;
+    EXPECT_TRUE(camDevice->isReady);
+    clearResponseBuff();
+
+    // each packet sent is answered with the next response, the release is answered second
+    uint8_t responseDataOfRelease[] = { 0xCC, 0xA5 };
+    uint8_t responseDataOfOpenConnection[] = { 0xCC, 0x11, 0xe7 };
+    addResponseData(responseDataOfRelease, sizeof(responseDataOfRelease), true);
+    addResponseData(responseDataOfOpenConnection, sizeof(responseDataOfOpenConnection), true);
+
+    // the release waits in the queue until the open connection is answered
+    rcdeviceSend5KeyOSDCableSimualtionEvent(RCDEVICE_CAM_KEY_CONNECTION_OPEN);
+    rcdeviceSend5KeyOSDCableSimualtionEvent(RCDEVICE_CAM_KEY_RELEASE);
+    EXPECT_EQ(2, waitingResponseQueue.itemCount);
+
+    rcdeviceReceive(millis() * 1000);
+    EXPECT_TRUE(rcdeviceInMenu);
+    EXPECT_FALSE(isButtonPressed);
+    EXPECT_EQ(0, waitingResponseQueue.itemCount);
+    clearResponseBuff();
+}
+
 TEST(RCDeviceTest, Test5KeyOSDCableSimulationWithout5KeyFeatureSupport)
 {
     resetRCDeviceStatus();
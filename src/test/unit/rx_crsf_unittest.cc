@@ -39,6 +39,8 @@ extern "C" {
     #include "rx/rx.h"
     #include "rx/crsf.h"
 
+    #include "scheduler/scheduler.h"
+
     #include "telemetry/msp_shared.h"
 
     rssiSource_e rssiSource;
@@ -51,7 +53,7 @@ extern "C" {
     extern bool crsfFrameDone;
     extern crsfFrame_t crsfFrame;
     extern crsfFrame_t crsfChannelDataFrame;
-    extern uint32_t crsfChannelData[CRSF_MAX_CHANNEL];
+    extern uint16_t crsfChannelData[CRSF_MAX_CHANNEL];
 
     uint32_t dummyTimeUs;
 
@@ -283,13 +285,74 @@ TEST(CrossFireTest, TestCrsfDataReceive)
     EXPECT_EQ(crc, crsfFrame.frame.payload[CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE]);
 }
 
+TEST(CrossFireTest, TestCrsfDataReceiveRcChannels)
+{
+    // the CRC doesn't cover the address, so the captured frame is valid when addressed to the flight controller
+    uint8_t frame[sizeof(crsfRcChannelsFrame_t)];
+    memcpy(frame, capturedData, sizeof(frame));
+    frame[0] = CRSF_ADDRESS_FLIGHT_CONTROLLER;
+
+    dummyTimeUs += 10000; // start a new frame
+    crsfFrameDone = false;
+    for (unsigned int ii = 0; ii < sizeof(frame); ++ii) {
+        crsfDataReceive(frame[ii]);
+    }
+    EXPECT_TRUE(crsfFrameDone);
+    EXPECT_EQ(RX_FRAME_COMPLETE, crsfFrameStatus());
+    EXPECT_EQ(189, crsfChannelData[0]);
+    EXPECT_EQ(993, crsfChannelData[1]);
+    EXPECT_EQ(978, crsfChannelData[2]);
+    EXPECT_EQ(983, crsfChannelData[3]);
+
+    // a corrupted payload byte fails the CRC
+    dummyTimeUs += 10000;
+    frame[5] ^= 0x01;
+    for (unsigned int ii = 0; ii < sizeof(frame); ++ii) {
+        crsfDataReceive(frame[ii]);
+    }
+    EXPECT_FALSE(crsfFrameDone);
+}
+
+TEST(CrossFireTest, TestCrsfDataReceiveGarbageStream)
+{
+    uint8_t frame[sizeof(crsfRcChannelsFrame_t)];
+    memcpy(frame, capturedData, sizeof(frame));
+    frame[0] = CRSF_ADDRESS_FLIGHT_CONTROLLER;
+
+    // stream pseudo random bytes at the 420k baud byte rate, the address and CRC checks should reject nearly all of them
+    uint32_t seed = 0x12345678;
+    int framesAccepted = 0;
+    for (int ii = 0; ii < 100000; ++ii) {
+        seed = seed * 1664525 + 1013904223;
+        crsfFrameDone = false;
+        crsfDataReceive(seed >> 24);
+        dummyTimeUs += 24;
+        if (crsfFrameDone) {
+            framesAccepted++;
+        }
+    }
+    EXPECT_LT(framesAccepted, 5);
+
+    // the parser resyncs on the next valid frame after an inter frame gap
+    dummyTimeUs += 10000;
+    crsfFrameDone = false;
+    for (unsigned int ii = 0; ii < sizeof(frame); ++ii) {
+        crsfDataReceive(frame[ii]);
+    }
+    EXPECT_TRUE(crsfFrameDone);
+    EXPECT_EQ(RX_FRAME_COMPLETE, crsfFrameStatus());
+    EXPECT_EQ(189, crsfChannelData[0]);
+    EXPECT_EQ(993, crsfChannelData[1]);
+}
+
 // STUBS
 
 extern "C" {
 
-int16_t debug[DEBUG16_VALUE_COUNT];
+int32_t debug[DEBUG_VALUE_STORAGE_COUNT];
 uint32_t micros(void) {return dummyTimeUs;}
 uint32_t microsISR(void) {return micros();}
+void schedulerSetFollowUpTask(taskId_e) {}
 serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) {return NULL;}
 const serialPortConfig_t *findSerialPortConfig(serialPortFunction_e ) {return NULL;}
 bool telemetryCheckRxPortShared(const serialPortConfig_t *) {return false;}
@@ -518,3 +518,39 @@ TEST_F(IbusRxProtocollUnitTest, Test_OneTelemetryShouldNotIgnoreTxEchoAfterInter
     rxRuntimeState.rcFrameStatusFn(&rxRuntimeState);
     EXPECT_TRUE(stubTelemetryCalled);
 }
+
+
+TEST_F(IbusRxProtocollUnitTest, Test_GarbageStreamThenValidPacket)
+{
+    uint8_t packet[] = {0x20, 0x00, //length and reserved (unknown) bits
+                        0x00, 0xE0, 0x01, 0x00, 0x02, 0x00, 0x03, 0xF0, 0x04, 0x00, //channel 1..5  + 15 + 16
+                        0x05, 0x00, 0x06, 0x00, 0x07, 0x10, 0x08, 0x00, 0x09, 0x10, //channel 6..10 + 17 + 18(lsb)
+                        0x0a, 0x10, 0x0b, 0x00, 0x0c, 0x00, 0x0d, 0x00,             //channel 11..14 + 18
+                        0x84, 0xfd}; //checksum
+
+    //stream pseudo random bytes at the serial byte rate with the IA6B checksum failing, nearly all of them should be rejected
+    isChecksumOkReturnValue = false;
+    uint32_t seed = 0x12345678;
+    int framesAccepted = 0;
+    for (int i = 0; i < 100000; i++) {
+        seed = seed * 1664525 + 1013904223;
+        stub_serialRxCallback(seed >> 24, NULL);
+        microseconds_stub_value += 87;
+        if (rxRuntimeState.rcFrameStatusFn(&rxRuntimeState) == RX_FRAME_COMPLETE) {
+            framesAccepted++;
+        }
+    }
+    EXPECT_LT(framesAccepted, 5);
+
+    //after an inter frame gap the parser resyncs on the next valid packet
+    isChecksumOkReturnValue = true;
+    microseconds_stub_value += 5000;
+    rxRuntimeState.rcFrameStatusFn(&rxRuntimeState);
+    for (size_t i = 0; i < sizeof(packet); i++) {
+        stub_serialRxCallback(packet[i], NULL);
+    }
+    EXPECT_EQ(RX_FRAME_COMPLETE, rxRuntimeState.rcFrameStatusFn(&rxRuntimeState));
+    for (int i = 0; i < 18; i++) {
+        EXPECT_EQ(i, rxRuntimeState.rcReadRawFn(&rxRuntimeState, i));
+    }
+}
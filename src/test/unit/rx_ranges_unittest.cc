@@ -41,8 +41,8 @@ extern "C" {
 PG_REGISTER(flight3DConfig_t, flight3DConfig, PG_MOTOR_3D_CONFIG, 0);
 
 boxBitmask_t rcModeActivationMask;
-int16_t debug[DEBUG16_VALUE_COUNT];
-uint8_t debugMode = 0;
+int32_t debug[DEBUG_VALUE_STORAGE_COUNT];
+uint8_t debugModes[DEBUG_GROUP_COUNT];
 
 extern uint16_t applyRxChannelRangeConfiguraton(int sample, const rxChannelRangeConfig_t *range);
 }
@@ -37,8 +37,8 @@ extern "C" {
     #include "io/beeper.h"
 
     boxBitmask_t rcModeActivationMask;
-    int16_t debug[DEBUG16_VALUE_COUNT];
-    uint8_t debugMode = 0;
+    int32_t debug[DEBUG_VALUE_STORAGE_COUNT];
+    uint8_t debugModes[DEBUG_GROUP_COUNT];
 
     bool isPulseValid(uint16_t pulseDuration);
 
@@ -23,6 +23,8 @@
 extern "C" {
     #include "platform.h"
 
+    #include "build/debug.h"
+
     #include "drivers/io.h"
 
     #include "pg/pg.h"
@@ -337,8 +339,8 @@ TEST(RxSpiSpektrumUnitTest, TestConvertDataPacket)
 
 extern "C" {
 
-    int16_t *debug;
-    uint8_t debugMode;
+    int32_t debug[DEBUG_VALUE_STORAGE_COUNT];
+    uint8_t debugModes[DEBUG_GROUP_COUNT];
 
     rssiSource_e rssiSource;
     void setRssi(uint16_t newRssi, rssiSource_e )
@@ -378,3 +378,24 @@ TEST_F(SumdRxProtocollUnitTest, Test_LongPacketsReceived)
     sendValidLongPacket();
     sendValidLongPacket();
 }
+
+TEST_F(SumdRxProtocollUnitTest, Test_GarbageStreamThenValidPacket)
+{
+    // stream pseudo random bytes at the serial byte rate, the CRC should reject nearly all of them
+    uint32_t seed = 0x12345678;
+    int framesAccepted = 0;
+    for (int i = 0; i < 100000; i++) {
+        seed = seed * 1664525 + 1013904223;
+        stub_serialRxCallback(seed >> 24, NULL);
+        microseconds_stub_value += 87;
+        if (rxRuntimeState.rcFrameStatusFn(&rxRuntimeState) != RX_FRAME_PENDING) {
+            framesAccepted++;
+        }
+    }
+    EXPECT_LT(framesAccepted, 5);
+
+    // after an inter frame gap the parser resyncs on the next valid packet
+    microseconds_stub_value += 5000;
+    rxRuntimeState.rcFrameStatusFn(&rxRuntimeState);
+    sendValidPacket();
+}
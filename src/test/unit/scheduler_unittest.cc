@@ -15,10 +15,14 @@
  * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <math.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 
 extern "C" {
     #include "platform.h"
+    #include "common/maths.h"
     #include "scheduler/scheduler.h"
 }
 
@@ -80,6 +84,10 @@ extern "C" {
 
     extern int taskQueueSize;
     extern task_t* taskQueueArray[];
+    extern int taskDueQueueSize;
+    extern task_t* taskDueQueueArray[];
+    extern int taskEventQueueSize;
+    extern task_t* taskEventQueueArray[];
 
     extern void queueClear(void);
     extern bool queueContains(task_t *task);
@@ -87,6 +95,7 @@ extern "C" {
     extern bool queueRemove(task_t *task);
     extern task_t *queueFirst(void);
     extern task_t *queueNext(void);
+    extern void loadGovernorUpdate(uint16_t loadPercent);
 
     task_t tasks[TASK_COUNT] = {
         [TASK_SYSTEM] = {
@@ -158,6 +167,16 @@ extern "C" {
     }
 }
 
+// The scheduler keeps the time driven tasks in order of their due time,
+// so an enabled task must be re-queued when its last execution time is changed
+static void setTaskLastExecutedAtUs(taskId_e taskId, timeUs_t lastExecutedAtUs)
+{
+    tasks[taskId].lastExecutedAtUs = lastExecutedAtUs;
+    if (queueRemove(&tasks[taskId])) {
+        queueAdd(&tasks[taskId]);
+    }
+}
+
 TEST(SchedulerUnittest, TestPriorites)
 {
     EXPECT_EQ(TASK_PRIORITY_MEDIUM_HIGH, tasks[TASK_SYSTEM].staticPriority);
@@ -352,7 +371,7 @@ TEST(SchedulerUnittest, TestSingleTask)
         setTaskEnabled(static_cast<taskId_e>(taskId), false);
     }
     setTaskEnabled(TASK_ACCEL, true);
-    tasks[TASK_ACCEL].lastExecutedAtUs = 1000;
+    setTaskLastExecutedAtUs(TASK_ACCEL, 1000);
     simulatedTime = 2050;
     // run the scheduler and check the task has executed
     scheduler();
@@ -360,7 +379,7 @@ TEST(SchedulerUnittest, TestSingleTask)
     EXPECT_EQ(unittest_scheduler_selectedTask, &tasks[TASK_ACCEL]);
     EXPECT_EQ(1050, tasks[TASK_ACCEL].taskLatestDeltaTimeUs);
     EXPECT_EQ(2050, tasks[TASK_ACCEL].lastExecutedAtUs);
-    EXPECT_EQ(TEST_UPDATE_ACCEL_TIME, tasks[TASK_ACCEL].totalExecutionTimeUs);
+    EXPECT_EQ(TEST_UPDATE_ACCEL_TIME, tasks[TASK_ACCEL].totalExecutionTime);
     // task has run, so its dynamic priority should have been set to zero
     EXPECT_EQ(0, tasks[TASK_GYRO].dynamicPriority);
 }
@@ -377,8 +396,8 @@ TEST(SchedulerUnittest, TestTwoTasks)
     // set it up so that TASK_ACCEL ran just before TASK_ATTITUDE
     static const uint32_t startTime = 4000;
     simulatedTime = startTime;
-    tasks[TASK_ACCEL].lastExecutedAtUs = simulatedTime;
-    tasks[TASK_ATTITUDE].lastExecutedAtUs = tasks[TASK_ACCEL].lastExecutedAtUs - TEST_UPDATE_ATTITUDE_TIME;
+    setTaskLastExecutedAtUs(TASK_ACCEL, simulatedTime);
+    setTaskLastExecutedAtUs(TASK_ATTITUDE, tasks[TASK_ACCEL].lastExecutedAtUs - TEST_UPDATE_ATTITUDE_TIME);
     EXPECT_EQ(0, tasks[TASK_ATTITUDE].taskAgeCycles);
     // run the scheduler
     scheduler();
@@ -439,7 +458,7 @@ TEST(SchedulerUnittest, TestGyroTask)
 
     // First set it up so TASK_GYRO just ran
     simulatedTime = startTime;
-    tasks[TASK_GYRO].lastExecutedAtUs = simulatedTime;
+    setTaskLastExecutedAtUs(TASK_GYRO, simulatedTime);
     // reset the flags
     resetGyroTaskTestFlags();
 
@@ -455,7 +474,7 @@ TEST(SchedulerUnittest, TestGyroTask)
     /* Test the gyro task running but not triggering the filtering or PID */
     // set the TASK_GYRO last executed time to be one period earlier
     simulatedTime = startTime;
-    tasks[TASK_GYRO].lastExecutedAtUs = simulatedTime - TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ);
+    setTaskLastExecutedAtUs(TASK_GYRO, simulatedTime - TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ));
 
     // reset the flags
     resetGyroTaskTestFlags();
@@ -472,7 +491,7 @@ TEST(SchedulerUnittest, TestGyroTask)
     /* Test the gyro task running and triggering the filtering task */
     // set the TASK_GYRO last executed time to be one period earlier
     simulatedTime = startTime;
-    tasks[TASK_GYRO].lastExecutedAtUs = simulatedTime - TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ);
+    setTaskLastExecutedAtUs(TASK_GYRO, simulatedTime - TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ));
 
     // reset the flags
     resetGyroTaskTestFlags();
@@ -490,7 +509,7 @@ TEST(SchedulerUnittest, TestGyroTask)
     /* Test the gyro task running and triggering the PID task */
     // set the TASK_GYRO last executed time to be one period earlier
     simulatedTime = startTime;
-    tasks[TASK_GYRO].lastExecutedAtUs = simulatedTime - TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ);
+    setTaskLastExecutedAtUs(TASK_GYRO, simulatedTime - TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ));
 
     // reset the flags
     resetGyroTaskTestFlags();
@@ -530,14 +549,14 @@ TEST(SchedulerUnittest, TestGyroLookahead)
 
 #if defined(USE_TASK_STATISTICS)
     // set the average run time for TASK_ACCEL
-    tasks[TASK_ACCEL].movingSumExecutionTimeUs = TEST_UPDATE_ACCEL_TIME * TASK_STATS_MOVING_SUM_COUNT;
+    tasks[TASK_ACCEL].movingSumExecutionTime = TEST_UPDATE_ACCEL_TIME * TASK_STATS_MOVING_SUM_COUNT;
 #endif
 
     /* Test that another task will run if there's plenty of time till the next gyro sample time */
     // set it up so TASK_GYRO just ran and TASK_ACCEL is ready to run
     simulatedTime = startTime;
-    tasks[TASK_GYRO].lastExecutedAtUs = simulatedTime;
-    tasks[TASK_ACCEL].lastExecutedAtUs = simulatedTime - TASK_PERIOD_HZ(1000);
+    setTaskLastExecutedAtUs(TASK_GYRO, simulatedTime);
+    setTaskLastExecutedAtUs(TASK_ACCEL, simulatedTime - TASK_PERIOD_HZ(1000));
     // reset the flags
     resetGyroTaskTestFlags();
 
@@ -553,8 +572,8 @@ TEST(SchedulerUnittest, TestGyroLookahead)
     /* Test that another task won't run if the time till the gyro task is less than the guard interval */
     // set it up so TASK_GYRO will run soon and TASK_ACCEL is ready to run
     simulatedTime = startTime;
-    tasks[TASK_GYRO].lastExecutedAtUs = simulatedTime - TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ) + GYRO_TASK_GUARD_INTERVAL_US / 2;
-    tasks[TASK_ACCEL].lastExecutedAtUs = simulatedTime - TASK_PERIOD_HZ(1000);
+    setTaskLastExecutedAtUs(TASK_GYRO, simulatedTime - TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ) + GYRO_TASK_GUARD_INTERVAL_US / 2);
+    setTaskLastExecutedAtUs(TASK_ACCEL, simulatedTime - TASK_PERIOD_HZ(1000));
     // reset the flags
     resetGyroTaskTestFlags();
 
@@ -570,8 +589,8 @@ TEST(SchedulerUnittest, TestGyroLookahead)
     /* Test that another task won't run if the time till the gyro task is less than the average task interval */
     // set it up so TASK_GYRO will run soon and TASK_ACCEL is ready to run
     simulatedTime = startTime;
-    tasks[TASK_GYRO].lastExecutedAtUs = simulatedTime - TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ) + TEST_UPDATE_ACCEL_TIME / 2;
-    tasks[TASK_ACCEL].lastExecutedAtUs = simulatedTime - TASK_PERIOD_HZ(1000);
+    setTaskLastExecutedAtUs(TASK_GYRO, simulatedTime - TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ) + TEST_UPDATE_ACCEL_TIME / 2);
+    setTaskLastExecutedAtUs(TASK_ACCEL, simulatedTime - TASK_PERIOD_HZ(1000));
     // reset the flags
     resetGyroTaskTestFlags();
 
@@ -587,8 +606,8 @@ TEST(SchedulerUnittest, TestGyroLookahead)
     /* Test that another task will run if the gyro task gets executed */
     // set it up so TASK_GYRO will run now and TASK_ACCEL is ready to run
     simulatedTime = startTime;
-    tasks[TASK_GYRO].lastExecutedAtUs = simulatedTime - TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ);
-    tasks[TASK_ACCEL].lastExecutedAtUs = simulatedTime - TASK_PERIOD_HZ(1000);
+    setTaskLastExecutedAtUs(TASK_GYRO, simulatedTime - TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ));
+    setTaskLastExecutedAtUs(TASK_ACCEL, simulatedTime - TASK_PERIOD_HZ(1000));
     // reset the flags
     resetGyroTaskTestFlags();
 
@@ -605,3 +624,279 @@ TEST(SchedulerUnittest, TestGyroLookahead)
     // TASK_ACCEL should have run
     EXPECT_EQ(&tasks[TASK_ACCEL], unittest_scheduler_selectedTask);
 }
+
+TEST(SchedulerUnittest, TestReadyQueues)
+{
+    schedulerInit();
+    for (int taskId = 0; taskId < TASK_COUNT; ++taskId) {
+        setTaskEnabled(static_cast<taskId_e>(taskId), false);
+    }
+    EXPECT_EQ(0, taskDueQueueSize);
+    EXPECT_EQ(0, taskEventQueueSize);
+
+    setTaskEnabled(TASK_GYRO, true);
+    setTaskEnabled(TASK_RX, true);
+    setTaskEnabled(TASK_ACCEL, true);
+    setTaskEnabled(TASK_SERIAL, true);
+    setTaskEnabled(TASK_BATTERY_VOLTAGE, true);
+
+    // realtime tasks are not in the ready queues, event driven tasks are kept separately
+    EXPECT_EQ(5, taskQueueSize);
+    EXPECT_EQ(3, taskDueQueueSize);
+    EXPECT_EQ(1, taskEventQueueSize);
+    EXPECT_EQ(&tasks[TASK_RX], taskEventQueueArray[0]);
+
+    // time driven tasks are kept in order of their next due time
+    static const uint32_t startTime = 100000;
+    simulatedTime = startTime;
+    setTaskLastExecutedAtUs(TASK_ACCEL, startTime);                    // due at startTime + 1000
+    setTaskLastExecutedAtUs(TASK_SERIAL, startTime - 9500);            // due at startTime + 500
+    setTaskLastExecutedAtUs(TASK_BATTERY_VOLTAGE, startTime - 19000);  // due at startTime + 1000
+    EXPECT_EQ(&tasks[TASK_SERIAL], taskDueQueueArray[0]);
+    EXPECT_EQ(&tasks[TASK_ACCEL], taskDueQueueArray[1]);
+    EXPECT_EQ(&tasks[TASK_BATTERY_VOLTAGE], taskDueQueueArray[2]);
+
+    // nothing is due yet
+    scheduler();
+    EXPECT_EQ(static_cast<task_t*>(0), unittest_scheduler_selectedTask);
+    EXPECT_EQ(0, unittest_scheduler_waitingTasks);
+
+    // only TASK_SERIAL is due, and once run it moves to the back of the queue
+    simulatedTime = startTime + 600;
+    scheduler();
+    EXPECT_EQ(&tasks[TASK_SERIAL], unittest_scheduler_selectedTask);
+    EXPECT_EQ(1, unittest_scheduler_waitingTasks);
+    EXPECT_EQ(&tasks[TASK_ACCEL], taskDueQueueArray[0]);
+    EXPECT_EQ(&tasks[TASK_BATTERY_VOLTAGE], taskDueQueueArray[1]);
+    EXPECT_EQ(&tasks[TASK_SERIAL], taskDueQueueArray[2]);
+
+    // rescheduling a task restores the due time ordering
+    rescheduleTask(TASK_SERIAL, TASK_PERIOD_HZ(10000));
+    EXPECT_EQ(&tasks[TASK_SERIAL], taskDueQueueArray[0]);
+
+    // disabling a task removes it from the ready queues
+    setTaskEnabled(TASK_SERIAL, false);
+    setTaskEnabled(TASK_RX, false);
+    EXPECT_EQ(2, taskDueQueueSize);
+    EXPECT_EQ(0, taskEventQueueSize);
+    EXPECT_EQ(&tasks[TASK_ACCEL], taskDueQueueArray[0]);
+    EXPECT_EQ(&tasks[TASK_BATTERY_VOLTAGE], taskDueQueueArray[1]);
+}
+
+TEST(SchedulerUnittest, TestTaskHistogram)
+{
+    schedulerInit();
+    for (int taskId = 0; taskId < TASK_COUNT; ++taskId) {
+        setTaskEnabled(static_cast<taskId_e>(taskId), false);
+    }
+    setTaskEnabled(TASK_ACCEL, true);
+    schedulerResetTaskStatistics(TASK_ACCEL);
+
+    taskHistogram_t histogram;
+    getTaskHistogram(TASK_ACCEL, &histogram);
+    EXPECT_EQ(0, taskHistogramPercentileUs(&histogram, 990));
+
+    simulatedTime = 200000;
+    setTaskLastExecutedAtUs(TASK_ACCEL, simulatedTime - TASK_PERIOD_HZ(1000));
+    scheduler();
+    EXPECT_EQ(&tasks[TASK_ACCEL], unittest_scheduler_selectedTask);
+
+    // TEST_UPDATE_ACCEL_TIME of 32us falls into the [32, 64) bucket
+    getTaskHistogram(TASK_ACCEL, &histogram);
+    for (int ii = 0; ii < TASK_STATS_HISTOGRAM_BUCKET_COUNT; ++ii) {
+        EXPECT_EQ(ii == 6 ? 1 : 0, histogram.count[ii]);
+    }
+    EXPECT_EQ(64, taskHistogramPercentileUs(&histogram, 990));
+    EXPECT_EQ(64, taskHistogramPercentileUs(&histogram, 999));
+
+    schedulerResetTaskStatistics(TASK_ACCEL);
+    getTaskHistogram(TASK_ACCEL, &histogram);
+    EXPECT_EQ(0, histogram.count[6]);
+}
+
+TEST(SchedulerUnittest, TestLoadGovernor)
+{
+    schedulerInit();
+    for (int taskId = 0; taskId < TASK_COUNT; ++taskId) {
+        setTaskEnabled(static_cast<taskId_e>(taskId), false);
+    }
+    setTaskEnabled(TASK_ACCEL, true);
+    setTaskEnabled(TASK_SERIAL, true);
+    rescheduleTask(TASK_SERIAL, TASK_PERIOD_HZ(100));
+    schedulerSetTaskMaxPeriod(TASK_SERIAL, TASK_PERIOD_HZ(25));
+    schedulerSetLoadGovernor(80);
+
+    // below the threshold nothing changes
+    loadGovernorUpdate(75);
+    EXPECT_EQ(100, getLoadGovernorStretchPercent());
+    EXPECT_EQ(TASK_PERIOD_HZ(100), tasks[TASK_SERIAL].desiredPeriodUs);
+
+    // above the threshold the governed task is slowed down, up to its maximum period
+    loadGovernorUpdate(90);
+    EXPECT_EQ(150, getLoadGovernorStretchPercent());
+    EXPECT_EQ(TASK_PERIOD_HZ(100) * 3 / 2, tasks[TASK_SERIAL].desiredPeriodUs);
+    EXPECT_EQ(TASK_PERIOD_HZ(1000), tasks[TASK_ACCEL].desiredPeriodUs);
+    for (int ii = 0; ii < 10; ++ii) {
+        loadGovernorUpdate(90);
+    }
+    EXPECT_EQ(TASK_PERIOD_HZ(25), tasks[TASK_SERIAL].desiredPeriodUs);
+
+    // the stretched period is kept in the due queue order
+    static const uint32_t startTime = 300000;
+    simulatedTime = startTime;
+    setTaskLastExecutedAtUs(TASK_ACCEL, startTime);
+    setTaskLastExecutedAtUs(TASK_SERIAL, startTime - TASK_PERIOD_HZ(100));
+    EXPECT_EQ(&tasks[TASK_ACCEL], taskDueQueueArray[0]);
+    EXPECT_EQ(&tasks[TASK_SERIAL], taskDueQueueArray[1]);
+
+    // rescheduling a governed task changes its nominal period, the stretch still applies
+    const uint16_t stretchPercent = getLoadGovernorStretchPercent();
+    rescheduleTask(TASK_SERIAL, TASK_PERIOD_HZ(200));
+    EXPECT_EQ(TASK_PERIOD_HZ(200) * stretchPercent / 100, tasks[TASK_SERIAL].desiredPeriodUs);
+
+    // within the hysteresis band the stretch is held
+    loadGovernorUpdate(75);
+    EXPECT_EQ(stretchPercent, getLoadGovernorStretchPercent());
+
+    // when the load drops the nominal period is restored
+    for (int ii = 0; ii < 40; ++ii) {
+        loadGovernorUpdate(50);
+    }
+    EXPECT_EQ(100, getLoadGovernorStretchPercent());
+    EXPECT_EQ(TASK_PERIOD_HZ(200), tasks[TASK_SERIAL].desiredPeriodUs);
+
+    // disabling the governor restores the nominal period immediately
+    loadGovernorUpdate(90);
+    schedulerSetLoadGovernor(0);
+    EXPECT_EQ(100, getLoadGovernorStretchPercent());
+    EXPECT_EQ(TASK_PERIOD_HZ(200), tasks[TASK_SERIAL].desiredPeriodUs);
+
+    schedulerSetTaskMaxPeriod(TASK_SERIAL, 0);
+}
+
+// Fixed timestep simulation on the scheduler clock. The task stubs still advance simulatedTime, which the
+// scheduler no longer reads, the cost of each task is its fixed cost below plus a repeatable pseudo random jitter.
+static timeUs_t fixedClockUs;
+static uint32_t costSeed;
+static const timeDelta_t fixedTaskCostUs[TASK_COUNT_UNITTEST] = {
+    [TASK_SYSTEM] = 2,
+    [TASK_MAIN] = 0,
+    [TASK_GYRO] = 5,
+    [TASK_FILTER] = 10,
+    [TASK_PID] = 20,
+    [TASK_ACCEL] = 12,
+    [TASK_ATTITUDE] = 15,
+    [TASK_RX] = 8,
+    [TASK_SERIAL] = 6,
+    [TASK_DISPATCH] = 1,
+    [TASK_BATTERY_VOLTAGE] = 3,
+};
+
+typedef struct {
+    uint32_t runs;
+    timeUs_t lastRunUs;
+    double sumPeriodUs;
+    double sumSquaredPeriodUs;
+    timeDelta_t maxJitterUs;
+} periodStats_t;
+
+static periodStats_t periodStats[TASK_COUNT_UNITTEST];
+
+static timeUs_t fixedClockNow(void) { return fixedClockUs; }
+static void fixedClockAdvance(timeDelta_t deltaUs) { fixedClockUs += deltaUs; }
+
+static timeDelta_t fixedTaskCost(const task_t *task, timeUs_t currentTimeUs)
+{
+    const int taskId = task - tasks;
+    periodStats_t *stats = &periodStats[taskId];
+    if (stats->runs++) {
+        const timeDelta_t periodUs = cmpTimeUs(currentTimeUs, stats->lastRunUs);
+        stats->sumPeriodUs += periodUs;
+        stats->sumSquaredPeriodUs += (double)periodUs * periodUs;
+        stats->maxJitterUs = MAX(stats->maxJitterUs, ABS(periodUs - task->desiredPeriodUs));
+    }
+    stats->lastRunUs = currentTimeUs;
+
+    costSeed = costSeed * 1664525 + 1013904223;
+    return fixedTaskCostUs[taskId] + (costSeed >> 30);
+}
+
+static timeDelta_t fixedCheckFuncCost(const task_t *, timeUs_t, bool) { return 1; }
+
+static const schedulerClock_t fixedClock = { fixedClockNow, fixedClockAdvance };
+static const schedulerCostModel_t fixedCostModel = { fixedTaskCost, fixedCheckFuncCost, 1 };
+
+static uint32_t runFixedTimestep(timeUs_t durationUs)
+{
+    schedulerInit();
+    for (int taskId = 0; taskId < TASK_COUNT; ++taskId) {
+        setTaskEnabled(static_cast<taskId_e>(taskId), false);
+    }
+    fixedClockUs = 1000;
+    costSeed = 1;
+    memset(periodStats, 0, sizeof(periodStats));
+    schedulerSetClock(&fixedClock, &fixedCostModel);
+    schedulerSetCalulateTaskStatistics(true);
+    schedulerOptimizeRate(true);
+    schedulerEnableGyro();
+    for (int taskId = 0; taskId < TASK_COUNT_UNITTEST; ++taskId) {
+        if (!tasks[taskId].taskFunc) {
+            continue;
+        }
+        setTaskEnabled(static_cast<taskId_e>(taskId), true);
+        schedulerResetTaskStatistics(static_cast<taskId_e>(taskId));
+        setTaskLastExecutedAtUs(static_cast<taskId_e>(taskId), fixedClockUs);
+        tasks[taskId].lastDesiredAt = fixedClockUs;
+    }
+    resetGyroTaskTestFlags();
+    taskFilterReady = true;
+    taskPidReady = true;
+
+    uint32_t passes = 0;
+    const timeUs_t endUs = fixedClockUs + durationUs;
+    while (cmpTimeUs(endUs, fixedClockUs) > 0) {
+        scheduler();
+        passes++;
+    }
+
+    schedulerSetClock(NULL, NULL);
+    resetGyroTaskTestFlags();
+    return passes;
+}
+
+TEST(SchedulerUnittest, TestFixedTimestepJitter)
+{
+    static const timeUs_t durationUs = 10000000;
+    const uint32_t passes = runFixedTimestep(durationUs);
+    EXPECT_GT(passes, 1000000);
+
+    printf("%u scheduler passes in %us\n", passes, durationUs / 1000000);
+    printf("%-16s %8s %10s %10s %10s\n", "task", "runs", "period/us", "stddev/us", "max jit/us");
+    for (int taskId = 0; taskId < TASK_COUNT_UNITTEST; ++taskId) {
+        const periodStats_t *stats = &periodStats[taskId];
+        if (stats->runs < 2) {
+            continue;
+        }
+        const double meanUs = stats->sumPeriodUs / (stats->runs - 1);
+        const double stddevUs = sqrt(stats->sumSquaredPeriodUs / (stats->runs - 1) - meanUs * meanUs);
+        printf("%-16s %8u %10.2f %10.2f %10d\n", tasks[taskId].taskName, stats->runs, meanUs, stddevUs, stats->maxJitterUs);
+
+        // every background time driven task keeps its rate within 1%
+        if (tasks[taskId].staticPriority != TASK_PRIORITY_REALTIME && !tasks[taskId].checkFunc) {
+            EXPECT_NEAR(tasks[taskId].desiredPeriodUs, meanUs, tasks[taskId].desiredPeriodUs / 100.0);
+        }
+    }
+
+    // the gyro stays on its sample grid, delayed at most by one background task run,
+    // and filtering and PID follow every sample as they are always ready
+    EXPECT_NEAR(durationUs / TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ), periodStats[TASK_GYRO].runs, 1);
+    EXPECT_LT(periodStats[TASK_GYRO].maxJitterUs, 2 * fixedTaskCostUs[TASK_ATTITUDE]);
+    EXPECT_EQ(periodStats[TASK_GYRO].runs, periodStats[TASK_FILTER].runs);
+    EXPECT_EQ(periodStats[TASK_GYRO].runs, periodStats[TASK_PID].runs);
+
+    // and the simulation is repeatable
+    periodStats_t firstRun[TASK_COUNT_UNITTEST];
+    memcpy(firstRun, periodStats, sizeof(firstRun));
+    EXPECT_EQ(passes, runFixedTimestep(durationUs));
+    EXPECT_EQ(0, memcmp(firstRun, periodStats, sizeof(firstRun)));
+}
@@ -19,6 +19,7 @@
 #include <stdbool.h>
 
 #include <limits.h>
+#include <math.h>
 #include <algorithm>
 
 extern "C" {
@@ -32,6 +33,7 @@ extern "C" {
     #include "drivers/accgyro/accgyro_fake.h"
     #include "drivers/accgyro/accgyro_mpu.h"
     #include "drivers/sensor.h"
+    #include "fc/runtime_config.h"
     #include "io/beeper.h"
     #include "pg/pg.h"
     #include "pg/pg_ids.h"
@@ -46,8 +48,8 @@ extern "C" {
     STATIC_UNIT_TESTED void performGyroCalibration(struct gyroSensor_s *gyroSensor, uint8_t gyroMovementCalibrationThreshold);
     STATIC_UNIT_TESTED bool fakeGyroRead(gyroDev_t *gyro);
 
-    uint8_t debugMode;
-    int16_t debug[DEBUG16_VALUE_COUNT];
+    uint8_t debugModes[DEBUG_GROUP_COUNT];
+    int32_t debug[DEBUG_VALUE_STORAGE_COUNT];
 }
 
 #include "unittest_macros.h"
@@ -112,6 +114,87 @@ TEST(SensorGyro, Calibrate)
     EXPECT_EQ(7, gyroDevPtr->gyroZero[Z]);
 }
 
+TEST(SensorGyro, CalibrateAfterMovement)
+{
+    pgResetAll();
+    gyroInit();
+    gyroSetTargetLooptime(1);
+    static const int gyroMovementCalibrationThreshold = 32;
+    gyroStartCalibration(false);
+    const int blockCycles = gyroSensorPtr->calibration.blockCycles;
+    ASSERT_GT(blockCycles, 1);
+
+    // still for half the window, then moved for a block
+    for (int i = 0; i < 2 * blockCycles; i++) {
+        fakeGyroSet(gyroDevPtr, 5, 6, 7);
+        gyroDevPtr->readFn(gyroDevPtr);
+        performGyroCalibration(gyroSensorPtr, gyroMovementCalibrationThreshold);
+    }
+    for (int i = 0; i < blockCycles; i++) {
+        fakeGyroSet(gyroDevPtr, (i & 1) ? 205 : -195, 6, 7);
+        gyroDevPtr->readFn(gyroDevPtr);
+        performGyroCalibration(gyroSensorPtr, gyroMovementCalibrationThreshold);
+    }
+    EXPECT_FALSE(gyroIsCalibrationComplete());
+
+    // a window after the movement the calibration is complete
+    int cycles = 0;
+    while (!gyroIsCalibrationComplete()) {
+        fakeGyroSet(gyroDevPtr, 5, 6, 7);
+        gyroDevPtr->readFn(gyroDevPtr);
+        performGyroCalibration(gyroSensorPtr, gyroMovementCalibrationThreshold);
+        cycles++;
+    }
+    EXPECT_EQ(GYRO_CALIBRATION_BLOCK_COUNT * blockCycles, cycles);
+    EXPECT_EQ(5, gyroDevPtr->gyroZero[X]);
+    EXPECT_EQ(6, gyroDevPtr->gyroZero[Y]);
+    EXPECT_EQ(7, gyroDevPtr->gyroZero[Z]);
+}
+
+TEST(SensorGyro, CalibrationTracking)
+{
+    pgResetAll();
+    gyroConfigMutable()->gyroCalibrationTracking = true;
+    gyroInit();
+    gyroSetTargetLooptime(1);
+    gyroDevPtr->readFn = fakeGyroRead;
+    gyroStartCalibration(false);
+    while (!gyroIsCalibrationComplete()) {
+        fakeGyroSet(gyroDevPtr, 5, 6, 7);
+        gyroUpdate();
+    }
+    const int windowCycles = GYRO_CALIBRATION_BLOCK_COUNT * gyroSensorPtr->calibration.blockCycles;
+
+    // the zero offsets follow a slow drift while disarmed
+    for (int i = 0; i < windowCycles; i++) {
+        fakeGyroSet(gyroDevPtr, 8, 6, 4);
+        gyroUpdate();
+    }
+    EXPECT_EQ(8, gyroDevPtr->gyroZero[X]);
+    EXPECT_EQ(6, gyroDevPtr->gyroZero[Y]);
+    EXPECT_EQ(4, gyroDevPtr->gyroZero[Z]);
+    fakeGyroSet(gyroDevPtr, 8, 6, 4);
+    gyroUpdate();
+    EXPECT_FLOAT_EQ(0, gyroDevPtr->gyroADC[X]);
+    EXPECT_FLOAT_EQ(0, gyroDevPtr->gyroADC[Z]);
+
+    // but not a steady turn
+    for (int i = 0; i < 2 * windowCycles; i++) {
+        fakeGyroSet(gyroDevPtr, 108, 6, 4);
+        gyroUpdate();
+    }
+    EXPECT_EQ(8, gyroDevPtr->gyroZero[X]);
+
+    // nor anything while armed
+    ENABLE_ARMING_FLAG(ARMED);
+    for (int i = 0; i < 2 * windowCycles; i++) {
+        fakeGyroSet(gyroDevPtr, 10, 6, 4);
+        gyroUpdate();
+    }
+    EXPECT_EQ(8, gyroDevPtr->gyroZero[X]);
+    DISABLE_ARMING_FLAG(ARMED);
+}
+
 TEST(SensorGyro, Update)
 {
     pgResetAll();
@@ -151,16 +234,135 @@ TEST(SensorGyro, Update)
     EXPECT_NEAR(90 * gyroDevPtr->scale, gyro.gyroADC[Z], 1e-3);
 }
 
+TEST(SensorGyro, UpdateAligned)
+{
+    pgResetAll();
+    // turn off filters
+    gyroConfigMutable()->gyro_lowpass_hz = 0;
+    gyroConfigMutable()->gyro_lowpass2_hz = 0;
+    gyroConfigMutable()->gyro_soft_notch_hz_1 = 0;
+    gyroConfigMutable()->gyro_soft_notch_hz_2 = 0;
+    gyroInit();
+    gyroSetTargetLooptime(1);
+    gyroDevPtr->readFn = fakeGyroRead;
+    gyroDevPtr->gyroAlign = CW90_DEG;
+    gyroStartCalibration(false);
+    while (!gyroIsCalibrationComplete()) {
+        fakeGyroSet(gyroDevPtr, 5, 6, 7);
+        gyroUpdate();
+    }
+    fakeGyroSet(gyroDevPtr, 15, 26, 97);
+    gyroUpdate();
+    // the zero offset is removed before the rotation, CW90_DEG maps (x, y, z) to (y, -x, z)
+    EXPECT_NEAR(20 * gyroDevPtr->scale, gyro.gyroADC[X], 1e-3);
+    EXPECT_NEAR(-10 * gyroDevPtr->scale, gyro.gyroADC[Y], 1e-3);
+    EXPECT_NEAR(90 * gyroDevPtr->scale, gyro.gyroADC[Z], 1e-3);
+}
+
+TEST(SensorGyro, FilterChain)
+{
+    pgResetAll();
+    gyroConfigMutable()->dyn_lpf_gyro_min_hz = 0;
+    gyroConfigMutable()->gyro_lowpass_hz = 0;
+    gyroInit();
+    gyroSetTargetLooptime(1);
+    gyroInitFilters();
+    EXPECT_EQ(GYRO_FILTER_CHAIN_NO_LPF, gyro.filterChain);
+
+    gyroConfigMutable()->gyro_lowpass_type = FILTER_PT1;
+    gyroConfigMutable()->gyro_lowpass_hz = 100;
+    gyroInitFilters();
+    EXPECT_EQ(GYRO_FILTER_CHAIN_PT1, gyro.filterChain);
+
+    gyroConfigMutable()->gyro_lowpass_type = FILTER_BIQUAD;
+    gyroInitFilters();
+    EXPECT_EQ(GYRO_FILTER_CHAIN_BIQUAD, gyro.filterChain);
+
+    // any static notch needs the generic chain
+    gyroConfigMutable()->gyro_soft_notch_hz_1 = 300;
+    gyroConfigMutable()->gyro_soft_notch_cutoff_1 = 200;
+    gyroInitFilters();
+    EXPECT_EQ(GYRO_FILTER_CHAIN_GENERIC, gyro.filterChain);
+}
+
+static void gyroSpin(float rollRate, float yawRate, timeUs_t currentTimeUs)
+{
+    fakeGyroSet(gyroDevPtr, lrintf(rollRate / gyroDevPtr->scale), 0, lrintf(yawRate / gyroDevPtr->scale));
+    gyroUpdate();
+    gyroFiltering(currentTimeUs);
+}
+
+TEST(SensorGyro, YawSpinDetection)
+{
+    pgResetAll();
+    gyroConfigMutable()->gyro_lowpass_hz = 0;
+    gyroConfigMutable()->gyro_lowpass2_hz = 0;
+    gyroConfigMutable()->gyro_soft_notch_hz_1 = 0;
+    gyroConfigMutable()->gyro_soft_notch_hz_2 = 0;
+    gyroConfigMutable()->dyn_lpf_gyro_min_hz = 0;
+    gyroConfigMutable()->yaw_spin_recovery = YAW_SPIN_RECOVERY_ON;
+    gyroConfigMutable()->yaw_spin_threshold = 1500;
+    gyroInit();
+    gyroSetTargetLooptime(1);
+    gyroInitFilters();
+    initYawSpinRecovery(0);
+    gyroDevPtr->readFn = fakeGyroRead;
+    gyroStartCalibration(false);
+    while (!gyroIsCalibrationComplete()) {
+        fakeGyroSet(gyroDevPtr, 0, 0, 0);
+        gyroUpdate();
+    }
+    timeUs_t currentTimeUs = 1000;
+
+    // a fast roll doesn't trigger it
+    for (int i = 0; i < 16; i++) {
+        gyroSpin(1900, 1400, currentTimeUs);
+        currentTimeUs += 125;
+    }
+    EXPECT_FALSE(gyroYawSpinDetected());
+
+    // disarmed, every 8th sample is checked
+    for (int i = 0; i < 7; i++) {
+        gyroSpin(0, 1600, currentTimeUs);
+        currentTimeUs += 125;
+    }
+    EXPECT_FALSE(gyroYawSpinDetected());
+    gyroSpin(0, 1600, currentTimeUs);
+    EXPECT_TRUE(gyroYawSpinDetected());
+
+    // the reset needs 20ms below the threshold less 100dps
+    for (int i = 0; i < 200; i++) {
+        currentTimeUs += 125;
+        gyroSpin(0, 1450, currentTimeUs);
+    }
+    EXPECT_TRUE(gyroYawSpinDetected());
+    for (int i = 0; i < 160; i++) {
+        currentTimeUs += 125;
+        gyroSpin(0, 1300, currentTimeUs);
+    }
+    EXPECT_TRUE(gyroYawSpinDetected());
+    currentTimeUs += 125;
+    gyroSpin(0, 1300, currentTimeUs);
+    EXPECT_FALSE(gyroYawSpinDetected());
+
+    // armed, every sample is checked
+    ENABLE_ARMING_FLAG(ARMED);
+    gyroSpin(0, -1600, currentTimeUs);
+    EXPECT_TRUE(gyroYawSpinDetected());
+    DISABLE_ARMING_FLAG(ARMED);
+}
+
 // STUBS
 
 extern "C" {
 
+uint8_t armingFlags;
 uint32_t micros(void) {return 0;}
 void beeper(beeperMode_e) {}
 uint8_t detectedSensors[] = { GYRO_NONE, ACC_NONE };
 timeDelta_t getGyroUpdateRate(void) {return gyro.targetLooptime;}
 void sensorsSet(uint32_t) {}
 void schedulerResetTaskStatistics(taskId_e) {}
-int getArmingDisableFlags(void) {return 0;}
+armingDisableFlags_e getArmingDisableFlags(void) {return (armingDisableFlags_e)0;}
 void writeEEPROM(void) {}
 }
@@ -55,6 +55,8 @@ extern "C" {
     #include "rx/rx.h"
     #include "rx/crsf.h"
 
+    #include "scheduler/scheduler.h"
+
     #include "sensors/battery.h"
     #include "sensors/sensors.h"
 
@@ -256,6 +258,7 @@ extern "C" {
 
     uint32_t micros(void) {return dummyTimeUs;}
     uint32_t microsISR(void) {return micros();}
+    void schedulerSetFollowUpTask(taskId_e) {}
     serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) {return NULL;}
     const serialPortConfig_t *findSerialPortConfig(serialPortFunction_e ) {return NULL;}
     bool isBatteryVoltageConfigured(void) { return true; }
@@ -313,6 +316,19 @@ extern "C" {
       return testmAhDrawn;
     }
 
+    const telemetrySnapshot_t *telemetryGetSnapshot(void)
+    {
+        static telemetrySnapshot_t snapshot;
+        snapshot.batteryVoltage = getBatteryVoltage();
+        snapshot.legacyBatteryVoltage = getLegacyBatteryVoltage();
+        snapshot.batteryAverageCellVoltage = getBatteryAverageCellVoltage();
+        snapshot.amperage = getAmperage();
+        snapshot.mAhDrawn = getMAhDrawn();
+        snapshot.batteryRemainingPercentage = calculateBatteryPercentageRemaining();
+        snapshot.attitude = attitude;
+        return &snapshot;
+    }
+
     bool telemetryIsSensorEnabled(sensor_e) {
         return true;
     }
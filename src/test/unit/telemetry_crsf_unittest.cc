@@ -53,6 +53,8 @@ extern "C" {
     #include "rx/rx.h"
     #include "rx/crsf.h"
 
+    #include "scheduler/scheduler.h"
+
     #include "sensors/battery.h"
     #include "sensors/sensors.h"
     #include "sensors/acceleration.h"
@@ -301,7 +303,7 @@ TEST(TelemetryCrsfTest, TestFlightMode)
 
 extern "C" {
 
-int16_t debug[DEBUG16_VALUE_COUNT];
+int32_t debug[DEBUG_VALUE_STORAGE_COUNT];
 
 const uint32_t baudRates[] = {0, 9600, 19200, 38400, 57600, 115200, 230400, 250000, 400000}; // see baudRate_e
 
@@ -317,6 +319,7 @@ void beeperConfirmationBeeps(uint8_t beepCount) {UNUSED(beepCount);}
 
 uint32_t micros(void) {return 0;}
 uint32_t microsISR(void) {return micros();}
+void schedulerSetFollowUpTask(taskId_e) {}
 
 bool featureIsEnabled(uint32_t) {return true;}
 
@@ -372,6 +375,19 @@ int32_t getMAhDrawn(void){
   return testmAhDrawn;
 }
 
+const telemetrySnapshot_t *telemetryGetSnapshot(void)
+{
+    static telemetrySnapshot_t snapshot;
+    snapshot.batteryVoltage = getBatteryVoltage();
+    snapshot.legacyBatteryVoltage = getLegacyBatteryVoltage();
+    snapshot.batteryAverageCellVoltage = getBatteryAverageCellVoltage();
+    snapshot.amperage = getAmperage();
+    snapshot.mAhDrawn = getMAhDrawn();
+    snapshot.batteryRemainingPercentage = calculateBatteryPercentageRemaining();
+    snapshot.attitude = attitude;
+    return &snapshot;
+}
+
 bool sendMspReply(uint8_t, mspResponseFnPtr) { return false; }
 bool handleMspFrame(uint8_t *, int, uint8_t *)  { return false; }
 void crsfScheduleMspResponse(void) {};
@@ -0,0 +1,85 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <limits.h>
+
+extern "C" {
+    #include "common/typeconversion.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+TEST(TypeConversionTest, Ui2aDecimal)
+{
+    char buf[12];
+    const unsigned int values[] = { 0, 7, 10, 99, 100, 12345, 4294967295u };
+    for (unsigned int value : values) {
+        char expected[12];
+        snprintf(expected, sizeof(expected), "%u", value);
+        ui2a(value, 10, 0, buf);
+        EXPECT_STREQ(expected, buf);
+    }
+
+    ui2a(0xbeef, 16, 0, buf);
+    EXPECT_STREQ("beef", buf);
+    ui2a(0xbeef, 16, 1, buf);
+    EXPECT_STREQ("BEEF", buf);
+}
+
+TEST(TypeConversionTest, I2aPad)
+{
+    char buf[16];
+
+    EXPECT_EQ(buf + 4, i2aPad(42, 4, ' ', buf));
+    EXPECT_STREQ("  42", buf);
+    i2aPad(42, 4, '0', buf);
+    EXPECT_STREQ("0042", buf);
+    i2aPad(-42, 4, ' ', buf);
+    EXPECT_STREQ(" -42", buf);
+    i2aPad(-42, 4, '0', buf);
+    EXPECT_STREQ("-042", buf);
+    i2aPad(12345, 2, '0', buf);
+    EXPECT_STREQ("12345", buf);
+    i2aPad(0, 0, ' ', buf);
+    EXPECT_STREQ("0", buf);
+    i2aPad(INT_MIN, 0, ' ', buf);
+    EXPECT_STREQ("-2147483648", buf);
+}
+
+TEST(TypeConversionTest, Fixed2a)
+{
+    char buf[16];
+
+    EXPECT_EQ(buf + 4, fixed2a(420, 2, 0, buf));
+    EXPECT_STREQ("4.20", buf);
+    fixed2a(5, 2, 6, buf);
+    EXPECT_STREQ("  0.05", buf);
+    fixed2a(-5, 2, 0, buf);
+    EXPECT_STREQ("-0.05", buf);
+    fixed2a(1261, 1, 0, buf);
+    EXPECT_STREQ("126.1", buf);
+    fixed2a(7, 0, 3, buf);
+    EXPECT_STREQ("  7", buf);
+    fixed2a(1, 9, 0, buf);
+    EXPECT_STREQ("0.000000001", buf);
+}
@@ -33,6 +33,7 @@ void displayPortTestBufferSubstring(int x, int y, const char * expectedFormat, .
 #define UNITTEST_DISPLAYPORT_BUFFER_LEN (UNITTEST_DISPLAYPORT_ROWS * UNITTEST_DISPLAYPORT_COLS)
 
 char testDisplayPortBuffer[UNITTEST_DISPLAYPORT_BUFFER_LEN];
+unsigned testDisplayPortCharsWritten;
 
 static displayPort_t testDisplayPort;
 
@@ -71,8 +72,9 @@ static int displayPortTestWriteString(displayPort_t *displayPort, uint8_t x, uin
 {
     UNUSED(displayPort);
     UNUSED(attr);
-    for (unsigned int i = 0; i < strlen(s); i++) {
+    for (unsigned int i = 0; i < strlen(s) && y < UNITTEST_DISPLAYPORT_ROWS && x + i < UNITTEST_DISPLAYPORT_COLS; i++) {
         testDisplayPortBuffer[(y * UNITTEST_DISPLAYPORT_COLS) + x + i] = s[i];
+        testDisplayPortCharsWritten++;
     }
     return 0;
 }
@@ -81,7 +83,10 @@ static int displayPortTestWriteChar(displayPort_t *displayPort, uint8_t x, uint8
 {
     UNUSED(displayPort);
     UNUSED(attr);
-    testDisplayPortBuffer[(y * UNITTEST_DISPLAYPORT_COLS) + x] = c;
+    if (y < UNITTEST_DISPLAYPORT_ROWS && x < UNITTEST_DISPLAYPORT_COLS) {
+        testDisplayPortBuffer[(y * UNITTEST_DISPLAYPORT_COLS) + x] = c;
+        testDisplayPortCharsWritten++;
+    }
     return 0;
 }
 
@@ -64,8 +64,8 @@ extern "C" {
     int16_t rcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
     uint16_t averageSystemLoadPercent = 0;
     uint8_t cliMode = 0;
-    uint8_t debugMode = 0;
-    int16_t debug[DEBUG16_VALUE_COUNT];
+    uint8_t debugModes[DEBUG_GROUP_COUNT];
+    int32_t debug[DEBUG_VALUE_STORAGE_COUNT];
     pidProfile_t *currentPidProfile;
     controlRateConfig_t *currentControlRateProfile;
     attitudeEulerAngles_t attitude;
@@ -116,6 +116,7 @@ TEST(VtxTest, PitMode)
 // STUBS
 extern "C" {
     uint8_t activePidLoopDenom = 1;
+    uint8_t activeGyroUpdateDenom = 1;
     uint32_t micros(void) { return simulationTime; }
     uint32_t millis(void) { return micros() / 1000; }
     bool rxIsReceivingSignal(void) { return simulationHaveRx; }
@@ -166,6 +167,7 @@ extern "C" {
     void processRcCommand(void) {}
     void updateGpsStateForHomeAndHoldMode(void) {}
     void blackboxUpdate(timeUs_t) {}
+    void blackboxCaptureIteration(timeUs_t) {}
     void transponderUpdate(timeUs_t) {}
     void GPS_reset_home_position(void) {}
     void accStartCalibration(void) {}
@@ -186,6 +188,8 @@ extern "C" {
     void compassStartCalibration(void) {}
     bool compassIsCalibrationComplete(void) { return true; }
     bool isUpright(void) { return true; }
+    void imuPredictLevelAttitude(float) {}
+    float pidGetDT(void) { return 0.0f; }
     void blackboxLogEvent(FlightLogEvent, union flightLogEventData_u *) {};
     void gyroFiltering(timeUs_t) {};
     timeDelta_t rxGetFrameDelta(timeDelta_t *) { return 0; }
@@ -34,8 +34,12 @@ extern "C" {
     void updateLEDDMABuffer(ledStripFormatRGB_e ledFormat, rgbColor24bpp_t *color, unsigned ledIndex);
 }
 
+static int hsvToRgb24Calls;
+static rgbColor24bpp_t rgb24Result;
+
 TEST(WS2812, updateDMABuffer) {
     // given
+    ws2811LedStripEnable();
     rgbColor24bpp_t color1 = { .raw = {0xFF,0xAA,0x55} };
 
     // when
@@ -75,17 +79,62 @@ TEST(WS2812, updateDMABuffer) {
     byteIndex++;
 }
 
+TEST(WS2812, updateStripEncodesChangedLedsOnly) {
+    // given
+    ws2811LedStripEnable();
+    setUsedLedCount(4);
+    const hsvColor_t black = { 0, 0, 0 };
+    const hsvColor_t red = { 0, 255, 255 };
+    setStripColor(&black);
+
+    // when
+    hsvToRgb24Calls = 0;
+    ws2811UpdateStrip(LED_GRB);
+    ws2811LedDataTransferInProgress = false;
+
+    // then all LEDs are encoded after the used count changed
+    EXPECT_EQ(WS2811_DATA_BUFFER_SIZE, hsvToRgb24Calls);
+
+    // when
+    hsvToRgb24Calls = 0;
+    setStripColor(&black);
+    setLedHsv(2, &red);
+    ws2811UpdateStrip(LED_GRB);
+    ws2811LedDataTransferInProgress = false;
+
+    // then only the changed LED is encoded
+    EXPECT_EQ(1, hsvToRgb24Calls);
+
+    // and the unused LEDs are cleared for the reset delay
+    EXPECT_EQ(0U, ledStripDMABuffer[4 * WS2811_BITS_PER_LED]);
+    EXPECT_EQ(0U, ledStripDMABuffer[WS2811_DATA_BUFFER_SIZE * WS2811_BITS_PER_LED - 1]);
+
+    // when
+    hsvToRgb24Calls = 0;
+    ws2811UpdateStrip(LED_RGB);
+    ws2811LedDataTransferInProgress = false;
+
+    // then a format change encodes all used LEDs
+    EXPECT_EQ(4, hsvToRgb24Calls);
+}
+
 extern "C" {
 rgbColor24bpp_t* hsvToRgb24(const hsvColor_t *c) {
     UNUSED(c);
-    return NULL;
+    hsvToRgb24Calls++;
+    return &rgb24Result;
 }
 
 bool ws2811LedStripHardwareInit(ioTag_t ioTag) {
     UNUSED(ioTag);
 
+    BIT_COMPARE_1 = 40;
+    BIT_COMPARE_0 = 20;
+
     return true;
 }
 
-void ws2811LedStripDMAEnable(void) {}
+void ws2811LedStripDMAEnable(uint16_t dmaBufferLength) {
+    UNUSED(dmaBufferLength);
+}
 }
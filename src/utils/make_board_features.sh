@@ -0,0 +1,63 @@
+#!/bin/bash
+
+# Create a header that drops the drivers a board has no hardware for from a Unified Target build
+#
+# The board's unified target configuration only lists the resources that are wired up, so a driver
+# is left out when none of the resources it needs are assigned. Sensors are detected at runtime and
+# not named in the configuration, so those drivers are always kept.
+#
+# Usage: make_board_features <unified target config file>
+
+INPUT_FILE=$1
+
+has_resource() {
+    grep -q "^resource $1 " "${INPUT_FILE}"
+}
+
+has_setting() {
+    grep -q "^set $1 = $2\$" "${INPUT_FILE}"
+}
+
+undef() {
+    for define in "$@"; do
+        echo "#undef ${define}"
+    done
+}
+
+echo "// Generated by make_board_features.sh from $(basename "${INPUT_FILE}"), do not edit"
+echo
+
+if ! has_resource FLASH_CS; then
+    undef USE_FLASHFS USE_FLASH_TOOLS USE_FLASH_M25P16 USE_FLASH_W25N01G USE_FLASH_W25M USE_FLASH_W25M512 USE_FLASH_W25M02G
+fi
+
+if ! has_resource SDCARD_CS; then
+    undef USE_SDCARD_SPI
+fi
+if ! has_setting sdcard_mode SDIO; then
+    undef USE_SDCARD_SDIO
+fi
+if ! has_resource SDCARD_CS && ! has_setting sdcard_mode SDIO; then
+    undef USE_SDCARD
+fi
+
+if ! has_resource OSD_CS; then
+    undef USE_MAX7456
+fi
+
+if ! has_resource VTX_CS; then
+    undef USE_VTX_RTC6705 USE_VTX_RTC6705_SOFTSPI
+fi
+
+if ! has_resource TRANSPONDER; then
+    undef USE_TRANSPONDER
+fi
+
+if ! has_resource SONAR_TRIGGER; then
+    undef USE_RANGEFINDER_HCSR04
+fi
+
+if ! has_resource RX_SPI_CS; then
+    undef USE_RX_SPI USE_RX_FRSKY_SPI_D USE_RX_FRSKY_SPI_X USE_RX_SFHSS_SPI USE_RX_REDPINE_SPI USE_RX_FRSKY_SPI_TELEMETRY \
+        USE_RX_CC2500_SPI_PA_LNA USE_RX_CC2500_SPI_DIVERSITY USE_RX_FLYSKY USE_RX_FLYSKY_SPI_LED USE_RX_SPEKTRUM USE_RX_SPEKTRUM_TELEMETRY
+fi
@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+
+# Create the list of functions to move into ITCM RAM from the call counts of a profiled SITL run
+#
+# The call counts written by a SITL build made with FUNCTION_PROFILE=yes are matched to function names
+# with the symbols of the SITL executable. The sizes of the functions come from a build of the flight
+# controller target, as they differ from the SITL ones. Functions are then picked by calls per byte
+# until the ITCM budget is used up, and the names are written out one per line for FAST_CODE_LIST.
+#
+# Usage: make_fast_code_list.py [options] <function_profile.txt> <SITL elf> <target elf> > <list>
+
+import subprocess
+import sys
+from optparse import OptionParser
+
+ITCM_BASE = 0x00000000
+ITCM_ALIGNMENT = 4
+
+
+def base_name(symbol):
+    # drop the suffixes gcc adds to specialised copies, e.g. 'fn.constprop.0' or 'fn.isra.0'
+    return symbol.split('.')[0]
+
+
+def read_symbols(nm, elf):
+    # {address: name} and {name: size} for the functions in the executable
+    output = subprocess.run([nm, '-S', '--defined-only', elf], check=True, capture_output=True, text=True).stdout
+    addresses = {}
+    sizes = {}
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) == 4 and fields[2] in 'tTW':
+            address, size, _, name = fields
+            addresses[int(address, 16)] = name
+            sizes[name] = int(size, 16)
+        elif len(fields) == 3 and fields[1] in 'tTW':
+            address, _, name = fields
+            addresses[int(address, 16)] = name
+    return addresses, sizes
+
+
+def read_profile(filename, sitl_addresses):
+    counts = {}
+    with open(filename) as profile:
+        _, main_address = profile.readline().split()
+        main_symbol = [address for address, name in sitl_addresses.items() if name == 'main']
+        if not main_symbol:
+            sys.exit('main not found in the SITL executable')
+        offset = int(main_address, 16) - main_symbol[0]
+
+        for line in profile:
+            address, count = line.split()
+            name = sitl_addresses.get(int(address, 16) - offset)
+            if name:
+                counts[base_name(name)] = counts.get(base_name(name), 0) + int(count)
+    return counts
+
+
+def main():
+    parser = OptionParser(usage='%prog [options] <function_profile.txt> <SITL elf> <target elf>')
+    parser.add_option('--budget', type='int', default=8192,
+                      help='bytes of ITCM RAM left for profiled functions after FAST_CODE [default: %default]')
+    parser.add_option('--nm', default='arm-none-eabi-nm', help='nm for the target elf [default: %default]')
+    parser.add_option('--sitl-nm', default='nm', help='nm for the SITL elf [default: %default]')
+    (options, args) = parser.parse_args()
+    if len(args) != 3:
+        parser.error('expected the profile, the SITL elf and the target elf')
+    profile_file, sitl_elf, target_elf = args
+
+    sitl_addresses, _ = read_symbols(options.sitl_nm, sitl_elf)
+    counts = read_profile(profile_file, sitl_addresses)
+
+    target_addresses, target_sizes = read_symbols(options.nm, target_elf)
+    in_itcm = {name for address, name in target_addresses.items() if address >= ITCM_BASE and address < ITCM_BASE + 0x10000}
+
+    candidates = []
+    for name, size in target_sizes.items():
+        count = counts.get(base_name(name), 0)
+        if count and size and name not in in_itcm:
+            candidates.append((count / size, name, size))
+    candidates.sort(reverse=True)
+
+    budget = options.budget
+    selected = []
+    for _, name, size in candidates:
+        size = (size + ITCM_ALIGNMENT - 1) & ~(ITCM_ALIGNMENT - 1)
+        if size <= budget:
+            selected.append(name)
+            budget -= size
+
+    print('# Generated by make_fast_code_list.py from {}, {} bytes of ITCM RAM left'.format(profile_file, budget))
+    for name in selected:
+        print(name)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+
+# Show where the CPU time goes on a running flight controller built with USE_PC_SAMPLING
+#
+# Polls MSP2_PC_SAMPLES over the given serial port for the given time, looks the sampled program counters
+# up in the elf of the running firmware and prints the share of the samples per function. With --folded the
+# counts are printed as "function count" lines instead, which flamegraph.pl and speedscope take as input.
+#
+# Usage: msp_pc_profile.py [options] <serial port> <elf>
+
+import bisect
+import struct
+import subprocess
+import time
+from optparse import OptionParser
+
+import serial
+
+MSP2_PC_SAMPLES = 0x3007
+
+
+def crc8_dvb_s2(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0xD5) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def msp_request(port, command):
+    frame = struct.pack('<BHH', 0, command, 0)
+    port.write(b'$X<' + frame + bytes([crc8_dvb_s2(frame)]))
+
+    if port.read(3) != b'$X>':
+        raise IOError('no MSP v2 reply')
+    header = port.read(5)
+    _, reply_command, length = struct.unpack('<BHH', header)
+    payload = port.read(length)
+    if port.read(1) != bytes([crc8_dvb_s2(header + payload)]) or reply_command != command:
+        raise IOError('bad MSP v2 reply')
+    return payload
+
+
+def read_functions(nm, elf):
+    output = subprocess.run([nm, '-S', '--defined-only', '-n', elf], check=True, capture_output=True, text=True).stdout
+    functions = []
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) == 4 and fields[2] in 'tTW':
+            # clear the thumb bit, the sampled addresses do not have it
+            functions.append((int(fields[0], 16) & ~1, int(fields[1], 16), fields[3]))
+    return functions
+
+
+def main():
+    parser = OptionParser(usage='%prog [options] <serial port> <elf>')
+    parser.add_option('--time', type='float', default=10, help='seconds to sample for [default: %default]')
+    parser.add_option('--nm', default='arm-none-eabi-nm', help='nm for the elf [default: %default]')
+    parser.add_option('--folded', action='store_true', help='print folded counts for flame graph tools')
+    (options, args) = parser.parse_args()
+    if len(args) != 2:
+        parser.error('expected the serial port and the elf')
+
+    functions = read_functions(options.nm, args[1])
+    starts = [start for start, _, _ in functions]
+
+    counts = {}
+    total = 0
+    lost = None
+    with serial.Serial(args[0], 115200, timeout=1) as port:
+        end = time.time() + options.time
+        while time.time() < end:
+            payload = msp_request(port, MSP2_PC_SAMPLES)
+            lost_now = struct.unpack_from('<H', payload)[0]
+            if lost is None:
+                lost_start = lost_now
+            lost = lost_now
+            for (pc,) in struct.iter_unpack('<I', payload[2:]):
+                index = bisect.bisect_right(starts, pc) - 1
+                start, size, name = functions[index] if index >= 0 else (0, 0, '?')
+                if pc >= start + size:
+                    name = '0x{:08x}'.format(pc)
+                counts[name] = counts.get(name, 0) + 1
+                total += 1
+
+    if options.folded:
+        for name, count in sorted(counts.items(), key=lambda item: -item[1]):
+            print('{} {}'.format(name, count))
+        return
+
+    print('{} samples, {} lost'.format(total, (lost - lost_start) & 0xFFFF if lost is not None else 0))
+    if not total:
+        return
+    for name, count in sorted(counts.items(), key=lambda item: -item[1]):
+        print('{:6.2f}% {:7d} {}'.format(100 * count / total, count, name))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,196 @@
+#!/usr/bin/env python3
+
+# Collect the memory usage of firmware builds and the host benchmark results into one report, and check it
+#
+# The sizes of the output sections and the usage of the memory regions are read from the map files the
+# linker writes for each target (obj/main/<fork>_<target>.map), the benchmark times from the JSON files of
+# 'make bench'. The report is written as JSON. Given a baseline report from an earlier run, the watched
+# sections growing or the benchmarks slowing down by more than the thresholds are reported as failures, as
+# is any memory region filled beyond --max-region-usage, and the exit status is then 1.
+#
+# Usage: perf_report.py [options] [map files]
+
+import glob
+import json
+import os
+import re
+import sys
+from optparse import OptionParser
+
+OUTPUT_SECTION = re.compile(r'^(\.\S+)\s*$|^(\.\S+)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)(?:\s+load address 0x([0-9a-f]+))?')
+SECTION_VALUES = re.compile(r'^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)(?:\s+load address 0x([0-9a-f]+))?')
+MEMORY_REGION = re.compile(r'^(\S+)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)')
+
+
+def target_name(map_file):
+    # <fork>_<target>.map
+    name = os.path.splitext(os.path.basename(map_file))[0]
+    return name.split('_', 1)[1] if '_' in name else name
+
+
+def region_of(regions, address):
+    for name, region in regions.items():
+        if region['origin'] <= address < region['origin'] + region['length']:
+            return name
+    return None
+
+
+def read_map(map_file):
+    regions = {}
+    sections = {}
+    with open(map_file) as lines:
+        state = None
+        pending = None
+        for line in lines:
+            if line.startswith('Memory Configuration'):
+                state = 'memory'
+                continue
+            if line.startswith('Linker script and memory map'):
+                state = 'sections'
+                continue
+
+            if state == 'memory':
+                match = MEMORY_REGION.match(line)
+                if match and match.group(1) not in ('Name', '*default*'):
+                    regions[match.group(1)] = {'origin': int(match.group(2), 16), 'length': int(match.group(3), 16)}
+            elif state == 'sections':
+                # long section names put the address and size on the next line
+                values = None
+                if pending:
+                    match = SECTION_VALUES.match(line)
+                    if match:
+                        values = (pending,) + match.groups()
+                    pending = None
+                if not values:
+                    match = OUTPUT_SECTION.match(line)
+                    if not match:
+                        continue
+                    if match.group(1):
+                        pending = match.group(1)
+                        continue
+                    values = match.group(2, 3, 4, 5)
+
+                name, address, size, load_address = values
+                size = int(size, 16)
+                if size:
+                    sections[name] = {'address': int(address, 16), 'size': size,
+                                      'load_address': int(load_address, 16) if load_address else None}
+
+    # sections with a load address take room in both of their regions, e.g. .data or .tcm_code in FLASH
+    usage = {name: dict(region, used=0) for name, region in regions.items()}
+    for section in sections.values():
+        for address in {section['address'], section['load_address']} - {None}:
+            region = region_of(regions, address)
+            if region:
+                usage[region]['used'] += section['size']
+
+    return {'map': map_file,
+            'sections': {name: section['size'] for name, section in sections.items()},
+            'regions': usage}
+
+
+def read_benchmarks(bench_dir):
+    to_ns = {'ns': 1, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+    benchmarks = {}
+    for bench_file in sorted(glob.glob(os.path.join(bench_dir, '*.json'))):
+        bench = os.path.splitext(os.path.basename(bench_file))[0]
+        with open(bench_file) as results:
+            for result in json.load(results)['benchmarks']:
+                scale = to_ns[result.get('time_unit', 'ns')]
+                benchmarks['{}/{}'.format(bench, result['name'])] = {
+                    'cpu_time_ns': result['cpu_time'] * scale,
+                    'real_time_ns': result['real_time'] * scale,
+                }
+    return benchmarks
+
+
+def check(report, baseline, options):
+    failures = []
+
+    for target, build in sorted(report['targets'].items()):
+        for name, region in sorted(build['regions'].items()):
+            if region['length'] and region['used'] * 100 > region['length'] * options.max_region_usage:
+                failures.append('{} {}: {} of {} bytes used, more than {}%'.format(
+                    target, name, region['used'], region['length'], options.max_region_usage))
+
+    if not baseline:
+        return failures
+
+    for target, build in sorted(report['targets'].items()):
+        old_build = baseline['targets'].get(target)
+        if not old_build:
+            continue
+        for name in options.sections.split(','):
+            size = build['sections'].get(name, 0)
+            old_size = old_build['sections'].get(name, 0)
+            if size > old_size + old_size * options.size_threshold / 100:
+                failures.append('{} {}: {} bytes, was {}'.format(target, name, size, old_size))
+
+    for name, result in sorted(report['benchmarks'].items()):
+        old_result = baseline['benchmarks'].get(name)
+        if not old_result:
+            continue
+        time = result['cpu_time_ns']
+        old_time = old_result['cpu_time_ns']
+        if time > old_time + old_time * options.time_threshold / 100:
+            failures.append('{}: {:.2f} ns, was {:.2f} ns (+{:.1f}%)'.format(
+                name, time, old_time, (time - old_time) * 100 / old_time))
+
+    return failures
+
+
+def print_summary(report, baseline, sections):
+    for target, build in sorted(report['targets'].items()):
+        old_build = baseline['targets'].get(target, {}) if baseline else {}
+        line = []
+        for name in sections:
+            size = build['sections'].get(name, 0)
+            old_size = old_build.get('sections', {}).get(name)
+            change = ' ({:+d})'.format(size - old_size) if old_size is not None and size != old_size else ''
+            line.append('{} {}{}'.format(name, size, change))
+        print('{}: {}'.format(target, ', '.join(line)))
+    if report['benchmarks']:
+        print('{} benchmark results'.format(len(report['benchmarks'])))
+
+
+def main():
+    parser = OptionParser(usage='%prog [options] [map files]')
+    parser.add_option('--bench-dir', help='directory of the benchmark JSON files written by make bench')
+    parser.add_option('--baseline', help='earlier report to compare with, ignored if the file does not exist')
+    parser.add_option('--output', help='file to write the JSON report to [default: stdout]')
+    parser.add_option('--sections', default='.tcm_code,.fastram_data,.fastram_bss',
+                      help='comma separated sections checked against the baseline [default: %default]')
+    parser.add_option('--size-threshold', type='float', default=5.0,
+                      help='percent a watched section may grow over the baseline [default: %default]')
+    parser.add_option('--time-threshold', type='float', default=10.0,
+                      help='percent a benchmark may slow down over the baseline [default: %default]')
+    parser.add_option('--max-region-usage', type='float', default=100.0,
+                      help='percent of a memory region that may be used [default: %default]')
+    (options, args) = parser.parse_args()
+
+    report = {
+        'targets': {target_name(map_file): read_map(map_file) for map_file in args},
+        'benchmarks': read_benchmarks(options.bench_dir) if options.bench_dir else {},
+    }
+
+    baseline = None
+    if options.baseline and os.path.exists(options.baseline):
+        with open(options.baseline) as baseline_file:
+            baseline = json.load(baseline_file)
+
+    if options.output:
+        with open(options.output, 'w') as output:
+            json.dump(report, output, indent=2, sort_keys=True)
+        print_summary(report, baseline, options.sections.split(','))
+    else:
+        json.dump(report, sys.stdout, indent=2, sort_keys=True)
+
+    failures = check(report, baseline, options)
+    for failure in failures:
+        print('FAIL ' + failure, file=sys.stderr)
+    if failures:
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()